@@ -0,0 +1,72 @@
+/* Run-time statistics support for the nRF52 port.
+ *
+ * RTC2 is the run-time counter: it runs from the 32768Hz low frequency clock, which keeps running while the CPU
+ * sleeps. Its 24 bits counter is shifted left by 8 bits so that the 32 bits run-time counters of the tasks wrap around
+ * correctly (every 512s).
+ *
+ * The tickless idle sleep periods are accounted too, as well as the interrupt that ends each of them.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "nrf_rtc.h"
+
+#if configGENERATE_RUN_TIME_STATS == 1
+
+static uint32_t ulSleepStart;
+static volatile uint32_t ulSleepTime;
+static volatile uint32_t ulWakeups;
+static volatile uint16_t usWakeupsBySource[ portNB_WAKEUP_SOURCES ];
+
+void vPortConfigureRunTimeCounter( void )
+{
+    nrf_rtc_prescaler_set( NRF_RTC2, 0 );
+    nrf_rtc_task_trigger( NRF_RTC2, NRF_RTC_TASK_START );
+}
+
+void vPortPreSleepProcessing( void )
+{
+    ulSleepStart = portGET_RUN_TIME_COUNTER_VALUE();
+}
+
+void vPortPostSleepProcessing( void )
+{
+    uint32_t ulPending;
+    uint32_t ulSource = 0;
+
+    ulSleepTime += portGET_RUN_TIME_COUNTER_VALUE() - ulSleepStart;
+    ulWakeups++;
+
+    /* Interrupts are still disabled: the interrupt that ended the sleep is pending. If several are, the one with the
+     * lowest number is counted. */
+    ulPending = NVIC->ISPR[ 0 ];
+    if ( ulPending == 0 )
+    {
+        ulPending = NVIC->ISPR[ 1 ];
+        ulSource = 32;
+    }
+    if ( ulPending != 0 )
+    {
+        ulSource += __builtin_ctz( ulPending );
+        if ( ulSource < portNB_WAKEUP_SOURCES )
+        {
+            usWakeupsBySource[ ulSource ]++;
+        }
+    }
+}
+
+void vPortGetSleepStats( uint32_t * pulSleepTime, uint32_t * pulWakeups, uint16_t * pusWakeupsBySource )
+{
+    uint32_t i;
+
+    taskENTER_CRITICAL();
+    *pulSleepTime = ulSleepTime;
+    *pulWakeups = ulWakeups;
+    for ( i = 0; i < portNB_WAKEUP_SOURCES; i++ )
+    {
+        pusWakeupsBySource[ i ] = usWakeupsBySource[ i ];
+    }
+    taskEXIT_CRITICAL();
+}
+
+#endif /* configGENERATE_RUN_TIME_STATS == 1 */
@@ -0,0 +1,52 @@
+/* Binary trace of the system events, see port_trace.h */
+
+#include "FreeRTOS.h"
+
+#ifdef ENABLE_TRACE
+
+#include "port_trace.h"
+
+static TraceRecord_t xTraceBuffer[ portTRACE_BUFFER_SIZE ];
+static uint32_t ulTraceHead;
+static volatile uint32_t ulTraceRunning;
+
+void vPortTraceRecord( uint8_t ucEvent, uint16_t usArgument )
+{
+    TraceRecord_t * pxRecord;
+
+    if ( ulTraceRunning == 0 )
+    {
+        return;
+    }
+
+    /* An ISR may record an event between the increment and the stores: each of them still writes its own record */
+    pxRecord = &xTraceBuffer[ __atomic_fetch_add( &ulTraceHead, 1, __ATOMIC_RELAXED ) & ( portTRACE_BUFFER_SIZE - 1 ) ];
+    pxRecord->ulTimestamp = NRF_RTC2->COUNTER;
+    pxRecord->ucEvent = ucEvent;
+    pxRecord->usArgument = usArgument;
+}
+
+void vPortTraceStart( void )
+{
+    ulTraceRunning = 0;
+    __atomic_store_n( &ulTraceHead, 0, __ATOMIC_RELAXED );
+    ulTraceRunning = 1;
+}
+
+void vPortTraceStop( void )
+{
+    ulTraceRunning = 0;
+}
+
+uint32_t ulPortTraceIsRunning( void )
+{
+    return ulTraceRunning;
+}
+
+const TraceRecord_t * pxPortTraceGetBuffer( uint32_t * pulNbRecorded )
+{
+    *pulNbRecorded = __atomic_load_n( &ulTraceHead, __ATOMIC_RELAXED );
+    return xTraceBuffer;
+}
+
+#endif /* ENABLE_TRACE */
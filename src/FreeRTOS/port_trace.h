@@ -0,0 +1,43 @@
+/* Binary trace of the system events, built when ENABLE_TRACE is defined.
+ *
+ * Events are recorded in a ring of 8 bytes records, timestamped with the RTC2 counter (see port_run_time_stats.c).
+ * Recording is lock-free and can be done from tasks and ISRs: it costs an atomic increment and 3 stores.
+ * The ring is read by Pinetime::Logging::Trace, which dumps it to a file.
+ */
+
+#ifndef PORT_TRACE_H
+#define PORT_TRACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Must be a power of 2 */
+#define portTRACE_BUFFER_SIZE 512
+
+/* Event IDs used by the FreeRTOS hooks, see Pinetime::Logging::Trace::Events for the others */
+#define portTRACE_EVENT_TASK_SWITCHED_IN 1
+#define portTRACE_EVENT_QUEUE_POSTED     2
+
+typedef struct {
+    uint32_t ulTimestamp; /* RTC2 counter (24 bits, 32768Hz) */
+    uint8_t ucEvent;
+    uint8_t ucReserved;
+    uint16_t usArgument;
+} TraceRecord_t;
+
+void vPortTraceRecord( uint8_t ucEvent, uint16_t usArgument );
+void vPortTraceStart( void );
+void vPortTraceStop( void );
+uint32_t ulPortTraceIsRunning( void );
+/* Returns the ring, and the total number of events recorded since the trace was started (the ring holds the last
+ * portTRACE_BUFFER_SIZE of them) */
+const TraceRecord_t * pxPortTraceGetBuffer( uint32_t * pulNbRecorded );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PORT_TRACE_H */
@@ -61,7 +61,12 @@
 #define configCPU_CLOCK_HZ                      (SystemCoreClock)
 #define configTICK_RATE_HZ                      1024
 #define configMAX_PRIORITIES                    (3)
-#define configMINIMAL_STACK_SIZE                (120)
+/* The idle task outputs the logs of the NRF SDK (see vApplicationIdleHook), which are formatted on the device */
+#if NRF_LOG_ENABLED
+  #define configMINIMAL_STACK_SIZE (200)
+#else
+  #define configMINIMAL_STACK_SIZE (120)
+#endif
 #define configTOTAL_HEAP_SIZE                   (1024 * 17)
 #define configMAX_TASK_NAME_LEN                 (4)
 #define configUSE_16_BIT_TICKS                  0
@@ -77,16 +82,53 @@
 #define configENABLE_BACKWARD_COMPATIBILITY     1
 
 /* Hook function related definitions. */
-#define configUSE_IDLE_HOOK            0
+#define configUSE_IDLE_HOOK            1
 #define configUSE_TICK_HOOK            0
 #define configCHECK_FOR_STACK_OVERFLOW 0
 #define configUSE_MALLOC_FAILED_HOOK   0
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS        0
+/* Built with -DENABLE_RUN_TIME_STATS=1, see SystemMonitor. The trace takes its timestamps from the run-time counter */
+#if defined(ENABLE_RUN_TIME_STATS) || defined(ENABLE_TRACE)
+  #define configGENERATE_RUN_TIME_STATS 1
+#else
+  #define configGENERATE_RUN_TIME_STATS 0
+#endif
 #define configUSE_TRACE_FACILITY             1
 #define configUSE_STATS_FORMATTING_FUNCTIONS 0
 
+#if configGENERATE_RUN_TIME_STATS == 1
+  /* See FreeRTOS/port_run_time_stats.c: RTC2 at 32768Hz, shifted to wrap around on 32 bits */
+  #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() vPortConfigureRunTimeCounter()
+  #define portGET_RUN_TIME_COUNTER_VALUE()         (NRF_RTC2->COUNTER << 8)
+  #define portRUN_TIME_COUNTER_FREQUENCY           (32768UL * 256UL)
+  #define configPRE_SLEEP_PROCESSING(x)            vPortPreSleepProcessing()
+  #define configPOST_SLEEP_PROCESSING(x)           vPortPostSleepProcessing()
+  /* Number of interrupts of the nRF52832, for the statistics of the wake-up sources */
+  #define portNB_WAKEUP_SOURCES 39
+
+  #ifdef __cplusplus
+extern "C" {
+  #endif
+void vPortConfigureRunTimeCounter(void);
+void vPortPreSleepProcessing(void);
+void vPortPostSleepProcessing(void);
+/* Cumulated sleep time (in run-time counter units), number of wake-ups, and number of wake-ups by interrupt number
+ * (portNB_WAKEUP_SOURCES of them) */
+void vPortGetSleepStats(uint32_t* pulSleepTime, uint32_t* pulWakeups, uint16_t* pusWakeupsBySource);
+  #ifdef __cplusplus
+}
+  #endif
+#endif
+
+#ifdef ENABLE_TRACE
+  /* See FreeRTOS/port_trace.h. The timestamps come from the RTC2 counter started for the run-time statistics */
+  #include "FreeRTOS/port_trace.h"
+  #define traceTASK_SWITCHED_IN()           vPortTraceRecord(portTRACE_EVENT_TASK_SWITCHED_IN, (uint16_t) pxCurrentTCB->uxTCBNumber)
+  #define traceQUEUE_SEND(pxQueue)          vPortTraceRecord(portTRACE_EVENT_QUEUE_POSTED, (uint16_t) (uint32_t) (pxQueue))
+  #define traceQUEUE_SEND_FROM_ISR(pxQueue) vPortTraceRecord(portTRACE_EVENT_QUEUE_POSTED, (uint16_t) (uint32_t) (pxQueue))
+#endif
+
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES           0
 #define configMAX_CO_ROUTINE_PRIORITIES (2)
@@ -1,5 +1,6 @@
 #include "components/ble/AlertNotificationClient.h"
 #include <algorithm>
+#include "components/ble/NewAlert.h"
 #include "components/ble/NotificationManager.h"
 #include "systemtask/SystemTask.h"
 #include <nrf_log.h>
@@ -112,6 +113,8 @@ int AlertNotificationClient::OnNewAlertSubcribe(uint16_t connectionHandle, const
     NRF_LOG_INFO("ANS New alert subscribe OK");
   } else {
     NRF_LOG_INFO("ANS New alert subscribe ERROR");
+    // The handles may be stale: don't save them
+    isDescriptorFound = false;
   }
   onServiceDiscovered(connectionHandle);
 
@@ -128,10 +131,7 @@ int AlertNotificationClient::OnDescriptorDiscoveryEventCallback(uint16_t connect
         NRF_LOG_INFO("ANS Descriptor discovered : %d", descriptor->handle);
         newAlertDescriptorHandle = descriptor->handle;
         isDescriptorFound = true;
-        uint8_t value[2];
-        value[0] = 1;
-        value[1] = 0;
-        ble_gattc_write_flat(connectionHandle, newAlertDescriptorHandle, value, sizeof(value), NewAlertSubcribeCallback, this);
+        SubscribeNewAlert(connectionHandle);
       }
     }
   } else {
@@ -143,27 +143,9 @@ int AlertNotificationClient::OnDescriptorDiscoveryEventCallback(uint16_t connect
 
 void AlertNotificationClient::OnNotification(ble_gap_event* event) {
   if (event->notify_rx.attr_handle == newAlertHandle) {
-    constexpr size_t stringTerminatorSize = 1; // end of string '\0'
-    constexpr size_t headerSize = 3;
-    const auto maxMessageSize {NotificationManager::MaximumMessageSize()};
-    const auto maxBufferSize {maxMessageSize + headerSize};
-
-    // Ignore notifications with empty message
-    const auto packetLen = OS_MBUF_PKTLEN(event->notify_rx.om);
-    if (packetLen <= headerSize)
-      return;
-
-    size_t bufferSize = std::min(packetLen + stringTerminatorSize, maxBufferSize);
-    auto messageSize = std::min(maxMessageSize, (bufferSize - headerSize));
-
-    NotificationManager::Notification notif;
-    os_mbuf_copydata(event->notify_rx.om, headerSize, messageSize - 1, notif.message.data());
-    notif.message[messageSize - 1] = '\0';
-    notif.size = messageSize;
-    notif.category = Pinetime::Controllers::NotificationManager::Categories::SimpleAlert;
-    notificationManager.Push(std::move(notif));
-
-    systemTask.PushMessage(Pinetime::System::Messages::OnNewNotification);
+    if (NewAlert::Push(notificationManager, event->notify_rx.om, Pinetime::Controllers::NotificationManager::Categories::SimpleAlert)) {
+      systemTask.PushMessage(Pinetime::System::Messages::OnNewNotification);
+    }
   }
 }
 
@@ -187,3 +169,31 @@ void AlertNotificationClient::Discover(uint16_t connectionHandle, std::function<
   this->onServiceDiscovered = onServiceDiscovered;
   ble_gattc_disc_svc_by_uuid(connectionHandle, &ansServiceUuid.u, OnDiscoveryEventCallback, this);
 }
+
+bool AlertNotificationClient::SaveHandles(Handles& handles) const {
+  if (!isDescriptorFound) {
+    return false;
+  }
+  handles = {newAlertHandle, newAlertDescriptorHandle};
+  return true;
+}
+
+void AlertNotificationClient::RestoreHandles(uint16_t connectionHandle,
+                                             const Handles& handles,
+                                             std::function<void(uint16_t)> onServiceDiscovered) {
+  NRF_LOG_INFO("[ANS] Restoring handles");
+  this->onServiceDiscovered = onServiceDiscovered;
+  newAlertHandle = handles[0];
+  newAlertDescriptorHandle = handles[1];
+  isDiscovered = true;
+  isCharacteristicDiscovered = true;
+  isDescriptorFound = true;
+  SubscribeNewAlert(connectionHandle);
+}
+
+void AlertNotificationClient::SubscribeNewAlert(uint16_t connectionHandle) {
+  uint8_t value[2];
+  value[0] = 1;
+  value[1] = 0;
+  ble_gattc_write_flat(connectionHandle, newAlertDescriptorHandle, value, sizeof(value), NewAlertSubcribeCallback, this);
+}
@@ -33,8 +33,12 @@ namespace Pinetime {
       void OnNotification(ble_gap_event* event);
       void Reset();
       void Discover(uint16_t connectionHandle, std::function<void(uint16_t)> lambda) override;
+      bool SaveHandles(Handles& handles) const override;
+      void RestoreHandles(uint16_t connectionHandle, const Handles& handles, std::function<void(uint16_t)> lambda) override;
 
     private:
+      void SubscribeNewAlert(uint16_t connectionHandle);
+
       static constexpr uint16_t ansServiceId {0x1811};
       static constexpr uint16_t supportedNewAlertCategoryId = 0x2a47;
       static constexpr uint16_t supportedUnreadAlertCategoryId = 0x2a48;
@@ -2,6 +2,7 @@
 #include <hal/nrf_rtc.h>
 #include <cstring>
 #include <algorithm>
+#include "components/ble/NewAlert.h"
 #include "components/ble/NotificationManager.h"
 #include "systemtask/SystemTask.h"
 
@@ -46,40 +47,15 @@ AlertNotificationService::AlertNotificationService(System::SystemTask& systemTas
 
 int AlertNotificationService::OnAlert(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt) {
   if (ctxt->op == BLE_GATT_ACCESS_OP_WRITE_CHR) {
-    constexpr size_t stringTerminatorSize = 1; // end of string '\0'
-    constexpr size_t headerSize = 3;
-    const auto maxMessageSize {NotificationManager::MaximumMessageSize()};
-    const auto maxBufferSize {maxMessageSize + headerSize};
-
-    // Ignore notifications with empty message
-    const auto packetLen = OS_MBUF_PKTLEN(ctxt->om);
-    if (packetLen <= headerSize) {
-      return 0;
-    }
-
-    size_t bufferSize = std::min(packetLen + stringTerminatorSize, maxBufferSize);
-    auto messageSize = std::min(maxMessageSize, (bufferSize - headerSize));
-    Categories category;
-
-    NotificationManager::Notification notif;
-    os_mbuf_copydata(ctxt->om, headerSize, messageSize - 1, notif.message.data());
-    os_mbuf_copydata(ctxt->om, 0, 1, &category);
-    notif.message[messageSize - 1] = '\0';
-    notif.size = messageSize;
-
     // TODO convert all ANS categories to NotificationController categories
-    switch (category) {
-      case Categories::Call:
-        notif.category = Pinetime::Controllers::NotificationManager::Categories::IncomingCall;
-        break;
-      default:
-        notif.category = Pinetime::Controllers::NotificationManager::Categories::SimpleAlert;
-        break;
+    auto category = Pinetime::Controllers::NotificationManager::Categories::SimpleAlert;
+    if (static_cast<Categories>(NewAlert::Category(ctxt->om)) == Categories::Call) {
+      category = Pinetime::Controllers::NotificationManager::Categories::IncomingCall;
     }
 
-    auto event = Pinetime::System::Messages::OnNewNotification;
-    notificationManager.Push(std::move(notif));
-    systemTask.PushMessage(event);
+    if (NewAlert::Push(notificationManager, ctxt->om, category)) {
+      systemTask.PushMessage(Pinetime::System::Messages::OnNewNotification);
+    }
   }
   return 0;
 }
@@ -1,12 +1,26 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 
 namespace Pinetime {
   namespace Controllers {
     class BleClient {
     public:
+      // Attribute handles of the peer needed by the client once the discovery is done
+      static constexpr size_t MaxCachedHandles = 2;
+      using Handles = std::array<uint16_t, MaxCachedHandles>;
+
       virtual void Discover(uint16_t connectionHandle, std::function<void(uint16_t)> lambda) = 0;
+
+      /// Copies the handles found by the last discovery, returns false if the service was not completely discovered
+      virtual bool SaveHandles(Handles& handles) const = 0;
+
+      /// Same as Discover(), but uses the handles saved by SaveHandles() during a previous connection to the same peer
+      /// instead of discovering the service again
+      virtual void RestoreHandles(uint16_t connectionHandle, const Handles& handles, std::function<void(uint16_t)> lambda) = 0;
     };
   }
 }
\ No newline at end of file
@@ -102,6 +102,8 @@ int CurrentTimeClient::OnCurrentTimeReadResult(uint16_t conn_handle, const ble_g
                                nrf_rtc_counter_get(portNRF_RTC_REG));
   } else {
     NRF_LOG_INFO("Error retrieving current time: %d", error->status);
+    // The handle may be stale: don't save it
+    isCharacteristicDiscovered = false;
   }
 
   onServiceDiscovered(conn_handle);
@@ -118,3 +120,22 @@ void CurrentTimeClient::Discover(uint16_t connectionHandle, std::function<void(u
   this->onServiceDiscovered = onServiceDiscovered;
   ble_gattc_disc_svc_by_uuid(connectionHandle, &ctsServiceUuid.u, OnDiscoveryEventCallback, this);
 }
+
+bool CurrentTimeClient::SaveHandles(Handles& handles) const {
+  if (!isCharacteristicDiscovered) {
+    return false;
+  }
+  handles = {currentTimeHandle};
+  return true;
+}
+
+void CurrentTimeClient::RestoreHandles(uint16_t connectionHandle,
+                                       const Handles& handles,
+                                       std::function<void(uint16_t)> onServiceDiscovered) {
+  NRF_LOG_INFO("[CTS] Restoring handles, fetching time");
+  this->onServiceDiscovered = onServiceDiscovered;
+  isDiscovered = true;
+  isCharacteristicDiscovered = true;
+  currentTimeHandle = handles[0];
+  ble_gattc_read(connectionHandle, currentTimeHandle, CurrentTimeReadCallback, this);
+}
@@ -26,6 +26,8 @@ namespace Pinetime {
         return &CurrentTimeClient::currentTimeCharacteristicUuid;
       }
       void Discover(uint16_t connectionHandle, std::function<void(uint16_t)> lambda) override;
+      bool SaveHandles(Handles& handles) const override;
+      void RestoreHandles(uint16_t connectionHandle, const Handles& handles, std::function<void(uint16_t)> lambda) override;
 
     private:
       typedef struct __attribute__((packed)) {
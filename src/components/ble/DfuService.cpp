@@ -12,10 +12,24 @@ constexpr ble_uuid128_t DfuService::controlPointCharacteristicUuid;
 constexpr ble_uuid128_t DfuService::revisionCharacteristicUuid;
 constexpr ble_uuid128_t DfuService::packetCharacteristicUuid;
 
-int DfuServiceCallback(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
-  auto dfuService = static_cast<DfuService*>(arg);
-  return dfuService->OnServiceData(conn_handle, attr_handle, ctxt);
-}
+const GattCharacteristic<DfuService> DfuService::characteristics[3] = {
+  {.uuid = &packetCharacteristicUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE_NO_RSP,
+   .onRead = nullptr,
+   .onWrite = &DfuService::WritePacketHandler,
+   .valueHandle = &DfuService::packetCharacteristicHandle},
+  {.uuid = &controlPointCharacteristicUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_NOTIFY,
+   .onRead = nullptr,
+   .onWrite = &DfuService::ControlPointHandler,
+   .valueHandle = &DfuService::controlPointCharacteristicHandle},
+  {.uuid = &revisionCharacteristicUuid.u,
+   .flags = BLE_GATT_CHR_F_READ,
+   .onRead = &DfuService::SendDfuRevision,
+   .onWrite = nullptr,
+   // As before the table: the value handle is written into the revision that the characteristic returns
+   .valueHandle = &DfuService::revision},
+};
 
 void NotificationTimerCallback(TimerHandle_t xTimer) {
   auto notificationManager = static_cast<DfuService::NotificationManager*>(pvTimerGetTimerID(xTimer));
@@ -33,86 +47,25 @@ DfuService::DfuService(Pinetime::System::SystemTask& systemTask,
   : systemTask {systemTask},
     bleController {bleController},
     dfuImage {spiNorFlash},
-    characteristicDefinition {{
-                                .uuid = &packetCharacteristicUuid.u,
-                                .access_cb = DfuServiceCallback,
-                                .arg = this,
-                                .flags = BLE_GATT_CHR_F_WRITE_NO_RSP,
-                                .val_handle = nullptr,
-                              },
-                              {
-                                .uuid = &controlPointCharacteristicUuid.u,
-                                .access_cb = DfuServiceCallback,
-                                .arg = this,
-                                .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_NOTIFY,
-                                .val_handle = nullptr,
-                              },
-                              {
-                                .uuid = &revisionCharacteristicUuid.u,
-                                .access_cb = DfuServiceCallback,
-                                .arg = this,
-                                .flags = BLE_GATT_CHR_F_READ,
-                                .val_handle = &revision,
-
-                              },
-                              {0}
-
-    },
-    serviceDefinition {
-      {/* Device Information Service */
-       .type = BLE_GATT_SVC_TYPE_PRIMARY,
-       .uuid = &serviceUuid.u,
-       .characteristics = characteristicDefinition},
-      {0},
-    } {
+    gattService {*this, &serviceUuid.u, characteristics} {
   timeoutTimer = xTimerCreate("notificationTimer", 10000, pdFALSE, this, TimeoutTimerCallback);
 }
 
 void DfuService::Init() {
-  int res;
-  res = ble_gatts_count_cfg(serviceDefinition);
-  ASSERT(res == 0);
+  gattService.Init();
+}
 
-  res = ble_gatts_add_svcs(serviceDefinition);
-  ASSERT(res == 0);
+int DfuService::SendDfuRevision(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* context) {
+  int res = os_mbuf_append(context->om, &revision, sizeof(revision));
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
 }
 
-int DfuService::OnServiceData(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context) {
+int DfuService::WritePacketHandler(uint16_t connectionHandle, ble_gatt_access_ctxt* context) {
   if (bleController.IsFirmwareUpdating()) {
     xTimerStart(timeoutTimer, 0);
   }
 
-  ble_gatts_find_chr(&serviceUuid.u, &packetCharacteristicUuid.u, nullptr, &packetCharacteristicHandle);
-  ble_gatts_find_chr(&serviceUuid.u, &controlPointCharacteristicUuid.u, nullptr, &controlPointCharacteristicHandle);
-  ble_gatts_find_chr(&serviceUuid.u, &revisionCharacteristicUuid.u, nullptr, &revisionCharacteristicHandle);
-
-  if (attributeHandle == packetCharacteristicHandle) {
-    if (context->op == BLE_GATT_ACCESS_OP_WRITE_CHR)
-      return WritePacketHandler(connectionHandle, context->om);
-    else
-      return 0;
-  } else if (attributeHandle == controlPointCharacteristicHandle) {
-    if (context->op == BLE_GATT_ACCESS_OP_WRITE_CHR)
-      return ControlPointHandler(connectionHandle, context->om);
-    else
-      return 0;
-  } else if (attributeHandle == revisionCharacteristicHandle) {
-    if (context->op == BLE_GATT_ACCESS_OP_READ_CHR)
-      return SendDfuRevision(context->om);
-    else
-      return 0;
-  } else {
-    NRF_LOG_INFO("[DFU] Unknown Characteristic : %d", attributeHandle);
-    return 0;
-  }
-}
-
-int DfuService::SendDfuRevision(os_mbuf* om) const {
-  int res = os_mbuf_append(om, &revision, sizeof(revision));
-  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
-}
-
-int DfuService::WritePacketHandler(uint16_t connectionHandle, os_mbuf* om) {
+  os_mbuf* om = context->om;
   switch (state) {
     case States::Start: {
       softdeviceSize = om->om_data[0] + (om->om_data[1] << 8) + (om->om_data[2] << 16) + (om->om_data[3] << 24);
@@ -191,7 +144,12 @@ int DfuService::WritePacketHandler(uint16_t connectionHandle, os_mbuf* om) {
   return 0;
 }
 
-int DfuService::ControlPointHandler(uint16_t connectionHandle, os_mbuf* om) {
+int DfuService::ControlPointHandler(uint16_t connectionHandle, ble_gatt_access_ctxt* context) {
+  if (bleController.IsFirmwareUpdating()) {
+    xTimerStart(timeoutTimer, 0);
+  }
+
+  os_mbuf* om = context->om;
   auto opcode = static_cast<Opcodes>(om->om_data[0]);
   NRF_LOG_INFO("[DFU] -> ControlPointHandler");
 
@@ -8,6 +8,7 @@
 #include <host/ble_gap.h>
 #undef max
 #undef min
+#include "components/ble/GattServiceTable.h"
 
 namespace Pinetime {
   namespace System {
@@ -25,7 +26,6 @@ namespace Pinetime {
                  Pinetime::Controllers::Ble& bleController,
                  Pinetime::Drivers::SpiNorFlash& spiNorFlash);
       void Init();
-      int OnServiceData(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context);
       void OnTimeout();
       void Reset();
 
@@ -102,11 +102,10 @@ namespace Pinetime {
         .u {.type = BLE_UUID_TYPE_128},
         .value = {0x23, 0xD1, 0xBC, 0xEA, 0x5F, 0x78, 0x23, 0x15, 0xDE, 0xEF, 0x12, 0x12, 0x34, 0x15, 0x00, 0x00}};
 
-      struct ble_gatt_chr_def characteristicDefinition[4];
-      struct ble_gatt_svc_def serviceDefinition[2];
+      static const GattCharacteristic<DfuService> characteristics[3];
+      GattServiceTable<DfuService, 3> gattService;
       uint16_t packetCharacteristicHandle;
       uint16_t controlPointCharacteristicHandle;
-      uint16_t revisionCharacteristicHandle;
 
       enum class States : uint8_t { Idle, Init, Start, Data, Validate, Validated };
       States state = States::Idle;
@@ -148,9 +147,9 @@ namespace Pinetime {
       uint32_t applicationSize = 0;
       uint16_t expectedCrc = 0;
 
-      int SendDfuRevision(os_mbuf* om) const;
-      int WritePacketHandler(uint16_t connectionHandle, os_mbuf* om);
-      int ControlPointHandler(uint16_t connectionHandle, os_mbuf* om);
+      int SendDfuRevision(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int WritePacketHandler(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int ControlPointHandler(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
 
       TimerHandle_t timeoutTimer;
     };
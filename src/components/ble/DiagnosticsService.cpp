@@ -0,0 +1,124 @@
+#include "components/ble/DiagnosticsService.h"
+#include "logging/Trace.h"
+#include "systemtask/SystemTask.h"
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  // 0006yyxx-78fc-48fe-8e23-433b3a1942d0
+  constexpr ble_uuid128_t CharUuid(uint8_t x, uint8_t y) {
+    return ble_uuid128_t {.u = {.type = BLE_UUID_TYPE_128},
+                          .value = {0xd0, 0x42, 0x19, 0x3a, 0x3b, 0x43, 0x23, 0x8e, 0xfe, 0x48, 0xfc, 0x78, x, y, 0x06, 0x00}};
+  }
+
+  // 00060000-78fc-48fe-8e23-433b3a1942d0
+  constexpr ble_uuid128_t BaseUuid() {
+    return CharUuid(0x00, 0x00);
+  }
+
+  constexpr ble_uuid128_t diagnosticsServiceUuid {BaseUuid()};
+  constexpr ble_uuid128_t runTimeStatsCharUuid {CharUuid(0x01, 0x00)};
+  constexpr ble_uuid128_t traceControlCharUuid {CharUuid(0x02, 0x00)};
+
+  uint8_t* Write16(uint8_t* buffer, uint16_t value) {
+    buffer[0] = value & 0xff;
+    buffer[1] = (value >> 8) & 0xff;
+    return buffer + 2;
+  }
+
+  uint8_t* Write32(uint8_t* buffer, uint32_t value) {
+    return Write16(Write16(buffer, value & 0xffff), value >> 16);
+  }
+
+  using RunTimeStats = Pinetime::System::RunTimeStats;
+  constexpr size_t runTimeStatsMaxSize = 14 + 1 + RunTimeStats::NbTopWakeupSources * 3 + 1 + RunTimeStats::MaxTasks * 8;
+}
+
+const GattCharacteristic<DiagnosticsService> DiagnosticsService::characteristics[2] = {
+  {.uuid = &runTimeStatsCharUuid.u,
+   .flags = BLE_GATT_CHR_F_READ,
+   .onRead = &DiagnosticsService::OnRunTimeStatsRead,
+   .onWrite = nullptr,
+   .valueHandle = nullptr},
+  {.uuid = &traceControlCharUuid.u,
+   .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_WRITE,
+   .onRead = &DiagnosticsService::OnTraceControlRead,
+   .onWrite = &DiagnosticsService::OnTraceControlWritten,
+   .valueHandle = nullptr},
+};
+
+DiagnosticsService::DiagnosticsService(Pinetime::System::SystemTask& system)
+  : gattService {*this, &diagnosticsServiceUuid.u, characteristics}, system {system} {
+}
+
+void DiagnosticsService::Init() {
+  gattService.Init();
+}
+
+int DiagnosticsService::OnRunTimeStatsRead(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* context) {
+  const RunTimeStats::Statistics statistics = system.GetRunTimeStatistics();
+
+  uint8_t buffer[runTimeStatsMaxSize];
+  uint8_t* ptr = buffer;
+  *ptr++ = runTimeStatsFormatVersion;
+  *ptr++ = 0; // reserved
+  ptr = Write32(ptr, statistics.periodMs);
+  ptr = Write16(ptr, statistics.cpuLoadPermille);
+  ptr = Write16(ptr, statistics.idlePermille);
+  ptr = Write16(ptr, statistics.sleepPermille);
+  ptr = Write16(ptr, statistics.wakeupsPerSecond);
+
+  *ptr++ = statistics.nbTopWakeupSources;
+  for (uint8_t i = 0; i < statistics.nbTopWakeupSources; i++) {
+    *ptr++ = statistics.topWakeupSources[i].source;
+    ptr = Write16(ptr, statistics.topWakeupSources[i].count);
+  }
+
+  *ptr++ = statistics.nbTasks;
+  for (uint8_t i = 0; i < statistics.nbTasks; i++) {
+    const RunTimeStats::TaskLoad& task = statistics.tasks[i];
+    for (size_t c = 0; c < RunTimeStats::TaskNameSize; c++) {
+      *ptr++ = static_cast<uint8_t>(task.name[c]);
+    }
+    ptr = Write16(ptr, task.loadPermille);
+    ptr = Write16(ptr, task.stackHighWaterMark);
+  }
+
+  int res = os_mbuf_append(context->om, buffer, ptr - buffer);
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
+
+int DiagnosticsService::OnTraceControlRead(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* context) {
+  uint8_t buffer[6];
+  buffer[0] = Logging::Trace::IsRunning() ? 1 : 0;
+  Write32(buffer + 1, Logging::Trace::NbRecorded());
+  buffer[5] = static_cast<uint8_t>(Logging::Trace::GetDumpState());
+
+  int res = os_mbuf_append(context->om, buffer, sizeof(buffer));
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
+
+int DiagnosticsService::OnTraceControlWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* context) {
+  if (OS_MBUF_PKTLEN(context->om) != 1) {
+    return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+  }
+  uint8_t command = 0;
+  os_mbuf_copydata(context->om, 0, 1, &command);
+
+  switch (static_cast<TraceCommands>(command)) {
+    case TraceCommands::Stop:
+      Logging::Trace::Stop();
+      return 0;
+    case TraceCommands::Start:
+      return Logging::Trace::Start() ? 0 : BLE_ATT_ERR_REQ_NOT_SUPPORTED;
+    case TraceCommands::Dump:
+      // Writing the file takes a while: it is done by the system task, not in the BLE host task
+      if (!Logging::Trace::RequestDump()) {
+        return BLE_ATT_ERR_REQ_NOT_SUPPORTED;
+      }
+      system.PushMessage(Pinetime::System::Messages::DumpTrace);
+      return 0;
+    default:
+      return BLE_ATT_ERR_VALUE_NOT_ALLOWED;
+  }
+}
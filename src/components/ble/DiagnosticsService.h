@@ -0,0 +1,39 @@
+#pragma once
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <host/ble_gap.h>
+#undef max
+#undef min
+#include "components/ble/GattServiceTable.h"
+
+namespace Pinetime {
+  namespace System {
+    class SystemTask;
+  }
+  namespace Controllers {
+    /**
+     * Exposes the run-time statistics of the system (CPU load, sleep ratio, wake-ups and load of each task), and
+     * controls the binary trace (see logging/Trace.h).
+     * See doc/DiagnosticsService.md for the description of the binary format.
+     */
+    class DiagnosticsService {
+    public:
+      static constexpr uint8_t runTimeStatsFormatVersion = 1;
+
+      enum class TraceCommands : uint8_t { Stop = 0, Start = 1, Dump = 2 };
+
+      explicit DiagnosticsService(Pinetime::System::SystemTask& system);
+      void Init();
+
+    private:
+      static const GattCharacteristic<DiagnosticsService> characteristics[2];
+      GattServiceTable<DiagnosticsService, 2> gattService;
+
+      Pinetime::System::SystemTask& system;
+
+      int OnRunTimeStatsRead(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnTraceControlRead(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnTraceControlWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+    };
+  }
+}
@@ -9,58 +9,37 @@ constexpr ble_uuid16_t FSService::fsServiceUuid;
 constexpr ble_uuid128_t FSService::fsVersionUuid;
 constexpr ble_uuid128_t FSService::fsTransferUuid;
 
-int FSServiceCallback(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
-  auto* fsService = static_cast<FSService*>(arg);
-  return fsService->OnFSServiceRequested(conn_handle, attr_handle, ctxt);
-}
+const GattCharacteristic<FSService> FSService::characteristics[2] = {
+  {.uuid = &fsVersionUuid.u,
+   .flags = BLE_GATT_CHR_F_READ,
+   .onRead = &FSService::OnVersionRead,
+   .onWrite = nullptr,
+   .valueHandle = &FSService::versionCharacteristicHandle},
+  {.uuid = &fsTransferUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
+   .onRead = nullptr,
+   .onWrite = &FSService::FSCommandHandler,
+   .valueHandle = &FSService::transferCharacteristicHandle},
+};
 
 FSService::FSService(Pinetime::System::SystemTask& systemTask, Pinetime::Controllers::FS& fs)
   : systemTask {systemTask},
     fs {fs},
-    characteristicDefinition {{.uuid = &fsVersionUuid.u,
-                               .access_cb = FSServiceCallback,
-                               .arg = this,
-                               .flags = BLE_GATT_CHR_F_READ,
-                               .val_handle = &versionCharacteristicHandle},
-                              {
-                                .uuid = &fsTransferUuid.u,
-                                .access_cb = FSServiceCallback,
-                                .arg = this,
-                                .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
-                                .val_handle = &transferCharacteristicHandle,
-                              },
-                              {0}},
-    serviceDefinition {
-      {/* Device Information Service */
-       .type = BLE_GATT_SVC_TYPE_PRIMARY,
-       .uuid = &fsServiceUuid.u,
-       .characteristics = characteristicDefinition},
-      {0},
-    } {
+    gattService {*this, &fsServiceUuid.u, characteristics} {
 }
 
 void FSService::Init() {
-  int res = 0;
-  res = ble_gatts_count_cfg(serviceDefinition);
-  ASSERT(res == 0);
-
-  res = ble_gatts_add_svcs(serviceDefinition);
-  ASSERT(res == 0);
+  gattService.Init();
 }
 
-int FSService::OnFSServiceRequested(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context) {
-  if (attributeHandle == versionCharacteristicHandle) {
-    NRF_LOG_INFO("FS_S : handle = %d", versionCharacteristicHandle);
-    int res = os_mbuf_append(context->om, &fsVersion, sizeof(fsVersion));
-    return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
-  }
-  if (attributeHandle == transferCharacteristicHandle) {
-    return FSCommandHandler(connectionHandle, context->om);
-  }
-  return 0;
+int FSService::OnVersionRead(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* context) {
+  NRF_LOG_INFO("FS_S : handle = %d", versionCharacteristicHandle);
+  int res = os_mbuf_append(context->om, &fsVersion, sizeof(fsVersion));
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
 }
 
-int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
+int FSService::FSCommandHandler(uint16_t connectionHandle, ble_gatt_access_ctxt* context) {
+  os_mbuf* om = context->om;
   auto command = static_cast<commands>(om->om_data[0]);
   NRF_LOG_INFO("[FS_S] -> FSCommandHandler Command %d", command);
   // Just always make sure we are awake...
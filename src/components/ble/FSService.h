@@ -5,6 +5,7 @@
 #undef max
 #undef min
 
+#include "components/ble/GattServiceTable.h"
 #include "components/fs/FS.h"
 
 namespace Pinetime {
@@ -18,7 +19,6 @@ namespace Pinetime {
       FSService(Pinetime::System::SystemTask& systemTask, Pinetime::Controllers::FS& fs);
       void Init();
 
-      int OnFSServiceRequested(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context);
       void NotifyFSRaw(uint16_t connectionHandle);
 
     private:
@@ -41,8 +41,8 @@ namespace Pinetime {
         .u {.type = BLE_UUID_TYPE_128},
         .value = {0x72, 0x65, 0x66, 0x73, 0x6e, 0x61, 0x72, 0x54, 0x65, 0x6c, 0x69, 0x46, 0x00, 0x02, 0xAF, 0xAD}};
 
-      struct ble_gatt_chr_def characteristicDefinition[3];
-      struct ble_gatt_svc_def serviceDefinition[2];
+      static const GattCharacteristic<FSService> characteristics[2];
+      GattServiceTable<FSService, 2> gattService;
       uint16_t versionCharacteristicHandle;
       uint16_t transferCharacteristicHandle;
 
@@ -184,7 +184,8 @@ namespace Pinetime {
         uint8_t status;
       };
 
-      int FSCommandHandler(uint16_t connectionHandle, os_mbuf* om);
+      int OnVersionRead(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int FSCommandHandler(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
       void prepareReadDataResp(ReadHeader* header, ReadResponse* resp);
     };
   }
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <host/ble_gatt.h>
+#undef max
+#undef min
+#include <nrf_assert.h>
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Compile-time description of a characteristic of a service implemented by Service
+     */
+    template <typename Service>
+    struct GattCharacteristic {
+      using Handler = int (Service::*)(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+
+      const ble_uuid_t* uuid;
+      ble_gatt_chr_flags flags;
+      // Called on read/write accesses, nullptr to accept the access without doing anything
+      Handler onRead;
+      Handler onWrite;
+      // Member of Service that receives the value handle of the characteristic, nullptr if the service doesn't need it
+      uint16_t Service::*valueHandle;
+    };
+
+    /**
+     * Registers a GATT service described by a table of characteristics, and dispatches the accesses to the handlers
+     * of the table.
+     *
+     * NimBLE fills the value handles when the GATT server is started. They are indexed on the first access: then an
+     * access is dispatched by its attribute handle in constant time, instead of comparing UUIDs or looking the
+     * characteristics up with ble_gatts_find_chr().
+     */
+    template <typename Service, size_t N>
+    class GattServiceTable {
+    public:
+      GattServiceTable(Service& service, const ble_uuid_t* serviceUuid, const GattCharacteristic<Service> (&characteristics)[N])
+        : service {service}, characteristics {characteristics} {
+        for (size_t i = 0; i < N; i++) {
+          const GattCharacteristic<Service>& characteristic = characteristics[i];
+          valueHandles[i] = (characteristic.valueHandle != nullptr) ? &(service.*characteristic.valueHandle) : &ownValueHandles[i];
+          characteristicDefinition[i] = {.uuid = characteristic.uuid,
+                                         .access_cb = OnAccess,
+                                         .arg = this,
+                                         .descriptors = nullptr,
+                                         .flags = characteristic.flags,
+                                         .min_key_size = 0,
+                                         .val_handle = valueHandles[i]};
+        }
+        characteristicDefinition[N] = {};
+
+        serviceDefinition[0] = {.type = BLE_GATT_SVC_TYPE_PRIMARY,
+                                .uuid = serviceUuid,
+                                .includes = nullptr,
+                                .characteristics = characteristicDefinition};
+        serviceDefinition[1] = {};
+      }
+
+      GattServiceTable(const GattServiceTable&) = delete;
+      GattServiceTable& operator=(const GattServiceTable&) = delete;
+
+      void Init() {
+        int res = 0;
+        res = ble_gatts_count_cfg(serviceDefinition);
+        ASSERT(res == 0);
+
+        res = ble_gatts_add_svcs(serviceDefinition);
+        ASSERT(res == 0);
+      }
+
+      int Dispatch(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context) {
+        size_t idx = IndexOf(attributeHandle);
+        if (idx == N) {
+          return 0;
+        }
+
+        typename GattCharacteristic<Service>::Handler handler = nullptr;
+        if (context->op == BLE_GATT_ACCESS_OP_READ_CHR) {
+          handler = characteristics[idx].onRead;
+        } else if (context->op == BLE_GATT_ACCESS_OP_WRITE_CHR) {
+          handler = characteristics[idx].onWrite;
+        }
+        if (handler == nullptr) {
+          return 0;
+        }
+        return (service.*handler)(connectionHandle, context);
+      }
+
+      /// Value handle of the characteristic at idx in the table, 0 until the GATT server is started
+      uint16_t ValueHandle(size_t idx) const {
+        return *valueHandles[idx];
+      }
+
+      /// Definition of the service registered with NimBLE, terminated by an empty service
+      const ble_gatt_svc_def* Definition() const {
+        return serviceDefinition;
+      }
+
+    private:
+      static int OnAccess(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context, void* arg) {
+        return static_cast<GattServiceTable*>(arg)->Dispatch(connectionHandle, attributeHandle, context);
+      }
+
+      // Value handles are allocated in sequence: each characteristic uses at most a declaration, a value and a CCCD
+      static constexpr size_t IndexSize = 3 * N;
+      static_assert(N < UINT8_MAX, "Too many characteristics");
+
+      size_t IndexOf(uint16_t attributeHandle) {
+        if (!indexed) {
+          BuildIndex();
+          if (!indexed) {
+            // No value handle yet: they are all 0
+            return N;
+          }
+        }
+        uint16_t offset = attributeHandle - firstHandle;
+        if (attributeHandle >= firstHandle && offset < IndexSize && index[offset] != N) {
+          return index[offset];
+        }
+        // Not expected with the usual handle layout, but never dispatch to the wrong handler
+        for (size_t i = 0; i < N; i++) {
+          if (*valueHandles[i] == attributeHandle) {
+            return i;
+          }
+        }
+        return N;
+      }
+
+      void BuildIndex() {
+        if (*valueHandles[0] == 0) {
+          // The GATT server is not started yet
+          return;
+        }
+        firstHandle = *valueHandles[0];
+        for (size_t i = 1; i < N; i++) {
+          if (*valueHandles[i] < firstHandle) {
+            firstHandle = *valueHandles[i];
+          }
+        }
+        index.fill(N);
+        for (size_t i = 0; i < N; i++) {
+          uint16_t offset = *valueHandles[i] - firstHandle;
+          if (offset < IndexSize) {
+            index[offset] = i;
+          }
+        }
+        indexed = true;
+      }
+
+      Service& service;
+      const GattCharacteristic<Service> (&characteristics)[N];
+
+      std::array<uint16_t*, N> valueHandles;
+      std::array<uint16_t, N> ownValueHandles {};
+      ble_gatt_chr_def characteristicDefinition[N + 1];
+      ble_gatt_svc_def serviceDefinition[2];
+
+      bool indexed = false;
+      uint16_t firstHandle = 0;
+      std::array<uint8_t, IndexSize> index;
+    };
+  }
+}
@@ -1,18 +1,28 @@
 #include "components/ble/HeartRateService.h"
+#include "components/ble/RawPpgPacket.h"
 #include "components/heartrate/HeartRateController.h"
 #include "systemtask/SystemTask.h"
+#include <nimble/nimble_port.h>
 #include <nrf_log.h>
+#include <algorithm>
 
 using namespace Pinetime::Controllers;
 
 constexpr ble_uuid16_t HeartRateService::heartRateServiceUuid;
 constexpr ble_uuid16_t HeartRateService::heartRateMeasurementUuid;
+constexpr ble_uuid128_t HeartRateService::rawPpgUuid;
 
 namespace {
   int HeartRateServiceCallback(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
     auto* heartRateService = static_cast<HeartRateService*>(arg);
     return heartRateService->OnHeartRateRequested(conn_handle, attr_handle, ctxt);
   }
+
+  void RawPpgEventCallback(struct ble_npl_event* event) {
+    auto* heartRateService = static_cast<HeartRateService*>(ble_npl_event_get_arg(event));
+    heartRateService->FlushRawSamples();
+  }
+
 }
 
 // TODO Refactoring - remove dependency to SystemTask
@@ -24,6 +34,11 @@ HeartRateService::HeartRateService(Pinetime::System::SystemTask& system, Control
                                .arg = this,
                                .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
                                .val_handle = &heartRateMeasurementHandle},
+                              {.uuid = &rawPpgUuid.u,
+                               .access_cb = HeartRateServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_NOTIFY,
+                               .val_handle = &rawPpgHandle},
                               {0}},
     serviceDefinition {
       {/* Device Information Service */
@@ -34,6 +49,7 @@ HeartRateService::HeartRateService(Pinetime::System::SystemTask& system, Control
     } {
   // TODO refactor to prevent this loop dependency (service depends on controller and controller depends on service)
   heartRateController.SetService(this);
+  ble_npl_event_init(&rawPpgEvent, RawPpgEventCallback, this);
 }
 
 void HeartRateService::Init() {
@@ -72,12 +88,71 @@ void HeartRateService::OnNewHeartRateValue(uint8_t heartRateValue) {
   ble_gattc_notify_custom(connectionHandle, heartRateMeasurementHandle, om);
 }
 
+void HeartRateService::OnNewRawSamples() {
+  if (heartRateController.RawSamples().Size() >= rawSamplesPerFlush) {
+    ble_npl_eventq_put(nimble_port_get_dflt_eventq(), &rawPpgEvent);
+  }
+}
+
+void HeartRateService::FlushRawSamples() {
+  auto& samples = heartRateController.RawSamples();
+  uint16_t connectionHandle = system.nimble().connHandle();
+
+  if (!rawPpgNotificationEnable || connectionHandle == 0 || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
+    samples.Discard(samples.Size());
+    return;
+  }
+
+  const size_t samplesPerPacket = RawPpgPacket::SamplesPerPacket(ble_att_mtu(connectionHandle));
+  if (samplesPerPacket == 0) {
+    return;
+  }
+
+  HeartRateController::RawSample first;
+  while (samples.Peek(first, 0)) {
+    const size_t count = std::min(samples.Size(), samplesPerPacket);
+
+    // Returns nullptr when the mbuf pool is exhausted: keep the samples, the next flush will retry
+    auto* om = ble_hs_mbuf_att_pkt();
+    if (om == nullptr) {
+      return;
+    }
+
+    uint8_t header[RawPpgPacket::headerSize];
+    RawPpgPacket::EncodeHeader(header, static_cast<uint8_t>(count), rawSequence, heartRateController.DroppedRawSamples(), first.timestamp);
+    int res = os_mbuf_append(om, header, sizeof(header));
+
+    HeartRateController::RawSample sample;
+    for (size_t i = 0; i < count && res == 0 && samples.Peek(sample, i); i++) {
+      uint8_t data[RawPpgPacket::sampleSize];
+      RawPpgPacket::EncodeSample(data, first.timestamp, sample.timestamp, sample.hrs, sample.als, sample.agcPeak);
+      res = os_mbuf_append(om, data, sizeof(data));
+    }
+
+    if (res != 0) {
+      os_mbuf_free_chain(om);
+      return;
+    }
+
+    if (ble_gattc_notify_custom(connectionHandle, rawPpgHandle, om) != 0) {
+      return;
+    }
+
+    rawSequence++;
+    samples.Discard(count);
+  }
+}
+
 void HeartRateService::SubscribeNotification(uint16_t connectionHandle, uint16_t attributeHandle) {
   if (attributeHandle == heartRateMeasurementHandle)
     heartRateMeasurementNotificationEnable = true;
+  else if (attributeHandle == rawPpgHandle)
+    rawPpgNotificationEnable = true;
 }
 
 void HeartRateService::UnsubscribeNotification(uint16_t connectionHandle, uint16_t attributeHandle) {
   if (attributeHandle == heartRateMeasurementHandle)
     heartRateMeasurementNotificationEnable = false;
+  else if (attributeHandle == rawPpgHandle)
+    rawPpgNotificationEnable = false;
 }
\ No newline at end of file
@@ -2,7 +2,9 @@
 #define min // workaround: nimble's min/max macros conflict with libstdc++
 #define max
 #include <host/ble_gap.h>
+#include <nimble/nimble_npl.h>
 #include <atomic>
+#include <cstddef>
 #undef max
 #undef min
 
@@ -19,6 +21,17 @@ namespace Pinetime {
       int OnHeartRateRequested(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context);
       void OnNewHeartRateValue(uint8_t hearRateValue);
 
+      bool IsRawStreamEnabled() const {
+        return rawPpgNotificationEnable;
+      }
+      /// Called from the heart rate task: schedules the notification of the buffered raw samples in the BLE host task
+      void OnNewRawSamples();
+      /// Runs in the BLE host task
+      void FlushRawSamples();
+
+      // The raw PPG packets are encoded by RawPpgPacket
+      static constexpr size_t rawSamplesPerFlush = 8;
+
       void SubscribeNotification(uint16_t connectionHandle, uint16_t attributeHandle);
       void UnsubscribeNotification(uint16_t connectionHandle, uint16_t attributeHandle);
 
@@ -32,11 +45,20 @@ namespace Pinetime {
 
       static constexpr ble_uuid16_t heartRateMeasurementUuid {.u {.type = BLE_UUID_TYPE_16}, .value = heartRateMeasurementId};
 
-      struct ble_gatt_chr_def characteristicDefinition[2];
+      static constexpr ble_uuid128_t rawPpgUuid {
+        .u {.type = BLE_UUID_TYPE_128},
+        .value = {0xd0, 0x42, 0x19, 0x3a, 0x3b, 0x43, 0x23, 0x8e, 0xfe, 0x48, 0xfc, 0x78, 0x01, 0x00, 0x05, 0x00}};
+
+      struct ble_gatt_chr_def characteristicDefinition[3];
       struct ble_gatt_svc_def serviceDefinition[2];
 
       uint16_t heartRateMeasurementHandle;
+      uint16_t rawPpgHandle;
       std::atomic_bool heartRateMeasurementNotificationEnable {false};
+      std::atomic_bool rawPpgNotificationEnable {false};
+
+      struct ble_npl_event rawPpgEvent;
+      uint16_t rawSequence = 0;
     };
   }
 }
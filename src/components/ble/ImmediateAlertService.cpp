@@ -62,10 +62,7 @@ int ImmediateAlertService::OnAlertLevelChanged(uint16_t connectionHandle, uint16
       auto alertLevel = static_cast<Levels>(context->om->om_data[0]);
       auto* alertString = ToString(alertLevel);
 
-      NotificationManager::Notification notif;
-      std::memcpy(notif.message.data(), alertString, strlen(alertString));
-      notif.category = Pinetime::Controllers::NotificationManager::Categories::SimpleAlert;
-      notificationManager.Push(std::move(notif));
+      notificationManager.Push(NotificationManager::Categories::SimpleAlert, alertString, strlen(alertString) + 1);
 
       systemTask.PushMessage(Pinetime::System::Messages::OnNewNotification);
     }
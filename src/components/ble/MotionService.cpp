@@ -20,58 +20,76 @@ namespace {
   constexpr ble_uuid128_t motionServiceUuid {BaseUuid()};
   constexpr ble_uuid128_t stepCountCharUuid {CharUuid(0x01, 0x00)};
   constexpr ble_uuid128_t motionValuesCharUuid {CharUuid(0x02, 0x00)};
-
-  int MotionServiceCallback(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
-    auto* motionService = static_cast<MotionService*>(arg);
-    return motionService->OnStepCountRequested(conn_handle, attr_handle, ctxt);
-  }
+  constexpr ble_uuid128_t motionStreamCharUuid {CharUuid(0x03, 0x00)};
+  constexpr ble_uuid128_t motionStreamRateCharUuid {CharUuid(0x04, 0x00)};
 }
 
+const GattCharacteristic<MotionService> MotionService::characteristics[4] = {
+  {.uuid = &stepCountCharUuid.u,
+   .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
+   .onRead = &MotionService::OnStepCountRead,
+   .onWrite = nullptr,
+   .valueHandle = &MotionService::stepCountHandle},
+  {.uuid = &motionValuesCharUuid.u,
+   .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
+   .onRead = &MotionService::OnMotionValuesRead,
+   .onWrite = nullptr,
+   .valueHandle = &MotionService::motionValuesHandle},
+  {.uuid = &motionStreamCharUuid.u,
+   .flags = BLE_GATT_CHR_F_NOTIFY,
+   .onRead = nullptr,
+   .onWrite = nullptr,
+   .valueHandle = &MotionService::motionStreamHandle},
+  {.uuid = &motionStreamRateCharUuid.u,
+   .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_WRITE,
+   .onRead = &MotionService::OnMotionStreamRateRead,
+   .onWrite = &MotionService::OnMotionStreamRateWritten,
+   .valueHandle = &MotionService::motionStreamRateHandle},
+};
+
 // TODO Refactoring - remove dependency to SystemTask
 MotionService::MotionService(Pinetime::System::SystemTask& system, Controllers::MotionController& motionController)
-  : system {system},
-    motionController {motionController},
-    characteristicDefinition {{.uuid = &stepCountCharUuid.u,
-                               .access_cb = MotionServiceCallback,
-                               .arg = this,
-                               .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
-                               .val_handle = &stepCountHandle},
-                              {.uuid = &motionValuesCharUuid.u,
-                               .access_cb = MotionServiceCallback,
-                               .arg = this,
-                               .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
-                               .val_handle = &motionValuesHandle},
-                              {0}},
-    serviceDefinition {
-      {.type = BLE_GATT_SVC_TYPE_PRIMARY, .uuid = &motionServiceUuid.u, .characteristics = characteristicDefinition},
-      {0},
-    } {
+  : gattService {*this, &motionServiceUuid.u, characteristics}, system {system}, motionController {motionController} {
   // TODO refactor to prevent this loop dependency (service depends on controller and controller depends on service)
   motionController.SetService(this);
 }
 
 void MotionService::Init() {
-  int res = 0;
-  res = ble_gatts_count_cfg(serviceDefinition);
-  ASSERT(res == 0);
+  gattService.Init();
+}
+
+int MotionService::OnStepCountRead(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* context) {
+  NRF_LOG_INFO("Motion-stepcount : handle = %d", stepCountHandle);
+  uint32_t buffer = motionController.NbSteps();
 
-  res = ble_gatts_add_svcs(serviceDefinition);
-  ASSERT(res == 0);
+  int res = os_mbuf_append(context->om, &buffer, 4);
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
 }
 
-int MotionService::OnStepCountRequested(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context) {
-  if (attributeHandle == stepCountHandle) {
-    NRF_LOG_INFO("Motion-stepcount : handle = %d", stepCountHandle);
-    uint32_t buffer = motionController.NbSteps();
+int MotionService::OnMotionValuesRead(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* context) {
+  int16_t buffer[3] = {motionController.X(), motionController.Y(), motionController.Z()};
 
-    int res = os_mbuf_append(context->om, &buffer, 4);
-    return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
-  } else if (attributeHandle == motionValuesHandle) {
-    int16_t buffer[3] = {motionController.X(), motionController.Y(), motionController.Z()};
+  int res = os_mbuf_append(context->om, buffer, 3 * sizeof(int16_t));
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
+
+int MotionService::OnMotionStreamRateRead(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* context) {
+  uint8_t rate = motionStreamRate;
+  int res = os_mbuf_append(context->om, &rate, 1);
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
 
-    int res = os_mbuf_append(context->om, buffer, 3 * sizeof(int16_t));
-    return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+int MotionService::OnMotionStreamRateWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* context) {
+  if (OS_MBUF_PKTLEN(context->om) != 1) {
+    return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
   }
+  uint8_t rate = 0;
+  os_mbuf_copydata(context->om, 0, 1, &rate);
+  if (rate < streamMinRate || rate > streamMaxRate) {
+    return BLE_ATT_ERR_VALUE_NOT_ALLOWED;
+  }
+  motionStreamRate = rate;
+  NRF_LOG_INFO("Motion-stream : rate = %d Hz", rate);
   return 0;
 }
 
@@ -106,11 +124,42 @@ void MotionService::OnNewMotionValues(int16_t x, int16_t y, int16_t z) {
   ble_gattc_notify_custom(connectionHandle, motionValuesHandle, om);
 }
 
+void MotionService::FlushMotionStream() {
+  if (!motionStreamNotificationEnabled) {
+    stream.Clear();
+    return;
+  }
+
+  uint16_t connectionHandle = system.nimble().connHandle();
+
+  if (connectionHandle == 0 || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
+    return;
+  }
+
+  const size_t packetSize = MotionStream::PacketSize(ble_att_mtu(connectionHandle));
+  uint8_t packet[MotionStream::maxPacketSize];
+  size_t nbSamples;
+  size_t size;
+  while ((size = stream.Encode(packet, packetSize, nbSamples)) > 0) {
+    // Returns nullptr when the mbuf pool is exhausted: keep the samples and retry on the next flush
+    auto* om = ble_hs_mbuf_from_flat(packet, size);
+    if (om == nullptr) {
+      return;
+    }
+    if (ble_gattc_notify_custom(connectionHandle, motionStreamHandle, om) != 0) {
+      return;
+    }
+    stream.Consume(nbSamples);
+  }
+}
+
 void MotionService::SubscribeNotification(uint16_t connectionHandle, uint16_t attributeHandle) {
   if (attributeHandle == stepCountHandle)
     stepCountNoficationEnabled = true;
   else if (attributeHandle == motionValuesHandle)
     motionValuesNoficationEnabled = true;
+  else if (attributeHandle == motionStreamHandle)
+    motionStreamNotificationEnabled = true;
 }
 
 void MotionService::UnsubscribeNotification(uint16_t connectionHandle, uint16_t attributeHandle) {
@@ -118,4 +167,6 @@ void MotionService::UnsubscribeNotification(uint16_t connectionHandle, uint16_t
     stepCountNoficationEnabled = false;
   else if (attributeHandle == motionValuesHandle)
     motionValuesNoficationEnabled = false;
+  else if (attributeHandle == motionStreamHandle)
+    motionStreamNotificationEnabled = false;
 }
@@ -2,9 +2,13 @@
 #define min // workaround: nimble's min/max macros conflict with libstdc++
 #define max
 #include <host/ble_gap.h>
+#include <array>
 #include <atomic>
+#include <cstddef>
 #undef max
 #undef min
+#include "components/ble/GattServiceTable.h"
+#include "components/ble/MotionStream.h"
 
 namespace Pinetime {
   namespace System {
@@ -14,26 +18,56 @@ namespace Pinetime {
     class MotionController;
     class MotionService {
     public:
+      static constexpr uint8_t streamMinRate = 1;
+      static constexpr uint8_t streamMaxRate = 100;
+      static constexpr uint8_t streamDefaultRate = 25;
+
       MotionService(Pinetime::System::SystemTask& system, Controllers::MotionController& motionController);
       void Init();
-      int OnStepCountRequested(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context);
       void OnNewStepCountValue(uint32_t stepCount);
       void OnNewMotionValues(int16_t x, int16_t y, int16_t z);
+      /// Reads the nbFrames frames of the accelerometer FIFO with read() and sends them on the motion stream (see
+      /// MotionStream::ReadFifo())
+      template <typename Read>
+      void ReadMotionFifo(size_t nbFrames, uint32_t now, Read read) {
+        stream.ReadFifo(nbFrames, now, motionStreamRate, read, [this]() {
+          FlushMotionStream();
+        });
+      }
+      void FlushMotionStream();
+
+      bool IsMotionStreamEnabled() const {
+        return motionStreamNotificationEnabled;
+      }
+      uint8_t MotionStreamRate() const {
+        return motionStreamRate;
+      }
 
       void SubscribeNotification(uint16_t connectionHandle, uint16_t attributeHandle);
       void UnsubscribeNotification(uint16_t connectionHandle, uint16_t attributeHandle);
 
     private:
+      static const GattCharacteristic<MotionService> characteristics[4];
+      GattServiceTable<MotionService, 4> gattService;
+
       Pinetime::System::SystemTask& system;
       Controllers::MotionController& motionController;
 
-      struct ble_gatt_chr_def characteristicDefinition[3];
-      struct ble_gatt_svc_def serviceDefinition[2];
+      int OnStepCountRead(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnMotionValuesRead(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnMotionStreamRateRead(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnMotionStreamRateWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
 
       uint16_t stepCountHandle;
       uint16_t motionValuesHandle;
+      uint16_t motionStreamHandle;
+      uint16_t motionStreamRateHandle;
       std::atomic_bool stepCountNoficationEnabled {false};
       std::atomic_bool motionValuesNoficationEnabled {false};
+      std::atomic_bool motionStreamNotificationEnabled {false};
+      std::atomic<uint8_t> motionStreamRate {streamDefaultRate};
+
+      MotionStream stream;
     };
   }
 }
@@ -0,0 +1,90 @@
+#include "components/ble/MotionStream.h"
+#include <algorithm>
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  void Write16(uint8_t* buffer, uint16_t value) {
+    buffer[0] = value & 0xff;
+    buffer[1] = (value >> 8) & 0xff;
+  }
+
+  void Write32(uint8_t* buffer, uint32_t value) {
+    Write16(buffer, value & 0xffff);
+    Write16(buffer + 2, value >> 16);
+  }
+}
+
+size_t MotionStream::PacketSize(uint16_t mtu) {
+  constexpr uint16_t attHeaderSize = 3;
+  if (mtu <= attHeaderSize) {
+    return 0;
+  }
+  const size_t packetSize = mtu - attHeaderSize;
+  return packetSize < maxPacketSize ? packetSize : maxPacketSize;
+}
+
+uint32_t MotionStream::FramesDuration(size_t nbFrames) {
+  return static_cast<uint32_t>(nbFrames * 1000 / Drivers::Bma421::FifoSampleRate);
+}
+
+void MotionStream::PushFrames(const Drivers::Bma421::AccelValues* frames, size_t nbFrames, uint32_t timestamp, uint8_t rate) {
+  const uint16_t decimation = std::max(1, Drivers::Bma421::FifoSampleRate / std::max<uint8_t>(rate, 1));
+  for (size_t i = 0; i < nbFrames; i++) {
+    if (decimationCounter == 0) {
+      Push({timestamp + FramesDuration(i), frames[i].x, frames[i].y, frames[i].z});
+    }
+    decimationCounter = (decimationCounter + 1) % decimation;
+  }
+}
+
+void MotionStream::Push(const Sample& sample) {
+  if (count == buffer.size()) {
+    // The host doesn't keep up: drop the oldest sample
+    head = (head + 1) % buffer.size();
+    count--;
+    droppedSamples++;
+  }
+  buffer[(head + count) % buffer.size()] = sample;
+  count++;
+}
+
+size_t MotionStream::Encode(uint8_t* packet, size_t packetSize, size_t& nbSamples) const {
+  nbSamples = 0;
+  if (packetSize > maxPacketSize) {
+    packetSize = maxPacketSize;
+  }
+  if (count == 0 || packetSize < headerSize + sampleSize) {
+    return 0;
+  }
+  nbSamples = std::min(count, (packetSize - headerSize) / sampleSize);
+  const uint32_t baseTimestamp = buffer[head].timestamp;
+
+  packet[0] = formatVersion;
+  packet[1] = static_cast<uint8_t>(nbSamples);
+  Write16(packet + 2, sequence);
+  Write16(packet + 4, droppedSamples);
+  Write32(packet + 6, baseTimestamp);
+
+  uint8_t* data = packet + headerSize;
+  for (size_t i = 0; i < nbSamples; i++, data += sampleSize) {
+    const auto& sample = buffer[(head + i) % buffer.size()];
+    Write16(data, static_cast<uint16_t>(sample.timestamp - baseTimestamp));
+    Write16(data + 2, static_cast<uint16_t>(sample.x));
+    Write16(data + 4, static_cast<uint16_t>(sample.y));
+    Write16(data + 6, static_cast<uint16_t>(sample.z));
+  }
+  return headerSize + nbSamples * sampleSize;
+}
+
+void MotionStream::Consume(size_t nbSamples) {
+  nbSamples = std::min(nbSamples, count);
+  head = (head + nbSamples) % buffer.size();
+  count -= nbSamples;
+  sequence++;
+}
+
+void MotionStream::Clear() {
+  count = 0;
+  decimationCounter = 0;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "drivers/Bma421.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Samples of the motion stream characteristic of MotionService, and their encoding into notifications.
+     * See doc/MotionService.md for the description of the binary format.
+     *
+     * The frames of the accelerometer FIFO are decimated to the rate of the stream and wait in a drop-oldest ring
+     * buffer until they are encoded. MotionService sends the packets: this class doesn't depend on NimBLE.
+     */
+    class MotionStream {
+    public:
+      struct Sample {
+        uint32_t timestamp;
+        int16_t x;
+        int16_t y;
+        int16_t z;
+      };
+
+      // Packet: header followed by up to (packet size - headerSize) / sampleSize samples
+      static constexpr uint8_t formatVersion = 1;
+      static constexpr size_t headerSize = 10;
+      static constexpr size_t sampleSize = 8;
+      static constexpr size_t maxPacketSize = 244;
+      static constexpr size_t bufferSize = 50;
+
+      /// Size of the packets that fit a notification with this ATT MTU, clamped to maxPacketSize. 0 if the MTU is
+      /// unknown (no connection) or too small for the 3 bytes of the ATT header.
+      static size_t PacketSize(uint16_t mtu);
+      /// Duration (in ms) of nbFrames frames of the accelerometer FIFO
+      static uint32_t FramesDuration(size_t nbFrames);
+
+      /// Queues the frames read from the accelerometer FIFO, decimated from the ODR of the accelerometer to rate (in Hz).
+      /// timestamp is the time (in ms) of frames[0], the next frames are one period of the ODR apart.
+      void PushFrames(const Drivers::Bma421::AccelValues* frames, size_t nbFrames, uint32_t timestamp, uint8_t rate);
+      void Push(const Sample& sample);
+      /// Queues the nbFrames frames waiting in the accelerometer FIFO, decimated to rate (in Hz). They are read in chunks
+      /// with read(frames, maxCount), which returns the number of frames read, and flush() is called after each chunk.
+      /// The last frame was sampled at now (in ms): each frame is dated from its rank in the FIFO.
+      template <typename Read, typename Flush>
+      void ReadFifo(size_t nbFrames, uint32_t now, uint8_t rate, Read read, Flush flush) {
+        while (nbFrames > 0) {
+          Drivers::Bma421::AccelValues frames[Drivers::Bma421::FifoMaxFrames];
+          const size_t nbRead = read(frames, nbFrames < Drivers::Bma421::FifoMaxFrames ? nbFrames : Drivers::Bma421::FifoMaxFrames);
+          if (nbRead == 0 || nbRead > nbFrames) {
+            return;
+          }
+          PushFrames(frames, nbRead, now - FramesDuration(nbFrames - 1), rate);
+          nbFrames -= nbRead;
+          flush();
+        }
+      }
+
+      /// Encodes the oldest samples into packet, as many as packetSize bytes allow. Returns the size of the packet (0 if
+      /// there is no sample or if packetSize is too small) and the number of samples in nbSamples.
+      size_t Encode(uint8_t* packet, size_t packetSize, size_t& nbSamples) const;
+      /// Removes the nbSamples oldest samples once their packet was sent
+      void Consume(size_t nbSamples);
+      void Clear();
+
+      size_t Size() const {
+        return count;
+      }
+      uint16_t DroppedSamples() const {
+        return droppedSamples;
+      }
+
+    private:
+      std::array<Sample, bufferSize> buffer;
+      size_t head = 0;
+      size_t count = 0;
+      uint16_t sequence = 0;
+      uint16_t droppedSamples = 0;
+      uint16_t decimationCounter = 0;
+    };
+  }
+}
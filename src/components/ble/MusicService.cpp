@@ -17,7 +17,9 @@
 */
 #include "components/ble/MusicService.h"
 #include "systemtask/SystemTask.h"
+#include <algorithm>
 #include <cstring>
+#include <task.h>
 
 namespace {
   // 0000yyxx-78fc-48fe-8e23-433b3a1942d0
@@ -46,147 +48,192 @@ namespace {
   constexpr ble_uuid128_t msRepeatCharUuid {CharUuid(0x0b, 0x00)};
   constexpr ble_uuid128_t msShuffleCharUuid {CharUuid(0x0c, 0x00)};
 
-  constexpr uint8_t MaxStringSize {40};
+  /// Copies the written string, truncated with an ellipsis if it doesn't fit in destination
+  template <size_t N>
+  void ReadString(const os_mbuf* om, Pinetime::Utility::StaticString<N>& destination) {
+    size_t notifSize = OS_MBUF_PKTLEN(om);
+    char* data = destination.Resize(notifSize);
+    size_t bufferSize = destination.Size();
+    os_mbuf_copydata(om, 0, bufferSize, data);
 
-  int MusicCallback(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
-    return static_cast<Pinetime::Controllers::MusicService*>(arg)->OnCommand(conn_handle, attr_handle, ctxt);
+    if (notifSize > bufferSize) {
+      data[bufferSize - 1] = '.';
+      data[bufferSize - 2] = '.';
+      data[bufferSize - 3] = '.';
+    }
+  }
+
+  /// Values are sent as big-endian 32 bits integers
+  int ReadInt(const os_mbuf* om) {
+    uint8_t s[4] {};
+    os_mbuf_copydata(om, 0, std::min<size_t>(OS_MBUF_PKTLEN(om), sizeof(s)), s);
+    return (s[0] << 24) | (s[1] << 16) | (s[2] << 8) | s[3];
+  }
+
+  bool ReadBool(const os_mbuf* om) {
+    uint8_t value = 0;
+    if (OS_MBUF_PKTLEN(om) > 0) {
+      os_mbuf_copydata(om, 0, 1, &value);
+    }
+    return value != 0;
   }
 }
 
-Pinetime::Controllers::MusicService::MusicService(Pinetime::System::SystemTask& system) : m_system(system) {
-  characteristicDefinition[0] = {.uuid = &msEventCharUuid.u,
-                                 .access_cb = MusicCallback,
-                                 .arg = this,
-                                 .flags = BLE_GATT_CHR_F_NOTIFY,
-                                 .val_handle = &eventHandle};
-  characteristicDefinition[1] = {.uuid = &msStatusCharUuid.u,
-                                 .access_cb = MusicCallback,
-                                 .arg = this,
-                                 .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ};
-  characteristicDefinition[2] = {.uuid = &msTrackCharUuid.u,
-                                 .access_cb = MusicCallback,
-                                 .arg = this,
-                                 .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ};
-  characteristicDefinition[3] = {.uuid = &msArtistCharUuid.u,
-                                 .access_cb = MusicCallback,
-                                 .arg = this,
-                                 .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ};
-  characteristicDefinition[4] = {.uuid = &msAlbumCharUuid.u,
-                                 .access_cb = MusicCallback,
-                                 .arg = this,
-                                 .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ};
-  characteristicDefinition[5] = {.uuid = &msPositionCharUuid.u,
-                                 .access_cb = MusicCallback,
-                                 .arg = this,
-                                 .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ};
-  characteristicDefinition[6] = {.uuid = &msTotalLengthCharUuid.u,
-                                 .access_cb = MusicCallback,
-                                 .arg = this,
-                                 .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ};
-  characteristicDefinition[7] = {.uuid = &msTotalLengthCharUuid.u,
-                                 .access_cb = MusicCallback,
-                                 .arg = this,
-                                 .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ};
-  characteristicDefinition[8] = {.uuid = &msTrackNumberCharUuid.u,
-                                 .access_cb = MusicCallback,
-                                 .arg = this,
-                                 .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ};
-  characteristicDefinition[9] = {.uuid = &msTrackTotalCharUuid.u,
-                                 .access_cb = MusicCallback,
-                                 .arg = this,
-                                 .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ};
-  characteristicDefinition[10] = {.uuid = &msPlaybackSpeedCharUuid.u,
-                                  .access_cb = MusicCallback,
-                                  .arg = this,
-                                  .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ};
-  characteristicDefinition[11] = {.uuid = &msRepeatCharUuid.u,
-                                  .access_cb = MusicCallback,
-                                  .arg = this,
-                                  .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ};
-  characteristicDefinition[12] = {.uuid = &msShuffleCharUuid.u,
-                                  .access_cb = MusicCallback,
-                                  .arg = this,
-                                  .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ};
-  characteristicDefinition[13] = {0};
-
-  serviceDefinition[0] = {.type = BLE_GATT_SVC_TYPE_PRIMARY, .uuid = &msUuid.u, .characteristics = characteristicDefinition};
-  serviceDefinition[1] = {0};
+using Pinetime::Controllers::GattCharacteristic;
+using Pinetime::Controllers::MusicService;
+
+const GattCharacteristic<MusicService> MusicService::characteristics[12] = {
+  {.uuid = &msEventCharUuid.u,
+   .flags = BLE_GATT_CHR_F_NOTIFY,
+   .onRead = nullptr,
+   .onWrite = nullptr,
+   .valueHandle = &MusicService::eventHandle},
+  {.uuid = &msStatusCharUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
+   .onRead = nullptr,
+   .onWrite = &MusicService::OnStatusWritten,
+   .valueHandle = nullptr},
+  {.uuid = &msTrackCharUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
+   .onRead = nullptr,
+   .onWrite = &MusicService::OnTrackWritten,
+   .valueHandle = nullptr},
+  {.uuid = &msArtistCharUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
+   .onRead = nullptr,
+   .onWrite = &MusicService::OnArtistWritten,
+   .valueHandle = nullptr},
+  {.uuid = &msAlbumCharUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
+   .onRead = nullptr,
+   .onWrite = &MusicService::OnAlbumWritten,
+   .valueHandle = nullptr},
+  {.uuid = &msPositionCharUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
+   .onRead = nullptr,
+   .onWrite = &MusicService::OnPositionWritten,
+   .valueHandle = nullptr},
+  {.uuid = &msTotalLengthCharUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
+   .onRead = nullptr,
+   .onWrite = &MusicService::OnTotalLengthWritten,
+   .valueHandle = nullptr},
+  {.uuid = &msTrackNumberCharUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
+   .onRead = nullptr,
+   .onWrite = &MusicService::OnTrackNumberWritten,
+   .valueHandle = nullptr},
+  {.uuid = &msTrackTotalCharUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
+   .onRead = nullptr,
+   .onWrite = &MusicService::OnTrackTotalWritten,
+   .valueHandle = nullptr},
+  {.uuid = &msPlaybackSpeedCharUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
+   .onRead = nullptr,
+   .onWrite = &MusicService::OnPlaybackSpeedWritten,
+   .valueHandle = nullptr},
+  {.uuid = &msRepeatCharUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
+   .onRead = nullptr,
+   .onWrite = &MusicService::OnRepeatWritten,
+   .valueHandle = nullptr},
+  {.uuid = &msShuffleCharUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
+   .onRead = nullptr,
+   .onWrite = &MusicService::OnShuffleWritten,
+   .valueHandle = nullptr},
+};
+
+Pinetime::Controllers::MusicService::MusicService(Pinetime::System::SystemTask& system)
+  : gattService {*this, &msUuid.u, characteristics}, m_system(system) {
 }
 
 void Pinetime::Controllers::MusicService::Init() {
-  uint8_t res = 0;
-  res = ble_gatts_count_cfg(serviceDefinition);
-  ASSERT(res == 0);
+  gattService.Init();
+}
 
-  res = ble_gatts_add_svcs(serviceDefinition);
-  ASSERT(res == 0);
+int Pinetime::Controllers::MusicService::OnStatusWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* ctxt) {
+  playing = ReadBool(ctxt->om);
+  // These variables need to be updated, because the progress may not be updated immediately,
+  // leading to getProgress() returning an incorrect position.
+  if (playing) {
+    trackProgressUpdateTime = xTaskGetTickCount();
+  } else {
+    trackProgress +=
+      static_cast<int>((static_cast<float>(xTaskGetTickCount() - trackProgressUpdateTime) / 1024.0f) * getPlaybackSpeed());
+  }
+  return 0;
 }
 
-int Pinetime::Controllers::MusicService::OnCommand(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt) {
-  if (ctxt->op == BLE_GATT_ACCESS_OP_WRITE_CHR) {
-    size_t notifSize = OS_MBUF_PKTLEN(ctxt->om);
-    size_t bufferSize = notifSize;
-    if (notifSize > MaxStringSize) {
-      bufferSize = MaxStringSize;
-    }
+int Pinetime::Controllers::MusicService::OnTrackWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* ctxt) {
+  ReadString(ctxt->om, trackName);
+  trackInfoVersion++;
+  return 0;
+}
 
-    char data[bufferSize + 1];
-    os_mbuf_copydata(ctxt->om, 0, bufferSize, data);
+int Pinetime::Controllers::MusicService::OnArtistWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* ctxt) {
+  ReadString(ctxt->om, artistName);
+  trackInfoVersion++;
+  return 0;
+}
 
-    if (notifSize > bufferSize) {
-      data[bufferSize - 1] = '.';
-      data[bufferSize - 2] = '.';
-      data[bufferSize - 3] = '.';
-    }
-    data[bufferSize] = '\0';
-
-    char* s = &data[0];
-    if (ble_uuid_cmp(ctxt->chr->uuid, &msArtistCharUuid.u) == 0) {
-      artistName = s;
-    } else if (ble_uuid_cmp(ctxt->chr->uuid, &msTrackCharUuid.u) == 0) {
-      trackName = s;
-    } else if (ble_uuid_cmp(ctxt->chr->uuid, &msAlbumCharUuid.u) == 0) {
-      albumName = s;
-    } else if (ble_uuid_cmp(ctxt->chr->uuid, &msStatusCharUuid.u) == 0) {
-      playing = s[0];
-      // These variables need to be updated, because the progress may not be updated immediately,
-      // leading to getProgress() returning an incorrect position.
-      if (playing) {
-        trackProgressUpdateTime = xTaskGetTickCount();
-      } else {
-        trackProgress +=
-          static_cast<int>((static_cast<float>(xTaskGetTickCount() - trackProgressUpdateTime) / 1024.0f) * getPlaybackSpeed());
-      }
-    } else if (ble_uuid_cmp(ctxt->chr->uuid, &msRepeatCharUuid.u) == 0) {
-      repeat = s[0];
-    } else if (ble_uuid_cmp(ctxt->chr->uuid, &msShuffleCharUuid.u) == 0) {
-      shuffle = s[0];
-    } else if (ble_uuid_cmp(ctxt->chr->uuid, &msPositionCharUuid.u) == 0) {
-      trackProgress = (s[0] << 24) | (s[1] << 16) | (s[2] << 8) | s[3];
-      trackProgressUpdateTime = xTaskGetTickCount();
-    } else if (ble_uuid_cmp(ctxt->chr->uuid, &msTotalLengthCharUuid.u) == 0) {
-      trackLength = (s[0] << 24) | (s[1] << 16) | (s[2] << 8) | s[3];
-    } else if (ble_uuid_cmp(ctxt->chr->uuid, &msTrackNumberCharUuid.u) == 0) {
-      trackNumber = (s[0] << 24) | (s[1] << 16) | (s[2] << 8) | s[3];
-    } else if (ble_uuid_cmp(ctxt->chr->uuid, &msTrackTotalCharUuid.u) == 0) {
-      tracksTotal = (s[0] << 24) | (s[1] << 16) | (s[2] << 8) | s[3];
-    } else if (ble_uuid_cmp(ctxt->chr->uuid, &msPlaybackSpeedCharUuid.u) == 0) {
-      playbackSpeed = static_cast<float>(((s[0] << 24) | (s[1] << 16) | (s[2] << 8) | s[3])) / 100.0f;
-    }
-  }
+int Pinetime::Controllers::MusicService::OnAlbumWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* ctxt) {
+  ReadString(ctxt->om, albumName);
+  trackInfoVersion++;
   return 0;
 }
 
-std::string Pinetime::Controllers::MusicService::getAlbum() const {
-  return albumName;
+int Pinetime::Controllers::MusicService::OnPositionWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* ctxt) {
+  trackProgress = ReadInt(ctxt->om);
+  trackProgressUpdateTime = xTaskGetTickCount();
+  return 0;
+}
+
+int Pinetime::Controllers::MusicService::OnTotalLengthWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* ctxt) {
+  trackLength = ReadInt(ctxt->om);
+  return 0;
+}
+
+int Pinetime::Controllers::MusicService::OnTrackNumberWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* ctxt) {
+  trackNumber = ReadInt(ctxt->om);
+  return 0;
+}
+
+int Pinetime::Controllers::MusicService::OnTrackTotalWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* ctxt) {
+  tracksTotal = ReadInt(ctxt->om);
+  return 0;
+}
+
+int Pinetime::Controllers::MusicService::OnPlaybackSpeedWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* ctxt) {
+  playbackSpeed = static_cast<float>(ReadInt(ctxt->om)) / 100.0f;
+  return 0;
+}
+
+int Pinetime::Controllers::MusicService::OnRepeatWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* ctxt) {
+  repeat = ReadBool(ctxt->om);
+  return 0;
+}
+
+int Pinetime::Controllers::MusicService::OnShuffleWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* ctxt) {
+  shuffle = ReadBool(ctxt->om);
+  return 0;
+}
+
+const char* Pinetime::Controllers::MusicService::getAlbum() const {
+  return albumName.Data();
+}
+
+const char* Pinetime::Controllers::MusicService::getArtist() const {
+  return artistName.Data();
 }
 
-std::string Pinetime::Controllers::MusicService::getArtist() const {
-  return artistName;
+const char* Pinetime::Controllers::MusicService::getTrack() const {
+  return trackName.Data();
 }
 
-std::string Pinetime::Controllers::MusicService::getTrack() const {
-  return trackName;
+uint32_t Pinetime::Controllers::MusicService::getTrackInfoVersion() const {
+  return trackInfoVersion;
 }
 
 bool Pinetime::Controllers::MusicService::isPlaying() const {
@@ -17,14 +17,18 @@
 */
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
-#include <string>
+#include <FreeRTOS.h>
 #define min // workaround: nimble's min/max macros conflict with libstdc++
 #define max
 #include <host/ble_gap.h>
 #include <host/ble_uuid.h>
 #undef max
 #undef min
+#include "components/ble/GattServiceTable.h"
+#include "utility/StaticString.h"
 
 namespace Pinetime {
   namespace System {
@@ -37,15 +41,20 @@ namespace Pinetime {
 
       void Init();
 
-      int OnCommand(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt);
-
       void event(char event);
 
-      std::string getArtist() const;
+      // Longer strings are truncated with an ellipsis
+      static constexpr size_t MaxStringSize = 40;
+
+      // The strings are updated in place by the BLE task: read them only after a change of getTrackInfoVersion()
+      const char* getArtist() const;
+
+      const char* getTrack() const;
 
-      std::string getTrack() const;
+      const char* getAlbum() const;
 
-      std::string getAlbum() const;
+      /// Incremented each time the artist, track or album changes. 0 is never a valid version.
+      uint32_t getTrackInfoVersion() const;
 
       int getProgress() const;
 
@@ -66,14 +75,27 @@ namespace Pinetime {
       enum MusicStatus { NotPlaying = 0x00, Playing = 0x01 };
 
     private:
-      struct ble_gatt_chr_def characteristicDefinition[14];
-      struct ble_gatt_svc_def serviceDefinition[2];
+      int OnStatusWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnTrackWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnArtistWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnAlbumWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnPositionWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnTotalLengthWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnTrackNumberWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnTrackTotalWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnPlaybackSpeedWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnRepeatWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnShuffleWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+
+      static const GattCharacteristic<MusicService> characteristics[12];
+      GattServiceTable<MusicService, 12> gattService;
 
       uint16_t eventHandle {};
 
-      std::string artistName {"Waiting for"};
-      std::string albumName {};
-      std::string trackName {"track information.."};
+      Utility::StaticString<MaxStringSize> artistName {"Waiting for"};
+      Utility::StaticString<MaxStringSize> albumName {};
+      Utility::StaticString<MaxStringSize> trackName {"track information.."};
+      std::atomic<uint32_t> trackInfoVersion {1};
 
       bool playing {false};
 
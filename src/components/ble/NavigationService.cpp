@@ -39,81 +39,91 @@ namespace {
   constexpr ble_uuid128_t navManDistCharUuid {CharUuid(0x03, 0x00)};
   constexpr ble_uuid128_t navProgressCharUuid {CharUuid(0x04, 0x00)};
 
-  int NAVCallback(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
-    auto navService = static_cast<Pinetime::Controllers::NavigationService*>(arg);
-    return navService->OnCommand(conn_handle, attr_handle, ctxt);
+  template <size_t N>
+  void ReadString(const os_mbuf* om, Pinetime::Utility::StaticString<N>& destination) {
+    char* data = destination.Resize(OS_MBUF_PKTLEN(om));
+    os_mbuf_copydata(om, 0, destination.Size(), data);
   }
 } // namespace
 
-Pinetime::Controllers::NavigationService::NavigationService(Pinetime::System::SystemTask& system) : m_system(system) {
-  characteristicDefinition[0] = {.uuid = &navFlagCharUuid.u,
-                                 .access_cb = NAVCallback,
-                                 .arg = this,
-                                 .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ};
-
-  characteristicDefinition[1] = {.uuid = &navNarrativeCharUuid.u,
-                                 .access_cb = NAVCallback,
-                                 .arg = this,
-                                 .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ};
-  characteristicDefinition[2] = {.uuid = &navManDistCharUuid.u,
-                                 .access_cb = NAVCallback,
-                                 .arg = this,
-                                 .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ};
-  characteristicDefinition[3] = {.uuid = &navProgressCharUuid.u,
-                                 .access_cb = NAVCallback,
-                                 .arg = this,
-                                 .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ};
-
-  characteristicDefinition[4] = {0};
-
-  serviceDefinition[0] = {.type = BLE_GATT_SVC_TYPE_PRIMARY, .uuid = &navUuid.u, .characteristics = characteristicDefinition};
-  serviceDefinition[1] = {0};
-
+using Pinetime::Controllers::GattCharacteristic;
+using Pinetime::Controllers::NavigationService;
+
+const GattCharacteristic<NavigationService> NavigationService::characteristics[4] = {
+  {.uuid = &navFlagCharUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
+   .onRead = nullptr,
+   .onWrite = &NavigationService::OnFlagWritten,
+   .valueHandle = nullptr},
+  {.uuid = &navNarrativeCharUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
+   .onRead = nullptr,
+   .onWrite = &NavigationService::OnNarrativeWritten,
+   .valueHandle = nullptr},
+  {.uuid = &navManDistCharUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
+   .onRead = nullptr,
+   .onWrite = &NavigationService::OnManDistWritten,
+   .valueHandle = nullptr},
+  {.uuid = &navProgressCharUuid.u,
+   .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
+   .onRead = nullptr,
+   .onWrite = &NavigationService::OnProgressWritten,
+   .valueHandle = nullptr},
+};
+
+Pinetime::Controllers::NavigationService::NavigationService(Pinetime::System::SystemTask& system)
+  : gattService {*this, &navUuid.u, characteristics}, m_system(system) {
   m_progress = 0;
 }
 
 void Pinetime::Controllers::NavigationService::Init() {
-  int res = 0;
-  res = ble_gatts_count_cfg(serviceDefinition);
-  ASSERT(res == 0);
+  gattService.Init();
+}
+
+int Pinetime::Controllers::NavigationService::OnFlagWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* ctxt) {
+  ReadString(ctxt->om, m_flag);
+  m_version++;
+  return 0;
+}
 
-  res = ble_gatts_add_svcs(serviceDefinition);
-  ASSERT(res == 0);
+int Pinetime::Controllers::NavigationService::OnNarrativeWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* ctxt) {
+  ReadString(ctxt->om, m_narrative);
+  m_version++;
+  return 0;
 }
 
-int Pinetime::Controllers::NavigationService::OnCommand(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt) {
-
-  if (ctxt->op == BLE_GATT_ACCESS_OP_WRITE_CHR) {
-    size_t notifSize = OS_MBUF_PKTLEN(ctxt->om);
-    uint8_t data[notifSize + 1];
-    data[notifSize] = '\0';
-    os_mbuf_copydata(ctxt->om, 0, notifSize, data);
-    char* s = (char*) &data[0];
-    if (ble_uuid_cmp(ctxt->chr->uuid, &navFlagCharUuid.u) == 0) {
-      m_flag = s;
-    } else if (ble_uuid_cmp(ctxt->chr->uuid, &navNarrativeCharUuid.u) == 0) {
-      m_narrative = s;
-    } else if (ble_uuid_cmp(ctxt->chr->uuid, &navManDistCharUuid.u) == 0) {
-      m_manDist = s;
-    } else if (ble_uuid_cmp(ctxt->chr->uuid, &navProgressCharUuid.u) == 0) {
-      m_progress = data[0];
-    }
+int Pinetime::Controllers::NavigationService::OnManDistWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* ctxt) {
+  ReadString(ctxt->om, m_manDist);
+  m_version++;
+  return 0;
+}
+
+int Pinetime::Controllers::NavigationService::OnProgressWritten(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* ctxt) {
+  uint8_t progress = 0;
+  if (OS_MBUF_PKTLEN(ctxt->om) > 0) {
+    os_mbuf_copydata(ctxt->om, 0, 1, &progress);
   }
+  m_progress = progress;
   return 0;
 }
 
-std::string Pinetime::Controllers::NavigationService::getFlag() {
-  return m_flag;
+const char* Pinetime::Controllers::NavigationService::getFlag() const {
+  return m_flag.Data();
+}
+
+const char* Pinetime::Controllers::NavigationService::getNarrative() const {
+  return m_narrative.Data();
 }
 
-std::string Pinetime::Controllers::NavigationService::getNarrative() {
-  return m_narrative;
+const char* Pinetime::Controllers::NavigationService::getManDist() const {
+  return m_manDist.Data();
 }
 
-std::string Pinetime::Controllers::NavigationService::getManDist() {
-  return m_manDist;
+uint32_t Pinetime::Controllers::NavigationService::getVersion() const {
+  return m_version;
 }
 
-int Pinetime::Controllers::NavigationService::getProgress() {
+int Pinetime::Controllers::NavigationService::getProgress() const {
   return m_progress;
 }
@@ -17,14 +17,16 @@
 */
 #pragma once
 
+#include <atomic>
 #include <cstdint>
-#include <string>
 #define min // workaround: nimble's min/max macros conflict with libstdc++
 #define max
 #include <host/ble_gap.h>
 #include <host/ble_uuid.h>
 #undef max
 #undef min
+#include "components/ble/GattServiceTable.h"
+#include "utility/StaticString.h"
 
 namespace Pinetime {
   namespace System {
@@ -38,23 +40,32 @@ namespace Pinetime {
 
       void Init();
 
-      int OnCommand(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt);
+      // The strings are updated in place by the BLE task: read them only after a change of getVersion()
+      const char* getFlag() const;
 
-      std::string getFlag();
+      const char* getNarrative() const;
 
-      std::string getNarrative();
+      const char* getManDist() const;
 
-      std::string getManDist();
+      /// Incremented each time the flag, narrative or distance changes, 0 until any of them is received
+      uint32_t getVersion() const;
 
-      int getProgress();
+      int getProgress() const;
 
     private:
-      struct ble_gatt_chr_def characteristicDefinition[5];
-      struct ble_gatt_svc_def serviceDefinition[2];
-
-      std::string m_flag;
-      std::string m_narrative;
-      std::string m_manDist;
+      int OnFlagWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnNarrativeWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnManDistWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+      int OnProgressWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
+
+      static const GattCharacteristic<NavigationService> characteristics[4];
+      GattServiceTable<NavigationService, 4> gattService;
+
+      // Longer strings are truncated
+      Utility::StaticString<32> m_flag;
+      Utility::StaticString<80> m_narrative;
+      Utility::StaticString<16> m_manDist;
+      std::atomic<uint32_t> m_version {0};
       int m_progress;
 
       Pinetime::System::SystemTask& m_system;
@@ -0,0 +1,31 @@
+#include "components/ble/NewAlert.h"
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <os/os_mbuf.h>
+#undef max
+#undef min
+
+using namespace Pinetime::Controllers;
+
+uint8_t NewAlert::Category(const os_mbuf* om) {
+  uint8_t category = 0;
+  os_mbuf_copydata(om, 0, 1, &category);
+  return category;
+}
+
+bool NewAlert::Push(NotificationManager& notificationManager, const os_mbuf* om, NotificationManager::Categories category) {
+  constexpr size_t stringTerminatorSize = 1; // end of string '\0'
+
+  // Ignore notifications with empty message
+  const size_t packetLen = OS_MBUF_PKTLEN(om);
+  if (packetLen <= headerSize) {
+    return false;
+  }
+
+  // Copy the message from the mbuf chain straight into the notification store (truncated if needed)
+  size_t messageSize = packetLen - headerSize + stringTerminatorSize;
+  char* message = notificationManager.BeginPush(messageSize);
+  os_mbuf_copydata(om, headerSize, messageSize - stringTerminatorSize, message);
+  notificationManager.CommitPush(category);
+  return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "components/ble/NotificationManager.h"
+
+struct os_mbuf;
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Value of the New Alert characteristic of the Alert Notification Service, written by the phone to
+     * AlertNotificationService or notified to AlertNotificationClient: the ANS category, the number of new alerts,
+     * '\0', then the message (title '\0' body).
+     *
+     * A message longer than the MTU is sent with ATT Prepare/Execute Write requests. NimBLE reassembles the fragments in
+     * a chain of mbufs (bounded by BLE_ATT_SVR_MAX_PREP_ENTRIES, discarded after BLE_ATT_SVR_QUEUED_WRITE_TMO).
+     */
+    class NewAlert {
+    public:
+      static constexpr size_t headerSize = 3;
+
+      /// ANS category of the alert
+      static uint8_t Category(const os_mbuf* om);
+      /// Copies the message from the mbuf chain straight into the notification store, truncated if needed. Returns
+      /// false, and pushes nothing, if the message is empty.
+      static bool Push(NotificationManager& notificationManager, const os_mbuf* om, NotificationManager::Categories category);
+    };
+  }
+}
@@ -20,6 +20,7 @@
 #include "components/datetime/DateTimeController.h"
 #include "components/fs/FS.h"
 #include "systemtask/SystemTask.h"
+#include "logging/TokenizedLog.h"
 
 using namespace Pinetime::Controllers;
 
@@ -50,18 +51,19 @@ NimbleController::NimbleController(Pinetime::System::SystemTask& systemTask,
     immediateAlertService {systemTask, notificationManager},
     heartRateService {systemTask, heartRateController},
     motionService {systemTask, motionController},
+    diagnosticsService {systemTask},
     fsService {systemTask, fs},
     serviceDiscovery({&currentTimeClient, &alertNotificationClient}) {
 }
 
 void nimble_on_reset(int reason) {
-  NRF_LOG_INFO("Nimble lost sync, resetting state; reason=%d", reason);
+  TLOG_INFO("Nimble lost sync, resetting state; reason=%d", reason);
 }
 
 void nimble_on_sync(void) {
   int rc;
 
-  NRF_LOG_INFO("Nimble is synced");
+  TLOG_INFO("Nimble is synced");
 
   rc = ble_hs_util_ensure_addr(0);
   ASSERT(rc == 0);
@@ -99,6 +101,7 @@ void NimbleController::Init() {
   immediateAlertService.Init();
   heartRateService.Init();
   motionService.Init();
+  diagnosticsService.Init();
   fsService.Init();
 
   int rc;
@@ -183,8 +186,8 @@ void NimbleController::StartAdvertising() {
 int NimbleController::OnGAPEvent(ble_gap_event* event) {
   switch (event->type) {
     case BLE_GAP_EVENT_ADV_COMPLETE:
-      NRF_LOG_INFO("Advertising event : BLE_GAP_EVENT_ADV_COMPLETE");
-      NRF_LOG_INFO("reason=%d; status=%0X", event->adv_complete.reason, event->connect.status);
+      TLOG_INFO("Advertising event : BLE_GAP_EVENT_ADV_COMPLETE");
+      TLOG_INFO("reason=%d; status=%0X", event->adv_complete.reason, event->connect.status);
       if (bleController.IsRadioEnabled() && !bleController.IsConnected()) {
         StartAdvertising();
       }
@@ -192,7 +195,7 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
 
     case BLE_GAP_EVENT_CONNECT:
       /* A new connection was established or a connection attempt failed. */
-      NRF_LOG_INFO("Connect event : BLE_GAP_EVENT_CONNECT");
+      TLOG_INFO("Connect event : BLE_GAP_EVENT_CONNECT");
       NRF_LOG_INFO("connection %s; status=%0X ", event->connect.status == 0 ? "established" : "failed", event->connect.status);
 
       if (event->connect.status != 0) {
@@ -213,8 +216,8 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
 
     case BLE_GAP_EVENT_DISCONNECT:
       /* Connection terminated; resume advertising. */
-      NRF_LOG_INFO("Disconnect event : BLE_GAP_EVENT_DISCONNECT");
-      NRF_LOG_INFO("disconnect reason=%d", event->disconnect.reason);
+      TLOG_INFO("Disconnect event : BLE_GAP_EVENT_DISCONNECT");
+      TLOG_INFO("disconnect reason=%d", event->disconnect.reason);
 
       if (event->disconnect.conn.sec_state.bonded) {
         PersistBond(event->disconnect.conn);
@@ -232,24 +235,24 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
 
     case BLE_GAP_EVENT_CONN_UPDATE:
       /* The central has updated the connection parameters. */
-      NRF_LOG_INFO("Update event : BLE_GAP_EVENT_CONN_UPDATE");
-      NRF_LOG_INFO("update status=%0X ", event->conn_update.status);
+      TLOG_INFO("Update event : BLE_GAP_EVENT_CONN_UPDATE");
+      TLOG_INFO("update status=%0X ", event->conn_update.status);
       break;
 
     case BLE_GAP_EVENT_CONN_UPDATE_REQ:
       /* The central has requested updated connection parameters */
-      NRF_LOG_INFO("Update event : BLE_GAP_EVENT_CONN_UPDATE_REQ");
-      NRF_LOG_INFO("update request : itvl_min=%d itvl_max=%d latency=%d supervision=%d",
-                   event->conn_update_req.peer_params->itvl_min,
-                   event->conn_update_req.peer_params->itvl_max,
-                   event->conn_update_req.peer_params->latency,
-                   event->conn_update_req.peer_params->supervision_timeout);
+      TLOG_INFO("Update event : BLE_GAP_EVENT_CONN_UPDATE_REQ");
+      TLOG_INFO("update request : itvl_min=%d itvl_max=%d latency=%d supervision=%d",
+                event->conn_update_req.peer_params->itvl_min,
+                event->conn_update_req.peer_params->itvl_max,
+                event->conn_update_req.peer_params->latency,
+                event->conn_update_req.peer_params->supervision_timeout);
       break;
 
     case BLE_GAP_EVENT_ENC_CHANGE:
       /* Encryption has been enabled or disabled for this connection. */
-      NRF_LOG_INFO("Security event : BLE_GAP_EVENT_ENC_CHANGE");
-      NRF_LOG_INFO("encryption change event; status=%0X ", event->enc_change.status);
+      TLOG_INFO("Security event : BLE_GAP_EVENT_ENC_CHANGE");
+      TLOG_INFO("encryption change event; status=%0X ", event->enc_change.status);
 
       if (event->enc_change.status == 0) {
         struct ble_gap_conn_desc desc;
@@ -258,11 +261,11 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
           PersistBond(desc);
         }
 
-        NRF_LOG_INFO("new state: encrypted=%d authenticated=%d bonded=%d key_size=%d",
-                     desc.sec_state.encrypted,
-                     desc.sec_state.authenticated,
-                     desc.sec_state.bonded,
-                     desc.sec_state.key_size);
+        TLOG_INFO("new state: encrypted=%d authenticated=%d bonded=%d key_size=%d",
+                  desc.sec_state.encrypted,
+                  desc.sec_state.authenticated,
+                  desc.sec_state.bonded,
+                  desc.sec_state.key_size);
       }
       break;
 
@@ -279,7 +282,7 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
        * Standards insist that the rand() PRNG be deterministic.
        * Use the tinycrypt prng here since rand() is predictable.
        */
-      NRF_LOG_INFO("Security event : BLE_GAP_EVENT_PASSKEY_ACTION");
+      TLOG_INFO("Security event : BLE_GAP_EVENT_PASSKEY_ACTION");
       if (event->passkey.params.action == BLE_SM_IOACT_DISP) {
         struct ble_sm_io pkey = {0};
         pkey.action = event->passkey.params.action;
@@ -312,14 +315,14 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
       break;
 
     case BLE_GAP_EVENT_SUBSCRIBE:
-      NRF_LOG_INFO("Subscribe event; conn_handle=%d attr_handle=%d "
-                   "reason=%d prevn=%d curn=%d previ=%d curi=???\n",
-                   event->subscribe.conn_handle,
-                   event->subscribe.attr_handle,
-                   event->subscribe.reason,
-                   event->subscribe.prev_notify,
-                   event->subscribe.cur_notify,
-                   event->subscribe.prev_indicate);
+      TLOG_INFO("Subscribe event; conn_handle=%d attr_handle=%d "
+                "reason=%d prevn=%d curn=%d previ=%d curi=???\n",
+                event->subscribe.conn_handle,
+                event->subscribe.attr_handle,
+                event->subscribe.reason,
+                event->subscribe.prev_notify,
+                event->subscribe.cur_notify,
+                event->subscribe.prev_indicate);
 
       if (event->subscribe.reason == BLE_GAP_SUBSCRIBE_REASON_TERM) {
         heartRateService.UnsubscribeNotification(event->subscribe.conn_handle, event->subscribe.attr_handle);
@@ -334,11 +337,11 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
       break;
 
     case BLE_GAP_EVENT_MTU:
-      NRF_LOG_INFO("MTU Update event; conn_handle=%d cid=%d mtu=%d", event->mtu.conn_handle, event->mtu.channel_id, event->mtu.value);
+      TLOG_INFO("MTU Update event; conn_handle=%d cid=%d mtu=%d", event->mtu.conn_handle, event->mtu.channel_id, event->mtu.value);
       break;
 
     case BLE_GAP_EVENT_REPEAT_PAIRING: {
-      NRF_LOG_INFO("Pairing event : BLE_GAP_EVENT_REPEAT_PAIRING");
+      TLOG_INFO("Pairing event : BLE_GAP_EVENT_REPEAT_PAIRING");
       /* We already have a bond with the peer, but it is attempting to
        * establish a new secure link.  This app sacrifices security for
        * convenience: just throw away the old bond and accept the new link.
@@ -358,7 +361,7 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
     case BLE_GAP_EVENT_NOTIFY_RX: {
       /* Peer sent us a notification or indication. */
       /* Attribute data is contained in event->notify_rx.attr_data. */
-      NRF_LOG_INFO("Notify event : BLE_GAP_EVENT_NOTIFY_RX");
+      TLOG_INFO("Notify event : BLE_GAP_EVENT_NOTIFY_RX");
       size_t notifSize = OS_MBUF_PKTLEN(event->notify_rx.om);
 
       NRF_LOG_INFO("received %s; conn_handle=%d attr_handle=%d "
@@ -368,19 +371,23 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
                    event->notify_rx.attr_handle,
                    notifSize);
 
+      if (event->notify_rx.indication) {
+        serviceDiscovery.OnIndication(event->notify_rx.attr_handle);
+      }
+
       alertNotificationClient.OnNotification(event);
     } break;
 
     case BLE_GAP_EVENT_NOTIFY_TX:
-      NRF_LOG_INFO("Notify event : BLE_GAP_EVENT_NOTIFY_TX");
+      TLOG_INFO("Notify event : BLE_GAP_EVENT_NOTIFY_TX");
       break;
 
     case BLE_GAP_EVENT_IDENTITY_RESOLVED:
-      NRF_LOG_INFO("Identity event : BLE_GAP_EVENT_IDENTITY_RESOLVED");
+      TLOG_INFO("Identity event : BLE_GAP_EVENT_IDENTITY_RESOLVED");
       break;
 
     default:
-      NRF_LOG_INFO("UNHANDLED GAP event : %d", event->type);
+      TLOG_INFO("UNHANDLED GAP event : %d", event->type);
       break;
   }
   return 0;
@@ -402,6 +409,14 @@ void NimbleController::NotifyBatteryLevel(uint8_t level) {
   }
 }
 
+uint16_t NimbleController::NbBuffers() const {
+  return static_cast<uint16_t>(os_msys_count());
+}
+
+uint16_t NimbleController::NbFreeBuffers() const {
+  return static_cast<uint16_t>(os_msys_num_free());
+}
+
 void NimbleController::EnableRadio() {
   bleController.EnableRadio();
   bleController.Disconnect();
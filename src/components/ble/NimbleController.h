@@ -14,6 +14,7 @@
 #include "components/ble/CurrentTimeService.h"
 #include "components/ble/DeviceInformationService.h"
 #include "components/ble/DfuService.h"
+#include "components/ble/DiagnosticsService.h"
 #include "components/ble/FSService.h"
 #include "components/ble/HeartRateService.h"
 #include "components/ble/ImmediateAlertService.h"
@@ -71,6 +72,10 @@ namespace Pinetime {
       uint16_t connHandle();
       void NotifyBatteryLevel(uint8_t level);
 
+      /// Blocks of the MSYS pool (buffers of the host and of the controller)
+      uint16_t NbBuffers() const;
+      uint16_t NbFreeBuffers() const;
+
       void RestartFastAdv() {
         fastAdvCount = 0;
       };
@@ -102,6 +107,7 @@ namespace Pinetime {
       ImmediateAlertService immediateAlertService;
       HeartRateService heartRateService;
       MotionService motionService;
+      DiagnosticsService diagnosticsService;
       FSService fsService;
       ServiceDiscovery serviceDiscovery;
 
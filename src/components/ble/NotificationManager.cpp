@@ -1,123 +1,180 @@
 #include "components/ble/NotificationManager.h"
+#include <FreeRTOS.h>
+#include <task.h>
 #include <cstring>
 #include <algorithm>
 #include <cassert>
 
 using namespace Pinetime::Controllers;
 
-constexpr uint8_t NotificationManager::MessageSize;
+constexpr uint16_t NotificationManager::MessageSize;
 
-void NotificationManager::Push(NotificationManager::Notification&& notif) {
-  notif.id = GetNextId();
-  notif.valid = true;
-  newNotification = true;
-  if (beginIdx > 0) {
-    --beginIdx;
-  } else {
-    beginIdx = notifications.size() - 1;
-  }
-  notifications[beginIdx] = std::move(notif);
-  if (size < notifications.size()) {
-    size++;
-  }
+// The 5 slots of 101 characters that the arena replaced took 540 bytes
+static_assert(sizeof(NotificationManager) <= 540, "The notification store must not take more RAM than the fixed slots");
+
+namespace {
+  // The critical sections only copy or move a few hundred bytes
+  class Lock {
+  public:
+    Lock() {
+      taskENTER_CRITICAL();
+    }
+
+    ~Lock() {
+      taskEXIT_CRITICAL();
+    }
+
+    Lock(const Lock&) = delete;
+    Lock& operator=(const Lock&) = delete;
+  };
 }
 
-NotificationManager::Notification::Id NotificationManager::GetNextId() {
-  return nextId++;
+void NotificationManager::Push(Categories category, const char* message, size_t messageSize) {
+  char* buffer = BeginPush(messageSize);
+  std::memcpy(buffer, message, messageSize);
+  CommitPush(category);
 }
 
-NotificationManager::Notification NotificationManager::GetLastNotification() const {
-  if (this->IsEmpty()) {
-    return {};
+char* NotificationManager::BeginPush(size_t& messageSize) {
+  messageSize = std::max<size_t>(1, std::min<size_t>(messageSize, MessageSize + 1));
+
+  Lock lock;
+  // Evict the oldest notifications until the new one fits
+  while (size > 0 && (size == entries.size() || MessagesSize() + messageSize > arena.size())) {
+    RemoveEntry(0);
   }
-  return this->At(0);
+  Compact();
+
+  pendingSize = messageSize;
+  return arena.data() + arenaUsed;
 }
 
-const NotificationManager::Notification& NotificationManager::At(NotificationManager::Notification::Idx idx) const {
-  if (idx >= notifications.size()) {
-    assert(false);
-    return notifications.at(beginIdx); // this should not happen
+void NotificationManager::CommitPush(Categories category) {
+  Lock lock;
+  if (pendingSize == 0) {
+    return;
   }
-  size_t read_idx = (beginIdx + idx) % notifications.size();
-  return notifications.at(read_idx);
+  arena[arenaUsed + pendingSize - 1] = '\0';
+
+  Entry& entry = entries[size];
+  entry.id = GetNextId();
+  entry.category = category;
+  entry.offset = arenaUsed;
+  entry.size = pendingSize;
+  arenaUsed += pendingSize;
+  pendingSize = 0;
+  size++;
+
+  newNotification = true;
+}
+
+NotificationManager::Notification::Id NotificationManager::GetNextId() {
+  return nextId++;
 }
 
-NotificationManager::Notification& NotificationManager::At(NotificationManager::Notification::Idx idx) {
-  if (idx >= notifications.size()) {
+const NotificationManager::Entry& NotificationManager::At(NotificationManager::Notification::Idx idx) const {
+  if (idx >= size) {
     assert(false);
-    return notifications.at(beginIdx); // this should not happen
+    return entries.at(size - 1); // this should not happen
   }
-  size_t read_idx = (beginIdx + idx) % notifications.size();
-  return notifications.at(read_idx);
+  return entries.at(size - 1 - idx);
 }
 
-NotificationManager::Notification::Idx NotificationManager::IndexOf(NotificationManager::Notification::Id id) const {
+NotificationManager::Notification::Idx NotificationManager::Find(NotificationManager::Notification::Id id) const {
   for (NotificationManager::Notification::Idx idx = 0; idx < this->size; idx++) {
-    const NotificationManager::Notification& notification = this->At(idx);
-    if (notification.id == id) {
+    if (this->At(idx).id == id) {
       return idx;
     }
   }
   return size;
 }
 
-NotificationManager::Notification NotificationManager::Get(NotificationManager::Notification::Id id) const {
-  NotificationManager::Notification::Idx idx = this->IndexOf(id);
-  if (idx == this->size) {
-    return {};
+bool NotificationManager::CopyAt(size_t idx, NotificationManager::Notification& notification) const {
+  if (idx >= size) {
+    notification.valid = false;
+    return false;
   }
-  return this->At(idx);
+  const Entry& entry = At(idx);
+  notification.id = entry.id;
+  notification.valid = true;
+  notification.category = entry.category;
+  notification.size = entry.size;
+  std::memcpy(notification.message.data(), arena.data() + entry.offset, entry.size);
+  return true;
 }
 
-NotificationManager::Notification NotificationManager::GetNext(NotificationManager::Notification::Id id) const {
-  NotificationManager::Notification::Idx idx = this->IndexOf(id);
-  if (idx == this->size) {
-    return {};
-  }
-  if (idx == 0 || idx > notifications.size()) {
-    return {};
+void NotificationManager::RemoveEntry(size_t entryIdx) {
+  // The message stays where it is until Compact()
+  for (size_t i = entryIdx; i < size - 1u; ++i) {
+    entries[i] = entries[i + 1];
   }
-  return this->At(idx - 1);
+  --size;
 }
 
-NotificationManager::Notification NotificationManager::GetPrevious(NotificationManager::Notification::Id id) const {
-  NotificationManager::Notification::Idx idx = this->IndexOf(id);
-  if (idx == this->size) {
-    return {};
-  }
-  if (static_cast<size_t>(idx + 1) >= notifications.size()) {
-    return {};
+uint16_t NotificationManager::MessagesSize() const {
+  uint16_t messagesSize = 0;
+  for (size_t i = 0; i < size; i++) {
+    messagesSize += entries[i].size;
   }
-  return this->At(idx + 1);
+  return messagesSize;
 }
 
-void NotificationManager::DismissIdx(NotificationManager::Notification::Idx idx) {
-  if (this->IsEmpty()) {
-    return;
+void NotificationManager::Compact() {
+  // Move the messages over the holes left by the removed notifications
+  uint16_t offset = 0;
+  for (size_t i = 0; i < size; i++) {
+    Entry& entry = entries[i];
+    if (entry.offset != offset) {
+      std::memmove(arena.data() + offset, arena.data() + entry.offset, entry.size);
+      entry.offset = offset;
+    }
+    offset += entry.size;
   }
-  if (idx >= size) {
-    assert(false);
-    return; // this should not happen
+  arenaUsed = offset;
+}
+
+NotificationManager::Notification::Idx NotificationManager::IndexOf(NotificationManager::Notification::Id id) const {
+  Lock lock;
+  return Find(id);
+}
+
+bool NotificationManager::GetLastNotification(NotificationManager::Notification& notification) const {
+  Lock lock;
+  return CopyAt(0, notification);
+}
+
+bool NotificationManager::Get(NotificationManager::Notification::Id id, NotificationManager::Notification& notification) const {
+  Lock lock;
+  return CopyAt(Find(id), notification);
+}
+
+bool NotificationManager::GetNext(NotificationManager::Notification::Id id, NotificationManager::Notification& notification) const {
+  Lock lock;
+  NotificationManager::Notification::Idx idx = Find(id);
+  if (idx == this->size || idx == 0) {
+    notification.valid = false;
+    return false;
   }
-  if (idx == 0) { // just remove the first element, don't need to change the other elements
-    notifications.at(beginIdx).valid = false;
-    beginIdx = (beginIdx + 1) % notifications.size();
-  } else {
-    // overwrite the specified entry by moving all later messages one index to the front
-    for (size_t i = idx; i < size - 1; ++i) {
-      this->At(i) = this->At(i + 1);
-    }
-    this->At(size - 1).valid = false;
+  return CopyAt(idx - 1, notification);
+}
+
+bool NotificationManager::GetPrevious(NotificationManager::Notification::Id id, NotificationManager::Notification& notification) const {
+  Lock lock;
+  NotificationManager::Notification::Idx idx = Find(id);
+  if (idx == this->size) {
+    notification.valid = false;
+    return false;
   }
-  --size;
+  return CopyAt(idx + 1, notification);
 }
 
 void NotificationManager::Dismiss(NotificationManager::Notification::Id id) {
-  NotificationManager::Notification::Idx idx = this->IndexOf(id);
+  Lock lock;
+  NotificationManager::Notification::Idx idx = Find(id);
   if (idx == this->size) {
     return;
   }
-  this->DismissIdx(idx);
+  RemoveEntry(size - 1 - idx);
 }
 
 bool NotificationManager::AreNewNotificationsAvailable() const {
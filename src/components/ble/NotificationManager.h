@@ -9,7 +9,7 @@ namespace Pinetime {
   namespace Controllers {
     class NotificationManager {
     public:
-      enum class Categories {
+      enum class Categories : uint8_t {
         Unknown,
         SimpleAlert,
         Email,
@@ -22,14 +22,14 @@ namespace Pinetime {
         HighProriotyAlert,
         InstantMessage
       };
-      static constexpr uint8_t MessageSize {100};
+      static constexpr uint16_t MessageSize {240};
 
       struct Notification {
         using Id = uint8_t;
         using Idx = uint8_t;
         Id id = 0;
         bool valid = false;
-        uint8_t size;
+        uint16_t size = 0;
         std::array<char, MessageSize + 1> message;
         Categories category = Categories::Unknown;
 
@@ -37,11 +37,19 @@ namespace Pinetime {
         const char* Title() const;
       };
 
-      void Push(Notification&& notif);
-      Notification GetLastNotification() const;
-      Notification Get(Notification::Id id) const;
-      Notification GetNext(Notification::Id id) const;
-      Notification GetPrevious(Notification::Id id) const;
+      /// Copies the message in the store, truncated to MaximumMessageSize() + 1 bytes (title '\0' body '\0')
+      void Push(Categories category, const char* message, size_t size);
+      /// Pushes a notification without intermediate copy: reserves room for a message of size bytes (title '\0' body '\0')
+      /// in the store, evicting the oldest notifications if needed, and returns the buffer the caller must fill before
+      /// calling CommitPush(). size is clamped to MaximumMessageSize() + 1. Only the BLE host task pushes notifications.
+      char* BeginPush(size_t& size);
+      void CommitPush(Categories category);
+      // The getters copy the notification into notification, which the caller keeps (the display task must not copy it
+      // on its stack). They return false, and notification.valid is false, if there is no such notification.
+      bool GetLastNotification(Notification& notification) const;
+      bool Get(Notification::Id id, Notification& notification) const;
+      bool GetNext(Notification::Id id, Notification& notification) const;
+      bool GetPrevious(Notification::Id id, Notification& notification) const;
       // Return the index of the notification with the specified id, if not found return NbNotifications()
       Notification::Idx IndexOf(Notification::Id id) const;
       bool ClearNewNotificationFlag();
@@ -56,17 +64,39 @@ namespace Pinetime {
       }
       size_t NbNotifications() const;
 
+      // Size of the arena in which the messages are stored: the store takes as much RAM as the 5 slots of 101
+      // characters it replaced
+      static constexpr size_t ArenaSize = 460;
+      // Maximum number of notifications stored, whatever their size
+      static constexpr uint8_t TotalNbNotifications = 12;
+
     private:
-      Notification::Id nextId {0};
+      // Messages are stored in the arena from the oldest to the newest notification. Dismissing a notification only
+      // removes its entry: the hole is compacted by the next BeginPush(), in the BLE host task, so the messages never
+      // move while a push is being written. Old notifications are evicted until the new message fits in the arena.
+      // The BLE host task pushes and the display task reads and dismisses: both access the store in a critical section.
+      struct Entry {
+        Notification::Id id;
+        Categories category;
+        uint16_t offset;
+        uint16_t size;
+      };
+
       Notification::Id GetNextId();
-      const Notification& At(Notification::Idx idx) const;
-      Notification& At(Notification::Idx idx);
-      void DismissIdx(Notification::Idx idx);
+      // idx 0 is the newest notification
+      const Entry& At(Notification::Idx idx) const;
+      Notification::Idx Find(Notification::Id id) const;
+      bool CopyAt(size_t idx, Notification& notification) const;
+      void RemoveEntry(size_t entryIdx);
+      uint16_t MessagesSize() const;
+      void Compact();
 
-      static constexpr uint8_t TotalNbNotifications = 5;
-      std::array<Notification, TotalNbNotifications> notifications;
-      size_t beginIdx = TotalNbNotifications - 1; // index of the newest notification
-      size_t size = 0;                            // number of valid notifications in buffer
+      std::array<char, ArenaSize> arena;
+      std::array<Entry, TotalNbNotifications> entries; // from the oldest to the newest notification
+      Notification::Id nextId {0};
+      uint8_t size = 0;         // number of valid notifications in buffer
+      uint16_t arenaUsed = 0;   // end of the last message in the arena
+      uint16_t pendingSize = 0; // size of the message reserved by BeginPush()
 
       std::atomic<bool> newNotification {false};
     };
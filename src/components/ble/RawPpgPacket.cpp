@@ -0,0 +1,54 @@
+#include "components/ble/RawPpgPacket.h"
+#include <cstring>
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  void Write16(uint8_t* buffer, uint16_t value) {
+    buffer[0] = value & 0xff;
+    buffer[1] = (value >> 8) & 0xff;
+  }
+
+  void Write24(uint8_t* buffer, uint32_t value) {
+    Write16(buffer, value & 0xffff);
+    buffer[2] = (value >> 16) & 0xff;
+  }
+
+  void Write32(uint8_t* buffer, uint32_t value) {
+    Write16(buffer, value & 0xffff);
+    Write16(buffer + 2, value >> 16);
+  }
+}
+
+size_t RawPpgPacket::SamplesPerPacket(uint16_t mtu) {
+  constexpr uint16_t attHeaderSize = 3;
+  if (mtu <= attHeaderSize) {
+    return 0;
+  }
+  size_t packetSize = mtu - attHeaderSize;
+  if (packetSize > maxPacketSize) {
+    packetSize = maxPacketSize;
+  }
+  if (packetSize < headerSize) {
+    return 0;
+  }
+  return (packetSize - headerSize) / sampleSize;
+}
+
+void RawPpgPacket::EncodeHeader(uint8_t* header, uint8_t nbSamples, uint16_t sequence, uint16_t droppedSamples, uint32_t timestamp) {
+  header[0] = formatVersion;
+  header[1] = nbSamples;
+  Write16(header + 2, sequence);
+  Write16(header + 4, droppedSamples);
+  Write32(header + 6, timestamp);
+}
+
+void RawPpgPacket::EncodeSample(uint8_t* data, uint32_t baseTimestamp, uint32_t timestamp, uint32_t hrs, uint32_t als, float agcPeak) {
+  uint32_t agcPeakBits;
+  static_assert(sizeof(agcPeakBits) == sizeof(agcPeak), "AGC peak is sent as a IEEE754 float");
+  std::memcpy(&agcPeakBits, &agcPeak, sizeof(agcPeakBits));
+  Write16(data, static_cast<uint16_t>(timestamp - baseTimestamp));
+  Write24(data + 2, hrs);
+  Write24(data + 5, als);
+  Write32(data + 8, agcPeakBits);
+}
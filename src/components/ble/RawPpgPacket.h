@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Encoding of the notifications of the raw PPG characteristic of HeartRateService.
+     * See doc/ble.md for the description of the binary format.
+     *
+     * HeartRateService appends the header and the samples to the mbuf of the notification: this class doesn't depend
+     * on NimBLE.
+     */
+    class RawPpgPacket {
+    public:
+      // Packet: header followed by up to (packet size - headerSize) / sampleSize samples
+      static constexpr uint8_t formatVersion = 1;
+      static constexpr size_t headerSize = 10;
+      static constexpr size_t sampleSize = 12;
+      static constexpr size_t maxPacketSize = 244;
+
+      /// Number of samples that fit a notification with this ATT MTU. 0 if the MTU is unknown (no connection) or too
+      /// small for a single sample.
+      static size_t SamplesPerPacket(uint16_t mtu);
+      static void EncodeHeader(uint8_t* header, uint8_t nbSamples, uint16_t sequence, uint16_t droppedSamples, uint32_t timestamp);
+      /// timestamp is sent as an offset from baseTimestamp, the timestamp of the header. hrs and als are sent on 24 bits.
+      static void EncodeSample(uint8_t* data, uint32_t baseTimestamp, uint32_t timestamp, uint32_t hrs, uint32_t als, float agcPeak);
+    };
+  }
+}
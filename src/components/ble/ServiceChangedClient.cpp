@@ -0,0 +1,172 @@
+#include "components/ble/ServiceChangedClient.h"
+#include <nrf_log.h>
+
+using namespace Pinetime::Controllers;
+
+constexpr ble_uuid16_t ServiceChangedClient::gattServiceUuid;
+constexpr ble_uuid16_t ServiceChangedClient::serviceChangedUuid;
+constexpr ble_uuid16_t ServiceChangedClient::characteristicDeclarationUuid;
+constexpr ble_uuid16_t ServiceChangedClient::clientCharacteristicConfigurationUuid;
+
+namespace {
+  int OnDiscoveryEventCallback(uint16_t conn_handle, const struct ble_gatt_error* error, const struct ble_gatt_svc* service, void* arg) {
+    auto client = static_cast<ServiceChangedClient*>(arg);
+    return client->OnDiscoveryEvent(conn_handle, error, service);
+  }
+
+  int OnCharacteristicDiscoveryEventCallback(uint16_t conn_handle,
+                                             const struct ble_gatt_error* error,
+                                             const struct ble_gatt_chr* chr,
+                                             void* arg) {
+    auto client = static_cast<ServiceChangedClient*>(arg);
+    return client->OnCharacteristicDiscoveryEvent(conn_handle, error, chr);
+  }
+
+  int OnDescriptorDiscoveryEventCallback(uint16_t conn_handle,
+                                         const struct ble_gatt_error* error,
+                                         uint16_t chr_val_handle,
+                                         const struct ble_gatt_dsc* dsc,
+                                         void* arg) {
+    auto client = static_cast<ServiceChangedClient*>(arg);
+    return client->OnDescriptorDiscoveryEvent(conn_handle, error, chr_val_handle, dsc);
+  }
+
+  int OnSubscribedCallback(uint16_t conn_handle, const struct ble_gatt_error* error, struct ble_gatt_attr* attr, void* arg) {
+    auto client = static_cast<ServiceChangedClient*>(arg);
+    return client->OnSubscribed(conn_handle, error, attr);
+  }
+}
+
+bool ServiceChangedClient::OnDiscoveryEvent(uint16_t connectionHandle, const ble_gatt_error* error, const ble_gatt_svc* service) {
+  if (service == nullptr && error->status == BLE_HS_EDONE) {
+    if (isDiscovered) {
+      ble_gattc_disc_chrs_by_uuid(connectionHandle,
+                                  gattStartHandle,
+                                  gattEndHandle,
+                                  &serviceChangedUuid.u,
+                                  OnCharacteristicDiscoveryEventCallback,
+                                  this);
+    } else {
+      NRF_LOG_INFO("GATT service not found");
+      onServiceDiscovered(connectionHandle);
+    }
+    return true;
+  }
+
+  if (service != nullptr && ble_uuid_cmp(&gattServiceUuid.u, &service->uuid.u) == 0) {
+    NRF_LOG_INFO("GATT service discovered : 0x%x - 0x%x", service->start_handle, service->end_handle);
+    gattStartHandle = service->start_handle;
+    gattEndHandle = service->end_handle;
+    isDiscovered = true;
+  }
+  return false;
+}
+
+int ServiceChangedClient::OnCharacteristicDiscoveryEvent(uint16_t connectionHandle,
+                                                         const ble_gatt_error* error,
+                                                         const ble_gatt_chr* characteristic) {
+  if (error->status == 0) {
+    if (characteristic != nullptr && ble_uuid_cmp(&serviceChangedUuid.u, &characteristic->uuid.u) == 0) {
+      NRF_LOG_INFO("Service Changed discovered : 0x%x", characteristic->val_handle);
+      serviceChangedHandle = characteristic->val_handle;
+      isCharacteristicDiscovered = true;
+    }
+    return 0;
+  }
+
+  if (error->status == BLE_HS_EDONE && isCharacteristicDiscovered) {
+    ble_gattc_disc_all_dscs(connectionHandle, serviceChangedHandle, gattEndHandle, OnDescriptorDiscoveryEventCallback, this);
+  } else {
+    NRF_LOG_INFO("Service Changed not found");
+    onServiceDiscovered(connectionHandle);
+  }
+  return 0;
+}
+
+int ServiceChangedClient::OnDescriptorDiscoveryEvent(uint16_t connectionHandle,
+                                                     const ble_gatt_error* error,
+                                                     uint16_t characteristicValueHandle,
+                                                     const ble_gatt_dsc* descriptor) {
+  if (error->status == 0) {
+    if (characteristicValueHandle == serviceChangedHandle && descriptor != nullptr && !isLastDescriptor) {
+      if (ble_uuid_cmp(&characteristicDeclarationUuid.u, &descriptor->uuid.u) == 0) {
+        isLastDescriptor = true;
+      } else if (ble_uuid_cmp(&clientCharacteristicConfigurationUuid.u, &descriptor->uuid.u) == 0) {
+        NRF_LOG_INFO("Service Changed descriptor discovered : 0x%x", descriptor->handle);
+        serviceChangedDescriptorHandle = descriptor->handle;
+      }
+    }
+    return 0;
+  }
+
+  if (error->status == BLE_HS_EDONE && serviceChangedDescriptorHandle != 0) {
+    Subscribe(connectionHandle);
+  } else {
+    onServiceDiscovered(connectionHandle);
+  }
+  return 0;
+}
+
+int ServiceChangedClient::OnSubscribed(uint16_t connectionHandle, const ble_gatt_error* error, ble_gatt_attr* /*attribute*/) {
+  if (error->status == 0) {
+    NRF_LOG_INFO("Service Changed subscribe OK");
+    isSubscribed = true;
+  } else {
+    NRF_LOG_INFO("Service Changed subscribe ERROR");
+    // The handles may be stale: don't save them
+    isSubscribed = false;
+  }
+  onServiceDiscovered(connectionHandle);
+  return 0;
+}
+
+bool ServiceChangedClient::IsServiceChanged(uint16_t attributeHandle) const {
+  return serviceChangedHandle != 0 && attributeHandle == serviceChangedHandle;
+}
+
+void ServiceChangedClient::Reset() {
+  gattStartHandle = 0;
+  gattEndHandle = 0;
+  serviceChangedHandle = 0;
+  serviceChangedDescriptorHandle = 0;
+  isDiscovered = false;
+  isCharacteristicDiscovered = false;
+  isLastDescriptor = false;
+  isSubscribed = false;
+}
+
+void ServiceChangedClient::Discover(uint16_t connectionHandle, std::function<void(uint16_t)> onServiceDiscovered) {
+  NRF_LOG_INFO("[Service Changed] Starting discovery");
+  Reset();
+  this->onServiceDiscovered = onServiceDiscovered;
+  ble_gattc_disc_svc_by_uuid(connectionHandle, &gattServiceUuid.u, OnDiscoveryEventCallback, this);
+}
+
+bool ServiceChangedClient::SaveHandles(Handles& handles) const {
+  if (!isSubscribed) {
+    return false;
+  }
+  handles = {serviceChangedHandle, serviceChangedDescriptorHandle};
+  return true;
+}
+
+void ServiceChangedClient::RestoreHandles(uint16_t connectionHandle,
+                                          const Handles& handles,
+                                          std::function<void(uint16_t)> onServiceDiscovered) {
+  NRF_LOG_INFO("[Service Changed] Restoring handles");
+  Reset();
+  this->onServiceDiscovered = onServiceDiscovered;
+  serviceChangedHandle = handles[0];
+  serviceChangedDescriptorHandle = handles[1];
+  isDiscovered = true;
+  isCharacteristicDiscovered = true;
+  Subscribe(connectionHandle);
+}
+
+void ServiceChangedClient::Subscribe(uint16_t connectionHandle) {
+  // Indications
+  uint8_t value[2];
+  value[0] = 2;
+  value[1] = 0;
+  ble_gattc_write_flat(connectionHandle, serviceChangedDescriptorHandle, value, sizeof(value), OnSubscribedCallback, this);
+}
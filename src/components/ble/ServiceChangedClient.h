@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <host/ble_gap.h>
+#undef max
+#undef min
+#include "components/ble/BleClient.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Subscribes to the indications of the Service Changed characteristic of the GATT service of the peer, which tell
+     * that the attribute handles of the peer changed.
+     */
+    class ServiceChangedClient : public BleClient {
+    public:
+      bool OnDiscoveryEvent(uint16_t connectionHandle, const ble_gatt_error* error, const ble_gatt_svc* service);
+      int OnCharacteristicDiscoveryEvent(uint16_t connectionHandle, const ble_gatt_error* error, const ble_gatt_chr* characteristic);
+      int OnDescriptorDiscoveryEvent(uint16_t connectionHandle,
+                                     const ble_gatt_error* error,
+                                     uint16_t characteristicValueHandle,
+                                     const ble_gatt_dsc* descriptor);
+      int OnSubscribed(uint16_t connectionHandle, const ble_gatt_error* error, ble_gatt_attr* attribute);
+
+      /// True if the attribute is the Service Changed characteristic of the peer
+      bool IsServiceChanged(uint16_t attributeHandle) const;
+
+      void Reset();
+      void Discover(uint16_t connectionHandle, std::function<void(uint16_t)> lambda) override;
+      bool SaveHandles(Handles& handles) const override;
+      void RestoreHandles(uint16_t connectionHandle, const Handles& handles, std::function<void(uint16_t)> lambda) override;
+
+    private:
+      void Subscribe(uint16_t connectionHandle);
+
+      static constexpr uint16_t gattServiceId {0x1801};
+      static constexpr uint16_t serviceChangedId {0x2a05};
+      static constexpr uint16_t characteristicDeclarationId {0x2803};
+      static constexpr uint16_t clientCharacteristicConfigurationId {0x2902};
+
+      static constexpr ble_uuid16_t gattServiceUuid {.u {.type = BLE_UUID_TYPE_16}, .value = gattServiceId};
+      static constexpr ble_uuid16_t serviceChangedUuid {.u {.type = BLE_UUID_TYPE_16}, .value = serviceChangedId};
+      static constexpr ble_uuid16_t characteristicDeclarationUuid {.u {.type = BLE_UUID_TYPE_16}, .value = characteristicDeclarationId};
+      static constexpr ble_uuid16_t clientCharacteristicConfigurationUuid {.u {.type = BLE_UUID_TYPE_16},
+                                                                           .value = clientCharacteristicConfigurationId};
+
+      uint16_t gattStartHandle = 0;
+      uint16_t gattEndHandle = 0;
+      uint16_t serviceChangedHandle = 0;
+      uint16_t serviceChangedDescriptorHandle = 0;
+      bool isDiscovered = false;
+      bool isCharacteristicDiscovered = false;
+      // The descriptors of the characteristic end at the declaration of the next one
+      bool isLastDescriptor = false;
+      bool isSubscribed = false;
+      std::function<void(uint16_t)> onServiceDiscovered;
+    };
+  }
+}
@@ -1,16 +1,77 @@
 #include "components/ble/ServiceDiscovery.h"
 #include <libraries/log/nrf_log.h>
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <host/ble_gap.h>
+#undef max
+#undef min
 #include "components/ble/BleClient.h"
 
 using namespace Pinetime::Controllers;
 
-ServiceDiscovery::ServiceDiscovery(std::array<BleClient*, 2>&& clients) : clients {clients} {
+namespace {
+  constexpr uint16_t databaseHashId {0x2b2a};
+  constexpr ble_uuid16_t databaseHashUuid {.u {.type = BLE_UUID_TYPE_16}, .value = databaseHashId};
+
+  int OnDatabaseHashReadCallback(uint16_t conn_handle, const struct ble_gatt_error* error, struct ble_gatt_attr* attr, void* arg) {
+    auto discovery = static_cast<ServiceDiscovery*>(arg);
+    return discovery->OnDatabaseHashRead(conn_handle, error, attr);
+  }
+}
+
+ServiceDiscovery::ServiceDiscovery(std::array<BleClient*, 2>&& bleClients) : clients {&serviceChangedClient, bleClients[0], bleClients[1]} {
 }
 
 void ServiceDiscovery::StartDiscovery(uint16_t connectionHandle) {
   NRF_LOG_INFO("[Discovery] Starting discovery");
+  restoringFromCache = false;
+  databaseHashRead = false;
+  serviceChangedClient.Reset();
+
+  ble_gap_conn_desc desc;
+  peerBonded = (ble_gap_conn_find(connectionHandle, &desc) == 0) && desc.sec_state.bonded;
+  if (peerBonded) {
+    peerAddress = desc.peer_id_addr;
+    // The database hash tells whether the handles cached during the previous connection are still valid
+    waitingDatabaseHash = true;
+    if (ble_gattc_read_by_uuid(connectionHandle, 1, 0xffff, &databaseHashUuid.u, OnDatabaseHashReadCallback, this) == 0) {
+      return;
+    }
+    waitingDatabaseHash = false;
+  }
+
+  clientIterator = clients.begin();
+  DiscoverNextService(connectionHandle);
+}
+
+int ServiceDiscovery::OnDatabaseHashRead(uint16_t connectionHandle, const ble_gatt_error* error, const ble_gatt_attr* attribute) {
+  if (!waitingDatabaseHash) {
+    return 0;
+  }
+
+  if (error->status == 0) {
+    if (attribute != nullptr && static_cast<size_t>(OS_MBUF_PKTLEN(attribute->om)) == databaseHash.size()) {
+      os_mbuf_copydata(attribute->om, 0, databaseHash.size(), databaseHash.data());
+      databaseHashRead = true;
+    }
+    return 0;
+  }
+
+  // The read is complete (or failed, if the peer doesn't expose a database hash)
+  waitingDatabaseHash = false;
+  if (cache.valid && ble_addr_cmp(&cache.peerAddress, &peerAddress) == 0) {
+    if (databaseHashRead && cache.databaseHash == databaseHash) {
+      NRF_LOG_INFO("[Discovery] Database hash unchanged, restoring cached handles");
+      restoringFromCache = true;
+    } else {
+      NRF_LOG_INFO("[Discovery] Database hash changed, discarding cached handles");
+      InvalidateCache();
+    }
+  }
+
   clientIterator = clients.begin();
   DiscoverNextService(connectionHandle);
+  return 0;
 }
 
 void ServiceDiscovery::OnServiceDiscovered(uint16_t connectionHandle) {
@@ -19,6 +80,7 @@ void ServiceDiscovery::OnServiceDiscovered(uint16_t connectionHandle) {
     DiscoverNextService(connectionHandle);
   } else {
     NRF_LOG_INFO("End of service discovery");
+    SaveCache();
   }
 }
 
@@ -28,5 +90,38 @@ void ServiceDiscovery::DiscoverNextService(uint16_t connectionHandle) {
   auto discoverNextService = [this](uint16_t connectionHandle) {
     this->OnServiceDiscovered(connectionHandle);
   };
-  (*clientIterator)->Discover(connectionHandle, discoverNextService);
-}
\ No newline at end of file
+  if (restoringFromCache) {
+    (*clientIterator)->RestoreHandles(connectionHandle, cache.handles[clientIterator - clients.begin()], discoverNextService);
+  } else {
+    (*clientIterator)->Discover(connectionHandle, discoverNextService);
+  }
+}
+
+void ServiceDiscovery::SaveCache() {
+  if (!peerBonded || !databaseHashRead) {
+    return;
+  }
+
+  // A client that failed (or whose restored handles turned out to be stale) must be discovered again next time
+  for (size_t i = 0; i < clients.size(); i++) {
+    if (!clients[i]->SaveHandles(cache.handles[i])) {
+      InvalidateCache();
+      return;
+    }
+  }
+  cache.peerAddress = peerAddress;
+  cache.databaseHash = databaseHash;
+  cache.valid = true;
+}
+
+void ServiceDiscovery::OnIndication(uint16_t attributeHandle) {
+  // The clients only subscribe to notifications, but the peer may send other indications
+  if (serviceChangedClient.IsServiceChanged(attributeHandle)) {
+    NRF_LOG_INFO("[Discovery] Services of the peer changed, discarding cached handles");
+    InvalidateCache();
+  }
+}
+
+void ServiceDiscovery::InvalidateCache() {
+  cache.valid = false;
+}
@@ -2,22 +2,66 @@
 
 #include <array>
 #include <cstdint>
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <host/ble_gatt.h>
+#include <nimble/ble.h>
+#undef max
+#undef min
+#include "components/ble/BleClient.h"
+#include "components/ble/ServiceChangedClient.h"
 
 namespace Pinetime {
   namespace Controllers {
-    class BleClient;
-
+    /**
+     * Runs the discovery of the clients one after the other.
+     *
+     * The handles found by the clients are cached for the last bonded peer, along with the GATT database hash of the peer.
+     * When this peer reconnects, its database hash is read first: if it didn't change, the clients restore their handles
+     * instead of running the discovery again. Peers that don't expose a database hash are always discovered.
+     *
+     * The discovery also subscribes to the Service Changed characteristic of the peer: its indication discards the cache.
+     */
     class ServiceDiscovery {
     public:
       ServiceDiscovery(std::array<BleClient*, 2>&& bleClients);
 
       void StartDiscovery(uint16_t connectionHandle);
 
+      /// To be called when the peer sends an indication
+      void OnIndication(uint16_t attributeHandle);
+
+      int OnDatabaseHashRead(uint16_t connectionHandle, const ble_gatt_error* error, const ble_gatt_attr* attribute);
+
     private:
+      static constexpr size_t DatabaseHashSize = 16;
+      using DatabaseHash = std::array<uint8_t, DatabaseHashSize>;
+
+      ServiceChangedClient serviceChangedClient;
+      // The Service Changed client first, then the clients given to the constructor
+      std::array<BleClient*, 3> clients;
       BleClient** clientIterator;
-      std::array<BleClient*, 2> clients;
+
+      struct Cache {
+        bool valid = false;
+        ble_addr_t peerAddress;
+        DatabaseHash databaseHash;
+        std::array<BleClient::Handles, 3> handles;
+      };
+
       void OnServiceDiscovered(uint16_t connectionHandle);
       void DiscoverNextService(uint16_t connectionHandle);
+      void SaveCache();
+      void InvalidateCache();
+
+      Cache cache;
+      bool restoringFromCache = false;
+      // Identity address of the connected peer, valid if it is bonded
+      bool peerBonded = false;
+      ble_addr_t peerAddress;
+      bool waitingDatabaseHash = false;
+      bool databaseHashRead = false;
+      DatabaseHash databaseHash;
     };
   }
 }
@@ -17,6 +17,8 @@
 */
 #pragma once
 
+#include <cstdint>
+
 /**
  * Different weather events, weather data structures used by {@link WeatherService.h}
  *
@@ -30,7 +32,9 @@
  * so keep in the bounds of the data types given.
  *
  * Write all struct members (CamelCase keys) into a single finite-sized map, and write it to the characteristic.
- * Mind the MTU.
+ * Several events, e.g. a whole forecast, can be sent in a single write as an array of such maps.
+ * Mind the MTU: payloads longer than it need a long write, up to 512 bytes.
+ * Unknown keys are ignored.
  *
  * How to debug?
  *
@@ -289,8 +293,8 @@ namespace Pinetime {
        */
       class Location : public TimelineHeader {
       public:
-        /** Location name */
-        std::string location;
+        /** Location name, null-terminated and stored in the string arena of the WeatherTimeline */
+        const char* location;
         /** Altitude relative to sea level in meters */
         int16_t altitude;
         /** Latitude, EPSG:3857 (Google Maps, Openstreetmaps datum) */
@@ -350,8 +354,10 @@ namespace Pinetime {
          * For generic ones use "PM0.1", "PM5", "PM10"
          * For chemical compounds use the molecular formula e.g. "NO2", "CO2", "O3"
          * For pollen use the genus, e.g. "Betula" for birch or "Alternaria" for that mold's spores
+         *
+         * Null-terminated and stored in the string arena of the WeatherTimeline
          */
-        std::string polluter;
+        const char* polluter;
         /**
          * Amount of the pollution in SI units,
          * otherwise it's going to be difficult to create UI, alerts
@@ -0,0 +1,391 @@
+/*  Copyright (C) 2021 Avamander
+
+    This file is part of InfiniTime.
+
+    InfiniTime is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    InfiniTime is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "WeatherDecoder.h"
+#include <algorithm>
+#include <cstring>
+
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <host/ble_att.h>
+#undef max
+#undef min
+
+#include "WeatherTimeline.h"
+#include "libs/QCBOR/inc/qcbor/qcbor.h"
+
+namespace {
+  using Pinetime::Controllers::WeatherData;
+  using Pinetime::Controllers::WeatherTimeline;
+
+  /// Keys of the event maps
+  enum class Field : uint8_t {
+    Timestamp,
+    Expires,
+    EventType,
+    Polluter,
+    Amount,
+    Type,
+    SpeedMin,
+    SpeedMax,
+    DirectionMin,
+    DirectionMax,
+    Temperature,
+    DewPoint,
+    Pressure,
+    Location,
+    Altitude,
+    Latitude,
+    Longitude,
+    Humidity,
+    Unknown
+  };
+  constexpr size_t NbFields = static_cast<size_t>(Field::Unknown);
+
+  /// Label and accepted range of each field, validated while walking the map.
+  /// Type and Amount depend on the event type and are narrowed once the whole event is decoded.
+  struct FieldSpec {
+    const char* label;
+    bool text;
+    int64_t min;
+    int64_t max;
+  };
+  constexpr FieldSpec fieldSpecs[NbFields] = {
+    {"Timestamp", false, 0, INT64_MAX},
+    {"Expires", false, 0, UINT32_MAX},
+    {"EventType", false, 0, static_cast<int64_t>(WeatherData::eventtype::Length) - 1},
+    {"Polluter", true, 0, 0},
+    {"Amount", false, 0, UINT32_MAX},
+    {"Type", false, 0, UINT8_MAX},
+    {"SpeedMin", false, 0, UINT8_MAX},
+    {"SpeedMax", false, 0, UINT8_MAX},
+    {"DirectionMin", false, 0, UINT8_MAX},
+    {"DirectionMax", false, 0, UINT8_MAX},
+    {"Temperature", false, INT16_MIN, INT16_MAX},
+    {"DewPoint", false, INT16_MIN, INT16_MAX},
+    {"Pressure", false, 0, INT16_MAX},
+    {"Location", true, 0, 0},
+    {"Altitude", false, INT16_MIN, INT16_MAX},
+    {"Latitude", false, INT32_MIN, INT32_MAX},
+    {"Longitude", false, INT32_MIN, INT32_MAX},
+    {"Humidity", false, 0, UINT8_MAX},
+  };
+
+  constexpr size_t LabelLength(const char* label) {
+    size_t length = 0;
+    while (label[length] != '\0') {
+      length++;
+    }
+    return length;
+  }
+
+  // Labels are at least 2 characters long, this is a perfect hash for them (checked below)
+  constexpr size_t FieldTableSize = 32;
+  constexpr uint8_t HashLabel(const char* label, size_t length) {
+    return (length * 5 + static_cast<uint8_t>(label[0]) + static_cast<uint8_t>(label[length - 2]) * 23) % FieldTableSize;
+  }
+
+  struct FieldTable {
+    Field slots[FieldTableSize];
+    bool perfect;
+  };
+
+  constexpr FieldTable MakeFieldTable() {
+    FieldTable table {};
+    for (auto& slot : table.slots) {
+      slot = Field::Unknown;
+    }
+    table.perfect = true;
+    for (size_t i = 0; i < NbFields; i++) {
+      uint8_t hash = HashLabel(fieldSpecs[i].label, LabelLength(fieldSpecs[i].label));
+      if (table.slots[hash] != Field::Unknown) {
+        table.perfect = false;
+      }
+      table.slots[hash] = static_cast<Field>(i);
+    }
+    return table;
+  }
+
+  constexpr FieldTable fieldTable = MakeFieldTable();
+  static_assert(fieldTable.perfect, "Weather field labels collide, update HashLabel()");
+
+  Field LookUpField(UsefulBufC label) {
+    if (label.len < 2) {
+      return Field::Unknown;
+    }
+    const char* str = static_cast<const char*>(label.ptr);
+    Field field = fieldTable.slots[HashLabel(str, label.len)];
+    if (field == Field::Unknown) {
+      return Field::Unknown;
+    }
+    const char* expected = fieldSpecs[static_cast<size_t>(field)].label;
+    if (std::strlen(expected) != label.len || std::memcmp(expected, str, label.len) != 0) {
+      return Field::Unknown;
+    }
+    return field;
+  }
+
+  constexpr uint32_t Bit(Field field) {
+    return 1U << static_cast<uint8_t>(field);
+  }
+
+  struct DecodedEvent {
+    union Value {
+      int64_t number;
+      UsefulBufC text;
+    };
+    Value values[NbFields];
+    uint32_t present = 0;
+
+    bool Has(uint32_t fields) const {
+      return (present & fields) == fields;
+    }
+    int64_t Number(Field field) const {
+      return values[static_cast<size_t>(field)].number;
+    }
+    UsefulBufC Text(Field field) const {
+      return values[static_cast<size_t>(field)].text;
+    }
+  };
+
+  template <size_t N>
+  void CopyString(char (&destination)[N], UsefulBufC source) {
+    size_t length = std::min(source.len, N - 1);
+    std::memcpy(destination, source.ptr, length);
+    destination[length] = '\0';
+  }
+
+  void FillHeader(WeatherData::TimelineHeader& header, const DecodedEvent& event) {
+    header.timestamp = event.Number(Field::Timestamp);
+    header.expires = event.Number(Field::Expires);
+    header.eventType = static_cast<WeatherData::eventtype>(event.Number(Field::EventType));
+  }
+
+  /**
+   * Validates the fields of the event type and adds the event to the timeline
+   */
+  int AddDecodedEvent(WeatherTimeline& timeline, const DecodedEvent& event) {
+    if (!event.Has(Bit(Field::Timestamp) | Bit(Field::Expires) | Bit(Field::EventType))) {
+      return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+    }
+
+    bool added = false;
+    switch (static_cast<WeatherData::eventtype>(event.Number(Field::EventType))) {
+      case WeatherData::eventtype::AirQuality: {
+        if (!event.Has(Bit(Field::Polluter) | Bit(Field::Amount))) {
+          return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+        }
+        WeatherData::AirQuality airquality;
+        FillHeader(airquality, event);
+        char polluter[WeatherTimeline::MaxStringLength + 1];
+        CopyString(polluter, event.Text(Field::Polluter));
+        airquality.polluter = polluter;
+        airquality.amount = event.Number(Field::Amount);
+        added = timeline.AddEventToTimeline(airquality);
+        break;
+      }
+      case WeatherData::eventtype::Obscuration: {
+        if (!event.Has(Bit(Field::Type) | Bit(Field::Amount)) ||
+            event.Number(Field::Type) >= static_cast<int64_t>(WeatherData::obscurationtype::Length) ||
+            event.Number(Field::Amount) > UINT16_MAX) {
+          return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+        }
+        WeatherData::Obscuration obscuration;
+        FillHeader(obscuration, event);
+        obscuration.type = static_cast<WeatherData::obscurationtype>(event.Number(Field::Type));
+        obscuration.amount = event.Number(Field::Amount);
+        added = timeline.AddEventToTimeline(obscuration);
+        break;
+      }
+      case WeatherData::eventtype::Precipitation: {
+        if (!event.Has(Bit(Field::Type) | Bit(Field::Amount)) ||
+            event.Number(Field::Type) >= static_cast<int64_t>(WeatherData::precipitationtype::Length) ||
+            event.Number(Field::Amount) > UINT8_MAX) {
+          return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+        }
+        WeatherData::Precipitation precipitation;
+        FillHeader(precipitation, event);
+        precipitation.type = static_cast<WeatherData::precipitationtype>(event.Number(Field::Type));
+        precipitation.amount = event.Number(Field::Amount);
+        added = timeline.AddEventToTimeline(precipitation);
+        break;
+      }
+      case WeatherData::eventtype::Wind: {
+        if (!event.Has(Bit(Field::SpeedMin) | Bit(Field::SpeedMax) | Bit(Field::DirectionMin) | Bit(Field::DirectionMax))) {
+          return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+        }
+        WeatherData::Wind wind;
+        FillHeader(wind, event);
+        wind.speedMin = event.Number(Field::SpeedMin);
+        wind.speedMax = event.Number(Field::SpeedMax);
+        wind.directionMin = event.Number(Field::DirectionMin);
+        wind.directionMax = event.Number(Field::DirectionMax);
+        added = timeline.AddEventToTimeline(wind);
+        break;
+      }
+      case WeatherData::eventtype::Temperature: {
+        if (!event.Has(Bit(Field::Temperature) | Bit(Field::DewPoint))) {
+          return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+        }
+        WeatherData::Temperature temperature;
+        FillHeader(temperature, event);
+        temperature.temperature = event.Number(Field::Temperature);
+        temperature.dewPoint = event.Number(Field::DewPoint);
+        added = timeline.AddEventToTimeline(temperature);
+        break;
+      }
+      case WeatherData::eventtype::Special: {
+        if (!event.Has(Bit(Field::Type)) || event.Number(Field::Type) >= static_cast<int64_t>(WeatherData::specialtype::Length)) {
+          return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+        }
+        WeatherData::Special special;
+        FillHeader(special, event);
+        special.type = static_cast<WeatherData::specialtype>(event.Number(Field::Type));
+        added = timeline.AddEventToTimeline(special);
+        break;
+      }
+      case WeatherData::eventtype::Pressure: {
+        if (!event.Has(Bit(Field::Pressure))) {
+          return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+        }
+        WeatherData::Pressure pressure;
+        FillHeader(pressure, event);
+        pressure.pressure = event.Number(Field::Pressure);
+        added = timeline.AddEventToTimeline(pressure);
+        break;
+      }
+      case WeatherData::eventtype::Location: {
+        if (!event.Has(Bit(Field::Location) | Bit(Field::Altitude) | Bit(Field::Latitude) | Bit(Field::Longitude))) {
+          return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+        }
+        WeatherData::Location location;
+        FillHeader(location, event);
+        char locationName[WeatherTimeline::MaxStringLength + 1];
+        CopyString(locationName, event.Text(Field::Location));
+        location.location = locationName;
+        location.altitude = event.Number(Field::Altitude);
+        location.latitude = event.Number(Field::Latitude);
+        location.longitude = event.Number(Field::Longitude);
+        added = timeline.AddEventToTimeline(location);
+        break;
+      }
+      case WeatherData::eventtype::Clouds: {
+        if (!event.Has(Bit(Field::Amount)) || event.Number(Field::Amount) > UINT8_MAX) {
+          return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+        }
+        WeatherData::Clouds clouds;
+        FillHeader(clouds, event);
+        clouds.amount = event.Number(Field::Amount);
+        added = timeline.AddEventToTimeline(clouds);
+        break;
+      }
+      case WeatherData::eventtype::Humidity: {
+        if (!event.Has(Bit(Field::Humidity))) {
+          return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+        }
+        WeatherData::Humidity humidity;
+        FillHeader(humidity, event);
+        humidity.humidity = event.Number(Field::Humidity);
+        added = timeline.AddEventToTimeline(humidity);
+        break;
+      }
+      default:
+        return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+    }
+
+    return added ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+  }
+
+  /**
+   * Reads the entries of the map whose header is item in a single pass and adds the event to the timeline.
+   * On return, item is the last item of the map.
+   */
+  int DecodeEvent(WeatherTimeline& timeline, QCBORDecodeContext& decodeContext, QCBORItem& item) {
+    DecodedEvent event;
+    const uint8_t mapLevel = item.uNestingLevel;
+    while (item.uNextNestLevel > mapLevel) {
+      if (QCBORDecode_GetNext(&decodeContext, &item) != QCBOR_SUCCESS || item.uLabelType != QCBOR_TYPE_TEXT_STRING) {
+        return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+      }
+
+      Field field = LookUpField(item.label.string);
+      if (field == Field::Unknown) {
+        // Ignore the fields we don't know about, with the maps and arrays nested in them
+        const uint8_t fieldLevel = item.uNestingLevel;
+        while (item.uNextNestLevel > fieldLevel) {
+          if (QCBORDecode_GetNext(&decodeContext, &item) != QCBOR_SUCCESS) {
+            return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+          }
+        }
+        continue;
+      }
+      const FieldSpec& spec = fieldSpecs[static_cast<size_t>(field)];
+      DecodedEvent::Value& value = event.values[static_cast<size_t>(field)];
+      if (spec.text) {
+        if (item.uDataType != QCBOR_TYPE_TEXT_STRING || UsefulBuf_IsNULLOrEmptyC(item.val.string) != 0) {
+          return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+        }
+        value.text = item.val.string;
+      } else {
+        // Always encodes to the smallest number of bytes based on the value
+        if (item.uDataType != QCBOR_TYPE_INT64 || item.val.int64 < spec.min || item.val.int64 > spec.max) {
+          return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+        }
+        value.number = item.val.int64;
+      }
+      event.present |= Bit(field);
+    }
+
+    return AddDecodedEvent(timeline, event);
+  }
+}
+
+namespace Pinetime {
+  namespace Controllers {
+    int WeatherDecoder::Decode(const uint8_t* payload, size_t size, WeatherTimeline& timeline) {
+      QCBORDecodeContext decodeContext;
+      QCBORDecode_Init(&decodeContext, UsefulBufC {payload, size}, QCBOR_DECODE_MODE_NORMAL);
+      QCBORItem item;
+      if (QCBORDecode_GetNext(&decodeContext, &item) != QCBOR_SUCCESS) {
+        QCBORDecode_Finish(&decodeContext);
+        return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+      }
+
+      int result = 0;
+      if (item.uDataType == QCBOR_TYPE_MAP) {
+        result = DecodeEvent(timeline, decodeContext, item);
+      } else if (item.uDataType == QCBOR_TYPE_ARRAY) {
+        // Array of events, e.g. a whole forecast. The events decoded before an invalid one are kept.
+        const uint8_t arrayLevel = item.uNestingLevel;
+        while (result == 0 && item.uNextNestLevel > arrayLevel) {
+          if (QCBORDecode_GetNext(&decodeContext, &item) != QCBOR_SUCCESS || item.uDataType != QCBOR_TYPE_MAP) {
+            result = BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+          } else {
+            result = DecodeEvent(timeline, decodeContext, item);
+          }
+        }
+      } else {
+        result = BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+      }
+
+      if (QCBORDecode_Finish(&decodeContext) != QCBOR_SUCCESS && result == 0) {
+        result = BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+      }
+      return result;
+    }
+  }
+}
@@ -0,0 +1,43 @@
+/*  Copyright (C) 2021 Avamander
+
+    This file is part of InfiniTime.
+
+    InfiniTime is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    InfiniTime is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+    class WeatherTimeline;
+
+    /**
+     * Decodes the payloads written to the data characteristic of the WeatherService: a CBOR map of an event, or an
+     * array of them. See {@link WeatherData.h} for more information.
+     */
+    class WeatherDecoder {
+    public:
+      /**
+       * Decodes the events in a single pass over the payload and adds them to the timeline
+       *
+       * Unknown keys are skipped, with the maps and arrays nested in them. The events decoded before an invalid one
+       * are kept.
+       * @return 0, or the ATT error to answer the write with
+       */
+      static int Decode(const uint8_t* payload, size_t size, WeatherTimeline& timeline);
+    };
+  }
+}
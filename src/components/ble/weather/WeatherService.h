@@ -17,10 +17,9 @@
 */
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <string>
-#include <vector>
-#include <memory>
 
 #define min // workaround: nimble's min/max macros conflict with libstdc++
 #define max
@@ -30,11 +29,10 @@
 #undef min
 
 #include "WeatherData.h"
-#include "libs/QCBOR/inc/qcbor/qcbor.h"
+#include "WeatherTimeline.h"
+#include "components/ble/GattServiceTable.h"
 #include "components/datetime/DateTimeController.h"
 
-int WeatherCallback(uint16_t connHandle, uint16_t attrHandle, struct ble_gatt_access_ctxt* ctxt, void* arg);
-
 namespace Pinetime {
   namespace System {
     class SystemTask;
@@ -47,127 +45,78 @@ namespace Pinetime {
 
       void Init();
 
-      int OnCommand(uint16_t connHandle, uint16_t attrHandle, struct ble_gatt_access_ctxt* ctxt);
-
       /*
-       * Helper functions for quick access to currently valid data
-       */
-      std::unique_ptr<WeatherData::Location>& GetCurrentLocation();
-      std::unique_ptr<WeatherData::Clouds>& GetCurrentClouds();
-      std::unique_ptr<WeatherData::Obscuration>& GetCurrentObscuration();
-      std::unique_ptr<WeatherData::Precipitation>& GetCurrentPrecipitation();
-      std::unique_ptr<WeatherData::Wind>& GetCurrentWind();
-      std::unique_ptr<WeatherData::Temperature>& GetCurrentTemperature();
-      std::unique_ptr<WeatherData::Humidity>& GetCurrentHumidity();
-      std::unique_ptr<WeatherData::Pressure>& GetCurrentPressure();
-      std::unique_ptr<WeatherData::AirQuality>& GetCurrentQuality();
-
-      /**
-       * Searches for the current day's maximum temperature
-       * @return -32768 if there's no data, degrees Celsius times 100 otherwise
-       */
-      int16_t GetTodayMaxTemp() const;
-      /**
-       * Searches for the current day's minimum temperature
-       * @return -32768 if there's no data, degrees Celsius times 100 otherwise
+       * Helper functions for quick access to currently valid data, see {@link WeatherTimeline.h}
        */
-      int16_t GetTodayMinTemp() const;
-
-      /*
-       * Management functions
-       */
-      /**
-       * Adds an event to the timeline
-       * @return
-       */
-      bool AddEventToTimeline(std::unique_ptr<WeatherData::TimelineHeader> event);
-      /**
-       * Gets the current timeline length
-       */
-      size_t GetTimelineLength() const;
-      /**
-       * Checks if an event of a certain type exists in the timeline
-       */
-      bool HasTimelineEventOfType(WeatherData::eventtype type) const;
-
-    private:
-      // 00040000-78fc-48fe-8e23-433b3a1942d0
-      static constexpr ble_uuid128_t BaseUuid() {
-        return CharUuid(0x00, 0x00);
+      bool GetCurrentLocation(WeatherData::Location& event, WeatherTimeline::String& location) const {
+        return timeline.GetCurrentLocation(event, location);
       }
-
-      // 0004yyxx-78fc-48fe-8e23-433b3a1942d0
-      static constexpr ble_uuid128_t CharUuid(uint8_t x, uint8_t y) {
-        return ble_uuid128_t {.u = {.type = BLE_UUID_TYPE_128},
-                              .value = {0xd0, 0x42, 0x19, 0x3a, 0x3b, 0x43, 0x23, 0x8e, 0xfe, 0x48, 0xfc, 0x78, y, x, 0x04, 0x00}};
+      bool GetCurrentClouds(WeatherData::Clouds& event) const {
+        return timeline.GetCurrentClouds(event);
+      }
+      bool GetCurrentObscuration(WeatherData::Obscuration& event) const {
+        return timeline.GetCurrentObscuration(event);
+      }
+      bool GetCurrentPrecipitation(WeatherData::Precipitation& event) const {
+        return timeline.GetCurrentPrecipitation(event);
+      }
+      bool GetCurrentWind(WeatherData::Wind& event) const {
+        return timeline.GetCurrentWind(event);
+      }
+      bool GetCurrentTemperature(WeatherData::Temperature& event) const {
+        return timeline.GetCurrentTemperature(event);
+      }
+      bool GetCurrentHumidity(WeatherData::Humidity& event) const {
+        return timeline.GetCurrentHumidity(event);
+      }
+      bool GetCurrentPressure(WeatherData::Pressure& event) const {
+        return timeline.GetCurrentPressure(event);
+      }
+      bool GetCurrentQuality(WeatherData::AirQuality& event, WeatherTimeline::String& polluter) const {
+        return timeline.GetCurrentQuality(event, polluter);
+      }
+      int16_t GetTodayMaxTemp() const {
+        return timeline.GetTodayMaxTemp();
+      }
+      int16_t GetTodayMinTemp() const {
+        return timeline.GetTodayMinTemp();
+      }
+      size_t GetTimelineLength() const {
+        return timeline.GetTimelineLength();
+      }
+      bool HasTimelineEventOfType(WeatherData::eventtype type) const {
+        return timeline.HasTimelineEventOfType(type);
       }
 
-      ble_uuid128_t weatherUuid {BaseUuid()};
+      /// Largest payload accepted on the data characteristic (maximum ATT attribute length)
+      static constexpr size_t MaxPayloadSize = 512;
 
+    private:
       /**
-       * Just write timeline data here.
+       * Decodes the timeline events written to the data characteristic
        *
        * See {@link WeatherData.h} for more information.
        */
-      ble_uuid128_t weatherDataCharUuid {CharUuid(0x00, 0x01)};
+      int OnDataWritten(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
       /**
-       * This doesn't take timeline data, provides some control over it.
+       * Reads the control characteristic
        *
        * NOTE: Currently not supported. Companion app implementer feedback required.
        * There's very little point in solidifying an API before we know the needs.
        */
-      ble_uuid128_t weatherControlCharUuid {CharUuid(0x00, 0x02)};
-
-      const struct ble_gatt_chr_def characteristicDefinition[3] = {
-        {.uuid = &weatherDataCharUuid.u,
-         .access_cb = WeatherCallback,
-         .arg = this,
-         .flags = BLE_GATT_CHR_F_WRITE,
-         .val_handle = &eventHandle},
-        {.uuid = &weatherControlCharUuid.u, .access_cb = WeatherCallback, .arg = this, .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ},
-        {nullptr}};
-      const struct ble_gatt_svc_def serviceDefinition[2] = {
-        {.type = BLE_GATT_SVC_TYPE_PRIMARY, .uuid = &weatherUuid.u, .characteristics = characteristicDefinition},
-        {0}};
+      int OnControlRead(uint16_t connectionHandle, ble_gatt_access_ctxt* context);
 
-      uint16_t eventHandle {};
-
-      Pinetime::System::SystemTask& system;
-      Pinetime::Controllers::DateTime& dateTimeController;
-
-      std::vector<std::unique_ptr<WeatherData::TimelineHeader>> timeline;
-      std::unique_ptr<WeatherData::TimelineHeader> nullTimelineheader = std::make_unique<WeatherData::TimelineHeader>();
-      std::unique_ptr<WeatherData::TimelineHeader>* nullHeader;
-
-      /**
-       * Cleans up the timeline of expired events
-       */
-      void TidyTimeline();
+      static const GattCharacteristic<WeatherService> characteristics[2];
+      GattServiceTable<WeatherService, 2> gattService;
 
-      /**
-       * Compares two timeline events
-       */
-      static bool CompareTimelineEvents(const std::unique_ptr<WeatherData::TimelineHeader>& first,
-                                        const std::unique_ptr<WeatherData::TimelineHeader>& second);
+      uint16_t eventHandle {};
 
-      /**
-       * Returns current UNIX timestamp
-       */
-      uint64_t GetCurrentUnixTimestamp() const;
+      // Long writes are copied here to be decoded
+      std::array<uint8_t, MaxPayloadSize> payloadBuffer;
 
-      /**
-       * Checks if the event hasn't gone past and expired
-       *
-       * @param header timeline event to check
-       * @param currentTimestamp what's the time right now
-       * @return if the event is valid
-       */
-      static bool IsEventStillValid(const std::unique_ptr<WeatherData::TimelineHeader>& uniquePtr, const uint64_t timestamp);
+      Pinetime::System::SystemTask& system;
 
-      /**
-       * This is a helper function that closes a QCBOR map and decoding context cleanly
-       */
-      void CleanUpQcbor(QCBORDecodeContext* decodeContext);
+      WeatherTimeline timeline;
     };
   }
 }
@@ -0,0 +1,358 @@
+/*  Copyright (C) 2021 Avamander
+
+    This file is part of InfiniTime.
+
+    InfiniTime is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    InfiniTime is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "WeatherTimeline.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Pinetime {
+  namespace Controllers {
+    // Holds the mutex of the timeline for the duration of a call. The mutex is created by Init(), before the first
+    // event is written.
+    class WeatherTimeline::Lock {
+    public:
+      explicit Lock(const WeatherTimeline& timeline) : mutex {timeline.mutex} {
+        if (mutex != nullptr) {
+          xSemaphoreTake(mutex, portMAX_DELAY);
+        }
+      }
+
+      ~Lock() {
+        if (mutex != nullptr) {
+          xSemaphoreGive(mutex);
+        }
+      }
+
+      Lock(const Lock&) = delete;
+      Lock& operator=(const Lock&) = delete;
+
+    private:
+      SemaphoreHandle_t mutex;
+    };
+
+    WeatherTimeline::WeatherTimeline(DateTime& dateTimeController) : dateTimeController(dateTimeController) {
+    }
+
+    void WeatherTimeline::Init() {
+      if (mutex == nullptr) {
+        mutex = xSemaphoreCreateMutex();
+      }
+    }
+
+    template <typename T, size_t N>
+    bool WeatherTimeline::GetCurrent(const TimelinePool<T, N>& pool, T& event) const {
+      uint64_t currentTimestamp = GetCurrentUnixTimestamp();
+      auto begin = pool.records.begin();
+      // Last event that has already started
+      auto it = std::upper_bound(begin, begin + pool.count, currentTimestamp, [](uint64_t timestamp, const T& event) {
+        return timestamp < event.timestamp;
+      });
+      while (it != begin) {
+        --it;
+        if (IsEventStillValid(*it, currentTimestamp)) {
+          event = *it;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    bool WeatherTimeline::GetCurrentClouds(WeatherData::Clouds& event) const {
+      Lock lock {*this};
+      return GetCurrent(clouds, event);
+    }
+
+    bool WeatherTimeline::GetCurrentObscuration(WeatherData::Obscuration& event) const {
+      Lock lock {*this};
+      return GetCurrent(obscurations, event);
+    }
+
+    bool WeatherTimeline::GetCurrentPrecipitation(WeatherData::Precipitation& event) const {
+      Lock lock {*this};
+      return GetCurrent(precipitations, event);
+    }
+
+    bool WeatherTimeline::GetCurrentWind(WeatherData::Wind& event) const {
+      Lock lock {*this};
+      return GetCurrent(winds, event);
+    }
+
+    bool WeatherTimeline::GetCurrentTemperature(WeatherData::Temperature& event) const {
+      Lock lock {*this};
+      return GetCurrent(temperatures, event);
+    }
+
+    bool WeatherTimeline::GetCurrentHumidity(WeatherData::Humidity& event) const {
+      Lock lock {*this};
+      return GetCurrent(humidities, event);
+    }
+
+    bool WeatherTimeline::GetCurrentPressure(WeatherData::Pressure& event) const {
+      Lock lock {*this};
+      return GetCurrent(pressures, event);
+    }
+
+    bool WeatherTimeline::GetCurrentLocation(WeatherData::Location& event, String& location) const {
+      Lock lock {*this};
+      if (!GetCurrent(locations, event)) {
+        return false;
+      }
+      std::strncpy(location.data(), event.location, location.size());
+      event.location = location.data();
+      return true;
+    }
+
+    bool WeatherTimeline::GetCurrentQuality(WeatherData::AirQuality& event, String& polluter) const {
+      Lock lock {*this};
+      if (!GetCurrent(airQualities, event)) {
+        return false;
+      }
+      std::strncpy(polluter.data(), event.polluter, polluter.size());
+      event.polluter = polluter.data();
+      return true;
+    }
+
+    size_t WeatherTimeline::GetTimelineLength() const {
+      Lock lock {*this};
+      size_t length = 0;
+      ForEachPool([&length](const auto& pool) {
+        length += pool.count;
+      });
+      return length;
+    }
+
+    template <typename T, size_t N>
+    T* WeatherTimeline::Insert(TimelinePool<T, N>& pool, const T& event) {
+      auto begin = pool.records.begin();
+      auto end = begin + pool.count;
+      auto it = std::lower_bound(begin, end, event.timestamp, [](const T& stored, uint64_t timestamp) {
+        return stored.timestamp < timestamp;
+      });
+
+      if (it != end && it->timestamp == event.timestamp) {
+        // Updated forecast for the same time
+        ReleaseStrings(*it);
+      } else if (pool.count == N) {
+        if (it == begin) {
+          return nullptr;
+        }
+        // Drop the oldest event
+        ReleaseStrings(*begin);
+        std::move(begin + 1, it, begin);
+        --it;
+      } else {
+        std::move_backward(it, end, end + 1);
+        pool.count++;
+      }
+      *it = event;
+      return &*it;
+    }
+
+    template <typename T, size_t N>
+    void WeatherTimeline::Remove(TimelinePool<T, N>& pool, size_t idx) {
+      auto begin = pool.records.begin();
+      ReleaseStrings(pool.records[idx]);
+      std::move(begin + idx + 1, begin + pool.count, begin + idx);
+      pool.count--;
+    }
+
+    bool WeatherTimeline::AddEventToTimeline(const WeatherData::Location& event) {
+      Lock lock {*this};
+      WeatherData::Location* stored = Insert(locations, event);
+      if (stored == nullptr) {
+        return false;
+      }
+      stored->location = StoreString(event.location);
+      if (stored->location == nullptr) {
+        Remove(locations, stored - locations.records.data());
+        return false;
+      }
+      return true;
+    }
+
+    bool WeatherTimeline::AddEventToTimeline(const WeatherData::AirQuality& event) {
+      Lock lock {*this};
+      WeatherData::AirQuality* stored = Insert(airQualities, event);
+      if (stored == nullptr) {
+        return false;
+      }
+      stored->polluter = StoreString(event.polluter);
+      if (stored->polluter == nullptr) {
+        Remove(airQualities, stored - airQualities.records.data());
+        return false;
+      }
+      return true;
+    }
+
+    bool WeatherTimeline::AddEventToTimeline(const WeatherData::Clouds& event) {
+      Lock lock {*this};
+      return Insert(clouds, event) != nullptr;
+    }
+
+    bool WeatherTimeline::AddEventToTimeline(const WeatherData::Obscuration& event) {
+      Lock lock {*this};
+      return Insert(obscurations, event) != nullptr;
+    }
+
+    bool WeatherTimeline::AddEventToTimeline(const WeatherData::Precipitation& event) {
+      Lock lock {*this};
+      return Insert(precipitations, event) != nullptr;
+    }
+
+    bool WeatherTimeline::AddEventToTimeline(const WeatherData::Wind& event) {
+      Lock lock {*this};
+      return Insert(winds, event) != nullptr;
+    }
+
+    bool WeatherTimeline::AddEventToTimeline(const WeatherData::Temperature& event) {
+      Lock lock {*this};
+      temperaturesGeneration++;
+      return Insert(temperatures, event) != nullptr;
+    }
+
+    bool WeatherTimeline::AddEventToTimeline(const WeatherData::Humidity& event) {
+      Lock lock {*this};
+      return Insert(humidities, event) != nullptr;
+    }
+
+    bool WeatherTimeline::AddEventToTimeline(const WeatherData::Pressure& event) {
+      Lock lock {*this};
+      return Insert(pressures, event) != nullptr;
+    }
+
+    bool WeatherTimeline::AddEventToTimeline(const WeatherData::Special& event) {
+      Lock lock {*this};
+      return Insert(specials, event) != nullptr;
+    }
+
+    const char* WeatherTimeline::StoreString(const char* str) {
+      size_t size = strnlen(str, MaxStringLength) + 1;
+      if (stringArenaUsed + size > stringArena.size()) {
+        return nullptr;
+      }
+      char* stored = stringArena.data() + stringArenaUsed;
+      std::memcpy(stored, str, size - 1);
+      stored[size - 1] = '\0';
+      stringArenaUsed += size;
+      return stored;
+    }
+
+    void WeatherTimeline::ReleaseString(const char* str) {
+      auto arenaBegin = reinterpret_cast<uintptr_t>(stringArena.data());
+      auto address = reinterpret_cast<uintptr_t>(str);
+      if (str == nullptr || address < arenaBegin || address >= arenaBegin + stringArenaUsed) {
+        return;
+      }
+      size_t offset = address - arenaBegin;
+      size_t size = std::strlen(str) + 1;
+      std::memmove(stringArena.data() + offset, stringArena.data() + offset + size, stringArenaUsed - (offset + size));
+      stringArenaUsed -= size;
+
+      // Strings stored after the removed one moved down
+      auto relocate = [&](const char*& stored) {
+        auto storedAddress = reinterpret_cast<uintptr_t>(stored);
+        if (stored != nullptr && storedAddress > address && storedAddress < arenaBegin + stringArenaUsed + size) {
+          stored -= size;
+        }
+      };
+      for (size_t i = 0; i < locations.count; i++) {
+        relocate(locations.records[i].location);
+      }
+      for (size_t i = 0; i < airQualities.count; i++) {
+        relocate(airQualities.records[i].polluter);
+      }
+    }
+
+    bool WeatherTimeline::HasTimelineEventOfType(const WeatherData::eventtype type) const {
+      Lock lock {*this};
+      uint64_t currentTimestamp = GetCurrentUnixTimestamp();
+      bool found = false;
+      ForEachPool([&](const auto& pool) {
+        for (size_t i = 0; i < pool.count && !found; i++) {
+          found = pool.records[i].eventType == type && IsEventStillValid(pool.records[i], currentTimestamp);
+        }
+      });
+      return found;
+    }
+
+    void WeatherTimeline::TidyTimeline() {
+      Lock lock {*this};
+      uint64_t timeCurrent = GetCurrentUnixTimestamp();
+      ForEachPool([&](auto& pool) {
+        for (size_t i = pool.count; i > 0; i--) {
+          if (!IsEventStillValid(pool.records[i - 1], timeCurrent)) {
+            Remove(pool, i - 1);
+          }
+        }
+      });
+      temperaturesGeneration++;
+    }
+
+    bool WeatherTimeline::IsEventStillValid(const WeatherData::TimelineHeader& header, const uint64_t timestamp) {
+      // Not getting timestamp in isEventStillValid for more speed
+      return header.timestamp + header.expires >= timestamp;
+    }
+
+    uint64_t WeatherTimeline::GetCurrentUnixTimestamp() const {
+      return std::chrono::duration_cast<std::chrono::seconds>(dateTimeController.CurrentDateTime().time_since_epoch()).count();
+    }
+
+    void WeatherTimeline::UpdateTodayTemperatures() const {
+      uint64_t currentTimestamp = GetCurrentUnixTimestamp();
+      if (todayTemperatures.generation == temperaturesGeneration && currentTimestamp >= todayTemperatures.validFrom &&
+          currentTimestamp < todayTemperatures.validUntil) {
+        return;
+      }
+
+      uint64_t secondsToday = dateTimeController.Hours() * 60 * 60 + dateTimeController.Minutes() * 60 + dateTimeController.Seconds();
+      uint64_t currentDayEnd = currentTimestamp - secondsToday + 24 * 60 * 60;
+
+      todayTemperatures.generation = temperaturesGeneration;
+      todayTemperatures.validFrom = currentTimestamp;
+      todayTemperatures.validUntil = currentDayEnd;
+      todayTemperatures.lowest = -32768;
+      todayTemperatures.highest = -32768;
+      // Events are sorted, today's are at the beginning of the pool
+      for (size_t i = 0; i < temperatures.count && temperatures.records[i].timestamp < currentDayEnd; i++) {
+        const WeatherData::Temperature& event = temperatures.records[i];
+        if (!IsEventStillValid(event, currentTimestamp) || event.temperature == -32768) {
+          continue;
+        }
+        if (todayTemperatures.lowest == -32768 || event.temperature < todayTemperatures.lowest) {
+          todayTemperatures.lowest = event.temperature;
+        }
+        if (todayTemperatures.highest == -32768 || event.temperature > todayTemperatures.highest) {
+          todayTemperatures.highest = event.temperature;
+        }
+        // The result changes once this event expires
+        todayTemperatures.validUntil = std::min(todayTemperatures.validUntil, event.timestamp + event.expires + 1);
+      }
+    }
+
+    int16_t WeatherTimeline::GetTodayMinTemp() const {
+      Lock lock {*this};
+      UpdateTodayTemperatures();
+      return todayTemperatures.lowest;
+    }
+
+    int16_t WeatherTimeline::GetTodayMaxTemp() const {
+      Lock lock {*this};
+      UpdateTodayTemperatures();
+      return todayTemperatures.highest;
+    }
+  }
+}
@@ -0,0 +1,225 @@
+/*  Copyright (C) 2021 Avamander
+
+    This file is part of InfiniTime.
+
+    InfiniTime is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    InfiniTime is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
+
+#include "WeatherData.h"
+#include "components/datetime/DateTimeController.h"
+
+namespace Pinetime {
+  namespace Controllers {
+
+    /**
+     * Events of the weather timeline, in one fixed-capacity pool per event type
+     *
+     * The BLE host task adds the events, the display task reads them: every call holds a mutex, and the events are
+     * handed out as copies, with their strings copied into a buffer of the caller. Nothing in the timeline can move
+     * under the reader.
+     */
+    class WeatherTimeline {
+    public:
+      /// Longest string (location, polluter) stored, longer ones are truncated
+      static constexpr size_t MaxStringLength = 47;
+      /// Size of the arena in which the strings of all events are stored
+      static constexpr size_t StringArenaSize = 128;
+
+      /// Buffer in which the string of an event is copied
+      using String = std::array<char, MaxStringLength + 1>;
+
+      explicit WeatherTimeline(DateTime& dateTimeController);
+
+      void Init();
+
+      /*
+       * Copies the most recent event of the type that has started and not yet expired
+       *
+       * The string of the event (location, polluter) is copied into the string buffer, and points to it.
+       * @return false if there is no such event
+       */
+      bool GetCurrentLocation(WeatherData::Location& event, String& location) const;
+      bool GetCurrentClouds(WeatherData::Clouds& event) const;
+      bool GetCurrentObscuration(WeatherData::Obscuration& event) const;
+      bool GetCurrentPrecipitation(WeatherData::Precipitation& event) const;
+      bool GetCurrentWind(WeatherData::Wind& event) const;
+      bool GetCurrentTemperature(WeatherData::Temperature& event) const;
+      bool GetCurrentHumidity(WeatherData::Humidity& event) const;
+      bool GetCurrentPressure(WeatherData::Pressure& event) const;
+      bool GetCurrentQuality(WeatherData::AirQuality& event, String& polluter) const;
+
+      /**
+       * Searches for the current day's maximum temperature
+       * @return -32768 if there's no data, degrees Celsius times 100 otherwise
+       */
+      int16_t GetTodayMaxTemp() const;
+      /**
+       * Searches for the current day's minimum temperature
+       * @return -32768 if there's no data, degrees Celsius times 100 otherwise
+       */
+      int16_t GetTodayMinTemp() const;
+
+      /**
+       * Adds an event to the timeline
+       *
+       * An event with the same timestamp as a stored one of the same type replaces it.
+       * When the pool of the type is full, the oldest event is dropped.
+       * Strings are copied into the string arena.
+       * @return false if the event could not be stored
+       */
+      bool AddEventToTimeline(const WeatherData::Location& event);
+      bool AddEventToTimeline(const WeatherData::Clouds& event);
+      bool AddEventToTimeline(const WeatherData::Obscuration& event);
+      bool AddEventToTimeline(const WeatherData::Precipitation& event);
+      bool AddEventToTimeline(const WeatherData::Wind& event);
+      bool AddEventToTimeline(const WeatherData::Temperature& event);
+      bool AddEventToTimeline(const WeatherData::Humidity& event);
+      bool AddEventToTimeline(const WeatherData::Pressure& event);
+      bool AddEventToTimeline(const WeatherData::AirQuality& event);
+      bool AddEventToTimeline(const WeatherData::Special& event);
+      /**
+       * Gets the current timeline length
+       */
+      size_t GetTimelineLength() const;
+      /**
+       * Checks if an event of a certain type exists in the timeline
+       */
+      bool HasTimelineEventOfType(WeatherData::eventtype type) const;
+      /**
+       * Cleans up the timeline of expired events
+       */
+      void TidyTimeline();
+
+    private:
+      Pinetime::Controllers::DateTime& dateTimeController;
+
+      SemaphoreHandle_t mutex = nullptr;
+      class Lock;
+
+      /**
+       * Fixed-capacity storage for the events of one type, sorted by ascending timestamp
+       */
+      template <typename T, size_t N>
+      struct TimelinePool {
+        std::array<T, N> records;
+        size_t count = 0;
+      };
+
+      TimelinePool<WeatherData::Obscuration, 4> obscurations;
+      TimelinePool<WeatherData::Precipitation, 12> precipitations;
+      TimelinePool<WeatherData::Wind, 8> winds;
+      TimelinePool<WeatherData::Temperature, 24> temperatures;
+      TimelinePool<WeatherData::AirQuality, 4> airQualities;
+      TimelinePool<WeatherData::Special, 4> specials;
+      TimelinePool<WeatherData::Pressure, 4> pressures;
+      TimelinePool<WeatherData::Location, 2> locations;
+      TimelinePool<WeatherData::Clouds, 12> clouds;
+      TimelinePool<WeatherData::Humidity, 8> humidities;
+
+      // Strings are stored back to back, in no particular order. Removing one compacts the arena.
+      std::array<char, StringArenaSize> stringArena;
+      size_t stringArenaUsed = 0;
+
+      // Today's min/max temperatures, cached until the temperatures change, one of them expires or the day ends
+      struct TemperatureRange {
+        uint64_t validFrom = 0;
+        uint64_t validUntil = 0;
+        uint32_t generation = 0;
+        int16_t lowest = -32768;
+        int16_t highest = -32768;
+      };
+      mutable TemperatureRange todayTemperatures;
+      uint32_t temperaturesGeneration = 1;
+      void UpdateTodayTemperatures() const;
+
+      template <typename F>
+      void ForEachPool(F&& f) {
+        f(obscurations);
+        f(precipitations);
+        f(winds);
+        f(temperatures);
+        f(airQualities);
+        f(specials);
+        f(pressures);
+        f(locations);
+        f(clouds);
+        f(humidities);
+      }
+
+      template <typename F>
+      void ForEachPool(F&& f) const {
+        f(obscurations);
+        f(precipitations);
+        f(winds);
+        f(temperatures);
+        f(airQualities);
+        f(specials);
+        f(pressures);
+        f(locations);
+        f(clouds);
+        f(humidities);
+      }
+
+      // The private functions below expect the caller to hold the mutex
+
+      template <typename T, size_t N>
+      bool GetCurrent(const TimelinePool<T, N>& pool, T& event) const;
+      /**
+       * Inserts the event in the pool, keeping it sorted
+       * @return the slot the event was copied into, nullptr if it's older than all the events of a full pool
+       */
+      template <typename T, size_t N>
+      T* Insert(TimelinePool<T, N>& pool, const T& event);
+      template <typename T, size_t N>
+      void Remove(TimelinePool<T, N>& pool, size_t idx);
+
+      /**
+       * Copies the null-terminated string into the string arena
+       * @return the stored string, nullptr if the arena is full
+       */
+      const char* StoreString(const char* str);
+      void ReleaseString(const char* str);
+      template <typename T>
+      void ReleaseStrings(const T& /*event*/) {
+      }
+      void ReleaseStrings(const WeatherData::Location& event) {
+        ReleaseString(event.location);
+      }
+      void ReleaseStrings(const WeatherData::AirQuality& event) {
+        ReleaseString(event.polluter);
+      }
+
+      /**
+       * Returns current UNIX timestamp
+       */
+      uint64_t GetCurrentUnixTimestamp() const;
+
+      /**
+       * Checks if the event hasn't gone past and expired
+       *
+       * @param header timeline event to check
+       * @param currentTimestamp what's the time right now
+       * @return if the event is valid
+       */
+      static bool IsEventStillValid(const WeatherData::TimelineHeader& header, const uint64_t timestamp);
+    };
+  }
+}
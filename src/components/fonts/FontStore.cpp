@@ -0,0 +1,432 @@
+#include "components/fonts/FontStore.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace Pinetime::Controllers;
+
+// Defined here instead of in the C files generated from fonts.json, with the names the screens use
+lv_font_t jetbrains_mono_42;
+lv_font_t jetbrains_mono_76;
+lv_font_t jetbrains_mono_extrabold_compressed;
+lv_font_t lv_font_navi_80;
+lv_font_t open_sans_light;
+
+namespace {
+  struct ExternalFont {
+    const char* name;
+    lv_font_t* font;
+  };
+
+  constexpr ExternalFont externalFonts[] = {
+    {"jetbrains_mono_42", &jetbrains_mono_42},
+    {"jetbrains_mono_76", &jetbrains_mono_76},
+    {"jetbrains_mono_extrabold_compressed", &jetbrains_mono_extrabold_compressed},
+    {"lv_font_navi_80", &lv_font_navi_80},
+    {"open_sans_light", &open_sans_light},
+  };
+
+  const lv_font_t* const fallbackFont = &jetbrains_mono_bold_20;
+}
+
+static_assert(sizeof(externalFonts) / sizeof(externalFonts[0]) == FontStore::NbFonts, "Fonts stored in the external flash");
+static_assert(FontStore::MaxGlyphs < UINT8_MAX && FontStore::CacheSize <= UINT16_MAX, "Size of the cache");
+
+FontStore::FontStore(FS& fs) : fs {fs} {
+  for (size_t i = 0; i < NbFonts; i++) {
+    fonts[i].store = this;
+    fonts[i].font = externalFonts[i].font;
+    fonts[i].name = externalFonts[i].name;
+  }
+}
+
+void FontStore::Init() {
+  for (auto& font : fonts) {
+    font.font->get_glyph_dsc = GetGlyphDsc;
+    font.font->get_glyph_bitmap = GetGlyphBitmap;
+    font.font->subpx = LV_FONT_SUBPX_NONE;
+    font.font->dsc = &font;
+  }
+  // Reads the metrics of the fonts
+  if (OpenPack()) {
+    ClosePack();
+  } else {
+    UseFallbackFonts();
+  }
+}
+
+/*
+
+    ----------- LVGL font -----------
+
+*/
+
+bool FontStore::GetGlyphDsc(const lv_font_t* font, lv_font_glyph_dsc_t* dsc, uint32_t letter, uint32_t nextLetter) {
+  auto* externalFont = static_cast<Font*>(font->dsc);
+  const GlyphHeader* glyph = externalFont->available ? externalFont->store->GetGlyph(*externalFont, letter) : nullptr;
+  // Also replaced if the pack was removed while the glyph was read
+  if (!externalFont->available) {
+    return fallbackFont->get_glyph_dsc(fallbackFont, dsc, letter, nextLetter);
+  }
+  if (glyph == nullptr) {
+    return false;
+  }
+  // No kerning in the pack
+  dsc->adv_w = (glyph->advanceWidth + 8) >> 4;
+  dsc->box_w = glyph->boxWidth;
+  dsc->box_h = glyph->boxHeight;
+  dsc->ofs_x = glyph->offsetX;
+  dsc->ofs_y = glyph->offsetY;
+  dsc->bpp = externalFont->bitsPerPixel;
+  return true;
+}
+
+const uint8_t* FontStore::GetGlyphBitmap(const lv_font_t* font, uint32_t letter) {
+  auto* externalFont = static_cast<Font*>(font->dsc);
+  // LVGL gets the descriptor of the glyph just before: it is in the cache
+  const GlyphHeader* glyph = externalFont->available ? externalFont->store->GetGlyph(*externalFont, letter) : nullptr;
+  if (!externalFont->available) {
+    return fallbackFont->get_glyph_bitmap(fallbackFont, letter);
+  }
+  if (glyph == nullptr) {
+    return nullptr;
+  }
+  return reinterpret_cast<const uint8_t*>(glyph) + sizeof(GlyphHeader);
+}
+
+void FontStore::Prefetch(lv_obj_t* label) {
+  Prefetch(lv_obj_get_style_text_font(label, LV_LABEL_PART_MAIN), lv_label_get_text(label));
+}
+
+void FontStore::Prefetch(const lv_font_t* font, const char* text) {
+  if (font == nullptr || font->get_glyph_dsc != GetGlyphDsc || text == nullptr) {
+    return;
+  }
+  auto* externalFont = static_cast<Font*>(font->dsc);
+  if (!externalFont->available) {
+    return;
+  }
+
+  FontStore& store = *externalFont->store;
+  const auto fontIndex = static_cast<uint8_t>(externalFont - store.fonts.data());
+  // The glyphs of the label that are already in the cache are not evicted to load the other ones
+  const uint32_t stamp = ++store.useCounter;
+  uint32_t codePoints[MaxPrefetch];
+  size_t nbCodePoints = 0;
+  uint32_t i = 0;
+  while (text[i] != '\0' && nbCodePoints < MaxPrefetch) {
+    const uint32_t codePoint = _lv_txt_encoded_next(text, &i);
+    Glyph* glyph = store.FindGlyph(fontIndex, codePoint);
+    if (glyph != nullptr) {
+      glyph->lastUse = stamp;
+    } else if (codePoint != '\n' && codePoint != '\r' &&
+               std::find(codePoints, codePoints + nbCodePoints, codePoint) == codePoints + nbCodePoints) {
+      codePoints[nbCodePoints++] = codePoint;
+    }
+  }
+
+  if (nbCodePoints > 0) {
+    store.LoadGlyphs(*externalFont, codePoints, nbCodePoints, stamp);
+  }
+}
+
+/*
+
+    ----------- Pack -----------
+
+*/
+
+bool FontStore::OpenPack() {
+  if (fs.FileOpen(&file, Path, LFS_O_RDONLY) != LFS_ERR_OK) {
+    return false;
+  }
+
+  // The CRC is not checked, it only tells if the pack was replaced since its fonts were loaded
+  Header header;
+  if (!Read(0, &header, sizeof(header)) || header.magic != Magic || header.version != Version ||
+      ((!fontsLoaded || header.crc != packCrc) && !LoadFonts(header))) {
+    fs.FileClose(&file);
+    return false;
+  }
+  return true;
+}
+
+void FontStore::ClosePack() {
+  fs.FileClose(&file);
+}
+
+bool FontStore::LoadFonts(const Header& header) {
+  ClearCache();
+  for (auto& font : fonts) {
+    font.available = false;
+  }
+
+  for (uint16_t i = 0; i < header.nbFonts; i++) {
+    FontEntry entry;
+    if (!Read(sizeof(Header) + i * sizeof(FontEntry), &entry, sizeof(entry))) {
+      UseFallbackFonts();
+      return false;
+    }
+    for (auto& font : fonts) {
+      if (std::strncmp(entry.name, font.name, NameSize) != 0 || entry.bitsPerPixel == 0 || entry.bitsPerPixel > 4) {
+        continue;
+      }
+      font.available = true;
+      font.bitsPerPixel = entry.bitsPerPixel;
+      font.indexOffset = entry.indexOffset;
+      font.nbGlyphs = entry.nbGlyphs;
+      font.font->line_height = entry.lineHeight;
+      font.font->base_line = entry.baseLine;
+      font.font->underline_position = entry.underlinePosition;
+      font.font->underline_thickness = entry.underlineThickness;
+    }
+  }
+
+  UseFallbackFonts();
+  packCrc = header.crc;
+  fontsLoaded = true;
+  return true;
+}
+
+void FontStore::UseFallbackFonts() {
+  for (auto& font : fonts) {
+    if (!font.available) {
+      font.font->line_height = fallbackFont->line_height;
+      font.font->base_line = fallbackFont->base_line;
+      font.font->underline_position = fallbackFont->underline_position;
+      font.font->underline_thickness = fallbackFont->underline_thickness;
+    }
+  }
+}
+
+bool FontStore::Read(uint32_t address, void* buffer, size_t size) {
+  if (fs.FileSeek(&file, address) < 0) {
+    return false;
+  }
+  return fs.FileRead(&file, static_cast<uint8_t*>(buffer), size) == static_cast<int>(size);
+}
+
+/*
+
+    ----------- Cache of glyphs -----------
+
+*/
+
+const FontStore::GlyphHeader* FontStore::GetGlyph(Font& font, uint32_t codePoint) {
+  const auto fontIndex = static_cast<uint8_t>(&font - fonts.data());
+  Glyph* glyph = FindGlyph(fontIndex, codePoint);
+  if (glyph != nullptr) {
+    nbHits++;
+  } else {
+    nbMisses++;
+    LoadGlyphs(font, &codePoint, 1, ++useCounter);
+    glyph = FindGlyph(fontIndex, codePoint);
+  }
+
+  if (glyph == nullptr || glyph->size == 0) {
+    return nullptr;
+  }
+  glyph->lastUse = ++useCounter;
+  return reinterpret_cast<const GlyphHeader*>(cache + glyph->offset);
+}
+
+FontStore::Glyph* FontStore::FindGlyph(uint8_t font, uint32_t codePoint) {
+  for (auto& glyph : glyphs) {
+    if (glyph.font == font && glyph.codePoint == codePoint) {
+      return &glyph;
+    }
+  }
+  return nullptr;
+}
+
+void FontStore::LoadGlyphs(Font& font, const uint32_t* codePoints, size_t nbCodePoints, uint32_t stamp) {
+  if (!OpenPack()) {
+    // The pack was removed: the fonts are replaced until the next start
+    for (auto& f : fonts) {
+      f.available = false;
+    }
+    UseFallbackFonts();
+    ClearCache();
+    fontsLoaded = false;
+    return;
+  }
+  // Opening the pack reloads the fonts if it was replaced
+  if (!font.available) {
+    ClosePack();
+    return;
+  }
+
+  Request requests[MaxPrefetch];
+  if (nbCodePoints > MaxPrefetch) {
+    nbCodePoints = MaxPrefetch;
+  }
+  for (size_t i = 0; i < nbCodePoints; i++) {
+    requests[i] = {codePoints[i], 0, 0};
+  }
+  if (!FindInIndex(font, requests, nbCodePoints)) {
+    ClosePack();
+    return;
+  }
+
+  // The glyphs of a run are next to each other in the pack: they are read at once. The glyphs used since the stamp,
+  // like the ones loaded by the previous runs, are not evicted.
+  std::sort(requests, requests + nbCodePoints, [](const Request& a, const Request& b) {
+    return a.offset < b.offset;
+  });
+  const auto fontIndex = static_cast<uint8_t>(&font - fonts.data());
+  size_t first = 0;
+  while (first < nbCodePoints) {
+    size_t last = first + 1;
+    uint32_t runSize = requests[first].size;
+    while (last < nbCodePoints && requests[first].size > 0 && requests[last].offset == requests[first].offset + runSize &&
+           runSize + requests[last].size <= CacheSize) {
+      runSize += requests[last++].size;
+    }
+    if (!LoadRun(fontIndex, requests + first, last - first, stamp)) {
+      break;
+    }
+    first = last;
+  }
+  ClosePack();
+}
+
+bool FontStore::FindInIndex(const Font& font, Request* requests, size_t nbRequests) {
+  // The index is read by chunks. The size of a glyph is the distance to the next one, except for the last glyph of
+  // the font: its header is read.
+  IndexEntry chunk[16];
+  Request* previous = nullptr;
+  size_t nbFound = 0;
+  for (uint32_t start = 0; start < font.nbGlyphs && (nbFound < nbRequests || previous != nullptr); start += 16) {
+    const uint32_t chunkSize = std::min<uint32_t>(font.nbGlyphs - start, 16);
+    if (!Read(font.indexOffset + start * sizeof(IndexEntry), chunk, chunkSize * sizeof(IndexEntry))) {
+      return false;
+    }
+    for (uint32_t i = 0; i < chunkSize; i++) {
+      if (previous != nullptr) {
+        previous->size = chunk[i].offset - previous->offset;
+        previous = nullptr;
+      }
+      for (size_t j = 0; j < nbRequests; j++) {
+        if (requests[j].codePoint == chunk[i].codePoint) {
+          requests[j].offset = chunk[i].offset;
+          previous = &requests[j];
+          nbFound++;
+          break;
+        }
+      }
+    }
+  }
+
+  if (previous != nullptr) {
+    GlyphHeader header;
+    if (!Read(previous->offset, &header, sizeof(header))) {
+      return false;
+    }
+    previous->size = sizeof(GlyphHeader) + header.bitmapSize;
+  }
+  // Glyphs that are not in the font keep a size of 0
+  return true;
+}
+
+bool FontStore::LoadRun(uint8_t font, const Request* requests, size_t nbRequests, uint32_t stamp) {
+  Glyph* runGlyphs[MaxPrefetch];
+  for (size_t i = 0; i < nbRequests; i++) {
+    runGlyphs[i] = NewGlyph(stamp);
+    if (runGlyphs[i] == nullptr) {
+      return false;
+    }
+    // Not in the font until it is read
+    *runGlyphs[i] = {requests[i].codePoint, stamp, 0, 0, font};
+  }
+
+  const uint32_t runSize = requests[nbRequests - 1].offset + requests[nbRequests - 1].size - requests[0].offset;
+  if (requests[0].size == 0) {
+    return true;
+  }
+
+  uint16_t offset;
+  if (runSize > CacheSize || !Reserve(runSize, stamp, offset) || !Read(requests[0].offset, cache + offset, runSize)) {
+    for (size_t i = 0; i < nbRequests; i++) {
+      runGlyphs[i]->font = InvalidFont;
+    }
+    // Releases the reserved space
+    Compact();
+    return false;
+  }
+
+  for (size_t i = 0; i < nbRequests; i++) {
+    runGlyphs[i]->offset = offset + (requests[i].offset - requests[0].offset);
+    runGlyphs[i]->size = requests[i].size;
+  }
+  return true;
+}
+
+FontStore::Glyph* FontStore::NewGlyph(uint32_t stamp) {
+  for (auto& glyph : glyphs) {
+    if (glyph.font == InvalidFont) {
+      return &glyph;
+    }
+  }
+  Glyph* glyph = LeastRecentlyUsed(stamp, false);
+  if (glyph != nullptr) {
+    glyph->font = InvalidFont;
+    Compact();
+  }
+  return glyph;
+}
+
+bool FontStore::Reserve(size_t size, uint32_t stamp, uint16_t& offset) {
+  while (CacheSize - cacheUsed < size) {
+    Glyph* glyph = LeastRecentlyUsed(stamp, true);
+    if (glyph == nullptr) {
+      return false;
+    }
+    glyph->font = InvalidFont;
+    Compact();
+  }
+  offset = static_cast<uint16_t>(cacheUsed);
+  cacheUsed += size;
+  return true;
+}
+
+FontStore::Glyph* FontStore::LeastRecentlyUsed(uint32_t stamp, bool withData) {
+  // The glyphs used since the stamp are kept
+  Glyph* leastRecentlyUsed = nullptr;
+  for (auto& glyph : glyphs) {
+    if (glyph.font == InvalidFont || glyph.lastUse >= stamp || (withData && glyph.size == 0)) {
+      continue;
+    }
+    if (leastRecentlyUsed == nullptr || glyph.lastUse < leastRecentlyUsed->lastUse) {
+      leastRecentlyUsed = &glyph;
+    }
+  }
+  return leastRecentlyUsed;
+}
+
+void FontStore::Compact() {
+  // Moves the glyphs to the start of the cache, in the order of their offsets
+  size_t used = 0;
+  while (true) {
+    Glyph* next = nullptr;
+    for (auto& glyph : glyphs) {
+      if (glyph.font != InvalidFont && glyph.size > 0 && glyph.offset >= used && (next == nullptr || glyph.offset < next->offset)) {
+        next = &glyph;
+      }
+    }
+    if (next == nullptr) {
+      break;
+    }
+    if (next->offset != used) {
+      std::memmove(cache + used, cache + next->offset, next->size);
+      next->offset = static_cast<uint16_t>(used);
+    }
+    used += next->size;
+  }
+  cacheUsed = used;
+}
+
+void FontStore::ClearCache() {
+  for (auto& glyph : glyphs) {
+    glyph.font = InvalidFont;
+  }
+  cacheUsed = 0;
+}
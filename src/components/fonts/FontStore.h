@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <lvgl/lvgl.h>
+#include "components/fs/FS.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Fonts stored in the external flash instead of the internal one.
+     *
+     * The fonts marked "external" in displayapp/fonts/fonts.json are not compiled into the firmware: they are packed
+     * into the file Path of the file system at build time. The lv_font_t of these fonts are defined here, with the
+     * same names, so the screens use them as before. Their glyphs are read from the pack when LVGL needs them, and kept
+     * in a fixed-size RAM cache of the recently used glyphs. Prefetch() reads all the missing glyphs of a label at once.
+     *
+     * If the pack or a font is missing, the font is replaced by jetbrains_mono_bold_20. See doc/ExternalFonts.md.
+     */
+    class FontStore {
+    public:
+      static constexpr const char* Path = "/fonts.bin";
+      static constexpr size_t NbFonts = 5;
+      static constexpr size_t NameSize = 40;
+      // Holds the 4 digits of the largest font (open_sans_light)
+      static constexpr size_t CacheSize = 4096;
+      static constexpr size_t MaxGlyphs = 32;
+      static constexpr size_t MaxPrefetch = 16;
+
+      explicit FontStore(FS& fs);
+      FontStore(const FontStore&) = delete;
+      FontStore& operator=(const FontStore&) = delete;
+
+      /// Reads the metrics of the fonts: call it before the screens use them
+      void Init();
+
+      /// Reads the glyphs of the text of the label that are not in the cache, if its font is external
+      static void Prefetch(lv_obj_t* label);
+      static void Prefetch(const lv_font_t* font, const char* text);
+
+      uint32_t NbHits() const {
+        return nbHits;
+      }
+      uint32_t NbMisses() const {
+        return nbMisses;
+      }
+
+    private:
+      struct __attribute__((packed)) Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t nbFonts;
+        // CRC32 of the file after the header
+        uint32_t crc;
+        uint32_t reserved;
+      };
+
+      struct __attribute__((packed)) FontEntry {
+        char name[NameSize];
+        int16_t lineHeight;
+        int16_t baseLine;
+        int8_t underlinePosition;
+        uint8_t underlineThickness;
+        uint8_t bitsPerPixel;
+        uint8_t reserved;
+        // Code point and offset of each glyph, sorted by code point
+        uint32_t indexOffset;
+        uint32_t nbGlyphs;
+      };
+      static_assert(sizeof(FontEntry) == 56, "Format of the fonts of the pack");
+
+      struct __attribute__((packed)) IndexEntry {
+        uint32_t codePoint;
+        uint32_t offset;
+      };
+
+      // Followed by the bitmap, in the pack and in the cache
+      struct __attribute__((packed)) GlyphHeader {
+        // 1/16 pixel
+        uint16_t advanceWidth;
+        uint16_t boxWidth;
+        uint16_t boxHeight;
+        int16_t offsetX;
+        int16_t offsetY;
+        uint16_t bitmapSize;
+      };
+
+      struct Font {
+        FontStore* store;
+        lv_font_t* font;
+        const char* name;
+        bool available = false;
+        uint8_t bitsPerPixel;
+        uint32_t indexOffset;
+        uint32_t nbGlyphs;
+      };
+
+      struct Glyph {
+        uint32_t codePoint;
+        uint32_t lastUse;
+        // Of the header of the glyph in the cache
+        uint16_t offset;
+        // 0 if the glyph is not in the font
+        uint16_t size;
+        uint8_t font = InvalidFont;
+      };
+
+      // A glyph to read from the pack
+      struct Request {
+        uint32_t codePoint;
+        uint32_t offset;
+        uint32_t size;
+      };
+
+      static constexpr uint32_t Magic = 0x4e465450; // "PTFN"
+      static constexpr uint16_t Version = 1;
+      static constexpr uint8_t InvalidFont = UINT8_MAX;
+
+      static bool GetGlyphDsc(const lv_font_t* font, lv_font_glyph_dsc_t* dsc, uint32_t letter, uint32_t nextLetter);
+      static const uint8_t* GetGlyphBitmap(const lv_font_t* font, uint32_t letter);
+
+      bool OpenPack();
+      void ClosePack();
+      bool LoadFonts(const Header& header);
+      void UseFallbackFonts();
+      bool Read(uint32_t address, void* buffer, size_t size);
+
+      const GlyphHeader* GetGlyph(Font& font, uint32_t codePoint);
+      Glyph* FindGlyph(uint8_t font, uint32_t codePoint);
+      void LoadGlyphs(Font& font, const uint32_t* codePoints, size_t nbCodePoints, uint32_t stamp);
+      bool FindInIndex(const Font& font, Request* requests, size_t nbRequests);
+      bool LoadRun(uint8_t font, const Request* requests, size_t nbRequests, uint32_t stamp);
+      Glyph* NewGlyph(uint32_t stamp);
+      bool Reserve(size_t size, uint32_t stamp, uint16_t& offset);
+      Glyph* LeastRecentlyUsed(uint32_t stamp, bool withData);
+      void Compact();
+      void ClearCache();
+
+      FS& fs;
+      lfs_file_t file;
+      bool fontsLoaded = false;
+      uint32_t packCrc = 0;
+      std::array<Font, NbFonts> fonts;
+
+      std::array<Glyph, MaxGlyphs> glyphs;
+      uint8_t cache[CacheSize];
+      size_t cacheUsed = 0;
+      uint32_t useCounter = 0;
+      uint32_t nbHits = 0;
+      uint32_t nbMisses = 0;
+    };
+  }
+}
@@ -1,11 +1,18 @@
 #pragma once
 
 #include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
 #include "drivers/SpiNorFlash.h"
 #include <littlefs/lfs.h>
 
 namespace Pinetime {
   namespace Controllers {
+    /**
+     * LittleFS on the external flash. The file system is used by several tasks (the display task reads the font and
+     * image packs while FSService writes files from the BLE host task): every call holds a mutex, as lfs_t is not
+     * thread safe.
+     */
     class FS {
     public:
       FS(Pinetime::Drivers::SpiNorFlash&);
@@ -72,6 +79,9 @@ namespace Pinetime {
       const struct lfs_config lfsConfig;
 
       lfs_t lfs;
+      SemaphoreHandle_t mutex = nullptr;
+
+      class Lock;
 
       static int SectorSync(const struct lfs_config* c);
       static int SectorErase(const struct lfs_config* c, lfs_block_t block);
@@ -26,6 +26,17 @@ void HeartRateController::Stop() {
   }
 }
 
+bool HeartRateController::IsRawStreamEnabled() const {
+  return service != nullptr && service->IsRawStreamEnabled();
+}
+
+void HeartRateController::PushRawSample(const RawSample& sample) {
+  if (!rawSamples.Push(sample)) {
+    droppedRawSamples++;
+  }
+  service->OnNewRawSamples();
+}
+
 void HeartRateController::SetHeartRateTask(Pinetime::Applications::HeartRateTask* task) {
   this->task = task;
 }
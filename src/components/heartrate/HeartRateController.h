@@ -1,7 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <components/ble/HeartRateService.h>
+#include "utility/SpscRingBuffer.h"
 
 namespace Pinetime {
   namespace Applications {
@@ -15,6 +17,14 @@ namespace Pinetime {
     public:
       enum class States { Stopped, NotEnoughData, NoTouch, Running };
 
+      struct RawSample {
+        uint32_t timestamp;
+        uint32_t hrs;
+        uint32_t als;
+        float agcPeak;
+      };
+      using RawSampleBuffer = Utility::SpscRingBuffer<RawSample, 32>;
+
       HeartRateController() = default;
       void Start();
       void Stop();
@@ -30,11 +40,25 @@ namespace Pinetime {
 
       void SetService(Pinetime::Controllers::HeartRateService* service);
 
+      bool IsRawStreamEnabled() const;
+      /// Called by the heart rate task for each raw sample. Never blocks: the sample is dropped if the buffer is full.
+      void PushRawSample(const RawSample& sample);
+      RawSampleBuffer& RawSamples() {
+        return rawSamples;
+      }
+      uint16_t DroppedRawSamples() const {
+        return droppedRawSamples;
+      }
+
     private:
       Applications::HeartRateTask* task = nullptr;
       States state = States::Stopped;
       uint8_t heartRate = 0;
       Pinetime::Controllers::HeartRateService* service = nullptr;
+
+      // Filled by the heart rate task, drained by the BLE host task
+      RawSampleBuffer rawSamples;
+      std::atomic<uint16_t> droppedRawSamples {0};
     };
   }
 }
\ No newline at end of file
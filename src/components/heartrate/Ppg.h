@@ -13,6 +13,9 @@ namespace Pinetime {
       Ppg();
       int8_t Preprocess(float spl);
       float HeartRate();
+      float AgcPeak() const {
+        return agc.Peak();
+      }
 
       void SetOffset(uint16_t i);
       void Reset();
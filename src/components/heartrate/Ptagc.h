@@ -6,6 +6,9 @@ namespace Pinetime {
     public:
       Ptagc(float start, float decay, float threshold);
       float Step(float spl);
+      float Peak() const {
+        return peak;
+      }
 
     private:
       float peak;
@@ -0,0 +1,332 @@
+#include "components/images/ImageStore.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace Pinetime::Controllers;
+
+static_assert(ImageStore::TileSize >= LV_HOR_RES_MAX * LV_COLOR_SIZE / 8, "A tile must hold a row of true color pixels");
+
+ImageStore::ImageStore(FS& fs) : fs {fs} {
+}
+
+void ImageStore::Init() {
+  lv_img_decoder_t* decoder = lv_img_decoder_create();
+  if (decoder == nullptr) {
+    return;
+  }
+  lv_img_decoder_set_info_cb(decoder, DecoderInfo);
+  lv_img_decoder_set_open_cb(decoder, DecoderOpen);
+  lv_img_decoder_set_read_line_cb(decoder, DecoderReadLine);
+  lv_img_decoder_set_close_cb(decoder, DecoderClose);
+  decoder->user_data = this;
+}
+
+/*
+
+    ----------- LVGL image decoder -----------
+
+*/
+
+lv_res_t ImageStore::DecoderInfo(lv_img_decoder_t* decoder, const void* source, lv_img_header_t* header) {
+  auto* store = static_cast<ImageStore*>(decoder->user_data);
+  // LVGL gets the info before opening the image: the index is reloaded here too if the pack was replaced
+  if (!IsStoreSource(source) || !store->OpenPack()) {
+    return LV_RES_INV;
+  }
+  const Entry* entry = store->Find(source);
+  store->ClosePack();
+  if (entry == nullptr) {
+    return LV_RES_INV;
+  }
+
+  header->always_zero = 0;
+  header->w = entry->width;
+  header->h = entry->height;
+  // The indexed pixels are decoded with the opacity of their palette entry
+  header->cf = (entry->colorFormat == LV_IMG_CF_TRUE_COLOR) ? LV_IMG_CF_TRUE_COLOR : LV_IMG_CF_TRUE_COLOR_ALPHA;
+  return LV_RES_OK;
+}
+
+lv_res_t ImageStore::DecoderOpen(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc) {
+  auto* store = static_cast<ImageStore*>(decoder->user_data);
+  if (!IsStoreSource(dsc->src) || !store->OpenPack()) {
+    return LV_RES_INV;
+  }
+
+  // Opening the pack reloads its index if it was replaced
+  const Entry* entry = store->Find(dsc->src);
+  auto* image = static_cast<OpenImage*>(lv_mem_alloc(sizeof(OpenImage)));
+  if (entry == nullptr || image == nullptr) {
+    lv_mem_free(image);
+    store->ClosePack();
+    return LV_RES_INV;
+  }
+
+  image->index = static_cast<uint8_t>(entry - store->entries.data());
+  image->bitsPerPixel = lv_img_cf_get_px_size(static_cast<lv_img_cf_t>(entry->colorFormat));
+  image->stride = (entry->width * image->bitsPerPixel + 7) / 8;
+  const bool indexed = image->bitsPerPixel <= 4;
+  image->bandsOffset = entry->offset + (indexed ? (4 << image->bitsPerPixel) : 0);
+  image->pixelsOffset = image->bandsOffset;
+  if (entry->compression == Compressions::Rle) {
+    const uint32_t nbBands = (entry->height + entry->rowsPerBand - 1) / entry->rowsPerBand;
+    image->pixelsOffset += (nbBands + 1) * sizeof(uint32_t);
+  }
+
+  if (indexed && !store->LoadPalette(*entry, *image)) {
+    lv_mem_free(image);
+    store->ClosePack();
+    return LV_RES_INV;
+  }
+
+  dsc->user_data = image;
+  // No image in RAM: LVGL reads it line by line
+  dsc->img_data = nullptr;
+  return LV_RES_OK;
+}
+
+lv_res_t ImageStore::DecoderReadLine(
+  lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc, lv_coord_t x, lv_coord_t y, lv_coord_t length, uint8_t* buffer) {
+  auto* store = static_cast<ImageStore*>(decoder->user_data);
+  const auto* image = static_cast<const OpenImage*>(dsc->user_data);
+  const Entry& entry = store->entries[image->index];
+
+  const uint8_t* row = store->GetRow(entry, *image, y);
+  if (row == nullptr) {
+    return LV_RES_INV;
+  }
+
+  if (image->bitsPerPixel > 4) {
+    const size_t bytesPerPixel = image->bitsPerPixel / 8;
+    std::memcpy(buffer, row + x * bytesPerPixel, length * bytesPerPixel);
+    return LV_RES_OK;
+  }
+
+  const uint8_t bitsPerPixel = image->bitsPerPixel;
+  const uint8_t mask = (1 << bitsPerPixel) - 1;
+  for (lv_coord_t i = 0; i < length; i++) {
+    // Most significant bits first
+    const uint32_t bit = (x + i) * bitsPerPixel;
+    const uint8_t index = (row[bit / 8] >> (8 - bitsPerPixel - bit % 8)) & mask;
+    uint8_t* pixel = buffer + i * LV_IMG_PX_SIZE_ALPHA_BYTE;
+    std::memcpy(pixel, &image->palette[index], sizeof(lv_color_t));
+    pixel[LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = image->opacities[index];
+  }
+  return LV_RES_OK;
+}
+
+void ImageStore::DecoderClose(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc) {
+  auto* store = static_cast<ImageStore*>(decoder->user_data);
+  lv_mem_free(dsc->user_data);
+  dsc->user_data = nullptr;
+  store->ClosePack();
+}
+
+/*
+
+    ----------- Pack and tiles -----------
+
+*/
+
+bool ImageStore::IsStoreSource(const void* source) {
+  if (lv_img_src_get_type(source) != LV_IMG_SRC_FILE) {
+    return false;
+  }
+  const auto* path = static_cast<const char*>(source);
+  return path[0] == Drive && path[1] == ':';
+}
+
+const ImageStore::Entry* ImageStore::Find(const void* source) {
+  const char* name = static_cast<const char*>(source) + 2;
+  for (size_t i = 0; i < nbEntries; i++) {
+    if (std::strncmp(entries[i].name, name, NameSize) == 0 && IsValid(entries[i])) {
+      return &entries[i];
+    }
+  }
+  return nullptr;
+}
+
+bool ImageStore::IsValid(const Entry& entry) {
+  switch (entry.colorFormat) {
+    case LV_IMG_CF_TRUE_COLOR:
+    case LV_IMG_CF_TRUE_COLOR_ALPHA:
+    case LV_IMG_CF_INDEXED_1BIT:
+    case LV_IMG_CF_INDEXED_2BIT:
+    case LV_IMG_CF_INDEXED_4BIT:
+      return entry.rowsPerBand > 0 && entry.width <= LV_HOR_RES_MAX;
+    default:
+      return false;
+  }
+}
+
+bool ImageStore::OpenPack() {
+  if (nbOpen > 0) {
+    nbOpen++;
+    return true;
+  }
+
+  if (fs.FileOpen(&file, Path, LFS_O_RDONLY) != LFS_ERR_OK) {
+    indexLoaded = false;
+    nbEntries = 0;
+    return false;
+  }
+
+  // The CRC is not checked, it only tells if the pack was replaced since its index was loaded
+  Header header;
+  if (!Read(0, &header, sizeof(header)) || header.magic != Magic || header.version != Version ||
+      ((!indexLoaded || header.crc != packCrc) && !LoadIndex(header))) {
+    fs.FileClose(&file);
+    indexLoaded = false;
+    nbEntries = 0;
+    return false;
+  }
+
+  nbOpen = 1;
+  return true;
+}
+
+void ImageStore::ClosePack() {
+  if (nbOpen > 0 && --nbOpen == 0) {
+    fs.FileClose(&file);
+  }
+}
+
+bool ImageStore::LoadIndex(const Header& header) {
+  for (auto& tile : tiles) {
+    tile.key = InvalidKey;
+    tile.lastUse = 0;
+  }
+
+  nbEntries = std::min<uint16_t>(header.nbImages, MaxImages);
+  if (!Read(sizeof(Header), entries.data(), nbEntries * sizeof(Entry))) {
+    return false;
+  }
+  packCrc = header.crc;
+  indexLoaded = true;
+  return true;
+}
+
+bool ImageStore::Read(uint32_t address, void* buffer, size_t size) {
+  if (fs.FileSeek(&file, address) < 0) {
+    return false;
+  }
+  return fs.FileRead(&file, static_cast<uint8_t*>(buffer), size) == static_cast<int>(size);
+}
+
+bool ImageStore::LoadPalette(const Entry& entry, OpenImage& image) {
+  // lv_color32_t: blue, green, red, alpha
+  uint8_t colors[4 * 16];
+  const size_t nbColors = 1 << image.bitsPerPixel;
+  if (!Read(entry.offset, colors, nbColors * 4)) {
+    return false;
+  }
+  for (size_t i = 0; i < nbColors; i++) {
+    image.palette[i] = lv_color_make(colors[i * 4 + 2], colors[i * 4 + 1], colors[i * 4]);
+    image.opacities[i] = colors[i * 4 + 3];
+  }
+  return true;
+}
+
+const uint8_t* ImageStore::GetRow(const Entry& entry, const OpenImage& image, uint16_t y) {
+  if (y >= entry.height) {
+    return nullptr;
+  }
+  const uint16_t band = y / entry.rowsPerBand;
+  const uint32_t key = (static_cast<uint32_t>(image.index) << 16) | band;
+  const size_t rowOffset = (y % entry.rowsPerBand) * image.stride;
+  useCounter++;
+
+  // LVGL reads the rows one after the other: most of them are in the tile of the previous one
+  Tile* leastRecentlyUsed = &tiles[0];
+  for (auto& tile : tiles) {
+    if (tile.key == key) {
+      nbHits++;
+      tile.lastUse = useCounter;
+      return tile.data + rowOffset;
+    }
+    if (tile.lastUse < leastRecentlyUsed->lastUse) {
+      leastRecentlyUsed = &tile;
+    }
+  }
+
+  nbMisses++;
+  Tile& tile = *leastRecentlyUsed;
+  if (!LoadBand(entry, image, band, tile)) {
+    tile.key = InvalidKey;
+    tile.lastUse = 0;
+    return nullptr;
+  }
+  tile.key = key;
+  tile.lastUse = useCounter;
+  return tile.data + rowOffset;
+}
+
+bool ImageStore::LoadBand(const Entry& entry, const OpenImage& image, uint16_t band, Tile& tile) {
+  const uint32_t firstRow = band * entry.rowsPerBand;
+  const uint32_t nbRows = std::min<uint32_t>(entry.rowsPerBand, entry.height - firstRow);
+  const size_t size = nbRows * image.stride;
+  if (size > TileSize) {
+    return false;
+  }
+
+  if (entry.compression == Compressions::None) {
+    return Read(image.pixelsOffset + firstRow * image.stride, tile.data, size);
+  }
+
+  // Offsets of the band and of the next one, from the start of the pixels
+  uint32_t offsets[2];
+  if (!Read(image.bandsOffset + band * sizeof(uint32_t), offsets, sizeof(offsets)) || offsets[1] < offsets[0]) {
+    return false;
+  }
+  const size_t unitSize = (image.bitsPerPixel > 4) ? image.bitsPerPixel / 8 : 1;
+  return DecodeRle(image.pixelsOffset + offsets[0], offsets[1] - offsets[0], unitSize, tile.data, size);
+}
+
+bool ImageStore::DecodeRle(uint32_t address, uint32_t size, size_t unitSize, uint8_t* output, size_t outputSize) {
+  // Control byte n: n + 1 literal units follow if n < 128, otherwise the next unit is repeated n - 126 times. A unit
+  // is a pixel for the true color formats, a byte for the indexed ones. The band is read by chunks: a run can straddle
+  // two of them.
+  uint8_t chunk[32];
+  uint8_t unit[LV_IMG_PX_SIZE_ALPHA_BYTE];
+  size_t nbUnitBytes = 0;
+  size_t nbDecoded = 0;
+  size_t nbLiteralBytes = 0;
+  uint8_t nbRepeats = 0;
+  while (size > 0) {
+    const size_t chunkSize = std::min<size_t>(size, sizeof(chunk));
+    if (!Read(address, chunk, chunkSize)) {
+      return false;
+    }
+    address += chunkSize;
+    size -= chunkSize;
+
+    for (size_t i = 0; i < chunkSize; i++) {
+      const uint8_t value = chunk[i];
+      if (nbLiteralBytes > 0) {
+        if (nbDecoded >= outputSize) {
+          return false;
+        }
+        output[nbDecoded++] = value;
+        nbLiteralBytes--;
+      } else if (nbRepeats > 0) {
+        unit[nbUnitBytes++] = value;
+        if (nbUnitBytes < unitSize) {
+          continue;
+        }
+        if (nbDecoded + nbRepeats * unitSize > outputSize) {
+          return false;
+        }
+        for (; nbRepeats > 0; nbRepeats--) {
+          std::memcpy(output + nbDecoded, unit, unitSize);
+          nbDecoded += unitSize;
+        }
+        nbUnitBytes = 0;
+      } else if (value < 128) {
+        nbLiteralBytes = (value + 1) * unitSize;
+      } else {
+        nbRepeats = value - 126;
+      }
+    }
+  }
+  return nbDecoded == outputSize && nbLiteralBytes == 0 && nbRepeats == 0;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <lvgl/lvgl.h>
+#include "components/fs/FS.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Images stored in the external flash instead of the internal one.
+     *
+     * The images are packed by tools/imagepack/imagepack.py into the file Path of the file system: an index of the
+     * images followed by their pixels, in the LVGL color formats (indexed 1, 2 or 4 bits with their palette, true
+     * color, true color with alpha). The pixels are split into bands of a few rows, each one optionally RLE compressed.
+     *
+     * The store registers an LVGL image decoder for the sources "I:<name>". Instead of loading an image in RAM, it
+     * decodes the rows requested by LVGL from the band that contains them, and keeps the last bands it used in a small
+     * LRU cache of tiles. See doc/ImageStore.md.
+     */
+    class ImageStore {
+    public:
+      static constexpr const char* Path = "/images.bin";
+      static constexpr char Drive = 'I';
+      static constexpr size_t MaxImages = 16;
+      static constexpr size_t NameSize = 12;
+      // Maximum size of a decoded band: a row of 240 true color pixels
+      static constexpr size_t TileSize = 480;
+      static constexpr size_t NbTiles = 4;
+
+      explicit ImageStore(FS& fs);
+      ImageStore(const ImageStore&) = delete;
+      ImageStore& operator=(const ImageStore&) = delete;
+
+      /// Registers the decoder: call it after lv_init()
+      void Init();
+
+      uint32_t NbHits() const {
+        return nbHits;
+      }
+      uint32_t NbMisses() const {
+        return nbMisses;
+      }
+
+    private:
+      enum class Compressions : uint8_t { None = 0, Rle = 1 };
+
+      struct __attribute__((packed)) Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t nbImages;
+        // CRC32 of the file after the header
+        uint32_t crc;
+        uint32_t reserved;
+      };
+
+      // Offset: in the file, of the palette, then the offsets of the bands (RLE only), then the pixels
+      struct __attribute__((packed)) Entry {
+        char name[NameSize];
+        uint16_t width;
+        uint16_t height;
+        uint8_t colorFormat;
+        Compressions compression;
+        uint8_t rowsPerBand;
+        uint8_t reserved;
+        uint32_t offset;
+        uint32_t size;
+      };
+      static_assert(sizeof(Entry) == 28, "Format of the index of the pack");
+
+      struct Tile {
+        // Index of the image and of the band, InvalidKey when the tile is empty
+        uint32_t key = InvalidKey;
+        uint32_t lastUse = 0;
+        uint8_t data[TileSize];
+      };
+
+      // State of an open image, allocated by LVGL
+      struct OpenImage {
+        uint8_t index;
+        uint8_t bitsPerPixel;
+        uint16_t stride;
+        uint32_t bandsOffset;
+        uint32_t pixelsOffset;
+        lv_color_t palette[16];
+        lv_opa_t opacities[16];
+      };
+
+      static constexpr uint32_t Magic = 0x4d495450; // "PTIM"
+      static constexpr uint16_t Version = 1;
+      static constexpr uint32_t InvalidKey = UINT32_MAX;
+
+      static lv_res_t DecoderInfo(lv_img_decoder_t* decoder, const void* source, lv_img_header_t* header);
+      static lv_res_t DecoderOpen(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc);
+      static lv_res_t
+      DecoderReadLine(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc, lv_coord_t x, lv_coord_t y, lv_coord_t length, uint8_t* buffer);
+      static void DecoderClose(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc);
+
+      static bool IsStoreSource(const void* source);
+      static bool IsValid(const Entry& entry);
+      // In the index of the open pack
+      const Entry* Find(const void* source);
+      bool OpenPack();
+      void ClosePack();
+      bool LoadIndex(const Header& header);
+      bool Read(uint32_t address, void* buffer, size_t size);
+      bool LoadPalette(const Entry& entry, OpenImage& image);
+      const uint8_t* GetRow(const Entry& entry, const OpenImage& image, uint16_t y);
+      bool LoadBand(const Entry& entry, const OpenImage& image, uint16_t band, Tile& tile);
+      bool DecodeRle(uint32_t address, uint32_t size, size_t unitSize, uint8_t* output, size_t outputSize);
+
+      FS& fs;
+      lfs_file_t file;
+      uint8_t nbOpen = 0;
+
+      bool indexLoaded = false;
+      uint32_t packCrc = 0;
+      std::array<Entry, MaxImages> entries;
+      uint16_t nbEntries = 0;
+
+      std::array<Tile, NbTiles> tiles;
+      uint32_t useCounter = 0;
+      uint32_t nbHits = 0;
+      uint32_t nbMisses = 0;
+    };
+  }
+}
@@ -21,6 +21,10 @@ void MotionController::Update(int16_t x, int16_t y, int16_t z, uint32_t nbSteps)
   }
 }
 
+bool MotionController::IsStreaming() const {
+  return service != nullptr && service->IsMotionStreamEnabled();
+}
+
 bool MotionController::Should_RaiseWake(bool isSleeping) {
   if ((x + 335) <= 670 && z < 0) {
     if (not isSleeping) {
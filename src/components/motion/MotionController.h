@@ -15,6 +15,15 @@ namespace Pinetime {
       };
 
       void Update(int16_t x, int16_t y, int16_t z, uint32_t nbSteps);
+      /// Forwards the nbFrames frames waiting in the accelerometer FIFO, read with read(values, maxCount), to the motion
+      /// stream. now is the time (in ms) of the last frame.
+      template <typename Read>
+      void UpdateFifo(size_t nbFrames, uint32_t now, Read read) {
+        if (IsStreaming()) {
+          service->ReadMotionFifo(nbFrames, now, read);
+        }
+      }
+      bool IsStreaming() const;
 
       int16_t X() const {
         return x;
@@ -190,6 +190,17 @@ namespace Pinetime {
         return settings.brightLevel;
       };
 
+      void SetAlwaysOnDisplay(bool enabled) {
+        if (enabled != settings.alwaysOnDisplay) {
+          settingsChanged = true;
+        }
+        settings.alwaysOnDisplay = enabled;
+      };
+
+      bool GetAlwaysOnDisplay() const {
+        return settings.alwaysOnDisplay;
+      };
+
       void SetStepsGoal(uint32_t goal) {
         if (goal != settings.stepsGoal) {
           settingsChanged = true;
@@ -212,7 +223,7 @@ namespace Pinetime {
     private:
       Pinetime::Controllers::FS& fs;
 
-      static constexpr uint32_t settingsVersion = 0x0003;
+      static constexpr uint32_t settingsVersion = 0x0004;
       struct SettingsData {
         uint32_t version = settingsVersion;
         uint32_t stepsGoal = 10000;
@@ -229,6 +240,7 @@ namespace Pinetime {
         std::bitset<4> wakeUpMode {0};
         uint16_t shakeWakeThreshold = 150;
         Controllers::BrightnessController::Levels brightLevel = Controllers::BrightnessController::Levels::Medium;
+        bool alwaysOnDisplay = false;
       };
 
       SettingsData settings;
@@ -0,0 +1,141 @@
+#include "displayapp/AlwaysOnDisplay.h"
+#include <algorithm>
+#include <FreeRTOS.h>
+#include <task.h>
+#include "components/datetime/DateTimeController.h"
+#include "components/settings/Settings.h"
+#include "drivers/St7789.h"
+
+using namespace Pinetime::Applications;
+
+namespace {
+  // 1-bit 7-segment digits: the idle mode of the display only shows 8 colours anyway
+  constexpr uint16_t digitWidth = 40;
+  constexpr uint16_t segmentThickness = 8;
+  constexpr uint16_t colonWidth = 8;
+  constexpr std::array<uint16_t, AlwaysOnDisplay::NbDigits> digitX {{20, 68, 132, 180}};
+  constexpr uint16_t colonX = 116;
+
+  constexpr uint16_t lit = 0xffff;
+  constexpr uint16_t unlit = 0x0000;
+
+  // Segments a (top) to g (middle) of each digit, in bits 0 to 6
+  constexpr std::array<uint8_t, 10> segments {{0x3f, 0x06, 0x5b, 0x4f, 0x66, 0x6d, 0x7d, 0x07, 0x7f, 0x6f}};
+
+  bool IsSegmentLit(uint8_t digit, uint16_t x, uint16_t y) {
+    constexpr uint16_t h = AlwaysOnDisplay::NbLines;
+    constexpr uint16_t t = segmentThickness;
+    constexpr uint16_t middle = (h - t) / 2;
+    const bool left = x < t;
+    const bool right = x >= digitWidth - t;
+    const bool upper = y < middle + t;
+    const bool lower = y >= middle;
+
+    const uint8_t mask = segments[digit];
+    return ((mask & 0x01) && y < t) ||                       // a
+           ((mask & 0x02) && right && upper) ||              // b
+           ((mask & 0x04) && right && lower) ||              // c
+           ((mask & 0x08) && y >= h - t) ||                  // d
+           ((mask & 0x10) && left && lower) ||               // e
+           ((mask & 0x20) && left && upper) ||               // f
+           ((mask & 0x40) && y >= middle && y < middle + t); // g
+  }
+
+  bool IsLit(const std::array<uint8_t, AlwaysOnDisplay::NbDigits>& digits, uint16_t x, uint16_t y) {
+    for (size_t i = 0; i < digits.size(); i++) {
+      if (x >= digitX[i] && x < digitX[i] + digitWidth) {
+        return IsSegmentLit(digits[i], x - digitX[i], y);
+      }
+    }
+    if (x >= colonX && x < colonX + colonWidth) {
+      return (y >= 20 && y < 20 + colonWidth) || (y >= 44 && y < 44 + colonWidth);
+    }
+    return false;
+  }
+}
+
+AlwaysOnDisplay::AlwaysOnDisplay(Drivers::St7789& lcd,
+                                 Controllers::DateTime& dateTimeController,
+                                 Controllers::Settings& settingsController)
+  : lcd {lcd}, dateTimeController {dateTimeController}, settingsController {settingsController} {
+}
+
+void AlwaysOnDisplay::Render(const std::array<uint8_t, NbDigits>& digits,
+                             uint16_t x,
+                             uint16_t width,
+                             uint16_t firstLine,
+                             uint16_t nbLines,
+                             uint16_t* buffer) {
+  for (uint16_t line = 0; line < nbLines; line++) {
+    for (uint16_t column = 0; column < width; column++) {
+      buffer[line * width + column] = IsLit(digits, x + column, firstLine + line) ? lit : unlit;
+    }
+  }
+}
+
+std::array<uint8_t, AlwaysOnDisplay::NbDigits> AlwaysOnDisplay::CurrentDigits() const {
+  uint8_t hours = dateTimeController.Hours();
+  if (settingsController.GetClockType() == Controllers::Settings::ClockType::H12) {
+    hours = (hours % 12 == 0) ? 12 : hours % 12;
+  }
+  const uint8_t minutes = dateTimeController.Minutes();
+  return {{static_cast<uint8_t>(hours / 10), static_cast<uint8_t>(hours % 10), static_cast<uint8_t>(minutes / 10),
+           static_cast<uint8_t>(minutes % 10)}};
+}
+
+void AlwaysOnDisplay::Enter() {
+  // Wait for the end of the last flush of LVGL, as the DataCommand pin cannot change during a transfer
+  ulTaskNotifyTake(pdTRUE, 200);
+
+  digits = CurrentDigits();
+  nbBytesWritten = 0;
+  // The partial area is a range of lines of the frame memory: the display must not be scrolled
+  lcd.VerticalScrollStartAddress(0);
+  lcd.LowPowerOn(FirstLine, FirstLine + NbLines - 1);
+  Draw(0, Width);
+  active = true;
+
+  // The next flush of LVGL waits for this notification
+  xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+}
+
+void AlwaysOnDisplay::Update() {
+  if (!active) {
+    return;
+  }
+  ulTaskNotifyTake(pdTRUE, 200);
+
+  const auto newDigits = CurrentDigits();
+  for (size_t i = 0; i < digits.size(); i++) {
+    if (newDigits[i] != digits[i]) {
+      digits[i] = newDigits[i];
+      Draw(digitX[i], digitWidth);
+    }
+  }
+
+  xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+}
+
+void AlwaysOnDisplay::Exit() {
+  if (!active) {
+    return;
+  }
+  ulTaskNotifyTake(pdTRUE, 200);
+  lcd.LowPowerOff();
+  active = false;
+  xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+}
+
+void AlwaysOnDisplay::Draw(uint16_t x, uint16_t width) {
+  const uint16_t linesPerTransfer = bufferSize / width;
+  for (uint16_t line = 0; line < NbLines; line += linesPerTransfer) {
+    const uint16_t nbLines = std::min<uint16_t>(linesPerTransfer, NbLines - line);
+    Render(digits, x, width, line, nbLines, buffer);
+
+    const size_t size = width * nbLines * sizeof(uint16_t);
+    lcd.DrawBuffer(x, FirstLine + line, width, nbLines, reinterpret_cast<const uint8_t*>(buffer), size);
+    nbBytesWritten += size;
+    // The buffer is reused for the next lines
+    ulTaskNotifyTake(pdTRUE, 100);
+  }
+}
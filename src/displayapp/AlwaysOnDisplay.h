@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Drivers {
+    class St7789;
+  }
+  namespace Controllers {
+    class DateTime;
+    class Settings;
+  }
+  namespace Applications {
+    /**
+     * Minimal clock displayed while the watch sleeps, instead of turning the display off.
+     *
+     * It is drawn directly into the frame memory, without LVGL: LVGL doesn't run while the display task is idle. The
+     * display only shows the lines of the clock, in its 8-colour idle mode, and each update only writes the digits that
+     * changed. Must only be used from the display task, while LVGL doesn't flush.
+     */
+    class AlwaysOnDisplay {
+    public:
+      static constexpr uint16_t Width = 240;
+      static constexpr uint16_t FirstLine = 84;
+      static constexpr uint16_t NbLines = 72;
+      static constexpr uint8_t NbDigits = 4;
+
+      AlwaysOnDisplay(Drivers::St7789& lcd, Controllers::DateTime& dateTimeController, Controllers::Settings& settingsController);
+
+      /// Draws the clock and switches the display to its low power mode
+      void Enter();
+      /// Draws the digits that changed since the last update
+      void Update();
+      /// Switches the display back to its normal mode: the screen must be redrawn entirely
+      void Exit();
+
+      bool IsActive() const {
+        return active;
+      }
+
+      /// Number of bytes written to the display since Enter(), to estimate the power budget
+      uint32_t NbBytesWritten() const {
+        return nbBytesWritten;
+      }
+
+      /// Renders the lines [firstLine, firstLine + nbLines[ of the columns [x, x + width[ of the clock into buffer
+      /// (RGB565). It doesn't depend on the hardware.
+      static void Render(const std::array<uint8_t, NbDigits>& digits,
+                         uint16_t x,
+                         uint16_t width,
+                         uint16_t firstLine,
+                         uint16_t nbLines,
+                         uint16_t* buffer);
+
+    private:
+      static constexpr uint16_t bufferSize = Width * 4;
+
+      std::array<uint8_t, NbDigits> CurrentDigits() const;
+      void Draw(uint16_t x, uint16_t width);
+
+      Drivers::St7789& lcd;
+      Controllers::DateTime& dateTimeController;
+      Controllers::Settings& settingsController;
+
+      std::array<uint8_t, NbDigits> digits {};
+      bool active = false;
+      uint32_t nbBytesWritten = 0;
+      uint16_t buffer[bufferSize];
+    };
+  }
+}
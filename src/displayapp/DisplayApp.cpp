@@ -1,5 +1,5 @@
 #include "displayapp/DisplayApp.h"
-#include <libraries/log/nrf_log.h>
+#include "logging/TokenizedLog.h"
 #include "displayapp/screens/HeartRate.h"
 #include "displayapp/screens/Motion.h"
 #include "displayapp/screens/Timer.h"
@@ -35,6 +35,7 @@
 #include "drivers/Watchdog.h"
 #include "systemtask/SystemTask.h"
 #include "systemtask/Messages.h"
+#include "logging/Trace.h"
 
 #include "displayapp/screens/settings/QuickSettings.h"
 #include "displayapp/screens/settings/Settings.h"
@@ -55,8 +56,25 @@ using namespace Pinetime::Applications;
 using namespace Pinetime::Applications::Display;
 
 namespace {
-  static inline bool in_isr(void) {
-    return (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) != 0;
+  // Apps opened even when the memory is critical: the watch face, the menus, and what the system or the user need
+  bool IsEssential(Apps app) {
+    switch (app) {
+      case Apps::None:
+      case Apps::Clock:
+      case Apps::Launcher:
+      case Apps::Error:
+      case Apps::FirmwareUpdate:
+      case Apps::FirmwareValidation:
+      case Apps::NotificationsPreview:
+      case Apps::Notifications:
+      case Apps::Alarm:
+      case Apps::Timer:
+      case Apps::PassKey:
+      case Apps::QuickSettings:
+        return true;
+      default:
+        return app >= Apps::Settings && app <= Apps::SettingBluetooth;
+    }
   }
 }
 
@@ -75,7 +93,8 @@ DisplayApp::DisplayApp(Drivers::St7789& lcd,
                        Pinetime::Controllers::TimerController& timerController,
                        Pinetime::Controllers::AlarmController& alarmController,
                        Pinetime::Controllers::BrightnessController& brightnessController,
-                       Pinetime::Controllers::TouchHandler& touchHandler)
+                       Pinetime::Controllers::TouchHandler& touchHandler,
+                       Pinetime::Controllers::FS& fs)
   : lcd {lcd},
     lvgl {lvgl},
     touchPanel {touchPanel},
@@ -91,13 +110,18 @@ DisplayApp::DisplayApp(Drivers::St7789& lcd,
     timerController {timerController},
     alarmController {alarmController},
     brightnessController {brightnessController},
-    touchHandler {touchHandler} {
+    touchHandler {touchHandler},
+    imageStore {fs},
+    fontStore {fs},
+    alwaysOnDisplay {lcd, dateTimeController, settingsController} {
 }
 
 void DisplayApp::Start(System::BootErrors error) {
-  msgQueue = xQueueCreate(queueSize, itemSize);
+  messageBus.Init();
 
   bootError = error;
+  imageStore.Init();
+  fontStore.Init();
 
   if (error == System::BootErrors::TouchController) {
     LoadApp(Apps::Error, DisplayApp::FullRefreshDirections::None);
@@ -112,7 +136,7 @@ void DisplayApp::Start(System::BootErrors error) {
 
 void DisplayApp::Process(void* instance) {
   auto* app = static_cast<DisplayApp*>(instance);
-  NRF_LOG_INFO("displayapp task started!");
+  TLOG_INFO("displayapp task started!");
   app->InitHw();
 
   // Send a dummy notification to unlock the lvgl display driver for the first iteration
@@ -143,6 +167,13 @@ void DisplayApp::Refresh() {
         LoadPreviousScreen();
       }
       queueTimeout = lv_task_handler();
+      if (xTaskGetTickCount() - lastMemoryCheck > memoryCheckPeriod) {
+        if (UpdateLvglMemory()) {
+          ReleaseMemory();
+        } else {
+          RestoreImageCache();
+        }
+      }
       break;
     default:
       queueTimeout = portMAX_DELAY;
@@ -150,7 +181,7 @@ void DisplayApp::Refresh() {
   }
 
   Messages msg;
-  if (xQueueReceive(msgQueue, &msg, queueTimeout)) {
+  if (messageBus.Receive(msg, queueTimeout)) {
     switch (msg) {
       case Messages::DimScreen:
         brightnessController.Set(Controllers::BrightnessController::Levels::Low);
@@ -159,17 +190,38 @@ void DisplayApp::Refresh() {
         brightnessController.Set(settingsController.GetBrightness());
         break;
       case Messages::GoToSleep:
-        while (brightnessController.Level() != Controllers::BrightnessController::Levels::Off) {
-          brightnessController.Lower();
-          vTaskDelay(100);
+        if (settingsController.GetAlwaysOnDisplay()) {
+          while (brightnessController.Level() > Controllers::BrightnessController::Levels::Low) {
+            brightnessController.Lower();
+            vTaskDelay(100);
+          }
+          // LVGL doesn't run until the watch wakes up: the clock is drawn without it
+          alwaysOnDisplay.Enter();
+        } else {
+          while (brightnessController.Level() != Controllers::BrightnessController::Levels::Off) {
+            brightnessController.Lower();
+            vTaskDelay(100);
+          }
         }
         PushMessageToSystemTask(Pinetime::System::Messages::OnDisplayTaskSleeping);
         state = States::Idle;
         break;
       case Messages::GoToRunning:
+        if (alwaysOnDisplay.IsActive()) {
+          alwaysOnDisplay.Exit();
+          // Redraw the screen before the backlight is restored
+          lvgl.InvalidateDisplay();
+          lv_refr_now(nullptr);
+        }
         brightnessController.Set(settingsController.GetBrightness());
         state = States::Running;
         break;
+      case Messages::UpdateAlwaysOnDisplay:
+        if (state == States::Idle) {
+          alwaysOnDisplay.Update();
+        }
+        PushMessageToSystemTask(Pinetime::System::Messages::OnAlwaysOnDisplayUpdated);
+        break;
       case Messages::UpdateTimeOut:
         PushMessageToSystemTask(System::Messages::UpdateTimeOut);
         break;
@@ -203,6 +255,8 @@ void DisplayApp::Refresh() {
         if (state != States::Running) {
           break;
         }
+        // Don't wait for the next read period of the input device to process the new touch point
+        lvgl.ReadTouchNow();
         auto gesture = touchHandler.GestureGet();
         if (gesture == TouchEvents::None) {
           break;
@@ -275,11 +329,21 @@ void DisplayApp::Refresh() {
       case Messages::Clock:
         LoadApp(Apps::Clock, DisplayApp::FullRefreshDirections::None);
         break;
+      case Messages::MemoryPressure:
+        ReleaseMemory();
+        break;
     }
   }
 
   if (touchHandler.IsTouching()) {
     currentScreen->OnTouchEvent(touchHandler.GetX(), touchHandler.GetY());
+    if (currentScreen->OnDragEvent(touchHandler.GetX(), touchHandler.GetY(), true)) {
+      touchHandler.CancelTap();
+    }
+    touchReleased = false;
+  } else if (!touchReleased) {
+    currentScreen->OnDragEvent(touchHandler.GetX(), touchHandler.GetY(), false);
+    touchReleased = true;
   }
 
   if (nextApp != Apps::None) {
@@ -300,31 +364,52 @@ void DisplayApp::ReturnApp(Apps app, DisplayApp::FullRefreshDirections direction
 }
 
 void DisplayApp::LoadApp(Apps app, DisplayApp::FullRefreshDirections direction) {
+  Logging::Trace::Record(Logging::Trace::Events::LoadAppStart, static_cast<uint16_t>(app));
   touchHandler.CancelTap();
   brightnessController.Set(settingsController.GetBrightness());
 
-  currentScreen.reset(nullptr);
+  HideCurrentScreen();
+  if (app >= Apps::Settings && app <= Apps::SettingBluetooth) {
+    // The kept screens would not show the new settings
+    screenCache.Clear();
+  }
+  if (systemTask->GetMemoryPressure().GetLevel() != System::MemoryPressure::Levels::Normal) {
+    ReleaseMemory();
+  }
+  if (!IsEssential(app) && systemTask->GetMemoryPressure().GetLevel() == System::MemoryPressure::Levels::Critical) {
+    // The app could exhaust the memory: go back to the watch face instead
+    TLOG_WARNING("[DisplayApp] Not enough memory to open app %d", static_cast<int>(app));
+    motorController.RunForDuration(35);
+    app = Apps::Clock;
+    direction = FullRefreshDirections::None;
+  }
   SetFullRefresh(direction);
 
   // default return to launcher
   ReturnApp(Apps::Launcher, FullRefreshDirections::Down, TouchEvents::SwipeDown);
 
+  // Only the apps whose screen is retainable are in the cache
+  currentScreen = screenCache.Take(app);
+  const bool retained = currentScreen != nullptr;
+
   switch (app) {
     case Apps::Launcher:
       currentScreen =
-        std::make_unique<Screens::ApplicationList>(this, settingsController, batteryController, bleController, dateTimeController);
+        std::make_unique<Screens::ApplicationList>(this, lvgl, settingsController, batteryController, bleController, dateTimeController);
       ReturnApp(Apps::Clock, FullRefreshDirections::Down, TouchEvents::SwipeDown);
       break;
     case Apps::None:
     case Apps::Clock:
-      currentScreen = std::make_unique<Screens::Clock>(this,
-                                                       dateTimeController,
-                                                       batteryController,
-                                                       bleController,
-                                                       notificationManager,
-                                                       settingsController,
-                                                       heartRateController,
-                                                       motionController);
+      if (!retained) {
+        currentScreen = std::make_unique<Screens::Clock>(this,
+                                                         dateTimeController,
+                                                         batteryController,
+                                                         bleController,
+                                                         notificationManager,
+                                                         settingsController,
+                                                         heartRateController,
+                                                         motionController);
+      }
       break;
 
     case Apps::Error:
@@ -348,6 +433,7 @@ void DisplayApp::LoadApp(Apps app, DisplayApp::FullRefreshDirections direction)
 
     case Apps::Notifications:
       currentScreen = std::make_unique<Screens::Notifications>(this,
+                                                               lvgl,
                                                                notificationManager,
                                                                systemTask->nimble().alertService(),
                                                                motorController,
@@ -357,6 +443,7 @@ void DisplayApp::LoadApp(Apps app, DisplayApp::FullRefreshDirections direction)
       break;
     case Apps::NotificationsPreview:
       currentScreen = std::make_unique<Screens::Notifications>(this,
+                                                               lvgl,
                                                                notificationManager,
                                                                systemTask->nimble().alertService(),
                                                                motorController,
@@ -383,7 +470,7 @@ void DisplayApp::LoadApp(Apps app, DisplayApp::FullRefreshDirections direction)
       ReturnApp(Apps::Clock, FullRefreshDirections::LeftAnim, TouchEvents::SwipeLeft);
       break;
     case Apps::Settings:
-      currentScreen = std::make_unique<Screens::Settings>(this, settingsController);
+      currentScreen = std::make_unique<Screens::Settings>(this, lvgl, settingsController);
       ReturnApp(Apps::QuickSettings, FullRefreshDirections::Down, TouchEvents::SwipeDown);
       break;
     case Apps::SettingWatchFace:
@@ -438,7 +525,8 @@ void DisplayApp::LoadApp(Apps app, DisplayApp::FullRefreshDirections direction)
                                                             bleController,
                                                             watchdog,
                                                             motionController,
-                                                            touchPanel);
+                                                            touchPanel,
+                                                            *systemTask);
       ReturnApp(Apps::Settings, FullRefreshDirections::Down, TouchEvents::SwipeDown);
       break;
     case Apps::FlashLight:
@@ -477,19 +565,77 @@ void DisplayApp::LoadApp(Apps app, DisplayApp::FullRefreshDirections direction)
       currentScreen = std::make_unique<Screens::Steps>(this, motionController, settingsController);
       break;
   }
+
+  if (!retained) {
+    currentScreen->RestoreState(screenCache.GetState(app));
+  }
   currentApp = app;
+
+  if (UpdateLvglMemory()) {
+    ReleaseMemory();
+  }
+  Logging::Trace::Record(Logging::Trace::Events::LoadAppEnd, retained ? 1 : 0);
+}
+
+bool DisplayApp::UpdateLvglMemory() {
+  lastMemoryCheck = xTaskGetTickCount();
+  auto& memoryPressure = systemTask->GetMemoryPressure();
+  const auto previousLevel = memoryPressure.GetLevel();
+
+  // The allocations that don't fit in the block pools need contiguous blocks of the general pool: the biggest free
+  // one is what matters, not the total free memory
+  const auto memory = Components::LittleVgl::GetMemoryStatistics();
+  memoryPressure.Update(System::MemoryPressure::Pools::Lvgl, memory.poolBiggestFree, memory.poolSize);
+  return memoryPressure.GetLevel() > previousLevel;
+}
+
+void DisplayApp::ReleaseMemory() {
+  const auto level = systemTask->GetMemoryPressure().GetLevel();
+  if (level == System::MemoryPressure::Levels::Normal) {
+    return;
+  }
+  TLOG_INFO("[DisplayApp] Memory pressure %d: releasing the caches", static_cast<int>(level));
+  screenCache.Clear();
+  // Closes the images kept open by LVGL, with the state allocated by their decoders, and keeps a single one open
+  // until the pressure is gone
+  lv_img_cache_invalidate_src(nullptr);
+  if (!imageCacheReduced) {
+    lv_img_cache_set_size(1);
+    imageCacheReduced = true;
+  }
+  if (currentScreen != nullptr) {
+    currentScreen->OnLowMemory();
+  }
+  UpdateLvglMemory();
+}
+
+void DisplayApp::RestoreImageCache() {
+  if (imageCacheReduced && systemTask->GetMemoryPressure().GetLevel() == System::MemoryPressure::Levels::Normal) {
+    lv_img_cache_set_size(LV_IMG_CACHE_DEF_SIZE);
+    imageCacheReduced = false;
+  }
+}
+
+void DisplayApp::HideCurrentScreen() {
+  if (currentScreen == nullptr) {
+    return;
+  }
+  screenCache.SaveState(currentApp, currentScreen->SaveState());
+
+  const auto memory = Components::LittleVgl::GetMemoryStatistics();
+  if (!currentScreen->IsRetainable() || memory.poolBiggestFree < ScreenCache::MinFreeMemory ||
+      systemTask->GetMemoryPressure().GetLevel() != System::MemoryPressure::Levels::Normal) {
+    currentScreen.reset(nullptr);
+    return;
+  }
+
+  screenCache.Retain(currentApp, std::move(currentScreen));
 }
 
 void DisplayApp::PushMessage(Messages msg) {
-  if (in_isr()) {
-    BaseType_t xHigherPriorityTaskWoken;
-    xHigherPriorityTaskWoken = pdFALSE;
-    xQueueSendFromISR(msgQueue, &msg, &xHigherPriorityTaskWoken);
-    if (xHigherPriorityTaskWoken) {
-      portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
-    }
-  } else {
-    xQueueSend(msgQueue, &msg, portMAX_DELAY);
+  Logging::Trace::Record(Logging::Trace::Events::DisplayMessagePosted, static_cast<uint16_t>(msg));
+  if (!messageBus.Post(msg)) {
+    TLOG_INFO("[DisplayApp] Message %d dropped", static_cast<int>(msg));
   }
 }
 
@@ -5,8 +5,11 @@
 #include <task.h>
 #include <memory>
 #include <systemtask/Messages.h>
+#include "systemtask/MessageBus.h"
+#include "displayapp/AlwaysOnDisplay.h"
 #include "displayapp/Apps.h"
 #include "displayapp/LittleVgl.h"
+#include "displayapp/ScreenCache.h"
 #include "displayapp/TouchEvents.h"
 #include "components/brightness/BrightnessController.h"
 #include "components/motor/MotorController.h"
@@ -15,6 +18,8 @@
 #include "displayapp/screens/Screen.h"
 #include "components/timer/TimerController.h"
 #include "components/alarm/AlarmController.h"
+#include "components/fonts/FontStore.h"
+#include "components/images/ImageStore.h"
 #include "touchhandler/TouchHandler.h"
 
 #include "displayapp/Messages.h"
@@ -36,6 +41,7 @@ namespace Pinetime {
     class HeartRateController;
     class MotionController;
     class TouchHandler;
+    class FS;
   }
 
   namespace System {
@@ -62,10 +68,17 @@ namespace Pinetime {
                  Pinetime::Controllers::TimerController& timerController,
                  Pinetime::Controllers::AlarmController& alarmController,
                  Pinetime::Controllers::BrightnessController& brightnessController,
-                 Pinetime::Controllers::TouchHandler& touchHandler);
+                 Pinetime::Controllers::TouchHandler& touchHandler,
+                 Pinetime::Controllers::FS& fs);
       void Start(System::BootErrors error);
+      using MessageBus = System::MessageBus<Display::Messages, 10>;
+
       void PushMessage(Display::Messages msg);
 
+      MessageBus::Statistics GetMessageStatistics() const {
+        return messageBus.GetStatistics();
+      }
+
       void StartApp(Apps app, DisplayApp::FullRefreshDirections direction);
 
       void SetFullRefresh(FullRefreshDirections direction);
@@ -92,21 +105,30 @@ namespace Pinetime {
       Pinetime::Controllers::TouchHandler& touchHandler;
 
       Pinetime::Controllers::FirmwareValidator validator;
+      Pinetime::Controllers::ImageStore imageStore;
+      Pinetime::Controllers::FontStore fontStore;
+      AlwaysOnDisplay alwaysOnDisplay;
 
       TaskHandle_t taskHandle;
 
       States state = States::Running;
-      QueueHandle_t msgQueue;
-
-      static constexpr uint8_t queueSize = 10;
-      static constexpr uint8_t itemSize = 1;
+      MessageBus messageBus {MessageBus::MaskOf({Display::Messages::TouchEvent,
+                                                 Display::Messages::UpdateDateTime,
+                                                 Display::Messages::UpdateBleConnection,
+                                                 Display::Messages::UpdateTimeOut,
+                                                 Display::Messages::NewNotification})};
 
       std::unique_ptr<Screens::Screen> currentScreen;
 
+      // The watch face, and possibly the last retainable app, kept while another app is displayed
+      ScreenCache screenCache;
+
       Apps currentApp = Apps::None;
       Apps returnToApp = Apps::None;
       FullRefreshDirections returnDirection = FullRefreshDirections::None;
       TouchEvents returnTouchEvent = TouchEvents::None;
+      // The current screen was told that the last touch was released
+      bool touchReleased = true;
 
       TouchEvents GetGesture();
       static void Process(void* instance);
@@ -114,6 +136,16 @@ namespace Pinetime {
       void Refresh();
       void ReturnApp(Apps app, DisplayApp::FullRefreshDirections direction, TouchEvents touchEvent);
       void LoadApp(Apps app, DisplayApp::FullRefreshDirections direction);
+      void HideCurrentScreen();
+
+      // Checks the LVGL memory at this period while running, and after an app is opened
+      static constexpr TickType_t memoryCheckPeriod = pdMS_TO_TICKS(1000);
+      TickType_t lastMemoryCheck = 0;
+      bool UpdateLvglMemory();
+      void ReleaseMemory();
+      void RestoreImageCache();
+      // The image cache of LVGL is reduced to a single entry while the memory is under pressure
+      bool imageCacheReduced = false;
       void PushMessageToSystemTask(Pinetime::System::Messages message);
 
       Apps nextApp = Apps::None;
@@ -35,6 +35,7 @@ namespace Pinetime {
     class TimerController;
     class AlarmController;
     class BrightnessController;
+    class FS;
   }
 
   namespace System {
@@ -59,7 +60,8 @@ namespace Pinetime {
                  Pinetime::Controllers::TimerController& timerController,
                  Pinetime::Controllers::AlarmController& alarmController,
                  Pinetime::Controllers::BrightnessController& brightnessController,
-                 Pinetime::Controllers::TouchHandler& touchHandler);
+                 Pinetime::Controllers::TouchHandler& touchHandler,
+                 Pinetime::Controllers::FS& fs);
       void Start();
       void Start(Pinetime::System::BootErrors) {
         Start();
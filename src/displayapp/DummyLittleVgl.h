@@ -1,5 +1,6 @@
 #pragma once
 
+#include <FreeRTOS.h>
 #include <lvgl/src/lv_core/lv_style.h>
 #include <lvgl/src/lv_themes/lv_theme.h>
 #include <lvgl/src/lv_hal/lv_hal.h>
@@ -31,7 +32,11 @@ namespace Pinetime {
       }
       void SetNewTapEvent(uint16_t x, uint16_t y) {
       }
-      void SetNewTouchPoint(uint16_t x, uint16_t y, bool contact) {
+      void SetNewTouchPoint(uint16_t x, uint16_t y, bool contact, TickType_t timestamp) {
+      }
+      void CancelTouchPoint() {
+      }
+      void ReadTouchNow() {
       }
     };
   }
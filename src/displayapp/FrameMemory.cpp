@@ -0,0 +1,55 @@
+#include "displayapp/FrameMemory.h"
+
+using namespace Pinetime::Components;
+
+uint16_t FrameMemory::Add(uint16_t offset, int16_t lines) {
+  const int32_t result = (static_cast<int32_t>(offset) + lines) % TotalNbLines;
+  return static_cast<uint16_t>(result < 0 ? result + TotalNbLines : result);
+}
+
+bool FrameMemory::Scroll(int16_t lines, Strip& strip) {
+  if (lines == 0 || lines > MaxScrollLines || lines < -MaxScrollLines || scrollPending) {
+    return false;
+  }
+
+  if (lines > 0) {
+    strip = {static_cast<uint16_t>(VisibleNbLines - lines), VisibleNbLines - 1};
+  } else {
+    strip = {0, static_cast<uint16_t>(-lines - 1)};
+  }
+  // The strip is written in the lines that are not displayed
+  writeOffset = Add(writeOffset, lines);
+  pendingScrollOffset = Add(scrollOffset, lines);
+  scrollPending = true;
+  return true;
+}
+
+bool FrameMemory::ApplyScroll() {
+  if (!scrollPending) {
+    return false;
+  }
+  scrollOffset = pendingScrollOffset;
+  scrollPending = false;
+  return true;
+}
+
+void FrameMemory::CancelScroll() {
+  if (scrollPending) {
+    writeOffset = scrollOffset;
+    scrollPending = false;
+  }
+}
+
+void FrameMemory::Reset() {
+  writeOffset = 0;
+  scrollOffset = 0;
+  scrollPending = false;
+}
+
+void FrameMemory::MoveWriteOffset(int16_t lines) {
+  writeOffset = Add(writeOffset, lines);
+}
+
+void FrameMemory::MoveScrollOffset(int16_t lines) {
+  scrollOffset = Add(scrollOffset, lines);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Components {
+    /**
+     * Mapping of the lines of the screen to the lines of the frame memory of the ST7789, which holds 80 lines more than
+     * the screen and displays them from its vertical scroll start address.
+     *
+     * The lines of the screen are written at writeOffset in the frame memory, and the display shows the lines from
+     * scrollOffset. Scrolling the content only moves both offsets: the lines that stay on the screen are already in the
+     * frame memory, and only the strip of lines exposed by the scroll is drawn, in the lines that are not displayed. The
+     * display scrolls once the strip is complete, so that it never shows a partly drawn strip. It doesn't depend on LVGL
+     * or on the hardware.
+     */
+    class FrameMemory {
+    public:
+      static constexpr uint16_t TotalNbLines = 320;
+      static constexpr uint16_t VisibleNbLines = 240;
+      // Lines of the frame memory that are not displayed: maximum number of lines of a Scroll()
+      static constexpr uint16_t MaxScrollLines = TotalNbLines - VisibleNbLines;
+
+      // Lines of the screen, inclusive
+      struct Strip {
+        uint16_t firstLine;
+        uint16_t lastLine;
+      };
+
+      /// Line of the frame memory in which the line of the screen is written
+      uint16_t FrameLine(uint16_t line) const {
+        return (line + writeOffset) % TotalNbLines;
+      }
+
+      /// Vertical scroll start address of the display
+      uint16_t ScrollOffset() const {
+        return scrollOffset;
+      }
+
+      bool IsScrollPending() const {
+        return scrollPending;
+      }
+
+      /// Scrolls the content by lines (> 0: the content moves up), and returns the strip of lines of the screen to draw
+      /// before ApplyScroll(). Returns false if lines is 0 or larger than MaxScrollLines, or if a scroll is pending.
+      bool Scroll(int16_t lines, Strip& strip);
+      /// Once the strip is drawn: returns true if the display must scroll to ScrollOffset()
+      bool ApplyScroll();
+      /// The whole screen is redrawn: the display keeps its current scroll, and the pending one is cancelled
+      void CancelScroll();
+      /// The frame memory was drawn without the mapping, and the display scrolled back to line 0
+      void Reset();
+
+      /// Moves the lines of the screen in the frame memory, for the transitions between screens
+      void MoveWriteOffset(int16_t lines);
+      /// Moves the vertical scroll of the display, for the transitions between screens
+      void MoveScrollOffset(int16_t lines);
+
+    private:
+      static uint16_t Add(uint16_t offset, int16_t lines);
+
+      uint16_t writeOffset = 0;
+      uint16_t scrollOffset = 0;
+      // Vertical scroll of the display once the strip of the last Scroll() is drawn
+      bool scrollPending = false;
+      uint16_t pendingScrollOffset = 0;
+    };
+  }
+}
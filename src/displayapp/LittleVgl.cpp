@@ -1,16 +1,53 @@
 #include "displayapp/LittleVgl.h"
 #include "displayapp/lv_pinetime_theme.h"
+#include "libs/lv_pinetime_mem.h"
 
 #include <FreeRTOS.h>
 #include <task.h>
 //#include <projdefs.h>
 #include "drivers/Cst816s.h"
 #include "drivers/St7789.h"
+#include "logging/Trace.h"
 
 using namespace Pinetime::Components;
 
 lv_style_t* LabelBigStyle = nullptr;
 
+namespace {
+  // LVGL adds a header (lv_mem_header_t) to the size of the blocks it allocates with LV_MEM_CUSTOM
+  constexpr size_t BlockSize(size_t size) {
+    return (size + sizeof(uint32_t) + 3) & ~static_cast<size_t>(3);
+  }
+  constexpr size_t ObjectBlockSize = BlockSize(sizeof(lv_obj_t));
+  static_assert(ObjectBlockSize > 48, "The size classes must be sorted by size");
+
+  // Style properties and short texts, label and other widget data, objects. The rest of LV_MEM_SIZE (about 6KB) is
+  // the general pool.
+  constexpr LvglAllocator::SizeClasses sizeClasses {{{16, 64}, {32, 48}, {48, 40}, {ObjectBlockSize, 48}}};
+
+  alignas(alignof(void*)) uint8_t lvglMemory[LV_MEM_SIZE];
+  LvglAllocator lvglAllocator {sizeClasses, lvglMemory, sizeof(lvglMemory)};
+}
+
+namespace {
+  // Offset of a block in the LVGL memory, recorded in the trace to replay the allocations (see tools/trace/trace2alloc.py)
+  uint16_t TraceOffset(const void* data) {
+    return (data == nullptr) ? 0xffff : static_cast<uint16_t>(static_cast<const uint8_t*>(data) - lvglMemory);
+  }
+}
+
+void* lv_pinetime_mem_alloc(size_t size) {
+  Pinetime::Logging::Trace::Record(Pinetime::Logging::Trace::Events::LvglAlloc, static_cast<uint16_t>(size));
+  void* data = lvglAllocator.Allocate(size);
+  Pinetime::Logging::Trace::Record(Pinetime::Logging::Trace::Events::LvglAllocated, TraceOffset(data));
+  return data;
+}
+
+void lv_pinetime_mem_free(void* data) {
+  Pinetime::Logging::Trace::Record(Pinetime::Logging::Trace::Events::LvglFree, TraceOffset(data));
+  lvglAllocator.Free(data);
+}
+
 static void disp_flush(lv_disp_drv_t* disp_drv, const lv_area_t* area, lv_color_t* color_p) {
   auto* lvgl = static_cast<LittleVgl*>(disp_drv->user_data);
   lvgl->FlushDisplay(area, color_p);
@@ -26,6 +63,11 @@ static void rounder(lv_disp_drv_t* disp_drv, lv_area_t* area) {
   }
 }
 
+static void monitor(lv_disp_drv_t* disp_drv, uint32_t /*time*/, uint32_t /*px*/) {
+  auto* lvgl = static_cast<LittleVgl*>(disp_drv->user_data);
+  lvgl->OnRefreshDone();
+}
+
 bool touchpad_read(lv_indev_drv_t* indev_drv, lv_indev_data_t* data) {
   auto* lvgl = static_cast<LittleVgl*>(indev_drv->user_data);
   return lvgl->GetTouchPadInfo(data);
@@ -34,6 +76,10 @@ bool touchpad_read(lv_indev_drv_t* indev_drv, lv_indev_data_t* data) {
 LittleVgl::LittleVgl(Pinetime::Drivers::St7789& lcd, Pinetime::Drivers::Cst816S& touchPanel) : lcd {lcd}, touchPanel {touchPanel} {
 }
 
+LvglAllocator::Statistics LittleVgl::GetMemoryStatistics() {
+  return lvglAllocator.GetStatistics();
+}
+
 void LittleVgl::Init() {
   lv_init();
   InitTheme();
@@ -57,6 +103,7 @@ void LittleVgl::InitDisplay() {
   disp_drv.buffer = &disp_buf_2;
   disp_drv.user_data = this;
   disp_drv.rounder_cb = rounder;
+  disp_drv.monitor_cb = monitor;
 
   /*Finally register the driver*/
   lv_disp_drv_register(&disp_drv);
@@ -69,7 +116,7 @@ void LittleVgl::InitTouchpad() {
   indev_drv.type = LV_INDEV_TYPE_POINTER;
   indev_drv.read_cb = touchpad_read;
   indev_drv.user_data = this;
-  lv_indev_drv_register(&indev_drv);
+  touchInputDevice = lv_indev_drv_register(&indev_drv);
 }
 
 void LittleVgl::SetFullRefresh(FullRefreshDirections direction) {
@@ -87,24 +134,63 @@ void LittleVgl::SetFullRefresh(FullRefreshDirections direction) {
       lv_disp_set_direction(lv_disp_get_default(), 4);
     }
   }
+  // The whole screen is redrawn: the display keeps its current scroll
+  frameMemory.CancelScroll();
   fullRefresh = true;
 }
 
+bool LittleVgl::ScrollDisplay(int16_t lines) {
+  FrameMemory::Strip strip;
+  if (fullRefresh || scrollDirection != FullRefreshDirections::None || !frameMemory.Scroll(lines, strip)) {
+    return false;
+  }
+
+  // The lines that stay on the screen are already in the frame memory, at the new offset: only the strip is drawn, in
+  // the lines that are not displayed, and the display scrolls once it is complete, without tearing
+  lv_disp_t* disp = lv_disp_get_default();
+  _lv_inv_area(disp, nullptr);
+  lv_area_t area;
+  area.x1 = 0;
+  area.x2 = LV_HOR_RES - 1;
+  area.y1 = strip.firstLine;
+  area.y2 = strip.lastLine;
+  _lv_inv_area(disp, &area);
+  return true;
+}
+
+void LittleVgl::OnRefreshDone() {
+  if (!frameMemory.IsScrollPending()) {
+    return;
+  }
+  // Wait for the end of the transfer of the last lines, as the DataCommand pin cannot change during a transfer
+  ulTaskNotifyTake(pdTRUE, 200);
+  frameMemory.ApplyScroll();
+  lcd.VerticalScrollStartAddress(frameMemory.ScrollOffset());
+  // The next flush waits for this notification
+  xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+}
+
+void LittleVgl::InvalidateDisplay() {
+  frameMemory.Reset();
+  lv_obj_invalidate(lv_scr_act());
+}
+
 void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
   uint16_t y1, y2, width, height = 0;
 
+  Logging::Trace::Record(Logging::Trace::Events::FlushDisplayStart, (area->y2 - area->y1) + 1);
   ulTaskNotifyTake(pdTRUE, 200);
   // Notification is still needed (even if there is a mutex on SPI) because of the DataCommand pin
   // which cannot be set/clear during a transfer.
 
   if ((scrollDirection == LittleVgl::FullRefreshDirections::Down) && (area->y2 == visibleNbLines - 1)) {
-    writeOffset = ((writeOffset + totalNbLines) - visibleNbLines) % totalNbLines;
+    frameMemory.MoveWriteOffset(-visibleNbLines);
   } else if ((scrollDirection == FullRefreshDirections::Up) && (area->y1 == 0)) {
-    writeOffset = (writeOffset + visibleNbLines) % totalNbLines;
+    frameMemory.MoveWriteOffset(visibleNbLines);
   }
 
-  y1 = (area->y1 + writeOffset) % totalNbLines;
-  y2 = (area->y2 + writeOffset) % totalNbLines;
+  y1 = frameMemory.FrameLine(area->y1);
+  y2 = frameMemory.FrameLine(area->y2);
 
   width = (area->x2 - area->x1) + 1;
   height = (area->y2 - area->y1) + 1;
@@ -121,27 +207,21 @@ void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
         toScroll = height;
       }
 
-      if (scrollOffset >= toScroll)
-        scrollOffset -= toScroll;
-      else {
-        toScroll -= scrollOffset;
-        scrollOffset = (totalNbLines) -toScroll;
-      }
-      lcd.VerticalScrollStartAddress(scrollOffset);
+      frameMemory.MoveScrollOffset(-toScroll);
+      lcd.VerticalScrollStartAddress(frameMemory.ScrollOffset());
     }
 
   } else if (scrollDirection == FullRefreshDirections::Up) {
 
     if (area->y1 > 0) {
       if (area->y2 == visibleNbLines - 1) {
-        scrollOffset += (height * 2);
+        frameMemory.MoveScrollOffset(height * 2);
         scrollDirection = FullRefreshDirections::None;
         lv_disp_set_direction(lv_disp_get_default(), 0);
       } else {
-        scrollOffset += height;
+        frameMemory.MoveScrollOffset(height);
       }
-      scrollOffset = scrollOffset % totalNbLines;
-      lcd.VerticalScrollStartAddress(scrollOffset);
+      lcd.VerticalScrollStartAddress(frameMemory.ScrollOffset());
     }
   } else if (scrollDirection == FullRefreshDirections::Left or scrollDirection == FullRefreshDirections::LeftAnim) {
     if (area->x2 == visibleNbLines - 1) {
@@ -171,26 +251,51 @@ void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
     lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), width * height * 2);
   }
 
+  if (touchFlushPending) {
+    touchFlushPending = false;
+    touchLatency.last = xTaskGetTickCount() - touchTimestamp;
+    if (touchLatency.last > touchLatency.max) {
+      touchLatency.max = touchLatency.last;
+    }
+  }
+
   // IMPORTANT!!!
   // Inform the graphics library that you are ready with the flushing
   lv_disp_flush_ready(&disp_drv);
+  Logging::Trace::Record(Logging::Trace::Events::FlushDisplayEnd);
 }
 
-void LittleVgl::SetNewTouchPoint(uint16_t x, uint16_t y, bool contact) {
-  tap_x = x;
-  tap_y = y;
-  tapped = contact;
+void LittleVgl::SetNewTouchPoint(uint16_t x, uint16_t y, bool contact, TickType_t timestamp) {
+  touchQueue.Push(x, y, contact, timestamp);
+}
+
+void LittleVgl::CancelTouchPoint() {
+  touchQueue.Cancel();
+}
+
+void LittleVgl::ReadTouchNow() {
+  if (touchInputDevice != nullptr) {
+    lv_task_ready(touchInputDevice->driver.read_task);
+  }
 }
 
 bool LittleVgl::GetTouchPadInfo(lv_indev_data_t* ptr) {
-  ptr->point.x = tap_x;
-  ptr->point.y = tap_y;
-  if (tapped) {
+  TickType_t timestamp;
+  if (touchQueue.Read(timestamp) && !touchFlushPending) {
+    touchTimestamp = timestamp;
+    touchFlushPending = true;
+  }
+
+  const auto& point = touchQueue.Current();
+  ptr->point.x = point.x;
+  ptr->point.y = point.y;
+  if (point.pressed) {
     ptr->state = LV_INDEV_STATE_PR;
   } else {
     ptr->state = LV_INDEV_STATE_REL;
   }
-  return false;
+  // Let LVGL process all the buffered points in the same read
+  return !touchQueue.Empty();
 }
 
 void LittleVgl::InitTheme() {
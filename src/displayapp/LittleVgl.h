@@ -1,6 +1,11 @@
 #pragma once
 
+#include <cstdint>
+#include <FreeRTOS.h>
 #include <lvgl/lvgl.h>
+#include "displayapp/FrameMemory.h"
+#include "displayapp/LvglAllocator.h"
+#include "displayapp/TouchQueue.h"
 
 namespace Pinetime {
   namespace Drivers {
@@ -12,6 +17,16 @@ namespace Pinetime {
     class LittleVgl {
     public:
       enum class FullRefreshDirections { None, Up, Down, Left, Right, LeftAnim, RightAnim };
+      // Time between a touch interrupt and the first flush of the display after LVGL processed the touch point
+      struct TouchLatency {
+        TickType_t last = 0;
+        TickType_t max = 0;
+      };
+      static constexpr uint16_t totalNbLines = FrameMemory::TotalNbLines;
+      static constexpr uint16_t visibleNbLines = FrameMemory::VisibleNbLines;
+      // Lines of the frame memory that are not displayed: maximum number of lines of a ScrollDisplay()
+      static constexpr uint16_t MaxScrollLines = FrameMemory::MaxScrollLines;
+
       LittleVgl(Pinetime::Drivers::St7789& lcd, Pinetime::Drivers::Cst816S& touchPanel);
 
       LittleVgl(const LittleVgl&) = delete;
@@ -24,7 +39,31 @@ namespace Pinetime {
       void FlushDisplay(const lv_area_t* area, lv_color_t* color_p);
       bool GetTouchPadInfo(lv_indev_data_t* ptr);
       void SetFullRefresh(FullRefreshDirections direction);
-      void SetNewTouchPoint(uint16_t x, uint16_t y, bool contact);
+      /// Scrolls the whole screen by lines (> 0: the content moves up) with the vertical scroll of the display: only the
+      /// strip of lines exposed by the scroll is drawn, in the lines of the frame memory that are not displayed, then the
+      /// display scrolls at the end of the refresh. Must be called right after the content moved, with nothing else to
+      /// draw. Returns false if the screen can't be scrolled now: LVGL then redraws the whole screen.
+      bool ScrollDisplay(int16_t lines);
+      /// Called by LVGL at the end of each refresh
+      void OnRefreshDone();
+      /// The frame memory was drawn without LVGL and the display scrolled back to line 0: redraws the whole screen
+      void InvalidateDisplay();
+      /// Queues a touch point for the input device of LVGL. timestamp is the time of the touch interrupt.
+      /// Must only be called from the task that reads the touch panel.
+      void SetNewTouchPoint(uint16_t x, uint16_t y, bool contact, TickType_t timestamp);
+      /// Cancels the current touch: LVGL sees it out of the screen until the finger is lifted. Must only be called from the
+      /// display task.
+      void CancelTouchPoint();
+      /// Makes the next lv_task_handler() read the input device instead of waiting for the next read period
+      void ReadTouchNow();
+
+      TouchLatency GetTouchLatency() const {
+        return touchLatency;
+      }
+
+      /// Statistics of the memory of LVGL, allocated by LvglAllocator. lv_mem_monitor() doesn't know the memory of
+      /// LV_MEM_CUSTOM.
+      static LvglAllocator::Statistics GetMemoryStatistics();
 
       bool GetFullRefresh() {
         bool returnValue = fullRefresh;
@@ -50,18 +89,19 @@ namespace Pinetime {
 
       bool fullRefresh = false;
       static constexpr uint8_t nbWriteLines = 4;
-      static constexpr uint16_t totalNbLines = 320;
-      static constexpr uint16_t visibleNbLines = 240;
       static constexpr uint8_t MaxScrollOffset() {
         return LV_VER_RES_MAX - nbWriteLines;
       }
       FullRefreshDirections scrollDirection = FullRefreshDirections::None;
-      uint16_t writeOffset = 0;
-      uint16_t scrollOffset = 0;
+      FrameMemory frameMemory;
+
+      TouchQueue touchQueue;
+      lv_indev_t* touchInputDevice = nullptr;
 
-      uint16_t tap_x = 0;
-      uint16_t tap_y = 0;
-      bool tapped = false;
+      // Timestamp of the last touch point read by LVGL, not flushed yet
+      TickType_t touchTimestamp = 0;
+      bool touchFlushPending = false;
+      TouchLatency touchLatency;
     };
   }
 }
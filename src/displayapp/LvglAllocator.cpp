@@ -0,0 +1,161 @@
+#include "displayapp/LvglAllocator.h"
+#include <algorithm>
+
+using namespace Pinetime::Components;
+
+LvglAllocator::LvglAllocator(const SizeClasses& sizeClasses, uint8_t* memory, size_t size) {
+  uint8_t* end = memory + size;
+  for (size_t i = 0; i < NbClasses; i++) {
+    Slab& slab = slabs[i];
+    slab.statistics.blockSize = sizeClasses[i].blockSize;
+    const size_t slabSize = std::min<size_t>(sizeClasses[i].blockSize * sizeClasses[i].nbBlocks, end - memory);
+    slab.statistics.nbBlocks = static_cast<uint16_t>(slabSize / sizeClasses[i].blockSize);
+    slab.begin = memory;
+    slab.end = memory + slab.statistics.nbBlocks * sizeClasses[i].blockSize;
+    memory = slab.end;
+
+    // The free list follows the order of the blocks
+    for (uint8_t* block = slab.end; block > slab.begin;) {
+      block -= slab.statistics.blockSize;
+      auto* freeBlock = reinterpret_cast<FreeBlock*>(block);
+      freeBlock->next = slab.freeBlocks;
+      slab.freeBlocks = freeBlock;
+    }
+  }
+
+  poolBegin = memory;
+  poolEnd = memory + ((end - memory) & ~(Alignment - 1));
+  if (static_cast<size_t>(poolEnd - poolBegin) >= sizeof(PoolBlock)) {
+    poolFreeBlocks = reinterpret_cast<PoolBlock*>(poolBegin);
+    poolFreeBlocks->size = static_cast<uint32_t>(poolEnd - poolBegin);
+    poolFreeBlocks->next = nullptr;
+  } else {
+    poolEnd = poolBegin;
+  }
+}
+
+void* LvglAllocator::Allocate(size_t size) {
+  // The smallest class that fits, then the general pool, then the larger classes
+  size_t first = 0;
+  while (first < NbClasses && slabs[first].statistics.blockSize < size) {
+    first++;
+  }
+  if (first < NbClasses) {
+    if (void* data = AllocateFromSlab(slabs[first])) {
+      return data;
+    }
+    slabs[first].statistics.nbOverflows++;
+  }
+  if (void* data = AllocateFromPool(size)) {
+    return data;
+  }
+  for (size_t i = first + 1; i < NbClasses; i++) {
+    if (void* data = AllocateFromSlab(slabs[i])) {
+      return data;
+    }
+  }
+  nbFailures++;
+  return nullptr;
+}
+
+void LvglAllocator::Free(void* data) {
+  auto* block = static_cast<uint8_t*>(data);
+  if (block == nullptr) {
+    return;
+  }
+  for (auto& slab : slabs) {
+    if (block >= slab.begin && block < slab.end) {
+      auto* freeBlock = reinterpret_cast<FreeBlock*>(block);
+      freeBlock->next = slab.freeBlocks;
+      slab.freeBlocks = freeBlock;
+      slab.statistics.used--;
+      return;
+    }
+  }
+  if (block >= poolBegin && block < poolEnd) {
+    FreeToPool(block);
+  }
+}
+
+LvglAllocator::Statistics LvglAllocator::GetStatistics() const {
+  Statistics statistics;
+  for (size_t i = 0; i < NbClasses; i++) {
+    statistics.classes[i] = slabs[i].statistics;
+  }
+  statistics.poolSize = static_cast<uint32_t>(poolEnd - poolBegin);
+  statistics.poolMaxUsed = poolMaxUsed;
+  statistics.nbFailures = nbFailures;
+  for (const PoolBlock* block = poolFreeBlocks; block != nullptr; block = block->next) {
+    statistics.poolFree += block->size;
+    statistics.poolBiggestFree = std::max(statistics.poolBiggestFree, block->size);
+    statistics.poolNbFreeBlocks++;
+  }
+  if (statistics.poolFree > 0) {
+    statistics.poolFragmentationPercent = static_cast<uint8_t>(100 - statistics.poolBiggestFree * 100 / statistics.poolFree);
+  }
+  return statistics;
+}
+
+void* LvglAllocator::AllocateFromSlab(Slab& slab) {
+  FreeBlock* block = slab.freeBlocks;
+  if (block == nullptr) {
+    return nullptr;
+  }
+  slab.freeBlocks = block->next;
+  slab.statistics.used++;
+  slab.statistics.maxUsed = std::max(slab.statistics.maxUsed, slab.statistics.used);
+  return block;
+}
+
+void* LvglAllocator::AllocateFromPool(size_t size) {
+  const size_t needed = std::max(Align(size + HeaderSize), sizeof(PoolBlock));
+  PoolBlock** link = &poolFreeBlocks;
+  for (PoolBlock* block = poolFreeBlocks; block != nullptr; link = &block->next, block = block->next) {
+    if (block->size < needed) {
+      continue;
+    }
+    if (block->size - needed >= sizeof(PoolBlock)) {
+      // The end of the block stays free
+      auto* rest = reinterpret_cast<PoolBlock*>(reinterpret_cast<uint8_t*>(block) + needed);
+      rest->size = static_cast<uint32_t>(block->size - needed);
+      rest->next = block->next;
+      block->size = static_cast<uint32_t>(needed);
+      *link = rest;
+    } else {
+      *link = block->next;
+    }
+    poolUsed += block->size;
+    poolMaxUsed = std::max(poolMaxUsed, poolUsed);
+    return reinterpret_cast<uint8_t*>(block) + HeaderSize;
+  }
+  return nullptr;
+}
+
+void LvglAllocator::FreeToPool(uint8_t* data) {
+  auto* block = reinterpret_cast<PoolBlock*>(data - HeaderSize);
+  poolUsed -= block->size;
+
+  // The free blocks are sorted by address, so that a freed block is merged with its free neighbours
+  PoolBlock* previous = nullptr;
+  PoolBlock* next = poolFreeBlocks;
+  while (next != nullptr && next < block) {
+    previous = next;
+    next = next->next;
+  }
+
+  if (next != nullptr && reinterpret_cast<uint8_t*>(block) + block->size == reinterpret_cast<uint8_t*>(next)) {
+    block->size += next->size;
+    block->next = next->next;
+  } else {
+    block->next = next;
+  }
+
+  if (previous != nullptr && reinterpret_cast<uint8_t*>(previous) + previous->size == reinterpret_cast<uint8_t*>(block)) {
+    previous->size += block->size;
+    previous->next = block->next;
+  } else if (previous != nullptr) {
+    previous->next = block;
+  } else {
+    poolFreeBlocks = block;
+  }
+}
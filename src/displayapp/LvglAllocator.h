@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Components {
+    /**
+     * Allocator of the memory of LVGL (LV_MEM_CUSTOM): pools of fixed-size blocks for the common sizes, and a general
+     * first-fit pool for the other allocations.
+     *
+     * The built-in allocator of LVGL puts all the objects, style lists and texts in a single first-fit pool: after a
+     * while of switching apps, the small blocks left between long-lived ones leave plenty of free memory but no large
+     * free block. Here the small allocations (objects, label and style data) are taken from the block pool of their size
+     * class, that can't fragment, and only the larger or unusual ones from the general pool. A full size class
+     * overflows into the general pool, and the general pool into the larger classes. It doesn't depend on LVGL.
+     */
+    class LvglAllocator {
+    public:
+      struct SizeClass {
+        // Multiple of the alignment of a pointer
+        uint16_t blockSize;
+        uint16_t nbBlocks;
+      };
+      static constexpr size_t NbClasses = 4;
+      using SizeClasses = std::array<SizeClass, NbClasses>;
+
+      struct ClassStatistics {
+        uint16_t blockSize = 0;
+        uint16_t nbBlocks = 0;
+        uint16_t used = 0;
+        uint16_t maxUsed = 0;
+        // Allocations of this class taken from another pool because it was full
+        uint32_t nbOverflows = 0;
+      };
+
+      struct Statistics {
+        std::array<ClassStatistics, NbClasses> classes;
+        uint32_t poolSize = 0;
+        uint32_t poolFree = 0;
+        uint32_t poolBiggestFree = 0;
+        uint32_t poolMaxUsed = 0;
+        uint16_t poolNbFreeBlocks = 0;
+        // 0 when the free memory of the general pool is a single block
+        uint8_t poolFragmentationPercent = 0;
+        uint32_t nbFailures = 0;
+      };
+
+      /// The blocks of the classes (by increasing size) are taken from the start of memory, the rest is the general pool.
+      /// memory must be aligned for a pointer.
+      LvglAllocator(const SizeClasses& sizeClasses, uint8_t* memory, size_t size);
+      LvglAllocator(const LvglAllocator&) = delete;
+      LvglAllocator& operator=(const LvglAllocator&) = delete;
+
+      /// Returns nullptr if no pool has room for size bytes
+      void* Allocate(size_t size);
+      void Free(void* data);
+
+      Statistics GetStatistics() const;
+
+    private:
+      struct FreeBlock {
+        FreeBlock* next;
+      };
+
+      struct Slab {
+        uint8_t* begin = nullptr;
+        uint8_t* end = nullptr;
+        FreeBlock* freeBlocks = nullptr;
+        ClassStatistics statistics;
+      };
+
+      // Block of the general pool: the size (header included) is the header of the allocated blocks
+      struct PoolBlock {
+        uint32_t size;
+        PoolBlock* next;
+      };
+      static constexpr size_t Alignment = alignof(PoolBlock*);
+      static constexpr size_t HeaderSize = Alignment;
+      static_assert(sizeof(uint32_t) <= HeaderSize, "The size doesn't fit in the header of a block");
+
+      static constexpr size_t Align(size_t size) {
+        return (size + Alignment - 1) & ~(Alignment - 1);
+      }
+
+      void* AllocateFromSlab(Slab& slab);
+      void* AllocateFromPool(size_t size);
+      void FreeToPool(uint8_t* data);
+
+      std::array<Slab, NbClasses> slabs;
+      uint8_t* poolBegin = nullptr;
+      uint8_t* poolEnd = nullptr;
+      PoolBlock* poolFreeBlocks = nullptr;
+      uint32_t poolUsed = 0;
+      uint32_t poolMaxUsed = 0;
+      uint32_t nbFailures = 0;
+    };
+  }
+}
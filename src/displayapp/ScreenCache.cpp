@@ -0,0 +1,75 @@
+#include "displayapp/ScreenCache.h"
+
+using namespace Pinetime::Applications;
+
+ScreenCache::~ScreenCache() {
+  Clear();
+}
+
+void ScreenCache::Retain(Apps app, std::unique_ptr<Screens::Screen> screen) {
+  // Replaces the least recently kept screen if the cache is full
+  Entry* slot = &entries[0];
+  for (auto& entry : entries) {
+    if (entry.screen == nullptr) {
+      slot = &entry;
+      break;
+    }
+    if (entry.lastUse < slot->lastUse) {
+      slot = &entry;
+    }
+  }
+  if (slot->screen != nullptr) {
+    Delete(*slot);
+  }
+
+  screen->OnHide();
+  slot->app = Key(app);
+  slot->screen = std::move(screen);
+  slot->lvScreen = lv_scr_act();
+  slot->lastUse = ++useCounter;
+  lv_scr_load(lv_obj_create(nullptr, nullptr));
+}
+
+std::unique_ptr<Screens::Screen> ScreenCache::Take(Apps app) {
+  app = Key(app);
+  for (auto& entry : entries) {
+    if (entry.screen != nullptr && entry.app == app) {
+      // The LVGL screen of the previous app is empty: it was deleted, or kept with its own LVGL screen
+      lv_obj_t* emptyScreen = lv_scr_act();
+      lv_scr_load(entry.lvScreen);
+      lv_obj_del(emptyScreen);
+      entry.lvScreen = nullptr;
+      entry.screen->OnShow();
+      return std::move(entry.screen);
+    }
+  }
+  return nullptr;
+}
+
+void ScreenCache::Clear() {
+  for (auto& entry : entries) {
+    if (entry.screen != nullptr) {
+      Delete(entry);
+    }
+  }
+}
+
+size_t ScreenCache::Size() const {
+  size_t size = 0;
+  for (const auto& entry : entries) {
+    if (entry.screen != nullptr) {
+      size++;
+    }
+  }
+  return size;
+}
+
+void ScreenCache::Delete(Entry& entry) {
+  // The destructors of the screens clean lv_scr_act()
+  lv_obj_t* activeScreen = lv_scr_act();
+  lv_scr_load(entry.lvScreen);
+  entry.screen.reset(nullptr);
+  lv_scr_load(activeScreen);
+  lv_obj_del(entry.lvScreen);
+  entry.lvScreen = nullptr;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <lvgl/lvgl.h>
+#include "displayapp/Apps.h"
+#include "displayapp/screens/Screen.h"
+
+namespace Pinetime {
+  namespace Applications {
+    /**
+     * Screens kept with their LVGL objects, each on its own LVGL screen, while another app is displayed (the watch face,
+     * and possibly the last retainable app), and the SaveState() of the last screen of each app. DisplayApp decides which
+     * screens are kept, from their IsRetainable() and from the free LVGL memory.
+     */
+    class ScreenCache {
+    public:
+      static constexpr size_t MaxScreens = 2;
+      // Biggest free block of the general pool of the LVGL memory needed to keep a screen: the objects of the next app
+      // are mostly in the block pools, its texts and buffers in what is left of the general pool. In the replay of
+      // LvglAllocatorTest, the hungriest app takes about 0.8KB of the general pool, and the draw buffers of LVGL 1.2KB
+      // more if the app is the first to need them: 3KB leaves a margin for longer texts and larger widgets. With the
+      // watch face kept, at least 4.8KB are left when an app is opened.
+      static constexpr size_t MinFreeMemory = 3 * 1024;
+
+      ScreenCache() = default;
+      ScreenCache(const ScreenCache&) = delete;
+      ScreenCache& operator=(const ScreenCache&) = delete;
+      ~ScreenCache();
+
+      /// Keeps the screen of app, displayed on lv_scr_act(), in place of the least recently kept one if the cache is
+      /// full. The screen is hidden, and the next app creates its objects on a new LVGL screen.
+      void Retain(Apps app, std::unique_ptr<Screens::Screen> screen);
+      /// Returns the kept screen of app, or nullptr. Its LVGL screen is loaded, the current one (empty) is deleted, and
+      /// the screen is shown again.
+      std::unique_ptr<Screens::Screen> Take(Apps app);
+      /// Deletes the kept screens
+      void Clear();
+      size_t Size() const;
+
+      void SaveState(Apps app, uint32_t state) {
+        states[static_cast<size_t>(app)] = state;
+      }
+      uint32_t GetState(Apps app) const {
+        return states[static_cast<size_t>(app)];
+      }
+
+    private:
+      struct Entry {
+        Apps app = Apps::None;
+        std::unique_ptr<Screens::Screen> screen;
+        lv_obj_t* lvScreen = nullptr;
+        uint32_t lastUse = 0;
+      };
+
+      // The clock is displayed at start-up as Apps::None
+      static Apps Key(Apps app) {
+        return (app == Apps::None) ? Apps::Clock : app;
+      }
+      static void Delete(Entry& entry);
+
+      std::array<Entry, MaxScreens> entries;
+      uint32_t useCounter = 0;
+      std::array<uint32_t, static_cast<size_t>(Apps::Error) + 1> states {};
+    };
+  }
+}
@@ -0,0 +1,48 @@
+#include "displayapp/TouchQueue.h"
+
+using namespace Pinetime::Components;
+
+void TouchQueue::Push(uint16_t x, uint16_t y, bool contact, TickType_t timestamp) {
+  lastPoint = Pack(x, y, contact);
+  // If LVGL doesn't keep up, the intermediate points are dropped but the last one is still read from lastPoint
+  samples.Push({x, y, contact, timestamp});
+}
+
+void TouchQueue::Cancel() {
+  Sample sample;
+  while (samples.Pop(sample)) {
+  }
+  // Otherwise the next Read() would jump back to the last point written before the cancellation
+  const uint32_t point = lastPoint;
+  lastReadPoint = point;
+  cancelled = HasContact(point);
+  current = {static_cast<uint16_t>(-1), static_cast<uint16_t>(-1), cancelled};
+}
+
+bool TouchQueue::Read(TickType_t& timestamp) {
+  Sample sample;
+  if (samples.Pop(sample)) {
+    lastReadPoint = Pack(sample.x, sample.y, sample.contact);
+    timestamp = sample.timestamp;
+    Apply(sample.x, sample.y, sample.contact);
+    return true;
+  }
+
+  const uint32_t point = lastPoint;
+  if (point != lastReadPoint) {
+    // Some points were dropped: jump to the last one
+    lastReadPoint = point;
+    Apply(Unpack(point), Unpack(point >> 15), HasContact(point));
+  }
+  return false;
+}
+
+void TouchQueue::Apply(uint16_t x, uint16_t y, bool contact) {
+  if (cancelled) {
+    // Stay out of the screen until the finger is lifted
+    cancelled = contact;
+    current.pressed = contact;
+    return;
+  }
+  current = {x, y, contact};
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <FreeRTOS.h>
+#include "utility/SpscRingBuffer.h"
+
+namespace Pinetime {
+  namespace Components {
+    /**
+     * Touch points written by the system task and read by the input device of LVGL in the display task, so that a
+     * short tap isn't lost between 2 reads of the input device. It doesn't depend on LVGL.
+     *
+     * A cancelled touch (a gesture was recognized) is seen by LVGL as a press out of the screen, until the finger is
+     * lifted, then as a release out of the screen: the object under the finger never receives a click.
+     */
+    class TouchQueue {
+    public:
+      // State of the input device of LVGL. x and y are -1 (65535) for a point out of the screen.
+      struct Point {
+        uint16_t x = 0;
+        uint16_t y = 0;
+        bool pressed = false;
+      };
+
+      /// Queues a touch point. Must only be called from the task that reads the touch panel.
+      void Push(uint16_t x, uint16_t y, bool contact, TickType_t timestamp);
+      /// Cancels the current touch. Must only be called from the task that reads the queue.
+      void Cancel();
+      /// Updates Current() with the next point. Returns true if it was read from the queue, with the time of its touch
+      /// interrupt in timestamp.
+      bool Read(TickType_t& timestamp);
+
+      const Point& Current() const {
+        return current;
+      }
+      bool Empty() const {
+        return samples.Empty();
+      }
+
+    private:
+      struct Sample {
+        uint16_t x;
+        uint16_t y;
+        bool contact;
+        TickType_t timestamp;
+      };
+      void Apply(uint16_t x, uint16_t y, bool contact);
+
+      static constexpr uint32_t Pack(uint16_t x, uint16_t y, bool contact) {
+        return (x & 0x7fffu) | ((y & 0x7fffu) << 15) | (contact ? (1u << 30) : 0);
+      }
+      static constexpr uint16_t Unpack(uint32_t coordinate) {
+        return ((coordinate & 0x7fffu) == 0x7fffu) ? static_cast<uint16_t>(-1) : static_cast<uint16_t>(coordinate & 0x7fffu);
+      }
+      static constexpr bool HasContact(uint32_t point) {
+        return (point & (1u << 30)) != 0;
+      }
+
+      Utility::SpscRingBuffer<Sample, 8> samples;
+      // Last touch point written, packed, in case it didn't fit in samples
+      std::atomic<uint32_t> lastPoint {0};
+      uint32_t lastReadPoint = 0;
+      // The current touch was cancelled and the finger is still on the screen
+      bool cancelled = false;
+      Point current;
+    };
+  }
+}
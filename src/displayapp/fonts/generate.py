@@ -1,10 +1,13 @@
 #!/usr/bin/env python
 
 import io
+import re
 import sys
 import json
 import shutil
+import struct
 import typing
+import zlib
 import os.path
 import argparse
 import subprocess
@@ -18,10 +21,12 @@ class Source(object):
         self.symbols = d.get('symbols')
 
 
-def gen_lvconv_line(lv_font_conv: str, dest: str, size: int, bpp: int, sources: typing.List[Source], compress:bool=False):
+def gen_lvconv_line(lv_font_conv: str, dest: str, size: int, bpp: int, sources: typing.List[Source], compress:bool=False, kerning:bool=True):
     args = [lv_font_conv, '--size', str(size), '--output', dest, '--bpp', str(bpp), '--format', 'lvgl']
     if not compress:
         args.append('--no-compress')
+    if not kerning:
+        args.append('--no-kerning')
     for source in sources:
         args.extend(['--font', source.file])
         if source.range:
@@ -31,11 +36,120 @@ def gen_lvconv_line(lv_font_conv: str, dest: str, size: int, bpp: int, sources:
 
     return args
 
+# Pack of the external fonts, read by src/components/fonts/FontStore.cpp. All the fields are little-endian.
+PACK_MAGIC = 0x4E465450 # "PTFN"
+PACK_VERSION = 1
+PACK_NAME_SIZE = 40
+# magic, version, number of fonts, CRC32 of the rest of the file, reserved
+PACK_HEADER = struct.Struct('<IHHII')
+# name, line height, base line, underline position, underline thickness, bpp, reserved, offset of the index, number of glyphs
+PACK_FONT = struct.Struct(f'<{PACK_NAME_SIZE}shhbBBBII')
+# code point, offset of the glyph; sorted by code point
+PACK_INDEX = struct.Struct('<II')
+# advance width (1/16 pixel), box width, box height, x offset, y offset, size of the bitmap that follows
+PACK_GLYPH = struct.Struct('<HHHhhH')
+
+CMAP_FORMATS = ('LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL', 'LV_FONT_FMT_TXT_CMAP_SPARSE_FULL',
+                'LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY', 'LV_FONT_FMT_TXT_CMAP_SPARSE_TINY')
+
+
+def parse_c_array(text: str, name: str) -> typing.List[int]:
+    match = re.search(name + r'\[\]\s*=\s*\{(.*?)\};', text, re.S)
+    if not match:
+        return []
+    body = re.sub(r'/\*.*?\*/', '', match.group(1), flags=re.S)
+    return [int(value, 0) for value in re.findall(r'-?(?:0x[0-9a-fA-F]+|\d+)', body)]
+
+
+def parse_lvgl_font(path: str) -> dict:
+    """Reads the metrics and the glyphs of a font generated by lv_font_conv (lvgl format, not compressed)."""
+    with open(path, 'r') as fd:
+        text = fd.read()
+
+    def field(name):
+        match = re.search(r'\.' + name + r'\s*=\s*(-?\d+)', text)
+        if not match:
+            sys.exit(f'Error: {path}: no {name}')
+        return int(match.group(1))
+
+    if field('bitmap_format') != 0:
+        sys.exit(f'Error: {path}: compressed fonts can not be packed')
+    bitmap = bytes(parse_c_array(text, r'(?:glyph|gylph)_bitmap'))
+    # The fields of the reserved glyph 0 are not in the same order as the others
+    dsc_array = re.search(r'glyph_dsc\[\]\s*=\s*\{(.*?)\};', text, re.S)
+    glyph_dscs = []
+    for dsc in re.findall(r'\{([^{}]*)\}', dsc_array.group(1) if dsc_array else ''):
+        values = dict(re.findall(r'\.(\w+)\s*=\s*(-?\d+)', dsc))
+        glyph_dscs.append(tuple(int(values[f]) for f in ('bitmap_index', 'adv_w', 'box_w', 'box_h', 'ofs_x', 'ofs_y')))
+
+    cmap_pattern = r'\.range_start\s*=\s*(\d+),\s*\.range_length\s*=\s*(\d+),\s*\.glyph_id_start\s*=\s*(\d+),' \
+                   r'\s*\.unicode_list\s*=\s*(\w+),\s*\.glyph_id_ofs_list\s*=\s*(\w+),\s*\.list_length\s*=\s*(\d+),' \
+                   r'\s*\.type\s*=\s*(\w+)'
+    glyph_ids = {}
+    for start, length, first_id, unicode_list, ofs_list, list_length, kind in re.findall(cmap_pattern, text):
+        start, length, first_id = int(start), int(length), int(first_id)
+        codes = parse_c_array(text, unicode_list) if unicode_list != 'NULL' else []
+        offsets = parse_c_array(text, ofs_list) if ofs_list != 'NULL' else []
+        if kind == CMAP_FORMATS[0]:
+            pairs = [(start + i, first_id + offset) for i, offset in enumerate(offsets) if offset or i == 0]
+        elif kind == CMAP_FORMATS[1]:
+            pairs = [(start + code, first_id + offsets[i]) for i, code in enumerate(codes)]
+        elif kind == CMAP_FORMATS[2]:
+            pairs = [(start + i, first_id + i) for i in range(length)]
+        elif kind == CMAP_FORMATS[3]:
+            pairs = [(start + code, first_id + i) for i, code in enumerate(codes)]
+        else:
+            sys.exit(f'Error: {path}: unknown cmap type {kind}')
+        glyph_ids.update(pairs)
+
+    bpp = field('bpp')
+    glyphs = []
+    for code_point, glyph_id in sorted(glyph_ids.items()):
+        bitmap_index, adv_w, box_w, box_h, ofs_x, ofs_y = glyph_dscs[glyph_id]
+        size = (box_w * box_h * bpp + 7) // 8
+        glyphs.append((code_point, adv_w, box_w, box_h, ofs_x, ofs_y, bitmap[bitmap_index:bitmap_index + size]))
+
+    return {
+        'line_height': field('line_height'),
+        'base_line': field('base_line'),
+        'underline_position': field('underline_position'),
+        'underline_thickness': field('underline_thickness'),
+        'bpp': bpp,
+        'glyphs': glyphs,
+    }
+
+
+def pack_fonts(fonts: typing.Dict[str, dict], dest: str):
+    """Writes the pack of the external fonts: header, fonts, then the index and the glyphs of each font."""
+    entries, data = b'', b''
+    offset = PACK_HEADER.size + PACK_FONT.size * len(fonts)
+    for name, font in sorted(fonts.items()):
+        if len(name) > PACK_NAME_SIZE:
+            sys.exit(f'Error: the name of the external font {name} is longer than {PACK_NAME_SIZE} characters')
+        glyphs = font['glyphs']
+        index_offset = offset + len(data)
+        # The glyphs are stored in the order of their code points: the glyphs of a string are often next to each other
+        glyph_offset = index_offset + PACK_INDEX.size * len(glyphs)
+        index, records = b'', b''
+        for code_point, adv_w, box_w, box_h, ofs_x, ofs_y, bitmap in glyphs:
+            index += PACK_INDEX.pack(code_point, glyph_offset + len(records))
+            records += PACK_GLYPH.pack(adv_w, box_w, box_h, ofs_x, ofs_y, len(bitmap)) + bitmap
+        entries += PACK_FONT.pack(name.encode(), font['line_height'], font['base_line'], font['underline_position'],
+                                  font['underline_thickness'], font['bpp'], 0, index_offset, len(glyphs))
+        data += index + records
+
+    content = entries + data
+    with open(dest, 'wb') as fd:
+        fd.write(PACK_HEADER.pack(PACK_MAGIC, PACK_VERSION, len(fonts), zlib.crc32(content), 0) + content)
+    print(f'{len(fonts)} external fonts packed to {dest}: {PACK_HEADER.size + len(content)} bytes')
+
+
 def main():
     ap = argparse.ArgumentParser(description='auto generate LVGL font files from fonts')
     ap.add_argument('config', type=str, help='config file to use')
     ap.add_argument('-f', '--font', type=str, action='append', help='Choose specific fonts to generate (default: all)', default=[])
     ap.add_argument('--lv-font-conv', type=str, help='Path to "lv_font_conf" executable', default="lv_font_conv")
+    ap.add_argument('--pack', type=str, help='Pack the external fonts into this file instead of generating the C files of the fonts')
     args = ap.parse_args()
 
     if not shutil.which(args.lv_font_conv):
@@ -58,16 +172,30 @@ def main():
             print(f'Warning: requested font{"s" if len(d)>1 else ""} missing: {" ".join(d)}')
         fonts_to_run = fonts_to_run.intersection(enabled_fonts)
 
+    if args.pack:
+        fonts_to_run = {name for name in fonts_to_run if data[name].get('external', False)}
+
+    packed_fonts = {}
     for name in fonts_to_run:
         font = data[name]
         sources = font.pop('sources')
         patches = font.pop('patches') if 'patches' in font else  []
+        font.pop('external', None)
         font['sources'] = [Source(thing) for thing in sources]
+        if args.pack:
+            # The glyphs are read one by one from the external flash: no compression, no kerning
+            font['compress'] = False
+            font['kerning'] = False
         line = gen_lvconv_line(args.lv_font_conv, f'{name}.c', **font)
         subprocess.check_call(line)
         if patches:
             for patch in patches:
                 subprocess.check_call(['/usr/bin/env', 'patch', name+'.c', patch])
+        if args.pack:
+            packed_fonts[name] = parse_lvgl_font(f'{name}.c')
+
+    if args.pack:
+        pack_fonts(packed_fonts, args.pack)
 
 
 
@@ -1,34 +1,19 @@
 #include "displayapp/screens/ApplicationList.h"
 #include <lvgl/lvgl.h>
-#include <functional>
 #include "displayapp/Apps.h"
 #include "displayapp/DisplayApp.h"
 
 using namespace Pinetime::Applications::Screens;
 
-constexpr std::array<Tile::Applications, ApplicationList::applications.size()> ApplicationList::applications;
-
-auto ApplicationList::CreateScreenList() const {
-  std::array<std::function<std::unique_ptr<Screen>()>, nScreens> screens;
-  for (size_t i = 0; i < screens.size(); i++) {
-    screens[i] = [this, i]() -> std::unique_ptr<Screen> {
-      return CreateScreen(i);
-    };
-  }
-  return screens;
-}
+constexpr std::array<Tile::Applications, Tile::maxApps> ApplicationList::applications;
 
 ApplicationList::ApplicationList(Pinetime::Applications::DisplayApp* app,
+                                 Pinetime::Components::LittleVgl& lvgl,
                                  Pinetime::Controllers::Settings& settingsController,
                                  Pinetime::Controllers::Battery& batteryController,
                                  Pinetime::Controllers::Ble& bleController,
                                  Controllers::DateTime& dateTimeController)
-  : Screen(app),
-    settingsController {settingsController},
-    batteryController {batteryController},
-    bleController {bleController},
-    dateTimeController {dateTimeController},
-    screens {app, settingsController.GetAppMenu(), CreateScreenList(), Screens::ScreenListModes::UpDown} {
+  : Screen(app), tile {app, lvgl, settingsController, batteryController, bleController, dateTimeController, applications} {
 }
 
 ApplicationList::~ApplicationList() {
@@ -36,21 +21,9 @@ ApplicationList::~ApplicationList() {
 }
 
 bool ApplicationList::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
-  return screens.OnTouchEvent(event);
+  return tile.OnTouchEvent(event);
 }
 
-std::unique_ptr<Screen> ApplicationList::CreateScreen(unsigned int screenNum) const {
-  std::array<Tile::Applications, appsPerScreen> apps;
-  for (int i = 0; i < appsPerScreen; i++) {
-    apps[i] = applications[screenNum * appsPerScreen + i];
-  }
-
-  return std::make_unique<Screens::Tile>(screenNum,
-                                         nScreens,
-                                         app,
-                                         settingsController,
-                                         batteryController,
-                                         bleController,
-                                         dateTimeController,
-                                         apps);
+bool ApplicationList::OnDragEvent(uint16_t x, uint16_t y, bool touching) {
+  return tile.OnDragEvent(x, y, touching);
 }
@@ -4,7 +4,6 @@
 #include <memory>
 
 #include "displayapp/screens/Screen.h"
-#include "displayapp/screens/ScreenList.h"
 #include "components/datetime/DateTimeController.h"
 #include "components/settings/Settings.h"
 #include "components/battery/BatteryController.h"
@@ -17,35 +16,24 @@ namespace Pinetime {
       class ApplicationList : public Screen {
       public:
         explicit ApplicationList(DisplayApp* app,
+                                 Pinetime::Components::LittleVgl& lvgl,
                                  Pinetime::Controllers::Settings& settingsController,
                                  Pinetime::Controllers::Battery& batteryController,
                                  Pinetime::Controllers::Ble& bleController,
                                  Controllers::DateTime& dateTimeController);
         ~ApplicationList() override;
         bool OnTouchEvent(TouchEvents event) override;
+        bool OnDragEvent(uint16_t x, uint16_t y, bool touching) override;
 
       private:
-        auto CreateScreenList() const;
-        std::unique_ptr<Screen> CreateScreen(unsigned int screenNum) const;
-
-        Controllers::Settings& settingsController;
-        Pinetime::Controllers::Battery& batteryController;
-        Pinetime::Controllers::Ble& bleController;
-        Controllers::DateTime& dateTimeController;
-
-        static constexpr int appsPerScreen = 6;
-
-        // Increment this when more space is needed
-        static constexpr int nScreens = 2;
-
-        static constexpr std::array<Tile::Applications, appsPerScreen * nScreens> applications {{
+        // Increase Tile::maxApps when more space is needed
+        static constexpr std::array<Tile::Applications, Tile::maxApps> applications {{
           {Symbols::stopWatch, Apps::StopWatch},
           {Symbols::clock, Apps::Alarm},
           {Symbols::hourGlass, Apps::Timer},
           {Symbols::shoe, Apps::Steps},
           {Symbols::heartBeat, Apps::HeartRate},
           {Symbols::music, Apps::Music},
-
           {Symbols::paintbrush, Apps::Paint},
           {Symbols::paddle, Apps::Paddle},
           {"2", Apps::Twos},
@@ -53,7 +41,7 @@ namespace Pinetime {
           {Symbols::drum, Apps::Metronome},
           {Symbols::map, Apps::Navigation},
         }};
-        ScreenList<nScreens> screens;
+        Tile tile;
       };
     }
   }
@@ -63,6 +63,14 @@ bool Clock::OnButtonPushed() {
   return screen->OnButtonPushed();
 }
 
+void Clock::OnHide() {
+  screen->OnHide();
+}
+
+void Clock::OnShow() {
+  screen->OnShow();
+}
+
 std::unique_ptr<Screen> Clock::WatchFaceDigitalScreen() {
   return std::make_unique<Screens::WatchFaceDigital>(app,
                                                      dateTimeController,
@@ -34,6 +34,12 @@ namespace Pinetime {
         bool OnTouchEvent(TouchEvents event) override;
         bool OnButtonPushed() override;
 
+        bool IsRetainable() const override {
+          return true;
+        }
+        void OnHide() override;
+        void OnShow() override;
+
       private:
         Controllers::DateTime& dateTimeController;
         Controllers::Battery& batteryController;
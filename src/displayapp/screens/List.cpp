@@ -1,4 +1,5 @@
 #include "displayapp/screens/List.h"
+#include <algorithm>
 #include "displayapp/DisplayApp.h"
 #include "displayapp/screens/Symbols.h"
 
@@ -11,30 +12,25 @@ namespace {
   }
 }
 
-List::List(uint8_t screenID,
-           uint8_t numScreens,
-           DisplayApp* app,
+List::List(DisplayApp* app,
+           Components::LittleVgl& lvgl,
            Controllers::Settings& settingsController,
-           std::array<Applications, MAXLISTITEMS>& applications)
-  : Screen(app), settingsController {settingsController}, pageIndicator(screenID, numScreens) {
+           const std::array<Applications, MAXLISTITEMS>& applications)
+  : Screen(app), settingsController {settingsController}, scroller {lvgl} {
 
   // Set the background to Black
   lv_obj_set_style_local_bg_color(lv_scr_act(), LV_OBJ_PART_MAIN, LV_STATE_DEFAULT, lv_color_make(0, 0, 0));
 
-  settingsController.SetSettingsMenu(screenID);
-
-  pageIndicator.Create();
-
   lv_obj_t* container1 = lv_cont_create(lv_scr_act(), nullptr);
 
   lv_obj_set_style_local_bg_opa(container1, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, LV_OPA_TRANSP);
-  lv_obj_set_style_local_pad_inner(container1, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, 4);
+  lv_obj_set_style_local_pad_inner(container1, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, itemSpacing);
   lv_obj_set_style_local_border_width(container1, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, 0);
 
   lv_obj_set_pos(container1, 0, 0);
   lv_obj_set_width(container1, LV_HOR_RES - 8);
-  lv_obj_set_height(container1, LV_VER_RES);
   lv_cont_set_layout(container1, LV_LAYOUT_COLUMN_LEFT);
+  lv_cont_set_fit2(container1, LV_FIT_NONE, LV_FIT_TIGHT);
 
   lv_obj_t* labelBt;
   lv_obj_t* labelBtIco;
@@ -49,7 +45,7 @@ List::List(uint8_t screenID,
       lv_obj_set_style_local_bg_color(itemApps[i], LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_AQUA);
 
       lv_obj_set_width(itemApps[i], LV_HOR_RES - 8);
-      lv_obj_set_height(itemApps[i], 57);
+      lv_obj_set_height(itemApps[i], itemHeight);
       lv_obj_set_event_cb(itemApps[i], ButtonEventHandler);
       lv_btn_set_layout(itemApps[i], LV_LAYOUT_ROW_MID);
       itemApps[i]->user_data = this;
@@ -62,16 +58,33 @@ List::List(uint8_t screenID,
       lv_label_set_text_fmt(labelBt, " %s", applications[i].name);
     }
   }
+
+  // The whole list scrolls: it covers at least the screen
+  lv_cont_set_fit(container1, LV_FIT_NONE);
+  lv_obj_set_height(container1, std::max<lv_coord_t>(LV_VER_RES, lv_obj_get_height(container1)));
+
+  scroller.SetContent(container1);
+  scroller.ScrollTo(-settingsController.GetSettingsMenu() * (itemHeight + itemSpacing));
 }
 
 List::~List() {
   lv_obj_clean(lv_scr_act());
 }
 
+bool List::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
+  return scroller.ConsumesSwipe(event);
+}
+
+bool List::OnDragEvent(uint16_t /*x*/, uint16_t y, bool touching) {
+  return scroller.OnDragEvent(y, touching);
+}
+
 void List::OnButtonEvent(lv_obj_t* object, lv_event_t event) {
   if (event == LV_EVENT_CLICKED) {
     for (int i = 0; i < MAXLISTITEMS; i++) {
       if (apps[i] != Apps::None && object == itemApps[i]) {
+        // The list opens again at the first item displayed
+        settingsController.SetSettingsMenu(scroller.GetScrollPosition() / (itemHeight + itemSpacing));
         app->StartApp(apps[i], DisplayApp::FullRefreshDirections::Up);
         running = false;
         return;
@@ -4,13 +4,16 @@
 #include <cstdint>
 #include <array>
 #include "displayapp/screens/Screen.h"
-#include "displayapp/widgets/PageIndicator.h"
+#include "displayapp/widgets/VerticalScroller.h"
 #include "displayapp/Apps.h"
 #include "components/settings/Settings.h"
 
-#define MAXLISTITEMS 4
+#define MAXLISTITEMS 16
 
 namespace Pinetime {
+  namespace Components {
+    class LittleVgl;
+  }
   namespace Applications {
     namespace Screens {
       class List : public Screen {
@@ -21,22 +24,26 @@ namespace Pinetime {
           Pinetime::Applications::Apps application;
         };
 
-        explicit List(uint8_t screenID,
-                      uint8_t numScreens,
-                      DisplayApp* app,
+        explicit List(DisplayApp* app,
+                      Components::LittleVgl& lvgl,
                       Controllers::Settings& settingsController,
-                      std::array<Applications, MAXLISTITEMS>& applications);
+                      const std::array<Applications, MAXLISTITEMS>& applications);
         ~List() override;
 
+        bool OnTouchEvent(TouchEvents event) override;
+        bool OnDragEvent(uint16_t x, uint16_t y, bool touching) override;
         void OnButtonEvent(lv_obj_t* object, lv_event_t event);
 
       private:
+        static constexpr lv_coord_t itemHeight = 57;
+        static constexpr lv_coord_t itemSpacing = 4;
+
         Controllers::Settings& settingsController;
         Pinetime::Applications::Apps apps[MAXLISTITEMS];
 
         lv_obj_t* itemApps[MAXLISTITEMS];
 
-        Widgets::PageIndicator pageIndicator;
+        Widgets::VerticalScroller scroller;
       };
     }
   }
@@ -20,9 +20,7 @@
 #include <cstdint>
 #include "displayapp/DisplayApp.h"
 #include "components/ble/MusicService.h"
-#include "displayapp/icons/music/disc.c"
-#include "displayapp/icons/music/disc_f_1.c"
-#include "displayapp/icons/music/disc_f_2.c"
+#include "lv_pinetime_styles.h"
 
 using namespace Pinetime::Applications::Screens;
 
@@ -31,15 +29,11 @@ static void event_handler(lv_obj_t* obj, lv_event_t event) {
   screen->OnObjectEvent(obj, event);
 }
 
-/**
- * Set the pixel array to display by the image
- * This just calls lv_img_set_src but adds type safety
- *
- * @param img pointer to an image object
- * @param data the image array
- */
-inline void lv_img_set_src_arr(lv_obj_t* img, const lv_img_dsc_t* src_img) {
-  lv_img_set_src(img, src_img);
+namespace {
+  // Images of the external flash (see doc/ImageStore.md)
+  constexpr const char* disc = "I:disc";
+  constexpr const char* discFrame1 = "I:disc_f_1";
+  constexpr const char* discFrame2 = "I:disc_f_2";
 }
 
 /**
@@ -50,17 +44,12 @@ inline void lv_img_set_src_arr(lv_obj_t* img, const lv_img_dsc_t* src_img) {
 Music::Music(Pinetime::Applications::DisplayApp* app, Pinetime::Controllers::MusicService& music) : Screen(app), musicService(music) {
   lv_obj_t* label;
 
-  lv_style_init(&btn_style);
-  lv_style_set_radius(&btn_style, LV_STATE_DEFAULT, 20);
-  lv_style_set_bg_color(&btn_style, LV_STATE_DEFAULT, LV_COLOR_AQUA);
-  lv_style_set_bg_opa(&btn_style, LV_STATE_DEFAULT, LV_OPA_50);
-
   btnVolDown = lv_btn_create(lv_scr_act(), nullptr);
   btnVolDown->user_data = this;
   lv_obj_set_event_cb(btnVolDown, event_handler);
   lv_obj_set_size(btnVolDown, 76, 76);
   lv_obj_align(btnVolDown, nullptr, LV_ALIGN_IN_BOTTOM_LEFT, 0, 0);
-  lv_obj_add_style(btnVolDown, LV_STATE_DEFAULT, &btn_style);
+  lv_obj_add_style(btnVolDown, LV_STATE_DEFAULT, &lv_pinetime_style_music_btn);
   label = lv_label_create(btnVolDown, nullptr);
   lv_label_set_text_static(label, Symbols::volumDown);
   lv_obj_set_hidden(btnVolDown, true);
@@ -70,7 +59,7 @@ Music::Music(Pinetime::Applications::DisplayApp* app, Pinetime::Controllers::Mus
   lv_obj_set_event_cb(btnVolUp, event_handler);
   lv_obj_set_size(btnVolUp, 76, 76);
   lv_obj_align(btnVolUp, nullptr, LV_ALIGN_IN_BOTTOM_RIGHT, 0, 0);
-  lv_obj_add_style(btnVolUp, LV_STATE_DEFAULT, &btn_style);
+  lv_obj_add_style(btnVolUp, LV_STATE_DEFAULT, &lv_pinetime_style_music_btn);
   label = lv_label_create(btnVolUp, nullptr);
   lv_label_set_text_static(label, Symbols::volumUp);
   lv_obj_set_hidden(btnVolUp, true);
@@ -80,7 +69,7 @@ Music::Music(Pinetime::Applications::DisplayApp* app, Pinetime::Controllers::Mus
   lv_obj_set_event_cb(btnPrev, event_handler);
   lv_obj_set_size(btnPrev, 76, 76);
   lv_obj_align(btnPrev, nullptr, LV_ALIGN_IN_BOTTOM_LEFT, 0, 0);
-  lv_obj_add_style(btnPrev, LV_STATE_DEFAULT, &btn_style);
+  lv_obj_add_style(btnPrev, LV_STATE_DEFAULT, &lv_pinetime_style_music_btn);
   label = lv_label_create(btnPrev, nullptr);
   lv_label_set_text_static(label, Symbols::stepBackward);
 
@@ -89,7 +78,7 @@ Music::Music(Pinetime::Applications::DisplayApp* app, Pinetime::Controllers::Mus
   lv_obj_set_event_cb(btnNext, event_handler);
   lv_obj_set_size(btnNext, 76, 76);
   lv_obj_align(btnNext, nullptr, LV_ALIGN_IN_BOTTOM_RIGHT, 0, 0);
-  lv_obj_add_style(btnNext, LV_STATE_DEFAULT, &btn_style);
+  lv_obj_add_style(btnNext, LV_STATE_DEFAULT, &lv_pinetime_style_music_btn);
   label = lv_label_create(btnNext, nullptr);
   lv_label_set_text_static(label, Symbols::stepForward);
 
@@ -98,7 +87,7 @@ Music::Music(Pinetime::Applications::DisplayApp* app, Pinetime::Controllers::Mus
   lv_obj_set_event_cb(btnPlayPause, event_handler);
   lv_obj_set_size(btnPlayPause, 76, 76);
   lv_obj_align(btnPlayPause, nullptr, LV_ALIGN_IN_BOTTOM_MID, 0, 0);
-  lv_obj_add_style(btnPlayPause, LV_STATE_DEFAULT, &btn_style);
+  lv_obj_add_style(btnPlayPause, LV_STATE_DEFAULT, &lv_pinetime_style_music_btn);
   txtPlayPause = lv_label_create(btnPlayPause, nullptr);
   lv_label_set_text_static(txtPlayPause, Symbols::play);
 
@@ -128,13 +117,19 @@ Music::Music(Pinetime::Applications::DisplayApp* app, Pinetime::Controllers::Mus
   lv_label_set_text_static(txtTrack, "This is a very long getTrack name");
 
   /** Init animation */
+  // Without the images in the external flash, the animation is not shown
+  lv_img_header_t header;
+  const bool hasImages = lv_img_decoder_get_info(disc, &header) == LV_RES_OK;
+
   imgDisc = lv_img_create(lv_scr_act(), nullptr);
-  lv_img_set_src_arr(imgDisc, &disc);
+  lv_img_set_src(imgDisc, disc);
   lv_obj_align(imgDisc, nullptr, LV_ALIGN_IN_TOP_RIGHT, -15, 15);
+  lv_obj_set_hidden(imgDisc, !hasImages);
 
   imgDiscAnim = lv_img_create(lv_scr_act(), nullptr);
-  lv_img_set_src_arr(imgDiscAnim, &disc_f_1);
+  lv_img_set_src(imgDiscAnim, discFrame1);
   lv_obj_align(imgDiscAnim, nullptr, LV_ALIGN_IN_TOP_RIGHT, -15 - 32, 15);
+  lv_obj_set_hidden(imgDiscAnim, !hasImages);
 
   frameB = false;
 
@@ -145,23 +140,14 @@ Music::Music(Pinetime::Applications::DisplayApp* app, Pinetime::Controllers::Mus
 
 Music::~Music() {
   lv_task_del(taskRefresh);
-  lv_style_reset(&btn_style);
   lv_obj_clean(lv_scr_act());
 }
 
 void Music::Refresh() {
-  if (artist != musicService.getArtist()) {
-    artist = musicService.getArtist();
-    lv_label_set_text(txtArtist, artist.data());
-  }
-
-  if (track != musicService.getTrack()) {
-    track = musicService.getTrack();
-    lv_label_set_text(txtTrack, track.data());
-  }
-
-  if (album != musicService.getAlbum()) {
-    album = musicService.getAlbum();
+  if (trackInfoVersion != musicService.getTrackInfoVersion()) {
+    trackInfoVersion = musicService.getTrackInfoVersion();
+    lv_label_set_text(txtArtist, musicService.getArtist());
+    lv_label_set_text(txtTrack, musicService.getTrack());
   }
 
   if (playing != musicService.isPlaying()) {
@@ -183,9 +169,9 @@ void Music::Refresh() {
     if (xTaskGetTickCount() - 1024 >= lastIncrement) {
 
       if (frameB) {
-        lv_img_set_src(imgDiscAnim, &disc_f_1);
+        lv_img_set_src(imgDiscAnim, discFrame1);
       } else {
-        lv_img_set_src(imgDiscAnim, &disc_f_2);
+        lv_img_set_src(imgDiscAnim, discFrame2);
       }
       frameB = !frameB;
 
@@ -19,7 +19,7 @@
 
 #include <FreeRTOS.h>
 #include <lvgl/src/lv_core/lv_obj.h>
-#include <string>
+#include <cstdint>
 #include "displayapp/screens/Screen.h"
 
 namespace Pinetime {
@@ -57,16 +57,13 @@ namespace Pinetime {
         lv_obj_t* imgDiscAnim;
         lv_obj_t* txtTrackDuration;
 
-        lv_style_t btn_style;
-
         /** For the spinning disc animation */
         bool frameB;
 
         Pinetime::Controllers::MusicService& musicService;
 
-        std::string artist;
-        std::string album;
-        std::string track;
+        /** Version of the artist and track names displayed */
+        uint32_t trackInfoVersion = 0;
 
         /** Total length in seconds */
         int totalLength = 0;
@@ -17,6 +17,8 @@
 */
 #include "displayapp/screens/Navigation.h"
 #include <cstdint>
+#include <cstring>
+#include <utility>
 #include "displayapp/DisplayApp.h"
 #include "components/ble/NavigationService.h"
 
@@ -114,9 +116,9 @@ namespace {
     {"uturn", "\xEE\xA4\x89"},
   }};
 
-  const char* iconForName(const std::string& icon) {
+  const char* iconForName(const char* icon) {
     for (auto iter : m_iconMap) {
-      if (iter.first == icon) {
+      if (std::strcmp(iter.first, icon) == 0) {
         return iter.second;
       }
     }
@@ -171,19 +173,11 @@ Navigation::~Navigation() {
 }
 
 void Navigation::Refresh() {
-  if (flag != navService.getFlag()) {
-    flag = navService.getFlag();
-    lv_label_set_text_static(imgFlag, iconForName(flag));
-  }
-
-  if (narrative != navService.getNarrative()) {
-    narrative = navService.getNarrative();
-    lv_label_set_text(txtNarrative, narrative.data());
-  }
-
-  if (manDist != navService.getManDist()) {
-    manDist = navService.getManDist();
-    lv_label_set_text(txtManDist, manDist.data());
+  if (version != navService.getVersion()) {
+    version = navService.getVersion();
+    lv_label_set_text_static(imgFlag, iconForName(navService.getFlag()));
+    lv_label_set_text(txtNarrative, navService.getNarrative());
+    lv_label_set_text(txtManDist, navService.getManDist());
   }
 
   if (progress != navService.getProgress()) {
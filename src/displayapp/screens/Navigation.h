@@ -19,7 +19,7 @@
 
 #include <FreeRTOS.h>
 #include <lvgl/src/lv_core/lv_obj.h>
-#include <string>
+#include <cstdint>
 #include "displayapp/screens/Screen.h"
 #include <array>
 
@@ -45,9 +45,8 @@ namespace Pinetime {
 
         Pinetime::Controllers::NavigationService& navService;
 
-        std::string flag;
-        std::string narrative;
-        std::string manDist;
+        /** Version of the flag, narrative and distance displayed, 0 to keep the placeholders */
+        uint32_t version = 0;
         int progress;
 
         lv_task_t* taskRefresh;
@@ -10,6 +10,7 @@ extern lv_font_t jetbrains_mono_extrabold_compressed;
 extern lv_font_t jetbrains_mono_bold_20;
 
 Notifications::Notifications(DisplayApp* app,
+                             Pinetime::Components::LittleVgl& lvgl,
                              Pinetime::Controllers::NotificationManager& notificationManager,
                              Pinetime::Controllers::AlertNotificationService& alertNotificationService,
                              Pinetime::Controllers::MotorController& motorController,
@@ -20,11 +21,11 @@ Notifications::Notifications(DisplayApp* app,
     alertNotificationService {alertNotificationService},
     motorController {motorController},
     systemTask {systemTask},
-    mode {mode} {
+    mode {mode},
+    scroller {lvgl} {
 
   notificationManager.ClearNewNotificationFlag();
-  auto notification = notificationManager.GetLastNotification();
-  if (notification.valid) {
+  if (notificationManager.GetLastNotification(notification)) {
     currentId = notification.id;
     currentItem = std::make_unique<NotificationItem>(notification.Title(),
                                                      notification.Message(),
@@ -38,6 +39,10 @@ Notifications::Notifications(DisplayApp* app,
     currentItem = std::make_unique<NotificationItem>(alertNotificationService, motorController);
     validDisplay = false;
   }
+  // The preview draws the timeout line over the item: it doesn't scroll
+  if (mode == Modes::Normal) {
+    scroller.SetContent(currentItem->GetContainer());
+  }
   if (mode == Modes::Preview) {
     systemTask.PushMessage(System::Messages::DisableSleeping);
     if (notification.category == Controllers::NotificationManager::Categories::IncomingCall) {
@@ -82,9 +87,8 @@ void Notifications::Refresh() {
 
   if (dismissingNotification) {
     dismissingNotification = false;
-    auto notification = notificationManager.Get(currentId);
-    if (!notification.valid) {
-      notification = notificationManager.GetLastNotification();
+    if (!notificationManager.Get(currentId, notification)) {
+      notificationManager.GetLastNotification(notification);
     }
     currentId = notification.id;
 
@@ -111,6 +115,7 @@ void Notifications::Refresh() {
     } else {
       currentItem = std::make_unique<NotificationItem>(alertNotificationService, motorController);
     }
+    scroller.SetContent(currentItem->GetContainer());
   }
 
   running = currentItem->IsRunning() && running;
@@ -138,23 +143,25 @@ bool Notifications::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
   switch (event) {
     case Pinetime::Applications::TouchEvents::SwipeRight:
       if (validDisplay) {
-        Controllers::NotificationManager::Notification previousNotification;
-        auto previousMessage = notificationManager.GetPrevious(currentId);
-        auto nextMessage = notificationManager.GetNext(currentId);
-        if (!previousMessage.valid) {
+        const bool hasPrevious = notificationManager.GetPrevious(currentId, notification);
+        const auto previousId = notification.id;
+        const bool hasNext = notificationManager.GetNext(currentId, notification);
+        const auto nextId = notification.id;
+        if (!hasPrevious) {
           // dismissed last message (like 5/5), need to go one message down (like 4/4)
           afterDismissNextMessageFromAbove = false; // show next message coming from below
         } else {
           afterDismissNextMessageFromAbove = true; // show next message coming from above
         }
         notificationManager.Dismiss(currentId);
-        if (previousMessage.valid) {
-          currentId = previousMessage.id;
-        } else if (nextMessage.valid) {
-          currentId = nextMessage.id;
+        if (hasPrevious) {
+          currentId = previousId;
+        } else if (hasNext) {
+          currentId = nextId;
         } else {
           // don't update id, won't be found be refresh and try to load latest message or no message box
         }
+        scroller.SetContent(nullptr);
         currentItem.reset(nullptr);
         app->SetFullRefresh(DisplayApp::FullRefreshDirections::RightAnim);
         // create black transition screen to let the notification dismiss to blackness
@@ -166,56 +173,62 @@ bool Notifications::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
       }
       return false;
     case Pinetime::Applications::TouchEvents::SwipeDown: {
-      Controllers::NotificationManager::Notification previousNotification;
+      if (scroller.ConsumesSwipe(event)) {
+        return true;
+      }
       if (validDisplay) {
-        previousNotification = notificationManager.GetPrevious(currentId);
+        notificationManager.GetPrevious(currentId, notification);
       } else {
-        previousNotification = notificationManager.GetLastNotification();
+        notificationManager.GetLastNotification(notification);
       }
 
-      if (!previousNotification.valid) {
+      if (!notification.valid) {
         return true;
       }
 
-      currentId = previousNotification.id;
+      currentId = notification.id;
       Controllers::NotificationManager::Notification::Idx currentIdx = notificationManager.IndexOf(currentId);
       validDisplay = true;
       currentItem.reset(nullptr);
       app->SetFullRefresh(DisplayApp::FullRefreshDirections::Down);
-      currentItem = std::make_unique<NotificationItem>(previousNotification.Title(),
-                                                       previousNotification.Message(),
+      currentItem = std::make_unique<NotificationItem>(notification.Title(),
+                                                       notification.Message(),
                                                        currentIdx + 1,
-                                                       previousNotification.category,
+                                                       notification.category,
                                                        notificationManager.NbNotifications(),
                                                        alertNotificationService,
                                                        motorController);
+      scroller.SetContent(currentItem->GetContainer());
     }
       return true;
     case Pinetime::Applications::TouchEvents::SwipeUp: {
-      Controllers::NotificationManager::Notification nextNotification;
+      if (scroller.ConsumesSwipe(event)) {
+        return true;
+      }
       if (validDisplay) {
-        nextNotification = notificationManager.GetNext(currentId);
+        notificationManager.GetNext(currentId, notification);
       } else {
-        nextNotification = notificationManager.GetLastNotification();
+        notificationManager.GetLastNotification(notification);
       }
 
-      if (!nextNotification.valid) {
+      if (!notification.valid) {
         running = false;
         return false;
       }
 
-      currentId = nextNotification.id;
+      currentId = notification.id;
       Controllers::NotificationManager::Notification::Idx currentIdx = notificationManager.IndexOf(currentId);
       validDisplay = true;
       currentItem.reset(nullptr);
       app->SetFullRefresh(DisplayApp::FullRefreshDirections::Up);
-      currentItem = std::make_unique<NotificationItem>(nextNotification.Title(),
-                                                       nextNotification.Message(),
+      currentItem = std::make_unique<NotificationItem>(notification.Title(),
+                                                       notification.Message(),
                                                        currentIdx + 1,
-                                                       nextNotification.category,
+                                                       notification.category,
                                                        notificationManager.NbNotifications(),
                                                        alertNotificationService,
                                                        motorController);
+      scroller.SetContent(currentItem->GetContainer());
     }
       return true;
     default:
@@ -223,6 +236,13 @@ bool Notifications::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
   }
 }
 
+bool Notifications::OnDragEvent(uint16_t /*x*/, uint16_t y, bool touching) {
+  if (mode != Modes::Normal) {
+    return false;
+  }
+  return scroller.OnDragEvent(y, touching);
+}
+
 namespace {
   void CallEventHandler(lv_obj_t* obj, lv_event_t event) {
     auto* item = static_cast<Notifications::NotificationItem*>(obj->user_data);
@@ -297,6 +317,10 @@ Notifications::NotificationItem::NotificationItem(const char* title,
       lv_label_set_long_mode(alert_subject, LV_LABEL_LONG_BREAK);
       lv_obj_set_width(alert_subject, LV_HOR_RES - 20);
       lv_label_set_text(alert_subject, msg);
+
+      // A long message extends the item below the screen
+      lv_obj_set_height(subject_container, std::max<lv_coord_t>(LV_VER_RES - 50, lv_obj_get_height(alert_subject) + 2 * 10));
+      lv_obj_set_height(container, 50 + lv_obj_get_height(subject_container));
     } break;
     case Controllers::NotificationManager::Categories::IncomingCall: {
       lv_obj_set_height(subject_container, 108);
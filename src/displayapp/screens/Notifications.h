@@ -8,6 +8,7 @@
 #include "components/ble/NotificationManager.h"
 #include "components/motor/MotorController.h"
 #include "systemtask/SystemTask.h"
+#include "displayapp/widgets/VerticalScroller.h"
 
 namespace Pinetime {
   namespace Controllers {
@@ -20,6 +21,7 @@ namespace Pinetime {
       public:
         enum class Modes { Normal, Preview };
         explicit Notifications(DisplayApp* app,
+                               Pinetime::Components::LittleVgl& lvgl,
                                Pinetime::Controllers::NotificationManager& notificationManager,
                                Pinetime::Controllers::AlertNotificationService& alertNotificationService,
                                Pinetime::Controllers::MotorController& motorController,
@@ -29,6 +31,7 @@ namespace Pinetime {
 
         void Refresh() override;
         bool OnTouchEvent(Pinetime::Applications::TouchEvents event) override;
+        bool OnDragEvent(uint16_t x, uint16_t y, bool touching) override;
         void OnPreviewInteraction();
 
         class NotificationItem {
@@ -46,6 +49,10 @@ namespace Pinetime {
           bool IsRunning() const {
             return running;
           }
+          /// The whole item, taller than the screen if the message doesn't fit
+          lv_obj_t* GetContainer() const {
+            return container;
+          }
           void OnCallButtonEvent(lv_obj_t*, lv_event_t event);
 
         private:
@@ -70,6 +77,8 @@ namespace Pinetime {
         System::SystemTask& systemTask;
         Modes mode = Modes::Normal;
         std::unique_ptr<NotificationItem> currentItem;
+        // Copy of the notification being read from the store, kept with the screen rather than on the display task stack
+        Pinetime::Controllers::NotificationManager::Notification notification;
         Pinetime::Controllers::NotificationManager::Notification::Id currentId;
         bool validDisplay = false;
         bool afterDismissNextMessageFromAbove = false;
@@ -83,6 +92,7 @@ namespace Pinetime {
 
         bool dismissingNotification = false;
 
+        Widgets::VerticalScroller scroller;
         lv_task_t* taskRefresh;
       };
     }
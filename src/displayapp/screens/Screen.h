@@ -68,6 +68,36 @@ namespace Pinetime {
           return false;
         }
 
+        /** Called with each touch point while the screen is touched, then once with touching == false on release
+         * @return true while the app scrolls with the finger: the lvgl tap is cancelled */
+        virtual bool OnDragEvent(uint16_t x, uint16_t y, bool touching) {
+          return false;
+        }
+
+        /** @return true if DisplayApp may keep the screen and its LVGL objects when another app is loaded, instead of
+         * deleting it. The screen must stop updating its objects in OnHide(), and catch up in OnShow(). */
+        virtual bool IsRetainable() const {
+          return false;
+        }
+        /// The screen is kept by DisplayApp while another app is displayed: lv_scr_act() is not its LVGL screen anymore
+        virtual void OnHide() {
+        }
+        /// The kept screen is displayed again, on its LVGL screen
+        virtual void OnShow() {
+        }
+
+        /** Small snapshot of the state of the screen (page, scroll position...), kept by DisplayApp when the screen is
+         * deleted and given to the next screen of the same app, right after it is created */
+        virtual uint32_t SaveState() const {
+          return 0;
+        }
+        virtual void RestoreState(uint32_t /*state*/) {
+        }
+
+        /// The memory is low: release what can be rebuilt (caches, hidden objects...)
+        virtual void OnLowMemory() {
+        }
+
       protected:
         DisplayApp* app;
         bool running = true;
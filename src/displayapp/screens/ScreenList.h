@@ -99,6 +99,19 @@ namespace Pinetime {
           return false;
         }
 
+        /// The index of the current screen
+        uint32_t SaveState() const override {
+          return screenIndex;
+        }
+
+        void RestoreState(uint32_t state) override {
+          if (state < screens.size() && state != screenIndex) {
+            current.reset(nullptr);
+            screenIndex = state;
+            current = screens[screenIndex]();
+          }
+        }
+
       private:
         uint8_t initScreen = 0;
         const std::array<std::function<std::unique_ptr<Screen>()>, N> screens;
@@ -12,6 +12,7 @@
 #include "components/datetime/DateTimeController.h"
 #include "components/motion/MotionController.h"
 #include "drivers/Watchdog.h"
+#include "systemtask/SystemTask.h"
 
 using namespace Pinetime::Applications::Screens;
 
@@ -36,7 +37,8 @@ SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
                        Pinetime::Controllers::Ble& bleController,
                        Pinetime::Drivers::WatchdogView& watchdog,
                        Pinetime::Controllers::MotionController& motionController,
-                       Pinetime::Drivers::Cst816S& touchPanel)
+                       Pinetime::Drivers::Cst816S& touchPanel,
+                       Pinetime::System::SystemTask& systemTask)
   : Screen(app),
     dateTimeController {dateTimeController},
     batteryController {batteryController},
@@ -45,6 +47,7 @@ SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
     watchdog {watchdog},
     motionController {motionController},
     touchPanel {touchPanel},
+    systemTask {systemTask},
     screens {app,
              0,
              {[this]() -> std::unique_ptr<Screen> {
@@ -61,6 +64,9 @@ SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
               },
               [this]() -> std::unique_ptr<Screen> {
                 return CreateScreen5();
+              },
+              [this]() -> std::unique_ptr<Screen> {
+                return CreateScreen6();
               }},
              Screens::ScreenListModes::UpDown} {
 }
@@ -93,7 +99,7 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen1() {
                         BootloaderVersion::VersionString());
   lv_label_set_align(label, LV_LABEL_ALIGN_CENTER);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(0, 5, app, label);
+  return std::make_unique<Screens::Label>(0, 6, app, label);
 }
 
 std::unique_ptr<Screen> SystemInfo::CreateScreen2() {
@@ -172,12 +178,21 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen2() {
                         touchPanel.GetFwVersion(),
                         TARGET_DEVICE_NAME);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(1, 5, app, label);
+  return std::make_unique<Screens::Label>(1, 6, app, label);
 }
 
 std::unique_ptr<Screen> SystemInfo::CreateScreen3() {
-  lv_mem_monitor_t mon;
-  lv_mem_monitor(&mon);
+  // The block pools and the general pool of the LVGL memory: the biggest free block and the fragmentation are those of
+  // the general pool
+  const auto memory = Components::LittleVgl::GetMemoryStatistics();
+  uint32_t totalSize = memory.poolSize;
+  uint32_t freeSize = memory.poolFree;
+  uint32_t maxUsed = memory.poolMaxUsed;
+  for (const auto& sizeClass : memory.classes) {
+    totalSize += sizeClass.nbBlocks * sizeClass.blockSize;
+    freeSize += (sizeClass.nbBlocks - sizeClass.used) * sizeClass.blockSize;
+    maxUsed += sizeClass.maxUsed * sizeClass.blockSize;
+  }
 
   lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
   lv_label_set_recolor(label, true);
@@ -197,13 +212,13 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen3() {
                         bleAddr[2],
                         bleAddr[1],
                         bleAddr[0],
-                        static_cast<int>(mon.total_size - mon.free_size),
-                        mon.used_pct,
-                        mon.max_used,
-                        mon.frag_pct,
-                        static_cast<int>(mon.free_biggest_size));
+                        static_cast<int>(totalSize - freeSize),
+                        static_cast<int>(100 - freeSize * 100 / totalSize),
+                        static_cast<unsigned long>(maxUsed),
+                        memory.poolFragmentationPercent,
+                        static_cast<int>(memory.poolBiggestFree));
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(2, 5, app, label);
+  return std::make_unique<Screens::Label>(2, 6, app, label);
 }
 
 bool SystemInfo::sortById(const TaskStatus_t& lhs, const TaskStatus_t& rhs) {
@@ -264,10 +279,54 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen4() {
     }
     lv_table_set_cell_value(infoTask, i + 1, 3, buffer);
   }
-  return std::make_unique<Screens::Label>(3, 5, app, infoTask);
+  return std::make_unique<Screens::Label>(3, 6, app, infoTask);
 }
 
 std::unique_ptr<Screen> SystemInfo::CreateScreen5() {
+  static constexpr uint8_t maxTaskCount = 4;
+  const auto statistics = systemTask.GetRunTimeStatistics();
+
+  lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
+  lv_label_set_recolor(label, true);
+  if (configGENERATE_RUN_TIME_STATS == 0) {
+    lv_label_set_text_static(label, "#808080 CPU load#\nnot built in");
+  } else if (statistics.periodMs == 0) {
+    lv_label_set_text_static(label, "#808080 CPU load#\nmeasuring...");
+  } else {
+    // Large enough for the longest task and wake-up source names
+    char text[256];
+    size_t length = 0;
+    auto append = [&text, &length](const char* format, auto... args) {
+      if (length < sizeof(text)) {
+        length += snprintf(text + length, sizeof(text) - length, format, args...);
+      }
+    };
+
+    append("#808080 CPU load# %d.%d%%\n"
+           "#808080 Sleep# %d.%d%%\n"
+           "#808080 Wake-ups# %d/s",
+           statistics.cpuLoadPermille / 10,
+           statistics.cpuLoadPermille % 10,
+           statistics.sleepPermille / 10,
+           statistics.sleepPermille % 10,
+           statistics.wakeupsPerSecond);
+    for (uint8_t i = 0; i < statistics.nbTopWakeupSources; i++) {
+      append("\n %s %d",
+             Pinetime::System::SystemMonitor::WakeupSourceName(statistics.topWakeupSources[i].source),
+             statistics.topWakeupSources[i].count);
+    }
+    append("\n#808080 Tasks#");
+    for (uint8_t i = 0; i < statistics.nbTasks && i < maxTaskCount; i++) {
+      const auto& task = statistics.tasks[i];
+      append("\n %s %d.%d%%", task.name, task.loadPermille / 10, task.loadPermille % 10);
+    }
+    lv_label_set_text(label, text);
+  }
+  lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
+  return std::make_unique<Screens::Label>(4, 6, app, label);
+}
+
+std::unique_ptr<Screen> SystemInfo::CreateScreen6() {
   lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
   lv_label_set_recolor(label, true);
   lv_label_set_text_static(label,
@@ -281,5 +340,5 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen5() {
                            "#FFFF00 InfiniTime#");
   lv_label_set_align(label, LV_LABEL_ALIGN_CENTER);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(4, 5, app, label);
+  return std::make_unique<Screens::Label>(5, 6, app, label);
 }
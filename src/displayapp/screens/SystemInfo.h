@@ -16,6 +16,10 @@ namespace Pinetime {
     class WatchdogView;
   }
 
+  namespace System {
+    class SystemTask;
+  }
+
   namespace Applications {
     class DisplayApp;
 
@@ -29,10 +33,19 @@ namespace Pinetime {
                             Pinetime::Controllers::Ble& bleController,
                             Pinetime::Drivers::WatchdogView& watchdog,
                             Pinetime::Controllers::MotionController& motionController,
-                            Pinetime::Drivers::Cst816S& touchPanel);
+                            Pinetime::Drivers::Cst816S& touchPanel,
+                            Pinetime::System::SystemTask& systemTask);
         ~SystemInfo() override;
         bool OnTouchEvent(TouchEvents event) override;
 
+        // Opens on the page that was displayed the last time
+        uint32_t SaveState() const override {
+          return screens.SaveState();
+        }
+        void RestoreState(uint32_t state) override {
+          screens.RestoreState(state);
+        }
+
       private:
         Pinetime::Controllers::DateTime& dateTimeController;
         Pinetime::Controllers::Battery& batteryController;
@@ -41,8 +54,9 @@ namespace Pinetime {
         Pinetime::Drivers::WatchdogView& watchdog;
         Pinetime::Controllers::MotionController& motionController;
         Pinetime::Drivers::Cst816S& touchPanel;
+        Pinetime::System::SystemTask& systemTask;
 
-        ScreenList<5> screens;
+        ScreenList<6> screens;
 
         static bool sortById(const TaskStatus_t& lhs, const TaskStatus_t& rhs);
 
@@ -51,6 +65,7 @@ namespace Pinetime {
         std::unique_ptr<Screen> CreateScreen3();
         std::unique_ptr<Screen> CreateScreen4();
         std::unique_ptr<Screen> CreateScreen5();
+        std::unique_ptr<Screen> CreateScreen6();
       };
     }
   }
@@ -23,34 +23,41 @@ namespace {
   }
 }
 
-Tile::Tile(uint8_t screenID,
-           uint8_t numScreens,
-           DisplayApp* app,
+Tile::Tile(DisplayApp* app,
+           Components::LittleVgl& lvgl,
            Controllers::Settings& settingsController,
            Controllers::Battery& batteryController,
            Controllers::Ble& bleController,
            Controllers::DateTime& dateTimeController,
-           std::array<Applications, 6>& applications)
+           const std::array<Applications, maxApps>& applications)
   : Screen(app),
+    settingsController {settingsController},
     dateTimeController {dateTimeController},
-    pageIndicator(screenID, numScreens),
-    statusIcons(batteryController, bleController) {
+    statusIcons(batteryController, bleController),
+    scroller {lvgl} {
 
-  settingsController.SetAppMenu(screenID);
+  constexpr uint8_t nbRows = maxApps / appsPerRow;
+  constexpr lv_coord_t buttonsHeight = nbRows * rowHeight + (nbRows - 1) * rowSpacing;
 
-  statusIcons.Create();
-  lv_obj_align(statusIcons.GetObject(), lv_scr_act(), LV_ALIGN_IN_TOP_RIGHT, -8, 0);
+  // The header and the buttons scroll together
+  lv_obj_t* content = lv_cont_create(lv_scr_act(), nullptr);
+  lv_obj_set_style_local_bg_opa(content, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, LV_OPA_TRANSP);
+  lv_obj_set_style_local_border_width(content, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, 0);
+  lv_obj_set_style_local_pad_all(content, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, 0);
+  lv_obj_set_pos(content, 0, 0);
+  lv_obj_set_size(content, LV_HOR_RES, buttonsY + buttonsHeight + bottomMargin);
+
+  statusIcons.Create(content);
+  lv_obj_align(statusIcons.GetObject(), content, LV_ALIGN_IN_TOP_RIGHT, -8, 0);
 
   // Time
-  label_time = lv_label_create(lv_scr_act(), nullptr);
+  label_time = lv_label_create(content, nullptr);
   lv_label_set_align(label_time, LV_LABEL_ALIGN_CENTER);
   lv_obj_align(label_time, nullptr, LV_ALIGN_IN_TOP_LEFT, 0, 0);
 
-  pageIndicator.Create();
-
   uint8_t btIndex = 0;
-  for (uint8_t i = 0; i < 6; i++) {
-    if (i == 3)
+  for (uint8_t i = 0; i < maxApps; i++) {
+    if (i > 0 && i % appsPerRow == 0)
       btnmMap[btIndex++] = "\n";
     if (applications[i].application == Apps::None) {
       btnmMap[btIndex] = " ";
@@ -62,10 +69,10 @@ Tile::Tile(uint8_t screenID,
   }
   btnmMap[btIndex] = "";
 
-  btnm1 = lv_btnmatrix_create(lv_scr_act(), nullptr);
+  btnm1 = lv_btnmatrix_create(content, nullptr);
   lv_btnmatrix_set_map(btnm1, btnmMap);
-  lv_obj_set_size(btnm1, LV_HOR_RES - 16, LV_VER_RES - 60);
-  lv_obj_align(btnm1, NULL, LV_ALIGN_CENTER, 0, 10);
+  lv_obj_set_size(btnm1, LV_HOR_RES - 16, buttonsHeight);
+  lv_obj_align(btnm1, nullptr, LV_ALIGN_IN_TOP_MID, 0, buttonsY);
 
   lv_obj_set_style_local_radius(btnm1, LV_BTNMATRIX_PART_BTN, LV_STATE_DEFAULT, 20);
   lv_obj_set_style_local_bg_opa(btnm1, LV_BTNMATRIX_PART_BTN, LV_STATE_DEFAULT, LV_OPA_50);
@@ -73,9 +80,9 @@ Tile::Tile(uint8_t screenID,
   lv_obj_set_style_local_bg_opa(btnm1, LV_BTNMATRIX_PART_BTN, LV_STATE_DISABLED, LV_OPA_50);
   lv_obj_set_style_local_bg_color(btnm1, LV_BTNMATRIX_PART_BTN, LV_STATE_DISABLED, lv_color_hex(0x111111));
   lv_obj_set_style_local_pad_all(btnm1, LV_BTNMATRIX_PART_BG, LV_STATE_DEFAULT, 0);
-  lv_obj_set_style_local_pad_inner(btnm1, LV_BTNMATRIX_PART_BG, LV_STATE_DEFAULT, 10);
+  lv_obj_set_style_local_pad_inner(btnm1, LV_BTNMATRIX_PART_BG, LV_STATE_DEFAULT, rowSpacing);
 
-  for (uint8_t i = 0; i < 6; i++) {
+  for (uint8_t i = 0; i < maxApps; i++) {
     lv_btnmatrix_set_btn_ctrl(btnm1, i, LV_BTNMATRIX_CTRL_CLICK_TRIG);
     if (applications[i].application == Apps::None) {
       lv_btnmatrix_set_btn_ctrl(btnm1, i, LV_BTNMATRIX_CTRL_DISABLED);
@@ -85,6 +92,9 @@ Tile::Tile(uint8_t screenID,
   btnm1->user_data = this;
   lv_obj_set_event_cb(btnm1, event_handler);
 
+  scroller.SetContent(content);
+  scroller.ScrollTo(-settingsController.GetAppMenu() * (rowHeight + rowSpacing));
+
   taskUpdate = lv_task_create(lv_update_task, 5000, LV_TASK_PRIO_MID, this);
 
   UpdateScreen();
@@ -95,6 +105,14 @@ Tile::~Tile() {
   lv_obj_clean(lv_scr_act());
 }
 
+bool Tile::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
+  return scroller.ConsumesSwipe(event);
+}
+
+bool Tile::OnDragEvent(uint16_t /*x*/, uint16_t y, bool touching) {
+  return scroller.OnDragEvent(y, touching);
+}
+
 void Tile::UpdateScreen() {
   lv_label_set_text(label_time, dateTimeController.FormattedTime().c_str());
   statusIcons.Update();
@@ -104,6 +122,8 @@ void Tile::OnValueChangedEvent(lv_obj_t* obj, uint32_t buttonId) {
   if (obj != btnm1)
     return;
 
+  // The list opens again at the first row displayed
+  settingsController.SetAppMenu(scroller.GetScrollPosition() / (rowHeight + rowSpacing));
   app->StartApp(apps[buttonId], DisplayApp::FullRefreshDirections::Up);
   running = false;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <lvgl/lvgl.h>
+#include <array>
 #include <cstdint>
 #include <memory>
 #include "displayapp/screens/Screen.h"
@@ -8,10 +9,13 @@
 #include "components/datetime/DateTimeController.h"
 #include "components/settings/Settings.h"
 #include "components/battery/BatteryController.h"
-#include "displayapp/widgets/PageIndicator.h"
 #include "displayapp/widgets/StatusIcons.h"
+#include "displayapp/widgets/VerticalScroller.h"
 
 namespace Pinetime {
+  namespace Components {
+    class LittleVgl;
+  }
   namespace Applications {
     namespace Screens {
       class Tile : public Screen {
@@ -21,21 +25,33 @@ namespace Pinetime {
           Pinetime::Applications::Apps application;
         };
 
-        explicit Tile(uint8_t screenID,
-                      uint8_t numScreens,
-                      DisplayApp* app,
+        static constexpr uint8_t appsPerRow = 3;
+        static constexpr uint8_t maxApps = 12;
+
+        explicit Tile(DisplayApp* app,
+                      Components::LittleVgl& lvgl,
                       Controllers::Settings& settingsController,
                       Controllers::Battery& batteryController,
                       Controllers::Ble& bleController,
                       Controllers::DateTime& dateTimeController,
-                      std::array<Applications, 6>& applications);
+                      const std::array<Applications, maxApps>& applications);
 
         ~Tile() override;
 
+        bool OnTouchEvent(TouchEvents event) override;
+        bool OnDragEvent(uint16_t x, uint16_t y, bool touching) override;
+
         void UpdateScreen();
         void OnValueChangedEvent(lv_obj_t* obj, uint32_t buttonId);
 
       private:
+        // Two rows of buttons are displayed at once
+        static constexpr lv_coord_t buttonsY = 40;
+        static constexpr lv_coord_t rowHeight = 85;
+        static constexpr lv_coord_t rowSpacing = 10;
+        static constexpr lv_coord_t bottomMargin = 20;
+
+        Controllers::Settings& settingsController;
         Controllers::DateTime& dateTimeController;
 
         lv_task_t* taskUpdate;
@@ -43,11 +59,11 @@ namespace Pinetime {
         lv_obj_t* label_time;
         lv_obj_t* btnm1;
 
-        Widgets::PageIndicator pageIndicator;
         Widgets::StatusIcons statusIcons;
+        Widgets::VerticalScroller scroller;
 
-        const char* btnmMap[8];
-        Pinetime::Applications::Apps apps[6];
+        const char* btnmMap[maxApps + maxApps / appsPerRow];
+        Pinetime::Applications::Apps apps[maxApps];
       };
     }
   }
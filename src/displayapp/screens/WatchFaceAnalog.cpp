@@ -1,5 +1,4 @@
 #include "displayapp/screens/WatchFaceAnalog.h"
-#include <cmath>
 #include <lvgl/lvgl.h>
 #include "displayapp/screens/BatteryIcon.h"
 #include "displayapp/screens/BleIcon.h"
@@ -15,31 +14,6 @@ namespace {
   constexpr int16_t HourLength = 70;
   constexpr int16_t MinuteLength = 90;
   constexpr int16_t SecondLength = 110;
-
-  // sin(90) = 1 so the value of _lv_trigo_sin(90) is the scaling factor
-  const auto LV_TRIG_SCALE = _lv_trigo_sin(90);
-
-  int16_t Cosine(int16_t angle) {
-    return _lv_trigo_sin(angle + 90);
-  }
-
-  int16_t Sine(int16_t angle) {
-    return _lv_trigo_sin(angle);
-  }
-
-  int16_t CoordinateXRelocate(int16_t x) {
-    return (x + LV_HOR_RES / 2);
-  }
-
-  int16_t CoordinateYRelocate(int16_t y) {
-    return std::abs(y - LV_HOR_RES / 2);
-  }
-
-  lv_point_t CoordinateRelocate(int16_t radius, int16_t angle) {
-    return lv_point_t {.x = CoordinateXRelocate(radius * static_cast<int32_t>(Sine(angle)) / LV_TRIG_SCALE),
-                       .y = CoordinateYRelocate(radius * static_cast<int32_t>(Cosine(angle)) / LV_TRIG_SCALE)};
-  }
-
 }
 
 WatchFaceAnalog::WatchFaceAnalog(Pinetime::Applications::DisplayApp* app,
@@ -50,6 +24,11 @@ WatchFaceAnalog::WatchFaceAnalog(Pinetime::Applications::DisplayApp* app,
                                  Controllers::Settings& settingsController)
   : Screen(app),
     currentDateTime {{}},
+    hour_body {30, HourLength, 7, LV_COLOR_WHITE, true},
+    hour_body_trace {5, 31, 3, LV_COLOR_WHITE, false},
+    minute_body {30, MinuteLength, 7, LV_COLOR_WHITE, true},
+    minute_body_trace {5, 31, 3, LV_COLOR_WHITE, false},
+    second_body {-20, SecondLength, 3, LV_COLOR_RED, true},
     dateTimeController {dateTimeController},
     batteryController {batteryController},
     bleController {bleController},
@@ -85,41 +64,12 @@ WatchFaceAnalog::WatchFaceAnalog(Pinetime::Applications::DisplayApp* app,
   lv_label_set_align(label_date_day, LV_LABEL_ALIGN_CENTER);
   lv_obj_align(label_date_day, NULL, LV_ALIGN_CENTER, 50, 0);
 
-  minute_body = lv_line_create(lv_scr_act(), NULL);
-  minute_body_trace = lv_line_create(lv_scr_act(), NULL);
-  hour_body = lv_line_create(lv_scr_act(), NULL);
-  hour_body_trace = lv_line_create(lv_scr_act(), NULL);
-  second_body = lv_line_create(lv_scr_act(), NULL);
-
-  lv_style_init(&second_line_style);
-  lv_style_set_line_width(&second_line_style, LV_STATE_DEFAULT, 3);
-  lv_style_set_line_color(&second_line_style, LV_STATE_DEFAULT, LV_COLOR_RED);
-  lv_style_set_line_rounded(&second_line_style, LV_STATE_DEFAULT, true);
-  lv_obj_add_style(second_body, LV_LINE_PART_MAIN, &second_line_style);
-
-  lv_style_init(&minute_line_style);
-  lv_style_set_line_width(&minute_line_style, LV_STATE_DEFAULT, 7);
-  lv_style_set_line_color(&minute_line_style, LV_STATE_DEFAULT, LV_COLOR_WHITE);
-  lv_style_set_line_rounded(&minute_line_style, LV_STATE_DEFAULT, true);
-  lv_obj_add_style(minute_body, LV_LINE_PART_MAIN, &minute_line_style);
-
-  lv_style_init(&minute_line_style_trace);
-  lv_style_set_line_width(&minute_line_style_trace, LV_STATE_DEFAULT, 3);
-  lv_style_set_line_color(&minute_line_style_trace, LV_STATE_DEFAULT, LV_COLOR_WHITE);
-  lv_style_set_line_rounded(&minute_line_style_trace, LV_STATE_DEFAULT, false);
-  lv_obj_add_style(minute_body_trace, LV_LINE_PART_MAIN, &minute_line_style_trace);
-
-  lv_style_init(&hour_line_style);
-  lv_style_set_line_width(&hour_line_style, LV_STATE_DEFAULT, 7);
-  lv_style_set_line_color(&hour_line_style, LV_STATE_DEFAULT, LV_COLOR_WHITE);
-  lv_style_set_line_rounded(&hour_line_style, LV_STATE_DEFAULT, true);
-  lv_obj_add_style(hour_body, LV_LINE_PART_MAIN, &hour_line_style);
-
-  lv_style_init(&hour_line_style_trace);
-  lv_style_set_line_width(&hour_line_style_trace, LV_STATE_DEFAULT, 3);
-  lv_style_set_line_color(&hour_line_style_trace, LV_STATE_DEFAULT, LV_COLOR_WHITE);
-  lv_style_set_line_rounded(&hour_line_style_trace, LV_STATE_DEFAULT, false);
-  lv_obj_add_style(hour_body_trace, LV_LINE_PART_MAIN, &hour_line_style_trace);
+  // The hands only invalidate the areas around their old and new positions when they move
+  minute_body.Create(lv_scr_act());
+  minute_body_trace.Create(lv_scr_act());
+  hour_body.Create(lv_scr_act());
+  hour_body_trace.Create(lv_scr_act());
+  second_body.Create(lv_scr_act());
 
   taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
 
@@ -129,12 +79,6 @@ WatchFaceAnalog::WatchFaceAnalog(Pinetime::Applications::DisplayApp* app,
 WatchFaceAnalog::~WatchFaceAnalog() {
   lv_task_del(taskRefresh);
 
-  lv_style_reset(&hour_line_style);
-  lv_style_reset(&hour_line_style_trace);
-  lv_style_reset(&minute_line_style);
-  lv_style_reset(&minute_line_style_trace);
-  lv_style_reset(&second_line_style);
-
   lv_obj_clean(lv_scr_act());
 }
 
@@ -145,38 +89,22 @@ void WatchFaceAnalog::UpdateClock() {
 
   if (sMinute != minute) {
     auto const angle = minute * 6;
-    minute_point[0] = CoordinateRelocate(30, angle);
-    minute_point[1] = CoordinateRelocate(MinuteLength, angle);
-
-    minute_point_trace[0] = CoordinateRelocate(5, angle);
-    minute_point_trace[1] = CoordinateRelocate(31, angle);
-
-    lv_line_set_points(minute_body, minute_point, 2);
-    lv_line_set_points(minute_body_trace, minute_point_trace, 2);
+    minute_body.SetAngle(angle);
+    minute_body_trace.SetAngle(angle);
   }
 
   if (sHour != hour || sMinute != minute) {
     sHour = hour;
     sMinute = minute;
     auto const angle = (hour * 30 + minute / 2);
-
-    hour_point[0] = CoordinateRelocate(30, angle);
-    hour_point[1] = CoordinateRelocate(HourLength, angle);
-
-    hour_point_trace[0] = CoordinateRelocate(5, angle);
-    hour_point_trace[1] = CoordinateRelocate(31, angle);
-
-    lv_line_set_points(hour_body, hour_point, 2);
-    lv_line_set_points(hour_body_trace, hour_point_trace, 2);
+    hour_body.SetAngle(angle);
+    hour_body_trace.SetAngle(angle);
   }
 
   if (sSecond != second) {
     sSecond = second;
     auto const angle = second * 6;
-
-    second_point[0] = CoordinateRelocate(-20, angle);
-    second_point[1] = CoordinateRelocate(SecondLength, angle);
-    lv_line_set_points(second_body, second_point, 2);
+    second_body.SetAngle(angle);
   }
 }
 
@@ -185,6 +113,15 @@ void WatchFaceAnalog::SetBatteryIcon() {
   batteryIcon.SetBatteryPercentage(batteryPercent);
 }
 
+void WatchFaceAnalog::OnHide() {
+  lv_task_set_prio(taskRefresh, LV_TASK_PRIO_OFF);
+}
+
+void WatchFaceAnalog::OnShow() {
+  lv_task_set_prio(taskRefresh, LV_TASK_PRIO_MID);
+  Refresh();
+}
+
 void WatchFaceAnalog::Refresh() {
   isCharging = batteryController.IsCharging();
   if (isCharging.IsUpdated()) {
@@ -9,6 +9,7 @@
 #include "components/battery/BatteryController.h"
 #include "components/ble/BleController.h"
 #include "components/ble/NotificationManager.h"
+#include "displayapp/widgets/ClockHand.h"
 #include <displayapp/screens/BatteryIcon.h>
 
 namespace Pinetime {
@@ -33,6 +34,8 @@ namespace Pinetime {
         ~WatchFaceAnalog() override;
 
         void Refresh() override;
+        void OnHide() override;
+        void OnShow() override;
 
       private:
         uint8_t sHour, sMinute, sSecond;
@@ -46,23 +49,11 @@ namespace Pinetime {
         DirtyValue<std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds>> currentDateTime;
         DirtyValue<bool> notificationState {false};
 
-        lv_obj_t* hour_body;
-        lv_obj_t* hour_body_trace;
-        lv_obj_t* minute_body;
-        lv_obj_t* minute_body_trace;
-        lv_obj_t* second_body;
-
-        lv_point_t hour_point[2];
-        lv_point_t hour_point_trace[2];
-        lv_point_t minute_point[2];
-        lv_point_t minute_point_trace[2];
-        lv_point_t second_point[2];
-
-        lv_style_t hour_line_style;
-        lv_style_t hour_line_style_trace;
-        lv_style_t minute_line_style;
-        lv_style_t minute_line_style_trace;
-        lv_style_t second_line_style;
+        Widgets::ClockHand hour_body;
+        Widgets::ClockHand hour_body_trace;
+        Widgets::ClockHand minute_body;
+        Widgets::ClockHand minute_body_trace;
+        Widgets::ClockHand second_body;
 
         lv_obj_t* label_date_day;
         lv_obj_t* plugIcon;
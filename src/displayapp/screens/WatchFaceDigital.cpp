@@ -42,10 +42,8 @@ WatchFaceDigital::WatchFaceDigital(DisplayApp* app,
   lv_obj_align(label_date, lv_scr_act(), LV_ALIGN_CENTER, 0, 60);
   lv_obj_set_style_local_text_color(label_date, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, lv_color_hex(0x999999));
 
-  label_time = lv_label_create(lv_scr_act(), nullptr);
-  lv_obj_set_style_local_text_font(label_time, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, &jetbrains_mono_extrabold_compressed);
-
-  lv_obj_align(label_time, lv_scr_act(), LV_ALIGN_IN_RIGHT_MID, 0, 0);
+  timeDigits.Create(lv_scr_act(), &jetbrains_mono_extrabold_compressed);
+  lv_obj_align(timeDigits.GetObject(), lv_scr_act(), LV_ALIGN_IN_RIGHT_MID, 0, 0);
 
   label_time_ampm = lv_label_create(lv_scr_act(), nullptr);
   lv_label_set_text_static(label_time_ampm, "");
@@ -80,6 +78,15 @@ WatchFaceDigital::~WatchFaceDigital() {
   lv_obj_clean(lv_scr_act());
 }
 
+void WatchFaceDigital::OnHide() {
+  lv_task_set_prio(taskRefresh, LV_TASK_PRIO_OFF);
+}
+
+void WatchFaceDigital::OnShow() {
+  lv_task_set_prio(taskRefresh, LV_TASK_PRIO_MID);
+  Refresh();
+}
+
 void WatchFaceDigital::Refresh() {
   statusIcons.Update();
 
@@ -120,11 +127,12 @@ void WatchFaceDigital::Refresh() {
           ampmChar[0] = 'P';
         }
         lv_label_set_text(label_time_ampm, ampmChar);
-        lv_label_set_text_fmt(label_time, "%2d:%02d", hour, minute);
-        lv_obj_align(label_time, lv_scr_act(), LV_ALIGN_IN_RIGHT_MID, 0, 0);
+        // Only the digits that changed are redrawn
+        timeDigits.SetTime(hour, minute, 0, false);
+        lv_obj_align(timeDigits.GetObject(), lv_scr_act(), LV_ALIGN_IN_RIGHT_MID, 0, 0);
       } else {
-        lv_label_set_text_fmt(label_time, "%02d:%02d", hour, minute);
-        lv_obj_align(label_time, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
+        timeDigits.SetTime(hour, minute);
+        lv_obj_align(timeDigits.GetObject(), lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
       }
     }
 
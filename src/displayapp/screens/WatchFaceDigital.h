@@ -8,6 +8,7 @@
 #include "components/datetime/DateTimeController.h"
 #include "components/ble/BleController.h"
 #include "displayapp/widgets/StatusIcons.h"
+#include "displayapp/widgets/TimeDigits.h"
 
 namespace Pinetime {
   namespace Controllers {
@@ -35,6 +36,8 @@ namespace Pinetime {
         ~WatchFaceDigital() override;
 
         void Refresh() override;
+        void OnHide() override;
+        void OnShow() override;
 
       private:
         uint8_t displayedHour = -1;
@@ -56,7 +59,7 @@ namespace Pinetime {
         DirtyValue<bool> heartbeatRunning {};
         DirtyValue<bool> notificationState {};
 
-        lv_obj_t* label_time;
+        Widgets::TimeDigits timeDigits;
         lv_obj_t* label_time_ampm;
         lv_obj_t* label_date;
         lv_obj_t* heartbeatIcon;
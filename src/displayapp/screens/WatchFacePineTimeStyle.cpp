@@ -31,6 +31,7 @@
 #include "components/battery/BatteryController.h"
 #include "components/ble/BleController.h"
 #include "components/ble/NotificationManager.h"
+#include "components/fonts/FontStore.h"
 #include "components/motion/MotionController.h"
 #include "components/settings/Settings.h"
 #include "displayapp/DisplayApp.h"
@@ -343,6 +344,15 @@ void WatchFacePineTimeStyle::AlignIcons() {
   }
 }
 
+void WatchFacePineTimeStyle::OnHide() {
+  lv_task_set_prio(taskRefresh, LV_TASK_PRIO_OFF);
+}
+
+void WatchFacePineTimeStyle::OnShow() {
+  lv_task_set_prio(taskRefresh, LV_TASK_PRIO_MID);
+  Refresh();
+}
+
 void WatchFacePineTimeStyle::Refresh() {
   isCharging = batteryController.IsCharging();
   if (isCharging.IsUpdated()) {
@@ -413,6 +423,9 @@ void WatchFacePineTimeStyle::Refresh() {
         lv_label_set_text_fmt(timeDD1, "%02d", hour);
         lv_label_set_text_fmt(timeDD2, "%02d", minute);
       }
+      // Reads the new digits from the external flash at once instead of one by one while drawing
+      Controllers::FontStore::Prefetch(timeDD1);
+      Controllers::FontStore::Prefetch(timeDD2);
     }
 
     if ((year != currentYear) || (month != currentMonth) || (dayOfWeek != currentDayOfWeek) || (day != currentDay)) {
@@ -37,6 +37,8 @@ namespace Pinetime {
         bool OnButtonPushed() override;
 
         void Refresh() override;
+        void OnHide() override;
+        void OnShow() override;
 
         void UpdateSelected(lv_obj_t* object, lv_event_t event);
 
@@ -76,6 +76,15 @@ WatchFaceTerminal::~WatchFaceTerminal() {
   lv_obj_clean(lv_scr_act());
 }
 
+void WatchFaceTerminal::OnHide() {
+  lv_task_set_prio(taskRefresh, LV_TASK_PRIO_OFF);
+}
+
+void WatchFaceTerminal::OnShow() {
+  lv_task_set_prio(taskRefresh, LV_TASK_PRIO_MID);
+  Refresh();
+}
+
 void WatchFaceTerminal::Refresh() {
   powerPresent = batteryController.IsPowerPresent();
   batteryPercentRemaining = batteryController.PercentRemaining();
@@ -33,6 +33,8 @@ namespace Pinetime {
         ~WatchFaceTerminal() override;
 
         void Refresh() override;
+        void OnHide() override;
+        void OnShow() override;
 
       private:
         uint8_t displayedHour = -1;
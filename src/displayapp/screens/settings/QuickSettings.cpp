@@ -3,6 +3,7 @@
 #include "displayapp/screens/Symbols.h"
 #include "displayapp/screens/BatteryIcon.h"
 #include <components/ble/BleController.h>
+#include "lv_pinetime_styles.h"
 
 using namespace Pinetime::Applications::Screens;
 
@@ -47,15 +48,12 @@ QuickSettings::QuickSettings(Pinetime::Applications::DisplayApp* app,
   static constexpr uint8_t buttonWidth = (LV_HOR_RES_MAX - innerDistance) / 2; // wide buttons
   // static constexpr uint8_t buttonWidth = buttonHeight; // square buttons
   static constexpr uint8_t buttonXOffset = (LV_HOR_RES_MAX - buttonWidth * 2 - innerDistance) / 2;
-
-  lv_style_init(&btn_style);
-  lv_style_set_radius(&btn_style, LV_STATE_DEFAULT, buttonHeight / 4);
-  lv_style_set_bg_color(&btn_style, LV_STATE_DEFAULT, LV_COLOR_MAKE(0x38, 0x38, 0x38));
+  static_assert(buttonHeight / 4 == 25, "Radius of quick_settings_btn in styles/styles.json");
 
   btn1 = lv_btn_create(lv_scr_act(), nullptr);
   btn1->user_data = this;
   lv_obj_set_event_cb(btn1, ButtonEventHandler);
-  lv_obj_add_style(btn1, LV_BTN_PART_MAIN, &btn_style);
+  lv_obj_add_style(btn1, LV_BTN_PART_MAIN, &lv_pinetime_style_quick_settings_btn);
   lv_obj_set_size(btn1, buttonWidth, buttonHeight);
   lv_obj_align(btn1, nullptr, LV_ALIGN_IN_TOP_LEFT, buttonXOffset, barHeight);
 
@@ -66,7 +64,7 @@ QuickSettings::QuickSettings(Pinetime::Applications::DisplayApp* app,
   btn2 = lv_btn_create(lv_scr_act(), nullptr);
   btn2->user_data = this;
   lv_obj_set_event_cb(btn2, ButtonEventHandler);
-  lv_obj_add_style(btn2, LV_BTN_PART_MAIN, &btn_style);
+  lv_obj_add_style(btn2, LV_BTN_PART_MAIN, &lv_pinetime_style_quick_settings_btn);
   lv_obj_set_size(btn2, buttonWidth, buttonHeight);
   lv_obj_align(btn2, nullptr, LV_ALIGN_IN_TOP_RIGHT, -buttonXOffset, barHeight);
 
@@ -79,7 +77,7 @@ QuickSettings::QuickSettings(Pinetime::Applications::DisplayApp* app,
   btn3->user_data = this;
   lv_obj_set_event_cb(btn3, ButtonEventHandler);
   lv_btn_set_checkable(btn3, true);
-  lv_obj_add_style(btn3, LV_BTN_PART_MAIN, &btn_style);
+  lv_obj_add_style(btn3, LV_BTN_PART_MAIN, &lv_pinetime_style_quick_settings_btn);
   lv_obj_set_size(btn3, buttonWidth, buttonHeight);
   lv_obj_align(btn3, nullptr, LV_ALIGN_IN_BOTTOM_LEFT, buttonXOffset, 0);
 
@@ -96,7 +94,7 @@ QuickSettings::QuickSettings(Pinetime::Applications::DisplayApp* app,
   btn4 = lv_btn_create(lv_scr_act(), nullptr);
   btn4->user_data = this;
   lv_obj_set_event_cb(btn4, ButtonEventHandler);
-  lv_obj_add_style(btn4, LV_BTN_PART_MAIN, &btn_style);
+  lv_obj_add_style(btn4, LV_BTN_PART_MAIN, &lv_pinetime_style_quick_settings_btn);
   lv_obj_set_size(btn4, buttonWidth, buttonHeight);
   lv_obj_align(btn4, nullptr, LV_ALIGN_IN_BOTTOM_RIGHT, -buttonXOffset, 0);
 
@@ -110,7 +108,6 @@ QuickSettings::QuickSettings(Pinetime::Applications::DisplayApp* app,
 }
 
 QuickSettings::~QuickSettings() {
-  lv_style_reset(&btn_style);
   lv_task_del(taskUpdate);
   lv_obj_clean(lv_scr_act());
   settingsController.SaveSettings();
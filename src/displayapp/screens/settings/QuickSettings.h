@@ -40,8 +40,6 @@ namespace Pinetime {
         lv_task_t* taskUpdate;
         lv_obj_t* label_time;
 
-        lv_style_t btn_style;
-
         lv_obj_t* btn1;
         lv_obj_t* btn1_lvl;
         lv_obj_t* btn2;
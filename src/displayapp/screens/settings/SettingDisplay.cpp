@@ -56,6 +56,13 @@ SettingDisplay::SettingDisplay(Pinetime::Applications::DisplayApp* app, Pinetime
       lv_checkbox_set_checked(cbOption[i], true);
     }
   }
+
+  // Minimal clock while sleeping, instead of a blank screen
+  cbAlwaysOn = lv_checkbox_create(container1, nullptr);
+  lv_checkbox_set_text_static(cbAlwaysOn, "Always on");
+  cbAlwaysOn->user_data = this;
+  lv_obj_set_event_cb(cbAlwaysOn, event_handler);
+  lv_checkbox_set_checked(cbAlwaysOn, settingsController.GetAlwaysOnDisplay());
 }
 
 SettingDisplay::~SettingDisplay() {
@@ -64,6 +71,12 @@ SettingDisplay::~SettingDisplay() {
 }
 
 void SettingDisplay::UpdateSelected(lv_obj_t* object, lv_event_t event) {
+  if (object == cbAlwaysOn) {
+    if (event == LV_EVENT_VALUE_CHANGED) {
+      settingsController.SetAlwaysOnDisplay(lv_checkbox_is_checked(cbAlwaysOn));
+    }
+    return;
+  }
   if (event == LV_EVENT_CLICKED) {
     for (unsigned int i = 0; i < options.size(); i++) {
       if (object == cbOption[i]) {
@@ -1,27 +1,16 @@
 #include "displayapp/screens/settings/Settings.h"
 #include <lvgl/lvgl.h>
-#include <functional>
 #include "displayapp/Apps.h"
 #include "displayapp/DisplayApp.h"
 
 using namespace Pinetime::Applications::Screens;
 
-constexpr std::array<List::Applications, Settings::entries.size()> Settings::entries;
+constexpr std::array<List::Applications, MAXLISTITEMS> Settings::entries;
 
-auto Settings::CreateScreenList() const {
-  std::array<std::function<std::unique_ptr<Screen>()>, nScreens> screens;
-  for (size_t i = 0; i < screens.size(); i++) {
-    screens[i] = [this, i]() -> std::unique_ptr<Screen> {
-      return CreateScreen(i);
-    };
-  }
-  return screens;
-}
-
-Settings::Settings(Pinetime::Applications::DisplayApp* app, Pinetime::Controllers::Settings& settingsController)
-  : Screen(app),
-    settingsController {settingsController},
-    screens {app, settingsController.GetSettingsMenu(), CreateScreenList(), Screens::ScreenListModes::UpDown} {
+Settings::Settings(Pinetime::Applications::DisplayApp* app,
+                   Pinetime::Components::LittleVgl& lvgl,
+                   Pinetime::Controllers::Settings& settingsController)
+  : Screen(app), list {app, lvgl, settingsController, entries} {
 }
 
 Settings::~Settings() {
@@ -29,14 +18,9 @@ Settings::~Settings() {
 }
 
 bool Settings::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
-  return screens.OnTouchEvent(event);
+  return list.OnTouchEvent(event);
 }
 
-std::unique_ptr<Screen> Settings::CreateScreen(unsigned int screenNum) const {
-  std::array<List::Applications, entriesPerScreen> screens;
-  for (int i = 0; i < entriesPerScreen; i++) {
-    screens[i] = entries[screenNum * entriesPerScreen + i];
-  }
-
-  return std::make_unique<Screens::List>(screenNum, nScreens, app, settingsController, screens);
+bool Settings::OnDragEvent(uint16_t x, uint16_t y, bool touching) {
+  return list.OnDragEvent(x, y, touching);
 }
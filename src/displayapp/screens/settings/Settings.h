@@ -3,7 +3,6 @@
 #include <array>
 #include <memory>
 #include "displayapp/screens/Screen.h"
-#include "displayapp/screens/ScreenList.h"
 #include "displayapp/screens/Symbols.h"
 #include "displayapp/screens/List.h"
 
@@ -14,44 +13,33 @@ namespace Pinetime {
 
       class Settings : public Screen {
       public:
-        Settings(DisplayApp* app, Pinetime::Controllers::Settings& settingsController);
+        Settings(DisplayApp* app, Pinetime::Components::LittleVgl& lvgl, Pinetime::Controllers::Settings& settingsController);
         ~Settings() override;
 
         bool OnTouchEvent(Pinetime::Applications::TouchEvents event) override;
+        bool OnDragEvent(uint16_t x, uint16_t y, bool touching) override;
 
       private:
-        auto CreateScreenList() const;
-        std::unique_ptr<Screen> CreateScreen(unsigned int screenNum) const;
-
-        Controllers::Settings& settingsController;
-
-        static constexpr int entriesPerScreen = 4;
-
-        // Increment this when more space is needed
-        static constexpr int nScreens = 4;
-
-        static constexpr std::array<List::Applications, entriesPerScreen * nScreens> entries {{
+        // Increase MAXLISTITEMS when more space is needed
+        static constexpr std::array<List::Applications, MAXLISTITEMS> entries {{
           {Symbols::sun, "Display", Apps::SettingDisplay},
           {Symbols::eye, "Wake Up", Apps::SettingWakeUp},
           {Symbols::clock, "Time format", Apps::SettingTimeFormat},
           {Symbols::home, "Watch face", Apps::SettingWatchFace},
-
           {Symbols::shoe, "Steps", Apps::SettingSteps},
           {Symbols::clock, "Set date", Apps::SettingSetDate},
           {Symbols::clock, "Set time", Apps::SettingSetTime},
           {Symbols::batteryHalf, "Battery", Apps::BatteryInfo},
-
           {Symbols::clock, "Chimes", Apps::SettingChimes},
           {Symbols::tachometer, "Shake Calib.", Apps::SettingShakeThreshold},
           {Symbols::check, "Firmware", Apps::FirmwareValidation},
           {Symbols::bluetooth, "Bluetooth", Apps::SettingBluetooth},
-
           {Symbols::list, "About", Apps::SysInfo},
           {Symbols::none, "None", Apps::None},
           {Symbols::none, "None", Apps::None},
           {Symbols::none, "None", Apps::None},
         }};
-        ScreenList<nScreens> screens;
+        List list;
       };
     }
   }
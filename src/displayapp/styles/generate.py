@@ -0,0 +1,249 @@
+#!/usr/bin/env python
+
+# Generates the LVGL styles of styles.json as constant style maps, in the flash instead of the memory of LVGL.
+#
+# A style of LVGL 7 is a pointer to its map: a list of properties (lv_style_property_t: the id of the property and its
+# state), each one followed by its value (lv_style_int_t, lv_color_t, lv_opa_t or a pointer), ended by
+# _LV_STYLE_CLOSING_PROP. lv_style_set_*() builds it in the memory of LVGL with a reallocation for each property. Here
+# each map is a packed constant structure with the same layout, and the style points to it.
+
+import sys
+import json
+import os.path
+import argparse
+import typing
+
+# Kind of the value of each property: its C type, the id range of the type in LVGL, checked at compile time, and the
+# function of LVGL that sets it at runtime
+KINDS = {
+    'int': ('lv_style_int_t', '(({}) & 0xF) < LV_STYLE_ID_COLOR', '_lv_style_set_int'),
+    'color': ('lv_color_t', '(({}) & 0xF) >= LV_STYLE_ID_COLOR && (({}) & 0xF) < LV_STYLE_ID_OPA', '_lv_style_set_color'),
+    'opa': ('lv_opa_t', '(({}) & 0xF) >= LV_STYLE_ID_OPA && (({}) & 0xF) < LV_STYLE_ID_PTR', '_lv_style_set_opa'),
+    'font': ('const lv_font_t*', '(({}) & 0xF) >= LV_STYLE_ID_PTR', '_lv_style_set_ptr'),
+}
+
+PROPERTIES = {
+    'radius': 'int', 'size': 'int', 'line_rounded': 'int', 'text_line_space': 'int',
+    'pad_top': 'int', 'pad_bottom': 'int', 'pad_left': 'int', 'pad_right': 'int', 'pad_inner': 'int',
+    'border_width': 'int', 'border_side': 'int', 'outline_width': 'int', 'outline_pad': 'int',
+    'line_width': 'int', 'scale_width': 'int', 'scale_end_line_width': 'int',
+    'transition_time': 'int', 'transition_delay': 'int', 'transition_prop_6': 'int',
+    'bg_color': 'color', 'border_color': 'color', 'outline_color': 'color', 'text_color': 'color',
+    'value_color': 'color', 'image_recolor': 'color', 'line_color': 'color', 'pattern_recolor': 'color',
+    'scale_grad_color': 'color', 'scale_end_color': 'color',
+    'bg_opa': 'opa', 'outline_opa': 'opa',
+    'text_font': 'font', 'value_font': 'font',
+}
+
+# Shorthands of lv_style_set_*()
+SHORTHANDS = {
+    'pad_all': ['pad_top', 'pad_bottom', 'pad_left', 'pad_right'],
+}
+
+STATES = ('DEFAULT', 'CHECKED', 'FOCUSED', 'EDITED', 'HOVERED', 'PRESSED', 'DISABLED')
+
+PREFIX = 'lv_pinetime_style_'
+
+
+class Property(object):
+    def __init__(self, name: str, state: str, value):
+        if name not in PROPERTIES:
+            raise ValueError(f'unknown property {name}')
+        if state not in STATES:
+            raise ValueError(f'unknown state {state}')
+        self.name = name
+        self.kind = PROPERTIES[name]
+        self.constant = 'LV_STYLE_' + name.upper()
+        self.state = state
+        self.value = value
+
+    def c_id(self) -> str:
+        return f'{self.constant} | (LV_STATE_{self.state} << LV_STYLE_STATE_POS)'
+
+    def c_value(self) -> str:
+        if self.kind == 'font':
+            return '&' + self.value
+        return str(self.value)
+
+
+def parse_styles(description: dict) -> typing.Dict[str, typing.List[Property]]:
+    styles = {}
+    for name, entries in description.items():
+        properties = []
+        for entry in entries:
+            prop, state, value = entry
+            for expanded in SHORTHANDS.get(prop, [prop]):
+                properties.append(Property(expanded, state, value))
+        ids = [(p.name, p.state) for p in properties]
+        if len(set(ids)) != len(ids):
+            raise ValueError(f'style {name}: a property is set twice for the same state')
+        styles[name] = properties
+    return styles
+
+
+def gen_header(styles: typing.Dict[str, typing.List[Property]]) -> str:
+    lines = ['// Generated by src/displayapp/styles/generate.py from styles.json, do not edit',
+             '#pragma once',
+             '',
+             '#ifdef __cplusplus',
+             'extern "C" {',
+             '#endif',
+             '',
+             '#include <lvgl/lvgl.h>',
+             '',
+             '/* Styles whose maps are constant: lv_style_set_*(), lv_style_remove_prop() and lv_style_reset() must not be',
+             ' * called on them. They can be added to any number of objects with lv_obj_add_style(). */']
+    for name in styles:
+        lines.append(f'extern lv_style_t {PREFIX}{name};')
+    lines += ['',
+              '#ifdef __cplusplus',
+              '} /* extern "C" */',
+              '#endif',
+              '']
+    return '\n'.join(lines)
+
+
+def gen_values_prologue(styles: typing.Dict[str, typing.List[Property]]) -> typing.List[str]:
+    """The definitions used by the values of the properties"""
+    fonts = sorted({p.value for properties in styles.values() for p in properties if p.kind == 'font'})
+    lines = ['// LV_DPX() with the default DPI of the display, as a constant',
+             '#define LV_PINETIME_DPX(n) ((n) == 0 ? 0 : ((LV_DPI * (n) + 80) / 160 > 1 ? (LV_DPI * (n) + 80) / 160 : 1))',
+             '']
+    for font in fonts:
+        lines.append(f'LV_FONT_DECLARE({font})')
+    if fonts:
+        lines.append('')
+    return lines
+
+
+def gen_source(styles: typing.Dict[str, typing.List[Property]]) -> str:
+    constants = sorted({(p.constant, p.kind) for properties in styles.values() for p in properties})
+
+    lines = ['// Generated by src/displayapp/styles/generate.py from styles.json, do not edit',
+             '#include "lv_pinetime_styles.h"',
+             '#include "displayapp/lv_pinetime_theme.h"',
+             '',
+             '#if LV_USE_ASSERT_STYLE',
+             '  #error "The constant styles don\'t have the sentinel of LV_USE_ASSERT_STYLE"',
+             '#endif',
+             '']
+    lines += gen_values_prologue(styles)
+    for constant, kind in constants:
+        check = KINDS[kind][1].format(constant, constant)
+        lines.append(f'_Static_assert({check}, "Type of {constant}");')
+    lines.append('')
+
+    for name, properties in styles.items():
+        lines.append('static const struct __attribute__((packed)) {')
+        for i, p in enumerate(properties):
+            lines.append(f'  lv_style_property_t id{i};')
+            lines.append(f'  {KINDS[p.kind][0]} value{i};')
+        lines.append('  lv_style_property_t end;')
+        lines.append(f'}} {name}_map = {{')
+        for p in properties:
+            lines.append(f'  {p.c_id()},')
+            lines.append(f'  {p.c_value()},')
+        lines.append('  _LV_STYLE_CLOSING_PROP,')
+        lines.append('};')
+        lines.append(f'lv_style_t {PREFIX}{name} = {{.map = (uint8_t*) &{name}_map}};')
+        lines.append('')
+    return '\n'.join(lines)
+
+
+def gen_runtime_header() -> str:
+    lines = ['// Generated by src/displayapp/styles/generate.py from styles.json, do not edit',
+             '#pragma once',
+             '',
+             '#include "lv_pinetime_styles.h"',
+             '',
+             '#ifdef __cplusplus',
+             'extern "C" {',
+             '#endif',
+             '',
+             '/* The styles of styles.json built at runtime with the functions of LVGL, like lv_style_set_*(), to check and',
+             ' * measure the constant styles on the host (tests/displayapp/StylesTest.cpp) */',
+             'typedef struct {',
+             '  const char* name;',
+             '  lv_style_t* constant;',
+             '  void (*build)(lv_style_t* style);',
+             '} lv_pinetime_style_builder_t;',
+             '',
+             'enum { LV_PINETIME_STYLE_INT, LV_PINETIME_STYLE_COLOR, LV_PINETIME_STYLE_OPA, LV_PINETIME_STYLE_PTR };',
+             '',
+             'typedef struct {',
+             '  uint16_t style; /* Index in lv_pinetime_style_builders */',
+             '  lv_style_property_t id;',
+             '  uint8_t kind;',
+             '} lv_pinetime_style_property_t;',
+             '',
+             'extern const lv_pinetime_style_builder_t lv_pinetime_style_builders[];',
+             'extern const size_t lv_pinetime_style_nb_builders;',
+             'extern const lv_pinetime_style_property_t lv_pinetime_style_properties[];',
+             'extern const size_t lv_pinetime_style_nb_properties;',
+             '',
+             '#ifdef __cplusplus',
+             '} /* extern "C" */',
+             '#endif',
+             '']
+    return '\n'.join(lines)
+
+
+def gen_runtime_source(styles: typing.Dict[str, typing.List[Property]]) -> str:
+    kinds = {'int': 'LV_PINETIME_STYLE_INT', 'color': 'LV_PINETIME_STYLE_COLOR', 'opa': 'LV_PINETIME_STYLE_OPA',
+             'font': 'LV_PINETIME_STYLE_PTR'}
+    lines = ['// Generated by src/displayapp/styles/generate.py from styles.json, do not edit',
+             '#include "lv_pinetime_styles_runtime.h"',
+             '#include "displayapp/lv_pinetime_theme.h"',
+             '']
+    lines += gen_values_prologue(styles)
+
+    for name, properties in styles.items():
+        lines.append(f'static void build_{name}(lv_style_t* style) {{')
+        lines.append('  lv_style_init(style);')
+        for p in properties:
+            lines.append(f'  {KINDS[p.kind][2]}(style, {p.c_id()}, {p.c_value()});')
+        lines.append('}')
+        lines.append('')
+
+    lines.append('const lv_pinetime_style_builder_t lv_pinetime_style_builders[] = {')
+    for name in styles:
+        lines.append(f'  {{"{name}", &{PREFIX}{name}, build_{name}}},')
+    lines.append('};')
+    lines.append(f'const size_t lv_pinetime_style_nb_builders = {len(styles)};')
+    lines.append('')
+
+    lines.append('const lv_pinetime_style_property_t lv_pinetime_style_properties[] = {')
+    for index, properties in enumerate(styles.values()):
+        for p in properties:
+            lines.append(f'  {{{index}, {p.c_id()}, {kinds[p.kind]}}},')
+    lines.append('};')
+    lines.append(f'const size_t lv_pinetime_style_nb_properties = {sum(len(p) for p in styles.values())};')
+    lines.append('')
+    return '\n'.join(lines)
+
+
+def main():
+    ap = argparse.ArgumentParser(description='generate the constant LVGL styles')
+    ap.add_argument('config', type=str, help='styles.json file')
+    ap.add_argument('--output', type=str, default='.', help='directory of lv_pinetime_styles.h and .c')
+    ap.add_argument('--runtime', action='store_true',
+                    help='also generate lv_pinetime_styles_runtime.h and .c, the styles built at runtime (host tests)')
+    args = ap.parse_args()
+
+    with open(args.config, 'r') as f:
+        styles = parse_styles(json.load(f))
+
+    with open(os.path.join(args.output, 'lv_pinetime_styles.h'), 'w') as f:
+        f.write(gen_header(styles))
+    with open(os.path.join(args.output, 'lv_pinetime_styles.c'), 'w') as f:
+        f.write(gen_source(styles))
+    if args.runtime:
+        with open(os.path.join(args.output, 'lv_pinetime_styles_runtime.h'), 'w') as f:
+            f.write(gen_runtime_header())
+        with open(os.path.join(args.output, 'lv_pinetime_styles_runtime.c'), 'w') as f:
+            f.write(gen_runtime_source(styles))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,86 @@
+#include "displayapp/widgets/ClockHand.h"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace Pinetime::Applications::Widgets;
+
+namespace {
+  // sin(90) = 1 so the value of _lv_trigo_sin(90) is the scaling factor
+  const auto LV_TRIG_SCALE = _lv_trigo_sin(90);
+}
+
+ClockHand::ClockHand(int16_t innerRadius, int16_t outerRadius, lv_style_int_t width, lv_color_t color, bool rounded)
+  : innerRadius {innerRadius}, outerRadius {outerRadius} {
+  lv_draw_line_dsc_init(&lineDsc);
+  lineDsc.width = width;
+  lineDsc.color = color;
+  lineDsc.round_start = rounded;
+  lineDsc.round_end = rounded;
+}
+
+void ClockHand::Create(lv_obj_t* parent) {
+  object = lv_obj_create(parent, nullptr);
+  lv_obj_set_size(object, LV_HOR_RES, LV_VER_RES);
+  lv_obj_set_pos(object, 0, 0);
+  lv_obj_set_click(object, false);
+  lv_obj_set_user_data(object, this);
+  // Draws the line only, not the background of the object
+  lv_obj_set_design_cb(object, Design);
+}
+
+void ClockHand::SetAngle(int16_t newAngle) {
+  if (newAngle == angle) {
+    return;
+  }
+  if (angle >= 0) {
+    InvalidateLine();
+  }
+  angle = newAngle;
+  points[0] = Point(innerRadius, angle);
+  points[1] = Point(outerRadius, angle);
+  InvalidateLine();
+}
+
+lv_design_res_t ClockHand::Design(lv_obj_t* obj, const lv_area_t* clipArea, lv_design_mode_t mode) {
+  if (mode == LV_DESIGN_COVER_CHK) {
+    return LV_DESIGN_RES_NOT_COVER;
+  }
+  const auto* hand = static_cast<const ClockHand*>(lv_obj_get_user_data(obj));
+  if (mode == LV_DESIGN_DRAW_MAIN && hand->angle >= 0) {
+    lv_draw_line(&hand->points[0], &hand->points[1], clipArea, &hand->lineDsc);
+  }
+  return LV_DESIGN_RES_OK;
+}
+
+lv_point_t ClockHand::Point(int16_t radius, int16_t angle) const {
+  // _lv_trigo_sin() is a lookup table of fixed-point values
+  const lv_coord_t centerX = object->coords.x1 + lv_obj_get_width(object) / 2;
+  const lv_coord_t centerY = object->coords.y1 + lv_obj_get_height(object) / 2;
+  const int32_t sine = _lv_trigo_sin(angle);
+  const int32_t cosine = _lv_trigo_sin(angle + 90);
+  return lv_point_t {.x = static_cast<lv_coord_t>(centerX + radius * sine / LV_TRIG_SCALE),
+                     .y = static_cast<lv_coord_t>(centerY - radius * cosine / LV_TRIG_SCALE)};
+}
+
+void ClockHand::InvalidateLine() const {
+  // The line is split into strips along its main axis: the areas around the strips cover the line, its rounded ends
+  // and its anti-aliasing, with far fewer pixels than its bounding box when it is diagonal
+  const lv_coord_t dx = points[1].x - points[0].x;
+  const lv_coord_t dy = points[1].y - points[0].y;
+  const lv_coord_t length = std::max(std::abs(dx), std::abs(dy));
+  const lv_coord_t nbStrips = std::max<lv_coord_t>(1, (length + StripLength - 1) / StripLength);
+  const lv_coord_t margin = lineDsc.width / 2 + 2;
+
+  lv_point_t start = points[0];
+  for (lv_coord_t i = 1; i <= nbStrips; i++) {
+    const lv_point_t end {static_cast<lv_coord_t>(points[0].x + dx * i / nbStrips),
+                          static_cast<lv_coord_t>(points[0].y + dy * i / nbStrips)};
+    lv_area_t area;
+    area.x1 = std::min(start.x, end.x) - margin;
+    area.y1 = std::min(start.y, end.y) - margin;
+    area.x2 = std::max(start.x, end.x) + margin;
+    area.y2 = std::max(start.y, end.y) + margin;
+    lv_obj_invalidate_area(object, &area);
+    start = end;
+  }
+}
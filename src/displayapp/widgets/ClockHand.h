@@ -0,0 +1,41 @@
+#pragma once
+#include <lvgl/lvgl.h>
+
+namespace Pinetime {
+  namespace Applications {
+    namespace Widgets {
+      /**
+       * A hand of an analog clock: a line from the center of the screen, drawn by an object that covers the screen.
+       *
+       * Moving an lv_line invalidates the bounding boxes of its old and new positions: up to 90x90 pixels each for a
+       * diagonal second hand. The hand invalidates a chain of small areas along the old and new lines instead, so LVGL
+       * only redraws the background around them.
+       */
+      class ClockHand {
+      public:
+        /// The line goes from innerRadius (< 0: on the other side of the center) to outerRadius
+        ClockHand(int16_t innerRadius, int16_t outerRadius, lv_style_int_t width, lv_color_t color, bool rounded);
+
+        void Create(lv_obj_t* parent);
+        /// Angle in degrees, clockwise from 12 o'clock
+        void SetAngle(int16_t angle);
+
+      private:
+        // Length of the areas invalidated along the line, on its main axis
+        static constexpr lv_coord_t StripLength = 32;
+
+        static lv_design_res_t Design(lv_obj_t* obj, const lv_area_t* clipArea, lv_design_mode_t mode);
+        lv_point_t Point(int16_t radius, int16_t angle) const;
+        void InvalidateLine() const;
+
+        int16_t innerRadius;
+        int16_t outerRadius;
+        lv_draw_line_dsc_t lineDsc;
+
+        lv_obj_t* object = nullptr;
+        int16_t angle = -1;
+        lv_point_t points[2];
+      };
+    }
+  }
+}
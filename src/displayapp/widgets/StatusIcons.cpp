@@ -8,7 +8,11 @@ StatusIcons::StatusIcons(Controllers::Battery& batteryController, Controllers::B
 }
 
 void StatusIcons::Create() {
-  container = lv_cont_create(lv_scr_act(), nullptr);
+  Create(lv_scr_act());
+}
+
+void StatusIcons::Create(lv_obj_t* parent) {
+  container = lv_cont_create(parent, nullptr);
   lv_cont_set_layout(container, LV_LAYOUT_ROW_TOP);
   lv_cont_set_fit(container, LV_FIT_TIGHT);
   lv_obj_set_style_local_pad_inner(container, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, 5);
@@ -15,6 +15,7 @@ namespace Pinetime {
         StatusIcons(Controllers::Battery& batteryController, Controllers::Ble& bleController);
         void Align();
         void Create();
+        void Create(lv_obj_t* parent);
         lv_obj_t* GetObject() {
           return container;
         }
@@ -0,0 +1,75 @@
+#include "displayapp/widgets/TimeDigits.h"
+#include "components/fonts/FontStore.h"
+
+using namespace Pinetime::Applications::Widgets;
+
+namespace {
+  // Static texts of the cells: lv_label_set_text_static() doesn't copy them
+  constexpr const char* cellTexts[] = {"0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "", ":"};
+}
+
+TimeDigits::TimeDigits(bool withSeconds) : nbCells {static_cast<uint8_t>(withSeconds ? 8 : 5)} {
+}
+
+void TimeDigits::Create(lv_obj_t* parent, const lv_font_t* font) {
+  this->font = font;
+  const lv_coord_t cellWidth = lv_font_get_glyph_width(font, '0', '0');
+
+  container = lv_cont_create(parent, nullptr);
+  lv_obj_set_style_local_bg_opa(container, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, LV_OPA_TRANSP);
+  lv_obj_set_style_local_border_width(container, LV_CONT_PART_MAIN, LV_STATE_DEFAULT, 0);
+  lv_obj_set_size(container, cellWidth * nbCells, lv_font_get_line_height(font));
+
+  for (uint8_t i = 0; i < nbCells; i++) {
+    cells[i] = lv_label_create(container, nullptr);
+    lv_obj_set_style_local_text_font(cells[i], LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, font);
+    lv_obj_set_pos(cells[i], i * cellWidth, 0);
+    values[i] = (i % 3 == 2) ? Colon : Blank;
+    lv_label_set_text_static(cells[i], cellTexts[values[i]]);
+  }
+}
+
+void TimeDigits::SetTime(uint8_t hours, uint8_t minutes, uint8_t seconds, bool leadingZero) {
+  SetCell(0, (hours >= 10 || leadingZero) ? hours / 10 : Blank);
+  SetCell(1, hours % 10);
+  SetCell(3, minutes / 10);
+  SetCell(4, minutes % 10);
+  if (nbCells > 5) {
+    SetCell(6, seconds / 10);
+    SetCell(7, seconds % 10);
+  }
+
+  // Reads the glyphs of the new digits at once if the font is in the external flash
+  char text[MaxCells + 1];
+  uint8_t length = 0;
+  for (uint8_t i = 0; i < nbCells; i++) {
+    if (values[i] != Blank) {
+      text[length++] = (values[i] == Colon) ? ':' : '0' + values[i];
+    }
+  }
+  text[length] = '\0';
+  Controllers::FontStore::Prefetch(font, text);
+}
+
+void TimeDigits::SetAnimationTime(uint16_t milliseconds) {
+  animationTime = milliseconds;
+}
+
+void TimeDigits::SetCell(uint8_t index, uint8_t value) {
+  if (values[index] == value) {
+    return;
+  }
+  values[index] = value;
+  lv_label_set_text_static(cells[index], cellTexts[value]);
+
+  if (animationTime > 0) {
+    // The container clips the digit while it slides
+    lv_anim_t animation;
+    lv_anim_init(&animation);
+    lv_anim_set_var(&animation, cells[index]);
+    lv_anim_set_exec_cb(&animation, reinterpret_cast<lv_anim_exec_xcb_t>(lv_obj_set_y));
+    lv_anim_set_values(&animation, -lv_obj_get_height(container), 0);
+    lv_anim_set_time(&animation, animationTime);
+    lv_anim_start(&animation);
+  }
+}
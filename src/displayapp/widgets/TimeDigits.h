@@ -0,0 +1,45 @@
+#pragma once
+#include <lvgl/lvgl.h>
+
+namespace Pinetime {
+  namespace Applications {
+    namespace Widgets {
+      /**
+       * The time in large digits ("12:34" or "12:34:56"), with one label per character of a monospaced font.
+       *
+       * Setting the text of a single label redraws the whole time each minute, and lv_label_set_text() allocates it.
+       * Here only the labels of the digits that changed are updated, with static texts: LVGL only redraws these
+       * digits. A new digit can slide in from the top of its cell, which doesn't redraw the other ones either.
+       */
+      class TimeDigits {
+      public:
+        explicit TimeDigits(bool withSeconds = false);
+
+        /// The font must be monospaced
+        void Create(lv_obj_t* parent, const lv_font_t* font);
+        /// The first digit is blank instead of 0 if the hours are < 10 and leadingZero is false
+        void SetTime(uint8_t hours, uint8_t minutes, uint8_t seconds = 0, bool leadingZero = true);
+        /// Duration of the slide of the new digits, 0 (default) to disable it
+        void SetAnimationTime(uint16_t milliseconds);
+
+        lv_obj_t* GetObject() const {
+          return container;
+        }
+
+      private:
+        static constexpr uint8_t MaxCells = 8;
+        static constexpr uint8_t Blank = 10;
+        static constexpr uint8_t Colon = 11;
+
+        void SetCell(uint8_t index, uint8_t value);
+
+        const uint8_t nbCells;
+        lv_obj_t* container = nullptr;
+        lv_obj_t* cells[MaxCells];
+        uint8_t values[MaxCells];
+        const lv_font_t* font = nullptr;
+        uint16_t animationTime = 0;
+      };
+    }
+  }
+}
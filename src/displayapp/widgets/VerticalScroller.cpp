@@ -0,0 +1,105 @@
+#include "displayapp/widgets/VerticalScroller.h"
+#include <algorithm>
+#include <cstdlib>
+#include "displayapp/LittleVgl.h"
+#include "touchhandler/GestureRecognizer.h"
+
+using namespace Pinetime::Applications::Widgets;
+
+VerticalScroller::VerticalScroller(Components::LittleVgl& lvgl) : lvgl {lvgl} {
+}
+
+void VerticalScroller::SetContent(lv_obj_t* newContent) {
+  content = newContent;
+  dragging = false;
+  if (content != nullptr) {
+    contentStartY = lv_obj_get_y(content);
+  }
+}
+
+bool VerticalScroller::OnDragEvent(uint16_t y, bool isTouching) {
+  if (!isTouching) {
+    touching = false;
+    dragging = false;
+    return false;
+  }
+  if (content == nullptr) {
+    return false;
+  }
+
+  if (!touching) {
+    touching = true;
+    touchStartY = y;
+    contentStartY = lv_obj_get_y(content);
+    return false;
+  }
+
+  if (!dragging) {
+    // Same slop as the gesture recognizer: a tap doesn't scroll
+    if (std::abs(y - touchStartY) <= Controllers::GestureRecognizer::TouchSlop || MinY() == 0) {
+      return false;
+    }
+    dragging = true;
+    lastY = y;
+  }
+
+  ScrollBy(y - lastY);
+  lastY = y;
+  return true;
+}
+
+bool VerticalScroller::ScrollBy(lv_coord_t dy) {
+  if (content == nullptr) {
+    return false;
+  }
+  const lv_coord_t y = lv_obj_get_y(content);
+  const lv_coord_t targetY = std::max(MinY(), std::min<lv_coord_t>(0, y + dy));
+  if (targetY == y) {
+    return false;
+  }
+
+  // A long step is split, each part only draws the lines it exposes
+  lv_coord_t currentY = y;
+  while (currentY != targetY) {
+    const lv_coord_t step = std::max<lv_coord_t>(-Components::LittleVgl::MaxScrollLines,
+                                                 std::min<lv_coord_t>(Components::LittleVgl::MaxScrollLines, targetY - currentY));
+    // The areas already invalidated must be drawn before the content moves: the scroll only draws the exposed strip
+    lv_refr_now(nullptr);
+    currentY += step;
+    lv_obj_set_y(content, currentY);
+    // If the display can't scroll now, LVGL redraws the whole screen
+    lvgl.ScrollDisplay(-step);
+  }
+  return true;
+}
+
+void VerticalScroller::ScrollTo(lv_coord_t y) {
+  if (content == nullptr) {
+    return;
+  }
+  lv_obj_set_y(content, std::max(MinY(), std::min<lv_coord_t>(0, y)));
+  contentStartY = lv_obj_get_y(content);
+}
+
+bool VerticalScroller::ConsumesSwipe(TouchEvents swipe) const {
+  if (content == nullptr) {
+    return false;
+  }
+  // Decided from the position at the start of the touch: the swipe that brings the content to its limit still scrolls
+  switch (swipe) {
+    case TouchEvents::SwipeDown:
+      return contentStartY < 0;
+    case TouchEvents::SwipeUp:
+      return contentStartY > MinY();
+    default:
+      return false;
+  }
+}
+
+lv_coord_t VerticalScroller::GetScrollPosition() const {
+  return (content == nullptr) ? 0 : -lv_obj_get_y(content);
+}
+
+lv_coord_t VerticalScroller::MinY() const {
+  return std::min<lv_coord_t>(0, LV_VER_RES - lv_obj_get_height(content));
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <lvgl/lvgl.h>
+#include "displayapp/TouchEvents.h"
+
+namespace Pinetime {
+  namespace Components {
+    class LittleVgl;
+  }
+  namespace Applications {
+    namespace Widgets {
+      /**
+       * Scrolls a content taller than the screen with the finger, using the vertical scroll of the display: each step
+       * only draws the strip of lines it exposes (lines * 240 * 2 bytes) instead of the whole screen (115200 bytes).
+       *
+       * The content must be a child of the screen, at x = 0: the whole screen scrolls, so nothing else may be drawn on
+       * the screen (no fixed header or overlay).
+       */
+      class VerticalScroller {
+      public:
+        explicit VerticalScroller(Components::LittleVgl& lvgl);
+
+        /// Sets the content to scroll, or nullptr while there is none. Its position is kept.
+        void SetContent(lv_obj_t* content);
+        /// Touch point while touching, then touching == false on release. Returns true while the content follows the finger.
+        bool OnDragEvent(uint16_t y, bool touching);
+        /// Moves the content by dy (> 0: down), within its limits. Returns false if it didn't move.
+        bool ScrollBy(lv_coord_t dy);
+        /// Moves the content at y (<= 0) without scrolling the display, before the screen is drawn
+        void ScrollTo(lv_coord_t y);
+
+        /// Returns true if the swipe of the current or last touch scrolls the content, instead of leaving the screen
+        bool ConsumesSwipe(TouchEvents swipe) const;
+        /// Distance between the top of the content and the top of the screen
+        lv_coord_t GetScrollPosition() const;
+
+      private:
+        lv_coord_t MinY() const;
+
+        Components::LittleVgl& lvgl;
+        lv_obj_t* content = nullptr;
+
+        bool touching = false;
+        bool dragging = false;
+        uint16_t lastY = 0;
+        uint16_t touchStartY = 0;
+        lv_coord_t contentStartY = 0;
+      };
+    }
+  }
+}
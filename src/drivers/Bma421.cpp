@@ -118,6 +118,73 @@ Bma421::Values Bma421::Process() {
   // X and Y axis are swapped because of the way the sensor is mounted in the PineTime
   return {steps, data.y, data.x, data.z};
 }
+void Bma421::EnableFifo(bool enable) {
+  if (not isOk)
+    return;
+
+  auto ret = bma4_set_fifo_config(BMA4_FIFO_HEADER, BMA4_DISABLE, &bma);
+  if (ret != BMA4_OK)
+    return;
+
+  ret = bma4_set_fifo_config(BMA4_FIFO_ACCEL, enable ? BMA4_ENABLE : BMA4_DISABLE, &bma);
+  if (ret != BMA4_OK)
+    return;
+
+  if (enable) {
+    // Flush the FIFO so that the first read doesn't return stale frames
+    bma4_set_command_register(0xB0, &bma);
+  }
+  isFifoEnabled = enable;
+}
+
+bool Bma421::IsFifoEnabled() const {
+  return isFifoEnabled;
+}
+
+size_t Bma421::FifoFrameCount() {
+  if (not isOk || not isFifoEnabled)
+    return 0;
+
+  uint16_t length = 0;
+  if (bma4_get_fifo_length(&length, &bma) != BMA4_OK)
+    return 0;
+  return length / FifoFrameSize;
+}
+
+size_t Bma421::ReadFifo(AccelValues* values, size_t maxCount) {
+  if (not isOk || not isFifoEnabled || maxCount == 0)
+    return 0;
+
+  uint16_t length = 0;
+  if (bma4_get_fifo_length(&length, &bma) != BMA4_OK || length == 0)
+    return 0;
+
+  uint8_t buffer[FifoMaxFrames * FifoFrameSize];
+  if (maxCount > FifoMaxFrames)
+    maxCount = FifoMaxFrames;
+  if (length > maxCount * FifoFrameSize)
+    length = maxCount * FifoFrameSize;
+  // Only read complete frames, the remaining bytes will be read during the next call
+  length -= length % FifoFrameSize;
+
+  struct bma4_fifo_frame fifo {};
+  fifo.data = buffer;
+  fifo.length = length;
+  if (bma4_read_fifo_data(&fifo, &bma) != BMA4_OK)
+    return 0;
+
+  struct bma4_accel frames[FifoMaxFrames];
+  uint16_t count = maxCount;
+  if (bma4_extract_accel(frames, &count, &fifo, &bma) != BMA4_OK)
+    return 0;
+
+  for (uint16_t i = 0; i < count; i++) {
+    // X and Y axis are swapped because of the way the sensor is mounted in the PineTime
+    values[i] = {frames[i].y, frames[i].x, frames[i].z};
+  }
+  return count;
+}
+
 bool Bma421::IsOk() const {
   return isOk;
 }
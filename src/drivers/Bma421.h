@@ -13,6 +13,16 @@ namespace Pinetime {
         int16_t y;
         int16_t z;
       };
+      struct AccelValues {
+        int16_t x;
+        int16_t y;
+        int16_t z;
+      };
+      /// Rate at which frames are pushed into the FIFO (accelerometer ODR)
+      static constexpr uint16_t FifoSampleRate = 100;
+      /// Maximum number of frames read in a single ReadFifo() call
+      static constexpr size_t FifoMaxFrames = 20;
+      static constexpr size_t FifoFrameSize = 6;
       Bma421(TwiMaster& twiMaster, uint8_t twiAddress);
       Bma421(const Bma421&) = delete;
       Bma421& operator=(const Bma421&) = delete;
@@ -26,6 +36,15 @@ namespace Pinetime {
       Values Process();
       void ResetStepCounter();
 
+      /// Enables or disables the accelerometer FIFO (headerless, accelerometer frames only).
+      /// The FIFO is flushed when it's enabled.
+      void EnableFifo(bool enable);
+      bool IsFifoEnabled() const;
+      /// Number of complete frames waiting in the FIFO
+      size_t FifoFrameCount();
+      /// Reads up to maxCount frames accumulated in the FIFO since the last call. Returns the number of frames read.
+      size_t ReadFifo(AccelValues* values, size_t maxCount);
+
       void Read(uint8_t registerAddress, uint8_t* buffer, size_t size);
       void Write(uint8_t registerAddress, const uint8_t* data, size_t size);
 
@@ -40,6 +59,7 @@ namespace Pinetime {
       struct bma4_dev bma;
       bool isOk = false;
       bool isResetOk = false;
+      bool isFifoEnabled = false;
       DeviceTypes deviceType = DeviceTypes::Unknown;
     };
   }
@@ -91,6 +91,26 @@ void St7789::NormalModeOn() {
   nrf_delay_ms(10);
 }
 
+void St7789::PartialAreaSet(uint16_t firstLine, uint16_t lastLine) {
+  WriteCommand(static_cast<uint8_t>(Commands::PartialAreaSet));
+  WriteData(firstLine >> 8u);
+  WriteData(firstLine & 0x00ffu);
+  WriteData(lastLine >> 8u);
+  WriteData(lastLine & 0x00ffu);
+}
+
+void St7789::PartialModeOn() {
+  WriteCommand(static_cast<uint8_t>(Commands::PartialModeOn));
+}
+
+void St7789::IdleModeOn() {
+  WriteCommand(static_cast<uint8_t>(Commands::IdleModeOn));
+}
+
+void St7789::IdleModeOff() {
+  WriteCommand(static_cast<uint8_t>(Commands::IdleModeOff));
+}
+
 void St7789::DisplayOn() {
   WriteCommand(static_cast<uint8_t>(Commands::DisplayOn));
 }
@@ -176,6 +196,20 @@ void St7789::Sleep() {
   NRF_LOG_INFO("[LCD] Sleep");
 }
 
+void St7789::LowPowerOn(uint16_t firstLine, uint16_t lastLine) {
+  PartialAreaSet(firstLine, lastLine);
+  PartialModeOn();
+  IdleModeOn();
+  NRF_LOG_INFO("[LCD] Low power");
+}
+
+void St7789::LowPowerOff() {
+  IdleModeOff();
+  // Also leaves the partial mode
+  NormalModeOn();
+  NRF_LOG_INFO("[LCD] Normal power");
+}
+
 void St7789::Wakeup() {
   nrf_gpio_cfg_output(pinDataCommand);
   SleepOut();
@@ -25,10 +25,15 @@ namespace Pinetime {
       void Sleep();
       void Wakeup();
 
+      /// Low power mode: only the lines [firstLine, lastLine] of the frame memory are displayed, in 8 colours (the most
+      /// significant bit of each component), the other lines are black
+      void LowPowerOn(uint16_t firstLine, uint16_t lastLine);
+      void LowPowerOff();
+
     private:
       Spi& spi;
       uint8_t pinDataCommand;
-      uint8_t verticalScrollingStartAddress = 0;
+      uint16_t verticalScrollingStartAddress = 0;
 
       void HardwareReset();
       void SoftwareReset();
@@ -38,6 +43,10 @@ namespace Pinetime {
       void MemoryDataAccessControl();
       void DisplayInversionOn();
       void NormalModeOn();
+      void PartialAreaSet(uint16_t firstLine, uint16_t lastLine);
+      void PartialModeOn();
+      void IdleModeOn();
+      void IdleModeOff();
       void WriteToRam();
       void DisplayOn();
       void DisplayOff();
@@ -51,6 +60,7 @@ namespace Pinetime {
         SoftwareReset = 0x01,
         SleepIn = 0x10,
         SleepOut = 0x11,
+        PartialModeOn = 0x12,
         NormalModeOn = 0x13,
         DisplayInversionOn = 0x21,
         DisplayOff = 0x28,
@@ -58,9 +68,12 @@ namespace Pinetime {
         ColumnAddressSet = 0x2a,
         RowAddressSet = 0x2b,
         WriteToRam = 0x2c,
+        PartialAreaSet = 0x30,
         MemoryDataAccessControl = 0x36,
         VerticalScrollDefinition = 0x33,
         VerticalScrollStartAddress = 0x37,
+        IdleModeOff = 0x38,
+        IdleModeOn = 0x39,
         ColMod = 0x3a,
         VdvSet = 0xc4,
       };
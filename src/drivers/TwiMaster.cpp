@@ -2,6 +2,7 @@
 #include <cstring>
 #include <hal/nrf_gpio.h>
 #include <nrfx_log.h>
+#include "logging/Trace.h"
 
 using namespace Pinetime::Drivers;
 
@@ -50,10 +51,12 @@ void TwiMaster::Init() {
 
 TwiMaster::ErrorCodes TwiMaster::Read(uint8_t deviceAddress, uint8_t registerAddress, uint8_t* data, size_t size) {
   xSemaphoreTake(mutex, portMAX_DELAY);
+  Logging::Trace::Record(Logging::Trace::Events::TwiTransferStart, deviceAddress);
   Wakeup();
   auto ret = Write(deviceAddress, &registerAddress, 1, false);
   ret = Read(deviceAddress, data, size, true);
   Sleep();
+  Logging::Trace::Record(Logging::Trace::Events::TwiTransferEnd, deviceAddress);
   xSemaphoreGive(mutex);
   return ret;
 }
@@ -61,11 +64,13 @@ TwiMaster::ErrorCodes TwiMaster::Read(uint8_t deviceAddress, uint8_t registerAdd
 TwiMaster::ErrorCodes TwiMaster::Write(uint8_t deviceAddress, uint8_t registerAddress, const uint8_t* data, size_t size) {
   ASSERT(size <= maxDataSize);
   xSemaphoreTake(mutex, portMAX_DELAY);
+  Logging::Trace::Record(Logging::Trace::Events::TwiTransferStart, deviceAddress);
   Wakeup();
   internalBuffer[0] = registerAddress;
   std::memcpy(internalBuffer + 1, data, size);
   auto ret = Write(deviceAddress, internalBuffer, size + 1, true);
   Sleep();
+  Logging::Trace::Record(Logging::Trace::Events::TwiTransferEnd, deviceAddress);
   xSemaphoreGive(mutex);
   return ret;
 }
@@ -65,7 +65,14 @@ void HeartRateTask::Work() {
     }
 
     if (measurementStarted) {
-      ppg.Preprocess(static_cast<float>(heartRateSensor.ReadHrs()));
+      auto hrs = heartRateSensor.ReadHrs();
+      ppg.Preprocess(static_cast<float>(hrs));
+
+      if (controller.IsRawStreamEnabled()) {
+        auto timestamp = static_cast<uint32_t>(static_cast<uint64_t>(xTaskGetTickCount()) * 1000 / configTICK_RATE_HZ);
+        controller.PushRawSample({timestamp, hrs, heartRateSensor.ReadAls(), ppg.AgcPeak()});
+      }
+
       auto bpm = ppg.HeartRate();
 
       if (lastBpm == 0 && bpm == 0)
@@ -70,26 +70,17 @@ typedef int16_t lv_coord_t;
 /* LittelvGL's internal memory manager's settings.
  * The graphical objects and other related data are stored here. */
 
-/* 1: use custom malloc/free, 0: use the built-in `lv_mem_alloc` and `lv_mem_free` */
-#define LV_MEM_CUSTOM      0
-#if LV_MEM_CUSTOM == 0
-/* Size of the memory used by `lv_mem_alloc` in bytes (>= 2kB)*/
+/* Size of the memory used by `lv_mem_alloc` in bytes (>= 2kB): the pools of LvglAllocator with LV_MEM_CUSTOM */
 #define LV_MEM_SIZE    (14U * 1024U)
 
-/* Complier prefix for a big array declaration */
-#define LV_MEM_ATTR
-
-/* Set an address for the memory pool instead of allocating it as an array.
- * Can be in external SRAM too. */
-#define LV_MEM_ADR          0
+/* 1: use custom malloc/free, 0: use the built-in `lv_mem_alloc` and `lv_mem_free` */
+#define LV_MEM_CUSTOM      1
 
-/* Automatically defrag. on free. Defrag. means joining the adjacent free cells. */
-#define LV_MEM_AUTO_DEFRAG  1
-#else       /*LV_MEM_CUSTOM*/
-#define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
-#define LV_MEM_CUSTOM_ALLOC   malloc       /*Wrapper to malloc*/
-#define LV_MEM_CUSTOM_FREE    free         /*Wrapper to free*/
-#endif     /*LV_MEM_CUSTOM*/
+/* Block pools and general pool of LV_MEM_SIZE bytes, see displayapp/LvglAllocator.h. lv_mem_monitor() doesn't see
+ * them: use Pinetime::Components::LittleVgl::GetMemoryStatistics() */
+#define LV_MEM_CUSTOM_INCLUDE "lv_pinetime_mem.h"   /*Header for the dynamic memory function*/
+#define LV_MEM_CUSTOM_ALLOC   lv_pinetime_mem_alloc /*Wrapper to malloc*/
+#define LV_MEM_CUSTOM_FREE    lv_pinetime_mem_free  /*Wrapper to free*/
 
 /* Use the standard memcpy and memset instead of LVGL's own functions.
  * The standard functions might or might not be faster depending on their implementation. */
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Allocation functions of LVGL (LV_MEM_CUSTOM), implemented by Pinetime::Components::LittleVgl
+ * @param size size of the block, with the header added by LVGL
+ * @return pointer to the block, NULL if there is not enough memory
+ */
+void* lv_pinetime_mem_alloc(size_t size);
+void lv_pinetime_mem_free(void* data);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -7,7 +7,7 @@ namespace Pinetime {
     public:
       void Init() override {
       }
-      void Resume() override {
+      void Flush() override {
       }
     };
   }
@@ -5,7 +5,8 @@ namespace Pinetime {
     class Logger {
     public:
       virtual void Init() = 0;
-      virtual void Resume() = 0;
+      /// Outputs the pending logs. Called by the idle task, instead of waking up periodically to flush them.
+      virtual void Flush() = 0;
     };
   }
 }
\ No newline at end of file
@@ -11,24 +11,10 @@ void NrfLogger::Init() {
   APP_ERROR_CHECK(result);
 
   NRF_LOG_DEFAULT_BACKENDS_INIT();
-
-  if (pdPASS != xTaskCreate(NrfLogger::Process, "LOGGER", 200, this, 0, &m_logger_thread)) {
-    APP_ERROR_HANDLER(NRF_ERROR_NO_MEM);
-  }
 }
 
-void NrfLogger::Process(void*) {
-  NRF_LOG_INFO("Logger task started!");
-
-#pragma clang diagnostic push
-#pragma ide diagnostic ignored "EndlessLoop"
-  while (true) {
-    NRF_LOG_FLUSH();
-    vTaskDelay(100); // Not good for power consumption, it will wake up every 100ms...
+void NrfLogger::Flush() {
+  // Processes the deferred logs until the buffer is empty: nothing is done when nothing was logged
+  while (NRF_LOG_PROCESS()) {
   }
-#pragma clang diagnostic pop
-}
-
-void NrfLogger::Resume() {
-  vTaskResume(m_logger_thread);
 }
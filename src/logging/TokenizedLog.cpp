@@ -0,0 +1,124 @@
+#include "logging/TokenizedLog.h"
+#include <array>
+#include <atomic>
+#include <FreeRTOS.h>
+#include <task.h>
+#include <SEGGER_RTT.h>
+
+using namespace Pinetime::Logging;
+
+#ifdef ENABLE_TOKENIZED_LOG
+
+namespace {
+  // Power of 2: the positions wrap around on 32 bits
+  constexpr size_t ringSize = 32;
+  // A task that pushes a record beyond this count flushes the ring itself, instead of waiting for the idle task
+  constexpr size_t watermark = ringSize * 3 / 4;
+  constexpr size_t rttBufferSize = 512;
+
+  // RTT record: token, number of arguments, reserved byte, timestamp (RTC2, 32768Hz, 24 bits), then the arguments.
+  // All little-endian.
+  struct __attribute__((packed)) RecordHeader {
+    uint16_t token;
+    uint8_t nbArguments;
+    uint8_t reserved;
+    uint32_t timestamp;
+  };
+
+  struct Slot {
+    std::atomic<bool> ready {false};
+    uint16_t token;
+    uint8_t nbArguments;
+    uint32_t timestamp;
+    uint32_t arguments[TokenizedLog::MaxArguments];
+  };
+
+  std::array<Slot, ringSize> ring;
+  // Producers reserve a slot by incrementing head, the flush frees it by incrementing tail
+  std::atomic<uint32_t> head {0};
+  std::atomic<uint32_t> tail {0};
+  std::atomic<uint32_t> nbLost {0};
+  std::atomic_flag flushing = ATOMIC_FLAG_INIT;
+
+  uint8_t rttBuffer[rttBufferSize];
+
+  bool InIsr() {
+    return (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) != 0;
+  }
+
+  bool WriteRecord(uint16_t token, uint32_t timestamp, const uint32_t* arguments, uint8_t nbArguments) {
+    uint8_t record[sizeof(RecordHeader) + sizeof(uint32_t) * TokenizedLog::MaxArguments];
+    const RecordHeader header {token, nbArguments, 0, timestamp};
+    std::memcpy(record, &header, sizeof(header));
+    std::memcpy(record + sizeof(header), arguments, sizeof(uint32_t) * nbArguments);
+
+    // In the skip mode, a record is either written entirely or not at all: the stream stays in sync
+    const unsigned size = sizeof(header) + sizeof(uint32_t) * nbArguments;
+    return SEGGER_RTT_Write(TokenizedLog::RttChannel, record, size) == size;
+  }
+}
+
+void TokenizedLog::Init() {
+  SEGGER_RTT_ConfigUpBuffer(RttChannel, "Tokens", rttBuffer, sizeof(rttBuffer), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+}
+
+void TokenizedLog::Push(uint16_t token, const uint32_t* arguments, size_t nbArguments) {
+  uint32_t position = head.load(std::memory_order_relaxed);
+  do {
+    if (position - tail.load(std::memory_order_acquire) >= ringSize) {
+      nbLost.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  } while (!head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed));
+
+  // The slot is reserved: an ISR that preempts this task fills the next one, the flush waits for this one to be ready
+  Slot& slot = ring[position % ringSize];
+  slot.token = token;
+  slot.nbArguments = static_cast<uint8_t>(nbArguments);
+  slot.timestamp = NRF_RTC2->COUNTER;
+  std::memcpy(slot.arguments, arguments, sizeof(uint32_t) * nbArguments);
+  slot.ready.store(true, std::memory_order_release);
+
+  if (position - tail.load(std::memory_order_relaxed) >= watermark && !InIsr() &&
+      xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+    Flush();
+  }
+}
+
+void TokenizedLog::Flush() {
+  // Single consumer: a flush that preempts another one leaves the work to it
+  if (flushing.test_and_set(std::memory_order_acquire)) {
+    return;
+  }
+
+  uint32_t position = tail.load(std::memory_order_relaxed);
+  while (ring[position % ringSize].ready.load(std::memory_order_acquire)) {
+    Slot& slot = ring[position % ringSize];
+    if (!WriteRecord(slot.token, slot.timestamp, slot.arguments, slot.nbArguments)) {
+      nbLost.fetch_add(1, std::memory_order_relaxed);
+    }
+    slot.ready.store(false, std::memory_order_relaxed);
+    position++;
+    tail.store(position, std::memory_order_release);
+  }
+
+  const uint32_t lost = nbLost.exchange(0, std::memory_order_relaxed);
+  if (lost > 0 && !WriteRecord(LostToken, NRF_RTC2->COUNTER, &lost, 1)) {
+    nbLost.fetch_add(lost, std::memory_order_relaxed);
+  }
+
+  flushing.clear(std::memory_order_release);
+}
+
+#else
+
+void TokenizedLog::Init() {
+}
+
+void TokenizedLog::Flush() {
+}
+
+void TokenizedLog::Push(uint16_t /*token*/, const uint32_t* /*arguments*/, size_t /*nbArguments*/) {
+}
+
+#endif
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <libraries/log/nrf_log.h>
+
+namespace Pinetime {
+  namespace Logging {
+    /**
+     * Tokenized logs: the format strings never reach the firmware image, and nothing is formatted on the device.
+     *
+     * The format string of a TLOG_* call is stored in the .log_tokens section, which is not loaded (see gcc_nrf52.ld):
+     * its offset in the section is the token of the log. A call only pushes the token, a timestamp and the raw 32-bit
+     * arguments into a lock-free ring, which can be used from tasks and ISRs. The ring is flushed to the RTT channel
+     * RttChannel from the idle task, or right away by the task that fills it beyond its watermark.
+     *
+     * The arguments must be integers, enums or floats: strings (%s) can't be tokenized. The dictionary of the
+     * tokens is extracted from the ELF file at the end of the build, and the RTT stream is decoded with
+     * tools/logtokens/logtokens.py. See doc/TokenizedLog.md.
+     *
+     * It is only built when ENABLE_TOKENIZED_LOG is defined (cmake -DENABLE_TOKENIZED_LOG=1): otherwise the TLOG_*
+     * macros forward to the NRF_LOG_* ones.
+     */
+    namespace TokenizedLog {
+      static constexpr size_t MaxArguments = 6;
+      static constexpr unsigned RttChannel = 1;
+      // Reserved token of the record that reports the number of lost records
+      static constexpr uint16_t LostToken = 0xffff;
+
+      void Init();
+      /// Writes the pending records to RTT. Only call it from a task.
+      void Flush();
+
+      void Push(uint16_t token, const uint32_t* arguments, size_t nbArguments);
+
+      inline uint32_t ToArgument(float value) {
+        uint32_t argument;
+        std::memcpy(&argument, &value, sizeof(argument));
+        return argument;
+      }
+
+      // The string would have to be copied: use NRF_LOG_* instead
+      uint32_t ToArgument(const char* value) = delete;
+
+      template <typename T>
+      inline uint32_t ToArgument(T value) {
+        static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "Unsupported type of argument");
+        static_assert(sizeof(T) <= sizeof(uint32_t), "Arguments are at most 32 bits");
+        return static_cast<uint32_t>(value);
+      }
+
+      template <typename... Args>
+      inline void Write(const char* format, Args... args) {
+        static_assert(sizeof...(Args) <= MaxArguments, "Too many arguments for a tokenized log");
+        // The additional 0 avoids an empty array
+        const uint32_t arguments[] = {ToArgument(args)..., 0};
+        Push(static_cast<uint16_t>(reinterpret_cast<uintptr_t>(format)), arguments, sizeof...(Args));
+      }
+
+      /// Never called: lets the compiler check the arguments against the format
+      inline void CheckFormat(const char* /*format*/, ...) __attribute__((format(printf, 1, 2)));
+
+      inline void CheckFormat(const char* /*format*/, ...) {
+      }
+    }
+  }
+}
+
+#ifdef ENABLE_TOKENIZED_LOG
+  #define TLOG_STRINGIFY_(x) #x
+  #define TLOG_STRINGIFY(x)  TLOG_STRINGIFY_(x)
+
+  // The token string is "<level>\x1f<file>:<line>\x1f<format>". Only use it in .cpp files: the strings of inline
+  // functions would be duplicated.
+  #define TLOG_WRITE(level, format, ...)                                                                                      \
+    do {                                                                                                                     \
+      __attribute__((section(".log_tokens"), used)) static const char tokenString[] =                                         \
+        level "\x1f" __FILE__ ":" TLOG_STRINGIFY(__LINE__) "\x1f" format;                                                   \
+      if (false) {                                                                                                           \
+        Pinetime::Logging::TokenizedLog::CheckFormat(format, ##__VA_ARGS__);                                                 \
+      }                                                                                                                      \
+      Pinetime::Logging::TokenizedLog::Write(tokenString, ##__VA_ARGS__);                                                    \
+    } while (0)
+
+  #define TLOG_ERROR(format, ...)   TLOG_WRITE("E", format, ##__VA_ARGS__)
+  #define TLOG_WARNING(format, ...) TLOG_WRITE("W", format, ##__VA_ARGS__)
+  #define TLOG_INFO(format, ...)    TLOG_WRITE("I", format, ##__VA_ARGS__)
+  #define TLOG_DEBUG(format, ...)   TLOG_WRITE("D", format, ##__VA_ARGS__)
+#else
+  #define TLOG_ERROR(...)   NRF_LOG_ERROR(__VA_ARGS__)
+  #define TLOG_WARNING(...) NRF_LOG_WARNING(__VA_ARGS__)
+  #define TLOG_INFO(...)    NRF_LOG_INFO(__VA_ARGS__)
+  #define TLOG_DEBUG(...)   NRF_LOG_DEBUG(__VA_ARGS__)
+#endif
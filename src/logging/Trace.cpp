@@ -0,0 +1,149 @@
+#include "logging/Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <FreeRTOS.h>
+#include <task.h>
+#include "components/fs/FS.h"
+
+using namespace Pinetime::Logging;
+
+#ifdef ENABLE_TRACE
+
+static_assert(static_cast<uint8_t>(Trace::Events::TaskSwitchedIn) == portTRACE_EVENT_TASK_SWITCHED_IN, "Event IDs mismatch");
+static_assert(static_cast<uint8_t>(Trace::Events::QueuePosted) == portTRACE_EVENT_QUEUE_POSTED, "Event IDs mismatch");
+static_assert(sizeof(TraceRecord_t) == 8, "Records must be packed in 8 bytes");
+
+namespace {
+  // Dump file: header, table of the tasks, then the records from the oldest to the newest. All little-endian.
+  constexpr uint8_t dumpMagic[4] = {'I', 'T', 'R', 'C'};
+  constexpr uint8_t dumpVersion = 1;
+  constexpr uint32_t timestampFrequency = 32768;
+  constexpr size_t maxTaskCount = 12;
+
+  struct __attribute__((packed)) DumpHeader {
+    uint8_t magic[4];
+    uint8_t version;
+    uint8_t recordSize;
+    uint16_t nbTasks;
+    uint32_t timestampFrequency;
+    uint32_t nbRecords;
+    uint32_t nbLost;
+  };
+
+  struct __attribute__((packed)) DumpTask {
+    uint16_t number;
+    char name[configMAX_TASK_NAME_LEN];
+  };
+
+  std::atomic<Trace::DumpStates> dumpState {Trace::DumpStates::None};
+}
+
+bool Trace::Start() {
+  vPortTraceStart();
+  return true;
+}
+
+void Trace::Stop() {
+  vPortTraceStop();
+}
+
+bool Trace::IsRunning() {
+  return ulPortTraceIsRunning() != 0;
+}
+
+uint32_t Trace::NbRecorded() {
+  uint32_t nbRecorded;
+  pxPortTraceGetBuffer(&nbRecorded);
+  return nbRecorded;
+}
+
+bool Trace::RequestDump() {
+  Stop();
+  dumpState = DumpStates::Pending;
+  return true;
+}
+
+Trace::DumpStates Trace::GetDumpState() {
+  return dumpState;
+}
+
+bool Trace::Dump(Controllers::FS& fs) {
+  Stop();
+
+  uint32_t nbRecorded;
+  const TraceRecord_t* buffer = pxPortTraceGetBuffer(&nbRecorded);
+  const uint32_t nbRecords = (nbRecorded < portTRACE_BUFFER_SIZE) ? nbRecorded : portTRACE_BUFFER_SIZE;
+
+  TaskStatus_t tasksStatus[maxTaskCount];
+  const auto nbTasks = uxTaskGetSystemState(tasksStatus, maxTaskCount, nullptr);
+
+  lfs_file_t file;
+  if (fs.FileOpen(&file, dumpFileName, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) != LFS_ERR_OK) {
+    dumpState = DumpStates::Failed;
+    return false;
+  }
+
+  DumpHeader header {};
+  std::copy(std::begin(dumpMagic), std::end(dumpMagic), header.magic);
+  header.version = dumpVersion;
+  header.recordSize = sizeof(TraceRecord_t);
+  header.nbTasks = nbTasks;
+  header.timestampFrequency = timestampFrequency;
+  header.nbRecords = nbRecords;
+  header.nbLost = nbRecorded - nbRecords;
+  bool success = fs.FileWrite(&file, reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header);
+
+  for (uint32_t i = 0; success && i < nbTasks; i++) {
+    DumpTask task {};
+    task.number = tasksStatus[i].xTaskNumber;
+    std::strncpy(task.name, tasksStatus[i].pcTaskName, configMAX_TASK_NAME_LEN);
+    success = fs.FileWrite(&file, reinterpret_cast<const uint8_t*>(&task), sizeof(task)) == sizeof(task);
+  }
+
+  // Oldest record first: once the ring has wrapped around, it is the one at the head
+  const uint32_t first = nbRecorded - nbRecords;
+  for (uint32_t i = 0; success && i < nbRecords;) {
+    const uint32_t index = (first + i) & (portTRACE_BUFFER_SIZE - 1);
+    const uint32_t count = std::min(nbRecords - i, portTRACE_BUFFER_SIZE - index);
+    const auto size = count * sizeof(TraceRecord_t);
+    success = fs.FileWrite(&file, reinterpret_cast<const uint8_t*>(&buffer[index]), size) == static_cast<int>(size);
+    i += count;
+  }
+
+  fs.FileClose(&file);
+  dumpState = success ? DumpStates::Done : DumpStates::Failed;
+  return success;
+}
+
+#else
+
+bool Trace::Start() {
+  return false;
+}
+
+void Trace::Stop() {
+}
+
+bool Trace::IsRunning() {
+  return false;
+}
+
+uint32_t Trace::NbRecorded() {
+  return 0;
+}
+
+bool Trace::RequestDump() {
+  return false;
+}
+
+Trace::DumpStates Trace::GetDumpState() {
+  return DumpStates::None;
+}
+
+bool Trace::Dump(Controllers::FS& /*fs*/) {
+  return false;
+}
+
+#endif
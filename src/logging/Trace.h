@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#ifdef ENABLE_TRACE
+  #include "FreeRTOS/port_trace.h"
+#endif
+
+namespace Pinetime {
+  namespace Controllers {
+    class FS;
+  }
+  namespace Logging {
+    /**
+     * Binary trace of the system events, to investigate stutters and latencies. It is only built when ENABLE_TRACE
+     * is defined (cmake -DENABLE_TRACE=1): otherwise recording an event compiles to nothing.
+     *
+     * The trace is dumped to a file, which is read with the BLE FS service and converted to the Chrome trace format
+     * with tools/trace/trace2chrome.py. See doc/Trace.md.
+     */
+    namespace Trace {
+      enum class Events : uint8_t {
+        None = 0,
+        TaskSwitchedIn = 1, // argument: task number
+        QueuePosted = 2,    // argument: lower 16 bits of the address of the queue
+        SystemMessagePosted = 3,
+        DisplayMessagePosted = 4,
+        SpiIsrEnter = 5,
+        SpiIsrExit = 6,
+        GpioteIsrEnter = 7, // argument: pin
+        GpioteIsrExit = 8,
+        FlushDisplayStart = 9, // argument: number of lines
+        FlushDisplayEnd = 10,
+        TwiTransferStart = 11, // argument: device address
+        TwiTransferEnd = 12,
+        LoadAppStart = 13, // argument: app
+        LoadAppEnd = 14,   // argument: 1 if the screen was kept by the screen cache
+        LvglAlloc = 15,     // argument: size
+        LvglAllocated = 16, // argument: offset of the block in the LVGL memory, 0xffff if the allocation failed
+        LvglFree = 17,      // argument: offset of the block in the LVGL memory
+      };
+
+      enum class DumpStates : uint8_t { None = 0, Pending = 1, Done = 2, Failed = 3 };
+
+      static constexpr const char* dumpFileName = "/trace.bin";
+
+#ifdef ENABLE_TRACE
+      inline void Record(Events event, uint16_t argument = 0) {
+        vPortTraceRecord(static_cast<uint8_t>(event), argument);
+      }
+#else
+      inline void Record(Events /*event*/, uint16_t /*argument*/ = 0) {
+      }
+#endif
+
+      /// Returns false if the trace is not built in
+      bool Start();
+      void Stop();
+      bool IsRunning();
+      /// Number of events recorded since the trace was started
+      uint32_t NbRecorded();
+      /// Stops the trace and marks its dump as pending, for the system task. Can be called from any task. Returns false if
+      /// the trace is not built in.
+      bool RequestDump();
+      DumpStates GetDumpState();
+      /// Stops the trace and writes it to dumpFileName. Returns false if the trace is not built in or on error.
+      /// It writes to the file system: only call it from the system task.
+      bool Dump(Controllers::FS& fs);
+    }
+  }
+}
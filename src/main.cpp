@@ -48,6 +48,8 @@
 #include "drivers/PinMap.h"
 #include "touchhandler/TouchHandler.h"
 #include "buttonhandler/ButtonHandler.h"
+#include "logging/Trace.h"
+#include "logging/TokenizedLog.h"
 
 #if NRF_LOG_ENABLED
   #include "logging/NrfLogger.h"
@@ -131,7 +133,8 @@ Pinetime::Applications::DisplayApp displayApp(lcd,
                                               timerController,
                                               alarmController,
                                               brightnessController,
-                                              touchHandler);
+                                              touchHandler,
+                                              fs);
 
 Pinetime::System::SystemTask systemTask(spi,
                                         lcd,
@@ -168,8 +171,10 @@ uint32_t NoInit_MagicWord __attribute__((section(".noinit")));
 std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> NoInit_BackUpTime __attribute__((section(".noinit")));
 
 void nrfx_gpiote_evt_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action) {
+  Pinetime::Logging::Trace::Record(Pinetime::Logging::Trace::Events::GpioteIsrEnter, pin);
   if (pin == Pinetime::PinMap::Cst816sIrq) {
     systemTask.OnTouchEvent();
+    Pinetime::Logging::Trace::Record(Pinetime::Logging::Trace::Events::GpioteIsrExit, pin);
     return;
   }
 
@@ -182,6 +187,7 @@ void nrfx_gpiote_evt_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action
     xTimerStartFromISR(debounceTimer, &xHigherPriorityTaskWoken);
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
   }
+  Pinetime::Logging::Trace::Record(Pinetime::Logging::Trace::Events::GpioteIsrExit, pin);
 }
 
 void DebounceTimerChargeCallback(TimerHandle_t xTimer) {
@@ -194,6 +200,7 @@ void DebounceTimerCallback(TimerHandle_t /*unused*/) {
 }
 
 void SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQHandler(void) {
+  Pinetime::Logging::Trace::Record(Pinetime::Logging::Trace::Events::SpiIsrEnter);
   if (((NRF_SPIM0->INTENSET & (1 << 6)) != 0) && NRF_SPIM0->EVENTS_END == 1) {
     NRF_SPIM0->EVENTS_END = 0;
     spi.OnEndEvent();
@@ -207,6 +214,7 @@ void SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQHandler(void) {
   if (((NRF_SPIM0->INTENSET & (1 << 1)) != 0) && NRF_SPIM0->EVENTS_STOPPED == 1) {
     NRF_SPIM0->EVENTS_STOPPED = 0;
   }
+  Pinetime::Logging::Trace::Record(Pinetime::Logging::Trace::Events::SpiIsrExit);
 }
 
 static void (*radio_isr_addr)(void);
@@ -231,6 +239,12 @@ void WDT_IRQHandler(void) {
   nrf_wdt_event_clear(NRF_WDT_EVENT_TIMEOUT);
 }
 
+void vApplicationIdleHook(void) {
+  // The logs are output when the CPU has nothing else to do, right before it goes to sleep
+  logger.Flush();
+  Pinetime::Logging::TokenizedLog::Flush();
+}
+
 void npl_freertos_hw_set_isr(int irqn, void (*addr)(void)) {
   switch (irqn) {
     case RADIO_IRQn:
@@ -308,6 +322,7 @@ void calibrate_lf_clock_rc(nrf_drv_clock_evt_type_t event) {
 
 int main(void) {
   logger.Init();
+  Pinetime::Logging::TokenizedLog::Init();
 
   nrf_drv_clock_init();
   nrf_drv_clock_lfclk_request(NULL);
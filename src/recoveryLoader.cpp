@@ -57,6 +57,7 @@ void DisplayLogo();
 
 extern "C" {
 void vApplicationIdleHook(void) {
+  logger.Flush();
 }
 
 void SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQHandler(void) {
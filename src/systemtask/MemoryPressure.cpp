@@ -0,0 +1,48 @@
+#include "systemtask/MemoryPressure.h"
+#include <algorithm>
+
+using namespace Pinetime::System;
+
+namespace {
+  constexpr const char* poolNames[MemoryPressure::NbPools] = {"Heap", "FreeRTOS", "LVGL", "BLE"};
+}
+
+bool MemoryPressure::Update(Pools pool, uint32_t free, uint32_t total) {
+  Pool& p = pools[static_cast<size_t>(pool)];
+  p.total = total;
+  p.free = free;
+  p.lowWatermark = std::min(p.lowWatermark, free);
+
+  const Levels level = ComputeLevel(p.level, free, total);
+  if (level == p.level) {
+    return false;
+  }
+  p.level = level;
+  return true;
+}
+
+MemoryPressure::Levels MemoryPressure::GetLevel() const {
+  Levels level = Levels::Normal;
+  for (const Pool& pool : pools) {
+    level = std::max(level, pool.level);
+  }
+  return level;
+}
+
+const char* MemoryPressure::PoolName(Pools pool) {
+  return poolNames[static_cast<size_t>(pool)];
+}
+
+MemoryPressure::Levels MemoryPressure::ComputeLevel(Levels current, uint32_t free, uint32_t total) {
+  if (total == 0) {
+    return Levels::Normal;
+  }
+  const uint32_t percent = static_cast<uint32_t>(static_cast<uint64_t>(free) * 100 / total);
+  if (percent < CriticalPercent || (current == Levels::Critical && percent < CriticalPercent + HysteresisPercent)) {
+    return Levels::Critical;
+  }
+  if (percent < LowPercent || (current != Levels::Normal && percent < LowPercent + HysteresisPercent)) {
+    return Levels::Low;
+  }
+  return Levels::Normal;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace System {
+    /**
+     * Tracks the free memory of the pools the RAM is statically split into, and the pressure on them.
+     *
+     * Each pool is updated by the task that owns it (the LVGL memory by the display task, the others by the system
+     * task) with its free and total sizes. The level of a pool is Low or Critical when its free memory is under a
+     * percentage of its size, and goes back up with a margin so that it doesn't toggle around a threshold. The level of
+     * the system is the highest one of the pools. It doesn't depend on the OS.
+     */
+    class MemoryPressure {
+    public:
+      enum class Pools : uint8_t {
+        // malloc() and new, in the heap of the linker script
+        Heap,
+        // pvPortMalloc(): tasks, queues, timers (configTOTAL_HEAP_SIZE)
+        FreeRtosHeap,
+        // Biggest free block of the general pool of the memory of LVGL (LV_MEM_SIZE)
+        Lvgl,
+        // Blocks of the NimBLE MSYS pool
+        BleBuffers
+      };
+      static constexpr size_t NbPools = 4;
+
+      enum class Levels : uint8_t { Normal, Low, Critical };
+
+      struct Pool {
+        uint32_t total = 0;
+        uint32_t free = 0;
+        // Lowest free memory since boot
+        uint32_t lowWatermark = UINT32_MAX;
+        Levels level = Levels::Normal;
+      };
+
+      /// Records the free memory of a pool, returns true if the level of the pool changed
+      bool Update(Pools pool, uint32_t free, uint32_t total);
+
+      Levels GetLevel() const;
+      const Pool& GetPool(Pools pool) const {
+        return pools[static_cast<size_t>(pool)];
+      }
+      static const char* PoolName(Pools pool);
+
+    private:
+      // Free memory, in percent of the pool, under which its level is Low and Critical
+      static constexpr uint32_t LowPercent = 25;
+      static constexpr uint32_t CriticalPercent = 10;
+      // Free memory above a threshold needed to leave the level under it
+      static constexpr uint32_t HysteresisPercent = 5;
+
+      static Levels ComputeLevel(Levels current, uint32_t free, uint32_t total);
+
+      std::array<Pool, NbPools> pools;
+    };
+  }
+}
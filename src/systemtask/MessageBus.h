@@ -0,0 +1,206 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <FreeRTOS.h>
+#include <nrf.h>
+#include <semphr.h>
+#include <task.h>
+
+namespace Pinetime {
+  namespace System {
+    /**
+     * Message queue between tasks that never blocks the sender, and can be used from tasks and ISRs.
+     *
+     * Idempotent messages (a touch event, a new time...) are coalesced: they are stored as a bit in a mask of pending
+     * messages, and posting one that is already pending doesn't take any room. The other messages change a state and must
+     * be handled in order: they are stored in a ring, and dropped (and counted) if the ring is full.
+     *
+     * All the messages are received in the order they were posted: a coalesced message takes its place in this order
+     * when it becomes pending, and keeps it until it is received.
+     */
+    template <typename Message, size_t RingSize>
+    class MessageBus {
+    public:
+      struct Statistics {
+        uint32_t dropped = 0;
+        uint32_t coalesced = 0;
+        // Maximum time between the post and the reception of a message
+        TickType_t maxLatency = 0;
+      };
+
+      /// Mask of the messages to coalesce, for the constructor. Only messages with a value lower than 32 can be coalesced.
+      static constexpr uint32_t MaskOf(std::initializer_list<Message> messages) {
+        uint32_t mask = 0;
+        for (Message message : messages) {
+          mask |= 1u << static_cast<uint32_t>(message);
+        }
+        return mask;
+      }
+
+      explicit MessageBus(uint32_t coalescedMask) : coalescedMask {coalescedMask} {
+      }
+
+      MessageBus(const MessageBus&) = delete;
+      MessageBus& operator=(const MessageBus&) = delete;
+
+      void Init() {
+        doorbell = xSemaphoreCreateBinary();
+      }
+
+      /// Returns false if the message was dropped because the ring is full
+      bool Post(Message message) {
+        const bool isr = InIsr();
+        const TickType_t now = isr ? xTaskGetTickCountFromISR() : xTaskGetTickCount();
+        const uint32_t value = static_cast<uint32_t>(message);
+        bool posted = true;
+
+        UBaseType_t savedInterruptStatus = Lock(isr);
+        if (value < 32 && (coalescedMask & (1u << value)) != 0) {
+          if ((pending & (1u << value)) != 0) {
+            statistics.coalesced++;
+          } else {
+            pending |= (1u << value);
+            pendingMessages[value] = {now, sequence++};
+          }
+        } else if (count == RingSize) {
+          statistics.dropped++;
+          posted = false;
+        } else {
+          ring[(head + count) % RingSize] = {message, now, sequence++};
+          count++;
+        }
+        Unlock(isr, savedInterruptStatus);
+
+        if (posted) {
+          Notify(isr);
+        }
+        return posted;
+      }
+
+      /// Waits at most timeout ticks for a message, returns false if none was received. Only call it from a task.
+      bool Receive(Message& message, TickType_t timeout) {
+        const TickType_t start = xTaskGetTickCount();
+        while (!TryReceive(message)) {
+          TickType_t remaining = timeout;
+          if (timeout != portMAX_DELAY) {
+            const TickType_t elapsed = xTaskGetTickCount() - start;
+            if (elapsed >= timeout) {
+              return false;
+            }
+            remaining = timeout - elapsed;
+          }
+          // The doorbell may be given for a message that was already received: check again once woken up
+          if (xSemaphoreTake(doorbell, remaining) == pdFALSE) {
+            return false;
+          }
+        }
+        return true;
+      }
+
+      Statistics GetStatistics() const {
+        taskENTER_CRITICAL();
+        Statistics result = statistics;
+        taskEXIT_CRITICAL();
+        return result;
+      }
+
+    private:
+      struct Entry {
+        Message message;
+        TickType_t postedAt;
+        uint16_t sequence;
+      };
+
+      // A coalesced message keeps the time and the place in the order of its first post
+      struct PendingMessage {
+        TickType_t postedAt;
+        uint16_t sequence;
+      };
+
+      // Sequence numbers wrap around, but there are never more than RingSize + 32 messages waiting
+      static bool IsOlder(uint16_t sequence, uint16_t other) {
+        return static_cast<int16_t>(sequence - other) < 0;
+      }
+
+      static bool InIsr() {
+        return (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) != 0;
+      }
+
+      static UBaseType_t Lock(bool isr) {
+        if (isr) {
+          return taskENTER_CRITICAL_FROM_ISR();
+        }
+        taskENTER_CRITICAL();
+        return 0;
+      }
+
+      static void Unlock(bool isr, UBaseType_t savedInterruptStatus) {
+        if (isr) {
+          taskEXIT_CRITICAL_FROM_ISR(savedInterruptStatus);
+        } else {
+          taskEXIT_CRITICAL();
+        }
+      }
+
+      void Notify(bool isr) {
+        if (isr) {
+          BaseType_t higherPriorityTaskWoken = pdFALSE;
+          xSemaphoreGiveFromISR(doorbell, &higherPriorityTaskWoken);
+          portYIELD_FROM_ISR(higherPriorityTaskWoken);
+        } else {
+          xSemaphoreGive(doorbell);
+        }
+      }
+
+      bool TryReceive(Message& message) {
+        const TickType_t now = xTaskGetTickCount();
+        TickType_t postedAt;
+
+        taskENTER_CRITICAL();
+        // The oldest pending coalesced message, 32 if there is none
+        uint32_t oldestPending = 32;
+        for (uint32_t bits = pending; bits != 0; bits &= bits - 1) {
+          const uint32_t value = __builtin_ctz(bits);
+          if (oldestPending == 32 || IsOlder(pendingMessages[value].sequence, pendingMessages[oldestPending].sequence)) {
+            oldestPending = value;
+          }
+        }
+
+        if (count > 0 && (oldestPending == 32 || IsOlder(ring[head].sequence, pendingMessages[oldestPending].sequence))) {
+          message = ring[head].message;
+          postedAt = ring[head].postedAt;
+          head = (head + 1) % RingSize;
+          count--;
+        } else if (oldestPending < 32) {
+          pending &= ~(1u << oldestPending);
+          message = static_cast<Message>(oldestPending);
+          postedAt = pendingMessages[oldestPending].postedAt;
+        } else {
+          taskEXIT_CRITICAL();
+          return false;
+        }
+        if (now - postedAt > statistics.maxLatency) {
+          statistics.maxLatency = now - postedAt;
+        }
+        taskEXIT_CRITICAL();
+        return true;
+      }
+
+      const uint32_t coalescedMask;
+      SemaphoreHandle_t doorbell = nullptr;
+
+      uint32_t pending = 0;
+      // Posting order of the messages
+      uint16_t sequence = 0;
+      std::array<PendingMessage, 32> pendingMessages;
+      std::array<Entry, RingSize> ring;
+      size_t head = 0;
+      size_t count = 0;
+
+      Statistics statistics;
+    };
+  }
+}
@@ -31,7 +31,11 @@ namespace Pinetime {
       BatteryPercentageUpdated,
       StartFileTransfer,
       StopFileTransfer,
-      BleRadioEnableToggle
+      BleRadioEnableToggle,
+      UpdateAlwaysOnDisplay,
+      OnAlwaysOnDisplayUpdated,
+      BleDiscoveryTimerExpired,
+      DumpTrace
     };
   }
 }
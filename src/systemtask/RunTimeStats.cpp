@@ -0,0 +1,95 @@
+#include "systemtask/RunTimeStats.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace Pinetime::System;
+
+RunTimeStats::RunTimeStats(uint32_t counterFrequency) : counterFrequency {counterFrequency} {
+}
+
+bool RunTimeStats::Update(const Snapshot& snapshot, Statistics& statistics) {
+  if (!hasPrevious) {
+    previous = snapshot;
+    hasPrevious = true;
+    return false;
+  }
+
+  const uint32_t period = snapshot.time - previous.time;
+  if (period == 0) {
+    return false;
+  }
+
+  statistics.periodMs = static_cast<uint32_t>(static_cast<uint64_t>(period) * 1000 / counterFrequency);
+
+  uint32_t idleTime = 0;
+  statistics.nbTasks = 0;
+  for (size_t i = 0; i < snapshot.nbTasks && i < MaxTasks; i++) {
+    const TaskCounters& task = snapshot.tasks[i];
+    // A task created during the period has run since its creation only
+    const uint32_t runTime = task.runTime - PreviousRunTime(task);
+    if (task.isIdle) {
+      idleTime = runTime;
+    }
+
+    TaskLoad& load = statistics.tasks[statistics.nbTasks++];
+    std::memcpy(load.name, task.name, TaskNameSize);
+    load.loadPermille = Permille(runTime, period);
+    load.stackHighWaterMark = task.stackHighWaterMark;
+  }
+  std::sort(statistics.tasks.begin(), statistics.tasks.begin() + statistics.nbTasks, [](const TaskLoad& lhs, const TaskLoad& rhs) {
+    return lhs.loadPermille > rhs.loadPermille;
+  });
+
+  // The idle task puts the CPU to sleep: the sleep time is part of its run time
+  statistics.idlePermille = Permille(idleTime, period);
+  statistics.cpuLoadPermille = 1000 - statistics.idlePermille;
+  statistics.sleepPermille = Permille(snapshot.sleepTime - previous.sleepTime, period);
+
+  const uint64_t wakeups = snapshot.wakeups - previous.wakeups;
+  statistics.wakeupsPerSecond = static_cast<uint16_t>(std::min<uint64_t>(wakeups * counterFrequency / period, UINT16_MAX));
+  ComputeTopWakeupSources(snapshot, statistics);
+
+  previous = snapshot;
+  return true;
+}
+
+uint16_t RunTimeStats::Permille(uint32_t part, uint32_t total) const {
+  if (part >= total) {
+    return 1000;
+  }
+  return static_cast<uint16_t>(static_cast<uint64_t>(part) * 1000 / total);
+}
+
+uint32_t RunTimeStats::PreviousRunTime(const TaskCounters& task) const {
+  for (size_t i = 0; i < previous.nbTasks && i < MaxTasks; i++) {
+    if (previous.tasks[i].taskNumber == task.taskNumber) {
+      return previous.tasks[i].runTime;
+    }
+  }
+  return 0;
+}
+
+void RunTimeStats::ComputeTopWakeupSources(const Snapshot& snapshot, Statistics& statistics) const {
+  // Insertion into the short sorted list of the top sources
+  statistics.nbTopWakeupSources = 0;
+  for (size_t source = 0; source < NbWakeupSources; source++) {
+    const uint16_t count = snapshot.wakeupsBySource[source] - previous.wakeupsBySource[source];
+    if (count == 0) {
+      continue;
+    }
+
+    size_t position = statistics.nbTopWakeupSources;
+    while (position > 0 && statistics.topWakeupSources[position - 1].count < count) {
+      if (position < NbTopWakeupSources) {
+        statistics.topWakeupSources[position] = statistics.topWakeupSources[position - 1];
+      }
+      position--;
+    }
+    if (position < NbTopWakeupSources) {
+      statistics.topWakeupSources[position] = {static_cast<uint8_t>(source), count};
+      if (statistics.nbTopWakeupSources < NbTopWakeupSources) {
+        statistics.nbTopWakeupSources++;
+      }
+    }
+  }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace System {
+    /**
+     * Computes the CPU load statistics of a period from two snapshots of the cumulated counters of the system: run time
+     * of each task, time spent sleeping and number of wake-ups by interrupt source.
+     *
+     * The counters wrap around, only their differences are used: a period must be shorter than the wrap-around period
+     * of the run-time counter. It doesn't depend on the OS.
+     */
+    class RunTimeStats {
+    public:
+      static constexpr size_t MaxTasks = 10;
+      static constexpr size_t TaskNameSize = 4;
+      // Interrupts of the nRF52832
+      static constexpr size_t NbWakeupSources = 39;
+      static constexpr size_t NbTopWakeupSources = 3;
+
+      struct TaskCounters {
+        uint32_t taskNumber;
+        char name[TaskNameSize];
+        uint32_t runTime;
+        uint16_t stackHighWaterMark;
+        bool isIdle;
+      };
+
+      struct Snapshot {
+        // Run-time counter when the snapshot was taken
+        uint32_t time;
+        uint32_t sleepTime;
+        uint32_t wakeups;
+        std::array<uint16_t, NbWakeupSources> wakeupsBySource;
+        std::array<TaskCounters, MaxTasks> tasks;
+        size_t nbTasks;
+      };
+
+      struct TaskLoad {
+        char name[TaskNameSize];
+        uint16_t loadPermille;
+        uint16_t stackHighWaterMark;
+      };
+
+      struct WakeupSource {
+        uint8_t source;
+        uint16_t count;
+      };
+
+      struct Statistics {
+        // 0 until the first period is complete
+        uint32_t periodMs = 0;
+        uint16_t cpuLoadPermille = 0;
+        uint16_t idlePermille = 0;
+        uint16_t sleepPermille = 0;
+        uint16_t wakeupsPerSecond = 0;
+        std::array<WakeupSource, NbTopWakeupSources> topWakeupSources {};
+        uint8_t nbTopWakeupSources = 0;
+        // Sorted by decreasing load
+        std::array<TaskLoad, MaxTasks> tasks {};
+        uint8_t nbTasks = 0;
+      };
+
+      explicit RunTimeStats(uint32_t counterFrequency);
+
+      /// Computes the statistics of the period since the previous snapshot, returns false on the first snapshot
+      bool Update(const Snapshot& snapshot, Statistics& statistics);
+
+    private:
+      uint16_t Permille(uint32_t part, uint32_t total) const;
+      uint32_t PreviousRunTime(const TaskCounters& task) const;
+      void ComputeTopWakeupSources(const Snapshot& snapshot, Statistics& statistics) const;
+
+      const uint32_t counterFrequency;
+      Snapshot previous {};
+      bool hasPrevious = false;
+    };
+  }
+}
@@ -1,27 +1,100 @@
 #include "systemtask/SystemTask.h"
-#if configUSE_TRACE_FACILITY == 1
+#include <algorithm>
+#include <cstring>
+
+namespace {
+  // Peripherals of the interrupts of the nRF52832
+  constexpr const char* wakeupSourceNames[Pinetime::System::RunTimeStats::NbWakeupSources] = {
+    "CLOCK", "RADIO", "UART", "SPI0", "TWI1", "NFCT", "GPIOTE", "SAADC", "TIMER0", "TIMER1",
+    "TIMER2", "RTC0", "TEMP", "RNG", "ECB", "CCM", "WDT", "RTC1", "QDEC", "COMP",
+    "SWI0", "SWI1", "SWI2", "SWI3", "SWI4", "SWI5", "TIMER3", "TIMER4", "PWM0", "PDM",
+    "?", "?", "MWU", "PWM1", "PWM2", "SPI2", "RTC2", "I2S", "FPU"};
+}
+
+const char* Pinetime::System::SystemMonitor::WakeupSourceName(uint8_t source) {
+  if (source >= RunTimeStats::NbWakeupSources) {
+    return "?";
+  }
+  return wakeupSourceNames[source];
+}
+
+#if configUSE_TRACE_FACILITY == 1 && configGENERATE_RUN_TIME_STATS == 1
   // FreeRtosMonitor
   #include <FreeRTOS.h>
   #include <task.h>
   #include <nrf_log.h>
 
+static_assert(Pinetime::System::RunTimeStats::TaskNameSize == configMAX_TASK_NAME_LEN, "Task names don't fit in the statistics");
+static_assert(Pinetime::System::RunTimeStats::NbWakeupSources == portNB_WAKEUP_SOURCES, "Wake-up sources don't fit in the statistics");
+
 void Pinetime::System::SystemMonitor::Process() {
-  if (xTaskGetTickCount() - lastTick > 10000) {
-    NRF_LOG_INFO("---------------------------------------\nFree heap : %d", xPortGetFreeHeapSize());
-    TaskStatus_t tasksStatus[10];
-    auto nb = uxTaskGetSystemState(tasksStatus, 10, nullptr);
-    for (uint32_t i = 0; i < nb; i++) {
-      NRF_LOG_INFO("Task [%s] - %d", tasksStatus[i].pcTaskName, tasksStatus[i].usStackHighWaterMark);
-      if (tasksStatus[i].usStackHighWaterMark < 20)
-        NRF_LOG_INFO("WARNING!!! Task %s task is nearly full, only %dB available",
-                     tasksStatus[i].pcTaskName,
-                     tasksStatus[i].usStackHighWaterMark * 4);
+  if (xTaskGetTickCount() - lastTick > statisticsPeriod) {
+    TakeSnapshot();
+    RunTimeStats::Statistics newStatistics;
+    if (runTimeStats.Update(snapshot, newStatistics)) {
+      taskENTER_CRITICAL();
+      statistics = newStatistics;
+      taskEXIT_CRITICAL();
+      LogStatistics();
     }
     lastTick = xTaskGetTickCount();
   }
 }
+
+Pinetime::System::RunTimeStats::Statistics Pinetime::System::SystemMonitor::GetStatistics() const {
+  taskENTER_CRITICAL();
+  RunTimeStats::Statistics result = statistics;
+  taskEXIT_CRITICAL();
+  return result;
+}
+
+void Pinetime::System::SystemMonitor::TakeSnapshot() {
+  TaskStatus_t tasksStatus[RunTimeStats::MaxTasks];
+  uint32_t totalRunTime;
+  // The run time of the tasks and the sleep time are read as close as possible to the run-time counter value
+  auto nb = uxTaskGetSystemState(tasksStatus, RunTimeStats::MaxTasks, &totalRunTime);
+  snapshot.time = portGET_RUN_TIME_COUNTER_VALUE();
+  vPortGetSleepStats(&snapshot.sleepTime, &snapshot.wakeups, snapshot.wakeupsBySource.data());
+
+  const TaskHandle_t idleTask = xTaskGetIdleTaskHandle();
+  snapshot.nbTasks = nb;
+  for (uint32_t i = 0; i < nb; i++) {
+    RunTimeStats::TaskCounters& task = snapshot.tasks[i];
+    task.taskNumber = tasksStatus[i].xTaskNumber;
+    std::strncpy(task.name, tasksStatus[i].pcTaskName, RunTimeStats::TaskNameSize - 1);
+    task.name[RunTimeStats::TaskNameSize - 1] = '\0';
+    task.runTime = tasksStatus[i].ulRunTimeCounter;
+    task.stackHighWaterMark = tasksStatus[i].usStackHighWaterMark;
+    task.isIdle = (tasksStatus[i].xHandle == idleTask);
+  }
+}
+
+void Pinetime::System::SystemMonitor::LogStatistics() const {
+  NRF_LOG_INFO("---------------------------------------\nFree heap : %d", xPortGetFreeHeapSize());
+  NRF_LOG_INFO("CPU %d.%d%% - sleep %d.%d%% - %d wake-ups/s",
+               statistics.cpuLoadPermille / 10,
+               statistics.cpuLoadPermille % 10,
+               statistics.sleepPermille / 10,
+               statistics.sleepPermille % 10,
+               statistics.wakeupsPerSecond);
+  for (uint8_t i = 0; i < statistics.nbTopWakeupSources; i++) {
+    NRF_LOG_INFO("Wake-up source [%s] - %d",
+                 WakeupSourceName(statistics.topWakeupSources[i].source),
+                 statistics.topWakeupSources[i].count);
+  }
+  for (uint8_t i = 0; i < statistics.nbTasks; i++) {
+    const RunTimeStats::TaskLoad& task = statistics.tasks[i];
+    NRF_LOG_INFO("Task [%s] - %d - %d.%d%%", task.name, task.stackHighWaterMark, task.loadPermille / 10, task.loadPermille % 10);
+    if (task.stackHighWaterMark < 20)
+      NRF_LOG_INFO("WARNING!!! Task %s task is nearly full, only %dB available", task.name, task.stackHighWaterMark * 4);
+  }
+}
 #else
 // DummyMonitor
 void Pinetime::System::SystemMonitor::Process() {
 }
+
+Pinetime::System::RunTimeStats::Statistics Pinetime::System::SystemMonitor::GetStatistics() const {
+  return {};
+}
 #endif
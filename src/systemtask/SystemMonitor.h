@@ -1,15 +1,30 @@
 #pragma once
 #include <FreeRTOS.h> // declares configUSE_TRACE_FACILITY
 #include <task.h>
+#include "systemtask/RunTimeStats.h"
 
 namespace Pinetime {
   namespace System {
     class SystemMonitor {
     public:
       void Process();
-#if configUSE_TRACE_FACILITY == 1
+
+      /// CPU load, sleep ratio, wake-ups and load of each task during the last statistics period
+      RunTimeStats::Statistics GetStatistics() const;
+      /// Short name of the peripheral of a wake-up source (interrupt number)
+      static const char* WakeupSourceName(uint8_t source);
+
+#if configUSE_TRACE_FACILITY == 1 && configGENERATE_RUN_TIME_STATS == 1
     private:
-      mutable TickType_t lastTick = 0;
+      static constexpr TickType_t statisticsPeriod = pdMS_TO_TICKS(10000);
+
+      void TakeSnapshot();
+      void LogStatistics() const;
+
+      TickType_t lastTick = 0;
+      RunTimeStats runTimeStats {portRUN_TIME_COUNTER_FREQUENCY};
+      RunTimeStats::Snapshot snapshot;
+      RunTimeStats::Statistics statistics;
 #endif
     };
   }
@@ -16,27 +16,30 @@
 #include "drivers/PinMap.h"
 #include "main.h"
 #include "BootErrors.h"
+#include "logging/Trace.h"
+#include "logging/TokenizedLog.h"
 
+#include <malloc.h>
 #include <memory>
 
 using namespace Pinetime::System;
 
-namespace {
-  static inline bool in_isr(void) {
-    return (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) != 0;
-  }
+extern "C" {
+// Bounds of the heap of malloc(), defined by the linker script
+extern uint8_t __HeapBase[];
+extern uint8_t __HeapLimit[];
 }
 
 void DimTimerCallback(TimerHandle_t xTimer) {
 
-  NRF_LOG_INFO("DimTimerCallback");
+  TLOG_INFO("DimTimerCallback");
   auto sysTask = static_cast<SystemTask*>(pvTimerGetTimerID(xTimer));
   sysTask->OnDim();
 }
 
 void IdleTimerCallback(TimerHandle_t xTimer) {
 
-  NRF_LOG_INFO("IdleTimerCallback");
+  TLOG_INFO("IdleTimerCallback");
   auto sysTask = static_cast<SystemTask*>(pvTimerGetTimerID(xTimer));
   sysTask->OnIdle();
 }
@@ -46,6 +49,16 @@ void MeasureBatteryTimerCallback(TimerHandle_t xTimer) {
   sysTask->PushMessage(Pinetime::System::Messages::MeasureBatteryTimerExpired);
 }
 
+void AlwaysOnDisplayTimerCallback(TimerHandle_t xTimer) {
+  auto* sysTask = static_cast<SystemTask*>(pvTimerGetTimerID(xTimer));
+  sysTask->PushMessage(Pinetime::System::Messages::UpdateAlwaysOnDisplay);
+}
+
+void BleDiscoveryTimerCallback(TimerHandle_t xTimer) {
+  auto* sysTask = static_cast<SystemTask*>(pvTimerGetTimerID(xTimer));
+  sysTask->PushMessage(Pinetime::System::Messages::BleDiscoveryTimerExpired);
+}
+
 SystemTask::SystemTask(Drivers::SpiMaster& spi,
                        Drivers::St7789& lcd,
                        Pinetime::Drivers::SpiNorFlash& spiNorFlash,
@@ -106,7 +119,7 @@ SystemTask::SystemTask(Drivers::SpiMaster& spi,
 }
 
 void SystemTask::Start() {
-  systemTasksMsgQueue = xQueueCreate(10, 1);
+  messageBus.Init();
   if (pdPASS != xTaskCreate(SystemTask::Process, "MAIN", 350, this, 1, &taskHandle)) {
     APP_ERROR_HANDLER(NRF_ERROR_NO_MEM);
   }
@@ -114,7 +127,7 @@ void SystemTask::Start() {
 
 void SystemTask::Process(void* instance) {
   auto* app = static_cast<SystemTask*>(instance);
-  NRF_LOG_INFO("systemtask task started!");
+  TLOG_INFO("systemtask task started!");
   app->Work();
 }
 
@@ -200,6 +213,8 @@ void SystemTask::Work() {
   idleTimer = xTimerCreate("idleTimer", pdMS_TO_TICKS(2000), pdFALSE, this, IdleTimerCallback);
   dimTimer = xTimerCreate("dimTimer", pdMS_TO_TICKS(settingsController.GetScreenTimeOut() - 2000), pdFALSE, this, DimTimerCallback);
   measureBatteryTimer = xTimerCreate("measureBattery", batteryMeasurementPeriod, pdTRUE, this, MeasureBatteryTimerCallback);
+  alwaysOnDisplayTimer = xTimerCreate("alwaysOnDisplay", pdMS_TO_TICKS(60 * 1000), pdFALSE, this, AlwaysOnDisplayTimerCallback);
+  bleDiscoveryTimer = xTimerCreate("bleDiscovery", bleDiscoveryDelay, pdFALSE, this, BleDiscoveryTimerCallback);
   xTimerStart(dimTimer, 0);
   xTimerStart(measureBatteryTimer, portMAX_DELAY);
 
@@ -208,9 +223,8 @@ void SystemTask::Work() {
   while (true) {
     UpdateMotion();
 
-    uint8_t msg;
-    if (xQueueReceive(systemTasksMsgQueue, &msg, 100)) {
-      Messages message = static_cast<Messages>(msg);
+    Messages message;
+    if (messageBus.Receive(message, 100)) {
       switch (message) {
         case Messages::EnableSleeping:
           // Make sure that exiting an app doesn't enable sleeping,
@@ -227,7 +241,10 @@ void SystemTask::Work() {
           xTimerChangePeriod(dimTimer, pdMS_TO_TICKS(settingsController.GetScreenTimeOut() - 2000), 0);
           break;
         case Messages::GoToRunning:
-          spi.Wakeup();
+          xTimerStop(alwaysOnDisplayTimer, 0);
+          if (!isUpdatingAlwaysOnDisplay) {
+            spi.Wakeup();
+          }
 
           // Double Tap needs the touch screen to be in normal mode
           if (!settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::DoubleTap)) {
@@ -266,7 +283,7 @@ void SystemTask::Work() {
             break;
           }
           state = SystemTaskState::GoingToSleep; // Already set in PushMessage()
-          NRF_LOG_INFO("[systemtask] Going to sleep");
+          TLOG_INFO("[systemtask] Going to sleep");
           xTimerStop(idleTimer, 0);
           xTimerStop(dimTimer, 0);
           displayApp.PushMessage(Pinetime::Applications::Display::Messages::GoToSleep);
@@ -308,8 +325,17 @@ void SystemTask::Work() {
           break;
         case Messages::BleConnected:
           ReloadIdleTimer();
-          isBleDiscoveryTimerRunning = true;
-          bleDiscoveryTimer = 5;
+          // Services discovery is deferred to avoid the conflicts between the host communicating with the target and
+          // vice-versa. A new connection restarts the delay.
+          xTimerReset(bleDiscoveryTimer, 0);
+          break;
+        case Messages::BleDiscoveryTimerExpired:
+          if (bleController.IsConnected()) {
+            nimbleController.StartDiscovery();
+          }
+          break;
+        case Messages::DumpTrace:
+          Logging::Trace::Dump(fs);
           break;
         case Messages::BleFirmwareUpdateStarted:
           doNotGoToSleep = true;
@@ -326,7 +352,7 @@ void SystemTask::Work() {
           xTimerStart(dimTimer, 0);
           break;
         case Messages::StartFileTransfer:
-          NRF_LOG_INFO("[systemtask] FS Started");
+          TLOG_INFO("[systemtask] FS Started");
           doNotGoToSleep = true;
           if (state == SystemTaskState::Sleeping) {
             GoToRunning();
@@ -334,7 +360,7 @@ void SystemTask::Work() {
           // TODO add intent of fs access icon or something
           break;
         case Messages::StopFileTransfer:
-          NRF_LOG_INFO("[systemtask] FS Stopped");
+          TLOG_INFO("[systemtask] FS Stopped");
           doNotGoToSleep = false;
           xTimerStart(dimTimer, 0);
           // TODO add intent of fs access icon or something
@@ -371,7 +397,12 @@ void SystemTask::Work() {
             // if it's in sleep mode. Avoid bricked device by disabling sleep mode on these versions.
             spiNorFlash.Sleep();
           }
-          lcd.Sleep();
+          if (settingsController.GetAlwaysOnDisplay()) {
+            // The display task left the display in its low power mode
+            StartAlwaysOnDisplayTimer();
+          } else {
+            lcd.Sleep();
+          }
           spi.Sleep();
 
           // Double Tap needs the touch screen to be in normal mode
@@ -381,6 +412,22 @@ void SystemTask::Work() {
 
           state = SystemTaskState::Sleeping;
           break;
+        case Messages::UpdateAlwaysOnDisplay:
+          if (state == SystemTaskState::Sleeping) {
+            // The display task reads the new minute
+            dateTimeController.UpdateTime(nrf_rtc_counter_get(portNRF_RTC_REG));
+            spi.Wakeup();
+            isUpdatingAlwaysOnDisplay = true;
+            displayApp.PushMessage(Pinetime::Applications::Display::Messages::UpdateAlwaysOnDisplay);
+          }
+          break;
+        case Messages::OnAlwaysOnDisplayUpdated:
+          isUpdatingAlwaysOnDisplay = false;
+          if (state == SystemTaskState::Sleeping) {
+            spi.Sleep();
+            StartAlwaysOnDisplayTimer();
+          }
+          break;
         case Messages::OnNewDay:
           // We might be sleeping (with TWI device disabled.
           // Remember we'll have to reset the counter next time we're awake
@@ -441,18 +488,8 @@ void SystemTask::Work() {
       }
     }
 
-    if (isBleDiscoveryTimerRunning) {
-      if (bleDiscoveryTimer == 0) {
-        isBleDiscoveryTimerRunning = false;
-        // Services discovery is deferred from 3 seconds to avoid the conflicts between the host communicating with the
-        // target and vice-versa. I'm not sure if this is the right way to handle this...
-        nimbleController.StartDiscovery();
-      } else {
-        bleDiscoveryTimer--;
-      }
-    }
-
     monitor.Process();
+    UpdateMemoryPressure();
     uint32_t systick_counter = nrf_rtc_counter_get(portNRF_RTC_REG);
     dateTimeController.UpdateTime(systick_counter);
     NoInit_BackUpTime = dateTimeController.CurrentDateTime();
@@ -463,13 +500,47 @@ void SystemTask::Work() {
 #pragma clang diagnostic pop
 }
 
+void SystemTask::UpdateMemoryPressure() {
+  if (xTaskGetTickCount() - lastMemoryPressureUpdate < memoryPressurePeriod) {
+    return;
+  }
+  lastMemoryPressureUpdate = xTaskGetTickCount();
+  const MemoryPressure::Levels previousLevel = memoryPressure.GetLevel();
+
+  const auto heapSize = static_cast<uint32_t>(__HeapLimit - __HeapBase);
+  const auto heapUsed = static_cast<uint32_t>(mallinfo().uordblks);
+  bool changed = memoryPressure.Update(MemoryPressure::Pools::Heap, (heapUsed < heapSize) ? heapSize - heapUsed : 0, heapSize);
+  changed |= memoryPressure.Update(MemoryPressure::Pools::FreeRtosHeap, xPortGetFreeHeapSize(), configTOTAL_HEAP_SIZE);
+  changed |= memoryPressure.Update(MemoryPressure::Pools::BleBuffers, nimbleController.NbFreeBuffers(), nimbleController.NbBuffers());
+
+  if (changed) {
+    for (uint8_t i = 0; i < MemoryPressure::NbPools; i++) {
+      const auto pool = static_cast<MemoryPressure::Pools>(i);
+      const MemoryPressure::Pool& p = memoryPressure.GetPool(pool);
+      // Not tokenized: the tokenized log has no string argument
+      NRF_LOG_INFO("[SystemTask] Memory %s : %d/%d free, min %d, level %d",
+                   MemoryPressure::PoolName(pool),
+                   p.free,
+                   p.total,
+                   p.lowWatermark,
+                   static_cast<int>(p.level));
+    }
+  }
+  // The display task releases its caches and refuses to open the apps that are not needed
+  if (memoryPressure.GetLevel() > previousLevel) {
+    displayApp.PushMessage(Pinetime::Applications::Display::Messages::MemoryPressure);
+  }
+}
+
 void SystemTask::UpdateMotion() {
   if (state == SystemTaskState::GoingToSleep || state == SystemTaskState::WakingUp) {
     return;
   }
 
-  if (state == SystemTaskState::Sleeping && !(settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::RaiseWrist) ||
-                                              settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::Shake))) {
+  // The motion stream goes on while the watch is sleeping
+  if (state == SystemTaskState::Sleeping && !motionController.IsStreaming() &&
+      !(settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::RaiseWrist) ||
+        settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::Shake))) {
     return;
   }
 
@@ -483,6 +554,17 @@ void SystemTask::UpdateMotion() {
   motionController.IsSensorOk(motionSensor.IsOk());
   motionController.Update(motionValues.x, motionValues.y, motionValues.z, motionValues.steps);
 
+  if (motionController.IsStreaming() != motionSensor.IsFifoEnabled()) {
+    motionSensor.EnableFifo(motionController.IsStreaming());
+  }
+  if (motionSensor.IsFifoEnabled()) {
+    // The whole backlog is read: it grows beyond a single read after a stall of the task
+    const auto now = static_cast<uint32_t>(static_cast<uint64_t>(xTaskGetTickCount()) * 1000 / configTICK_RATE_HZ);
+    motionController.UpdateFifo(motionSensor.FifoFrameCount(), now, [this](Drivers::Bma421::AccelValues* values, size_t maxCount) {
+      return motionSensor.ReadFifo(values, maxCount);
+    });
+  }
+
   if (settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::RaiseWrist) &&
       motionController.Should_RaiseWake(state == SystemTaskState::Sleeping)) {
     GoToRunning();
@@ -532,7 +614,14 @@ void SystemTask::GoToRunning() {
   }
 }
 
+void SystemTask::StartAlwaysOnDisplayTimer() {
+  // Wakes up at the start of the next minute
+  const uint32_t delay = (60 - dateTimeController.Seconds()) * 1000;
+  xTimerChangePeriod(alwaysOnDisplayTimer, pdMS_TO_TICKS(delay), 0);
+}
+
 void SystemTask::OnTouchEvent() {
+  touchHandler.OnTouchInterrupt(xTaskGetTickCountFromISR());
   if (state == SystemTaskState::Running) {
     PushMessage(Messages::OnTouchEvent);
   } else if (state == SystemTaskState::Sleeping) {
@@ -548,16 +637,9 @@ void SystemTask::PushMessage(System::Messages msg) {
     state = SystemTaskState::GoingToSleep;
   }
 
-  if (in_isr()) {
-    BaseType_t xHigherPriorityTaskWoken;
-    xHigherPriorityTaskWoken = pdFALSE;
-    xQueueSendFromISR(systemTasksMsgQueue, &msg, &xHigherPriorityTaskWoken);
-    if (xHigherPriorityTaskWoken) {
-      /* Actual macro used here is port specific. */
-      portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
-    }
-  } else {
-    xQueueSend(systemTasksMsgQueue, &msg, portMAX_DELAY);
+  Logging::Trace::Record(Logging::Trace::Events::SystemMessagePosted, static_cast<uint16_t>(msg));
+  if (!messageBus.Post(msg)) {
+    TLOG_INFO("[SystemTask] Message %d dropped", static_cast<int>(msg));
   }
 }
 
@@ -565,7 +647,7 @@ void SystemTask::OnDim() {
   if (doNotGoToSleep) {
     return;
   }
-  NRF_LOG_INFO("Dim timeout -> Dim screen")
+  TLOG_INFO("Dim timeout -> Dim screen");
   displayApp.PushMessage(Pinetime::Applications::Display::Messages::DimScreen);
   xTimerStart(idleTimer, 0);
   isDimmed = true;
@@ -575,7 +657,7 @@ void SystemTask::OnIdle() {
   if (doNotGoToSleep) {
     return;
   }
-  NRF_LOG_INFO("Idle timeout -> Going to sleep")
+  TLOG_INFO("Idle timeout -> Going to sleep");
   PushMessage(Messages::GoToSleep);
 }
 
@@ -12,7 +12,9 @@
 #include <drivers/PinMap.h>
 #include <components/motion/MotionController.h>
 
+#include "systemtask/MessageBus.h"
 #include "systemtask/SystemMonitor.h"
+#include "systemtask/MemoryPressure.h"
 #include "components/ble/NimbleController.h"
 #include "components/ble/NotificationManager.h"
 #include "components/motor/MotorController.h"
@@ -79,9 +81,24 @@ namespace Pinetime {
                  Pinetime::Controllers::TouchHandler& touchHandler,
                  Pinetime::Controllers::ButtonHandler& buttonHandler);
 
+      using MessageBus = System::MessageBus<Messages, 16>;
+
       void Start();
       void PushMessage(Messages msg);
 
+      MessageBus::Statistics GetMessageStatistics() const {
+        return messageBus.GetStatistics();
+      }
+
+      RunTimeStats::Statistics GetRunTimeStatistics() const {
+        return monitor.GetStatistics();
+      }
+
+      /// The display task updates the LVGL pool, the system task the other ones
+      MemoryPressure& GetMemoryPressure() {
+        return memoryPressure;
+      }
+
       void OnTouchEvent();
 
       void OnIdle();
@@ -110,7 +127,13 @@ namespace Pinetime {
       Pinetime::Controllers::DateTime& dateTimeController;
       Pinetime::Controllers::TimerController& timerController;
       Pinetime::Controllers::AlarmController& alarmController;
-      QueueHandle_t systemTasksMsgQueue;
+      MessageBus messageBus {MessageBus::MaskOf({Messages::OnTouchEvent,
+                                                 Messages::OnNewTime,
+                                                 Messages::OnNewNotification,
+                                                 Messages::UpdateTimeOut,
+                                                 Messages::OnChargingEvent,
+                                                 Messages::MeasureBatteryTimerExpired,
+                                                 Messages::BatteryPercentageUpdated})};
       Pinetime::Drivers::Watchdog& watchdog;
       Pinetime::Controllers::NotificationManager& notificationManager;
       Pinetime::Controllers::MotorController& motorController;
@@ -130,11 +153,13 @@ namespace Pinetime {
       static void Process(void* instance);
       void Work();
       void ReloadIdleTimer();
-      bool isBleDiscoveryTimerRunning = false;
-      uint8_t bleDiscoveryTimer = 0;
       TimerHandle_t dimTimer;
       TimerHandle_t idleTimer;
       TimerHandle_t measureBatteryTimer;
+      TimerHandle_t alwaysOnDisplayTimer;
+      TimerHandle_t bleDiscoveryTimer;
+      // The display task is drawing the always-on display: the SPI is awake
+      bool isUpdatingAlwaysOnDisplay = false;
       bool doNotGoToSleep = false;
       bool isDimmed = false;
       SystemTaskState state = SystemTaskState::Running;
@@ -143,11 +168,19 @@ namespace Pinetime {
       bool fastWakeUpDone = false;
 
       void GoToRunning();
+      void StartAlwaysOnDisplayTimer();
       void UpdateMotion();
       bool stepCounterMustBeReset = false;
       static constexpr TickType_t batteryMeasurementPeriod = pdMS_TO_TICKS(10 * 60 * 1000);
+      // Delay between the connection and the discovery of the services of the peer
+      static constexpr TickType_t bleDiscoveryDelay = pdMS_TO_TICKS(500);
 
       SystemMonitor monitor;
+
+      void UpdateMemoryPressure();
+      static constexpr TickType_t memoryPressurePeriod = pdMS_TO_TICKS(1000);
+      TickType_t lastMemoryPressureUpdate = 0;
+      MemoryPressure memoryPressure;
     };
   }
 }
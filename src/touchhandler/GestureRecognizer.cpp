@@ -0,0 +1,138 @@
+#include "touchhandler/GestureRecognizer.h"
+#include <cstdlib>
+
+using namespace Pinetime::Controllers;
+
+GestureRecognizer::GestureRecognizer(uint32_t ticksPerSecond)
+  : ticksPerSecond {ticksPerSecond},
+    longPressTicks {MsToTicks(LongPressDelay)},
+    doubleTapTicks {MsToTicks(DoubleTapDelay)},
+    maxSampleGapTicks {MsToTicks(MaxSampleGap)},
+    velocityWindowTicks {MsToTicks(VelocityWindow)} {
+}
+
+uint32_t GestureRecognizer::MsToTicks(uint32_t ms) const {
+  return static_cast<uint32_t>(static_cast<uint64_t>(ms) * ticksPerSecond / 1000);
+}
+
+void GestureRecognizer::Reset() {
+  state = States::Idle;
+  drag = {};
+  velocity = {};
+  sampleCount = 0;
+  historyCount = 0;
+  tapPending = false;
+}
+
+GestureRecognizer::Gestures GestureRecognizer::OnSample(int32_t x, int32_t y, bool touching, uint32_t timestamp) {
+  if (!touching) {
+    if (state == States::Idle) {
+      // Release without any point of the touch: the panel doesn't report raw points
+      sampleCount = 1;
+      return Gestures::None;
+    }
+    // The coordinates of the release are not used: the velocity is the one of the last points of the touch
+    if (sampleCount < UINT8_MAX) {
+      sampleCount++;
+    }
+    return OnRelease(timestamp);
+  }
+
+  if (state == States::Idle || timestamp - history[historyHead].timestamp > maxSampleGapTicks) {
+    StartTouch(x, y, timestamp);
+    return Gestures::None;
+  }
+
+  AddToHistory(x, y, timestamp);
+  if (sampleCount < UINT8_MAX) {
+    sampleCount++;
+  }
+  drag = {x - start.x, y - start.y};
+  UpdateVelocity();
+
+  if (state == States::Pressed) {
+    if (std::abs(drag.x) > TouchSlop || std::abs(drag.y) > TouchSlop) {
+      state = States::Dragging;
+    } else if (timestamp - start.timestamp >= longPressTicks) {
+      state = States::LongPressed;
+      return Gestures::LongPress;
+    }
+  }
+  if (state == States::Dragging && (std::abs(drag.x) >= SwipeDistance || std::abs(drag.y) >= SwipeDistance)) {
+    state = States::Swiped;
+    return SwipeDirection(drag.x, drag.y);
+  }
+  return Gestures::None;
+}
+
+void GestureRecognizer::StartTouch(int32_t x, int32_t y, uint32_t timestamp) {
+  state = States::Pressed;
+  start = {x, y, timestamp};
+  drag = {};
+  velocity = {};
+  sampleCount = 1;
+  historyCount = 0;
+  AddToHistory(x, y, timestamp);
+}
+
+void GestureRecognizer::AddToHistory(int32_t x, int32_t y, uint32_t timestamp) {
+  historyHead = (historyHead + 1) % HistorySize;
+  history[historyHead] = {x, y, timestamp};
+  if (historyCount < HistorySize) {
+    historyCount++;
+  }
+}
+
+void GestureRecognizer::UpdateVelocity() {
+  const Sample& newest = history[historyHead];
+  // Oldest sample of the history that is still in the velocity window
+  const Sample* oldest = &newest;
+  for (size_t i = 1; i < historyCount; i++) {
+    const Sample& sample = history[(historyHead + HistorySize - i) % HistorySize];
+    if (newest.timestamp - sample.timestamp > velocityWindowTicks) {
+      break;
+    }
+    oldest = &sample;
+  }
+
+  const uint32_t elapsed = newest.timestamp - oldest->timestamp;
+  if (elapsed == 0) {
+    return;
+  }
+  velocity.x = static_cast<int32_t>(static_cast<int64_t>(newest.x - oldest->x) * ticksPerSecond / elapsed);
+  velocity.y = static_cast<int32_t>(static_cast<int64_t>(newest.y - oldest->y) * ticksPerSecond / elapsed);
+}
+
+GestureRecognizer::Gestures GestureRecognizer::OnRelease(uint32_t timestamp) {
+  const States releasedState = state;
+  state = States::Idle;
+
+  switch (releasedState) {
+    case States::Pressed:
+      if (tapPending && timestamp - lastTap.timestamp <= doubleTapTicks && std::abs(start.x - lastTap.x) <= DoubleTapSlop &&
+          std::abs(start.y - lastTap.y) <= DoubleTapSlop) {
+        tapPending = false;
+        return Gestures::DoubleTap;
+      }
+      tapPending = true;
+      lastTap = {start.x, start.y, timestamp};
+      return Gestures::Tap;
+    case States::Dragging:
+      // Flick shorter than SwipeDistance, but fast enough
+      tapPending = false;
+      if (std::abs(velocity.x) >= FlingVelocity || std::abs(velocity.y) >= FlingVelocity) {
+        return SwipeDirection(velocity.x, velocity.y);
+      }
+      return Gestures::None;
+    default:
+      tapPending = false;
+      return Gestures::None;
+  }
+}
+
+GestureRecognizer::Gestures GestureRecognizer::SwipeDirection(int32_t dx, int32_t dy) {
+  if (std::abs(dx) >= std::abs(dy)) {
+    return (dx > 0) ? Gestures::SwipeRight : Gestures::SwipeLeft;
+  }
+  return (dy > 0) ? Gestures::SwipeDown : Gestures::SwipeUp;
+}
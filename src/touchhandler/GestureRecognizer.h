@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+    /**
+     * Recognizes gestures from the raw points of the touch panel, instead of relying on the gesture codes of the chip.
+     *
+     * A gesture is reported as soon as the sample that completes it is received:
+     *  - a swipe when the finger moves further than SwipeDistance, or is released while moving faster than FlingVelocity,
+     *  - a long press when the finger stays still for LongPressDelay,
+     *  - a tap on release, or a double tap if the previous tap was released less than DoubleTapDelay before, close by.
+     * At most one swipe or long press is reported per touch. The velocity of the finger, for the flicks, is estimated from
+     * the last samples.
+     *
+     * It doesn't depend on the OS: timestamps are in ticks of ticksPerSecond, and may wrap around.
+     */
+    class GestureRecognizer {
+    public:
+      enum class Gestures : uint8_t { None, Tap, DoubleTap, LongPress, SwipeLeft, SwipeRight, SwipeUp, SwipeDown };
+
+      struct Vector {
+        int32_t x = 0;
+        int32_t y = 0;
+      };
+
+      // Thresholds, in pixels and milliseconds
+      static constexpr int32_t TouchSlop = 12;
+      static constexpr int32_t SwipeDistance = 40;
+      static constexpr int32_t FlingVelocity = 400; // px/s
+      static constexpr int32_t DoubleTapSlop = 40;
+      static constexpr uint32_t LongPressDelay = 600;
+      static constexpr uint32_t DoubleTapDelay = 400;
+      // Without a new sample for that long, the release was missed and the next point starts a new touch
+      static constexpr uint32_t MaxSampleGap = 500;
+      // Velocity is estimated over the samples of this last period
+      static constexpr uint32_t VelocityWindow = 80;
+
+      explicit GestureRecognizer(uint32_t ticksPerSecond);
+
+      /// Feeds a point of the touch panel, and returns the gesture it completes, if any
+      Gestures OnSample(int32_t x, int32_t y, bool touching, uint32_t timestamp);
+      void Reset();
+
+      /// Number of samples received for the current touch (or the last one once released), release included
+      uint8_t SampleCount() const {
+        return sampleCount;
+      }
+
+    private:
+      enum class States : uint8_t { Idle, Pressed, Dragging, Swiped, LongPressed };
+
+      struct Sample {
+        int32_t x;
+        int32_t y;
+        uint32_t timestamp;
+      };
+
+      static constexpr size_t HistorySize = 4;
+
+      uint32_t MsToTicks(uint32_t ms) const;
+      void StartTouch(int32_t x, int32_t y, uint32_t timestamp);
+      void AddToHistory(int32_t x, int32_t y, uint32_t timestamp);
+      void UpdateVelocity();
+      Gestures OnRelease(uint32_t timestamp);
+      static Gestures SwipeDirection(int32_t dx, int32_t dy);
+
+      const uint32_t ticksPerSecond;
+      const uint32_t longPressTicks;
+      const uint32_t doubleTapTicks;
+      const uint32_t maxSampleGapTicks;
+      const uint32_t velocityWindowTicks;
+
+      States state = States::Idle;
+      Sample start {};
+      Vector drag;
+      Vector velocity;
+      uint8_t sampleCount = 0;
+
+      std::array<Sample, HistorySize> history;
+      size_t historyHead = 0;
+      size_t historyCount = 0;
+
+      bool tapPending = false;
+      Sample lastTap {};
+    };
+  }
+}
@@ -30,6 +30,31 @@ namespace {
         return TouchEvents::None;
     }
   }
+
+  TouchEvents ConvertGesture(GestureRecognizer::Gestures gesture) {
+    switch (gesture) {
+      case GestureRecognizer::Gestures::Tap:
+        return TouchEvents::Tap;
+      case GestureRecognizer::Gestures::DoubleTap:
+        return TouchEvents::DoubleTap;
+      case GestureRecognizer::Gestures::LongPress:
+        return TouchEvents::LongTap;
+      case GestureRecognizer::Gestures::SwipeLeft:
+        return TouchEvents::SwipeLeft;
+      case GestureRecognizer::Gestures::SwipeRight:
+        return TouchEvents::SwipeRight;
+      case GestureRecognizer::Gestures::SwipeUp:
+        return TouchEvents::SwipeUp;
+      case GestureRecognizer::Gestures::SwipeDown:
+        return TouchEvents::SwipeDown;
+      case GestureRecognizer::Gestures::None:
+      default:
+        return TouchEvents::None;
+    }
+  }
+
+  // A touch with fewer points was not tracked by the recognizer: the panel only reports its gestures (in sleep mode)
+  constexpr uint8_t minRawSamples = 2;
 }
 
 TouchHandler::TouchHandler(Drivers::Cst816S& touchPanel, Components::LittleVgl& lvgl) : touchPanel {touchPanel}, lvgl {lvgl} {
@@ -38,7 +63,7 @@ TouchHandler::TouchHandler(Drivers::Cst816S& touchPanel, Components::LittleVgl&
 void TouchHandler::CancelTap() {
   if (info.touching) {
     isCancelled = true;
-    lvgl.SetNewTouchPoint(-1, -1, true);
+    lvgl.CancelTouchPoint();
   }
 }
 
@@ -55,21 +80,11 @@ bool TouchHandler::GetNewTouchInfo() {
     return false;
   }
 
-  if (info.gesture != Pinetime::Drivers::Cst816S::Gestures::None) {
-    if (gestureReleased) {
-      if (info.gesture == Pinetime::Drivers::Cst816S::Gestures::SlideDown ||
-          info.gesture == Pinetime::Drivers::Cst816S::Gestures::SlideLeft ||
-          info.gesture == Pinetime::Drivers::Cst816S::Gestures::SlideUp ||
-          info.gesture == Pinetime::Drivers::Cst816S::Gestures::SlideRight ||
-          info.gesture == Pinetime::Drivers::Cst816S::Gestures::LongPress) {
-        if (info.touching) {
-          gesture = ConvertGesture(info.gesture);
-          gestureReleased = false;
-        }
-      } else {
-        gesture = ConvertGesture(info.gesture);
-      }
-    }
+  auto recognized = recognizer.OnSample(info.x, info.y, info.touching, interruptTimestamp);
+  if (recognized != GestureRecognizer::Gestures::None) {
+    gesture = ConvertGesture(recognized);
+  } else if (recognizer.SampleCount() < minRawSamples) {
+    HandleChipGesture();
   }
 
   if (!info.touching) {
@@ -79,17 +94,37 @@ bool TouchHandler::GetNewTouchInfo() {
   return true;
 }
 
+void TouchHandler::HandleChipGesture() {
+  if (info.gesture == Pinetime::Drivers::Cst816S::Gestures::None || !gestureReleased) {
+    return;
+  }
+
+  if (info.gesture == Pinetime::Drivers::Cst816S::Gestures::SlideDown ||
+      info.gesture == Pinetime::Drivers::Cst816S::Gestures::SlideLeft ||
+      info.gesture == Pinetime::Drivers::Cst816S::Gestures::SlideUp ||
+      info.gesture == Pinetime::Drivers::Cst816S::Gestures::SlideRight ||
+      info.gesture == Pinetime::Drivers::Cst816S::Gestures::LongPress) {
+    if (info.touching) {
+      gesture = ConvertGesture(info.gesture);
+      gestureReleased = false;
+    }
+  } else {
+    gesture = ConvertGesture(info.gesture);
+  }
+}
+
 void TouchHandler::UpdateLvglTouchPoint() {
+  const TickType_t timestamp = interruptTimestamp;
   if (info.touching) {
     if (!isCancelled) {
-      lvgl.SetNewTouchPoint(info.x, info.y, true);
+      lvgl.SetNewTouchPoint(info.x, info.y, true, timestamp);
     }
   } else {
     if (isCancelled) {
-      lvgl.SetNewTouchPoint(-1, -1, false);
+      lvgl.SetNewTouchPoint(-1, -1, false, timestamp);
       isCancelled = false;
     } else {
-      lvgl.SetNewTouchPoint(info.x, info.y, false);
+      lvgl.SetNewTouchPoint(info.x, info.y, false, timestamp);
     }
   }
 }
@@ -1,6 +1,9 @@
 #pragma once
+#include <atomic>
+#include <FreeRTOS.h>
 #include "drivers/Cst816s.h"
 #include "displayapp/TouchEvents.h"
+#include "touchhandler/GestureRecognizer.h"
 
 namespace Pinetime {
   namespace Components {
@@ -14,6 +17,10 @@ namespace Pinetime {
     public:
       explicit TouchHandler(Drivers::Cst816S&, Components::LittleVgl&);
       void CancelTap();
+      /// Records the time of the touch interrupt, to timestamp the touch point read next
+      void OnTouchInterrupt(TickType_t timestamp) {
+        interruptTimestamp = timestamp;
+      }
       bool GetNewTouchInfo();
       void UpdateLvglTouchPoint();
 
@@ -29,12 +36,16 @@ namespace Pinetime {
       Pinetime::Applications::TouchEvents GestureGet();
 
     private:
+      void HandleChipGesture();
+
       Pinetime::Drivers::Cst816S::TouchInfos info;
       Pinetime::Drivers::Cst816S& touchPanel;
       Pinetime::Components::LittleVgl& lvgl;
       Pinetime::Applications::TouchEvents gesture;
       bool isCancelled = false;
       bool gestureReleased = true;
+      std::atomic<TickType_t> interruptTimestamp {0};
+      GestureRecognizer recognizer {configTICK_RATE_HZ};
     };
   }
 }
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace Pinetime {
+  namespace Utility {
+    /// Lock-free single producer / single consumer ring buffer.
+    /// Push() must only be called from the producer context (task or ISR), Pop() and Peek() from the consumer context.
+    /// When the buffer is full, Push() fails and the new item is dropped: the producer never blocks and never modifies
+    /// the read index owned by the consumer.
+    template <typename T, size_t N>
+    class SpscRingBuffer {
+      static_assert(N >= 2 && (N & (N - 1)) == 0, "The size of the buffer must be a power of 2");
+
+    public:
+      bool Push(const T& item) {
+        const size_t head = writeIndex.load(std::memory_order_relaxed);
+        if (head - readIndex.load(std::memory_order_acquire) == N) {
+          return false;
+        }
+        buffer[head & (N - 1)] = item;
+        writeIndex.store(head + 1, std::memory_order_release);
+        return true;
+      }
+
+      bool Pop(T& item) {
+        if (!Peek(item, 0)) {
+          return false;
+        }
+        Discard(1);
+        return true;
+      }
+
+      /// Copies the item at the given offset from the oldest one without removing it
+      bool Peek(T& item, size_t offset) const {
+        const size_t tail = readIndex.load(std::memory_order_relaxed);
+        if (writeIndex.load(std::memory_order_acquire) - tail <= offset) {
+          return false;
+        }
+        item = buffer[(tail + offset) & (N - 1)];
+        return true;
+      }
+
+      /// Removes the count oldest items (consumer only)
+      void Discard(size_t count) {
+        const size_t tail = readIndex.load(std::memory_order_relaxed);
+        const size_t available = writeIndex.load(std::memory_order_acquire) - tail;
+        readIndex.store(tail + (count < available ? count : available), std::memory_order_release);
+      }
+
+      size_t Size() const {
+        return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire);
+      }
+
+      bool Empty() const {
+        return Size() == 0;
+      }
+
+      static constexpr size_t Capacity() {
+        return N;
+      }
+
+    private:
+      std::array<T, N> buffer;
+      std::atomic<size_t> writeIndex {0};
+      std::atomic<size_t> readIndex {0};
+    };
+  }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+namespace Pinetime {
+  namespace Utility {
+    /// Null-terminated string of at most Capacity characters stored inline: assigning it never allocates.
+    /// Longer strings are truncated.
+    template <size_t Capacity>
+    class StaticString {
+    public:
+      StaticString() = default;
+
+      explicit StaticString(const char* str) {
+        Assign(str, std::strlen(str));
+      }
+
+      void Assign(const char* str, size_t newLength) {
+        char* data = Resize(newLength);
+        std::memcpy(data, str, length);
+      }
+
+      /// Sets the length of the string (clamped to Capacity) and returns its buffer, which the caller fills with
+      /// Size() characters
+      char* Resize(size_t newLength) {
+        length = (newLength < Capacity) ? newLength : Capacity;
+        buffer[length] = '\0';
+        return buffer.data();
+      }
+
+      const char* Data() const {
+        return buffer.data();
+      }
+
+      size_t Size() const {
+        return length;
+      }
+
+      bool Empty() const {
+        return length == 0;
+      }
+
+      static constexpr size_t MaxSize() {
+        return Capacity;
+      }
+
+    private:
+      std::array<char, Capacity + 1> buffer {};
+      size_t length = 0;
+    };
+  }
+}
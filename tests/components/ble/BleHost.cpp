@@ -0,0 +1,41 @@
+#include "BleHost.h"
+
+std::vector<const ble_gatt_svc_def*>& BleHost::RegisteredServices() {
+  static std::vector<const ble_gatt_svc_def*> services;
+  return services;
+}
+
+std::vector<uint16_t> BleHost::StartGattServer(const ble_gatt_svc_def* service, uint16_t serviceHandle) {
+  std::vector<uint16_t> valueHandles;
+  uint16_t handle = serviceHandle + 1;
+  for (const ble_gatt_chr_def* characteristic = service->characteristics; characteristic->uuid != nullptr; characteristic++) {
+    *characteristic->val_handle = handle + 1;
+    valueHandles.push_back(handle + 1);
+    handle += (characteristic->flags & BLE_GATT_CHR_F_NOTIFY) ? 3 : 2;
+  }
+  return valueHandles;
+}
+
+int BleHost::Access(const ble_gatt_svc_def* service, uint16_t attributeHandle, uint8_t op, os_mbuf* om) {
+  for (const ble_gatt_chr_def* characteristic = service->characteristics; characteristic->uuid != nullptr; characteristic++) {
+    if (*characteristic->val_handle == attributeHandle) {
+      ble_gatt_access_ctxt context {};
+      context.op = op;
+      context.om = om;
+      context.chr = characteristic;
+      return characteristic->access_cb(1, attributeHandle, &context, characteristic->arg);
+    }
+  }
+  return BLE_ATT_ERR_ATTR_NOT_FOUND;
+}
+
+extern "C" int ble_gatts_count_cfg(const ble_gatt_svc_def* /*defs*/) {
+  return 0;
+}
+
+extern "C" int ble_gatts_add_svcs(const ble_gatt_svc_def* svcs) {
+  for (const ble_gatt_svc_def* service = svcs; service->type != 0; service++) {
+    BleHost::RegisteredServices().push_back(service);
+  }
+  return 0;
+}
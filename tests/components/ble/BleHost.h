@@ -0,0 +1,61 @@
+#pragma once
+// What the BLE host of NimBLE does for the services under test: mbufs with the values written by the phone, and the
+// value handles allocated when the GATT server starts
+#include <string>
+#include <vector>
+#include <os/os_mbuf.h>
+#include <host/ble_gatt.h>
+#undef min
+#undef max
+
+namespace BleHost {
+  // NimBLE registers the pools in a global list, and never removes them: a single pool for all the tests, like the msys
+  // pool of the firmware
+  class MbufPool {
+  public:
+    // Small mbufs, so that a value spans several of them, like the values that the BLE host chains from the ACL packets
+    static constexpr uint16_t DataSize = 16;
+    static constexpr uint16_t NbMbufs = 256;
+
+    static MbufPool& Instance() {
+      static MbufPool instance;
+      return instance;
+    }
+
+    MbufPool(const MbufPool&) = delete;
+    MbufPool& operator=(const MbufPool&) = delete;
+
+    os_mbuf* Make(const std::string& data) {
+      os_mbuf* om = os_mbuf_get_pkthdr(&pool, 0);
+      os_mbuf_append(om, data.data(), data.size());
+      return om;
+    }
+
+    size_t NbFree() const {
+      return mempool.mp_num_free;
+    }
+
+  private:
+    static constexpr uint16_t MbufSize = sizeof(os_mbuf) + sizeof(os_mbuf_pkthdr) + DataSize;
+
+    MbufPool() {
+      static char name[] = "test_mbufs";
+      os_mempool_init(&mempool, NbMbufs, MbufSize, buffer.data(), name);
+      os_mbuf_pool_init(&pool, &mempool, MbufSize, NbMbufs);
+    }
+
+    std::vector<os_membuf_t> buffer = std::vector<os_membuf_t>(OS_MEMPOOL_SIZE(NbMbufs, MbufSize));
+    os_mempool mempool;
+    os_mbuf_pool pool;
+  };
+
+  /// Services registered with ble_gatts_add_svcs() (BleHost.cpp), most recent last
+  std::vector<const ble_gatt_svc_def*>& RegisteredServices();
+
+  /// What ble_gatts_start() does: the attributes of a characteristic are its declaration, its value and the CCCD if it
+  /// notifies, allocated in sequence after the service declaration. Returns the value handles.
+  std::vector<uint16_t> StartGattServer(const ble_gatt_svc_def* service, uint16_t serviceHandle);
+
+  /// Calls the access callback of the characteristic of the value handle, like the ATT server does for a read or a write
+  int Access(const ble_gatt_svc_def* service, uint16_t attributeHandle, uint8_t op, os_mbuf* om);
+}
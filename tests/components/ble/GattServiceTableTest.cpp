@@ -0,0 +1,196 @@
+#include "components/ble/GattServiceTable.h"
+#include "BleHost.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using Pinetime::Controllers::GattCharacteristic;
+using Pinetime::Controllers::GattServiceTable;
+
+namespace {
+  constexpr size_t NbCharacteristics = 10;
+
+  // A service with as many characteristics as the Music service: the value of each one is its index
+  class Service {
+  public:
+    Service() : gattService {*this, &serviceUuid.u, characteristics} {
+    }
+
+    int Read(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* /*context*/) {
+      nbReads++;
+      return 0;
+    }
+
+    int Write(uint16_t /*connectionHandle*/, ble_gatt_access_ctxt* /*context*/) {
+      nbWrites++;
+      return 0;
+    }
+
+    static constexpr ble_uuid16_t serviceUuid {.u {.type = BLE_UUID_TYPE_16}, .value = 0xfff0};
+    static const ble_uuid16_t uuids[NbCharacteristics];
+    static const GattCharacteristic<Service> characteristics[NbCharacteristics];
+
+    GattServiceTable<Service, NbCharacteristics> gattService;
+    int nbReads = 0;
+    int nbWrites = 0;
+  };
+
+  constexpr ble_uuid16_t Service::serviceUuid;
+
+  constexpr ble_uuid16_t Uuid(uint16_t value) {
+    return {.u {.type = BLE_UUID_TYPE_16}, .value = value};
+  }
+
+  const ble_uuid16_t Service::uuids[NbCharacteristics] = {Uuid(0xfff1),
+                                                           Uuid(0xfff2),
+                                                           Uuid(0xfff3),
+                                                           Uuid(0xfff4),
+                                                           Uuid(0xfff5),
+                                                           Uuid(0xfff6),
+                                                           Uuid(0xfff7),
+                                                           Uuid(0xfff8),
+                                                           Uuid(0xfff9),
+                                                           Uuid(0xfffa)};
+
+  // Even characteristics notify, like the status characteristics of the services, odd ones are written by the phone
+  constexpr GattCharacteristic<Service> Notified(const ble_uuid16_t& uuid) {
+    return {.uuid = &uuid.u, .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY, .onRead = &Service::Read, .onWrite = nullptr,
+            .valueHandle = nullptr};
+  }
+
+  constexpr GattCharacteristic<Service> Written(const ble_uuid16_t& uuid) {
+    return {.uuid = &uuid.u, .flags = BLE_GATT_CHR_F_WRITE, .onRead = nullptr, .onWrite = &Service::Write, .valueHandle = nullptr};
+  }
+
+  const GattCharacteristic<Service> Service::characteristics[NbCharacteristics] = {Notified(uuids[0]),
+                                                                                  Written(uuids[1]),
+                                                                                  Notified(uuids[2]),
+                                                                                  Written(uuids[3]),
+                                                                                  Notified(uuids[4]),
+                                                                                  Written(uuids[5]),
+                                                                                  Notified(uuids[6]),
+                                                                                  Written(uuids[7]),
+                                                                                  Notified(uuids[8]),
+                                                                                  Written(uuids[9])};
+
+  std::vector<uint16_t> StartServer(Service& service, uint16_t serviceHandle) {
+    return BleHost::StartGattServer(service.gattService.Definition(), serviceHandle);
+  }
+
+  ble_gatt_access_ctxt Access(uint8_t op) {
+    ble_gatt_access_ctxt context {};
+    context.op = op;
+    return context;
+  }
+}
+
+TEST(GattServiceTableTest, BuildsTheServiceDefinition) {
+  Service service;
+  const ble_gatt_svc_def* definition = service.gattService.Definition();
+  EXPECT_EQ(BLE_GATT_SVC_TYPE_PRIMARY, definition[0].type);
+  EXPECT_EQ(&Service::serviceUuid.u, definition[0].uuid);
+  for (size_t i = 0; i < NbCharacteristics; i++) {
+    EXPECT_EQ(&Service::uuids[i].u, definition[0].characteristics[i].uuid);
+    EXPECT_EQ(Service::characteristics[i].flags, definition[0].characteristics[i].flags);
+  }
+  EXPECT_EQ(nullptr, definition[0].characteristics[NbCharacteristics].uuid);
+  EXPECT_EQ(0, definition[1].type);
+}
+
+TEST(GattServiceTableTest, DispatchesByValueHandle) {
+  Service service;
+  const auto valueHandles = StartServer(service, 0x20);
+  auto read = Access(BLE_GATT_ACCESS_OP_READ_CHR);
+  auto write = Access(BLE_GATT_ACCESS_OP_WRITE_CHR);
+  for (size_t i = 0; i < NbCharacteristics; i++) {
+    EXPECT_EQ(valueHandles[i], service.gattService.ValueHandle(i));
+    EXPECT_EQ(0, service.gattService.Dispatch(1, valueHandles[i], &read));
+    EXPECT_EQ(0, service.gattService.Dispatch(1, valueHandles[i], &write));
+  }
+  // Only the handler of the operation is called
+  EXPECT_EQ(5, service.nbReads);
+  EXPECT_EQ(5, service.nbWrites);
+}
+
+TEST(GattServiceTableTest, IgnoresTheOtherAttributes) {
+  Service service;
+  const auto valueHandles = StartServer(service, 0x20);
+  auto read = Access(BLE_GATT_ACCESS_OP_READ_CHR);
+  // Service declaration, characteristic declarations, CCCDs and the attributes of the other services
+  for (uint16_t handle = 1; handle < 0x80; handle++) {
+    if (std::find(valueHandles.begin(), valueHandles.end(), handle) == valueHandles.end()) {
+      EXPECT_EQ(0, service.gattService.Dispatch(1, handle, &read));
+    }
+  }
+  EXPECT_EQ(0, service.nbReads);
+}
+
+TEST(GattServiceTableTest, AccessBeforeTheServerStarted) {
+  Service service;
+  auto read = Access(BLE_GATT_ACCESS_OP_READ_CHR);
+  EXPECT_EQ(0, service.gattService.Dispatch(1, 0, &read));
+  EXPECT_EQ(0, service.nbReads);
+
+  // The index is built once the value handles are known
+  const auto valueHandles = StartServer(service, 0x20);
+  service.gattService.Dispatch(1, valueHandles[0], &read);
+  EXPECT_EQ(1, service.nbReads);
+}
+
+TEST(GattServiceTableTest, ValueHandlesOutsideTheIndex) {
+  // Not the layout of NimBLE, but an access is never dispatched to the wrong characteristic
+  Service service;
+  for (size_t i = 0; i < NbCharacteristics; i++) {
+    *service.gattService.Definition()[0].characteristics[i].val_handle = static_cast<uint16_t>(0x100 + 0x40 * i);
+  }
+  auto write = Access(BLE_GATT_ACCESS_OP_WRITE_CHR);
+  service.gattService.Dispatch(1, 0x100 + 0x40 * 3, &write);
+  EXPECT_EQ(1, service.nbWrites);
+  service.gattService.Dispatch(1, 0x100 + 0x40 * 2, &write);
+  service.gattService.Dispatch(1, 0x101, &write);
+  EXPECT_EQ(1, service.nbWrites);
+}
+
+TEST(GattServiceTableTest, DispatchThroughput) {
+  Service service;
+  const auto valueHandles = StartServer(service, 0x20);
+  auto write = Access(BLE_GATT_ACCESS_OP_WRITE_CHR);
+  constexpr int nbRounds = 200000;
+
+  // The lookup that the index replaces: the value handles compared one after the other
+  std::array<uint16_t, NbCharacteristics> scanned;
+  for (size_t i = 0; i < NbCharacteristics; i++) {
+    scanned[i] = service.gattService.ValueHandle(i);
+  }
+  auto start = std::chrono::steady_clock::now();
+  size_t found = 0;
+  for (int round = 0; round < nbRounds; round++) {
+    const uint16_t handle = valueHandles[round % NbCharacteristics];
+    size_t idx = 0;
+    while (idx < NbCharacteristics && scanned[idx] != handle) {
+      idx++;
+    }
+    if (idx < NbCharacteristics && Service::characteristics[idx].onWrite != nullptr) {
+      found += (service.*Service::characteristics[idx].onWrite)(1, &write) == 0;
+    }
+  }
+  const std::chrono::duration<double, std::nano> linear = std::chrono::steady_clock::now() - start;
+  ASSERT_EQ(static_cast<size_t>(nbRounds / 2), found);
+
+  service.nbWrites = 0;
+  start = std::chrono::steady_clock::now();
+  for (int round = 0; round < nbRounds; round++) {
+    service.gattService.Dispatch(1, valueHandles[round % NbCharacteristics], &write);
+  }
+  const std::chrono::duration<double, std::nano> indexed = std::chrono::steady_clock::now() - start;
+  ASSERT_EQ(nbRounds / 2, service.nbWrites);
+
+  RecordProperty("indexed_ns", static_cast<int>(indexed.count() / nbRounds));
+  RecordProperty("linear_ns", static_cast<int>(linear.count() / nbRounds));
+  std::cout << "GattServiceTable (" << NbCharacteristics << " characteristics): " << indexed.count() / nbRounds
+            << " ns per access with the index, " << linear.count() / nbRounds << " ns with a linear scan of the value handles"
+            << std::endl;
+}
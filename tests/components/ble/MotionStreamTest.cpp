@@ -0,0 +1,239 @@
+#include "components/ble/MotionStream.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using Pinetime::Controllers::MotionStream;
+using Pinetime::Drivers::Bma421;
+
+namespace {
+  // Decoder of the packets of the motion stream, as described in doc/MotionService.md
+  struct Packet {
+    uint8_t version;
+    uint16_t sequence;
+    uint16_t droppedSamples;
+    std::vector<MotionStream::Sample> samples;
+  };
+
+  uint16_t Read16(const uint8_t* data) {
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+  }
+
+  uint32_t Read32(const uint8_t* data) {
+    return Read16(data) | (static_cast<uint32_t>(Read16(data + 2)) << 16);
+  }
+
+  Packet Decode(const uint8_t* data, size_t size) {
+    Packet packet {data[0], Read16(data + 2), Read16(data + 4), {}};
+    const uint32_t timestamp = Read32(data + 6);
+    EXPECT_EQ(size, MotionStream::headerSize + data[1] * MotionStream::sampleSize);
+    for (const uint8_t* sample = data + MotionStream::headerSize; sample < data + size; sample += MotionStream::sampleSize) {
+      packet.samples.push_back({timestamp + Read16(sample),
+                                static_cast<int16_t>(Read16(sample + 2)),
+                                static_cast<int16_t>(Read16(sample + 4)),
+                                static_cast<int16_t>(Read16(sample + 6))});
+    }
+    return packet;
+  }
+
+  // Sends all the samples of the stream in packets of packetSize bytes
+  std::vector<Packet> Flush(MotionStream& stream, size_t packetSize) {
+    std::vector<Packet> packets;
+    uint8_t data[MotionStream::maxPacketSize];
+    size_t nbSamples;
+    size_t size;
+    while ((size = stream.Encode(data, packetSize, nbSamples)) > 0) {
+      EXPECT_LE(size, packetSize);
+      packets.push_back(Decode(data, size));
+      EXPECT_EQ(packets.back().samples.size(), nbSamples);
+      stream.Consume(nbSamples);
+    }
+    return packets;
+  }
+
+  MotionStream::Sample MakeSample(uint32_t i) {
+    return {1000000 + i * 40, static_cast<int16_t>(i), static_cast<int16_t>(-2048 + static_cast<int>(i)), static_cast<int16_t>(-i * 3)};
+  }
+
+  void ExpectSample(const MotionStream::Sample& expected, const MotionStream::Sample& actual) {
+    EXPECT_EQ(expected.timestamp, actual.timestamp);
+    EXPECT_EQ(expected.x, actual.x);
+    EXPECT_EQ(expected.y, actual.y);
+    EXPECT_EQ(expected.z, actual.z);
+  }
+}
+
+TEST(MotionStreamTest, RoundTripWithTheLargestMtu) {
+  MotionStream stream;
+  for (uint32_t i = 0; i < 40; i++) {
+    stream.Push(MakeSample(i));
+  }
+
+  // MTU 247: 29 samples per packet
+  auto packets = Flush(stream, 247 - 3);
+  ASSERT_EQ(2u, packets.size());
+  EXPECT_EQ(29u, packets[0].samples.size());
+  EXPECT_EQ(11u, packets[1].samples.size());
+  uint32_t i = 0;
+  for (size_t p = 0; p < packets.size(); p++) {
+    EXPECT_EQ(static_cast<uint8_t>(MotionStream::formatVersion), packets[p].version);
+    EXPECT_EQ(p, packets[p].sequence);
+    EXPECT_EQ(0, packets[p].droppedSamples);
+    for (const auto& sample : packets[p].samples) {
+      ExpectSample(MakeSample(i++), sample);
+    }
+  }
+  EXPECT_EQ(0u, stream.Size());
+}
+
+TEST(MotionStreamTest, RoundTripWithTheDefaultMtu) {
+  MotionStream stream;
+  for (uint32_t i = 0; i < 5; i++) {
+    stream.Push(MakeSample(i));
+  }
+
+  // MTU 23: a single sample per packet
+  auto packets = Flush(stream, 23 - 3);
+  ASSERT_EQ(5u, packets.size());
+  for (uint32_t i = 0; i < 5; i++) {
+    EXPECT_EQ(i, packets[i].sequence);
+    ASSERT_EQ(1u, packets[i].samples.size());
+    ExpectSample(MakeSample(i), packets[i].samples[0]);
+  }
+}
+
+TEST(MotionStreamTest, NoPacketWhenItCannotHoldASample) {
+  MotionStream stream;
+  stream.Push(MakeSample(0));
+  uint8_t data[MotionStream::maxPacketSize];
+  size_t nbSamples = 1;
+  EXPECT_EQ(0u, stream.Encode(data, MotionStream::headerSize + MotionStream::sampleSize - 1, nbSamples));
+  EXPECT_EQ(0u, nbSamples);
+  EXPECT_EQ(1u, stream.Size());
+}
+
+TEST(MotionStreamTest, PacketSizeOfTheMtu) {
+  // Not connected: ble_att_mtu() returns 0
+  EXPECT_EQ(0u, MotionStream::PacketSize(0));
+  EXPECT_EQ(0u, MotionStream::PacketSize(2));
+  EXPECT_EQ(0u, MotionStream::PacketSize(3));
+  EXPECT_EQ(20u, MotionStream::PacketSize(23));
+  EXPECT_EQ(244u, MotionStream::PacketSize(247));
+  // Larger MTUs are clamped to the packet buffer of MotionService
+  EXPECT_EQ(static_cast<size_t>(MotionStream::maxPacketSize), MotionStream::PacketSize(512));
+
+  MotionStream stream;
+  stream.Push(MakeSample(0));
+  uint8_t data[MotionStream::maxPacketSize];
+  size_t nbSamples = 1;
+  EXPECT_EQ(0u, stream.Encode(data, MotionStream::PacketSize(0), nbSamples));
+  EXPECT_EQ(0u, nbSamples);
+}
+
+TEST(MotionStreamTest, SamplesAreKeptUntilConsumed) {
+  MotionStream stream;
+  stream.Push(MakeSample(0));
+  uint8_t data[MotionStream::maxPacketSize];
+  size_t nbSamples;
+  // The notification failed: the same samples are encoded again, with the same sequence number
+  ASSERT_GT(stream.Encode(data, 244, nbSamples), 0u);
+  auto size = stream.Encode(data, 244, nbSamples);
+  auto packet = Decode(data, size);
+  EXPECT_EQ(0, packet.sequence);
+  ASSERT_EQ(1u, packet.samples.size());
+  ExpectSample(MakeSample(0), packet.samples[0]);
+}
+
+TEST(MotionStreamTest, DropsTheOldestSamples) {
+  MotionStream stream;
+  const uint32_t nbSamples = MotionStream::bufferSize + 10;
+  for (uint32_t i = 0; i < nbSamples; i++) {
+    stream.Push(MakeSample(i));
+  }
+  EXPECT_EQ(static_cast<size_t>(MotionStream::bufferSize), stream.Size());
+  EXPECT_EQ(10, stream.DroppedSamples());
+
+  auto packets = Flush(stream, 244);
+  uint32_t i = 10;
+  for (const auto& packet : packets) {
+    EXPECT_EQ(10, packet.droppedSamples);
+    for (const auto& sample : packet.samples) {
+      ExpectSample(MakeSample(i++), sample);
+    }
+  }
+  EXPECT_EQ(nbSamples, i);
+}
+
+TEST(MotionStreamTest, DecimatesTheFrames) {
+  MotionStream stream;
+  Bma421::AccelValues frames[10];
+  for (int16_t i = 0; i < 10; i++) {
+    frames[i] = {i, 0, 0};
+  }
+  // 100Hz -> 25Hz: one frame out of 4, 40ms apart. The decimation goes on from one call to the next.
+  stream.PushFrames(frames, 10, 500, 25);
+  stream.PushFrames(frames, 10, 600, 25);
+
+  auto packets = Flush(stream, 244);
+  ASSERT_EQ(1u, packets.size());
+  const std::vector<std::pair<uint32_t, int16_t>> expected {{500, 0}, {540, 4}, {580, 8}, {620, 2}, {660, 6}};
+  ASSERT_EQ(expected.size(), packets[0].samples.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(expected[i].first, packets[0].samples[i].timestamp);
+    EXPECT_EQ(expected[i].second, packets[0].samples[i].x);
+  }
+}
+
+TEST(MotionStreamTest, DatesTheFramesOfALargeFifoBacklog) {
+  // After a stall of the system task, the FIFO holds far more frames than a single read: 150 frames at 100Hz
+  constexpr size_t backlog = 150;
+  constexpr uint32_t now = 123456;
+  int16_t nextFrame = 0;
+  size_t nbReads = 0;
+  auto read = [&](Bma421::AccelValues* frames, size_t maxCount) {
+    EXPECT_LE(maxCount, static_cast<size_t>(Bma421::FifoMaxFrames));
+    nbReads++;
+    for (size_t i = 0; i < maxCount; i++) {
+      frames[i] = {nextFrame++, 0, 0};
+    }
+    return maxCount;
+  };
+
+  MotionStream stream;
+  std::vector<MotionStream::Sample> samples;
+  stream.ReadFifo(backlog, now, 100, read, [&]() {
+    uint8_t data[MotionStream::maxPacketSize];
+    size_t nbSamples;
+    size_t size;
+    while ((size = stream.Encode(data, 244, nbSamples)) > 0) {
+      auto packet = Decode(data, size);
+      samples.insert(samples.end(), packet.samples.begin(), packet.samples.end());
+      stream.Consume(nbSamples);
+    }
+  });
+
+  EXPECT_EQ((backlog + Bma421::FifoMaxFrames - 1) / Bma421::FifoMaxFrames, nbReads);
+  ASSERT_EQ(backlog, samples.size());
+  EXPECT_EQ(0, stream.DroppedSamples());
+  for (size_t i = 0; i < backlog; i++) {
+    EXPECT_EQ(static_cast<int16_t>(i), samples[i].x);
+    // The last frame was sampled now, the previous ones 10ms apart
+    EXPECT_EQ(now - (backlog - 1 - i) * 10, samples[i].timestamp);
+  }
+}
+
+TEST(MotionStreamTest, StopsReadingAnEmptyFifo) {
+  MotionStream stream;
+  size_t nbFlushes = 0;
+  stream.ReadFifo(
+    50,
+    1000,
+    100,
+    [](Bma421::AccelValues*, size_t) {
+      return size_t {0};
+    },
+    [&]() {
+      nbFlushes++;
+    });
+  EXPECT_EQ(0u, stream.Size());
+  EXPECT_EQ(0u, nbFlushes);
+}
@@ -0,0 +1,171 @@
+#include "components/ble/MusicService.h"
+#include "AllocationCounter.h"
+#include "BleHost.h"
+#include "Stubs.h"
+#include "systemtask/SystemTask.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using Pinetime::Controllers::MusicService;
+using BleHost::MbufPool;
+
+namespace {
+  // Order of the characteristics in the service
+  enum Characteristic : size_t { Event, Status, Track, Artist, Album, Position, TotalLength };
+
+  std::string BigEndian(uint32_t value) {
+    return {static_cast<char>(value >> 24), static_cast<char>(value >> 16), static_cast<char>(value >> 8), static_cast<char>(value)};
+  }
+
+  // The music service and screen before the inline strings: the strings were std::string members, returned by copy
+  class StringMusicService {
+  public:
+    void OnTrackWritten(const os_mbuf* om) {
+      size_t size = std::min(static_cast<size_t>(OS_MBUF_PKTLEN(om)), static_cast<size_t>(MusicService::MaxStringSize));
+      char data[MusicService::MaxStringSize + 1];
+      os_mbuf_copydata(om, 0, size, data);
+      data[size] = '\0';
+      trackName = data;
+    }
+
+    std::string getTrack() const {
+      return trackName;
+    }
+
+  private:
+    std::string trackName;
+  };
+
+  class MusicServiceTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+      Stubs::SetTickCount(0);
+      musicService.Init();
+      service = BleHost::RegisteredServices().back();
+      valueHandles = BleHost::StartGattServer(service, 0x20);
+    }
+
+    int Write(Characteristic characteristic, const std::string& value) {
+      os_mbuf* om = pool.Make(value);
+      int res = BleHost::Access(service, valueHandles[characteristic], BLE_GATT_ACCESS_OP_WRITE_CHR, om);
+      os_mbuf_free_chain(om);
+      return res;
+    }
+
+    MbufPool& pool = MbufPool::Instance();
+    Pinetime::System::SystemTask systemTask;
+    MusicService musicService {systemTask};
+    const ble_gatt_svc_def* service = nullptr;
+    std::vector<uint16_t> valueHandles;
+  };
+}
+
+TEST_F(MusicServiceTest, WaitsForTheTrackInformation) {
+  EXPECT_STREQ("Waiting for", musicService.getArtist());
+  EXPECT_STREQ("track information..", musicService.getTrack());
+  EXPECT_STREQ("", musicService.getAlbum());
+  EXPECT_NE(0u, musicService.getTrackInfoVersion());
+}
+
+TEST_F(MusicServiceTest, EachStringWriteChangesTheVersion) {
+  auto version = musicService.getTrackInfoVersion();
+  EXPECT_EQ(0, Write(Track, "Song"));
+  EXPECT_EQ(version + 1, musicService.getTrackInfoVersion());
+  EXPECT_EQ(0, Write(Artist, "Band"));
+  EXPECT_EQ(0, Write(Album, "Record"));
+  EXPECT_EQ(version + 3, musicService.getTrackInfoVersion());
+  EXPECT_STREQ("Song", musicService.getTrack());
+  EXPECT_STREQ("Band", musicService.getArtist());
+  EXPECT_STREQ("Record", musicService.getAlbum());
+
+  // Same string again: the phone sent it, the screen sets it again
+  version = musicService.getTrackInfoVersion();
+  Write(Track, "Song");
+  EXPECT_EQ(version + 1, musicService.getTrackInfoVersion());
+
+  // The other characteristics don't change the strings
+  version = musicService.getTrackInfoVersion();
+  Write(Position, BigEndian(10));
+  Write(TotalLength, BigEndian(200));
+  EXPECT_EQ(version, musicService.getTrackInfoVersion());
+}
+
+TEST_F(MusicServiceTest, LongStringsAreTruncatedWithAnEllipsis) {
+  const std::string track = "A track name longer than the forty characters of the screen";
+  Write(Track, track);
+  EXPECT_EQ(track.substr(0, static_cast<size_t>(MusicService::MaxStringSize) - 3) + "...", musicService.getTrack());
+
+  const std::string fits(static_cast<size_t>(MusicService::MaxStringSize), 'a');
+  Write(Artist, fits);
+  EXPECT_EQ(fits, musicService.getArtist());
+
+  Write(Album, "");
+  EXPECT_STREQ("", musicService.getAlbum());
+}
+
+TEST_F(MusicServiceTest, IntegersAreBigEndian) {
+  Write(TotalLength, BigEndian(0x01020304));
+  EXPECT_EQ(0x01020304, musicService.getTrackLength());
+  Write(Position, BigEndian(42));
+  EXPECT_EQ(42, musicService.getProgress());
+  // Shorter values are padded with zeros
+  Write(TotalLength, std::string {1});
+  EXPECT_EQ(0x01000000, musicService.getTrackLength());
+}
+
+TEST_F(MusicServiceTest, NoAllocationPerUpdate) {
+  // The phone sends the track information, then the screen refreshes every 20 ms (Music::Refresh())
+  const std::vector<std::string> tracks = {"Bohemian Rhapsody - Remastered 2011", "Stairway to Heaven", "Hotel California (Live)"};
+  constexpr int nbUpdates = 300;
+  constexpr int nbRefreshesPerUpdate = 50;
+
+  size_t allocations = 0;
+  size_t labelUpdates = 0;
+  {
+    AllocationCounter counter;
+    uint32_t displayedVersion = 0;
+    for (int update = 0; update < nbUpdates; update++) {
+      const std::string& track = tracks[update % tracks.size()];
+      os_mbuf* om = pool.Make(track);
+      BleHost::Access(service, valueHandles[Track], BLE_GATT_ACCESS_OP_WRITE_CHR, om);
+      os_mbuf_free_chain(om);
+      for (int refresh = 0; refresh < nbRefreshesPerUpdate; refresh++) {
+        if (displayedVersion != musicService.getTrackInfoVersion()) {
+          displayedVersion = musicService.getTrackInfoVersion();
+          labelUpdates += std::strlen(musicService.getTrack()) > 0;
+        }
+      }
+    }
+    allocations = counter.Allocations();
+  }
+  EXPECT_EQ(0u, allocations);
+  EXPECT_EQ(static_cast<size_t>(nbUpdates), labelUpdates);
+
+  StringMusicService stringService;
+  size_t stringAllocations = 0;
+  {
+    AllocationCounter counter;
+    std::string displayedTrack;
+    for (int update = 0; update < nbUpdates; update++) {
+      const std::string& track = tracks[update % tracks.size()];
+      os_mbuf* om = pool.Make(track);
+      stringService.OnTrackWritten(om);
+      os_mbuf_free_chain(om);
+      for (int refresh = 0; refresh < nbRefreshesPerUpdate; refresh++) {
+        if (displayedTrack != stringService.getTrack()) {
+          displayedTrack = stringService.getTrack();
+        }
+      }
+    }
+    stringAllocations = counter.Allocations();
+  }
+
+  RecordProperty("allocations_per_update", static_cast<int>(allocations / nbUpdates));
+  RecordProperty("std_string_allocations_per_update", static_cast<int>(stringAllocations / nbUpdates));
+  std::cout << "MusicService: " << allocations / nbUpdates << " allocations per track update and " << nbRefreshesPerUpdate
+            << " refreshes of the screen, " << stringAllocations / nbUpdates << " with std::string" << std::endl;
+}
@@ -0,0 +1,102 @@
+#include "components/ble/NavigationService.h"
+#include "AllocationCounter.h"
+#include "BleHost.h"
+#include "systemtask/SystemTask.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using Pinetime::Controllers::NavigationService;
+using BleHost::MbufPool;
+
+namespace {
+  // Order of the characteristics in the service
+  enum Characteristic : size_t { Flag, Narrative, ManDist, Progress };
+
+  class NavigationServiceTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+      navigationService.Init();
+      service = BleHost::RegisteredServices().back();
+      valueHandles = BleHost::StartGattServer(service, 0x40);
+    }
+
+    int Write(Characteristic characteristic, const std::string& value) {
+      os_mbuf* om = pool.Make(value);
+      int res = BleHost::Access(service, valueHandles[characteristic], BLE_GATT_ACCESS_OP_WRITE_CHR, om);
+      os_mbuf_free_chain(om);
+      return res;
+    }
+
+    MbufPool& pool = MbufPool::Instance();
+    Pinetime::System::SystemTask systemTask;
+    NavigationService navigationService {systemTask};
+    const ble_gatt_svc_def* service = nullptr;
+    std::vector<uint16_t> valueHandles;
+  };
+}
+
+TEST_F(NavigationServiceTest, NothingReceived) {
+  EXPECT_EQ(0u, navigationService.getVersion());
+  EXPECT_STREQ("", navigationService.getFlag());
+  EXPECT_STREQ("", navigationService.getNarrative());
+  EXPECT_STREQ("", navigationService.getManDist());
+}
+
+TEST_F(NavigationServiceTest, EachStringWriteChangesTheVersion) {
+  EXPECT_EQ(0, Write(Flag, "turn-left"));
+  EXPECT_EQ(1u, navigationService.getVersion());
+  EXPECT_EQ(0, Write(Narrative, "Turn left onto Main Street"));
+  EXPECT_EQ(0, Write(ManDist, "150 m"));
+  EXPECT_EQ(3u, navigationService.getVersion());
+  EXPECT_STREQ("turn-left", navigationService.getFlag());
+  EXPECT_STREQ("Turn left onto Main Street", navigationService.getNarrative());
+  EXPECT_STREQ("150 m", navigationService.getManDist());
+
+  // The progress isn't displayed from the strings
+  EXPECT_EQ(0, Write(Progress, std::string {42}));
+  EXPECT_EQ(42, navigationService.getProgress());
+  EXPECT_EQ(3u, navigationService.getVersion());
+}
+
+TEST_F(NavigationServiceTest, LongStringsAreTruncated) {
+  const std::string narrative(120, 'n');
+  Write(Narrative, narrative);
+  EXPECT_EQ(narrative.substr(0, 80), navigationService.getNarrative());
+  Write(Flag, std::string(40, 'f'));
+  EXPECT_EQ(std::string(32, 'f'), navigationService.getFlag());
+  Write(ManDist, std::string(20, 'd'));
+  EXPECT_EQ(std::string(16, 'd'), navigationService.getManDist());
+}
+
+TEST_F(NavigationServiceTest, NoAllocationPerUpdate) {
+  // The phone sends the next instruction, then the screen refreshes every 20 ms (Navigation::Refresh())
+  const std::vector<std::string> narratives = {"Turn left onto Main Street", "Continue on the A1 for 12 kilometers", "Arrive"};
+  constexpr int nbUpdates = 300;
+  constexpr int nbRefreshesPerUpdate = 50;
+
+  size_t allocations = 0;
+  size_t labelUpdates = 0;
+  {
+    AllocationCounter counter;
+    uint32_t displayedVersion = 0;
+    for (int update = 0; update < nbUpdates; update++) {
+      os_mbuf* om = pool.Make(narratives[update % narratives.size()]);
+      BleHost::Access(service, valueHandles[Narrative], BLE_GATT_ACCESS_OP_WRITE_CHR, om);
+      os_mbuf_free_chain(om);
+      for (int refresh = 0; refresh < nbRefreshesPerUpdate; refresh++) {
+        if (displayedVersion != navigationService.getVersion()) {
+          displayedVersion = navigationService.getVersion();
+          labelUpdates += std::strlen(navigationService.getNarrative()) > 0;
+        }
+      }
+    }
+    allocations = counter.Allocations();
+  }
+  EXPECT_EQ(0u, allocations);
+  EXPECT_EQ(static_cast<size_t>(nbUpdates), labelUpdates);
+  std::cout << "NavigationService: " << allocations / nbUpdates << " allocations per instruction and " << nbRefreshesPerUpdate
+            << " refreshes of the screen" << std::endl;
+}
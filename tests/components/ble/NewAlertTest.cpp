@@ -0,0 +1,258 @@
+#include "components/ble/NewAlert.h"
+#include "BleHost.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using Pinetime::Controllers::NewAlert;
+using Pinetime::Controllers::NotificationManager;
+using BleHost::MbufPool;
+
+namespace {
+  constexpr uint16_t NbMbufs = MbufPool::NbMbufs;
+
+  // ATT MTU of a connection that didn't exchange it: a Prepare Write request carries MTU - 5 bytes of the value
+  constexpr uint16_t DefaultMtu = 23;
+  constexpr size_t FragmentSize = DefaultMtu - 5;
+  // MYNEWT_VAL_BLE_ATT_SVR_MAX_PREP_ENTRIES of the firmware (src/CMakeLists.txt)
+  constexpr size_t MaxPrepEntries = 16;
+
+  // The prepare queue of the ATT server of NimBLE (ble_att_svr.c): the fragments of the Prepare Write requests of a
+  // connection are sorted by handle and offset, then the Execute Write request checks that the fragments of each
+  // handle are contiguous from offset 0 and concatenates their mbufs
+  class PrepareQueue {
+  public:
+    explicit PrepareQueue(MbufPool& pool) : pool {pool} {
+    }
+
+    ~PrepareQueue() {
+      for (auto& connection : connections) {
+        Clear(connection.second);
+      }
+    }
+
+    bool Prepare(uint16_t connectionHandle, uint16_t handle, uint16_t offset, const std::string& value) {
+      auto& entries = connections[connectionHandle];
+      if (entries.size() == MaxPrepEntries) {
+        return false;
+      }
+      Entry entry {handle, offset, pool.Make(value)};
+      auto it = std::upper_bound(entries.begin(), entries.end(), entry, [](const Entry& a, const Entry& b) {
+        return a.handle < b.handle || (a.handle == b.handle && a.offset < b.offset);
+      });
+      entries.insert(it, entry);
+      return true;
+    }
+
+    // Hands the reassembled value of each handle to write, in the order of the handles
+    template <typename Write> bool Execute(uint16_t connectionHandle, Write write) {
+      auto& entries = connections[connectionHandle];
+      for (size_t i = 0; i < entries.size(); i++) {
+        const bool first = i == 0 || entries[i - 1].handle != entries[i].handle;
+        const uint16_t expectedOffset = first ? 0 : entries[i - 1].offset + OS_MBUF_PKTLEN(entries[i - 1].om);
+        if (entries[i].offset != expectedOffset) {
+          Clear(entries);
+          return false;
+        }
+      }
+      for (size_t i = 0; i < entries.size();) {
+        os_mbuf* om = entries[i].om;
+        const uint16_t handle = entries[i].handle;
+        for (i++; i < entries.size() && entries[i].handle == handle; i++) {
+          os_mbuf_concat(om, entries[i].om);
+        }
+        write(handle, om);
+        os_mbuf_free_chain(om);
+      }
+      entries.clear();
+      return true;
+    }
+
+  private:
+    struct Entry {
+      uint16_t handle;
+      uint16_t offset;
+      os_mbuf* om;
+    };
+
+    static void Clear(std::vector<Entry>& entries) {
+      for (auto& entry : entries) {
+        os_mbuf_free_chain(entry.om);
+      }
+      entries.clear();
+    }
+
+    MbufPool& pool;
+    std::map<uint16_t, std::vector<Entry>> connections;
+  };
+
+  constexpr uint8_t CategoryCall = 0x03;
+  constexpr uint8_t CategorySimpleAlert = 0x00;
+
+  // New Alert value: category, number of new alerts, '\0', then the message (title '\0' body '\0')
+  std::string MakeValue(uint8_t category, const std::string& title, const std::string& body) {
+    return std::string {static_cast<char>(category), 1, '\0'} + title + std::string(1, '\0') + body + std::string(1, '\0');
+  }
+
+  struct Fragment {
+    uint16_t connectionHandle;
+    uint16_t handle;
+    uint16_t offset;
+    std::string value;
+  };
+
+  std::vector<Fragment> Split(uint16_t connectionHandle, uint16_t handle, const std::string& value, size_t firstSize = FragmentSize) {
+    std::vector<Fragment> fragments;
+    size_t offset = 0;
+    size_t size = firstSize;
+    while (offset < value.size()) {
+      fragments.push_back({connectionHandle, handle, static_cast<uint16_t>(offset), value.substr(offset, size)});
+      offset += size;
+      size = FragmentSize;
+    }
+    return fragments;
+  }
+
+  // What AlertNotificationService::OnAlert() does with the value written to the New Alert characteristic
+  bool OnAlert(NotificationManager& manager, const os_mbuf* om) {
+    auto category = NotificationManager::Categories::SimpleAlert;
+    if (NewAlert::Category(om) == CategoryCall) {
+      category = NotificationManager::Categories::IncomingCall;
+    }
+    return NewAlert::Push(manager, om, category);
+  }
+
+  class NewAlertTest : public ::testing::Test {
+  protected:
+    bool Write(const std::vector<Fragment>& fragments) {
+      for (const auto& fragment : fragments) {
+        if (!queue.Prepare(fragment.connectionHandle, fragment.handle, fragment.offset, fragment.value)) {
+          return false;
+        }
+      }
+      return Execute(fragments.front().connectionHandle);
+    }
+
+    bool Execute(uint16_t connectionHandle) {
+      return queue.Execute(connectionHandle, [this](uint16_t, os_mbuf* om) {
+        OnAlert(manager, om);
+      });
+    }
+
+    MbufPool& pool = MbufPool::Instance();
+    PrepareQueue queue {pool};
+    NotificationManager manager;
+    NotificationManager::Notification notification;
+  };
+}
+
+TEST_F(NewAlertTest, SingleMbuf) {
+  os_mbuf* om = pool.Make(MakeValue(CategoryCall, "Alice", "calling"));
+  EXPECT_TRUE(OnAlert(manager, om));
+  os_mbuf_free_chain(om);
+
+  ASSERT_TRUE(manager.GetLastNotification(notification));
+  EXPECT_EQ(NotificationManager::Categories::IncomingCall, notification.category);
+  EXPECT_STREQ("Alice", notification.Title());
+  EXPECT_STREQ("calling", notification.Message());
+}
+
+TEST_F(NewAlertTest, FragmentedPreparedWrites) {
+  const std::string body = "A message longer than the MTU, sent with Prepare Write requests and reassembled by the BLE host";
+  const auto fragments = Split(1, 42, MakeValue(CategorySimpleAlert, "Bob", body));
+  ASSERT_GT(fragments.size(), 5u);
+  ASSERT_TRUE(Write(fragments));
+
+  ASSERT_TRUE(manager.GetLastNotification(notification));
+  EXPECT_EQ(NotificationManager::Categories::SimpleAlert, notification.category);
+  EXPECT_STREQ("Bob", notification.Title());
+  EXPECT_EQ(body, notification.Message());
+  EXPECT_EQ(NbMbufs, pool.NbFree());
+}
+
+TEST_F(NewAlertTest, HeaderSplitAcrossFragments) {
+  // The category alone in the first fragment, the number of new alerts and the title in the next one
+  const auto fragments = Split(1, 42, MakeValue(CategoryCall, "Carol", "calling"), 1);
+  ASSERT_TRUE(Write(fragments));
+
+  ASSERT_TRUE(manager.GetLastNotification(notification));
+  EXPECT_EQ(NotificationManager::Categories::IncomingCall, notification.category);
+  EXPECT_STREQ("Carol", notification.Title());
+  EXPECT_STREQ("calling", notification.Message());
+}
+
+TEST_F(NewAlertTest, InterleavedPreparedWrites) {
+  // Two phones write a New Alert at the same time; the fragments of each one arrive out of order
+  const std::string body1(150, 'a');
+  const std::string body2(120, 'b');
+  auto fragments1 = Split(1, 42, MakeValue(CategorySimpleAlert, "First", body1));
+  auto fragments2 = Split(2, 42, MakeValue(CategoryCall, "Second", body2));
+  std::mt19937 random {29};
+  std::shuffle(fragments1.begin(), fragments1.end(), random);
+  std::shuffle(fragments2.begin(), fragments2.end(), random);
+  std::vector<Fragment> fragments;
+  for (size_t i = 0; i < std::max(fragments1.size(), fragments2.size()); i++) {
+    if (i < fragments1.size()) {
+      fragments.push_back(fragments1[i]);
+    }
+    if (i < fragments2.size()) {
+      fragments.push_back(fragments2[i]);
+    }
+  }
+  for (const auto& fragment : fragments) {
+    ASSERT_TRUE(queue.Prepare(fragment.connectionHandle, fragment.handle, fragment.offset, fragment.value));
+  }
+  ASSERT_TRUE(Execute(2));
+  ASSERT_TRUE(Execute(1));
+
+  ASSERT_EQ(2u, manager.NbNotifications());
+  ASSERT_TRUE(manager.GetLastNotification(notification));
+  EXPECT_STREQ("First", notification.Title());
+  EXPECT_EQ(body1, notification.Message());
+  ASSERT_TRUE(manager.GetPrevious(notification.id, notification));
+  EXPECT_EQ(NotificationManager::Categories::IncomingCall, notification.category);
+  EXPECT_STREQ("Second", notification.Title());
+  EXPECT_EQ(body2, notification.Message());
+  EXPECT_EQ(NbMbufs, pool.NbFree());
+}
+
+TEST_F(NewAlertTest, MissingFragmentDiscardsTheWrite) {
+  auto fragments = Split(1, 42, MakeValue(CategorySimpleAlert, "Dave", std::string(80, 'd')));
+  fragments.erase(fragments.begin() + 2);
+  EXPECT_FALSE(Write(fragments));
+  EXPECT_TRUE(manager.IsEmpty());
+  EXPECT_EQ(NbMbufs, pool.NbFree());
+}
+
+TEST_F(NewAlertTest, EmptyMessageIsIgnored) {
+  os_mbuf* om = pool.Make(std::string {static_cast<char>(CategorySimpleAlert), 1, '\0'});
+  EXPECT_FALSE(OnAlert(manager, om));
+  os_mbuf_free_chain(om);
+  EXPECT_TRUE(manager.IsEmpty());
+}
+
+TEST_F(NewAlertTest, LongestMessageAtTheDefaultMtu) {
+  // The longest message that the store keeps fits in the prepare queue, whatever the MTU
+  const std::string title = "Title";
+  const std::string body(NotificationManager::MaximumMessageSize() - title.size() - 2, 'e');
+  const auto fragments = Split(1, 42, MakeValue(CategorySimpleAlert, title, body));
+  ASSERT_LE(fragments.size(), MaxPrepEntries);
+  ASSERT_TRUE(Write(fragments));
+
+  ASSERT_TRUE(manager.GetLastNotification(notification));
+  EXPECT_EQ(body, notification.Message());
+}
+
+TEST_F(NewAlertTest, TruncatesLongerMessages) {
+  const std::string body(400, 'f');
+  os_mbuf* om = pool.Make(MakeValue(CategorySimpleAlert, "Title", body));
+  EXPECT_TRUE(OnAlert(manager, om));
+  os_mbuf_free_chain(om);
+
+  ASSERT_TRUE(manager.GetLastNotification(notification));
+  EXPECT_EQ(NotificationManager::MaximumMessageSize() + 1, notification.size);
+  EXPECT_EQ(body.substr(0, NotificationManager::MaximumMessageSize() - 6), notification.Message());
+}
@@ -0,0 +1,223 @@
+#include "components/ble/NotificationManager.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+
+using Pinetime::Controllers::NotificationManager;
+using Categories = NotificationManager::Categories;
+
+namespace {
+  // Message of a notification as sent by the companion apps: title '\0' body '\0'
+  std::string MakeMessage(const std::string& title, const std::string& body) {
+    return title + std::string(1, '\0') + body + std::string(1, '\0');
+  }
+
+  void Push(NotificationManager& manager, const std::string& message, Categories category = Categories::SimpleAlert) {
+    manager.Push(category, message.data(), message.size());
+  }
+
+  std::string Body(const NotificationManager::Notification& notification) {
+    return notification.Message();
+  }
+
+  // The store that the arena replaced: 5 slots of 101 characters, the newest evicting the oldest
+  constexpr size_t BaselineSize = 540;
+  constexpr size_t BaselineNbNotifications = 5;
+  constexpr size_t BaselineMessageSize = 100;
+
+  // Lengths of the titles and bodies of a kind of notification
+  struct Profile {
+    const char* name;
+    std::lognormal_distribution<double> title;
+    std::lognormal_distribution<double> body;
+  };
+}
+
+TEST(NotificationManagerTest, NewestNotificationFirst) {
+  NotificationManager manager;
+  NotificationManager::Notification notification;
+  EXPECT_TRUE(manager.IsEmpty());
+  EXPECT_FALSE(manager.GetLastNotification(notification));
+  EXPECT_FALSE(notification.valid);
+
+  Push(manager, MakeMessage("Alice", "first"));
+  Push(manager, MakeMessage("Bob", "second"));
+  Push(manager, MakeMessage("Carol", "third"), Categories::IncomingCall);
+  EXPECT_EQ(3u, manager.NbNotifications());
+  EXPECT_TRUE(manager.AreNewNotificationsAvailable());
+
+  ASSERT_TRUE(manager.GetLastNotification(notification));
+  EXPECT_STREQ("Carol", notification.Title());
+  EXPECT_EQ("third", Body(notification));
+  EXPECT_EQ(Categories::IncomingCall, notification.category);
+  EXPECT_EQ(0, manager.IndexOf(notification.id));
+  const auto newest = notification.id;
+
+  // The previous notification is older, the next one is newer
+  ASSERT_TRUE(manager.GetPrevious(newest, notification));
+  EXPECT_EQ("second", Body(notification));
+  EXPECT_EQ(1, manager.IndexOf(notification.id));
+  const auto middle = notification.id;
+  ASSERT_TRUE(manager.GetPrevious(middle, notification));
+  EXPECT_EQ("first", Body(notification));
+  EXPECT_FALSE(manager.GetPrevious(notification.id, notification));
+  EXPECT_FALSE(notification.valid);
+
+  ASSERT_TRUE(manager.GetNext(middle, notification));
+  EXPECT_EQ(newest, notification.id);
+  EXPECT_FALSE(manager.GetNext(newest, notification));
+
+  ASSERT_TRUE(manager.Get(middle, notification));
+  EXPECT_EQ("second", Body(notification));
+  EXPECT_FALSE(manager.Get(42, notification));
+  EXPECT_EQ(3, manager.IndexOf(42));
+}
+
+TEST(NotificationManagerTest, MessageWithoutTitle) {
+  NotificationManager manager;
+  const char message[] = "Alert";
+  manager.Push(Categories::SimpleAlert, message, sizeof(message));
+  NotificationManager::Notification notification;
+  ASSERT_TRUE(manager.GetLastNotification(notification));
+  EXPECT_EQ(nullptr, notification.Title());
+  EXPECT_STREQ("Alert", notification.Message());
+}
+
+TEST(NotificationManagerTest, DismissKeepsTheOtherNotifications) {
+  NotificationManager manager;
+  for (int i = 0; i < 5; i++) {
+    Push(manager, MakeMessage("Title", "message " + std::to_string(i)));
+  }
+  NotificationManager::Notification notification;
+  manager.GetLastNotification(notification);
+  manager.GetPrevious(notification.id, notification);
+  manager.GetPrevious(notification.id, notification);
+  const auto dismissed = notification.id;
+  manager.Dismiss(dismissed);
+  manager.Dismiss(dismissed);
+  EXPECT_EQ(4u, manager.NbNotifications());
+  EXPECT_FALSE(manager.Get(dismissed, notification));
+
+  // The hole left in the arena is compacted by the next push
+  Push(manager, MakeMessage("Title", "message 5"));
+  const char* expected[] = {"message 5", "message 4", "message 3", "message 1", "message 0"};
+  ASSERT_TRUE(manager.GetLastNotification(notification));
+  for (const char* body : expected) {
+    EXPECT_EQ(body, Body(notification));
+    manager.GetPrevious(notification.id, notification);
+  }
+  EXPECT_FALSE(notification.valid);
+}
+
+TEST(NotificationManagerTest, EvictsTheOldestNotificationsUntilTheMessageFits) {
+  NotificationManager manager;
+  const std::string body(NotificationManager::MaximumMessageSize() - 10, 'x');
+  Push(manager, MakeMessage("1", body));
+  Push(manager, MakeMessage("2", "short"));
+  EXPECT_EQ(2u, manager.NbNotifications());
+
+  // Doesn't fit next to the long message
+  Push(manager, MakeMessage("3", body));
+  EXPECT_EQ(2u, manager.NbNotifications());
+  NotificationManager::Notification notification;
+  manager.GetLastNotification(notification);
+  EXPECT_STREQ("3", notification.Title());
+  EXPECT_EQ(body, Body(notification));
+  manager.GetPrevious(notification.id, notification);
+  EXPECT_EQ("short", Body(notification));
+}
+
+TEST(NotificationManagerTest, KeepsAtMostTotalNbNotifications) {
+  NotificationManager manager;
+  for (int i = 0; i < 20; i++) {
+    Push(manager, MakeMessage("", std::to_string(i)));
+  }
+  EXPECT_EQ(static_cast<size_t>(NotificationManager::TotalNbNotifications), manager.NbNotifications());
+  NotificationManager::Notification notification;
+  manager.GetLastNotification(notification);
+  EXPECT_EQ("19", Body(notification));
+}
+
+TEST(NotificationManagerTest, TruncatesLongMessages) {
+  NotificationManager manager;
+  const std::string body(400, 'y');
+  Push(manager, MakeMessage("Title", body));
+  NotificationManager::Notification notification;
+  ASSERT_TRUE(manager.GetLastNotification(notification));
+  EXPECT_EQ(NotificationManager::MaximumMessageSize() + 1, notification.size);
+  EXPECT_EQ(body.substr(0, NotificationManager::MaximumMessageSize() - 6), Body(notification));
+}
+
+TEST(NotificationManagerTest, DismissWhileAPushIsWritten) {
+  // The BLE host task writes the message into the arena between BeginPush() and CommitPush(), while the display task
+  // dismisses a notification: the reserved room doesn't move
+  NotificationManager manager;
+  Push(manager, MakeMessage("1", "first"));
+  Push(manager, MakeMessage("2", "second"));
+  const std::string message = MakeMessage("3", "third");
+  size_t size = message.size();
+  char* buffer = manager.BeginPush(size);
+  ASSERT_EQ(message.size(), size);
+  std::memcpy(buffer, message.data(), 4);
+
+  NotificationManager::Notification notification;
+  manager.GetLastNotification(notification);
+  manager.Dismiss(notification.id);
+  manager.GetLastNotification(notification);
+  manager.Dismiss(notification.id);
+  EXPECT_TRUE(manager.IsEmpty());
+
+  std::memcpy(buffer + 4, message.data() + 4, size - 4);
+  manager.CommitPush(Categories::SimpleAlert);
+  ASSERT_TRUE(manager.GetLastNotification(notification));
+  EXPECT_STREQ("3", notification.Title());
+  EXPECT_EQ("third", Body(notification));
+}
+
+TEST(NotificationManagerTest, RamPerNotification) {
+  // Notifications pushed by a phone: lengths of the titles and the bodies (log-normal, in characters)
+  Profile profiles[] = {
+    {"chat", std::lognormal_distribution<double> {2.2, 0.4}, std::lognormal_distribution<double> {3.3, 0.7}},
+    {"mixed", std::lognormal_distribution<double> {2.5, 0.5}, std::lognormal_distribution<double> {3.8, 0.9}},
+    {"email", std::lognormal_distribution<double> {3.0, 0.4}, std::lognormal_distribution<double> {4.8, 0.5}},
+  };
+  constexpr int nbPushes = 2000;
+  ASSERT_LE(sizeof(NotificationManager), BaselineSize);
+
+  for (auto& profile : profiles) {
+    std::mt19937 random {42};
+    NotificationManager manager;
+    double held = 0;
+    double baselineHeld = 0;
+    int truncated = 0;
+    int baselineTruncated = 0;
+    for (int i = 0; i < nbPushes; i++) {
+      const auto titleLength = std::min<size_t>(static_cast<size_t>(profile.title(random)) + 1, 40);
+      const auto bodyLength = static_cast<size_t>(profile.body(random)) + 1;
+      const std::string message = MakeMessage(std::string(titleLength, 't'), std::string(bodyLength, 'b'));
+      Push(manager, message);
+      held += manager.NbNotifications();
+      baselineHeld += std::min<size_t>(i + 1, BaselineNbNotifications);
+      truncated += message.size() > NotificationManager::MaximumMessageSize() + 1;
+      baselineTruncated += message.size() > BaselineMessageSize + 1;
+    }
+    held /= nbPushes;
+    baselineHeld /= nbPushes;
+    // More notifications in the same RAM, unless most messages are longer than the 100 characters of the slots: they
+    // were truncated, they are now kept whole
+    if (std::string(profile.name) == "chat") {
+      EXPECT_GT(held, 1.5 * baselineHeld);
+    } else if (std::string(profile.name) == "mixed") {
+      EXPECT_GE(held, baselineHeld);
+    }
+    EXPECT_LT(truncated, baselineTruncated);
+
+    RecordProperty(std::string(profile.name) + "_notifications", static_cast<int>(held * 10));
+    std::cout << "NotificationManager (" << profile.name << "): " << held << " notifications held, "
+              << sizeof(NotificationManager) / held << " bytes per notification, " << truncated
+              << " truncated; fixed slots: " << baselineHeld << " held, " << BaselineSize / baselineHeld << " bytes per notification, "
+              << baselineTruncated << " truncated (of " << nbPushes << ")" << std::endl;
+  }
+}
@@ -0,0 +1,129 @@
+#include "components/ble/RawPpgPacket.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+using Pinetime::Controllers::RawPpgPacket;
+
+namespace {
+  struct Sample {
+    uint32_t timestamp;
+    uint32_t hrs;
+    uint32_t als;
+    float agcPeak;
+  };
+
+  // Decoder of the raw PPG notifications, as described in doc/ble.md (and decoded by tools/ppg/ppg_record.py)
+  struct Packet {
+    uint8_t version;
+    uint16_t sequence;
+    uint16_t droppedSamples;
+    std::vector<Sample> samples;
+  };
+
+  uint32_t Read(const uint8_t* data, size_t size) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < size; i++) {
+      value |= static_cast<uint32_t>(data[i]) << (8 * i);
+    }
+    return value;
+  }
+
+  Packet Decode(const std::vector<uint8_t>& data) {
+    Packet packet {data[0], static_cast<uint16_t>(Read(&data[2], 2)), static_cast<uint16_t>(Read(&data[4], 2)), {}};
+    const uint32_t timestamp = Read(&data[6], 4);
+    EXPECT_EQ(data.size(), RawPpgPacket::headerSize + data[1] * RawPpgPacket::sampleSize);
+    for (size_t offset = RawPpgPacket::headerSize; offset < data.size(); offset += RawPpgPacket::sampleSize) {
+      const uint32_t agcPeakBits = Read(&data[offset + 8], 4);
+      float agcPeak;
+      std::memcpy(&agcPeak, &agcPeakBits, sizeof(agcPeak));
+      packet.samples.push_back({timestamp + Read(&data[offset], 2), Read(&data[offset + 2], 3), Read(&data[offset + 5], 3), agcPeak});
+    }
+    return packet;
+  }
+
+  // Packs the samples like HeartRateService::FlushRawSamples(): as many samples per notification as the MTU allows
+  std::vector<std::vector<uint8_t>> Encode(const std::vector<Sample>& samples, uint16_t mtu, uint16_t droppedSamples) {
+    std::vector<std::vector<uint8_t>> packets;
+    const size_t samplesPerPacket = RawPpgPacket::SamplesPerPacket(mtu);
+    uint16_t sequence = 0;
+    for (size_t first = 0; samplesPerPacket > 0 && first < samples.size(); first += samplesPerPacket) {
+      const size_t count = std::min(samples.size() - first, samplesPerPacket);
+      std::vector<uint8_t> packet(RawPpgPacket::headerSize + count * RawPpgPacket::sampleSize);
+      RawPpgPacket::EncodeHeader(packet.data(), static_cast<uint8_t>(count), sequence++, droppedSamples, samples[first].timestamp);
+      for (size_t i = 0; i < count; i++) {
+        const Sample& sample = samples[first + i];
+        RawPpgPacket::EncodeSample(&packet[RawPpgPacket::headerSize + i * RawPpgPacket::sampleSize],
+                                   samples[first].timestamp,
+                                   sample.timestamp,
+                                   sample.hrs,
+                                   sample.als,
+                                   sample.agcPeak);
+      }
+      packets.push_back(packet);
+    }
+    return packets;
+  }
+
+  // The samples of the heart rate task: 25Hz, 40ms apart
+  std::vector<Sample> MakeSamples(size_t count) {
+    std::vector<Sample> samples;
+    for (uint32_t i = 0; i < count; i++) {
+      samples.push_back({0xfffff000 + i * 40, 0x10000 + i * 3, 0x800 + i, 1000.5f + static_cast<float>(i)});
+    }
+    return samples;
+  }
+}
+
+TEST(RawPpgPacketTest, SamplesPerPacketOfTheMtu) {
+  // Not connected: ble_att_mtu() returns 0
+  EXPECT_EQ(0u, RawPpgPacket::SamplesPerPacket(0));
+  EXPECT_EQ(0u, RawPpgPacket::SamplesPerPacket(3));
+  // The default MTU can't hold a sample
+  EXPECT_EQ(0u, RawPpgPacket::SamplesPerPacket(23));
+  EXPECT_EQ(1u, RawPpgPacket::SamplesPerPacket(3 + RawPpgPacket::headerSize + RawPpgPacket::sampleSize));
+  EXPECT_EQ(19u, RawPpgPacket::SamplesPerPacket(247));
+  // Larger MTUs are clamped to the largest packet
+  EXPECT_EQ(19u, RawPpgPacket::SamplesPerPacket(512));
+}
+
+TEST(RawPpgPacketTest, RoundTrip) {
+  const auto samples = MakeSamples(50);
+  const auto packets = Encode(samples, 247, 7);
+  ASSERT_EQ(3u, packets.size());
+  EXPECT_EQ(RawPpgPacket::headerSize + 19 * RawPpgPacket::sampleSize, packets[0].size());
+  EXPECT_LE(packets[0].size(), static_cast<size_t>(RawPpgPacket::maxPacketSize));
+
+  size_t i = 0;
+  for (size_t p = 0; p < packets.size(); p++) {
+    const Packet packet = Decode(packets[p]);
+    EXPECT_EQ(static_cast<uint8_t>(RawPpgPacket::formatVersion), packet.version);
+    EXPECT_EQ(p, packet.sequence);
+    EXPECT_EQ(7, packet.droppedSamples);
+    for (const auto& sample : packet.samples) {
+      // The timestamps wrap around in the middle of the stream
+      EXPECT_EQ(samples[i].timestamp, sample.timestamp);
+      EXPECT_EQ(samples[i].hrs, sample.hrs);
+      EXPECT_EQ(samples[i].als, sample.als);
+      EXPECT_EQ(samples[i].agcPeak, sample.agcPeak);
+      i++;
+    }
+  }
+  EXPECT_EQ(samples.size(), i);
+}
+
+TEST(RawPpgPacketTest, SensorValuesAreSentOn24Bits) {
+  uint8_t data[RawPpgPacket::sampleSize];
+  RawPpgPacket::EncodeSample(data, 1000, 1040, 0x12345678, 0xffffff, -1.0f);
+  EXPECT_EQ(40u, Read(data, 2));
+  EXPECT_EQ(0x345678u, Read(data + 2, 3));
+  EXPECT_EQ(0xffffffu, Read(data + 5, 3));
+  EXPECT_EQ(0xbf800000u, Read(data + 8, 4));
+}
+
+TEST(RawPpgPacketTest, HeaderLayout) {
+  uint8_t header[RawPpgPacket::headerSize];
+  RawPpgPacket::EncodeHeader(header, 19, 0xabcd, 0x1234, 0x89abcdef);
+  const uint8_t expected[] = {1, 19, 0xcd, 0xab, 0x34, 0x12, 0xef, 0xcd, 0xab, 0x89};
+  EXPECT_EQ(0, std::memcmp(expected, header, sizeof(expected)));
+}
@@ -0,0 +1,422 @@
+#include "components/ble/ServiceDiscovery.h"
+#include "BleHost.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <vector>
+
+using Pinetime::Controllers::BleClient;
+using Pinetime::Controllers::ServiceDiscovery;
+using BleHost::MbufPool;
+
+namespace {
+  constexpr uint16_t ConnectionHandle = 1;
+
+  constexpr uint16_t PrimaryServiceId = 0x2800;
+  constexpr uint16_t CharacteristicId = 0x2803;
+  constexpr uint16_t CccdId = 0x2902;
+  constexpr uint16_t GattServiceId = 0x1801;
+  constexpr uint16_t ServiceChangedId = 0x2a05;
+  constexpr uint16_t DatabaseHashId = 0x2b2a;
+
+  ble_uuid_any_t Uuid16(uint16_t value) {
+    ble_uuid_any_t uuid {};
+    uuid.u16.u.type = BLE_UUID_TYPE_16;
+    uuid.u16.value = value;
+    return uuid;
+  }
+
+  uint16_t Uuid16Value(const ble_uuid_t* uuid) {
+    return reinterpret_cast<const ble_uuid16_t*>(uuid)->value;
+  }
+
+  /**
+   * The GATT server of the phone: a list of attributes, on which the GATT procedures that the clients use are run
+   * synchronously
+   */
+  class Peer {
+  public:
+    using DatabaseHash = std::array<uint8_t, 16>;
+
+    uint16_t AddService(uint16_t uuid) {
+      return Add({0, PrimaryServiceId, uuid, 0, 0});
+    }
+
+    /// Returns the value handle
+    uint16_t AddCharacteristic(uint16_t uuid, bool cccd, uint8_t properties = 0) {
+      Add({0, CharacteristicId, 0, uuid, properties});
+      uint16_t valueHandle = Add({0, uuid, 0, 0, 0});
+      if (cccd) {
+        Add({0, CccdId, 0, 0, 0});
+      }
+      return valueHandle;
+    }
+
+    /// The GATT service, with the Service Changed characteristic and its CCCD, and the database hash
+    void AddGattService(bool serviceChanged = true, bool serviceChangedCccd = true) {
+      AddService(GattServiceId);
+      if (serviceChanged) {
+        serviceChangedHandle = AddCharacteristic(ServiceChangedId, serviceChangedCccd, BLE_GATT_CHR_PROP_INDICATE);
+      }
+      AddCharacteristic(DatabaseHashId, false, BLE_GATT_CHR_PROP_READ);
+    }
+
+    uint16_t AddOtherService(uint16_t uuid) {
+      AddService(uuid);
+      return AddCharacteristic(0x2a00 | (uuid & 0xff), true, BLE_GATT_CHR_PROP_INDICATE);
+    }
+
+    uint16_t ServiceChangedHandle() const {
+      return serviceChangedHandle;
+    }
+
+    /// Value written to the CCCD of the characteristic, 0xffff if none
+    uint16_t Cccd(uint16_t valueHandle) const {
+      auto it = writes.find(valueHandle + 1);
+      return (it == writes.end()) ? 0xffff : it->second;
+    }
+
+    int ConnFind(ble_gap_conn_desc* desc) const {
+      std::memset(desc, 0, sizeof(*desc));
+      desc->conn_handle = ConnectionHandle;
+      desc->sec_state.bonded = bonded;
+      desc->peer_id_addr = address;
+      return 0;
+    }
+
+    int DiscoverServiceByUuid(const ble_uuid_t* uuid, ble_gatt_disc_svc_fn* cb, void* arg) const {
+      for (size_t i = 0; i < attributes.size(); i++) {
+        if (attributes[i].type == PrimaryServiceId && attributes[i].serviceUuid == Uuid16Value(uuid)) {
+          ble_gatt_svc service {};
+          service.start_handle = attributes[i].handle;
+          service.end_handle = EndOfService(i);
+          service.uuid = Uuid16(attributes[i].serviceUuid);
+          cb(ConnectionHandle, &Status(0), &service, arg);
+        }
+      }
+      cb(ConnectionHandle, &Status(BLE_HS_EDONE), nullptr, arg);
+      return 0;
+    }
+
+    int DiscoverCharacteristicsByUuid(uint16_t start, uint16_t end, const ble_uuid_t* uuid, ble_gatt_chr_fn* cb, void* arg) const {
+      for (const auto& attribute : attributes) {
+        if (attribute.handle >= start && attribute.handle <= end && attribute.type == CharacteristicId &&
+            attribute.characteristicUuid == Uuid16Value(uuid)) {
+          ble_gatt_chr characteristic {};
+          characteristic.def_handle = attribute.handle;
+          characteristic.val_handle = attribute.handle + 1;
+          characteristic.properties = attribute.properties;
+          characteristic.uuid = Uuid16(attribute.characteristicUuid);
+          cb(ConnectionHandle, &Status(0), &characteristic, arg);
+        }
+      }
+      cb(ConnectionHandle, &Status(BLE_HS_EDONE), nullptr, arg);
+      return 0;
+    }
+
+    // Find Information from the value handle to the end handle: the descriptors, then the attributes of the next
+    // characteristics
+    int DiscoverDescriptors(uint16_t valueHandle, uint16_t end, ble_gatt_dsc_fn* cb, void* arg) const {
+      for (const auto& attribute : attributes) {
+        if (attribute.handle > valueHandle && attribute.handle <= end) {
+          ble_gatt_dsc descriptor {};
+          descriptor.handle = attribute.handle;
+          descriptor.uuid = Uuid16(attribute.type);
+          cb(ConnectionHandle, &Status(0), valueHandle, &descriptor, arg);
+        }
+      }
+      cb(ConnectionHandle, &Status(BLE_HS_EDONE), valueHandle, nullptr, arg);
+      return 0;
+    }
+
+    int ReadByUuid(const ble_uuid_t* uuid, ble_gatt_attr_fn* cb, void* arg) {
+      bool found = false;
+      for (const auto& attribute : attributes) {
+        if (attribute.type == Uuid16Value(uuid) && attribute.type == DatabaseHashId) {
+          ble_gatt_attr attr {};
+          attr.handle = attribute.handle;
+          attr.om = MbufPool::Instance().Make(std::string(databaseHash.begin(), databaseHash.end()));
+          cb(ConnectionHandle, &Status(0), &attr, arg);
+          os_mbuf_free_chain(attr.om);
+          found = true;
+        }
+      }
+      // Attribute Not Found when the peer has no database hash
+      cb(ConnectionHandle, &Status(found ? BLE_HS_EDONE : BLE_HS_ERR_ATT_BASE + BLE_ATT_ERR_ATTR_NOT_FOUND), nullptr, arg);
+      return 0;
+    }
+
+    int Write(uint16_t handle, const void* data, uint16_t size, ble_gatt_attr_fn* cb, void* arg) {
+      uint16_t value = 0;
+      std::memcpy(&value, data, std::min<size_t>(size, sizeof(value)));
+      writes[handle] = value;
+      ble_gatt_attr attr {};
+      attr.handle = handle;
+      cb(ConnectionHandle, &Status(0), &attr, arg);
+      return 0;
+    }
+
+    bool bonded = true;
+    ble_addr_t address {BLE_ADDR_PUBLIC, {1, 2, 3, 4, 5, 6}};
+    DatabaseHash databaseHash {{0x42}};
+    std::map<uint16_t, uint16_t> writes;
+
+  private:
+    struct Attribute {
+      uint16_t handle;
+      uint16_t type;
+      uint16_t serviceUuid;
+      uint16_t characteristicUuid;
+      uint8_t properties;
+    };
+
+    uint16_t Add(Attribute attribute) {
+      attribute.handle = static_cast<uint16_t>(attributes.size() + 1);
+      attributes.push_back(attribute);
+      return attribute.handle;
+    }
+
+    uint16_t EndOfService(size_t idx) const {
+      for (size_t i = idx + 1; i < attributes.size(); i++) {
+        if (attributes[i].type == PrimaryServiceId) {
+          return attributes[i].handle - 1;
+        }
+      }
+      return 0xffff;
+    }
+
+    const ble_gatt_error& Status(uint16_t status) const {
+      error.status = status;
+      error.att_handle = 0;
+      return error;
+    }
+
+    std::vector<Attribute> attributes;
+    uint16_t serviceChangedHandle = 0;
+    mutable ble_gatt_error error;
+  };
+
+  Peer* peer = nullptr;
+
+  // CTS and ANS: discovered, or restored with the handles saved after the previous discovery
+  class Client : public BleClient {
+  public:
+    explicit Client(uint16_t handle) : handle {handle} {
+    }
+
+    void Discover(uint16_t connectionHandle, std::function<void(uint16_t)> lambda) override {
+      nbDiscoveries++;
+      discovered = true;
+      lambda(connectionHandle);
+    }
+
+    bool SaveHandles(Handles& handles) const override {
+      handles = {handle, static_cast<uint16_t>(handle + 1)};
+      return discovered && !failed;
+    }
+
+    void RestoreHandles(uint16_t connectionHandle, const Handles& handles, std::function<void(uint16_t)> lambda) override {
+      nbRestores++;
+      restored = handles;
+      discovered = true;
+      lambda(connectionHandle);
+    }
+
+    uint16_t handle;
+    bool discovered = false;
+    bool failed = false;
+    int nbDiscoveries = 0;
+    int nbRestores = 0;
+    Handles restored {};
+  };
+
+  class ServiceDiscoveryTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+      peer = &phone;
+    }
+
+    void TearDown() override {
+      peer = nullptr;
+    }
+
+    void Connect() {
+      cts.discovered = false;
+      ans.discovered = false;
+      phone.writes.clear();
+      discovery.StartDiscovery(ConnectionHandle);
+    }
+
+    Peer phone;
+    Client cts {0x30};
+    Client ans {0x40};
+    ServiceDiscovery discovery {{&cts, &ans}};
+  };
+}
+
+extern "C" {
+int ble_gap_conn_find(uint16_t /*handle*/, struct ble_gap_conn_desc* out_desc) {
+  return peer->ConnFind(out_desc);
+}
+
+int ble_gattc_disc_svc_by_uuid(uint16_t /*conn_handle*/, const ble_uuid_t* uuid, ble_gatt_disc_svc_fn* cb, void* cb_arg) {
+  return peer->DiscoverServiceByUuid(uuid, cb, cb_arg);
+}
+
+int ble_gattc_disc_chrs_by_uuid(uint16_t /*conn_handle*/,
+                                uint16_t start_handle,
+                                uint16_t end_handle,
+                                const ble_uuid_t* uuid,
+                                ble_gatt_chr_fn* cb,
+                                void* cb_arg) {
+  return peer->DiscoverCharacteristicsByUuid(start_handle, end_handle, uuid, cb, cb_arg);
+}
+
+int ble_gattc_disc_all_dscs(uint16_t /*conn_handle*/, uint16_t start_handle, uint16_t end_handle, ble_gatt_dsc_fn* cb, void* cb_arg) {
+  return peer->DiscoverDescriptors(start_handle, end_handle, cb, cb_arg);
+}
+
+int ble_gattc_read_by_uuid(uint16_t /*conn_handle*/,
+                           uint16_t /*start_handle*/,
+                           uint16_t /*end_handle*/,
+                           const ble_uuid_t* uuid,
+                           ble_gatt_attr_fn* cb,
+                           void* cb_arg) {
+  return peer->ReadByUuid(uuid, cb, cb_arg);
+}
+
+int ble_gattc_write_flat(uint16_t /*conn_handle*/,
+                         uint16_t attr_handle,
+                         const void* data,
+                         uint16_t data_len,
+                         ble_gatt_attr_fn* cb,
+                         void* cb_arg) {
+  return peer->Write(attr_handle, data, data_len, cb, cb_arg);
+}
+
+int ble_uuid_cmp(const ble_uuid_t* uuid1, const ble_uuid_t* uuid2) {
+  return static_cast<int>(Uuid16Value(uuid1)) - static_cast<int>(Uuid16Value(uuid2));
+}
+}
+
+TEST_F(ServiceDiscoveryTest, SubscribesToTheServiceChangedIndications) {
+  phone.AddGattService();
+  Connect();
+  EXPECT_EQ(0x0002, phone.Cccd(phone.ServiceChangedHandle()));
+  EXPECT_EQ(1, cts.nbDiscoveries);
+  EXPECT_EQ(1, ans.nbDiscoveries);
+}
+
+TEST_F(ServiceDiscoveryTest, ReconnectionRestoresTheCachedHandles) {
+  phone.AddGattService();
+  Connect();
+  Connect();
+  EXPECT_EQ(1, cts.nbDiscoveries);
+  EXPECT_EQ(1, cts.nbRestores);
+  EXPECT_EQ(1, ans.nbRestores);
+  EXPECT_EQ((BleClient::Handles {0x40, 0x41}), ans.restored);
+  // Subscribed again with the restored handles
+  EXPECT_EQ(0x0002, phone.Cccd(phone.ServiceChangedHandle()));
+}
+
+TEST_F(ServiceDiscoveryTest, ServiceChangedIndicationDiscardsTheCache) {
+  phone.AddGattService();
+  Connect();
+  discovery.OnIndication(phone.ServiceChangedHandle());
+  Connect();
+  EXPECT_EQ(2, cts.nbDiscoveries);
+  EXPECT_EQ(0, cts.nbRestores);
+}
+
+TEST_F(ServiceDiscoveryTest, OtherIndicationsKeepTheCache) {
+  phone.AddGattService();
+  const uint16_t other = phone.AddOtherService(0x180d);
+  Connect();
+  discovery.OnIndication(other);
+  discovery.OnIndication(0);
+  discovery.OnIndication(phone.ServiceChangedHandle() + 1);
+  Connect();
+  EXPECT_EQ(1, cts.nbDiscoveries);
+  EXPECT_EQ(1, cts.nbRestores);
+
+  // Also after the handles are restored
+  discovery.OnIndication(other);
+  Connect();
+  EXPECT_EQ(2, cts.nbRestores);
+  discovery.OnIndication(phone.ServiceChangedHandle());
+  Connect();
+  EXPECT_EQ(2, cts.nbDiscoveries);
+}
+
+TEST_F(ServiceDiscoveryTest, DatabaseHashChanged) {
+  phone.AddGattService();
+  Connect();
+  phone.databaseHash[0]++;
+  Connect();
+  EXPECT_EQ(2, cts.nbDiscoveries);
+  EXPECT_EQ(0, cts.nbRestores);
+  // Cached again with the new hash
+  Connect();
+  EXPECT_EQ(1, cts.nbRestores);
+}
+
+TEST_F(ServiceDiscoveryTest, OtherPeer) {
+  phone.AddGattService();
+  Connect();
+  phone.address.val[0]++;
+  Connect();
+  EXPECT_EQ(2, cts.nbDiscoveries);
+  EXPECT_EQ(0, cts.nbRestores);
+}
+
+TEST_F(ServiceDiscoveryTest, PeerNotBonded) {
+  phone.AddGattService();
+  phone.bonded = false;
+  Connect();
+  Connect();
+  EXPECT_EQ(2, cts.nbDiscoveries);
+  EXPECT_EQ(0, cts.nbRestores);
+  // Nothing is cached, but the indications still tell about the changes during the connection
+  EXPECT_EQ(0x0002, phone.Cccd(phone.ServiceChangedHandle()));
+}
+
+TEST_F(ServiceDiscoveryTest, PeerWithoutDatabaseHash) {
+  phone.AddService(GattServiceId);
+  phone.AddCharacteristic(ServiceChangedId, true, BLE_GATT_CHR_PROP_INDICATE);
+  Connect();
+  Connect();
+  EXPECT_EQ(2, cts.nbDiscoveries);
+}
+
+TEST_F(ServiceDiscoveryTest, PeerWithoutServiceChanged) {
+  // Without its indication, a change of the services of the peer wouldn't be noticed during the connection
+  phone.AddGattService(false);
+  Connect();
+  Connect();
+  EXPECT_EQ(2, cts.nbDiscoveries);
+  EXPECT_EQ(0, cts.nbRestores);
+}
+
+TEST_F(ServiceDiscoveryTest, ServiceChangedWithoutCccd) {
+  // The CCCD of the next characteristic of the GATT service is not the one of Service Changed
+  phone.AddGattService(true, false);
+  const uint16_t other = phone.AddCharacteristic(0x2b3a, true, BLE_GATT_CHR_PROP_INDICATE);
+  Connect();
+  EXPECT_EQ(0xffff, phone.Cccd(phone.ServiceChangedHandle()));
+  EXPECT_EQ(0xffff, phone.Cccd(other));
+  EXPECT_TRUE(phone.writes.empty());
+  Connect();
+  EXPECT_EQ(2, cts.nbDiscoveries);
+}
+
+TEST_F(ServiceDiscoveryTest, FailedClientIsDiscoveredAgain) {
+  phone.AddGattService();
+  ans.failed = true;
+  Connect();
+  ans.failed = false;
+  Connect();
+  EXPECT_EQ(2, ans.nbDiscoveries);
+  Connect();
+  EXPECT_EQ(1, ans.nbRestores);
+}
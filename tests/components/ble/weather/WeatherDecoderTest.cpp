@@ -0,0 +1,366 @@
+#include "components/ble/weather/WeatherDecoder.h"
+#include "components/ble/weather/WeatherTimeline.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <host/ble_att.h>
+#undef min
+#undef max
+
+using Pinetime::Controllers::DateTime;
+using Pinetime::Controllers::WeatherData;
+using Pinetime::Controllers::WeatherDecoder;
+using Pinetime::Controllers::WeatherTimeline;
+
+namespace {
+  // 2021-11-01 12:00:00 UTC
+  constexpr uint64_t Now = 1635768000;
+
+  // Writes CBOR like the companion apps: definite lengths, the shortest encoding of the integers
+  class CborWriter {
+  public:
+    CborWriter& Map(size_t nbEntries) {
+      return Head(5, nbEntries);
+    }
+
+    CborWriter& Array(size_t nbItems) {
+      return Head(4, nbItems);
+    }
+
+    CborWriter& Int(int64_t value) {
+      return value >= 0 ? Head(0, value) : Head(1, -1 - value);
+    }
+
+    CborWriter& Text(const std::string& text) {
+      Head(3, text.size());
+      bytes.insert(bytes.end(), text.begin(), text.end());
+      return *this;
+    }
+
+    CborWriter& Entry(const std::string& key, int64_t value) {
+      return Text(key).Int(value);
+    }
+
+    CborWriter& Entry(const std::string& key, const std::string& value) {
+      return Text(key).Text(value);
+    }
+
+    std::vector<uint8_t> bytes;
+
+  private:
+    CborWriter& Head(uint8_t major, uint64_t argument) {
+      const uint8_t type = major << 5;
+      if (argument < 24) {
+        bytes.push_back(type | argument);
+        return *this;
+      }
+      size_t size = argument <= UINT8_MAX ? 1 : argument <= UINT16_MAX ? 2 : argument <= UINT32_MAX ? 4 : 8;
+      bytes.push_back(type | (size == 1 ? 24 : size == 2 ? 25 : size == 4 ? 26 : 27));
+      for (size_t i = size; i > 0; i--) {
+        bytes.push_back(argument >> (8 * (i - 1)));
+      }
+      return *this;
+    }
+  };
+
+  void Temperature(CborWriter& writer, uint64_t timestamp, int16_t temperature) {
+    writer.Map(5)
+      .Entry("Timestamp", timestamp)
+      .Entry("Expires", 3600)
+      .Entry("EventType", static_cast<int64_t>(WeatherData::eventtype::Temperature))
+      .Entry("Temperature", temperature)
+      .Entry("DewPoint", 500);
+  }
+
+  void AirQuality(CborWriter& writer, uint64_t timestamp, const std::string& polluter, uint32_t amount) {
+    writer.Map(5)
+      .Entry("Timestamp", timestamp)
+      .Entry("Expires", 3600)
+      .Entry("EventType", static_cast<int64_t>(WeatherData::eventtype::AirQuality))
+      .Entry("Polluter", polluter)
+      .Entry("Amount", amount);
+  }
+
+  // Nested maps and arrays, as an app could add to an event for its own needs
+  void Nested(CborWriter& writer, std::mt19937& random, int depth) {
+    const size_t nbItems = random() % 4;
+    const bool map = random() % 2 == 0;
+    map ? writer.Map(nbItems) : writer.Array(nbItems);
+    for (size_t i = 0; i < nbItems; i++) {
+      if (map) {
+        random() % 2 == 0 ? writer.Text("Key" + std::to_string(i)) : writer.Int(i);
+      }
+      switch (depth > 0 ? random() % 4 : random() % 2) {
+        case 0:
+          writer.Int(static_cast<int32_t>(random()));
+          break;
+        case 1:
+          writer.Text("Temperature");
+          break;
+        default:
+          Nested(writer, random, depth - 1);
+          break;
+      }
+    }
+  }
+
+  class WeatherDecoderTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+      using TimePoint = std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds>;
+      dateTime.SetCurrentTime(TimePoint {std::chrono::seconds {Now}});
+      timeline.Init();
+    }
+
+    int Decode(const std::vector<uint8_t>& payload) {
+      return WeatherDecoder::Decode(payload.data(), payload.size(), timeline);
+    }
+
+    int16_t CurrentTemperature() {
+      WeatherData::Temperature current;
+      return timeline.GetCurrentTemperature(current) ? current.temperature : -32768;
+    }
+
+    DateTime dateTime;
+    WeatherTimeline timeline {dateTime};
+  };
+}
+
+TEST_F(WeatherDecoderTest, SingleEvent) {
+  CborWriter writer;
+  Temperature(writer, Now - 60, 2150);
+  EXPECT_EQ(0, Decode(writer.bytes));
+  EXPECT_EQ(1u, timeline.GetTimelineLength());
+  EXPECT_EQ(2150, CurrentTemperature());
+}
+
+TEST_F(WeatherDecoderTest, ArrayOfEvents) {
+  CborWriter writer;
+  writer.Array(3);
+  Temperature(writer, Now - 120, 1000);
+  Temperature(writer, Now - 60, 1100);
+  AirQuality(writer, Now - 60, "NO2", 42);
+  EXPECT_EQ(0, Decode(writer.bytes));
+  EXPECT_EQ(3u, timeline.GetTimelineLength());
+  EXPECT_EQ(1100, CurrentTemperature());
+
+  WeatherData::AirQuality quality;
+  WeatherTimeline::String polluter;
+  ASSERT_TRUE(timeline.GetCurrentQuality(quality, polluter));
+  EXPECT_STREQ("NO2", quality.polluter);
+  EXPECT_EQ(42u, quality.amount);
+
+  CborWriter empty;
+  empty.Array(0);
+  EXPECT_EQ(0, Decode(empty.bytes));
+}
+
+TEST_F(WeatherDecoderTest, SkipsUnknownKeysWithNestedMapsAndArrays) {
+  CborWriter writer;
+  writer.Array(2);
+  writer.Map(8).Entry("Timestamp", Now - 60).Entry("Source", "forecast");
+  writer.Text("Details").Map(2).Entry("Model", "ICON").Text("Runs").Array(3).Int(0).Int(6).Map(1).Entry("Temperature", 5);
+  writer.Entry("Expires", 3600).Entry("EventType", static_cast<int64_t>(WeatherData::eventtype::Temperature));
+  writer.Text("Hourly").Array(2).Array(0).Map(0);
+  writer.Entry("Temperature", 1800).Entry("DewPoint", 300);
+  writer.Map(6)
+    .Entry("Timestamp", Now - 30)
+    .Entry("Expires", 3600)
+    .Entry("EventType", static_cast<int64_t>(WeatherData::eventtype::Temperature))
+    .Entry("Temperature", 1900)
+    .Entry("DewPoint", 300);
+  writer.Text("Extra").Array(1).Map(1).Entry("Temperature", -4000);
+
+  EXPECT_EQ(0, Decode(writer.bytes));
+  EXPECT_EQ(2u, timeline.GetTimelineLength());
+  EXPECT_EQ(1900, CurrentTemperature());
+}
+
+TEST_F(WeatherDecoderTest, RandomNestedUnknownKeysAreSkipped) {
+  std::mt19937 random {31};
+  for (int i = 0; i < 2000; i++) {
+    // The fields of the event, with unknown keys holding random nested items in between
+    const int16_t temperature = static_cast<int16_t>(random() % 4000);
+    const size_t nbUnknown = 1 + random() % 3;
+    CborWriter writer;
+    writer.Map(5 + nbUnknown);
+    std::vector<size_t> positions;
+    for (size_t j = 0; j < nbUnknown; j++) {
+      positions.push_back(random() % 6);
+    }
+    auto unknownAt = [&](size_t position) {
+      for (size_t p : positions) {
+        if (p == position) {
+          writer.Text("Unknown");
+          Nested(writer, random, 3);
+        }
+      }
+    };
+    unknownAt(0);
+    writer.Entry("Timestamp", Now - 2000 + i);
+    unknownAt(1);
+    writer.Entry("Expires", 3600);
+    unknownAt(2);
+    writer.Entry("EventType", static_cast<int64_t>(WeatherData::eventtype::Temperature));
+    unknownAt(3);
+    writer.Entry("Temperature", temperature);
+    unknownAt(4);
+    writer.Entry("DewPoint", 0);
+    unknownAt(5);
+
+    ASSERT_EQ(0, Decode(writer.bytes)) << "event " << i;
+    ASSERT_EQ(temperature, CurrentTemperature()) << "event " << i;
+  }
+}
+
+TEST_F(WeatherDecoderTest, RejectsInvalidEvents) {
+  const auto eventType = static_cast<int64_t>(WeatherData::eventtype::Clouds);
+  auto clouds = [&](CborWriter& writer) -> CborWriter& {
+    return writer.Entry("Timestamp", Now).Entry("Expires", 3600).Entry("EventType", eventType);
+  };
+  {
+    // Missing field
+    CborWriter writer;
+    clouds(writer.Map(3));
+    EXPECT_EQ(BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN, Decode(writer.bytes));
+  }
+  {
+    // Out of range
+    CborWriter writer;
+    clouds(writer.Map(4)).Entry("Amount", 256);
+    EXPECT_EQ(BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN, Decode(writer.bytes));
+  }
+  {
+    // Known key with a nested value
+    CborWriter writer;
+    clouds(writer.Map(4)).Text("Amount").Array(1).Int(50);
+    EXPECT_EQ(BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN, Decode(writer.bytes));
+  }
+  {
+    // Text instead of a number
+    CborWriter writer;
+    clouds(writer.Map(4)).Entry("Amount", "50");
+    EXPECT_EQ(BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN, Decode(writer.bytes));
+  }
+  {
+    // Integer label
+    CborWriter writer;
+    clouds(writer.Map(4)).Int(4).Int(50);
+    EXPECT_EQ(BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN, Decode(writer.bytes));
+  }
+  {
+    // Not a map
+    CborWriter writer;
+    writer.Int(5);
+    EXPECT_EQ(BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN, Decode(writer.bytes));
+  }
+  {
+    // Trailing bytes
+    CborWriter writer;
+    clouds(writer.Map(4)).Entry("Amount", 50).Int(0);
+    EXPECT_EQ(BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN, Decode(writer.bytes));
+  }
+  EXPECT_EQ(1u, timeline.GetTimelineLength());
+}
+
+TEST_F(WeatherDecoderTest, KeepsTheEventsBeforeAnInvalidOne) {
+  CborWriter writer;
+  writer.Array(3);
+  Temperature(writer, Now - 120, 1000);
+  writer.Map(1).Entry("Timestamp", Now);
+  Temperature(writer, Now - 60, 1100);
+  EXPECT_EQ(BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN, Decode(writer.bytes));
+  EXPECT_EQ(1u, timeline.GetTimelineLength());
+  EXPECT_EQ(1000, CurrentTemperature());
+}
+
+TEST_F(WeatherDecoderTest, TruncatedPayloads) {
+  CborWriter writer;
+  writer.Array(2);
+  Temperature(writer, Now - 120, 1000);
+  AirQuality(writer, Now - 60, "PM2.5", 7);
+  for (size_t size = 0; size < writer.bytes.size(); size++) {
+    EXPECT_NE(0, WeatherDecoder::Decode(writer.bytes.data(), size, timeline)) << "truncated to " << size;
+  }
+}
+
+TEST_F(WeatherDecoderTest, FuzzedPayloads) {
+  // Random byte flips, insertions and deletions in a valid forecast: the decoder must not read out of the payload
+  // (checked by ASan), nor store more events than the pools hold
+  CborWriter writer;
+  writer.Array(4);
+  Temperature(writer, Now - 120, 1000);
+  Temperature(writer, Now - 60, 1100);
+  AirQuality(writer, Now - 60, "NO2", 42);
+  writer.Map(7)
+    .Entry("Timestamp", Now - 60)
+    .Entry("Expires", 3600)
+    .Entry("EventType", static_cast<int64_t>(WeatherData::eventtype::Location))
+    .Entry("Location", "Somewhere very far away")
+    .Entry("Altitude", 10)
+    .Entry("Latitude", 5)
+    .Entry("Longitude", -6);
+  ASSERT_EQ(0, Decode(writer.bytes));
+
+  std::mt19937 random {1031};
+  int accepted = 0;
+  constexpr int nbPayloads = 50000;
+  for (int i = 0; i < nbPayloads; i++) {
+    std::vector<uint8_t> payload = writer.bytes;
+    const int nbMutations = 1 + random() % 4;
+    for (int j = 0; j < nbMutations && !payload.empty(); j++) {
+      const size_t position = random() % payload.size();
+      switch (random() % 3) {
+        case 0:
+          payload[position] ^= 1 << (random() % 8);
+          break;
+        case 1:
+          payload.insert(payload.begin() + position, static_cast<uint8_t>(random()));
+          break;
+        default:
+          payload.erase(payload.begin() + position);
+          break;
+      }
+    }
+    // Exact size, so that ASan catches any read past the end
+    std::unique_ptr<uint8_t[]> exact {new uint8_t[payload.size()]};
+    std::copy(payload.begin(), payload.end(), exact.get());
+    const int result = WeatherDecoder::Decode(exact.get(), payload.size(), timeline);
+    ASSERT_TRUE(result == 0 || result == BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN || result == BLE_ATT_ERR_INSUFFICIENT_RES);
+    accepted += result == 0;
+    if (i % 1000 == 0) {
+      timeline.TidyTimeline();
+    }
+  }
+  EXPECT_LE(timeline.GetTimelineLength(), 82u);
+  std::cout << "WeatherDecoder: " << accepted << " of " << nbPayloads << " fuzzed payloads accepted" << std::endl;
+}
+
+TEST_F(WeatherDecoderTest, DecodeThroughput) {
+  // A forecast of temperatures for the next 14 hours, as sent in a single long write
+  CborWriter writer;
+  constexpr size_t nbEvents = 7;
+  writer.Array(nbEvents);
+  for (size_t i = 0; i < nbEvents; i++) {
+    Temperature(writer, Now + i * 2 * 3600, 1000 + i * 50);
+  }
+  ASSERT_LE(writer.bytes.size(), 512u);
+
+  constexpr int nbPayloads = 20000;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < nbPayloads; i++) {
+    ASSERT_EQ(0, Decode(writer.bytes));
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  const auto nsPerPayload = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / nbPayloads;
+
+  RecordProperty("ns_per_payload", static_cast<int>(nsPerPayload));
+  RecordProperty("ns_per_event", static_cast<int>(nsPerPayload / nbEvents));
+  std::cout << "WeatherDecoder: " << writer.bytes.size() << "-byte payload of " << nbEvents << " events: " << nsPerPayload
+            << " ns per payload, " << nsPerPayload / nbEvents << " ns per event" << std::endl;
+}
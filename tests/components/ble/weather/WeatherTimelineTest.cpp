@@ -0,0 +1,287 @@
+#include "components/ble/weather/WeatherTimeline.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using Pinetime::Controllers::DateTime;
+using Pinetime::Controllers::WeatherData;
+using Pinetime::Controllers::WeatherTimeline;
+
+namespace {
+  // 2021-11-01 00:00:00 UTC
+  constexpr uint64_t Midnight = 1635724800;
+  constexpr uint32_t Hour = 60 * 60;
+
+  void SetTime(DateTime& dateTime, uint64_t timestamp) {
+    using TimePoint = std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds>;
+    dateTime.SetCurrentTime(TimePoint {std::chrono::seconds {timestamp}});
+  }
+
+  template <typename T>
+  T MakeEvent(WeatherData::eventtype type, uint64_t timestamp, uint32_t expires) {
+    T event {};
+    event.timestamp = timestamp;
+    event.expires = expires;
+    event.eventType = type;
+    return event;
+  }
+
+  WeatherData::Temperature Temperature(uint64_t timestamp, uint32_t expires, int16_t temperature) {
+    auto event = MakeEvent<WeatherData::Temperature>(WeatherData::eventtype::Temperature, timestamp, expires);
+    event.temperature = temperature;
+    return event;
+  }
+
+  WeatherData::Location Location(uint64_t timestamp, uint32_t expires, const char* name) {
+    auto event = MakeEvent<WeatherData::Location>(WeatherData::eventtype::Location, timestamp, expires);
+    event.location = name;
+    return event;
+  }
+
+  WeatherData::AirQuality AirQuality(uint64_t timestamp, uint32_t expires, const char* polluter, uint32_t amount) {
+    auto event = MakeEvent<WeatherData::AirQuality>(WeatherData::eventtype::AirQuality, timestamp, expires);
+    event.polluter = polluter;
+    event.amount = amount;
+    return event;
+  }
+
+  class WeatherTimelineTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+      timeline.Init();
+      SetTime(dateTime, Midnight + 12 * Hour);
+    }
+
+    DateTime dateTime;
+    WeatherTimeline timeline {dateTime};
+  };
+
+  // The timeline that the pools replaced: a vector of heap-allocated events, sorted from the newest after every write,
+  // scanned by every query (holding only temperatures: TimelineHeader has no virtual destructor). The query skips the
+  // events that haven't started, like WeatherTimeline.
+  class VectorTimeline {
+  public:
+    void Tidy(uint64_t now) {
+      timeline.erase(std::remove_if(timeline.begin(),
+                                    timeline.end(),
+                                    [now](const std::unique_ptr<WeatherData::Temperature>& header) {
+                                      return header->timestamp + header->expires < now;
+                                    }),
+                     timeline.end());
+      std::sort(timeline.begin(), timeline.end(), [](const auto& first, const auto& second) {
+        return first->timestamp > second->timestamp;
+      });
+    }
+
+    void Add(std::unique_ptr<WeatherData::Temperature> event) {
+      timeline.push_back(std::move(event));
+    }
+
+    const WeatherData::Temperature* CurrentTemperature(uint64_t now) const {
+      for (const auto& header : timeline) {
+        if (header->eventType == WeatherData::eventtype::Temperature && header->timestamp <= now &&
+            header->timestamp + header->expires >= now) {
+          return header.get();
+        }
+      }
+      return nullptr;
+    }
+
+  private:
+    std::vector<std::unique_ptr<WeatherData::Temperature>> timeline;
+  };
+}
+
+TEST_F(WeatherTimelineTest, CurrentEventIsTheLatestThatStarted) {
+  WeatherData::Temperature current;
+  EXPECT_FALSE(timeline.GetCurrentTemperature(current));
+
+  const uint64_t now = Midnight + 12 * Hour;
+  ASSERT_TRUE(timeline.AddEventToTimeline(Temperature(now - 2 * Hour, 3 * Hour, 1500)));
+  ASSERT_TRUE(timeline.AddEventToTimeline(Temperature(now - Hour, 3 * Hour, 1700)));
+  ASSERT_TRUE(timeline.AddEventToTimeline(Temperature(now + Hour, 3 * Hour, 2000)));
+  EXPECT_EQ(3u, timeline.GetTimelineLength());
+  EXPECT_TRUE(timeline.HasTimelineEventOfType(WeatherData::eventtype::Temperature));
+  EXPECT_FALSE(timeline.HasTimelineEventOfType(WeatherData::eventtype::Wind));
+
+  ASSERT_TRUE(timeline.GetCurrentTemperature(current));
+  EXPECT_EQ(1700, current.temperature);
+
+  // Updated forecast for the same time
+  ASSERT_TRUE(timeline.AddEventToTimeline(Temperature(now - Hour, 3 * Hour, 1600)));
+  EXPECT_EQ(3u, timeline.GetTimelineLength());
+  ASSERT_TRUE(timeline.GetCurrentTemperature(current));
+  EXPECT_EQ(1600, current.temperature);
+
+  // The newest event expired: the previous one is still valid
+  ASSERT_TRUE(timeline.AddEventToTimeline(Temperature(now - Hour / 2, 60, 1900)));
+  ASSERT_TRUE(timeline.GetCurrentTemperature(current));
+  EXPECT_EQ(1600, current.temperature);
+}
+
+TEST_F(WeatherTimelineTest, FullPoolDropsTheOldestEvent) {
+  const uint64_t now = Midnight + 12 * Hour;
+  for (int i = 0; i < 30; i++) {
+    ASSERT_TRUE(timeline.AddEventToTimeline(Temperature(now - 30 * 60 + i * 60, 24 * Hour, i)));
+  }
+  EXPECT_EQ(24u, timeline.GetTimelineLength());
+  // Older than all the events of the full pool
+  EXPECT_FALSE(timeline.AddEventToTimeline(Temperature(now - Hour, 24 * Hour, -1)));
+
+  WeatherData::Temperature current;
+  ASSERT_TRUE(timeline.GetCurrentTemperature(current));
+  EXPECT_EQ(29, current.temperature);
+}
+
+TEST_F(WeatherTimelineTest, TidyRemovesExpiredEvents) {
+  const uint64_t now = Midnight + 12 * Hour;
+  timeline.AddEventToTimeline(Temperature(now - 2 * Hour, Hour, 1000));
+  timeline.AddEventToTimeline(AirQuality(now - 2 * Hour, Hour, "PM10", 1200));
+  timeline.AddEventToTimeline(AirQuality(now - Hour, 2 * Hour, "O3", 3400));
+  EXPECT_EQ(3u, timeline.GetTimelineLength());
+  timeline.TidyTimeline();
+  EXPECT_EQ(1u, timeline.GetTimelineLength());
+
+  WeatherData::AirQuality current;
+  WeatherTimeline::String polluter;
+  ASSERT_TRUE(timeline.GetCurrentQuality(current, polluter));
+  EXPECT_STREQ("O3", current.polluter);
+}
+
+TEST_F(WeatherTimelineTest, CopiesOfTheStringsDontMoveWhenTheArenaIsCompacted) {
+  const uint64_t now = Midnight + 12 * Hour;
+  ASSERT_TRUE(timeline.AddEventToTimeline(AirQuality(now - Hour, 4 * Hour, "Betula", 10)));
+  ASSERT_TRUE(timeline.AddEventToTimeline(Location(now - Hour, 4 * Hour, "Tallinn")));
+
+  // The display task holds the events it read...
+  WeatherData::AirQuality quality;
+  WeatherTimeline::String polluter;
+  ASSERT_TRUE(timeline.GetCurrentQuality(quality, polluter));
+  WeatherData::Location location;
+  WeatherTimeline::String locationName;
+  ASSERT_TRUE(timeline.GetCurrentLocation(location, locationName));
+  EXPECT_EQ(polluter.data(), quality.polluter);
+  EXPECT_EQ(locationName.data(), location.location);
+
+  // ...while the BLE host task replaces the polluter, which compacts the arena: the location moves down
+  ASSERT_TRUE(timeline.AddEventToTimeline(AirQuality(now - Hour, 4 * Hour, "NO2", 20)));
+  EXPECT_STREQ("Betula", quality.polluter);
+  EXPECT_STREQ("Tallinn", location.location);
+
+  ASSERT_TRUE(timeline.GetCurrentLocation(location, locationName));
+  EXPECT_STREQ("Tallinn", location.location);
+  ASSERT_TRUE(timeline.GetCurrentQuality(quality, polluter));
+  EXPECT_STREQ("NO2", quality.polluter);
+  EXPECT_EQ(20u, quality.amount);
+}
+
+TEST_F(WeatherTimelineTest, StringsAreTruncatedAndTheArenaIsBounded) {
+  const uint64_t now = Midnight + 12 * Hour;
+  const std::string longName(100, 'x');
+  ASSERT_TRUE(timeline.AddEventToTimeline(Location(now - Hour, 4 * Hour, longName.c_str())));
+  WeatherData::Location location;
+  WeatherTimeline::String locationName;
+  ASSERT_TRUE(timeline.GetCurrentLocation(location, locationName));
+  EXPECT_EQ(longName.substr(0, WeatherTimeline::MaxStringLength), location.location);
+
+  // 48 bytes for the location, 3 polluters of 31 bytes don't fit in the 128 bytes of the arena
+  const std::string polluterName(30, 'p');
+  EXPECT_TRUE(timeline.AddEventToTimeline(AirQuality(now - 3 * Hour, 4 * Hour, polluterName.c_str(), 1)));
+  EXPECT_TRUE(timeline.AddEventToTimeline(AirQuality(now - 2 * Hour, 4 * Hour, polluterName.c_str(), 2)));
+  EXPECT_FALSE(timeline.AddEventToTimeline(AirQuality(now - Hour, 4 * Hour, polluterName.c_str(), 3)));
+  EXPECT_EQ(3u, timeline.GetTimelineLength());
+  WeatherData::AirQuality quality;
+  WeatherTimeline::String polluter;
+  ASSERT_TRUE(timeline.GetCurrentQuality(quality, polluter));
+  EXPECT_EQ(2u, quality.amount);
+}
+
+TEST_F(WeatherTimelineTest, TodayTemperatures) {
+  const uint64_t now = Midnight + 12 * Hour;
+  EXPECT_EQ(-32768, timeline.GetTodayMinTemp());
+  timeline.AddEventToTimeline(Temperature(now - Hour, 2 * Hour, 1500));
+  timeline.AddEventToTimeline(Temperature(now + 3 * Hour, 2 * Hour, 2200));
+  timeline.AddEventToTimeline(Temperature(now + 6 * Hour, 2 * Hour, 900));
+  // Tomorrow
+  timeline.AddEventToTimeline(Temperature(now + 13 * Hour, 2 * Hour, -500));
+  EXPECT_EQ(900, timeline.GetTodayMinTemp());
+  EXPECT_EQ(2200, timeline.GetTodayMaxTemp());
+
+  // The first event expired
+  SetTime(dateTime, now + 2 * Hour);
+  timeline.AddEventToTimeline(Temperature(now + 5 * Hour, 2 * Hour, 2500));
+  EXPECT_EQ(900, timeline.GetTodayMinTemp());
+  EXPECT_EQ(2500, timeline.GetTodayMaxTemp());
+
+  // Next day
+  SetTime(dateTime, now + 13 * Hour);
+  EXPECT_EQ(-500, timeline.GetTodayMinTemp());
+  EXPECT_EQ(-500, timeline.GetTodayMaxTemp());
+}
+
+TEST_F(WeatherTimelineTest, InsertAndQueryThroughput) {
+  // A phone sends a temperature every 10 minutes, for around the time it's sent, valid for 2 hours; the display reads
+  // the current temperature after each write. Both timelines must agree on the result.
+  constexpr int nbWrites = 10000;
+  constexpr int nbReadsPerWrite = 4;
+  std::mt19937 random {30};
+  std::uniform_int_distribution<int> offsets {-30 * 60, 30 * 60};
+  std::uniform_int_distribution<int> temperatures {-1000, 3000};
+  std::set<uint64_t> timestamps;
+  std::vector<WeatherData::Temperature> events;
+  for (int i = 0; i < nbWrites; i++) {
+    const uint64_t sent = Midnight + i * 10 * 60;
+    uint64_t timestamp;
+    do {
+      timestamp = sent + offsets(random);
+    } while (!timestamps.insert(timestamp).second);
+    events.push_back(Temperature(timestamp, 2 * Hour, temperatures(random)));
+  }
+
+  VectorTimeline baseline;
+  int64_t baselineSum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < nbWrites; i++) {
+    const uint64_t now = Midnight + i * 10 * 60;
+    // Sorted after the write, not before like the firmware did: the new event would be missed by the next queries
+    baseline.Add(std::make_unique<WeatherData::Temperature>(events[i]));
+    baseline.Tidy(now);
+    for (int j = 0; j < nbReadsPerWrite; j++) {
+      const auto* current = baseline.CurrentTemperature(now);
+      baselineSum += current != nullptr ? current->temperature : 0;
+    }
+  }
+  const auto baselineTime = std::chrono::steady_clock::now() - start;
+
+  int64_t sum = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < nbWrites; i++) {
+    const uint64_t now = Midnight + i * 10 * 60;
+    SetTime(dateTime, now);
+    timeline.TidyTimeline();
+    timeline.AddEventToTimeline(events[i]);
+    for (int j = 0; j < nbReadsPerWrite; j++) {
+      WeatherData::Temperature current;
+      sum += timeline.GetCurrentTemperature(current) ? current.temperature : 0;
+    }
+  }
+  const auto poolTime = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(baselineSum, sum);
+  EXPECT_LT(poolTime, baselineTime);
+
+  using std::chrono::nanoseconds;
+  const auto nbOperations = nbWrites * (1 + nbReadsPerWrite);
+  const auto poolNs = std::chrono::duration_cast<nanoseconds>(poolTime).count() / nbOperations;
+  const auto baselineNs = std::chrono::duration_cast<nanoseconds>(baselineTime).count() / nbOperations;
+  RecordProperty("pool_ns_per_operation", static_cast<int>(poolNs));
+  RecordProperty("vector_ns_per_operation", static_cast<int>(baselineNs));
+  std::cout << "WeatherTimeline: " << nbWrites << " writes, " << nbWrites * nbReadsPerWrite << " reads: " << poolNs
+            << " ns per operation; vector of events: " << baselineNs << " ns per operation" << std::endl;
+}
@@ -0,0 +1,393 @@
+#include "components/fonts/FontStore.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using Pinetime::Controllers::FontStore;
+using Pinetime::Controllers::FS;
+
+extern lv_font_t jetbrains_mono_42;
+extern lv_font_t jetbrains_mono_76;
+extern lv_font_t lv_font_navi_80;
+extern lv_font_t open_sans_light;
+
+namespace {
+  constexpr uint32_t Magic = 0x4e465450;
+  constexpr size_t HeaderSize = 16;
+  constexpr size_t FontEntrySize = 56;
+  constexpr size_t IndexEntrySize = 8;
+  // 6 of them fit in the cache
+  constexpr size_t DigitSize = 600;
+
+  struct Glyph {
+    uint32_t codePoint;
+    uint16_t advanceWidth;
+    uint16_t boxWidth;
+    uint16_t boxHeight;
+    int16_t offsetX;
+    int16_t offsetY;
+    std::vector<uint8_t> bitmap;
+  };
+
+  struct Font {
+    std::string name;
+    int16_t lineHeight;
+    int16_t baseLine;
+    int8_t underlinePosition;
+    uint8_t underlineThickness;
+    uint8_t bitsPerPixel;
+    std::vector<Glyph> glyphs;
+  };
+
+  void Append16(std::vector<uint8_t>& data, uint16_t value) {
+    data.push_back(value & 0xff);
+    data.push_back(value >> 8);
+  }
+
+  void Append32(std::vector<uint8_t>& data, uint32_t value) {
+    Append16(data, value & 0xffff);
+    Append16(data, value >> 16);
+  }
+
+  uint32_t Crc32(const uint8_t* data, size_t size) {
+    uint32_t crc = 0xffffffff;
+    for (size_t i = 0; i < size; i++) {
+      crc ^= data[i];
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+      }
+    }
+    return ~crc;
+  }
+
+  // pack_fonts() of src/displayapp/fonts/generate.py, see doc/ExternalFonts.md
+  std::vector<uint8_t> Pack(const std::vector<Font>& fonts) {
+    std::vector<uint8_t> entries;
+    std::vector<uint8_t> data;
+    const size_t offset = HeaderSize + FontEntrySize * fonts.size();
+    for (const auto& font : fonts) {
+      const size_t indexOffset = offset + data.size();
+      const size_t glyphOffset = indexOffset + IndexEntrySize * font.glyphs.size();
+      std::vector<uint8_t> index;
+      std::vector<uint8_t> records;
+      for (const auto& glyph : font.glyphs) {
+        Append32(index, glyph.codePoint);
+        Append32(index, glyphOffset + records.size());
+        Append16(records, glyph.advanceWidth);
+        Append16(records, glyph.boxWidth);
+        Append16(records, glyph.boxHeight);
+        Append16(records, glyph.offsetX);
+        Append16(records, glyph.offsetY);
+        Append16(records, glyph.bitmap.size());
+        records.insert(records.end(), glyph.bitmap.begin(), glyph.bitmap.end());
+      }
+
+      char name[FontStore::NameSize] {};
+      std::memcpy(name, font.name.data(), std::min(font.name.size(), sizeof(name)));
+      entries.insert(entries.end(), name, name + sizeof(name));
+      Append16(entries, font.lineHeight);
+      Append16(entries, font.baseLine);
+      entries.insert(entries.end(), {static_cast<uint8_t>(font.underlinePosition), font.underlineThickness, font.bitsPerPixel, 0});
+      Append32(entries, indexOffset);
+      Append32(entries, font.glyphs.size());
+      data.insert(data.end(), index.begin(), index.end());
+      data.insert(data.end(), records.begin(), records.end());
+    }
+
+    std::vector<uint8_t> content = entries;
+    content.insert(content.end(), data.begin(), data.end());
+    std::vector<uint8_t> pack;
+    Append32(pack, Magic);
+    Append16(pack, 1);
+    Append16(pack, fonts.size());
+    Append32(pack, Crc32(content.data(), content.size()));
+    Append32(pack, 0);
+    pack.insert(pack.end(), content.begin(), content.end());
+    return pack;
+  }
+
+  Glyph MakeGlyph(uint32_t codePoint, size_t bitmapSize, uint16_t advanceWidth) {
+    Glyph glyph {codePoint, advanceWidth, 30, 40, 2, -3, std::vector<uint8_t>(bitmapSize)};
+    for (size_t i = 0; i < bitmapSize; i++) {
+      glyph.bitmap[i] = static_cast<uint8_t>(codePoint * 7 + i);
+    }
+    return glyph;
+  }
+
+  // The digits and ':' of the watch faces, the icons of the navigation app. open_sans_light is not packed.
+  std::vector<Font> Fonts(uint16_t advanceWidth = 44 * 16 + 5) {
+    Font digits {"jetbrains_mono_76", 76, 14, -8, 4, 4, {}};
+    for (uint32_t codePoint = '0'; codePoint <= ':'; codePoint++) {
+      digits.glyphs.push_back(MakeGlyph(codePoint, DigitSize, advanceWidth));
+    }
+    Font small {"jetbrains_mono_42", 42, 8, -5, 2, 2, {MakeGlyph('1', 40, 24 * 16)}};
+    Font icons {"lv_font_navi_80", 80, 0, 0, 0, 1, {}};
+    for (uint32_t codePoint = 0xe000; codePoint < 0xe000 + 40; codePoint++) {
+      icons.glyphs.push_back(MakeGlyph(codePoint, 20, 80 * 16));
+    }
+    return {digits, small, icons};
+  }
+
+  const Glyph& FindGlyph(const std::vector<Font>& fonts, const std::string& name, uint32_t codePoint) {
+    for (const auto& font : fonts) {
+      for (const auto& glyph : font.glyphs) {
+        if (font.name == name && glyph.codePoint == codePoint) {
+          return glyph;
+        }
+      }
+    }
+    throw std::invalid_argument("not in the fonts");
+  }
+
+  // The fallback font of the firmware
+  bool FallbackGlyphDsc(const lv_font_t* /*font*/, lv_font_glyph_dsc_t* dsc, uint32_t /*letter*/, uint32_t /*nextLetter*/) {
+    *dsc = {12, 10, 16, 1, 0, 1};
+    return true;
+  }
+
+  const uint8_t* FallbackGlyphBitmap(const lv_font_t* /*font*/, uint32_t /*letter*/) {
+    static const uint8_t bitmap[20] {};
+    return bitmap;
+  }
+}
+
+lv_font_t jetbrains_mono_bold_20 {0, 0, FallbackGlyphDsc, FallbackGlyphBitmap, 20, 4, LV_FONT_SUBPX_NONE, -2, 1, nullptr};
+
+namespace {
+  class FontStoreTest : public ::testing::Test {
+  protected:
+    void Init(const std::vector<uint8_t>& pack) {
+      fs.Content(FontStore::Path) = pack;
+      fontStore.Init();
+    }
+
+    // What LVGL does for each letter it draws
+    bool Draw(const lv_font_t& font, uint32_t letter, lv_font_glyph_dsc_t& dsc, const uint8_t*& bitmap) {
+      if (!font.get_glyph_dsc(&font, &dsc, letter, 0)) {
+        return false;
+      }
+      bitmap = font.get_glyph_bitmap(&font, letter);
+      return bitmap != nullptr;
+    }
+
+    void ExpectGlyph(const Glyph& expected, const lv_font_t& font, uint8_t bitsPerPixel) {
+      lv_font_glyph_dsc_t dsc;
+      const uint8_t* bitmap;
+      ASSERT_TRUE(Draw(font, expected.codePoint, dsc, bitmap)) << expected.codePoint;
+      EXPECT_EQ((expected.advanceWidth + 8) >> 4, dsc.adv_w);
+      EXPECT_EQ(expected.boxWidth, dsc.box_w);
+      EXPECT_EQ(expected.boxHeight, dsc.box_h);
+      EXPECT_EQ(expected.offsetX, dsc.ofs_x);
+      EXPECT_EQ(expected.offsetY, dsc.ofs_y);
+      EXPECT_EQ(bitsPerPixel, dsc.bpp);
+      EXPECT_EQ(expected.bitmap, std::vector<uint8_t>(bitmap, bitmap + expected.bitmap.size())) << expected.codePoint;
+    }
+
+    FS fs;
+    FontStore fontStore {fs};
+  };
+}
+
+TEST_F(FontStoreTest, LoadsTheMetricsOfThePackedFonts) {
+  Init(Pack(Fonts()));
+  EXPECT_EQ(76, jetbrains_mono_76.line_height);
+  EXPECT_EQ(14, jetbrains_mono_76.base_line);
+  EXPECT_EQ(-8, jetbrains_mono_76.underline_position);
+  EXPECT_EQ(4, jetbrains_mono_76.underline_thickness);
+  EXPECT_EQ(80, lv_font_navi_80.line_height);
+  // Not in the pack
+  EXPECT_EQ(jetbrains_mono_bold_20.line_height, open_sans_light.line_height);
+  EXPECT_EQ(jetbrains_mono_bold_20.base_line, open_sans_light.base_line);
+}
+
+TEST_F(FontStoreTest, ReadsTheGlyphsFromThePack) {
+  const auto fonts = Fonts();
+  Init(Pack(fonts));
+  for (uint32_t codePoint = '0'; codePoint <= ':'; codePoint += 3) {
+    ExpectGlyph(FindGlyph(fonts, "jetbrains_mono_76", codePoint), jetbrains_mono_76, 4);
+  }
+  ExpectGlyph(FindGlyph(fonts, "jetbrains_mono_42", '1'), jetbrains_mono_42, 2);
+  ExpectGlyph(FindGlyph(fonts, "lv_font_navi_80", 0xe027), lv_font_navi_80, 1);
+
+  // Not in the font
+  lv_font_glyph_dsc_t dsc;
+  EXPECT_FALSE(jetbrains_mono_42.get_glyph_dsc(&jetbrains_mono_42, &dsc, '2', 0));
+  EXPECT_EQ(nullptr, jetbrains_mono_42.get_glyph_bitmap(&jetbrains_mono_42, '2'));
+  EXPECT_FALSE(jetbrains_mono_76.get_glyph_dsc(&jetbrains_mono_76, &dsc, 'A', 0));
+
+  // Then from the cache
+  const auto nbReads = fs.nbReads;
+  const auto nbMisses = fontStore.NbMisses();
+  ExpectGlyph(FindGlyph(fonts, "jetbrains_mono_76", '3'), jetbrains_mono_76, 4);
+  EXPECT_FALSE(jetbrains_mono_42.get_glyph_dsc(&jetbrains_mono_42, &dsc, '2', 0));
+  EXPECT_EQ(nbReads, fs.nbReads);
+  EXPECT_EQ(nbMisses, fontStore.NbMisses());
+}
+
+TEST_F(FontStoreTest, MissingFontsUseTheFallbackFont) {
+  Init(Pack(Fonts()));
+  lv_font_glyph_dsc_t dsc;
+  const uint8_t* bitmap;
+  ASSERT_TRUE(Draw(open_sans_light, '5', dsc, bitmap));
+  EXPECT_EQ(12, dsc.adv_w);
+  EXPECT_EQ(FallbackGlyphBitmap(nullptr, '5'), bitmap);
+
+  // No pack at all
+  FS emptyFs;
+  FontStore store {emptyFs};
+  store.Init();
+  EXPECT_EQ(jetbrains_mono_bold_20.line_height, jetbrains_mono_76.line_height);
+  ASSERT_TRUE(Draw(jetbrains_mono_76, '5', dsc, bitmap));
+  EXPECT_EQ(12, dsc.adv_w);
+  EXPECT_EQ(0u, emptyFs.nbReads);
+}
+
+TEST_F(FontStoreTest, PrefetchReadsTheGlyphsOfALabelAtOnce) {
+  const auto fonts = Fonts();
+  Init(Pack(fonts));
+  // The header, the index, the header of ':' (the last glyph of the font: its size is not in the index), the run of
+  // "1234" and ':'
+  auto nbReads = fs.nbReads;
+  FontStore::Prefetch(&jetbrains_mono_76, "12:34");
+  EXPECT_EQ(nbReads + 5, fs.nbReads);
+
+  nbReads = fs.nbReads;
+  for (const char letter : std::string("12:34")) {
+    ExpectGlyph(FindGlyph(fonts, "jetbrains_mono_76", letter), jetbrains_mono_76, 4);
+  }
+  FontStore::Prefetch(&jetbrains_mono_76, "43:21");
+  EXPECT_EQ(nbReads, fs.nbReads);
+  EXPECT_EQ(0u, fontStore.NbMisses());
+
+  // A label
+  lv_obj_t* label = lv_label_create(nullptr, nullptr);
+  lv_obj_set_style_local_text_font(label, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, &lv_font_navi_80);
+  lv_label_set_text_static(label, "\xee\x80\x80\xee\x80\x81");
+  FontStore::Prefetch(label);
+  nbReads = fs.nbReads;
+  ExpectGlyph(FindGlyph(fonts, "lv_font_navi_80", 0xe000), lv_font_navi_80, 1);
+  ExpectGlyph(FindGlyph(fonts, "lv_font_navi_80", 0xe001), lv_font_navi_80, 1);
+  EXPECT_EQ(nbReads, fs.nbReads);
+}
+
+TEST_F(FontStoreTest, EvictsTheLeastRecentlyUsedGlyphs) {
+  const auto fonts = Fonts();
+  Init(Pack(fonts));
+  // 6 digits fit in the cache: '0' is evicted by '6'
+  for (uint32_t codePoint = '0'; codePoint <= '6'; codePoint++) {
+    ExpectGlyph(FindGlyph(fonts, "jetbrains_mono_76", codePoint), jetbrains_mono_76, 4);
+  }
+  auto nbMisses = fontStore.NbMisses();
+  ExpectGlyph(FindGlyph(fonts, "jetbrains_mono_76", '6'), jetbrains_mono_76, 4);
+  ExpectGlyph(FindGlyph(fonts, "jetbrains_mono_76", '2'), jetbrains_mono_76, 4);
+  EXPECT_EQ(nbMisses, fontStore.NbMisses());
+  ExpectGlyph(FindGlyph(fonts, "jetbrains_mono_76", '0'), jetbrains_mono_76, 4);
+  EXPECT_EQ(nbMisses + 1, fontStore.NbMisses());
+
+  // At most 32 glyphs, whatever their size
+  for (uint32_t codePoint = 0xe000; codePoint < 0xe000 + 40; codePoint++) {
+    ExpectGlyph(FindGlyph(fonts, "lv_font_navi_80", codePoint), lv_font_navi_80, 1);
+  }
+  nbMisses = fontStore.NbMisses();
+  for (uint32_t codePoint = 0xe000 + 40 - FontStore::MaxGlyphs; codePoint < 0xe000 + 40; codePoint++) {
+    ExpectGlyph(FindGlyph(fonts, "lv_font_navi_80", codePoint), lv_font_navi_80, 1);
+  }
+  EXPECT_EQ(nbMisses, fontStore.NbMisses());
+}
+
+TEST_F(FontStoreTest, PrefetchKeepsTheGlyphsOfTheLabel) {
+  const auto fonts = Fonts();
+  Init(Pack(fonts));
+  for (uint32_t codePoint = '0'; codePoint <= '5'; codePoint++) {
+    ExpectGlyph(FindGlyph(fonts, "jetbrains_mono_76", codePoint), jetbrains_mono_76, 4);
+  }
+  // '5' is the most recently used glyph, but the least recently used ones are evicted for "678" anyway
+  FontStore::Prefetch(&jetbrains_mono_76, "5678");
+  const auto nbMisses = fontStore.NbMisses();
+  for (const char letter : std::string("5678")) {
+    ExpectGlyph(FindGlyph(fonts, "jetbrains_mono_76", letter), jetbrains_mono_76, 4);
+  }
+  EXPECT_EQ(nbMisses, fontStore.NbMisses());
+}
+
+TEST_F(FontStoreTest, ReloadsAReplacedPack) {
+  Init(Pack(Fonts()));
+  ExpectGlyph(FindGlyph(Fonts(), "jetbrains_mono_76", '1'), jetbrains_mono_76, 4);
+
+  // Noticed on the next miss: the cache is cleared
+  const auto fonts = Fonts(50 * 16);
+  fs.Content(FontStore::Path) = Pack(fonts);
+  ExpectGlyph(FindGlyph(fonts, "jetbrains_mono_76", '2'), jetbrains_mono_76, 4);
+  ExpectGlyph(FindGlyph(fonts, "jetbrains_mono_76", '1'), jetbrains_mono_76, 4);
+
+  // Removed: the fallback font until the next start
+  fs.Delete(FontStore::Path);
+  lv_font_glyph_dsc_t dsc;
+  const uint8_t* bitmap;
+  ASSERT_TRUE(Draw(jetbrains_mono_76, '3', dsc, bitmap));
+  EXPECT_EQ(12, dsc.adv_w);
+  EXPECT_EQ(jetbrains_mono_bold_20.line_height, jetbrains_mono_76.line_height);
+}
+
+TEST_F(FontStoreTest, CostOfDrawingTheTime) {
+  const auto fonts = Fonts();
+  const auto pack = Pack(fonts);
+  const std::string time = "12:34";
+  constexpr int nbRounds = 500;
+
+  // LVGL gets the descriptor of each letter to lay the label out, then the descriptor and the bitmap to draw it
+  auto drawTime = [&]() {
+    lv_font_glyph_dsc_t dsc;
+    const uint8_t* bitmap;
+    for (const char letter : time) {
+      jetbrains_mono_76.get_glyph_dsc(&jetbrains_mono_76, &dsc, letter, 0);
+    }
+    for (const char letter : time) {
+      EXPECT_TRUE(Draw(jetbrains_mono_76, letter, dsc, bitmap));
+    }
+  };
+
+  struct Result {
+    double us;
+    uint32_t nbReads;
+    size_t bytesRead;
+  } results[3] {};
+  for (int mode = 0; mode < 3; mode++) {
+    // Cold cache, with and without Prefetch(), then hot cache
+    Init(pack);
+    drawTime();
+    for (int round = 0; round < nbRounds; round++) {
+      if (mode < 2) {
+        // The cache is cleared when the fonts are reloaded from a new pack
+        Init(Pack(Fonts(44 * 16 + round % 2)));
+      }
+      const auto nbReads = fs.nbReads;
+      const auto bytesRead = fs.bytesRead;
+      const auto start = std::chrono::steady_clock::now();
+      if (mode == 0) {
+        FontStore::Prefetch(&jetbrains_mono_76, time.c_str());
+      }
+      drawTime();
+      results[mode].us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+      results[mode].nbReads += fs.nbReads - nbReads;
+      results[mode].bytesRead += fs.bytesRead - bytesRead;
+    }
+    results[mode].us /= nbRounds;
+    results[mode].nbReads /= nbRounds;
+    results[mode].bytesRead /= nbRounds;
+  }
+
+  // Without Prefetch(), each glyph is looked up in the index of the font
+  EXPECT_LT(results[0].nbReads, results[1].nbReads);
+  EXPECT_EQ(0u, results[2].nbReads);
+
+  RecordProperty("prefetch_us", static_cast<int>(results[0].us));
+  RecordProperty("glyph_by_glyph_us", static_cast<int>(results[1].us));
+  RecordProperty("cached_us", static_cast<int>(results[2].us));
+  std::cout << "Drawing \"" << time << "\" with a cold cache: with Prefetch() " << results[0].us << "us, "
+            << results[0].nbReads << " reads of " << results[0].bytesRead << " bytes; glyph by glyph " << results[1].us
+            << "us, " << results[1].nbReads << " reads of " << results[1].bytesRead << " bytes. Cached: " << results[2].us
+            << "us" << std::endl;
+}
@@ -0,0 +1,452 @@
+#include "components/images/ImageStore.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using Pinetime::Controllers::FS;
+using Pinetime::Controllers::ImageStore;
+
+namespace {
+  constexpr uint32_t Magic = 0x4d495450;
+  constexpr size_t HeaderSize = 16;
+  constexpr size_t EntrySize = 28;
+
+  struct Image {
+    std::string name;
+    uint16_t width;
+    uint16_t height;
+    lv_img_cf_t colorFormat;
+    // lv_color32_t: blue, green, red, alpha
+    std::vector<uint8_t> palette;
+    std::vector<std::vector<uint8_t>> rows;
+  };
+
+  void Append16(std::vector<uint8_t>& data, uint16_t value) {
+    data.push_back(value & 0xff);
+    data.push_back(value >> 8);
+  }
+
+  void Append32(std::vector<uint8_t>& data, uint32_t value) {
+    Append16(data, value & 0xffff);
+    Append16(data, value >> 16);
+  }
+
+  void Write32(std::vector<uint8_t>& data, size_t offset, uint32_t value) {
+    for (size_t i = 0; i < 4; i++) {
+      data[offset + i] = (value >> (8 * i)) & 0xff;
+    }
+  }
+
+  uint32_t Crc32(const uint8_t* data, size_t size) {
+    uint32_t crc = 0xffffffff;
+    for (size_t i = 0; i < size; i++) {
+      crc ^= data[i];
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+      }
+    }
+    return ~crc;
+  }
+
+  void UpdateCrc(std::vector<uint8_t>& pack) {
+    Write32(pack, 8, Crc32(pack.data() + HeaderSize, pack.size() - HeaderSize));
+  }
+
+  // rle_encode() of tools/imagepack/imagepack.py
+  std::vector<uint8_t> EncodeRle(const std::vector<uint8_t>& data, size_t unitSize) {
+    std::vector<uint8_t> output;
+    std::vector<uint8_t> literals;
+    auto flushLiterals = [&]() {
+      for (size_t start = 0; start < literals.size(); start += 128 * unitSize) {
+        const size_t size = std::min(literals.size() - start, 128 * unitSize);
+        output.push_back(size / unitSize - 1);
+        output.insert(output.end(), literals.begin() + start, literals.begin() + start + size);
+      }
+      literals.clear();
+    };
+
+    const size_t nbUnits = data.size() / unitSize;
+    auto same = [&](size_t a, size_t b) {
+      return std::equal(data.begin() + a * unitSize, data.begin() + (a + 1) * unitSize, data.begin() + b * unitSize);
+    };
+    for (size_t i = 0; i < nbUnits;) {
+      size_t run = 1;
+      while (i + run < nbUnits && run < 129 && same(i, i + run)) {
+        run++;
+      }
+      if (run >= 3) {
+        flushLiterals();
+        output.push_back(run + 126);
+        output.insert(output.end(), data.begin() + i * unitSize, data.begin() + (i + 1) * unitSize);
+      } else {
+        literals.insert(literals.end(), data.begin() + i * unitSize, data.begin() + (i + run) * unitSize);
+      }
+      i += run;
+    }
+    flushLiterals();
+    return output;
+  }
+
+  // The pack written by tools/imagepack/imagepack.py, see doc/ImageStore.md
+  std::vector<uint8_t> Pack(const std::vector<Image>& images, bool useRle) {
+    std::vector<uint8_t> index;
+    std::vector<uint8_t> data;
+    const size_t dataOffset = HeaderSize + EntrySize * images.size();
+    for (const auto& image : images) {
+      const size_t stride = image.rows[0].size();
+      const uint8_t rowsPerBand = std::min<size_t>(255, ImageStore::TileSize / stride);
+      const uint8_t bitsPerPixel = lv_img_cf_get_px_size(image.colorFormat);
+      const size_t unitSize = (bitsPerPixel >= 16) ? bitsPerPixel / 8 : 1;
+
+      std::vector<std::vector<uint8_t>> bands;
+      std::vector<uint8_t> raw;
+      for (size_t y = 0; y < image.height; y += rowsPerBand) {
+        bands.emplace_back();
+        for (size_t row = y; row < std::min<size_t>(y + rowsPerBand, image.height); row++) {
+          bands.back().insert(bands.back().end(), image.rows[row].begin(), image.rows[row].end());
+        }
+        raw.insert(raw.end(), bands.back().begin(), bands.back().end());
+      }
+
+      uint8_t compression = 0;
+      std::vector<uint8_t> pixels = raw;
+      if (useRle) {
+        std::vector<uint8_t> offsets;
+        std::vector<uint8_t> encoded;
+        for (const auto& band : bands) {
+          Append32(offsets, encoded.size());
+          const auto encodedBand = EncodeRle(band, unitSize);
+          encoded.insert(encoded.end(), encodedBand.begin(), encodedBand.end());
+        }
+        Append32(offsets, encoded.size());
+        offsets.insert(offsets.end(), encoded.begin(), encoded.end());
+        if (offsets.size() < raw.size()) {
+          compression = 1;
+          pixels = offsets;
+        }
+      }
+
+      const size_t offset = dataOffset + data.size();
+      data.insert(data.end(), image.palette.begin(), image.palette.end());
+      data.insert(data.end(), pixels.begin(), pixels.end());
+      char name[ImageStore::NameSize] {};
+      std::memcpy(name, image.name.data(), std::min(image.name.size(), sizeof(name)));
+      index.insert(index.end(), name, name + sizeof(name));
+      Append16(index, image.width);
+      Append16(index, image.height);
+      index.insert(index.end(), {image.colorFormat, compression, rowsPerBand, 0});
+      Append32(index, offset);
+      Append32(index, image.palette.size() + pixels.size());
+    }
+
+    std::vector<uint8_t> pack;
+    Append32(pack, Magic);
+    Append16(pack, 1);
+    Append16(pack, images.size());
+    Append32(pack, 0);
+    Append32(pack, 0);
+    pack.insert(pack.end(), index.begin(), index.end());
+    pack.insert(pack.end(), data.begin(), data.end());
+    UpdateCrc(pack);
+    return pack;
+  }
+
+  // Horizontal stripes of 3 colors, with a pseudo-random pixel every few ones: runs and literals
+  Image TrueColorImage(const std::string& name, uint16_t width, uint16_t height, bool withAlpha) {
+    const uint8_t pixelSize = withAlpha ? 3 : 2;
+    Image image {name, width, height, withAlpha ? LV_IMG_CF_TRUE_COLOR_ALPHA : LV_IMG_CF_TRUE_COLOR, {}, {}};
+    uint32_t seed = 1;
+    for (uint16_t y = 0; y < height; y++) {
+      std::vector<uint8_t> row;
+      for (uint16_t x = 0; x < width; x++) {
+        seed = seed * 1103515245 + 12345;
+        const uint16_t color = (x % 7 == 3) ? static_cast<uint16_t>(seed >> 16) : static_cast<uint16_t>(0x1234 * (y / 16 % 3));
+        row.push_back(color >> 8);
+        row.push_back(color & 0xff);
+        if (pixelSize == 3) {
+          row.push_back(x % 2 == 0 ? 0xff : 0x80);
+        }
+      }
+      image.rows.push_back(row);
+    }
+    return image;
+  }
+
+  Image IndexedImage(const std::string& name, uint16_t width, uint16_t height, lv_img_cf_t colorFormat) {
+    const uint8_t bitsPerPixel = lv_img_cf_get_px_size(colorFormat);
+    Image image {name, width, height, colorFormat, {}, {}};
+    for (int i = 0; i < (1 << bitsPerPixel); i++) {
+      // The last color is transparent
+      const bool transparent = i == (1 << bitsPerPixel) - 1;
+      image.palette.insert(image.palette.end(), {uint8_t(16 * i), uint8_t(255 - 16 * i), uint8_t(8 * i), uint8_t(transparent ? 0 : 255)});
+    }
+    for (uint16_t y = 0; y < height; y++) {
+      std::vector<uint8_t> row((width * bitsPerPixel + 7) / 8);
+      for (uint16_t x = 0; x < width; x++) {
+        const uint8_t index = ((x / 5 + y) % (1 << bitsPerPixel));
+        const uint32_t bit = x * bitsPerPixel;
+        row[bit / 8] |= index << (8 - bitsPerPixel - bit % 8);
+      }
+      image.rows.push_back(row);
+    }
+    return image;
+  }
+
+  // The pixels that LVGL gets from the decoder
+  std::vector<uint8_t> Expected(const Image& image) {
+    std::vector<uint8_t> pixels;
+    const uint8_t bitsPerPixel = lv_img_cf_get_px_size(image.colorFormat);
+    for (const auto& row : image.rows) {
+      if (bitsPerPixel >= 16) {
+        pixels.insert(pixels.end(), row.begin(), row.end());
+        continue;
+      }
+      for (uint16_t x = 0; x < image.width; x++) {
+        const uint32_t bit = x * bitsPerPixel;
+        const uint8_t index = (row[bit / 8] >> (8 - bitsPerPixel - bit % 8)) & ((1 << bitsPerPixel) - 1);
+        const uint8_t* color = &image.palette[index * 4];
+        const lv_color_t pixel = lv_color_make(color[2], color[1], color[0]);
+        pixels.push_back(pixel.full & 0xff);
+        pixels.push_back(pixel.full >> 8);
+        pixels.push_back(color[3]);
+      }
+    }
+    return pixels;
+  }
+
+  class ImageStoreTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+      imageStore.Init();
+      decoder = &Stubs::GetLvgl().decoders.back();
+    }
+
+    void Store(const std::vector<uint8_t>& pack) {
+      fs.Content(ImageStore::Path) = pack;
+    }
+
+    bool Info(const char* source, lv_img_header_t& header) {
+      return decoder->info_cb(decoder, source, &header) == LV_RES_OK;
+    }
+
+    // Like LVGL: the info, then each row is read by parts, and the image is closed
+    bool Decode(const char* source, std::vector<uint8_t>& pixels) {
+      lv_img_header_t header;
+      if (!Info(source, header)) {
+        return false;
+      }
+      lv_img_decoder_dsc_t dsc {decoder, source, header, nullptr, nullptr};
+      if (decoder->open_cb(decoder, &dsc) != LV_RES_OK) {
+        return false;
+      }
+      EXPECT_EQ(nullptr, dsc.img_data);
+
+      const size_t pixelSize = lv_img_cf_get_px_size(header.cf) / 8;
+      const lv_coord_t half = header.w / 2;
+      pixels.assign(header.w * header.h * pixelSize, 0);
+      bool ok = true;
+      for (lv_coord_t y = 0; ok && y < static_cast<lv_coord_t>(header.h); y++) {
+        uint8_t* row = pixels.data() + y * header.w * pixelSize;
+        ok = decoder->read_line_cb(decoder, &dsc, 0, y, half, row) == LV_RES_OK &&
+             decoder->read_line_cb(decoder, &dsc, half, y, header.w - half, row + half * pixelSize) == LV_RES_OK;
+      }
+      decoder->close_cb(decoder, &dsc);
+      return ok;
+    }
+
+    FS fs;
+    ImageStore imageStore {fs};
+    lv_img_decoder_t* decoder = nullptr;
+  };
+}
+
+TEST_F(ImageStoreTest, DecodesAllTheFormats) {
+  const std::vector<Image> images {TrueColorImage("color", 240, 20, false),
+                                   TrueColorImage("alpha", 100, 30, true),
+                                   IndexedImage("index1", 63, 70, LV_IMG_CF_INDEXED_1BIT),
+                                   IndexedImage("index2", 50, 9, LV_IMG_CF_INDEXED_2BIT),
+                                   IndexedImage("index4_name", 37, 41, LV_IMG_CF_INDEXED_4BIT)};
+  for (bool useRle : {false, true}) {
+    SCOPED_TRACE(useRle ? "RLE" : "raw");
+    Store(Pack(images, useRle));
+    for (const auto& image : images) {
+      SCOPED_TRACE(image.name);
+      const std::string source = "I:" + image.name;
+      lv_img_header_t header;
+      ASSERT_TRUE(Info(source.c_str(), header));
+      EXPECT_EQ(image.width, header.w);
+      EXPECT_EQ(image.height, header.h);
+      EXPECT_EQ(image.colorFormat == LV_IMG_CF_TRUE_COLOR ? LV_IMG_CF_TRUE_COLOR : LV_IMG_CF_TRUE_COLOR_ALPHA, header.cf);
+
+      std::vector<uint8_t> pixels;
+      ASSERT_TRUE(Decode(source.c_str(), pixels));
+      EXPECT_EQ(Expected(image), pixels);
+    }
+  }
+}
+
+TEST_F(ImageStoreTest, OnlyTheImagesOfThePack) {
+  lv_img_header_t header;
+  // No pack
+  EXPECT_FALSE(Info("I:color", header));
+
+  Store(Pack({TrueColorImage("color", 10, 10, false)}, true));
+  EXPECT_TRUE(Info("I:color", header));
+  EXPECT_FALSE(Info("I:other", header));
+  EXPECT_FALSE(Info("F:color", header));
+  // A symbol
+  EXPECT_FALSE(Info("\xef\x80\x81", header));
+}
+
+TEST_F(ImageStoreTest, ReloadsTheIndexOfAReplacedPack) {
+  Store(Pack({TrueColorImage("first", 10, 10, false)}, true));
+  std::vector<uint8_t> pixels;
+  ASSERT_TRUE(Decode("I:first", pixels));
+
+  const auto second = TrueColorImage("second", 20, 5, false);
+  Store(Pack({second}, true));
+  ASSERT_TRUE(Decode("I:second", pixels));
+  EXPECT_EQ(Expected(second), pixels);
+  lv_img_header_t header;
+  EXPECT_FALSE(Info("I:first", header));
+
+  // Deleted: the index is dropped when the pack is opened
+  fs.Delete(ImageStore::Path);
+  EXPECT_FALSE(Decode("I:second", pixels));
+  EXPECT_FALSE(Info("I:second", header));
+}
+
+TEST_F(ImageStoreTest, CorruptBandsAreNotDecoded) {
+  // A single color: each band of a row is a run of 129 pixels and a run of 111 pixels
+  Image image {"flat", 240, 4, LV_IMG_CF_TRUE_COLOR, {}, {}};
+  image.rows.assign(image.height, std::vector<uint8_t>(480, 0x42));
+  const auto pack = Pack({image}, true);
+  std::vector<uint8_t> pixels;
+  Store(pack);
+  ASSERT_TRUE(Decode("I:flat", pixels));
+
+  // The run of 111 pixels of the last band overflows the row
+  auto corrupt = pack;
+  corrupt[corrupt.size() - 3] = 0xff;
+  UpdateCrc(corrupt);
+  Store(corrupt);
+  EXPECT_FALSE(Decode("I:flat", pixels));
+
+  // The last band is truncated
+  corrupt = pack;
+  corrupt.resize(corrupt.size() - 1);
+  UpdateCrc(corrupt);
+  Store(corrupt);
+  EXPECT_FALSE(Decode("I:flat", pixels));
+}
+
+TEST_F(ImageStoreTest, RowsAreReadFromTheTiles) {
+  // 48 bytes per row, 10 rows per band: 3 bands
+  Store(Pack({TrueColorImage("color", 24, 30, false)}, true));
+  std::vector<uint8_t> pixels;
+  ASSERT_TRUE(Decode("I:color", pixels));
+  EXPECT_EQ(3u, imageStore.NbMisses());
+  EXPECT_EQ(2 * 30 - 3u, imageStore.NbHits());
+
+  // All the bands are still in the tiles
+  ASSERT_TRUE(Decode("I:color", pixels));
+  EXPECT_EQ(3u, imageStore.NbMisses());
+}
+
+TEST_F(ImageStoreTest, DecodesThePackOfTheFirmwareImages) {
+#if defined(PYTHON3_EXECUTABLE) && defined(IMAGEPACK) && defined(MUSIC_ICONS)
+  // The disc of the music app, packed by imagepack.py with and without RLE: both decode the same pixels
+  std::vector<std::vector<uint8_t>> decoded;
+  for (const char* option : {"", "--no-rle"}) {
+    const std::string packPath = ::testing::TempDir() + "images.bin";
+    std::string command = std::string("\"") + PYTHON3_EXECUTABLE + "\" \"" + IMAGEPACK + "\" pack \"" + packPath + "\"";
+    for (const char* name : {"disc", "disc_f_1", "disc_f_2"}) {
+      command += std::string(" ") + name + ":indexed1:\"" + MUSIC_ICONS + "/" + name + ".png\"";
+    }
+    command += std::string(" ") + option + " > /dev/null";
+    ASSERT_EQ(0, std::system(command.c_str()));
+
+    std::ifstream file(packPath, std::ios::binary);
+    Store({std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()});
+    for (const char* source : {"I:disc", "I:disc_f_1", "I:disc_f_2"}) {
+      decoded.emplace_back();
+      ASSERT_TRUE(Decode(source, decoded.back())) << source;
+    }
+  }
+  for (size_t i = 0; i < 3; i++) {
+    EXPECT_FALSE(decoded[i].empty());
+    EXPECT_EQ(decoded[i], decoded[i + 3]);
+  }
+#else
+  GTEST_SKIP() << "Python 3 not found";
+#endif
+}
+
+TEST_F(ImageStoreTest, CostOfTheLookupAndOfTheDecoding) {
+  // A full pack, looked up by the name of its last image
+  std::vector<Image> images;
+  for (size_t i = 0; i < ImageStore::MaxImages; i++) {
+    images.push_back(IndexedImage("image" + std::to_string(i), 16, 16, LV_IMG_CF_INDEXED_1BIT));
+  }
+  Store(Pack(images, true));
+  lv_img_header_t header;
+  constexpr int nbLookups = 100000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < nbLookups; i++) {
+    ASSERT_TRUE(Info("I:image15", header));
+  }
+  const auto lookup = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / nbLookups;
+
+  // A 240x240 true color frame, decoded from the RLE and from the raw pack, and copied from RAM as a reference
+  const auto frame = TrueColorImage("frame", 240, 240, false);
+  const auto expected = Expected(frame);
+  constexpr int nbFrames = 20;
+  std::vector<uint8_t> pixels;
+  double decodingUs[2];
+  size_t bytesRead[2];
+  size_t packSize[2];
+  uint32_t nbReads[2];
+  for (bool useRle : {false, true}) {
+    const auto pack = Pack({frame}, useRle);
+    Store(pack);
+    packSize[useRle] = pack.size();
+    fs.bytesRead = 0;
+    fs.nbReads = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < nbFrames; i++) {
+      ASSERT_TRUE(Decode("I:frame", pixels));
+    }
+    decodingUs[useRle] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / nbFrames;
+    bytesRead[useRle] = fs.bytesRead / nbFrames;
+    nbReads[useRle] = fs.nbReads / nbFrames;
+    EXPECT_EQ(expected, pixels);
+  }
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < nbFrames; i++) {
+    pixels.assign(expected.size(), 0);
+    for (size_t y = 0; y < frame.height; y++) {
+      std::memcpy(pixels.data() + y * 480, expected.data() + y * 480, 480);
+    }
+  }
+  const double copyUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / nbFrames;
+  const double hitRate = 100.0 * imageStore.NbHits() / (imageStore.NbHits() + imageStore.NbMisses());
+
+  // The RLE pack is smaller, and so are the reads from the flash
+  EXPECT_LT(packSize[true], packSize[false]);
+  EXPECT_LT(bytesRead[true], bytesRead[false]);
+
+  RecordProperty("lookup_ns", static_cast<int>(lookup));
+  RecordProperty("decode_raw_us", static_cast<int>(decodingUs[false]));
+  RecordProperty("decode_rle_us", static_cast<int>(decodingUs[true]));
+  RecordProperty("copy_us", static_cast<int>(copyUs));
+  std::cout << "Lookup in a pack of " << ImageStore::MaxImages << " images: " << lookup << "ns. 240x240 frame: raw "
+            << decodingUs[false] << "us (" << bytesRead[false] << " bytes in " << nbReads[false] << " reads), RLE "
+            << decodingUs[true] << "us (" << bytesRead[true] << " bytes in " << nbReads[true] << " reads), copy from RAM "
+            << copyUs << "us. Pack " << packSize[false] << " bytes raw, " << packSize[true] << " RLE. Tile hits "
+            << hitRate << "%" << std::endl;
+}
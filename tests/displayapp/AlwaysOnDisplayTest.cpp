@@ -0,0 +1,121 @@
+#include "displayapp/AlwaysOnDisplay.h"
+#include "components/datetime/DateTimeController.h"
+#include "components/settings/Settings.h"
+#include "drivers/St7789.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+using Pinetime::Applications::AlwaysOnDisplay;
+
+namespace {
+  constexpr size_t DigitBytes = 40 * AlwaysOnDisplay::NbLines * 2;
+  constexpr size_t ClockBytes = AlwaysOnDisplay::Width * AlwaysOnDisplay::NbLines * 2;
+
+  class AlwaysOnDisplayTest : public ::testing::Test {
+  protected:
+    // The area of the clock in the frame memory matches a full render of these digits
+    void ExpectClock(const std::array<uint8_t, AlwaysOnDisplay::NbDigits>& digits) {
+      std::vector<uint16_t> reference(AlwaysOnDisplay::Width * AlwaysOnDisplay::NbLines);
+      AlwaysOnDisplay::Render(digits, 0, AlwaysOnDisplay::Width, 0, AlwaysOnDisplay::NbLines, reference.data());
+      const uint16_t* clock = &lcd.frame[AlwaysOnDisplay::FirstLine * AlwaysOnDisplay::Width];
+      const auto mismatch = std::mismatch(reference.begin(), reference.end(), clock);
+      ASSERT_TRUE(mismatch.first == reference.end())
+        << "at " << (mismatch.first - reference.begin()) % AlwaysOnDisplay::Width << ","
+        << (mismatch.first - reference.begin()) / AlwaysOnDisplay::Width << " for " << int(digits[0]) << int(digits[1]) << ":"
+        << int(digits[2]) << int(digits[3]);
+    }
+
+    Pinetime::Drivers::St7789 lcd;
+    Pinetime::Controllers::DateTime dateTime;
+    Pinetime::Controllers::Settings settings;
+    AlwaysOnDisplay display {lcd, dateTime, settings};
+  };
+}
+
+TEST_F(AlwaysOnDisplayTest, EnterDrawsTheWholeClockInLowPowerMode) {
+  dateTime.SetTime(12, 34);
+  lcd.scrollStartAddress = 120;
+  display.Enter();
+
+  EXPECT_TRUE(display.IsActive());
+  EXPECT_TRUE(lcd.lowPower);
+  EXPECT_EQ(0, lcd.scrollStartAddress);
+  EXPECT_EQ(static_cast<uint16_t>(AlwaysOnDisplay::FirstLine), lcd.firstLine);
+  EXPECT_EQ(AlwaysOnDisplay::FirstLine + AlwaysOnDisplay::NbLines - 1, lcd.lastLine);
+  EXPECT_EQ(ClockBytes, display.NbBytesWritten());
+  ExpectClock({{1, 2, 3, 4}});
+}
+
+TEST_F(AlwaysOnDisplayTest, EachUpdateOnlyDrawsTheDigitsThatChanged) {
+  dateTime.SetTime(9, 59);
+  display.Enter();
+
+  dateTime.SetTime(10, 0);
+  display.Update();
+  EXPECT_EQ(ClockBytes + 4 * DigitBytes, display.NbBytesWritten());
+  ExpectClock({{1, 0, 0, 0}});
+
+  dateTime.SetTime(10, 1);
+  display.Update();
+  EXPECT_EQ(ClockBytes + 5 * DigitBytes, display.NbBytesWritten());
+
+  // Same time: nothing is written
+  display.Update();
+  EXPECT_EQ(ClockBytes + 5 * DigitBytes, display.NbBytesWritten());
+}
+
+TEST_F(AlwaysOnDisplayTest, EveryMinuteOfADayMatchesAFullRedraw) {
+  dateTime.SetTime(0, 0);
+  display.Enter();
+  size_t bytesInPreviousHours = display.NbBytesWritten();
+
+  for (uint16_t minute = 1; minute <= 24 * 60; minute++) {
+    const uint8_t hours = (minute / 60) % 24;
+    const uint8_t minutes = minute % 60;
+    dateTime.SetTime(hours, minutes);
+    display.Update();
+    ExpectClock({{static_cast<uint8_t>(hours / 10),
+                  static_cast<uint8_t>(hours % 10),
+                  static_cast<uint8_t>(minutes / 10),
+                  static_cast<uint8_t>(minutes % 10)}});
+    if (HasFatalFailure()) {
+      return;
+    }
+
+    if (minutes == 0) {
+      // 60 units of minutes, 6 tens of minutes, and 1 or 2 digits of the hours (doc/AlwaysOnDisplay.md)
+      const size_t bytesInHour = display.NbBytesWritten() - bytesInPreviousHours;
+      EXPECT_GE(bytesInHour, 67 * DigitBytes);
+      EXPECT_LE(bytesInHour, 68 * DigitBytes);
+      bytesInPreviousHours = display.NbBytesWritten();
+    }
+  }
+  std::cout << "Always-on display: " << (display.NbBytesWritten() - ClockBytes) / 24 << " bytes per hour on average"
+            << std::endl;
+}
+
+TEST_F(AlwaysOnDisplayTest, TwelveHourClock) {
+  settings.SetClockType(Pinetime::Controllers::Settings::ClockType::H12);
+  dateTime.SetTime(13, 5);
+  display.Enter();
+  ExpectClock({{0, 1, 0, 5}});
+
+  dateTime.SetTime(0, 7);
+  display.Update();
+  ExpectClock({{1, 2, 0, 7}});
+}
+
+TEST_F(AlwaysOnDisplayTest, ExitLeavesTheLowPowerMode) {
+  dateTime.SetTime(8, 0);
+  display.Enter();
+  display.Exit();
+  EXPECT_FALSE(display.IsActive());
+  EXPECT_FALSE(lcd.lowPower);
+
+  // Inactive: the frame memory belongs to LVGL again
+  const size_t written = lcd.nbBytesWritten;
+  dateTime.SetTime(8, 1);
+  display.Update();
+  EXPECT_EQ(written, lcd.nbBytesWritten);
+}
@@ -0,0 +1,285 @@
+#include "displayapp/widgets/ClockHand.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using Pinetime::Applications::Widgets::ClockHand;
+
+namespace {
+  // LV_INV_BUF_SIZE of LVGL
+  constexpr size_t MaxInvalidAreas = 32;
+  constexpr lv_area_t screenArea {0, 0, LV_HOR_RES - 1, LV_VER_RES - 1};
+
+  uint32_t Size(const lv_area_t& area) {
+    return (area.x2 - area.x1 + 1) * (area.y2 - area.y1 + 1);
+  }
+
+  bool Contains(const lv_area_t& area, lv_coord_t x, lv_coord_t y) {
+    return x >= area.x1 && x <= area.x2 && y >= area.y1 && y <= area.y2;
+  }
+
+  bool Contains(const lv_area_t& area, const lv_area_t& other) {
+    return other.x1 >= area.x1 && other.y1 >= area.y1 && other.x2 <= area.x2 && other.y2 <= area.y2;
+  }
+
+  // What LVGL redraws from the areas invalidated since the last refresh (lv_inv_area() and lv_refr_join_area() of
+  // lv_refr.c): the areas are clipped to the screen and dropped when another one contains them, the whole screen is
+  // redrawn beyond MaxInvalidAreas, and two overlapping areas are joined when their union is smaller than both.
+  uint32_t RedrawnPixels(const std::vector<lv_area_t>& invalidated) {
+    std::vector<lv_area_t> areas;
+    for (const auto& area : invalidated) {
+      const lv_area_t clipped {std::max(area.x1, screenArea.x1),
+                               std::max(area.y1, screenArea.y1),
+                               std::min(area.x2, screenArea.x2),
+                               std::min(area.y2, screenArea.y2)};
+      if (clipped.x1 > clipped.x2 || clipped.y1 > clipped.y2 ||
+          std::any_of(areas.begin(), areas.end(), [&](const lv_area_t& a) { return Contains(a, clipped); })) {
+        continue;
+      }
+      if (areas.size() == MaxInvalidAreas) {
+        areas = {screenArea};
+        continue;
+      }
+      areas.push_back(clipped);
+    }
+
+    std::vector<bool> joined(areas.size(), false);
+    for (size_t in = 0; in < areas.size(); in++) {
+      for (size_t from = 0; !joined[in] && from < areas.size(); from++) {
+        const auto& a = areas[in];
+        const auto& b = areas[from];
+        if (joined[from] || in == from || a.x1 > b.x2 || a.x2 < b.x1 || a.y1 > b.y2 || a.y2 < b.y1) {
+          continue;
+        }
+        const lv_area_t joinedArea {std::min(a.x1, b.x1), std::min(a.y1, b.y1), std::max(a.x2, b.x2), std::max(a.y2, b.y2)};
+        if (Size(joinedArea) < Size(a) + Size(b)) {
+          areas[in] = joinedArea;
+          joined[from] = true;
+        }
+      }
+    }
+    uint32_t pixels = 0;
+    for (size_t i = 0; i < areas.size(); i++) {
+      pixels += joined[i] ? 0 : Size(areas[i]);
+    }
+    return pixels;
+  }
+
+  // A hand of the face before ClockHand, with the coordinates it computed (CoordinateRelocate()). An lv_line at (0, 0)
+  // is resized to its largest coordinates plus the line width by lv_line_set_points(), and invalidated with a padding of
+  // the line width: its old and new areas when its size changes, then its new area.
+  class LineHand {
+  public:
+    LineHand(int16_t innerRadius, int16_t outerRadius, lv_coord_t width)
+      : innerRadius {innerRadius}, outerRadius {outerRadius}, width {width} {
+    }
+
+    void SetAngle(int16_t angle, std::vector<lv_area_t>& invalidated) {
+      const lv_point_t start = Point(innerRadius, angle);
+      const lv_point_t end = Point(outerRadius, angle);
+      const lv_coord_t newWidth = std::max(start.x, end.x) + width;
+      const lv_coord_t newHeight = std::max(start.y, end.y) + width;
+      if (newWidth != objectWidth || newHeight != objectHeight) {
+        invalidated.push_back(Area());
+        objectWidth = newWidth;
+        objectHeight = newHeight;
+        invalidated.push_back(Area());
+      }
+      invalidated.push_back(Area());
+    }
+
+  private:
+    static lv_point_t Point(int16_t radius, int16_t angle) {
+      const int32_t scale = _lv_trigo_sin(90);
+      return {static_cast<lv_coord_t>(radius * static_cast<int32_t>(_lv_trigo_sin(angle)) / scale + LV_HOR_RES / 2),
+              static_cast<lv_coord_t>(std::abs(radius * static_cast<int32_t>(_lv_trigo_sin(angle + 90)) / scale - LV_HOR_RES / 2))};
+    }
+
+    lv_area_t Area() const {
+      return {static_cast<lv_coord_t>(-width),
+              static_cast<lv_coord_t>(-width),
+              static_cast<lv_coord_t>(objectWidth - 1 + width),
+              static_cast<lv_coord_t>(objectHeight - 1 + width)};
+    }
+
+    int16_t innerRadius;
+    int16_t outerRadius;
+    lv_coord_t width;
+    lv_coord_t objectWidth = 0;
+    lv_coord_t objectHeight = 0;
+  };
+
+  // The hands of WatchFaceAnalog: hour, hour trace, minute, minute trace, second
+  template <class Hand> struct Face {
+    Hand hands[5];
+    int hour = -1;
+    int minute = -1;
+    int second = -1;
+
+    // WatchFaceAnalog::UpdateClock()
+    template <class... Args> void Update(int newHour, int newMinute, int newSecond, Args&... args) {
+      if (newMinute != minute) {
+        hands[2].SetAngle(newMinute * 6, args...);
+        hands[3].SetAngle(newMinute * 6, args...);
+      }
+      if (newHour != hour || newMinute != minute) {
+        hour = newHour;
+        minute = newMinute;
+        hands[0].SetAngle(newHour * 30 + newMinute / 2, args...);
+        hands[1].SetAngle(newHour * 30 + newMinute / 2, args...);
+      }
+      if (newSecond != second) {
+        second = newSecond;
+        hands[4].SetAngle(newSecond * 6, args...);
+      }
+    }
+  };
+
+  // Whether the pixels of the line, with its width, are in the areas
+  bool IsCovered(const std::vector<lv_area_t>& areas, lv_point_t start, lv_point_t end, lv_coord_t width) {
+    const int nbSteps = std::max(std::abs(end.x - start.x), std::abs(end.y - start.y));
+    const lv_coord_t halfWidth = width / 2;
+    for (int step = 0; step <= nbSteps; step++) {
+      const lv_coord_t x = start.x + (end.x - start.x) * step / std::max(nbSteps, 1);
+      const lv_coord_t y = start.y + (end.y - start.y) * step / std::max(nbSteps, 1);
+      for (lv_coord_t dx = -halfWidth; dx <= halfWidth; dx++) {
+        for (lv_coord_t dy = -halfWidth; dy <= halfWidth; dy++) {
+          if (std::none_of(areas.begin(), areas.end(), [&](const lv_area_t& a) { return Contains(a, x + dx, y + dy); })) {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  class ClockHandTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+      Stubs::GetLvgl() = {};
+      lv_obj_set_size(&screen, LV_HOR_RES, LV_VER_RES);
+    }
+
+    // The line drawn by the hand
+    Stubs::Lvgl::Line Draw(lv_obj_t* object) {
+      Stubs::GetLvgl().lines.clear();
+      EXPECT_EQ(LV_DESIGN_RES_NOT_COVER, object->design_cb(object, &screenArea, LV_DESIGN_COVER_CHK));
+      EXPECT_EQ(LV_DESIGN_RES_OK, object->design_cb(object, &screenArea, LV_DESIGN_DRAW_MAIN));
+      EXPECT_EQ(1u, Stubs::GetLvgl().lines.size());
+      return Stubs::GetLvgl().lines.empty() ? Stubs::Lvgl::Line {} : Stubs::GetLvgl().lines[0];
+    }
+
+    lv_obj_t screen {nullptr, 0, 0, 0, 0, false, nullptr, nullptr, false};
+  };
+}
+
+TEST_F(ClockHandTest, DrawsTheLineFromTheCenter) {
+  ClockHand hand {-20, 110, 3, lv_color_make(255, 0, 0), true};
+  hand.Create(&screen);
+  lv_obj_t* object = &Stubs::GetLvgl().objects.back();
+  EXPECT_EQ(Size(screenArea), Size(object->coords));
+
+  // Not drawn before the first angle
+  Stubs::GetLvgl().lines.clear();
+  object->design_cb(object, &screenArea, LV_DESIGN_DRAW_MAIN);
+  EXPECT_TRUE(Stubs::GetLvgl().lines.empty());
+
+  hand.SetAngle(0);
+  auto line = Draw(object);
+  EXPECT_EQ(120, line.start.x);
+  EXPECT_EQ(140, line.start.y);
+  EXPECT_EQ(120, line.end.x);
+  EXPECT_EQ(10, line.end.y);
+  EXPECT_EQ(3, line.width);
+
+  hand.SetAngle(90);
+  line = Draw(object);
+  EXPECT_EQ(100, line.start.x);
+  EXPECT_EQ(120, line.start.y);
+  EXPECT_EQ(230, line.end.x);
+  EXPECT_EQ(120, line.end.y);
+}
+
+TEST_F(ClockHandTest, InvalidatesTheOldAndTheNewLines) {
+  ClockHand hand {30, 90, 7, lv_color_make(255, 255, 255), true};
+  hand.Create(&screen);
+  lv_obj_t* object = &Stubs::GetLvgl().objects.back();
+  auto& invalidated = Stubs::GetLvgl().invalidated;
+
+  hand.SetAngle(0);
+  auto previous = Draw(object);
+  for (int16_t angle = 6; angle <= 360; angle += 6) {
+    invalidated.clear();
+    hand.SetAngle(angle % 360);
+    const auto line = Draw(object);
+    EXPECT_TRUE(IsCovered(invalidated, previous.start, previous.end, line.width)) << angle;
+    EXPECT_TRUE(IsCovered(invalidated, line.start, line.end, line.width)) << angle;
+    previous = line;
+  }
+
+  // Same angle: nothing to redraw
+  invalidated.clear();
+  hand.SetAngle(0);
+  EXPECT_TRUE(invalidated.empty());
+}
+
+TEST_F(ClockHandTest, CostOfAnHourOfTheAnalogFace) {
+  // Areas and time to update the hands each second from 10:00:00 to 10:59:59. The time only covers the computation of
+  // the hands and of their areas: drawing them is proportional to the redrawn pixels.
+  constexpr int nbSeconds = 3600;
+  constexpr int nbRounds = 20;
+  const lv_color_t white = lv_color_make(255, 255, 255);
+  const lv_color_t red = lv_color_make(255, 0, 0);
+
+  Face<LineHand> lineFace {{{30, 70, 7}, {5, 31, 3}, {30, 90, 7}, {5, 31, 3}, {-20, 110, 3}}};
+  Face<ClockHand> handFace {{{30, 70, 7, white, true},
+                             {5, 31, 3, white, false},
+                             {30, 90, 7, white, true},
+                             {5, 31, 3, white, false},
+                             {-20, 110, 3, red, true}}};
+  for (auto& hand : handFace.hands) {
+    hand.Create(&screen);
+  }
+  std::vector<lv_area_t> invalidated;
+  lineFace.Update(9, 59, 59, invalidated);
+  handFace.Update(9, 59, 59);
+
+  uint64_t linePixels = 0;
+  uint64_t handPixels = 0;
+  size_t maxAreas = 0;
+  std::chrono::duration<double, std::nano> lineTime {0};
+  std::chrono::duration<double, std::nano> handTime {0};
+  for (int round = 0; round < nbRounds; round++) {
+    for (int second = 0; second < nbSeconds; second++) {
+      const int hour = (round % 2 == 0) ? 10 : 9;
+      invalidated.clear();
+      auto start = std::chrono::steady_clock::now();
+      lineFace.Update(hour, second / 60, second % 60, invalidated);
+      lineTime += std::chrono::steady_clock::now() - start;
+
+      Stubs::GetLvgl().invalidated.clear();
+      start = std::chrono::steady_clock::now();
+      handFace.Update(hour, second / 60, second % 60);
+      handTime += std::chrono::steady_clock::now() - start;
+
+      if (round == 0) {
+        linePixels += RedrawnPixels(invalidated);
+        handPixels += RedrawnPixels(Stubs::GetLvgl().invalidated);
+        maxAreas = std::max(maxAreas, Stubs::GetLvgl().invalidated.size());
+      }
+    }
+  }
+
+  // Moving all the hands at once doesn't redraw the whole screen
+  EXPECT_LE(maxAreas, MaxInvalidAreas);
+  EXPECT_LT(handPixels, linePixels);
+
+  const double updates = static_cast<double>(nbSeconds) * nbRounds;
+  RecordProperty("lv_line_pixels_per_second", static_cast<int>(linePixels / nbSeconds));
+  RecordProperty("clock_hand_pixels_per_second", static_cast<int>(handPixels / nbSeconds));
+  std::cout << "Analog face, pixels redrawn per second: lv_line " << linePixels / nbSeconds << ", ClockHand "
+            << handPixels / nbSeconds << " (at most " << maxAreas << " areas). Update of the hands: lv_line "
+            << lineTime.count() / updates << "ns, ClockHand " << handTime.count() / updates << "ns" << std::endl;
+}
@@ -0,0 +1,166 @@
+#include "displayapp/FrameMemory.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdlib>
+#include <iostream>
+
+using Pinetime::Components::FrameMemory;
+
+namespace {
+  constexpr uint16_t TotalNbLines = FrameMemory::TotalNbLines;
+  constexpr uint16_t VisibleNbLines = FrameMemory::VisibleNbLines;
+  constexpr uint16_t MaxScrollLines = FrameMemory::MaxScrollLines;
+  constexpr size_t BytesPerLine = 240 * 2;
+
+  // Frame memory of the ST7789 scrolled through a long list: each line holds the index of the line of the list drawn
+  // into it. Line y of the screen shows line top + y of the list.
+  class Display {
+  public:
+    // Redraws the whole screen, like LittleVgl after SetFullRefresh()
+    void FullRedraw() {
+      mapping.CancelScroll();
+      Draw(0, VisibleNbLines - 1);
+    }
+
+    // Scrolls the list by lines like VerticalScroller, with LittleVgl::ScrollDisplay(). Returns false if the whole
+    // screen had to be redrawn.
+    bool Scroll(int16_t lines) {
+      FrameMemory::Strip strip;
+      top += lines;
+      if (!mapping.Scroll(lines, strip)) {
+        FullRedraw();
+        return false;
+      }
+      Draw(strip.firstLine, strip.lastLine);
+      // The strip was drawn in the lines that are not displayed: the screen still shows the list before the scroll
+      ExpectScreen(top - lines);
+      EXPECT_TRUE(mapping.ApplyScroll());
+      return true;
+    }
+
+    // Checks the lines shown by the display, from its vertical scroll start address, against a full redraw
+    void ExpectScreen(int expectedTop) const {
+      for (uint16_t y = 0; y < VisibleNbLines; y++) {
+        ASSERT_EQ(expectedTop + y, frame[(mapping.ScrollOffset() + y) % TotalNbLines]) << "line " << y;
+      }
+    }
+
+    void ExpectScreen() const {
+      ExpectScreen(top);
+    }
+
+    size_t NbBytesWritten() const {
+      return nbBytesWritten;
+    }
+
+    FrameMemory mapping;
+
+  private:
+    void Draw(uint16_t firstLine, uint16_t lastLine) {
+      for (uint16_t y = firstLine; y <= lastLine; y++) {
+        frame[mapping.FrameLine(y)] = top + y;
+      }
+      nbBytesWritten += (lastLine - firstLine + 1) * BytesPerLine;
+    }
+
+    int top = 1000;
+    std::array<int, TotalNbLines> frame {};
+    size_t nbBytesWritten = 0;
+  };
+}
+
+TEST(FrameMemoryTest, ScrollsLikeAFullRedraw) {
+  Display display;
+  display.FullRedraw();
+  display.ExpectScreen();
+
+  // Steps of a scroll in both directions, larger than the lines that are not displayed, through the wrap of the offsets
+  const int16_t steps[] = {1, 5, 80, 80, 37, -1, -80, -13, 79, 80, 80, 80, 80, -80, -80, -80, -80, -80, 3};
+  for (auto lines : steps) {
+    EXPECT_TRUE(display.Scroll(lines));
+    display.ExpectScreen();
+  }
+}
+
+TEST(FrameMemoryTest, BytesPushedPerScrollStep) {
+  std::srand(42);
+  Display display;
+  display.FullRedraw();
+  const size_t fullRedrawBytes = display.NbBytesWritten();
+  ASSERT_EQ(VisibleNbLines * BytesPerLine, fullRedrawBytes);
+
+  // Random drags of a list, the size of a touch panel event (up to 20 lines per frame)
+  constexpr int nbSteps = 2000;
+  size_t scrolledLines = 0;
+  for (int i = 0; i < nbSteps; i++) {
+    const int16_t lines = static_cast<int16_t>(std::rand() % 41 - 20);
+    if (lines == 0) {
+      continue;
+    }
+    EXPECT_TRUE(display.Scroll(lines));
+    display.ExpectScreen();
+    scrolledLines += std::abs(lines);
+  }
+
+  const size_t scrollBytes = display.NbBytesWritten() - fullRedrawBytes;
+  EXPECT_EQ(scrolledLines * BytesPerLine, scrollBytes);
+  std::cout << "FrameMemory: " << scrollBytes / nbSteps << " bytes pushed per scroll step on average, " << fullRedrawBytes
+            << " for a full redraw" << std::endl;
+}
+
+TEST(FrameMemoryTest, RejectsTheScrollsThatDoNotFit) {
+  FrameMemory mapping;
+  FrameMemory::Strip strip {};
+  EXPECT_FALSE(mapping.Scroll(0, strip));
+  EXPECT_FALSE(mapping.Scroll(static_cast<int16_t>(MaxScrollLines + 1), strip));
+  EXPECT_FALSE(mapping.Scroll(static_cast<int16_t>(-MaxScrollLines - 1), strip));
+  EXPECT_FALSE(mapping.IsScrollPending());
+
+  EXPECT_TRUE(mapping.Scroll(10, strip));
+  EXPECT_EQ(230, strip.firstLine);
+  EXPECT_EQ(239, strip.lastLine);
+  // The strip of the first scroll is not drawn yet
+  EXPECT_FALSE(mapping.Scroll(10, strip));
+  EXPECT_TRUE(mapping.ApplyScroll());
+  EXPECT_FALSE(mapping.ApplyScroll());
+
+  EXPECT_TRUE(mapping.Scroll(-10, strip));
+  EXPECT_EQ(0, strip.firstLine);
+  EXPECT_EQ(9, strip.lastLine);
+}
+
+TEST(FrameMemoryTest, FullRedrawCancelsThePendingScroll) {
+  Display display;
+  display.FullRedraw();
+  ASSERT_TRUE(display.Scroll(40));
+
+  // A scroll that doesn't fit falls back to a full redraw, at the current scroll of the display
+  FrameMemory::Strip strip;
+  ASSERT_TRUE(display.mapping.Scroll(20, strip));
+  const uint16_t scrollOffset = display.mapping.ScrollOffset();
+  EXPECT_FALSE(display.Scroll(100));
+  EXPECT_FALSE(display.mapping.IsScrollPending());
+  EXPECT_EQ(scrollOffset, display.mapping.ScrollOffset());
+  display.ExpectScreen();
+
+  EXPECT_TRUE(display.Scroll(-30));
+  display.ExpectScreen();
+}
+
+TEST(FrameMemoryTest, MovesTheOffsetsAcrossTheWrap) {
+  FrameMemory mapping;
+  mapping.MoveWriteOffset(-static_cast<int16_t>(VisibleNbLines));
+  EXPECT_EQ(80, mapping.FrameLine(0));
+  EXPECT_EQ(79, mapping.FrameLine(319));
+  mapping.MoveWriteOffset(VisibleNbLines);
+  EXPECT_EQ(0, mapping.FrameLine(0));
+
+  mapping.MoveScrollOffset(-1);
+  EXPECT_EQ(319, mapping.ScrollOffset());
+  mapping.MoveScrollOffset(2);
+  EXPECT_EQ(1, mapping.ScrollOffset());
+
+  mapping.Reset();
+  EXPECT_EQ(0, mapping.ScrollOffset());
+  EXPECT_EQ(5, mapping.FrameLine(5));
+}
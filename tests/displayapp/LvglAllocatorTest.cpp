@@ -0,0 +1,620 @@
+#include "displayapp/LvglAllocator.h"
+#include "displayapp/Apps.h"
+#include "displayapp/ScreenCache.h"
+#include <gtest/gtest.h>
+#include <dirent.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using Pinetime::Applications::Apps;
+using Pinetime::Applications::ScreenCache;
+using Pinetime::Components::LvglAllocator;
+
+namespace {
+  // LV_MEM_SIZE, and the size classes of LittleVgl.cpp. The objects are larger on the host (64 bits pointers).
+  constexpr size_t MemorySize = 14 * 1024;
+  constexpr LvglAllocator::SizeClasses FirmwareClasses {{{16, 64}, {32, 48}, {48, 40}, {96, 48}}};
+  // The built-in allocator of LVGL: a single first-fit pool
+  constexpr LvglAllocator::SizeClasses SinglePool {{{16, 0}, {32, 0}, {48, 0}, {96, 0}}};
+
+  // Line of an allocation trace (see lvgl-traces/README.md)
+  struct Operation {
+    enum class Types { Allocate, Free, OpenApp };
+    Types type;
+    // Block (NoBlock if the allocation failed on the watch), or app
+    uint32_t id;
+    uint32_t size;
+  };
+  constexpr uint32_t NoBlock = UINT32_MAX;
+
+  std::vector<Operation> Parse(std::istream& input) {
+    std::vector<Operation> operations;
+    std::string line;
+    while (std::getline(input, line)) {
+      std::istringstream fields(line);
+      char type = 0;
+      fields >> type;
+      Operation operation {Operation::Types::Allocate, NoBlock, 0};
+      switch (type) {
+        case 'a':
+          fields >> operation.id >> operation.size;
+          break;
+        case 'x':
+          fields >> operation.size;
+          break;
+        case 'f':
+          operation.type = Operation::Types::Free;
+          fields >> operation.id;
+          break;
+        case 'o':
+          operation.type = Operation::Types::OpenApp;
+          fields >> operation.id;
+          break;
+        default:
+          // Empty line or comment
+          continue;
+      }
+      EXPECT_FALSE(fields.fail()) << "invalid line: " << line;
+      operations.push_back(operation);
+    }
+    return operations;
+  }
+
+  // Allocations of LVGL on the watch (32 bits), with the header that LVGL adds to the blocks (see LittleVgl.cpp)
+  constexpr uint32_t Header = 4;
+  constexpr uint32_t ObjectSize = 64 + Header;
+  constexpr uint32_t LocalStyleSize = 4 + Header;
+  constexpr uint32_t LabelDataSize = 40 + Header;
+  constexpr uint32_t ImageDataSize = 28 + Header;
+  constexpr uint32_t ButtonDataSize = 8 + Header;
+  constexpr uint32_t PageDataSize = 56 + Header;
+  constexpr uint32_t TableDataSize = 48 + Header;
+  constexpr uint32_t ChartDataSize = 96 + Header;
+  // Nodes of the linked lists of LVGL (lv_ll_t): 8 bytes of links after the item
+  constexpr uint32_t ChartSeriesSize = 16 + 8 + Header;
+  constexpr uint32_t TaskSize = 28 + 8 + Header;
+  constexpr uint32_t AnimationSize = 60 + 8 + Header;
+
+  constexpr uint32_t StyleMapSize(uint32_t nbProperties) {
+    // A 2 bytes ID and (mostly) a 4 bytes value for each property, and the end marker
+    return nbProperties * 6 + 2 + Header;
+  }
+
+  constexpr uint32_t TextSize(uint32_t length) {
+    return length + 1 + Header;
+  }
+
+  // The buffers of lv_mem_buf_get(), kept in the general pool once a screen was drawn with them: a line of a full-width
+  // image with alpha, and two lines of masks. An app may be the first to need them.
+  constexpr uint32_t DrawBuffersSize = (240 * 3 + Header) + 2 * (240 + Header);
+
+  // Builds an allocation trace
+  class Session {
+  public:
+    uint32_t Allocate(uint32_t size) {
+      operations.push_back({Operation::Types::Allocate, static_cast<uint32_t>(sizes.size()), size});
+      sizes.push_back(size);
+      return operations.back().id;
+    }
+
+    void Free(uint32_t id) {
+      operations.push_back({Operation::Types::Free, id, 0});
+    }
+
+    // lv_mem_realloc() with LV_MEM_CUSTOM: the data is copied to a new block unless the size is the same
+    uint32_t Reallocate(uint32_t id, uint32_t size) {
+      if (sizes[id] == size) {
+        return id;
+      }
+      const uint32_t newId = Allocate(size);
+      Free(id);
+      return newId;
+    }
+
+    void OpenApp(Apps app) {
+      operations.push_back({Operation::Types::OpenApp, static_cast<uint32_t>(app), 0});
+    }
+
+    const std::vector<Operation>& Operations() const {
+      return operations;
+    }
+
+  private:
+    std::vector<Operation> operations;
+    std::vector<uint32_t> sizes;
+  };
+
+  // The blocks of the objects of a screen, freed in the reverse order when the screen is deleted, like lv_obj_del()
+  // deletes the children first
+  class ModelScreen {
+  public:
+    explicit ModelScreen(Session& session) : session {session} {
+    }
+
+    ModelScreen(const ModelScreen&) = delete;
+    ModelScreen& operator=(const ModelScreen&) = delete;
+
+    ~ModelScreen() {
+      for (auto block = blocks.rbegin(); block != blocks.rend(); ++block) {
+        session.Free(*block);
+      }
+    }
+
+    // The theme adds its styles to the style list of the object, then each local style property (lv_obj_set_style_local_*)
+    // reallocates the style map of the object
+    void Object(uint32_t nbStyleProperties) {
+      Add(ObjectSize);
+      size_t styleList = Add(4 + Header);
+      Reallocate(styleList, 8 + Header);
+      if (nbStyleProperties > 0) {
+        Reallocate(styleList, 12 + Header);
+        Add(LocalStyleSize);
+        const size_t styleMap = Add(StyleMapSize(1));
+        for (uint32_t i = 2; i <= nbStyleProperties; i++) {
+          Reallocate(styleMap, StyleMapSize(i));
+        }
+      }
+    }
+
+    // Returns the text, to be changed with SetText(). The label is created with the text "Text".
+    size_t Label(uint32_t length, uint32_t nbStyleProperties) {
+      Object(nbStyleProperties);
+      Add(LabelDataSize);
+      const size_t text = Add(TextSize(4));
+      SetText(text, length);
+      return text;
+    }
+
+    void SetText(size_t text, uint32_t length) {
+      Reallocate(text, TextSize(length));
+    }
+
+    void Image() {
+      Object(0);
+      Add(ImageDataSize);
+    }
+
+    void Button(uint32_t textLength) {
+      Object(1);
+      Add(ButtonDataSize);
+      Label(textLength, 0);
+    }
+
+    // Returns the first cell: the cells are stored by row
+    size_t Table(uint32_t nbRows, uint32_t nbColumns, uint32_t cellLength) {
+      Object(2);
+      Add(TableDataSize);
+      Add(nbRows * nbColumns * 4 + Header);
+      Add(nbRows * 2 + Header);
+      const size_t firstCell = blocks.size();
+      for (uint32_t i = 0; i < nbRows * nbColumns; i++) {
+        // The format of the cell, then the text
+        Add(cellLength + 2 + Header);
+      }
+      return firstCell;
+    }
+
+    void SetCell(size_t cell, uint32_t length) {
+      Reallocate(cell, length + 2 + Header);
+    }
+
+    void Chart(uint32_t nbSeries, uint32_t nbPoints) {
+      Object(1);
+      Add(ChartDataSize);
+      for (uint32_t i = 0; i < nbSeries; i++) {
+        Add(ChartSeriesSize);
+        Add(nbPoints * 2 + Header);
+      }
+    }
+
+    // A page and its scrollable container, and items made of a button, an icon and a label
+    void List(uint32_t nbItems, uint32_t textLength) {
+      Object(2);
+      Add(PageDataSize);
+      Object(1);
+      Add(4 + Header);
+      for (uint32_t i = 0; i < nbItems; i++) {
+        Object(1);
+        Add(ButtonDataSize);
+        Image();
+        Label(textLength, 0);
+      }
+    }
+
+    void Task() {
+      Add(TaskSize);
+    }
+
+    void Animation() {
+      Add(AnimationSize);
+    }
+
+  private:
+    size_t Add(uint32_t size) {
+      blocks.push_back(session.Allocate(size));
+      return blocks.size() - 1;
+    }
+
+    void Reallocate(size_t block, uint32_t size) {
+      blocks[block] = session.Reallocate(blocks[block], size);
+    }
+
+    Session& session;
+    std::vector<uint32_t> blocks;
+  };
+
+  using Random = std::mt19937;
+
+  uint32_t Uniform(Random& random, uint32_t min, uint32_t max) {
+    return std::uniform_int_distribution<uint32_t> {min, max}(random);
+  }
+
+  // The screens of a few apps of InfiniTime, and what is done with them. The screens that change their content
+  // (pages of SystemInfo, notifications) are deleted before the next one is created, like ScreenList.
+  void Notifications(Session& session, Random& random) {
+    const uint32_t nbNotifications = Uniform(random, 1, 5);
+    for (uint32_t i = 0; i < nbNotifications; i++) {
+      ModelScreen screen {session};
+      screen.Object(3);
+      screen.Label(3, 1);
+      screen.Label(Uniform(random, 6, 30), 1);
+      screen.Label(Uniform(random, 20, 250), 0);
+      screen.Button(7);
+      screen.Task();
+    }
+  }
+
+  void SystemInfo(Session& session, Random& random) {
+    const uint32_t nbPages = Uniform(random, 1, 5);
+    for (uint32_t page = 0; page < nbPages; page++) {
+      ModelScreen screen {session};
+      switch (page) {
+        case 3: {
+          // The tasks: a table of 4 columns and 10 rows
+          screen.Table(10, 4, 6);
+          break;
+        }
+        case 4:
+          screen.Label(420, 0);
+          break;
+        default:
+          // Texts formatted with lv_label_set_text_fmt()
+          screen.Label(Uniform(random, 180, 320), 0);
+          break;
+      }
+      screen.Label(3, 1);
+    }
+  }
+
+  void Music(Session& session, Random& random) {
+    ModelScreen screen {session};
+    for (int i = 0; i < 6; i++) {
+      screen.Button(3);
+    }
+    // The title and the artist scroll
+    screen.Label(Uniform(random, 10, 60), 1);
+    screen.Animation();
+    screen.Label(Uniform(random, 5, 30), 1);
+    screen.Animation();
+    screen.Object(2);
+    screen.Label(10, 0);
+    screen.Task();
+  }
+
+  void Settings(Session& session, Random& random) {
+    ModelScreen screen {session};
+    screen.List(Uniform(random, 4, 6), 14);
+    screen.Label(3, 1);
+  }
+
+  void Twos(Session& session, Random& random) {
+    ModelScreen screen {session};
+    const size_t score = screen.Label(8, 1);
+    const size_t firstCell = screen.Table(4, 4, 0);
+    const uint32_t nbMoves = Uniform(random, 10, 80);
+    for (uint32_t i = 0; i < nbMoves; i++) {
+      for (int cell = 0; cell < 4; cell++) {
+        screen.SetCell(firstCell + Uniform(random, 0, 15), Uniform(random, 0, 4));
+      }
+      screen.SetText(score, Uniform(random, 8, 12));
+    }
+  }
+
+  void StopWatch(Session& session, Random& random) {
+    ModelScreen screen {session};
+    screen.Label(5, 2);
+    screen.Label(3, 2);
+    const size_t laps = screen.Label(0, 1);
+    screen.Button(4);
+    screen.Button(4);
+    screen.Task();
+    const uint32_t nbLaps = Uniform(random, 0, 7);
+    for (uint32_t i = 1; i <= nbLaps; i++) {
+      screen.SetText(laps, i * 14);
+    }
+  }
+
+  void Motion(Session& session, Random& /*random*/) {
+    ModelScreen screen {session};
+    screen.Chart(3, 10);
+    screen.Label(40, 0);
+    screen.Label(20, 1);
+    screen.Task();
+  }
+
+  // Boots the watch and uses the apps from the watch face, which is kept by the screen cache while they are open
+  std::vector<Operation> MakeSession(unsigned seed, size_t nbApps) {
+    Session session;
+    Random random {seed};
+
+    // The display and the input device, their screens and tasks, and the style maps of the theme
+    for (uint32_t size : {180 + Header, 96 + Header, 32 + Header}) {
+      session.Allocate(size);
+    }
+    std::vector<std::unique_ptr<ModelScreen>> system;
+    for (int i = 0; i < 3; i++) {
+      system.push_back(std::make_unique<ModelScreen>(session));
+      system.back()->Object(0);
+      system.back()->Task();
+    }
+    for (uint32_t i = 0; i < 40; i++) {
+      uint32_t map = session.Allocate(StyleMapSize(1));
+      for (uint32_t nbProperties = 2; nbProperties <= 2 + i % 6; nbProperties++) {
+        map = session.Reallocate(map, StyleMapSize(nbProperties));
+      }
+    }
+
+    using App = void (*)(Session&, Random&);
+    const std::vector<std::pair<Apps, App>> apps {{Apps::Notifications, Notifications},
+                                                  {Apps::SysInfo, SystemInfo},
+                                                  {Apps::Music, Music},
+                                                  {Apps::Settings, Settings},
+                                                  {Apps::Twos, Twos},
+                                                  {Apps::StopWatch, StopWatch},
+                                                  {Apps::Motion, Motion}};
+
+    // WatchFaceDigital: the time, the date, the icons of the status and the values of the heart rate and of the steps
+    session.OpenApp(Apps::Clock);
+    ModelScreen watchFace {session};
+    watchFace.Object(1);
+    watchFace.Label(5, 2);
+    watchFace.Label(2, 2);
+    watchFace.Label(16, 2);
+    for (int i = 0; i < 5; i++) {
+      watchFace.Label(3, 1);
+    }
+    const size_t heartRate = watchFace.Label(3, 1);
+    const size_t steps = watchFace.Label(1, 1);
+    watchFace.Task();
+
+    for (size_t i = 0; i < nbApps; i++) {
+      const auto& app = apps[Uniform(random, 0, static_cast<uint32_t>(apps.size() - 1))];
+      session.OpenApp(app.first);
+      app.second(session, random);
+      session.OpenApp(Apps::Clock);
+      // The values refreshed by the watch face until the next app
+      watchFace.SetText(heartRate, Uniform(random, 2, 3));
+      watchFace.SetText(steps, std::min<uint32_t>(5, 1 + static_cast<uint32_t>(i * 5 / nbApps)));
+    }
+    return session.Operations();
+  }
+
+  struct Result {
+    size_t nbOperations = 0;
+    uint32_t nbFailures = 0;
+    // Bytes of the LVGL memory in use, in the blocks of the size classes and in the general pool
+    size_t peakUsed = 0;
+    // Biggest free block of the general pool when an app is opened from the watch face
+    uint32_t minBiggestFreeAtOpen = UINT32_MAX;
+    uint8_t maxFragmentationPercent = 0;
+    // General pool used by an app: what it allocates once the previous screen is deleted
+    uint32_t maxAppNeed = 0;
+    uint32_t hungriestApp = 0;
+  };
+
+  size_t UsedMemory(const LvglAllocator::Statistics& statistics) {
+    size_t used = statistics.poolSize - statistics.poolFree;
+    for (const auto& sizeClass : statistics.classes) {
+      used += sizeClass.used * sizeClass.blockSize;
+    }
+    return used;
+  }
+
+  // Replays operations in an LvglAllocator of MemorySize bytes with the size classes
+  Result Replay(const std::vector<Operation>& operations, const LvglAllocator::SizeClasses& sizeClasses) {
+    auto memory = std::make_unique<uint64_t[]>(MemorySize / sizeof(uint64_t));
+    LvglAllocator allocator {sizeClasses, reinterpret_cast<uint8_t*>(memory.get()), MemorySize};
+    std::vector<void*> blocks;
+    Result result;
+    uint32_t app = static_cast<uint32_t>(Apps::None);
+    uint32_t maxPoolFree = 0;
+
+    for (const auto& operation : operations) {
+      switch (operation.type) {
+        case Operation::Types::Allocate: {
+          void* data = allocator.Allocate(operation.size);
+          if (operation.id != NoBlock) {
+            blocks.resize(std::max<size_t>(blocks.size(), operation.id + 1));
+            blocks[operation.id] = data;
+          }
+          break;
+        }
+        case Operation::Types::Free:
+          if (operation.id < blocks.size()) {
+            allocator.Free(blocks[operation.id]);
+            blocks[operation.id] = nullptr;
+          }
+          break;
+        case Operation::Types::OpenApp:
+          app = operation.id;
+          maxPoolFree = 0;
+          break;
+      }
+
+      const auto statistics = allocator.GetStatistics();
+      result.peakUsed = std::max(result.peakUsed, UsedMemory(statistics));
+      result.maxFragmentationPercent = std::max(result.maxFragmentationPercent, statistics.poolFragmentationPercent);
+      if (operation.type == Operation::Types::OpenApp && app != static_cast<uint32_t>(Apps::Clock)) {
+        result.minBiggestFreeAtOpen = std::min(result.minBiggestFreeAtOpen, statistics.poolBiggestFree);
+      }
+      maxPoolFree = std::max(maxPoolFree, statistics.poolFree);
+      if (app != static_cast<uint32_t>(Apps::Clock) && maxPoolFree - statistics.poolFree > result.maxAppNeed) {
+        result.maxAppNeed = maxPoolFree - statistics.poolFree;
+        result.hungriestApp = app;
+      }
+    }
+    result.nbOperations = operations.size();
+    result.nbFailures = allocator.GetStatistics().nbFailures;
+    return result;
+  }
+
+  // Average duration of an allocation or a free on the host, in ns
+  double Time(const std::vector<Operation>& operations, const LvglAllocator::SizeClasses& sizeClasses) {
+    auto memory = std::make_unique<uint64_t[]>(MemorySize / sizeof(uint64_t));
+    std::vector<void*> blocks(operations.size());
+    constexpr int nbRuns = 20;
+    const auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < nbRuns; run++) {
+      LvglAllocator allocator {sizeClasses, reinterpret_cast<uint8_t*>(memory.get()), MemorySize};
+      for (const auto& operation : operations) {
+        if (operation.type == Operation::Types::Allocate && operation.id != NoBlock) {
+          blocks[operation.id] = allocator.Allocate(operation.size);
+        } else if (operation.type == Operation::Types::Free && operation.id < blocks.size()) {
+          allocator.Free(blocks[operation.id]);
+        }
+      }
+    }
+    const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+    return duration.count() / (nbRuns * operations.size());
+  }
+
+  void Report(const std::string& name, const std::string& layout, const Result& result, double nanoseconds) {
+    std::cout << name << " (" << layout << "): " << result.nbOperations << " operations, " << result.nbFailures
+              << " failures, peak " << result.peakUsed << " bytes, biggest free block of the general pool at least "
+              << result.minBiggestFreeAtOpen << " bytes when an app is opened, fragmentation up to "
+              << static_cast<int>(result.maxFragmentationPercent) << "%, " << result.maxAppNeed
+              << " bytes of the general pool used by app " << result.hungriestApp << ", " << nanoseconds << " ns/operation"
+              << std::endl;
+  }
+
+  std::vector<std::string> TraceFiles() {
+    std::vector<std::string> files;
+#ifdef LVGL_TRACES_DIR
+    if (DIR* directory = opendir(LVGL_TRACES_DIR)) {
+      while (const dirent* entry = readdir(directory)) {
+        const std::string name = entry->d_name;
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".txt") == 0) {
+          files.push_back(std::string(LVGL_TRACES_DIR) + "/" + name);
+        }
+      }
+      closedir(directory);
+    }
+    std::sort(files.begin(), files.end());
+#endif
+    return files;
+  }
+}
+
+TEST(LvglAllocatorTest, SmallBlocksAreTakenFromTheirClass) {
+  alignas(alignof(void*)) uint8_t memory[MemorySize];
+  LvglAllocator allocator {FirmwareClasses, memory, sizeof(memory)};
+  void* small = allocator.Allocate(10);
+  void* object = allocator.Allocate(ObjectSize);
+  void* text = allocator.Allocate(TextSize(200));
+
+  const auto statistics = allocator.GetStatistics();
+  EXPECT_EQ(1u, statistics.classes[0].used);
+  EXPECT_EQ(1u, statistics.classes[3].used);
+  EXPECT_GE(statistics.poolSize - statistics.poolFree, TextSize(200));
+  allocator.Free(small);
+  allocator.Free(object);
+  allocator.Free(text);
+  EXPECT_EQ(0u, UsedMemory(allocator.GetStatistics()));
+}
+
+TEST(LvglAllocatorTest, FullClassesOverflowIntoTheGeneralPool) {
+  alignas(alignof(void*)) uint8_t memory[MemorySize];
+  LvglAllocator allocator {FirmwareClasses, memory, sizeof(memory)};
+  std::vector<void*> blocks;
+  for (int i = 0; i < FirmwareClasses[0].nbBlocks + 1; i++) {
+    blocks.push_back(allocator.Allocate(16));
+    ASSERT_NE(nullptr, blocks.back());
+  }
+  const auto statistics = allocator.GetStatistics();
+  EXPECT_EQ(FirmwareClasses[0].nbBlocks, statistics.classes[0].used);
+  EXPECT_EQ(1u, statistics.classes[0].nbOverflows);
+  EXPECT_LT(statistics.poolFree, statistics.poolSize);
+  for (void* block : blocks) {
+    allocator.Free(block);
+  }
+}
+
+TEST(LvglAllocatorTest, FreedBlocksOfTheGeneralPoolAreMerged) {
+  alignas(alignof(void*)) uint8_t memory[MemorySize];
+  LvglAllocator allocator {FirmwareClasses, memory, sizeof(memory)};
+  const uint32_t poolSize = allocator.GetStatistics().poolSize;
+  void* first = allocator.Allocate(500);
+  void* second = allocator.Allocate(500);
+  void* third = allocator.Allocate(500);
+  allocator.Free(first);
+  allocator.Free(third);
+  EXPECT_EQ(2u, allocator.GetStatistics().poolNbFreeBlocks);
+  EXPECT_GT(allocator.GetStatistics().poolFragmentationPercent, 0);
+
+  allocator.Free(second);
+  const auto statistics = allocator.GetStatistics();
+  EXPECT_EQ(1u, statistics.poolNbFreeBlocks);
+  EXPECT_EQ(poolSize, statistics.poolBiggestFree);
+  EXPECT_EQ(0, statistics.poolFragmentationPercent);
+}
+
+TEST(LvglAllocatorTest, ParsesTheAllocationTraces) {
+  std::istringstream trace {"# comment\no 3\na 0 40\nx 20\n\nf 0\n"};
+  const auto operations = Parse(trace);
+  ASSERT_EQ(4u, operations.size());
+  EXPECT_EQ(Operation::Types::OpenApp, operations[0].type);
+  EXPECT_EQ(3u, operations[0].id);
+  EXPECT_EQ(Operation::Types::Allocate, operations[1].type);
+  EXPECT_EQ(40u, operations[1].size);
+  EXPECT_EQ(NoBlock, operations[2].id);
+  EXPECT_EQ(Operation::Types::Free, operations[3].type);
+  EXPECT_EQ(0u, operations[3].id);
+}
+
+TEST(LvglAllocatorTest, ReplayOfASession) {
+  // 500 apps opened from the watch face, replayed with the layout of the firmware and with a single first-fit pool
+  const auto operations = MakeSession(42, 500);
+  const Result firmware = Replay(operations, FirmwareClasses);
+  const Result singlePool = Replay(operations, SinglePool);
+  Report("Session", "firmware", firmware, Time(operations, FirmwareClasses));
+  Report("Session", "single pool", singlePool, Time(operations, SinglePool));
+
+  EXPECT_EQ(0u, firmware.nbFailures);
+  // ScreenCache::MinFreeMemory: the apps and the draw buffers fit in it, and it is left while the watch face is kept
+  const auto minFreeMemory = static_cast<uint32_t>(ScreenCache::MinFreeMemory);
+  EXPECT_LE(firmware.maxAppNeed + DrawBuffersSize, minFreeMemory);
+  EXPECT_GE(firmware.minBiggestFreeAtOpen, minFreeMemory);
+  RecordProperty("max_app_need", static_cast<int>(firmware.maxAppNeed));
+  RecordProperty("min_biggest_free", static_cast<int>(firmware.minBiggestFreeAtOpen));
+}
+
+TEST(LvglAllocatorTest, ReplayOfTheCapturedTraces) {
+  // The traces captured on the watch with tools/trace/trace2alloc.py, see lvgl-traces/README.md
+  for (const auto& file : TraceFiles()) {
+    std::ifstream input {file};
+    ASSERT_TRUE(input.good()) << file;
+    const auto operations = Parse(input);
+    const Result firmware = Replay(operations, FirmwareClasses);
+    Report(file, "firmware", firmware, Time(operations, FirmwareClasses));
+    Report(file, "single pool", Replay(operations, SinglePool), Time(operations, SinglePool));
+    EXPECT_EQ(0u, firmware.nbFailures) << file;
+    EXPECT_LE(firmware.maxAppNeed, static_cast<uint32_t>(ScreenCache::MinFreeMemory)) << file;
+  }
+}
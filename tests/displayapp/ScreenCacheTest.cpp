@@ -0,0 +1,250 @@
+#include "displayapp/ScreenCache.h"
+#include "displayapp/LvglAllocator.h"
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+
+using Pinetime::Applications::Apps;
+using Pinetime::Applications::ScreenCache;
+using Pinetime::Applications::Screens::Screen;
+using Pinetime::Components::LvglAllocator;
+
+namespace {
+  struct Counters {
+    int nbHidden = 0;
+    int nbShown = 0;
+    int nbDeleted = 0;
+  };
+
+  // Screen that creates its objects on lv_scr_act() and allocates their memory from the LVGL memory, like an app: an
+  // object, its style list and a few larger buffers (texts)
+  class FakeScreen : public Screen {
+  public:
+    FakeScreen(LvglAllocator& allocator, size_t nbObjects, bool retainable, Counters& counters)
+      : Screen(nullptr), allocator {allocator}, retainable {retainable}, counters {counters} {
+      for (size_t i = 0; i < nbObjects; i++) {
+        objects.push_back(lv_label_create(lv_scr_act(), nullptr));
+        blocks.push_back(allocator.Allocate(96));
+        blocks.push_back(allocator.Allocate(24));
+      }
+      blocks.push_back(allocator.Allocate(400));
+    }
+
+    ~FakeScreen() override {
+      lv_obj_clean(lv_scr_act());
+      for (void* block : blocks) {
+        allocator.Free(block);
+      }
+      counters.nbDeleted++;
+    }
+
+    bool IsRetainable() const override {
+      return retainable;
+    }
+
+    void OnHide() override {
+      counters.nbHidden++;
+    }
+
+    void OnShow() override {
+      counters.nbShown++;
+    }
+
+    uint32_t SaveState() const override {
+      return page;
+    }
+
+    void RestoreState(uint32_t state) override {
+      page = state;
+    }
+
+    std::vector<lv_obj_t*> objects;
+    uint32_t page = 0;
+
+  private:
+    LvglAllocator& allocator;
+    const bool retainable;
+    Counters& counters;
+    std::vector<void*> blocks;
+  };
+
+  // Objects of the watch faces and of a simple app
+  constexpr size_t WatchFaceObjects = 25;
+  constexpr size_t AppObjects = 10;
+
+  class ScreenCacheTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+      Stubs::GetLvgl() = {};
+    }
+
+    std::unique_ptr<FakeScreen> MakeScreen(size_t nbObjects, bool retainable, Counters& counters) {
+      return std::make_unique<FakeScreen>(allocator, nbObjects, retainable, counters);
+    }
+
+    // Bytes of the LVGL memory in use
+    size_t UsedMemory() const {
+      const auto statistics = allocator.GetStatistics();
+      size_t used = statistics.poolSize - statistics.poolFree;
+      for (const auto& sizeClass : statistics.classes) {
+        used += sizeClass.used * sizeClass.blockSize;
+      }
+      return used;
+    }
+
+    // The memory of LVGL, with the same layout as the firmware (see MemoryPressureTest)
+    static constexpr LvglAllocator::SizeClasses sizeClasses {{{16, 64}, {32, 48}, {48, 40}, {96, 48}}};
+    alignas(alignof(void*)) uint8_t memory[14 * 1024];
+    LvglAllocator allocator {sizeClasses, memory, sizeof(memory)};
+  };
+
+  constexpr LvglAllocator::SizeClasses ScreenCacheTest::sizeClasses;
+}
+
+TEST_F(ScreenCacheTest, KeepsTheScreenWithItsObjects) {
+  ScreenCache cache;
+  Counters counters;
+  lv_obj_t* watchFaceScreen = lv_scr_act();
+  auto watchFace = MakeScreen(WatchFaceObjects, true, counters);
+  Screen* watchFaceAddress = watchFace.get();
+
+  cache.Retain(Apps::Clock, std::move(watchFace));
+  EXPECT_EQ(1, counters.nbHidden);
+  EXPECT_EQ(1u, cache.Size());
+  // The next app is created on a new LVGL screen
+  lv_obj_t* appScreen = lv_scr_act();
+  EXPECT_NE(watchFaceScreen, appScreen);
+  EXPECT_EQ(WatchFaceObjects, Stubs::NbChildren(watchFaceScreen));
+
+  Counters appCounters;
+  auto app = MakeScreen(AppObjects, false, appCounters);
+  EXPECT_EQ(nullptr, cache.Take(Apps::Music));
+  EXPECT_EQ(appScreen, lv_scr_act());
+  app.reset(nullptr);
+
+  auto screen = cache.Take(Apps::Clock);
+  EXPECT_EQ(watchFaceAddress, screen.get());
+  EXPECT_EQ(1, counters.nbShown);
+  EXPECT_EQ(0, counters.nbDeleted);
+  EXPECT_EQ(0u, cache.Size());
+  // The watch face is displayed again on its LVGL screen, with all its objects, and the screen of the app is deleted
+  EXPECT_EQ(watchFaceScreen, lv_scr_act());
+  EXPECT_EQ(WatchFaceObjects, Stubs::NbChildren(watchFaceScreen));
+  EXPECT_TRUE(appScreen->deleted);
+}
+
+TEST_F(ScreenCacheTest, TheClockIsDisplayedAsNoneAtStartUp) {
+  ScreenCache cache;
+  Counters counters;
+  cache.Retain(Apps::None, MakeScreen(WatchFaceObjects, true, counters));
+  EXPECT_NE(nullptr, cache.Take(Apps::Clock));
+}
+
+TEST_F(ScreenCacheTest, ReplacesTheLeastRecentlyKeptScreen) {
+  ScreenCache cache;
+  Counters clock;
+  Counters timer;
+  Counters stopWatch;
+  lv_obj_t* clockScreen = lv_scr_act();
+  cache.Retain(Apps::Clock, MakeScreen(WatchFaceObjects, true, clock));
+  cache.Retain(Apps::Timer, MakeScreen(AppObjects, true, timer));
+  // The clock was used more recently than the timer
+  cache.Retain(Apps::Clock, cache.Take(Apps::Clock));
+  ASSERT_EQ(static_cast<size_t>(ScreenCache::MaxScreens), cache.Size());
+
+  lv_obj_t* activeScreen = lv_scr_act();
+  cache.Retain(Apps::StopWatch, MakeScreen(AppObjects, true, stopWatch));
+  EXPECT_EQ(1, timer.nbDeleted);
+  EXPECT_EQ(0, clock.nbDeleted);
+  EXPECT_EQ(static_cast<size_t>(ScreenCache::MaxScreens), cache.Size());
+  EXPECT_EQ(nullptr, cache.Take(Apps::Timer));
+  EXPECT_EQ(WatchFaceObjects, Stubs::NbChildren(clockScreen));
+  EXPECT_EQ(AppObjects, Stubs::NbChildren(activeScreen));
+}
+
+TEST_F(ScreenCacheTest, ClearDeletesTheKeptScreens) {
+  ScreenCache cache;
+  Counters clock;
+  Counters app;
+  lv_obj_t* clockScreen = lv_scr_act();
+  cache.Retain(Apps::Clock, MakeScreen(WatchFaceObjects, true, clock));
+  lv_obj_t* appScreen = lv_scr_act();
+  auto current = MakeScreen(AppObjects, false, app);
+  const size_t usedByApp = UsedMemory();
+
+  cache.Clear();
+  EXPECT_EQ(1, clock.nbDeleted);
+  EXPECT_EQ(0u, cache.Size());
+  EXPECT_TRUE(clockScreen->deleted);
+  // The current screen is not touched, and the memory of the watch face is given back
+  EXPECT_EQ(appScreen, lv_scr_act());
+  EXPECT_EQ(AppObjects, Stubs::NbChildren(appScreen));
+  EXPECT_LT(UsedMemory(), usedByApp);
+}
+
+TEST_F(ScreenCacheTest, StatesAreGivenToTheNextScreenOfTheApp) {
+  ScreenCache cache;
+  Counters counters;
+  auto sysInfo = MakeScreen(AppObjects, false, counters);
+  sysInfo->page = 3;
+  cache.SaveState(Apps::SysInfo, sysInfo->SaveState());
+  sysInfo.reset(nullptr);
+
+  sysInfo = MakeScreen(AppObjects, false, counters);
+  sysInfo->RestoreState(cache.GetState(Apps::SysInfo));
+  EXPECT_EQ(3u, sysInfo->page);
+  EXPECT_EQ(0u, cache.GetState(Apps::Settings));
+}
+
+TEST_F(ScreenCacheTest, GoingBackToTheWatchFace) {
+  // Opens an app from the watch face and goes back to the watch face, like DisplayApp::LoadApp(), with and without
+  // keeping the watch face. The time it takes on the watch is recorded by the LoadApp events of the trace.
+  struct Result {
+    size_t usedWithApp = 0;
+    size_t objectsCreated = 0;
+    size_t bytesAllocated = 0;
+  };
+  auto run = [this](bool retain) {
+    ScreenCache cache;
+    Counters counters;
+    Result result;
+    std::unique_ptr<Screen> current = MakeScreen(WatchFaceObjects, true, counters);
+    for (int i = 0; i < 100; i++) {
+      if (retain) {
+        cache.Retain(Apps::Clock, std::move(current));
+      } else {
+        current.reset(nullptr);
+      }
+      current = MakeScreen(AppObjects, false, counters);
+      result.usedWithApp = UsedMemory();
+
+      const size_t nbObjects = Stubs::GetLvgl().objects.size();
+      current.reset(nullptr);
+      const size_t usedWithoutApp = UsedMemory();
+      current = cache.Take(Apps::Clock);
+      if (current == nullptr) {
+        current = MakeScreen(WatchFaceObjects, true, counters);
+      }
+      result.objectsCreated = Stubs::GetLvgl().objects.size() - nbObjects;
+      result.bytesAllocated = UsedMemory() - usedWithoutApp;
+    }
+    current.reset(nullptr);
+    return result;
+  };
+
+  const Result retained = run(true);
+  const Result rebuilt = run(false);
+  // Keeping the watch face creates nothing when going back to it, at the cost of its memory while the app is open
+  EXPECT_EQ(0u, retained.objectsCreated);
+  EXPECT_EQ(0u, retained.bytesAllocated);
+  EXPECT_EQ(WatchFaceObjects, rebuilt.objectsCreated);
+  EXPECT_GT(rebuilt.bytesAllocated, 0u);
+  EXPECT_EQ(rebuilt.bytesAllocated, retained.usedWithApp - rebuilt.usedWithApp);
+  EXPECT_EQ(0u, UsedMemory());
+
+  const size_t statesSize = (static_cast<size_t>(Apps::Error) + 1) * sizeof(uint32_t);
+  RecordProperty("retained_bytes", static_cast<int>(retained.usedWithApp - rebuilt.usedWithApp));
+  std::cout << "ScreenCache: the kept watch face holds " << retained.usedWithApp - rebuilt.usedWithApp
+            << " bytes of LVGL memory on the host while an app is open; going back to it creates 0 objects instead of "
+            << rebuilt.objectsCreated << "; the saved states take " << statesSize << " bytes" << std::endl;
+}
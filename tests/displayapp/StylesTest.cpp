@@ -0,0 +1,173 @@
+#include "lv_pinetime_styles_runtime.h"
+#include "displayapp/LvglAllocator.h"
+#include "libs/lv_pinetime_mem.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using Pinetime::Components::LvglAllocator;
+
+namespace {
+  // The LVGL memory of the firmware (LV_MEM_SIZE and the size classes of LittleVgl.cpp, with the larger objects of the
+  // host)
+  constexpr LvglAllocator::SizeClasses sizeClasses {{{16, 64}, {32, 48}, {48, 40}, {96, 48}}};
+  alignas(alignof(void*)) uint8_t memory[LV_MEM_SIZE];
+  LvglAllocator allocator {sizeClasses, memory, sizeof(memory)};
+  size_t nbAllocations = 0;
+
+  size_t UsedMemory() {
+    const auto statistics = allocator.GetStatistics();
+    size_t used = statistics.poolSize - statistics.poolFree;
+    for (const auto& sizeClass : statistics.classes) {
+      used += sizeClass.used * sizeClass.blockSize;
+    }
+    return used;
+  }
+
+  // Value of a property, and the weight of the state that matched (-1 if the property is not in the style)
+  struct Value {
+    int16_t weight;
+    uint64_t value;
+  };
+
+  Value Get(const lv_style_t* style, const lv_pinetime_style_property_t& property) {
+    Value result {-1, 0};
+    switch (property.kind) {
+      case LV_PINETIME_STYLE_INT: {
+        lv_style_int_t value = 0;
+        result.weight = _lv_style_get_int(style, property.id, &value);
+        result.value = static_cast<uint64_t>(value);
+        break;
+      }
+      case LV_PINETIME_STYLE_COLOR: {
+        lv_color_t value {};
+        result.weight = _lv_style_get_color(style, property.id, &value);
+        result.value = lv_color_to32(value);
+        break;
+      }
+      case LV_PINETIME_STYLE_OPA: {
+        lv_opa_t value = 0;
+        result.weight = _lv_style_get_opa(style, property.id, &value);
+        result.value = value;
+        break;
+      }
+      default: {
+        const void* value = nullptr;
+        result.weight = _lv_style_get_ptr(style, property.id, &value);
+        result.value = reinterpret_cast<uintptr_t>(value);
+        break;
+      }
+    }
+    return result;
+  }
+
+  // The styles of styles.json built with the functions of LVGL, like the theme did at boot
+  class StylesTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+      const size_t usedBefore = UsedMemory();
+      const size_t allocationsBefore = nbAllocations;
+      runtimeStyles.resize(lv_pinetime_style_nb_builders);
+      for (size_t i = 0; i < lv_pinetime_style_nb_builders; i++) {
+        lv_pinetime_style_builders[i].build(&runtimeStyles[i]);
+      }
+      runtimeMemory = UsedMemory() - usedBefore;
+      runtimeAllocations = nbAllocations - allocationsBefore;
+    }
+
+    void TearDown() override {
+      for (auto& style : runtimeStyles) {
+        lv_style_reset(&style);
+      }
+    }
+
+    std::vector<lv_style_t> runtimeStyles;
+    size_t runtimeMemory = 0;
+    size_t runtimeAllocations = 0;
+  };
+}
+
+// LVGL on the host: the allocator of the firmware, the tick and the fonts of lv_conf.h
+extern "C" {
+void* lv_pinetime_mem_alloc(size_t size) {
+  nbAllocations++;
+  return allocator.Allocate(size);
+}
+
+void lv_pinetime_mem_free(void* data) {
+  allocator.Free(data);
+}
+
+uint32_t xTaskGetTickCount(void) {
+  return 0;
+}
+
+lv_font_t jetbrains_mono_bold_20;
+lv_font_t jetbrains_mono_extrabold_compressed;
+lv_font_t jetbrains_mono_42;
+lv_font_t jetbrains_mono_76;
+lv_font_t open_sans_light;
+lv_font_t lv_font_sys_48;
+}
+
+TEST_F(StylesTest, ConstantMapsAreTheMapsOfLvgl) {
+  // Same layout as the maps built by LVGL with the compiler and the configuration of the host, like in InfiniSim
+  for (size_t i = 0; i < lv_pinetime_style_nb_builders; i++) {
+    const auto& builder = lv_pinetime_style_builders[i];
+    const uint16_t size = _lv_style_get_mem_size(builder.constant);
+    ASSERT_EQ(_lv_style_get_mem_size(&runtimeStyles[i]), size) << builder.name;
+    EXPECT_EQ(0, std::memcmp(runtimeStyles[i].map, builder.constant->map, size)) << builder.name;
+  }
+}
+
+TEST_F(StylesTest, ConstantStylesGiveTheSameValues) {
+  for (size_t i = 0; i < lv_pinetime_style_nb_properties; i++) {
+    const auto& property = lv_pinetime_style_properties[i];
+    const auto& builder = lv_pinetime_style_builders[property.style];
+    const Value constant = Get(builder.constant, property);
+    const Value runtime = Get(&runtimeStyles[property.style], property);
+    EXPECT_GE(constant.weight, 0) << builder.name << " " << property.id;
+    EXPECT_EQ(runtime.weight, constant.weight) << builder.name << " " << property.id;
+    EXPECT_EQ(runtime.value, constant.value) << builder.name << " " << property.id;
+  }
+}
+
+TEST_F(StylesTest, MemoryAndLookupCost) {
+  // Reading the constant styles doesn't allocate anything
+  const size_t allocationsBefore = nbAllocations;
+  const size_t usedBefore = UsedMemory();
+  size_t mapsSize = 0;
+  for (size_t i = 0; i < lv_pinetime_style_nb_builders; i++) {
+    mapsSize += _lv_style_get_mem_size(lv_pinetime_style_builders[i].constant);
+  }
+
+  // Every property of every style, from the constant maps or from the maps built at runtime
+  auto lookups = [this](bool constant) {
+    constexpr int nbRuns = 2000;
+    uint64_t checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < nbRuns; run++) {
+      for (size_t i = 0; i < lv_pinetime_style_nb_properties; i++) {
+        const auto& property = lv_pinetime_style_properties[i];
+        const lv_style_t* style = constant ? lv_pinetime_style_builders[property.style].constant : &runtimeStyles[property.style];
+        checksum += Get(style, property).value;
+      }
+    }
+    const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+    return std::make_pair(duration.count() / (nbRuns * lv_pinetime_style_nb_properties), checksum);
+  };
+  const auto constant = lookups(true);
+  const auto runtime = lookups(false);
+  EXPECT_EQ(runtime.second, constant.second);
+  EXPECT_EQ(allocationsBefore, nbAllocations);
+  EXPECT_EQ(usedBefore, UsedMemory());
+  EXPECT_GT(runtimeMemory, mapsSize);
+
+  RecordProperty("runtime_bytes", static_cast<int>(runtimeMemory));
+  std::cout << "Styles: " << lv_pinetime_style_nb_builders << " styles, " << lv_pinetime_style_nb_properties << " properties, "
+            << mapsSize << " bytes of constant maps on the host. Built at runtime: " << runtimeAllocations << " allocations, "
+            << runtimeMemory << " bytes of LVGL memory. Lookup: " << constant.first << " ns (constant), " << runtime.first
+            << " ns (runtime)" << std::endl;
+}
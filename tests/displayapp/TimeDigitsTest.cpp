@@ -0,0 +1,143 @@
+#include "displayapp/widgets/TimeDigits.h"
+#include "components/fonts/FontStore.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using Pinetime::Applications::Widgets::TimeDigits;
+using Pinetime::Controllers::FontStore;
+
+namespace {
+  // Cells of about the size of jetbrains_mono_extrabold_compressed
+  constexpr lv_font_t font {48, 80};
+  constexpr uint32_t cellArea = 48 * 80;
+
+  std::string Text(const TimeDigits& digits, size_t nbCells) {
+    std::string text;
+    const lv_obj_t* container = digits.GetObject();
+    for (const auto& obj : Stubs::GetLvgl().objects) {
+      if (obj.parent == container && text.size() < nbCells) {
+        text += (obj.text[0] == '\0') ? ' ' : obj.text[0];
+      }
+    }
+    return text;
+  }
+
+  // Area redrawn by LVGL: the invalidated areas are merged when they overlap, as the cells don't overlap
+  uint32_t RedrawnArea() {
+    auto& invalidated = Stubs::GetLvgl().invalidated;
+    uint32_t area = 0;
+    for (size_t i = 0; i < invalidated.size(); i++) {
+      bool merged = false;
+      for (size_t j = 0; j < i; j++) {
+        merged |= std::memcmp(&invalidated[i], &invalidated[j], sizeof(lv_area_t)) == 0;
+      }
+      if (!merged) {
+        area += (invalidated[i].x2 - invalidated[i].x1 + 1) * (invalidated[i].y2 - invalidated[i].y1 + 1);
+      }
+    }
+    invalidated.clear();
+    return area;
+  }
+
+  class TimeDigitsTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+      Stubs::GetLvgl() = {};
+      FontStore::Prefetched().clear();
+    }
+
+    lv_obj_t screen {nullptr, 0, 0, 240, 240, false, nullptr, nullptr, false};
+  };
+}
+
+TEST_F(TimeDigitsTest, ShowsTheTime) {
+  TimeDigits digits;
+  digits.Create(&screen, &font);
+  EXPECT_EQ(5 * font.glyphWidth, digits.GetObject()->width);
+
+  digits.SetTime(12, 34);
+  EXPECT_EQ("12:34", Text(digits, 5));
+  digits.SetTime(9, 5, 0, false);
+  EXPECT_EQ(" 9:05", Text(digits, 5));
+  digits.SetTime(9, 5);
+  EXPECT_EQ("09:05", Text(digits, 5));
+}
+
+TEST_F(TimeDigitsTest, ShowsTheSeconds) {
+  TimeDigits digits {true};
+  digits.Create(&screen, &font);
+  digits.SetTime(23, 59, 7);
+  EXPECT_EQ("23:59:07", Text(digits, 8));
+}
+
+TEST_F(TimeDigitsTest, OnlyTheDigitsThatChangedAreRedrawn) {
+  TimeDigits digits;
+  digits.Create(&screen, &font);
+  digits.SetTime(12, 34);
+  RedrawnArea();
+
+  digits.SetTime(12, 35);
+  EXPECT_EQ(cellArea, RedrawnArea());
+  digits.SetTime(12, 40);
+  EXPECT_EQ(2 * cellArea, RedrawnArea());
+  digits.SetTime(12, 40);
+  EXPECT_EQ(0u, RedrawnArea());
+  digits.SetTime(20, 0);
+  EXPECT_EQ(3 * cellArea, RedrawnArea());
+}
+
+TEST_F(TimeDigitsTest, RedrawnAreaDuringADay) {
+  TimeDigits digits;
+  digits.Create(&screen, &font);
+  digits.SetTime(0, 0);
+  RedrawnArea();
+
+  uint32_t area = 0;
+  for (uint16_t minute = 1; minute <= 24 * 60; minute++) {
+    digits.SetTime((minute / 60) % 24, minute % 60);
+    area += RedrawnArea();
+  }
+  // A single label "HH:MM" redraws its whole area each minute
+  const uint32_t labelArea = 24 * 60 * 5 * cellArea;
+  EXPECT_LT(area * 4, labelArea);
+  std::cout << "TimeDigits: " << area / (24 * 60) << " pixels redrawn per minute on average, " << 5 * cellArea
+            << " for a label" << std::endl;
+}
+
+TEST_F(TimeDigitsTest, RedrawnAreaWithTheSeconds) {
+  TimeDigits digits {true};
+  digits.Create(&screen, &font);
+  digits.SetTime(0, 0, 0);
+  RedrawnArea();
+
+  uint32_t area = 0;
+  for (uint32_t second = 1; second <= 3600; second++) {
+    digits.SetTime(second / 3600, (second / 60) % 60, second % 60);
+    area += RedrawnArea();
+  }
+  // A single label "HH:MM:SS" redraws its whole area each second
+  const uint32_t labelArea = 3600 * 8 * cellArea;
+  EXPECT_LT(area * 6, labelArea);
+  std::cout << "TimeDigits: " << area / 3600 << " pixels redrawn per second on average, " << 8 * cellArea << " for a label"
+            << std::endl;
+}
+
+TEST_F(TimeDigitsTest, OnlyTheNewDigitsSlideIn) {
+  TimeDigits digits;
+  digits.Create(&screen, &font);
+  digits.SetAnimationTime(200);
+  digits.SetTime(12, 34);
+  Stubs::GetLvgl().animated.clear();
+
+  digits.SetTime(12, 35);
+  ASSERT_EQ(1u, Stubs::GetLvgl().animated.size());
+  EXPECT_STREQ("5", Stubs::GetLvgl().animated[0]->text);
+}
+
+TEST_F(TimeDigitsTest, PrefetchesTheGlyphsOfTheTime) {
+  TimeDigits digits;
+  digits.Create(&screen, &font);
+  digits.SetTime(7, 45, 0, false);
+  ASSERT_FALSE(FontStore::Prefetched().empty());
+  EXPECT_EQ("7:45", FontStore::Prefetched().back());
+}
@@ -0,0 +1,123 @@
+#include "displayapp/TouchQueue.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using Pinetime::Components::TouchQueue;
+
+namespace {
+  constexpr uint16_t OutOfScreen = static_cast<uint16_t>(-1);
+
+  // Reads the queue like the input device of LVGL: all the buffered points in a row
+  std::vector<TouchQueue::Point> ReadAll(TouchQueue& queue) {
+    std::vector<TouchQueue::Point> points;
+    TickType_t timestamp;
+    do {
+      queue.Read(timestamp);
+      points.push_back(queue.Current());
+    } while (!queue.Empty());
+    return points;
+  }
+
+  // LVGL clicks the object under the finger when it is released on screen after a press
+  bool Clicked(const std::vector<TouchQueue::Point>& points) {
+    bool pressed = false;
+    for (const auto& point : points) {
+      if (pressed && !point.pressed && point.x != OutOfScreen) {
+        return true;
+      }
+      pressed = point.pressed;
+    }
+    return false;
+  }
+}
+
+TEST(TouchQueueTest, ReadsAllTheQueuedPoints) {
+  TouchQueue queue;
+  queue.Push(10, 20, true, 100);
+  queue.Push(10, 20, false, 130);
+
+  TickType_t timestamp = 0;
+  EXPECT_TRUE(queue.Read(timestamp));
+  EXPECT_EQ(100u, timestamp);
+  EXPECT_TRUE(queue.Current().pressed);
+  EXPECT_FALSE(queue.Empty());
+  EXPECT_TRUE(queue.Read(timestamp));
+  EXPECT_EQ(130u, timestamp);
+  EXPECT_FALSE(queue.Current().pressed);
+  EXPECT_EQ(10, queue.Current().x);
+  EXPECT_EQ(20, queue.Current().y);
+  EXPECT_FALSE(queue.Read(timestamp));
+}
+
+TEST(TouchQueueTest, JumpsToTheLastPointWhenPointsWereDropped) {
+  TouchQueue queue;
+  for (uint16_t i = 0; i < 20; i++) {
+    queue.Push(i, i, true, i);
+  }
+  queue.Push(50, 60, false, 20);
+
+  // The 8 first points, then the last one
+  ReadAll(queue);
+  TickType_t timestamp;
+  EXPECT_FALSE(queue.Read(timestamp));
+  EXPECT_FALSE(queue.Current().pressed);
+  EXPECT_EQ(50, queue.Current().x);
+  EXPECT_EQ(60, queue.Current().y);
+}
+
+TEST(TouchQueueTest, ASwipeThatIsCancelledIsNotAClick) {
+  TouchQueue queue;
+  std::vector<TouchQueue::Point> points;
+  queue.Push(120, 200, true, 0);
+  queue.Push(120, 150, true, 10);
+  auto read = ReadAll(queue);
+  points.insert(points.end(), read.begin(), read.end());
+
+  // The swipe goes on while the display task handles the gesture: more points than the queue can hold
+  for (uint16_t y = 140; y > 40; y -= 10) {
+    queue.Push(120, y, true, 20);
+  }
+  queue.Cancel();
+  EXPECT_TRUE(queue.Current().pressed);
+  EXPECT_EQ(OutOfScreen, queue.Current().x);
+
+  // The last point written before the cancellation isn't read again
+  read = ReadAll(queue);
+  points.insert(points.end(), read.begin(), read.end());
+  EXPECT_TRUE(points.back().pressed);
+  EXPECT_EQ(OutOfScreen, points.back().x);
+
+  // Nor the points written after it, until the finger is lifted
+  queue.Push(120, 30, true, 40);
+  queue.Push(120, 30, false, 50);
+  read = ReadAll(queue);
+  points.insert(points.end(), read.begin(), read.end());
+  for (size_t i = 2; i < points.size(); i++) {
+    EXPECT_EQ(OutOfScreen, points[i].x);
+    EXPECT_EQ(OutOfScreen, points[i].y);
+  }
+  EXPECT_FALSE(points.back().pressed);
+  EXPECT_FALSE(Clicked(points));
+
+  // The next touch is a normal tap
+  queue.Push(60, 60, true, 100);
+  queue.Push(60, 60, false, 110);
+  EXPECT_TRUE(Clicked(ReadAll(queue)));
+}
+
+TEST(TouchQueueTest, CancelAfterTheFingerWasLifted) {
+  TouchQueue queue;
+  queue.Push(120, 200, true, 0);
+  queue.Push(120, 100, false, 10);
+  queue.Cancel();
+  EXPECT_FALSE(queue.Current().pressed);
+  EXPECT_EQ(OutOfScreen, queue.Current().x);
+
+  // The next touch isn't ignored
+  queue.Push(60, 60, true, 100);
+  queue.Push(60, 60, false, 110);
+  auto points = ReadAll(queue);
+  EXPECT_TRUE(points.front().pressed);
+  EXPECT_EQ(60, points.front().x);
+  EXPECT_TRUE(Clicked(points));
+}
@@ -0,0 +1,247 @@
+#include "logging/TokenizedLog.h"
+#include "nrf.h"
+#include "Stubs.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+#endif
+
+using namespace Pinetime::Logging;
+
+namespace {
+  constexpr size_t RingSize = 32;
+  constexpr size_t Watermark = RingSize * 3 / 4;
+  constexpr size_t HeaderSize = 8;
+
+  struct Record {
+    uint16_t token;
+    uint32_t timestamp;
+    std::vector<uint32_t> arguments;
+  };
+
+  uint32_t Read32(const std::vector<uint8_t>& data, size_t offset) {
+    return data[offset] | (data[offset + 1] << 8) | (data[offset + 2] << 16) | (static_cast<uint32_t>(data[offset + 3]) << 24);
+  }
+
+  // The records of the RTT stream, see doc/TokenizedLog.md
+  std::vector<Record> Decode(const std::vector<uint8_t>& stream) {
+    std::vector<Record> records;
+    size_t offset = 0;
+    while (offset + HeaderSize <= stream.size()) {
+      Record record {static_cast<uint16_t>(stream[offset] | (stream[offset + 1] << 8)), Read32(stream, offset + 4), {}};
+      const size_t nbArguments = stream[offset + 2];
+      offset += HeaderSize;
+      for (size_t i = 0; i < nbArguments; i++, offset += 4) {
+        record.arguments.push_back(Read32(stream, offset));
+      }
+      records.push_back(record);
+    }
+    EXPECT_EQ(stream.size(), offset);
+    return records;
+  }
+
+  // What NRF_LOG_INFO() does with 2 arguments in the deferred mode of the firmware (NRF_LOG_DEFERRED,
+  // nrf_log_frontend.c): the header, the timestamp and the arguments are copied in a ring of words, reserved in a
+  // critical section that disables the interrupts, then the header is marked complete
+  class NrfLogDeferred {
+  public:
+    void Info(const char* format, uint32_t arg0, uint32_t arg1) {
+      const uint32_t args[] = {arg0, arg1};
+      Std(3, format, args, 2);
+    }
+
+    // What the idle task does
+    void Flush() {
+      readIndex = writeIndex;
+    }
+
+  private:
+    static constexpr uint32_t BufferSize = 256;
+    static constexpr uint32_t Mask = BufferSize - 1;
+    static constexpr uint32_t HeaderWords = 2;
+
+    void Std(uint32_t severity, const char* format, const uint32_t* args, uint32_t nbArgs) {
+      uint32_t writeIndex;
+      if (!Prealloc(nbArgs + HeaderWords + 1, writeIndex)) {
+        skipped++;
+        return;
+      }
+      const uint32_t headerIndex = writeIndex;
+      const uint32_t header = 1 | (1 << 3) | (nbArgs << 4) | (static_cast<uint32_t>(reinterpret_cast<uintptr_t>(format)) << 8);
+      buffer[writeIndex++ & Mask] = header;
+      buffer[writeIndex++ & Mask] = severity | (skipped << 16);
+      buffer[writeIndex++ & Mask] = NRF_RTC2->COUNTER;
+      for (uint32_t i = 0; i < nbArgs; i++) {
+        buffer[writeIndex++ & Mask] = args[i];
+      }
+      buffer[headerIndex & Mask] = header & ~(1u << 3);
+      skipped = 0;
+    }
+
+    bool Prealloc(uint32_t length, uint32_t& writeIndex) {
+      // Interrupts disabled (PRIMASK): a couple of cycles on the Cortex-M4
+      primask.store(1, std::memory_order_relaxed);
+      std::atomic_signal_fence(std::memory_order_seq_cst);
+      const bool fits = Mask + 1 - (this->writeIndex - readIndex) >= length;
+      if (fits) {
+        writeIndex = this->writeIndex;
+        this->writeIndex += length;
+      }
+      std::atomic_signal_fence(std::memory_order_seq_cst);
+      primask.store(0, std::memory_order_relaxed);
+      return fits;
+    }
+
+    std::atomic<uint32_t> primask {0};
+    uint32_t buffer[BufferSize];
+    uint32_t writeIndex = 0;
+    uint32_t readIndex = 0;
+    uint32_t skipped = 0;
+  };
+
+  // Time stamp counter of the CPU, nanoseconds where there is none
+  uint64_t Cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+
+  class TokenizedLogTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+      TokenizedLog::Init();
+      Stubs::SetRttCapacity(SIZE_MAX);
+      Stubs::SetInIsr(false);
+      stubRtc2.COUNTER = 0;
+      TokenizedLog::Flush();
+      Stubs::TakeRttOutput();
+    }
+
+    void TearDown() override {
+      Stubs::SetInIsr(false);
+      Stubs::SetRttCapacity(SIZE_MAX);
+      TokenizedLog::Flush();
+    }
+  };
+}
+
+TEST_F(TokenizedLogTest, RecordsTheTokenTimestampAndArguments) {
+  stubRtc2.COUNTER = 0x123456;
+  TLOG_INFO("value=%d count=%u state=%d", -2, 7u, 'x');
+  stubRtc2.COUNTER = 0x123457;
+  TLOG_WARNING("ratio=%f", 1.5f);
+  TLOG_ERROR("failed");
+  EXPECT_TRUE(Stubs::TakeRttOutput().empty());
+
+  TokenizedLog::Flush();
+  const auto records = Decode(Stubs::TakeRttOutput());
+  ASSERT_EQ(3u, records.size());
+  EXPECT_EQ(0x123456u, records[0].timestamp);
+  EXPECT_EQ((std::vector<uint32_t> {static_cast<uint32_t>(-2), 7, 'x'}), records[0].arguments);
+  EXPECT_EQ(0x123457u, records[1].timestamp);
+  EXPECT_EQ(std::vector<uint32_t> {0x3fc00000}, records[1].arguments);
+  EXPECT_TRUE(records[2].arguments.empty());
+  // Each format string has its own token
+  EXPECT_NE(records[0].token, records[1].token);
+  EXPECT_NE(records[1].token, records[2].token);
+  for (const auto& record : records) {
+    EXPECT_NE(TokenizedLog::LostToken, record.token);
+  }
+}
+
+TEST_F(TokenizedLogTest, TaskFlushesTheRingAtTheWatermark) {
+  for (size_t i = 0; i < Watermark; i++) {
+    TLOG_DEBUG("%d", static_cast<int>(i));
+  }
+  EXPECT_TRUE(Stubs::TakeRttOutput().empty());
+  // Pushed beyond the watermark
+  TLOG_DEBUG("%d", static_cast<int>(Watermark));
+  EXPECT_EQ(Watermark + 1, Decode(Stubs::TakeRttOutput()).size());
+}
+
+TEST_F(TokenizedLogTest, InterruptsLeaveTheFlushToTheTasks) {
+  Stubs::SetInIsr(true);
+  for (size_t i = 0; i < RingSize + 5; i++) {
+    TLOG_DEBUG("%d", static_cast<int>(i));
+  }
+  EXPECT_TRUE(Stubs::TakeRttOutput().empty());
+  Stubs::SetInIsr(false);
+
+  TokenizedLog::Flush();
+  const auto records = Decode(Stubs::TakeRttOutput());
+  ASSERT_EQ(RingSize + 1, records.size());
+  for (size_t i = 0; i < RingSize; i++) {
+    EXPECT_EQ(std::vector<uint32_t> {static_cast<uint32_t>(i)}, records[i].arguments);
+  }
+  // The records that didn't fit in the ring are reported
+  EXPECT_EQ(TokenizedLog::LostToken, records.back().token);
+  EXPECT_EQ(std::vector<uint32_t> {5}, records.back().arguments);
+}
+
+TEST_F(TokenizedLogTest, RecordsThatDontFitInTheRttBufferAreReported) {
+  // Room for 2 records of 1 argument: the third one is lost, and reported by the next flush
+  Stubs::SetRttCapacity(2 * (HeaderSize + 4));
+  TLOG_INFO("%d", 1);
+  TLOG_INFO("%d", 2);
+  TLOG_INFO("%d", 3);
+  TokenizedLog::Flush();
+  EXPECT_EQ(2u, Decode(Stubs::TakeRttOutput()).size());
+
+  Stubs::SetRttCapacity(SIZE_MAX);
+  TokenizedLog::Flush();
+  const auto records = Decode(Stubs::TakeRttOutput());
+  ASSERT_EQ(1u, records.size());
+  EXPECT_EQ(TokenizedLog::LostToken, records[0].token);
+  EXPECT_EQ(std::vector<uint32_t> {1}, records[0].arguments);
+}
+
+TEST_F(TokenizedLogTest, CostOfALogCall) {
+  // Logs of 2 arguments, flushed every 16 calls like the idle task would: the calls never flush the ring themselves
+  constexpr int nbCalls = 200000;
+  constexpr int batch = 16;
+  NrfLogDeferred nrfLog;
+  uint64_t tokenized = 0;
+  uint64_t deferred = 0;
+  uint64_t formatted = 0;
+  char text[64];
+  for (int round = 0; round < 3; round++) {
+    for (int i = 0; i < nbCalls; i += batch) {
+      auto start = Cycles();
+      for (int j = 0; j < batch; j++) {
+        TLOG_INFO("update status=%d handle=%d", i, j);
+      }
+      tokenized += Cycles() - start;
+      TokenizedLog::Flush();
+      Stubs::TakeRttOutput();
+
+      start = Cycles();
+      for (int j = 0; j < batch; j++) {
+        nrfLog.Info("update status=%d handle=%d", i, j);
+      }
+      deferred += Cycles() - start;
+      nrfLog.Flush();
+
+      // Without NRF_LOG_DEFERRED, or when the idle task processes the deferred logs: the message is formatted
+      start = Cycles();
+      for (int j = 0; j < batch; j++) {
+        snprintf(text, sizeof(text), "update status=%d handle=%d", i, j);
+      }
+      formatted += Cycles() - start;
+    }
+  }
+  const double nb = 3.0 * nbCalls;
+  EXPECT_LT(tokenized, formatted);
+
+  RecordProperty("tokenized", static_cast<int>(tokenized / nb));
+  RecordProperty("nrf_log_deferred", static_cast<int>(deferred / nb));
+  RecordProperty("nrf_log_formatted", static_cast<int>(formatted / nb));
+  std::cout << "Log call of 2 arguments (host cycles): TLOG_INFO " << tokenized / nb << ", NRF_LOG_INFO deferred "
+            << deferred / nb << ", formatted " << formatted / nb << std::endl;
+}
@@ -0,0 +1,141 @@
+#include "logging/Trace.h"
+#include "components/fs/FS.h"
+#include "nrf.h"
+#include "Stubs.h"
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace Pinetime::Logging;
+using Pinetime::Controllers::FS;
+
+namespace {
+  constexpr size_t HeaderSize = 20;
+  constexpr size_t TaskSize = 6;
+  constexpr size_t RecordSize = 8;
+  constexpr uint32_t CounterMask = 0xffffff;
+
+  uint32_t Read32(const std::vector<uint8_t>& data, size_t offset) {
+    return data[offset] | (data[offset + 1] << 8) | (data[offset + 2] << 16) | (static_cast<uint32_t>(data[offset + 3]) << 24);
+  }
+
+  uint16_t Read16(const std::vector<uint8_t>& data, size_t offset) {
+    return data[offset] | (data[offset + 1] << 8);
+  }
+
+  class TraceTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+      Stubs::SetTasks({{nullptr, "IDLE", 1, 0, 0}, {nullptr, "sys", 2, 0, 0}, {nullptr, "disp", 3, 0, 0}});
+      stubRtc2.COUNTER = 0;
+      Trace::Start();
+    }
+
+    void Record(uint32_t timestamp, Trace::Events event, uint16_t argument = 0) {
+      stubRtc2.COUNTER = timestamp & CounterMask;
+      Trace::Record(event, argument);
+    }
+
+    FS fs;
+  };
+}
+
+TEST_F(TraceTest, DumpsTheTasksAndTheRecords) {
+  Record(10, Trace::Events::TaskSwitchedIn, 2);
+  Record(20, Trace::Events::SystemMessagePosted, 7);
+  EXPECT_TRUE(Trace::IsRunning());
+  EXPECT_EQ(2u, Trace::NbRecorded());
+
+  ASSERT_TRUE(Trace::Dump(fs));
+  EXPECT_FALSE(Trace::IsRunning());
+  EXPECT_EQ(Trace::DumpStates::Done, Trace::GetDumpState());
+  // Stopped: not recorded
+  Record(30, Trace::Events::TaskSwitchedIn, 3);
+
+  const auto& dump = fs.Content(Trace::dumpFileName);
+  ASSERT_EQ(HeaderSize + 3 * TaskSize + 2 * RecordSize, dump.size());
+  EXPECT_EQ("ITRC", std::string(dump.begin(), dump.begin() + 4));
+  EXPECT_EQ(1, dump[4]);
+  EXPECT_EQ(RecordSize, dump[5]);
+  EXPECT_EQ(3, Read16(dump, 6));
+  EXPECT_EQ(32768u, Read32(dump, 8));
+  EXPECT_EQ(2u, Read32(dump, 12));
+  EXPECT_EQ(0u, Read32(dump, 16));
+
+  size_t offset = HeaderSize + TaskSize;
+  EXPECT_EQ(2, Read16(dump, offset));
+  // The task names are truncated to configMAX_TASK_NAME_LEN, without a terminating null character
+  EXPECT_EQ("sys", std::string(dump.begin() + offset + 2, dump.begin() + offset + 5));
+
+  offset = HeaderSize + 3 * TaskSize + RecordSize;
+  EXPECT_EQ(20u, Read32(dump, offset));
+  EXPECT_EQ(static_cast<uint8_t>(Trace::Events::SystemMessagePosted), dump[offset + 4]);
+  EXPECT_EQ(7, Read16(dump, offset + 6));
+}
+
+TEST_F(TraceTest, KeepsTheLastEventsOldestFirst) {
+  const size_t nbEvents = portTRACE_BUFFER_SIZE + 88;
+  for (size_t i = 0; i < nbEvents; i++) {
+    Record(i, Trace::Events::QueuePosted, i);
+  }
+  ASSERT_TRUE(Trace::Dump(fs));
+
+  const auto& dump = fs.Content(Trace::dumpFileName);
+  ASSERT_EQ(HeaderSize + 3 * TaskSize + portTRACE_BUFFER_SIZE * RecordSize, dump.size());
+  EXPECT_EQ(portTRACE_BUFFER_SIZE, Read32(dump, 12));
+  EXPECT_EQ(88u, Read32(dump, 16));
+  const size_t records = HeaderSize + 3 * TaskSize;
+  for (size_t i = 0; i < portTRACE_BUFFER_SIZE; i++) {
+    ASSERT_EQ(88 + i, Read16(dump, records + i * RecordSize + 6));
+  }
+}
+
+TEST_F(TraceTest, DumpFailsWhenTheFileSystemIsFull) {
+  Record(10, Trace::Events::TaskSwitchedIn, 2);
+  fs.SetCapacity(HeaderSize + TaskSize);
+  EXPECT_FALSE(Trace::Dump(fs));
+  EXPECT_EQ(Trace::DumpStates::Failed, Trace::GetDumpState());
+}
+
+TEST_F(TraceTest, ConvertedToTheChromeTraceFormat) {
+#if defined(PYTHON3_EXECUTABLE) && defined(TRACE2CHROME)
+  // 32 ticks of the 32768Hz counter are 976.5625us. The counter wraps around (24 bits) during the display flush.
+  const uint32_t start = CounterMask - 40;
+  Record(start, Trace::Events::TaskSwitchedIn, 3);
+  Record(start + 32, Trace::Events::FlushDisplayStart, 240);
+  Record(start + 64, Trace::Events::FlushDisplayEnd);
+  Record(start + 96, Trace::Events::DisplayMessagePosted, 5);
+  Record(start + 128, Trace::Events::TaskSwitchedIn, 1);
+  Record(start + 160, Trace::Events::TaskSwitchedIn, 3);
+  ASSERT_TRUE(Trace::Dump(fs));
+
+  const std::string dumpPath = ::testing::TempDir() + "trace.bin";
+  const std::string jsonPath = ::testing::TempDir() + "trace.json";
+  const auto& dump = fs.Content(Trace::dumpFileName);
+  std::ofstream(dumpPath, std::ios::binary).write(reinterpret_cast<const char*>(dump.data()), dump.size());
+  const std::string command =
+    std::string("\"") + PYTHON3_EXECUTABLE + "\" \"" + TRACE2CHROME + "\" \"" + dumpPath + "\" \"" + jsonPath + "\"";
+  ASSERT_EQ(0, std::system(command.c_str()));
+
+  std::ifstream file(jsonPath);
+  const std::string json {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  const char* expected[] = {
+    R"({"ph": "M", "name": "thread_name", "pid": 1, "tid": 3, "args": {"name": "disp"}})",
+    R"({"ph": "X", "name": "FlushDisplay", "pid": 1, "tid": 1001, "ts": 976.5625, "dur": 976.5625, )"
+    R"("args": {"argument": 240, "end_argument": 0}})",
+    R"({"ph": "i", "s": "t", "name": "DisplayApp message", "pid": 1, "tid": 1003, "ts": 2929.6875, )"
+    R"("args": {"message": "5"}})",
+    R"({"ph": "X", "name": "disp", "pid": 1, "tid": 3, "ts": 0.0, "dur": 3906.25})",
+    R"({"ph": "X", "name": "IDLE", "pid": 1, "tid": 1, "ts": 3906.25, "dur": 976.5625})",
+    R"("otherData": {"lostEvents": 0})",
+  };
+  for (const char* event : expected) {
+    EXPECT_NE(std::string::npos, json.find(event)) << event << " not in " << json;
+  }
+#else
+  GTEST_SKIP() << "Python 3 not found";
+#endif
+}
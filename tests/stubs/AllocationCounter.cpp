@@ -0,0 +1,41 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+  std::atomic<bool> counting {false};
+  std::atomic<size_t> allocations {0};
+}
+
+void* operator new(std::size_t size) {
+  if (counting) {
+    allocations++;
+  }
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t /*size*/) noexcept {
+  std::free(p);
+}
+
+AllocationCounter::AllocationCounter() {
+  allocations = 0;
+  counting = true;
+}
+
+AllocationCounter::~AllocationCounter() {
+  counting = false;
+}
+
+size_t AllocationCounter::Allocations() const {
+  return allocations;
+}
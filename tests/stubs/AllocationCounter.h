@@ -0,0 +1,16 @@
+#pragma once
+// Counts the allocations of the global operator new, for the tests: AllocationCounter.cpp replaces it, and is built
+// only in the tests that count them
+#include <cstddef>
+
+class AllocationCounter {
+public:
+  /// Counts the allocations made while the counter exists
+  AllocationCounter();
+  ~AllocationCounter();
+
+  AllocationCounter(const AllocationCounter&) = delete;
+  AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+  size_t Allocations() const;
+};
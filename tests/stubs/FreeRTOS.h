@@ -0,0 +1,17 @@
+#pragma once
+// Host replacement for FreeRTOS: a single task, with a tick count set by the tests (see Stubs.h)
+#include <cstdint>
+#include "nrf.h" // like FreeRTOSConfig.h
+
+using TickType_t = uint32_t;
+using BaseType_t = long;
+using UBaseType_t = unsigned long;
+
+#define pdFALSE ((BaseType_t) 0)
+#define pdTRUE  ((BaseType_t) 1)
+#define pdPASS  pdTRUE
+#define portMAX_DELAY ((TickType_t) 0xffffffffUL)
+#define configTICK_RATE_HZ 1024
+#define configMAX_TASK_NAME_LEN 4
+#define pdMS_TO_TICKS(ms) ((TickType_t) (((TickType_t) (ms) * (TickType_t) configTICK_RATE_HZ) / (TickType_t) 1000))
+#define portYIELD_FROM_ISR(x) ((void) (x))
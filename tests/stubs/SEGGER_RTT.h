@@ -0,0 +1,24 @@
+#pragma once
+// The logs of NimBLE (modlog.h) are printed on the RTT of the debugger: discarded on the host.
+// modlog.h defines printf() as SEGGER_RTT_printf(): stdio.h is included before, so that it still declares printf().
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SEGGER_RTT_MODE_NO_BLOCK_SKIP 0
+
+// The bytes written to the up buffers are kept by the stubs, see Stubs.h
+unsigned SEGGER_RTT_Write(unsigned bufferIndex, const void* buffer, unsigned numBytes);
+int SEGGER_RTT_ConfigUpBuffer(unsigned bufferIndex, const char* name, void* buffer, unsigned bufferSize, unsigned flags);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline int SEGGER_RTT_printf(unsigned bufferIndex, const char* format, ...) {
+  (void) bufferIndex;
+  (void) format;
+  return 0;
+}
@@ -0,0 +1,159 @@
+#include "Stubs.h"
+#include "nrf.h"
+#include "SEGGER_RTT.h"
+#include "semphr.h"
+#include "task.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+StubScb stubScb {0};
+StubRtc stubRtc2 {0};
+
+struct StubSemaphore {
+  bool available;
+};
+
+namespace {
+  std::atomic<TickType_t> tickCount {0};
+  uint32_t notificationCount = 0;
+  // Like the firmware, the tests never delete most of their semaphores: they live until the end of the process
+  std::deque<StubSemaphore> semaphores;
+  // Critical sections nest
+  std::recursive_mutex critical;
+  std::vector<TaskStatus_t> tasks;
+  std::vector<uint8_t> rttOutput;
+  size_t rttCapacity = SIZE_MAX;
+}
+
+void Stubs::SetTickCount(TickType_t ticks) {
+  tickCount = ticks;
+}
+
+void Stubs::AdvanceTicks(TickType_t ticks) {
+  tickCount += ticks;
+}
+
+void Stubs::SetInIsr(bool isr) {
+  // Any active exception number
+  stubScb.ICSR = isr ? 0x10 : 0;
+}
+
+void Stubs::SetTasks(const std::vector<TaskStatus_t>& newTasks) {
+  tasks = newTasks;
+}
+
+std::vector<uint8_t> Stubs::TakeRttOutput() {
+  std::vector<uint8_t> output;
+  output.swap(rttOutput);
+  return output;
+}
+
+void Stubs::SetRttCapacity(size_t bytes) {
+  rttCapacity = bytes;
+}
+
+unsigned SEGGER_RTT_Write(unsigned /*bufferIndex*/, const void* buffer, unsigned numBytes) {
+  // SEGGER_RTT_MODE_NO_BLOCK_SKIP: what doesn't fit is dropped
+  if (rttOutput.size() + numBytes > rttCapacity) {
+    return 0;
+  }
+  const auto* bytes = static_cast<const uint8_t*>(buffer);
+  rttOutput.insert(rttOutput.end(), bytes, bytes + numBytes);
+  return numBytes;
+}
+
+int SEGGER_RTT_ConfigUpBuffer(unsigned /*bufferIndex*/,
+                              const char* /*name*/,
+                              void* /*buffer*/,
+                              unsigned /*bufferSize*/,
+                              unsigned /*flags*/) {
+  return 0;
+}
+
+TickType_t xTaskGetTickCount() {
+  return tickCount;
+}
+
+TickType_t xTaskGetTickCountFromISR() {
+  return tickCount;
+}
+
+void vPortEnterCritical() {
+  critical.lock();
+}
+
+void vPortExitCritical() {
+  critical.unlock();
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t* taskStatusArray, UBaseType_t arraySize, uint32_t* totalRunTime) {
+  // Like FreeRTOS, nothing is returned if the array is too small
+  if (arraySize < tasks.size()) {
+    return 0;
+  }
+  std::copy(tasks.begin(), tasks.end(), taskStatusArray);
+  if (totalRunTime != nullptr) {
+    *totalRunTime = 0;
+  }
+  return tasks.size();
+}
+
+BaseType_t xTaskGetSchedulerState() {
+  return taskSCHEDULER_RUNNING;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  return &notificationCount;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t /*timeout*/) {
+  const uint32_t count = notificationCount;
+  if (count > 0) {
+    notificationCount = (clearCountOnExit == pdTRUE) ? 0 : count - 1;
+  }
+  return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t /*task*/) {
+  notificationCount++;
+  return pdPASS;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+  semaphores.push_back({false});
+  return &semaphores.back();
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  semaphores.push_back({true});
+  return &semaphores.back();
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+  semaphore->available = false;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t timeout) {
+  std::lock_guard<std::recursive_mutex> lock {critical};
+  if (semaphore->available) {
+    semaphore->available = false;
+    return pdTRUE;
+  }
+  if (timeout != portMAX_DELAY) {
+    tickCount += timeout;
+  }
+  return pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  std::lock_guard<std::recursive_mutex> lock {critical};
+  semaphore->available = true;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t* higherPriorityTaskWoken) {
+  *higherPriorityTaskWoken = pdFALSE;
+  return xSemaphoreGive(semaphore);
+}
@@ -0,0 +1,20 @@
+#pragma once
+// Controls of the host stubs, for the tests
+#include "FreeRTOS.h"
+#include "task.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Stubs {
+  void SetTickCount(TickType_t ticks);
+  void AdvanceTicks(TickType_t ticks);
+  /// Code run between SetInIsr(true) and SetInIsr(false) behaves as if it ran in an interrupt handler
+  void SetInIsr(bool isr);
+  /// Tasks returned by uxTaskGetSystemState()
+  void SetTasks(const std::vector<TaskStatus_t>& tasks);
+  /// Returns and clears the bytes written to the RTT up buffers, like a debugger that reads them
+  std::vector<uint8_t> TakeRttOutput();
+  /// Number of bytes that the RTT up buffers can take until the next TakeRttOutput()
+  void SetRttCapacity(size_t bytes);
+}
@@ -0,0 +1,15 @@
+#pragma once
+// Host replacement for FreeRTOS in the C sources of LVGL and of the FreeRTOS port: the tick of LV_TICK_CUSTOM, defined
+// by the test
+#include <stdint.h>
+#include "nrf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t xTaskGetTickCount(void);
+
+#ifdef __cplusplus
+}
+#endif
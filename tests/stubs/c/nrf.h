@@ -0,0 +1,18 @@
+#pragma once
+// Host replacement for the RTC2 of the nRF52, in the C and C++ sources: its counter is set by the tests
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  volatile uint32_t COUNTER;
+} StubRtc;
+
+extern StubRtc stubRtc2;
+#define NRF_RTC2 (&stubRtc2)
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+    class DateTime {
+    public:
+      void SetTime(uint8_t newHours, uint8_t newMinutes) {
+        hours = newHours;
+        minutes = newMinutes;
+      }
+
+      /// Sets the date and the time of the day, in UTC
+      void SetCurrentTime(std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> t) {
+        currentDateTime = t;
+        const auto secondsOfDay = std::chrono::duration_cast<std::chrono::seconds>(t.time_since_epoch()).count() % (24 * 60 * 60);
+        hours = secondsOfDay / (60 * 60);
+        minutes = (secondsOfDay / 60) % 60;
+        seconds = secondsOfDay % 60;
+      }
+
+      uint8_t Hours() const {
+        return hours;
+      }
+      uint8_t Minutes() const {
+        return minutes;
+      }
+      uint8_t Seconds() const {
+        return seconds;
+      }
+
+      std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> CurrentDateTime() const {
+        return currentDateTime;
+      }
+
+    private:
+      uint8_t hours = 0;
+      uint8_t minutes = 0;
+      uint8_t seconds = 0;
+      std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> currentDateTime;
+    };
+  }
+}
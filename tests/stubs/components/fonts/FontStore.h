@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <lvgl/lvgl.h>
+
+namespace Pinetime {
+  namespace Controllers {
+    /// Records the texts prefetched
+    class FontStore {
+    public:
+      static void Prefetch(const lv_font_t* /*font*/, const char* text) {
+        Prefetched().push_back(text);
+      }
+
+      static std::vector<std::string>& Prefetched() {
+        static std::vector<std::string> texts;
+        return texts;
+      }
+    };
+  }
+}
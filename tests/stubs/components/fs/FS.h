@@ -0,0 +1,93 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+// The error codes and open flags of LittleFS
+enum lfs_error { LFS_ERR_OK = 0, LFS_ERR_NOENT = -2, LFS_ERR_NOSPC = -28 };
+enum lfs_open_flags { LFS_O_RDONLY = 1, LFS_O_WRONLY = 2, LFS_O_RDWR = 3, LFS_O_CREAT = 0x0100, LFS_O_TRUNC = 0x0400 };
+
+struct lfs_file_t {
+  std::vector<uint8_t>* content;
+  uint32_t position;
+};
+
+namespace Pinetime {
+  namespace Controllers {
+    /// Files in memory. The writes fail once the file system is full.
+    class FS {
+    public:
+      int FileOpen(lfs_file_t* file_p, const char* fileName, const int flags) {
+        auto it = files.find(fileName);
+        if (it == files.end()) {
+          if ((flags & LFS_O_CREAT) == 0) {
+            return LFS_ERR_NOENT;
+          }
+          it = files.emplace(fileName, std::vector<uint8_t> {}).first;
+        }
+        if ((flags & LFS_O_TRUNC) != 0) {
+          it->second.clear();
+        }
+        *file_p = {&it->second, 0};
+        return LFS_ERR_OK;
+      }
+
+      int FileClose(lfs_file_t* /*file_p*/) {
+        return LFS_ERR_OK;
+      }
+
+      int FileRead(lfs_file_t* file_p, uint8_t* buff, uint32_t size) {
+        nbReads++;
+        const auto count = std::min<size_t>(size, file_p->content->size() - file_p->position);
+        std::memcpy(buff, file_p->content->data() + file_p->position, count);
+        file_p->position += count;
+        bytesRead += count;
+        return static_cast<int>(count);
+      }
+
+      int FileSeek(lfs_file_t* file_p, uint32_t pos) {
+        file_p->position = std::min<size_t>(pos, file_p->content->size());
+        return static_cast<int>(file_p->position);
+      }
+
+      int FileWrite(lfs_file_t* file_p, const uint8_t* buff, uint32_t size) {
+        if (used + size > capacity) {
+          return LFS_ERR_NOSPC;
+        }
+        used += size;
+        auto& content = *file_p->content;
+        content.resize(std::max<size_t>(content.size(), file_p->position + size));
+        std::memcpy(content.data() + file_p->position, buff, size);
+        file_p->position += size;
+        return static_cast<int>(size);
+      }
+
+      /// Content of a file, for the tests
+      std::vector<uint8_t>& Content(const std::string& fileName) {
+        return files[fileName];
+      }
+
+      void Delete(const std::string& fileName) {
+        files.erase(fileName);
+      }
+
+      /// Bytes that can still be written, for the tests
+      void SetCapacity(size_t bytes) {
+        capacity = used + bytes;
+      }
+
+    private:
+      std::map<std::string, std::vector<uint8_t>> files;
+      size_t used = 0;
+      size_t capacity = SIZE_MAX;
+
+    public:
+      // Calls to FileRead() and bytes read, for the tests
+      uint32_t nbReads = 0;
+      size_t bytesRead = 0;
+    };
+  }
+}
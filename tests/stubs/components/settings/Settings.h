@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+    class Settings {
+    public:
+      enum class ClockType : uint8_t { H24, H12 };
+
+      void SetClockType(ClockType type) {
+        clockType = type;
+      }
+      ClockType GetClockType() const {
+        return clockType;
+      }
+
+    private:
+      ClockType clockType = ClockType::H24;
+    };
+  }
+}
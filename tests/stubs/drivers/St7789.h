@@ -0,0 +1,48 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace Pinetime {
+  namespace Drivers {
+    /// Frame memory of the display (RGB565) and state of its low power mode
+    class St7789 {
+    public:
+      static constexpr uint16_t Width = 240;
+      static constexpr uint16_t Height = 320;
+
+      void VerticalScrollStartAddress(uint16_t line) {
+        scrollStartAddress = line;
+      }
+
+      void DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* data, size_t size) {
+        for (uint16_t line = 0; line < height; line++) {
+          std::memcpy(&frame[(y + line) * Width + x], data + line * width * 2, width * 2);
+        }
+        nbBytesWritten += size;
+      }
+
+      void LowPowerOn(uint16_t first, uint16_t last) {
+        lowPower = true;
+        firstLine = first;
+        lastLine = last;
+      }
+
+      void LowPowerOff() {
+        lowPower = false;
+      }
+
+      uint16_t Pixel(uint16_t x, uint16_t y) const {
+        return frame[y * Width + x];
+      }
+
+      std::array<uint16_t, Width * Height> frame {};
+      size_t nbBytesWritten = 0;
+      uint16_t scrollStartAddress = 0;
+      bool lowPower = false;
+      uint16_t firstLine = 0;
+      uint16_t lastLine = 0;
+    };
+  }
+}
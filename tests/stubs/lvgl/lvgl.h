@@ -0,0 +1,488 @@
+#pragma once
+// The few objects and functions of LVGL used by the code under test. The objects only have a position, a size and a
+// text, and the areas LVGL would redraw are recorded instead of drawn. The deleted objects are kept, marked as deleted.
+// The image decoders and the design callbacks are registered, for the tests to call them like LVGL would, and the lines
+// drawn are recorded.
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+using lv_coord_t = int16_t;
+using lv_opa_t = uint8_t;
+using lv_style_int_t = int16_t;
+
+struct lv_font_glyph_dsc_t {
+  uint16_t adv_w;
+  uint16_t box_w;
+  uint16_t box_h;
+  int16_t ofs_x;
+  int16_t ofs_y;
+  uint8_t bpp;
+};
+
+enum { LV_FONT_SUBPX_NONE = 0 };
+
+struct lv_font_t {
+  // Monospaced, for the labels of the stub
+  lv_coord_t glyphWidth;
+  lv_coord_t lineHeight;
+  // The fonts of LVGL, for the fonts defined by the code under test
+  bool (*get_glyph_dsc)(const lv_font_t*, lv_font_glyph_dsc_t*, uint32_t letter, uint32_t nextLetter) = nullptr;
+  const uint8_t* (*get_glyph_bitmap)(const lv_font_t*, uint32_t) = nullptr;
+  lv_coord_t line_height = 0;
+  lv_coord_t base_line = 0;
+  uint8_t subpx = 0;
+  int8_t underline_position = 0;
+  int8_t underline_thickness = 0;
+  void* dsc = nullptr;
+};
+
+// The fallback font of the firmware (lv_conf.h)
+extern lv_font_t jetbrains_mono_bold_20;
+
+struct lv_area_t {
+  lv_coord_t x1;
+  lv_coord_t y1;
+  lv_coord_t x2;
+  lv_coord_t y2;
+};
+
+struct lv_point_t {
+  lv_coord_t x;
+  lv_coord_t y;
+};
+
+using lv_design_res_t = uint8_t;
+enum { LV_DESIGN_RES_OK, LV_DESIGN_RES_COVER, LV_DESIGN_RES_NOT_COVER, LV_DESIGN_RES_MASKED };
+using lv_design_mode_t = uint8_t;
+enum { LV_DESIGN_DRAW_MAIN, LV_DESIGN_DRAW_POST, LV_DESIGN_COVER_CHK };
+
+struct lv_obj_t;
+using lv_design_cb_t = lv_design_res_t (*)(lv_obj_t*, const lv_area_t*, lv_design_mode_t);
+
+struct lv_obj_t {
+  lv_obj_t* parent;
+  lv_coord_t x;
+  lv_coord_t y;
+  lv_coord_t width;
+  lv_coord_t height;
+  bool isLabel;
+  const char* text;
+  const lv_font_t* font;
+  bool deleted;
+  // In screen coordinates, updated when the object is moved or resized
+  lv_area_t coords {};
+  void* user_data = nullptr;
+  lv_design_cb_t design_cb = nullptr;
+};
+
+struct _lv_task_t;
+using lv_task_t = _lv_task_t;
+
+enum { LV_CONT_PART_MAIN = 0, LV_LABEL_PART_MAIN = 0 };
+enum { LV_STATE_DEFAULT = 0 };
+enum { LV_OPA_TRANSP = 0 };
+
+// The color format of the firmware (lv_conf.h): LV_COLOR_DEPTH 16, LV_COLOR_16_SWAP 1
+#define LV_HOR_RES_MAX            240
+#define LV_VER_RES_MAX            240
+#define LV_HOR_RES                LV_HOR_RES_MAX
+#define LV_VER_RES                LV_VER_RES_MAX
+#define LV_COLOR_SIZE             16
+#define LV_IMG_PX_SIZE_ALPHA_BYTE 3
+
+union lv_color_t {
+  struct {
+    uint16_t green_h : 3;
+    uint16_t red : 5;
+    uint16_t blue : 5;
+    uint16_t green_l : 3;
+  } ch;
+  uint16_t full;
+};
+
+inline lv_color_t lv_color_make(uint8_t r, uint8_t g, uint8_t b) {
+  lv_color_t color;
+  color.ch.red = r >> 3;
+  color.ch.green_h = g >> 5;
+  color.ch.green_l = (g >> 2) & 0x7;
+  color.ch.blue = b >> 3;
+  return color;
+}
+
+using lv_res_t = uint8_t;
+enum { LV_RES_INV = 0, LV_RES_OK };
+
+using lv_img_cf_t = uint8_t;
+enum {
+  LV_IMG_CF_TRUE_COLOR = 4,
+  LV_IMG_CF_TRUE_COLOR_ALPHA = 5,
+  LV_IMG_CF_INDEXED_1BIT = 7,
+  LV_IMG_CF_INDEXED_2BIT = 8,
+  LV_IMG_CF_INDEXED_4BIT = 9,
+  LV_IMG_CF_INDEXED_8BIT = 10,
+};
+
+using lv_img_src_t = uint8_t;
+enum { LV_IMG_SRC_VARIABLE, LV_IMG_SRC_FILE, LV_IMG_SRC_SYMBOL, LV_IMG_SRC_UNKNOWN };
+
+struct lv_img_header_t {
+  uint32_t cf : 5;
+  uint32_t always_zero : 3;
+  uint32_t reserved : 2;
+  uint32_t w : 11;
+  uint32_t h : 11;
+};
+
+struct _lv_img_decoder;
+
+struct lv_img_decoder_dsc_t {
+  _lv_img_decoder* decoder;
+  const void* src;
+  lv_img_header_t header;
+  const uint8_t* img_data;
+  void* user_data;
+};
+
+using lv_img_decoder_info_f_t = lv_res_t (*)(_lv_img_decoder*, const void*, lv_img_header_t*);
+using lv_img_decoder_open_f_t = lv_res_t (*)(_lv_img_decoder*, lv_img_decoder_dsc_t*);
+using lv_img_decoder_read_line_f_t = lv_res_t (*)(_lv_img_decoder*, lv_img_decoder_dsc_t*, lv_coord_t, lv_coord_t, lv_coord_t, uint8_t*);
+using lv_img_decoder_close_f_t = void (*)(_lv_img_decoder*, lv_img_decoder_dsc_t*);
+
+struct _lv_img_decoder {
+  lv_img_decoder_info_f_t info_cb;
+  lv_img_decoder_open_f_t open_cb;
+  lv_img_decoder_read_line_f_t read_line_cb;
+  lv_img_decoder_close_f_t close_cb;
+  void* user_data;
+};
+using lv_img_decoder_t = _lv_img_decoder;
+
+namespace Stubs {
+  struct Lvgl {
+    std::deque<lv_obj_t> objects;
+    std::deque<lv_img_decoder_t> decoders;
+    // Areas invalidated since the last ClearInvalidated(), in screen coordinates
+    std::vector<lv_area_t> invalidated;
+    // Objects whose animation was started
+    std::vector<lv_obj_t*> animated;
+    // Lines drawn by lv_draw_line()
+    struct Line {
+      lv_point_t start;
+      lv_point_t end;
+      lv_area_t clip;
+      lv_style_int_t width;
+    };
+    std::vector<Line> lines;
+    lv_obj_t* activeScreen = nullptr;
+  };
+
+  inline Lvgl& GetLvgl() {
+    static Lvgl lvgl;
+    return lvgl;
+  }
+
+  inline lv_area_t ScreenArea(const lv_obj_t* obj) {
+    lv_coord_t x = 0;
+    lv_coord_t y = 0;
+    for (const lv_obj_t* o = obj; o != nullptr; o = o->parent) {
+      x += o->x;
+      y += o->y;
+    }
+    return {x, y, static_cast<lv_coord_t>(x + obj->width - 1), static_cast<lv_coord_t>(y + obj->height - 1)};
+  }
+
+  inline void Invalidate(const lv_obj_t* obj) {
+    GetLvgl().invalidated.push_back(ScreenArea(obj));
+  }
+}
+
+inline lv_obj_t* lv_cont_create(lv_obj_t* parent, const lv_obj_t* /*copy*/) {
+  auto& objects = Stubs::GetLvgl().objects;
+  objects.push_back({parent, 0, 0, 0, 0, false, nullptr, nullptr, false});
+  return &objects.back();
+}
+
+inline lv_obj_t* lv_obj_create(lv_obj_t* parent, const lv_obj_t* copy) {
+  return lv_cont_create(parent, copy);
+}
+
+inline lv_obj_t* lv_label_create(lv_obj_t* parent, const lv_obj_t* /*copy*/) {
+  auto& objects = Stubs::GetLvgl().objects;
+  objects.push_back({parent, 0, 0, 0, 0, true, "", nullptr, false});
+  return &objects.back();
+}
+
+inline void lv_label_set_text_static(lv_obj_t* label, const char* text) {
+  // The label is resized to its text: both the old and the new areas are redrawn
+  Stubs::Invalidate(label);
+  label->text = text;
+  label->width = (label->font == nullptr) ? 0 : static_cast<lv_coord_t>(label->font->glyphWidth * std::strlen(text));
+  label->height = (label->font == nullptr) ? 0 : label->font->lineHeight;
+  Stubs::Invalidate(label);
+}
+
+namespace Stubs {
+  inline bool IsDescendant(const lv_obj_t* obj, const lv_obj_t* ancestor) {
+    for (const lv_obj_t* o = obj->parent; o != nullptr; o = o->parent) {
+      if (o == ancestor) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Number of objects created on screen and not deleted, the screen excluded
+  inline size_t NbChildren(const lv_obj_t* screen) {
+    size_t nbChildren = 0;
+    for (const auto& obj : GetLvgl().objects) {
+      if (!obj.deleted && IsDescendant(&obj, screen)) {
+        nbChildren++;
+      }
+    }
+    return nbChildren;
+  }
+}
+
+inline lv_obj_t* lv_scr_act() {
+  auto& lvgl = Stubs::GetLvgl();
+  if (lvgl.activeScreen == nullptr) {
+    lvgl.activeScreen = lv_obj_create(nullptr, nullptr);
+  }
+  return lvgl.activeScreen;
+}
+
+inline void lv_scr_load(lv_obj_t* screen) {
+  Stubs::GetLvgl().activeScreen = screen;
+}
+
+inline void lv_obj_clean(lv_obj_t* obj) {
+  for (auto& o : Stubs::GetLvgl().objects) {
+    if (Stubs::IsDescendant(&o, obj)) {
+      o.deleted = true;
+    }
+  }
+}
+
+inline void lv_obj_del(lv_obj_t* obj) {
+  lv_obj_clean(obj);
+  obj->deleted = true;
+}
+
+inline const char* lv_label_get_text(const lv_obj_t* label) {
+  return label->text;
+}
+
+inline void lv_obj_set_pos(lv_obj_t* obj, lv_coord_t x, lv_coord_t y) {
+  obj->x = x;
+  obj->y = y;
+  obj->coords = Stubs::ScreenArea(obj);
+}
+
+inline void lv_obj_set_y(lv_obj_t* obj, lv_coord_t y) {
+  obj->y = y;
+}
+
+inline void lv_obj_set_size(lv_obj_t* obj, lv_coord_t width, lv_coord_t height) {
+  obj->width = width;
+  obj->height = height;
+  obj->coords = Stubs::ScreenArea(obj);
+}
+
+inline lv_coord_t lv_obj_get_width(const lv_obj_t* obj) {
+  return obj->width;
+}
+
+inline lv_coord_t lv_obj_get_height(const lv_obj_t* obj) {
+  return obj->height;
+}
+
+inline void lv_obj_set_style_local_bg_opa(lv_obj_t* /*obj*/, uint8_t /*part*/, int /*state*/, lv_opa_t /*opa*/) {
+}
+
+inline void lv_obj_set_style_local_border_width(lv_obj_t* /*obj*/, uint8_t /*part*/, int /*state*/, lv_style_int_t /*width*/) {
+}
+
+inline void lv_obj_set_style_local_text_font(lv_obj_t* obj, uint8_t /*part*/, int /*state*/, const lv_font_t* font) {
+  obj->font = font;
+}
+
+inline const lv_font_t* lv_obj_get_style_text_font(const lv_obj_t* obj, uint8_t /*part*/) {
+  return obj->font;
+}
+
+// The code point of the UTF-8 character at index i, and i moved to the next character
+inline uint32_t _lv_txt_encoded_next(const char* text, uint32_t* i) {
+  const auto first = static_cast<uint8_t>(text[(*i)++]);
+  if (first < 0x80) {
+    return first;
+  }
+  const int nbBytes = (first >= 0xf0) ? 4 : (first >= 0xe0) ? 3 : 2;
+  uint32_t codePoint = first & (0x7f >> nbBytes);
+  for (int n = 1; n < nbBytes && text[*i] != '\0'; n++) {
+    codePoint = (codePoint << 6) | (static_cast<uint8_t>(text[(*i)++]) & 0x3f);
+  }
+  return codePoint;
+}
+
+inline lv_coord_t lv_font_get_glyph_width(const lv_font_t* font, uint32_t /*letter*/, uint32_t /*nextLetter*/) {
+  return font->glyphWidth;
+}
+
+inline lv_coord_t lv_font_get_line_height(const lv_font_t* font) {
+  return font->lineHeight;
+}
+
+inline void lv_obj_set_click(lv_obj_t* /*obj*/, bool /*enabled*/) {
+}
+
+inline void lv_obj_set_user_data(lv_obj_t* obj, void* data) {
+  obj->user_data = data;
+}
+
+inline void* lv_obj_get_user_data(const lv_obj_t* obj) {
+  return obj->user_data;
+}
+
+inline void lv_obj_set_design_cb(lv_obj_t* obj, lv_design_cb_t callback) {
+  obj->design_cb = callback;
+}
+
+// Like LVGL, the area is clipped to the object
+inline void lv_obj_invalidate_area(const lv_obj_t* obj, const lv_area_t* area) {
+  const lv_area_t clipped {std::max(area->x1, obj->coords.x1),
+                           std::max(area->y1, obj->coords.y1),
+                           std::min(area->x2, obj->coords.x2),
+                           std::min(area->y2, obj->coords.y2)};
+  if (clipped.x1 <= clipped.x2 && clipped.y1 <= clipped.y2) {
+    Stubs::GetLvgl().invalidated.push_back(clipped);
+  }
+}
+
+struct lv_draw_line_dsc_t {
+  lv_color_t color;
+  lv_style_int_t width;
+  lv_opa_t opa;
+  uint8_t round_start : 1;
+  uint8_t round_end : 1;
+};
+
+inline void lv_draw_line_dsc_init(lv_draw_line_dsc_t* dsc) {
+  std::memset(dsc, 0, sizeof(*dsc));
+  dsc->width = 1;
+  dsc->opa = 255;
+}
+
+inline void lv_draw_line(const lv_point_t* point1, const lv_point_t* point2, const lv_area_t* clip, const lv_draw_line_dsc_t* dsc) {
+  Stubs::GetLvgl().lines.push_back({*point1, *point2, *clip, dsc->width});
+}
+
+// sin(angle) * 32767, from the table of sines of 0 to 90 degrees like LVGL
+inline int16_t _lv_trigo_sin(int16_t angle) {
+  angle %= 360;
+  if (angle < 0) {
+    angle += 360;
+  }
+  auto table = [](int16_t degrees) {
+    return static_cast<int16_t>(std::lround(32767 * std::sin(degrees * M_PI / 180)));
+  };
+  if (angle < 90) {
+    return table(angle);
+  }
+  if (angle < 180) {
+    return table(180 - angle);
+  }
+  if (angle < 270) {
+    return -table(angle - 180);
+  }
+  return -table(360 - angle);
+}
+
+using lv_anim_exec_xcb_t = void (*)(void*, lv_coord_t);
+
+struct lv_anim_t {
+  void* var;
+};
+
+inline void lv_anim_init(lv_anim_t* animation) {
+  animation->var = nullptr;
+}
+
+inline void lv_anim_set_var(lv_anim_t* animation, void* var) {
+  animation->var = var;
+}
+
+inline void lv_anim_set_exec_cb(lv_anim_t* /*animation*/, lv_anim_exec_xcb_t /*callback*/) {
+}
+
+inline void lv_anim_set_values(lv_anim_t* /*animation*/, lv_coord_t /*start*/, lv_coord_t /*end*/) {
+}
+
+inline void lv_anim_set_time(lv_anim_t* /*animation*/, uint32_t /*duration*/) {
+}
+
+inline void lv_anim_start(lv_anim_t* animation) {
+  Stubs::GetLvgl().animated.push_back(static_cast<lv_obj_t*>(animation->var));
+}
+
+inline lv_img_decoder_t* lv_img_decoder_create() {
+  auto& decoders = Stubs::GetLvgl().decoders;
+  decoders.push_back({});
+  return &decoders.back();
+}
+
+inline void lv_img_decoder_set_info_cb(lv_img_decoder_t* decoder, lv_img_decoder_info_f_t callback) {
+  decoder->info_cb = callback;
+}
+
+inline void lv_img_decoder_set_open_cb(lv_img_decoder_t* decoder, lv_img_decoder_open_f_t callback) {
+  decoder->open_cb = callback;
+}
+
+inline void lv_img_decoder_set_read_line_cb(lv_img_decoder_t* decoder, lv_img_decoder_read_line_f_t callback) {
+  decoder->read_line_cb = callback;
+}
+
+inline void lv_img_decoder_set_close_cb(lv_img_decoder_t* decoder, lv_img_decoder_close_f_t callback) {
+  decoder->close_cb = callback;
+}
+
+inline uint8_t lv_img_cf_get_px_size(lv_img_cf_t cf) {
+  switch (cf) {
+    case LV_IMG_CF_TRUE_COLOR:
+      return LV_COLOR_SIZE;
+    case LV_IMG_CF_TRUE_COLOR_ALPHA:
+      return LV_IMG_PX_SIZE_ALPHA_BYTE * 8;
+    case LV_IMG_CF_INDEXED_1BIT:
+      return 1;
+    case LV_IMG_CF_INDEXED_2BIT:
+      return 2;
+    case LV_IMG_CF_INDEXED_4BIT:
+      return 4;
+    case LV_IMG_CF_INDEXED_8BIT:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+// Like LVGL: a path starts with a printable ASCII character, a symbol with a UTF-8 sequence
+inline lv_img_src_t lv_img_src_get_type(const void* source) {
+  const auto first = *static_cast<const uint8_t*>(source);
+  if (first >= 0x20 && first <= 0x7f) {
+    return LV_IMG_SRC_FILE;
+  }
+  return (first >= 0x80) ? LV_IMG_SRC_SYMBOL : LV_IMG_SRC_VARIABLE;
+}
+
+inline void* lv_mem_alloc(size_t size) {
+  return std::malloc(size);
+}
+
+inline void lv_mem_free(void* data) {
+  std::free(data);
+}
@@ -0,0 +1,18 @@
+/* The functions of the NimBLE host that the services under test call to notify the phone: nothing is connected */
+#include <stddef.h>
+#include <stdint.h>
+
+struct os_mbuf;
+
+struct os_mbuf* ble_hs_mbuf_from_flat(const void* buf, uint16_t len) {
+  (void) buf;
+  (void) len;
+  return NULL;
+}
+
+int ble_gattc_notify_custom(uint16_t conn_handle, uint16_t att_handle, struct os_mbuf* om) {
+  (void) conn_handle;
+  (void) att_handle;
+  (void) om;
+  return 0;
+}
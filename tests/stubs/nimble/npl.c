@@ -0,0 +1,21 @@
+// The host tests run the mbufs of NimBLE on a single thread: no critical sections, no event queues
+#include "nimble/nimble_npl.h"
+
+uint32_t ble_npl_hw_enter_critical(void) {
+  return 0;
+}
+
+void ble_npl_hw_exit_critical(uint32_t ctx) {
+  (void) ctx;
+}
+
+void ble_npl_event_init(struct ble_npl_event* ev, ble_npl_event_fn* fn, void* arg) {
+  (void) ev;
+  (void) fn;
+  (void) arg;
+}
+
+void ble_npl_eventq_put(struct ble_npl_eventq* evq, struct ble_npl_event* ev) {
+  (void) evq;
+  (void) ev;
+}
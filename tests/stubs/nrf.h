@@ -0,0 +1,11 @@
+#pragma once
+// Host replacement for the registers of the nRF52 used by the firmware
+#include <cstdint>
+#include "c/nrf.h"
+
+struct StubScb {
+  volatile uint32_t ICSR;
+};
+extern StubScb stubScb;
+#define SCB (&stubScb)
+#define SCB_ICSR_VECTACTIVE_Msk 0x1FFUL
@@ -0,0 +1,5 @@
+#pragma once
+
+#include <cassert>
+
+#define ASSERT(expr) assert(expr)
@@ -0,0 +1,6 @@
+#pragma once
+// The logs of the SDK are printed on the RTT of the debugger: discarded on the host
+
+#define NRF_LOG_INFO(...)
+#define NRF_LOG_WARNING(...)
+#define NRF_LOG_ERROR(...)
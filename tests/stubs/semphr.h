@@ -0,0 +1,13 @@
+#pragma once
+#include "FreeRTOS.h"
+
+struct StubSemaphore;
+using SemaphoreHandle_t = StubSemaphore*;
+
+SemaphoreHandle_t xSemaphoreCreateBinary();
+SemaphoreHandle_t xSemaphoreCreateMutex();
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
+/// Doesn't wait: the tick count advances by timeout if the semaphore can't be taken
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t timeout);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t* higherPriorityTaskWoken);
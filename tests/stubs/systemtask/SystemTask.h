@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+    class NimbleController {
+    public:
+      uint16_t connHandle() const {
+        return 0;
+      }
+    };
+  }
+
+  namespace System {
+    class SystemTask {
+    public:
+      Controllers::NimbleController& nimble() {
+        return nimbleController;
+      }
+
+    private:
+      Controllers::NimbleController nimbleController;
+    };
+  }
+}
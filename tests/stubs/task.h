@@ -0,0 +1,34 @@
+#pragma once
+#include "FreeRTOS.h"
+
+using TaskHandle_t = void*;
+
+TickType_t xTaskGetTickCount();
+TickType_t xTaskGetTickCountFromISR();
+
+// The tasks are set by the tests (see Stubs.h)
+struct TaskStatus_t {
+  TaskHandle_t xHandle;
+  const char* pcTaskName;
+  UBaseType_t xTaskNumber;
+  uint32_t ulRunTimeCounter;
+  uint16_t usStackHighWaterMark;
+};
+UBaseType_t uxTaskGetSystemState(TaskStatus_t* taskStatusArray, UBaseType_t arraySize, uint32_t* totalRunTime);
+
+#define taskSCHEDULER_RUNNING ((BaseType_t) 2)
+BaseType_t xTaskGetSchedulerState();
+
+// Single task: the notifications are counted, ulTaskNotifyTake() never waits
+TaskHandle_t xTaskGetCurrentTaskHandle();
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t timeout);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+
+// The critical sections are a single global lock, like on the single core of the nRF52: tests can run code that uses them
+// from several threads
+void vPortEnterCritical();
+void vPortExitCritical();
+#define taskENTER_CRITICAL() vPortEnterCritical()
+#define taskEXIT_CRITICAL() vPortExitCritical()
+#define taskENTER_CRITICAL_FROM_ISR() (vPortEnterCritical(), (UBaseType_t) 0)
+#define taskEXIT_CRITICAL_FROM_ISR(x) ((void) (x), vPortExitCritical())
@@ -0,0 +1,206 @@
+#include "systemtask/MemoryPressure.h"
+#include "displayapp/LvglAllocator.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using Pinetime::Components::LvglAllocator;
+using Pinetime::System::MemoryPressure;
+using Levels = MemoryPressure::Levels;
+using Pools = MemoryPressure::Pools;
+
+namespace {
+  // Counts the bytes allocated from a pool of a given size, like the heaps of the firmware
+  class FakeAllocator {
+  public:
+    explicit FakeAllocator(uint32_t total) : total {total} {
+    }
+
+    bool Allocate(uint32_t size) {
+      if (used + size > total) {
+        return false;
+      }
+      used += size;
+      return true;
+    }
+
+    void Free(uint32_t size) {
+      used -= size;
+    }
+
+    bool Report(MemoryPressure& pressure, Pools pool) const {
+      return pressure.Update(pool, total - used, total);
+    }
+
+  private:
+    const uint32_t total;
+    uint32_t used = 0;
+  };
+}
+
+TEST(MemoryPressureTest, LevelsOfAPool) {
+  MemoryPressure pressure;
+  FakeAllocator heap {1000};
+  EXPECT_FALSE(heap.Report(pressure, Pools::Heap));
+  EXPECT_EQ(Levels::Normal, pressure.GetLevel());
+
+  // 76% used: 24% free
+  heap.Allocate(760);
+  EXPECT_TRUE(heap.Report(pressure, Pools::Heap));
+  EXPECT_EQ(Levels::Low, pressure.GetLevel());
+
+  // 9% free
+  heap.Allocate(150);
+  EXPECT_TRUE(heap.Report(pressure, Pools::Heap));
+  EXPECT_EQ(Levels::Critical, pressure.GetLevel());
+
+  const auto& pool = pressure.GetPool(Pools::Heap);
+  EXPECT_EQ(1000u, pool.total);
+  EXPECT_EQ(90u, pool.free);
+}
+
+TEST(MemoryPressureTest, LevelsGoBackDownWithAMargin) {
+  MemoryPressure pressure;
+  FakeAllocator heap {1000};
+  heap.Allocate(910);
+  heap.Report(pressure, Pools::Heap);
+  ASSERT_EQ(Levels::Critical, pressure.GetLevel());
+
+  // 12% free: above the threshold, but not by 5%
+  heap.Free(30);
+  EXPECT_FALSE(heap.Report(pressure, Pools::Heap));
+  EXPECT_EQ(Levels::Critical, pressure.GetLevel());
+
+  // 15% free
+  heap.Free(30);
+  EXPECT_TRUE(heap.Report(pressure, Pools::Heap));
+  EXPECT_EQ(Levels::Low, pressure.GetLevel());
+
+  // 28% free
+  heap.Free(130);
+  EXPECT_FALSE(heap.Report(pressure, Pools::Heap));
+  EXPECT_EQ(Levels::Low, pressure.GetLevel());
+
+  // 30% free
+  heap.Free(20);
+  EXPECT_TRUE(heap.Report(pressure, Pools::Heap));
+  EXPECT_EQ(Levels::Normal, pressure.GetLevel());
+}
+
+TEST(MemoryPressureTest, TheLevelOfTheSystemIsTheHighestOne) {
+  MemoryPressure pressure;
+  FakeAllocator heap {1000};
+  FakeAllocator freeRtosHeap {17 * 1024};
+  FakeAllocator bleBuffers {12};
+
+  heap.Allocate(800);
+  heap.Report(pressure, Pools::Heap);
+  freeRtosHeap.Report(pressure, Pools::FreeRtosHeap);
+  bleBuffers.Report(pressure, Pools::BleBuffers);
+  EXPECT_EQ(Levels::Low, pressure.GetLevel());
+
+  bleBuffers.Allocate(12);
+  bleBuffers.Report(pressure, Pools::BleBuffers);
+  EXPECT_EQ(Levels::Critical, pressure.GetLevel());
+  EXPECT_EQ(Levels::Low, pressure.GetPool(Pools::Heap).level);
+
+  bleBuffers.Free(12);
+  bleBuffers.Report(pressure, Pools::BleBuffers);
+  EXPECT_EQ(Levels::Low, pressure.GetLevel());
+}
+
+TEST(MemoryPressureTest, LowWatermark) {
+  MemoryPressure pressure;
+  FakeAllocator heap {1000};
+  heap.Allocate(300);
+  heap.Report(pressure, Pools::Heap);
+  heap.Allocate(400);
+  heap.Report(pressure, Pools::Heap);
+  heap.Free(700);
+  heap.Report(pressure, Pools::Heap);
+  EXPECT_EQ(300u, pressure.GetPool(Pools::Heap).lowWatermark);
+  EXPECT_EQ(1000u, pressure.GetPool(Pools::Heap).free);
+}
+
+TEST(MemoryPressureTest, EmptyPoolIsNormal) {
+  MemoryPressure pressure;
+  EXPECT_FALSE(pressure.Update(Pools::BleBuffers, 0, 0));
+  EXPECT_EQ(Levels::Normal, pressure.GetLevel());
+}
+
+TEST(MemoryPressureTest, CyclingThroughTheApps) {
+  // The memory of LVGL, with the same layout as the firmware (LV_MEM_SIZE): block pools of the small sizes, and the
+  // general pool for the rest. The block sizes are larger on the host, where pointers are 8 bytes.
+  constexpr LvglAllocator::SizeClasses sizeClasses {{{16, 64}, {32, 48}, {48, 40}, {96, 48}}};
+  alignas(alignof(void*)) static uint8_t memory[14 * 1024];
+  LvglAllocator allocator {sizeClasses, memory, sizeof(memory)};
+  MemoryPressure pressure;
+
+  Levels highestLevel = Levels::Normal;
+  auto report = [&]() {
+    const auto statistics = allocator.GetStatistics();
+    pressure.Update(Pools::Lvgl, statistics.poolBiggestFree, statistics.poolSize);
+    highestLevel = std::max(highestLevel, pressure.GetLevel());
+  };
+
+  // Allocation profiles of the apps: objects, labels, styles and a few larger buffers (texts, images, charts)
+  struct App {
+    size_t nbObjects;
+    size_t nbSmall;
+    std::vector<size_t> large;
+  };
+  const std::vector<App> apps {
+    {10, 30, {}},                    // a simple app
+    {20, 60, {300}},                 // a list
+    {12, 20, {1024, 512}},           // music: cover and texts
+    {16, 80, {240, 240, 480}},       // a chart
+    {20, 40, {2048, 1024, 512, 256}}, // navigation: the largest one
+  };
+
+  // The watch face stays allocated while the apps are opened
+  std::vector<void*> watchFace;
+  for (size_t i = 0; i < 25; i++) {
+    watchFace.push_back(allocator.Allocate(96));
+    watchFace.push_back(allocator.Allocate(24));
+  }
+  watchFace.push_back(allocator.Allocate(400));
+  report();
+  ASSERT_EQ(Levels::Normal, pressure.GetLevel());
+  const uint32_t biggestFree = allocator.GetStatistics().poolBiggestFree;
+
+  std::mt19937 random {42};
+  for (size_t cycle = 0; cycle < 200; cycle++) {
+    for (const auto& app : apps) {
+      std::vector<void*> blocks;
+      for (size_t i = 0; i < app.nbObjects; i++) {
+        blocks.push_back(allocator.Allocate(96));
+      }
+      for (size_t i = 0; i < app.nbSmall; i++) {
+        blocks.push_back(allocator.Allocate(8 + random() % 40));
+      }
+      for (size_t size : app.large) {
+        blocks.push_back(allocator.Allocate(size));
+      }
+      for (void* block : blocks) {
+        ASSERT_NE(nullptr, block);
+      }
+      report();
+      // The screens are deleted in any order
+      std::shuffle(blocks.begin(), blocks.end(), random);
+      for (void* block : blocks) {
+        allocator.Free(block);
+      }
+
+      // Closing the app gives all its memory back, in a single block
+      report();
+      EXPECT_EQ(biggestFree, allocator.GetStatistics().poolBiggestFree);
+      EXPECT_EQ(Levels::Normal, pressure.GetLevel());
+    }
+  }
+  EXPECT_EQ(0u, allocator.GetStatistics().nbFailures);
+  // Navigation brings the LVGL memory under pressure, the level goes back to normal when it is closed
+  EXPECT_EQ(Levels::Low, highestLevel);
+  std::cout << "LVGL memory: " << biggestFree << " bytes free with the watch face, at least "
+            << pressure.GetPool(Pools::Lvgl).lowWatermark << " with an app" << std::endl;
+}
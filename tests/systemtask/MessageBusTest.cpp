@@ -0,0 +1,227 @@
+#include "systemtask/MessageBus.h"
+#include "Stubs.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+  enum class Messages : uint8_t { Touch, NewTime, Notification, GoToSleep, GoToRunning, BleConnected, Large = 40 };
+  using Bus = Pinetime::System::MessageBus<Messages, 4>;
+
+  class MessageBusTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+      Stubs::SetTickCount(0);
+      Stubs::SetInIsr(false);
+      bus.Init();
+    }
+
+    std::vector<Messages> ReceiveAll() {
+      std::vector<Messages> messages;
+      Messages message;
+      while (bus.Receive(message, 0)) {
+        messages.push_back(message);
+      }
+      return messages;
+    }
+
+    Bus bus {Bus::MaskOf({Messages::Touch, Messages::NewTime, Messages::Notification})};
+  };
+}
+
+TEST_F(MessageBusTest, ReceivesNothingWhenEmpty) {
+  Messages message;
+  EXPECT_FALSE(bus.Receive(message, 10));
+  EXPECT_EQ(10u, xTaskGetTickCount());
+}
+
+TEST_F(MessageBusTest, KeepsThePostingOrderOfRingMessages) {
+  EXPECT_TRUE(bus.Post(Messages::GoToSleep));
+  EXPECT_TRUE(bus.Post(Messages::GoToRunning));
+  EXPECT_TRUE(bus.Post(Messages::GoToSleep));
+  EXPECT_EQ((std::vector<Messages> {Messages::GoToSleep, Messages::GoToRunning, Messages::GoToSleep}), ReceiveAll());
+}
+
+TEST_F(MessageBusTest, KeepsThePostingOrderBetweenCoalescedAndRingMessages) {
+  bus.Post(Messages::NewTime);
+  bus.Post(Messages::GoToSleep);
+  bus.Post(Messages::Touch);
+  bus.Post(Messages::GoToRunning);
+  EXPECT_EQ((std::vector<Messages> {Messages::NewTime, Messages::GoToSleep, Messages::Touch, Messages::GoToRunning}), ReceiveAll());
+}
+
+TEST_F(MessageBusTest, CoalescedMessagesKeepTheirFirstPlace) {
+  bus.Post(Messages::Notification);
+  bus.Post(Messages::Touch);
+  bus.Post(Messages::BleConnected);
+  bus.Post(Messages::Notification);
+  bus.Post(Messages::Touch);
+  EXPECT_EQ((std::vector<Messages> {Messages::Notification, Messages::Touch, Messages::BleConnected}), ReceiveAll());
+  EXPECT_EQ(2u, bus.GetStatistics().coalesced);
+}
+
+TEST_F(MessageBusTest, CoalescedMessageReceivedIsPostedAgainAtTheEnd) {
+  bus.Post(Messages::Touch);
+  bus.Post(Messages::GoToSleep);
+  Messages message;
+  ASSERT_TRUE(bus.Receive(message, 0));
+  EXPECT_EQ(Messages::Touch, message);
+  bus.Post(Messages::Touch);
+  EXPECT_EQ((std::vector<Messages> {Messages::GoToSleep, Messages::Touch}), ReceiveAll());
+}
+
+TEST_F(MessageBusTest, DropsRingMessagesWhenFullButNeverCoalescedOnes) {
+  for (int i = 0; i < 4; i++) {
+    EXPECT_TRUE(bus.Post(Messages::GoToSleep));
+  }
+  EXPECT_FALSE(bus.Post(Messages::GoToRunning));
+  EXPECT_FALSE(bus.Post(Messages::Large));
+  EXPECT_TRUE(bus.Post(Messages::Touch));
+  EXPECT_EQ(2u, bus.GetStatistics().dropped);
+
+  auto messages = ReceiveAll();
+  ASSERT_EQ(5u, messages.size());
+  EXPECT_EQ(Messages::Touch, messages.back());
+}
+
+TEST_F(MessageBusTest, MessagesAbove32AreNeverCoalesced) {
+  bus.Post(Messages::Large);
+  bus.Post(Messages::Large);
+  EXPECT_EQ((std::vector<Messages> {Messages::Large, Messages::Large}), ReceiveAll());
+}
+
+TEST_F(MessageBusTest, KeepsTheOrderWhenTheSequenceWrapsAround) {
+  // 70000 messages: the 16-bit sequence numbers wrap around
+  for (int i = 0; i < 70000; i++) {
+    bus.Post(Messages::GoToSleep);
+    bus.Post(Messages::Touch);
+    bus.Post(Messages::GoToRunning);
+    ASSERT_EQ((std::vector<Messages> {Messages::GoToSleep, Messages::Touch, Messages::GoToRunning}), ReceiveAll());
+  }
+}
+
+TEST_F(MessageBusTest, PostFromAnInterruptHandler) {
+  Stubs::SetInIsr(true);
+  EXPECT_TRUE(bus.Post(Messages::Touch));
+  EXPECT_TRUE(bus.Post(Messages::GoToRunning));
+  Stubs::SetInIsr(false);
+  EXPECT_EQ((std::vector<Messages> {Messages::Touch, Messages::GoToRunning}), ReceiveAll());
+}
+
+TEST_F(MessageBusTest, MeasuresTheLatency) {
+  bus.Post(Messages::GoToSleep);
+  Stubs::AdvanceTicks(25);
+  bus.Post(Messages::Touch);
+  Stubs::AdvanceTicks(5);
+  ReceiveAll();
+  EXPECT_EQ(30u, bus.GetStatistics().maxLatency);
+}
+
+TEST_F(MessageBusTest, MeasuresTheLatencyOfEachCoalescedMessage) {
+  bus.Post(Messages::Touch);
+  Stubs::AdvanceTicks(50);
+  bus.Post(Messages::NewTime);
+  Messages message;
+  ASSERT_TRUE(bus.Receive(message, 0));
+  EXPECT_EQ(Messages::Touch, message);
+  EXPECT_EQ(50u, bus.GetStatistics().maxLatency);
+
+  // NewTime waited 10 ticks, not since Touch was posted
+  Stubs::AdvanceTicks(10);
+  ASSERT_TRUE(bus.Receive(message, 0));
+  EXPECT_EQ(Messages::NewTime, message);
+  EXPECT_EQ(50u, bus.GetStatistics().maxLatency);
+
+  // A coalesced post doesn't move the time of the first one
+  bus.Post(Messages::Notification);
+  Stubs::AdvanceTicks(70);
+  bus.Post(Messages::Notification);
+  ReceiveAll();
+  EXPECT_EQ(70u, bus.GetStatistics().maxLatency);
+}
+
+TEST(MessageBusStressTest, SeveralProducers) {
+  // The BLE host task, the timers and the interrupt handlers post to SystemTask while it receives
+  using StressBus = Pinetime::System::MessageBus<Messages, 8>;
+  constexpr std::array<Messages, 4> ringMessages = {Messages::GoToSleep, Messages::GoToRunning, Messages::BleConnected, Messages::Large};
+  constexpr std::array<Messages, 3> coalescedMessages = {Messages::Touch, Messages::NewTime, Messages::Notification};
+  constexpr int nbProducers = 4;
+  constexpr int nbPostsPerProducer = 50000;
+
+  Stubs::SetTickCount(0);
+  Stubs::SetInIsr(false);
+  StressBus bus {StressBus::MaskOf({Messages::Touch, Messages::NewTime, Messages::Notification})};
+  bus.Init();
+
+  std::array<std::atomic<uint32_t>, 64> posted {};
+  std::array<uint32_t, 64> received {};
+  std::atomic<int> nbRunningProducers {nbProducers};
+
+  std::thread consumer([&]() {
+    Messages message;
+    while (true) {
+      // Read before receiving: once it's 0, the bus holds every message that was posted
+      const bool producersDone = nbRunningProducers == 0;
+      if (bus.Receive(message, 0)) {
+        received[static_cast<size_t>(message)]++;
+      } else if (producersDone) {
+        break;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < nbProducers; producer++) {
+    producers.emplace_back([&, producer]() {
+      const Messages ringMessage = ringMessages[producer];
+      const Messages coalescedMessage = coalescedMessages[producer % coalescedMessages.size()];
+      for (int i = 0; i < nbPostsPerProducer; i++) {
+        const Messages message = (i % 3 == 0) ? ringMessage : coalescedMessage;
+        if (bus.Post(message)) {
+          posted[static_cast<size_t>(message)]++;
+        }
+        if (i % 64 == 0) {
+          Stubs::AdvanceTicks(1);
+        }
+        // Bursts of posts, like the touch events
+        if (i % 8 == 0) {
+          std::this_thread::yield();
+        }
+      }
+      nbRunningProducers--;
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  consumer.join();
+
+  // Every ring message that was accepted is received once, every coalesced post is received or counted as coalesced
+  const auto statistics = bus.GetStatistics();
+  uint32_t nbRingPosts = 0;
+  for (Messages message : ringMessages) {
+    EXPECT_EQ(posted[static_cast<size_t>(message)], received[static_cast<size_t>(message)]);
+    nbRingPosts += posted[static_cast<size_t>(message)];
+  }
+  uint32_t nbCoalescedPosts = 0;
+  uint32_t nbCoalescedReceived = 0;
+  for (Messages message : coalescedMessages) {
+    nbCoalescedPosts += posted[static_cast<size_t>(message)];
+    nbCoalescedReceived += received[static_cast<size_t>(message)];
+  }
+  EXPECT_EQ(nbCoalescedPosts, nbCoalescedReceived + statistics.coalesced);
+  EXPECT_EQ(static_cast<uint32_t>(nbProducers * nbPostsPerProducer), nbRingPosts + statistics.dropped + nbCoalescedPosts);
+  Messages message;
+  EXPECT_FALSE(bus.Receive(message, 0));
+
+  RecordProperty("dropped", static_cast<int>(statistics.dropped));
+  RecordProperty("coalesced", static_cast<int>(statistics.coalesced));
+  std::cout << "MessageBus (" << nbProducers << " producers): " << nbRingPosts << " ring messages received, " << statistics.dropped
+            << " dropped, " << nbCoalescedReceived << " coalesced messages received for " << nbCoalescedPosts << " posts, max latency "
+            << statistics.maxLatency << " ticks" << std::endl;
+}
@@ -0,0 +1,147 @@
+#include "systemtask/RunTimeStats.h"
+#include <gtest/gtest.h>
+#include <cstring>
+
+using Pinetime::System::RunTimeStats;
+
+namespace {
+  // Run-time counter of the firmware: RTC2 at 32768Hz, shifted left by 8 bits
+  constexpr uint32_t CounterFrequency = 32768UL * 256UL;
+  constexpr uint32_t TenSeconds = 10 * CounterFrequency;
+
+  RunTimeStats::TaskCounters Task(uint32_t taskNumber, const char* name, uint32_t runTime, bool isIdle = false) {
+    RunTimeStats::TaskCounters task {};
+    task.taskNumber = taskNumber;
+    std::strncpy(task.name, name, RunTimeStats::TaskNameSize - 1);
+    task.runTime = runTime;
+    task.stackHighWaterMark = 42;
+    task.isIdle = isIdle;
+    return task;
+  }
+
+  RunTimeStats::Snapshot Snapshot(uint32_t time, uint32_t sleepTime, uint32_t wakeups) {
+    RunTimeStats::Snapshot snapshot {};
+    snapshot.time = time;
+    snapshot.sleepTime = sleepTime;
+    snapshot.wakeups = wakeups;
+    return snapshot;
+  }
+
+  void Add(RunTimeStats::Snapshot& snapshot, const RunTimeStats::TaskCounters& task) {
+    snapshot.tasks[snapshot.nbTasks++] = task;
+  }
+}
+
+TEST(RunTimeStatsTest, FirstSnapshotStartsThePeriod) {
+  RunTimeStats runTimeStats {CounterFrequency};
+  RunTimeStats::Statistics statistics;
+  EXPECT_FALSE(runTimeStats.Update(Snapshot(1000, 0, 0), statistics));
+  EXPECT_EQ(0u, statistics.periodMs);
+  // No time elapsed since the previous snapshot
+  EXPECT_FALSE(runTimeStats.Update(Snapshot(1000, 0, 0), statistics));
+}
+
+TEST(RunTimeStatsTest, LoadOfThePeriod) {
+  RunTimeStats runTimeStats {CounterFrequency};
+  RunTimeStats::Statistics statistics;
+  auto first = Snapshot(0, 0, 0);
+  Add(first, Task(1, "IDL", 0, true));
+  Add(first, Task(2, "SYS", 0));
+  Add(first, Task(3, "DSP", 0));
+  runTimeStats.Update(first, statistics);
+
+  auto second = Snapshot(TenSeconds, TenSeconds / 10 * 7, 250);
+  Add(second, Task(1, "IDL", TenSeconds / 10 * 8, true));
+  Add(second, Task(2, "SYS", TenSeconds / 20));
+  Add(second, Task(3, "DSP", TenSeconds / 20 * 3));
+  ASSERT_TRUE(runTimeStats.Update(second, statistics));
+
+  EXPECT_EQ(10000u, statistics.periodMs);
+  EXPECT_EQ(800, statistics.idlePermille);
+  EXPECT_EQ(200, statistics.cpuLoadPermille);
+  EXPECT_EQ(700, statistics.sleepPermille);
+  EXPECT_EQ(25, statistics.wakeupsPerSecond);
+
+  // By decreasing load
+  ASSERT_EQ(3, statistics.nbTasks);
+  EXPECT_STREQ("IDL", statistics.tasks[0].name);
+  EXPECT_EQ(800, statistics.tasks[0].loadPermille);
+  EXPECT_STREQ("DSP", statistics.tasks[1].name);
+  EXPECT_EQ(150, statistics.tasks[1].loadPermille);
+  EXPECT_STREQ("SYS", statistics.tasks[2].name);
+  EXPECT_EQ(50, statistics.tasks[2].loadPermille);
+  EXPECT_EQ(42, statistics.tasks[2].stackHighWaterMark);
+}
+
+TEST(RunTimeStatsTest, CountersWrapAround) {
+  // The 32 bits run-time counter wraps around every 512s
+  RunTimeStats runTimeStats {CounterFrequency};
+  RunTimeStats::Statistics statistics;
+  const uint32_t start = UINT32_MAX - TenSeconds / 2 + 1;
+  auto first = Snapshot(start, UINT32_MAX - 99, UINT32_MAX - 9);
+  Add(first, Task(1, "IDL", UINT32_MAX - TenSeconds / 4 + 1, true));
+  runTimeStats.Update(first, statistics);
+
+  auto second = Snapshot(start + TenSeconds, TenSeconds / 4 - 100, 90);
+  Add(second, Task(1, "IDL", TenSeconds / 4, true));
+  ASSERT_TRUE(runTimeStats.Update(second, statistics));
+
+  EXPECT_EQ(10000u, statistics.periodMs);
+  EXPECT_EQ(500, statistics.idlePermille);
+  EXPECT_EQ(500, statistics.cpuLoadPermille);
+  EXPECT_EQ(250, statistics.sleepPermille);
+  EXPECT_EQ(10, statistics.wakeupsPerSecond);
+}
+
+TEST(RunTimeStatsTest, TaskCreatedDuringThePeriod) {
+  RunTimeStats runTimeStats {CounterFrequency};
+  RunTimeStats::Statistics statistics;
+  auto first = Snapshot(0, 0, 0);
+  Add(first, Task(1, "IDL", 0, true));
+  Add(first, Task(2, "SYS", TenSeconds / 10));
+  runTimeStats.Update(first, statistics);
+
+  // Task 4 was created (and task 2 deleted) during the period: it ran since its creation only
+  auto second = Snapshot(TenSeconds, 0, 0);
+  Add(second, Task(1, "IDL", TenSeconds / 2, true));
+  Add(second, Task(4, "APP", TenSeconds / 10 * 3));
+  ASSERT_TRUE(runTimeStats.Update(second, statistics));
+
+  ASSERT_EQ(2, statistics.nbTasks);
+  EXPECT_STREQ("IDL", statistics.tasks[0].name);
+  EXPECT_EQ(500, statistics.tasks[0].loadPermille);
+  EXPECT_STREQ("APP", statistics.tasks[1].name);
+  EXPECT_EQ(300, statistics.tasks[1].loadPermille);
+}
+
+TEST(RunTimeStatsTest, TopWakeupSources) {
+  RunTimeStats runTimeStats {CounterFrequency};
+  RunTimeStats::Statistics statistics;
+  auto first = Snapshot(0, 0, 0);
+  first.wakeupsBySource[17] = 65530;
+  runTimeStats.Update(first, statistics);
+
+  auto second = Snapshot(TenSeconds, 0, 0);
+  second.wakeupsBySource[1] = 3;
+  second.wakeupsBySource[6] = 40;
+  second.wakeupsBySource[11] = 1;
+  // The 16 bits counter of RTC1 wrapped around
+  second.wakeupsBySource[17] = 94;
+  second.wakeupsBySource[36] = 40;
+  ASSERT_TRUE(runTimeStats.Update(second, statistics));
+
+  // The 3 most frequent sources, by decreasing count; the first one of equal counts is kept first
+  ASSERT_EQ(3, statistics.nbTopWakeupSources);
+  EXPECT_EQ(17, statistics.topWakeupSources[0].source);
+  EXPECT_EQ(100, statistics.topWakeupSources[0].count);
+  EXPECT_EQ(6, statistics.topWakeupSources[1].source);
+  EXPECT_EQ(40, statistics.topWakeupSources[1].count);
+  EXPECT_EQ(36, statistics.topWakeupSources[2].source);
+  EXPECT_EQ(40, statistics.topWakeupSources[2].count);
+
+  // No wake-up during the next period
+  auto third = second;
+  third.time += TenSeconds;
+  ASSERT_TRUE(runTimeStats.Update(third, statistics));
+  EXPECT_EQ(0, statistics.nbTopWakeupSources);
+}
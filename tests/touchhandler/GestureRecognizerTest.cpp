@@ -0,0 +1,175 @@
+#include "touchhandler/GestureRecognizer.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
+
+using Pinetime::Controllers::GestureRecognizer;
+using Gestures = GestureRecognizer::Gestures;
+
+namespace {
+  // Same tick rate as the firmware (configTICK_RATE_HZ)
+  constexpr uint32_t ticksPerSecond = 1024;
+
+  struct Point {
+    int32_t x;
+    int32_t y;
+    bool touching;
+    uint32_t ms;
+  };
+  using Trace = std::vector<Point>;
+
+  uint32_t Ticks(uint32_t ms) {
+    return ms * ticksPerSecond / 1000;
+  }
+
+  // Points of a touch that moves in a straight line from (x0, y0) to (x1, y1), one point every period ms like the panel
+  // reports them, then is released
+  Trace Stroke(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t duration, uint32_t start = 0, uint32_t period = 10) {
+    Trace trace;
+    const uint32_t nbSteps = duration / period;
+    for (uint32_t i = 0; i <= nbSteps; i++) {
+      trace.push_back({x0 + static_cast<int32_t>((x1 - x0) * static_cast<int32_t>(i) / static_cast<int32_t>(nbSteps)),
+                       y0 + static_cast<int32_t>((y1 - y0) * static_cast<int32_t>(i) / static_cast<int32_t>(nbSteps)),
+                       true,
+                       start + i * period});
+    }
+    trace.push_back({x1, y1, false, start + duration + period});
+    return trace;
+  }
+
+  Trace Concat(Trace a, const Trace& b) {
+    a.insert(a.end(), b.begin(), b.end());
+    return a;
+  }
+
+  // Gestures recognized along the trace
+  std::vector<Gestures> Replay(GestureRecognizer& recognizer, const Trace& trace) {
+    std::vector<Gestures> gestures;
+    for (const auto& point : trace) {
+      auto gesture = recognizer.OnSample(point.x, point.y, point.touching, Ticks(point.ms));
+      if (gesture != Gestures::None) {
+        gestures.push_back(gesture);
+      }
+    }
+    return gestures;
+  }
+
+  std::vector<Gestures> Replay(const Trace& trace) {
+    GestureRecognizer recognizer {ticksPerSecond};
+    return Replay(recognizer, trace);
+  }
+
+  using G = std::vector<Gestures>;
+}
+
+TEST(GestureRecognizerTest, Tap) {
+  EXPECT_EQ((G {Gestures::Tap}), Replay(Stroke(120, 120, 120, 120, 80)));
+}
+
+TEST(GestureRecognizerTest, TapWithAJitteryFinger) {
+  // Moves less than TouchSlop
+  EXPECT_EQ((G {Gestures::Tap}), Replay(Stroke(120, 120, 128, 112, 100)));
+}
+
+TEST(GestureRecognizerTest, DoubleTap) {
+  EXPECT_EQ((G {Gestures::Tap, Gestures::DoubleTap}), Replay(Concat(Stroke(120, 120, 120, 120, 60), Stroke(125, 118, 125, 118, 60, 200))));
+}
+
+TEST(GestureRecognizerTest, TwoTapsTooFarApartInTimeOrSpace) {
+  EXPECT_EQ((G {Gestures::Tap, Gestures::Tap}), Replay(Concat(Stroke(120, 120, 120, 120, 60), Stroke(120, 120, 120, 120, 60, 600))));
+  EXPECT_EQ((G {Gestures::Tap, Gestures::Tap}), Replay(Concat(Stroke(40, 40, 40, 40, 60), Stroke(200, 200, 200, 200, 60, 200))));
+}
+
+TEST(GestureRecognizerTest, LongPress) {
+  EXPECT_EQ((G {Gestures::LongPress}), Replay(Stroke(120, 120, 122, 121, 1000)));
+}
+
+TEST(GestureRecognizerTest, SwipesAreRecognizedDuringTheMove) {
+  GestureRecognizer recognizer {ticksPerSecond};
+  const Trace trace = Stroke(120, 200, 120, 20, 300);
+  size_t i = 0;
+  for (; i < trace.size(); i++) {
+    if (recognizer.OnSample(trace[i].x, trace[i].y, trace[i].touching, Ticks(trace[i].ms)) != Gestures::None) {
+      break;
+    }
+  }
+  // Once the finger moved SwipeDistance, long before the release
+  ASSERT_LT(i, trace.size());
+  EXPECT_TRUE(trace[i].touching);
+  EXPECT_GE(200 - trace[i].y, static_cast<int32_t>(GestureRecognizer::SwipeDistance));
+  EXPECT_LT(200 - trace[i - 1].y, static_cast<int32_t>(GestureRecognizer::SwipeDistance));
+}
+
+TEST(GestureRecognizerTest, SwipeDirections) {
+  EXPECT_EQ((G {Gestures::SwipeUp}), Replay(Stroke(120, 200, 120, 40, 200)));
+  EXPECT_EQ((G {Gestures::SwipeDown}), Replay(Stroke(120, 40, 120, 200, 200)));
+  EXPECT_EQ((G {Gestures::SwipeLeft}), Replay(Stroke(200, 120, 40, 120, 200)));
+  EXPECT_EQ((G {Gestures::SwipeRight}), Replay(Stroke(40, 120, 200, 120, 200)));
+  // Diagonal: the main direction
+  EXPECT_EQ((G {Gestures::SwipeUp}), Replay(Stroke(100, 200, 140, 40, 200)));
+}
+
+TEST(GestureRecognizerTest, Flick) {
+  // 30px in 50ms: shorter than SwipeDistance, faster than FlingVelocity
+  EXPECT_EQ((G {Gestures::SwipeLeft}), Replay(Stroke(150, 120, 120, 120, 50)));
+}
+
+TEST(GestureRecognizerTest, SlowShortDragIsNothing) {
+  // 30px in 1s: past TouchSlop, so neither a tap nor a long press
+  EXPECT_EQ((G {}), Replay(Stroke(120, 120, 120, 150, 1000)));
+}
+
+TEST(GestureRecognizerTest, MissedReleaseStartsANewTouch) {
+  // The release of the first touch was lost: the second one, later, is still a tap
+  Trace trace = Stroke(120, 120, 120, 120, 60);
+  trace.pop_back();
+  EXPECT_EQ((G {Gestures::Tap}), Replay(Concat(trace, Stroke(30, 30, 30, 30, 60, 2000))));
+}
+
+TEST(GestureRecognizerTest, ReleaseWithoutRawPoints) {
+  // In its sleep mode, the panel only reports the release with its own gesture
+  GestureRecognizer recognizer {ticksPerSecond};
+  EXPECT_EQ(Gestures::None, recognizer.OnSample(120, 120, false, 0));
+  EXPECT_EQ(1u, recognizer.SampleCount());
+}
+
+TEST(GestureRecognizerTest, TimestampsWrapAround) {
+  GestureRecognizer recognizer {ticksPerSecond};
+  const uint32_t start = UINT32_MAX - Ticks(50);
+  const Trace trace = Stroke(120, 200, 120, 40, 200);
+  std::vector<Gestures> gestures;
+  for (const auto& point : trace) {
+    auto gesture = recognizer.OnSample(point.x, point.y, point.touching, start + Ticks(point.ms));
+    if (gesture != Gestures::None) {
+      gestures.push_back(gesture);
+    }
+  }
+  EXPECT_EQ((G {Gestures::SwipeUp}), gestures);
+}
+
+TEST(GestureRecognizerTest, CostPerSample) {
+  // A mix of taps, swipes and long presses
+  Trace trace;
+  uint32_t start = 0;
+  for (int i = 0; i < 100; i++) {
+    trace = Concat(trace, Stroke(120, 120, 120, 120, 60, start));
+    trace = Concat(trace, Stroke(120, 200, 120, 40, 200, start + 500));
+    trace = Concat(trace, Stroke(60, 60, 61, 60, 800, start + 1000));
+    start += 3000;
+  }
+
+  GestureRecognizer recognizer {ticksPerSecond};
+  size_t nbGestures = 0;
+  constexpr int nbRuns = 20;
+  const auto begin = std::chrono::steady_clock::now();
+  for (int run = 0; run < nbRuns; run++) {
+    recognizer.Reset();
+    nbGestures += Replay(recognizer, trace).size();
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+  EXPECT_EQ(static_cast<size_t>(nbRuns * 300), nbGestures);
+
+  const auto nsPerSample = elapsed.count() / static_cast<long long>(nbRuns * trace.size());
+  RecordProperty("ns_per_sample", static_cast<int>(nsPerSample));
+  std::cout << "GestureRecognizer: " << nsPerSample << " ns per sample on the host" << std::endl;
+}
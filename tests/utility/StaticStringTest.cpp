@@ -0,0 +1,81 @@
+#include "utility/StaticString.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+using Pinetime::Utility::StaticString;
+
+TEST(StaticStringTest, EmptyByDefault) {
+  StaticString<8> str;
+  EXPECT_TRUE(str.Empty());
+  EXPECT_EQ(0u, str.Size());
+  EXPECT_STREQ("", str.Data());
+  EXPECT_EQ(8u, StaticString<8>::MaxSize());
+}
+
+TEST(StaticStringTest, ConstructedFromACString) {
+  StaticString<8> str {"abc"};
+  EXPECT_FALSE(str.Empty());
+  EXPECT_EQ(3u, str.Size());
+  EXPECT_STREQ("abc", str.Data());
+}
+
+TEST(StaticStringTest, AssignReplacesTheString) {
+  StaticString<8> str {"abcdef"};
+  str.Assign("xy", 2);
+  EXPECT_EQ(2u, str.Size());
+  EXPECT_STREQ("xy", str.Data());
+}
+
+TEST(StaticStringTest, AssignCopiesOnlyTheGivenLength) {
+  // The values written by the phone are not null-terminated
+  const char value[] = {'h', 'e', 'l', 'l', 'o', 'X', 'X'};
+  StaticString<8> str;
+  str.Assign(value, 5);
+  EXPECT_STREQ("hello", str.Data());
+}
+
+TEST(StaticStringTest, LongerStringsAreTruncated) {
+  StaticString<8> str {"0123456789"};
+  EXPECT_EQ(8u, str.Size());
+  EXPECT_STREQ("01234567", str.Data());
+
+  const std::string value(100, 'z');
+  str.Assign(value.data(), value.size());
+  EXPECT_EQ(std::string(8, 'z'), str.Data());
+}
+
+TEST(StaticStringTest, FullCapacity) {
+  StaticString<8> str;
+  str.Assign("01234567", 8);
+  EXPECT_EQ(8u, str.Size());
+  EXPECT_STREQ("01234567", str.Data());
+}
+
+TEST(StaticStringTest, ResizeClampsAndTerminates) {
+  StaticString<8> str {"abcdefgh"};
+  char* data = str.Resize(3);
+  EXPECT_EQ(3u, str.Size());
+  EXPECT_STREQ("abc", str.Data());
+
+  data = str.Resize(20);
+  EXPECT_EQ(8u, str.Size());
+  std::memcpy(data, "ABCDEFGH", str.Size());
+  EXPECT_STREQ("ABCDEFGH", str.Data());
+
+  str.Resize(0);
+  EXPECT_TRUE(str.Empty());
+  EXPECT_STREQ("", str.Data());
+}
+
+TEST(StaticStringTest, StoredInline) {
+  // The buffer is part of the object: copies and assignments don't allocate
+  static_assert(sizeof(StaticString<40>) <= 40 + 1 + 2 * sizeof(size_t), "The buffer must be stored inline");
+  static_assert(std::is_trivially_copyable<StaticString<40>>::value, "Copying must not allocate");
+  StaticString<8> str {"abc"};
+  StaticString<8> copy = str;
+  str.Assign("xyz", 3);
+  EXPECT_STREQ("abc", copy.Data());
+  EXPECT_STREQ("xyz", str.Data());
+}
@@ -0,0 +1,288 @@
+#!/usr/bin/env python3
+"""Packer of the images of InfiniTime stored in the external flash.
+
+  imagepack.py pack images.bin disc:indexed1:disc.png disc_f_1:indexed1:disc_f_1.png ...
+      Packs the PNG images into images.bin. Each image is given as name:format:path, the formats are indexed1,
+      indexed2, indexed4, true_color and true_color_alpha.
+  imagepack.py info images.bin
+      Lists the images of a pack.
+
+The pack is uploaded to /images.bin on the watch with the BLE FS service. See doc/ImageStore.md for its format.
+Only the standard library is used: the PNG files must not be interlaced.
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = 0x4D495450
+VERSION = 1
+MAX_IMAGES = 16
+NAME_SIZE = 12
+# Must match ImageStore::TileSize and LV_HOR_RES_MAX
+TILE_SIZE = 480
+MAX_WIDTH = 240
+
+HEADER = struct.Struct('<IHHII')
+ENTRY = struct.Struct(f'<{NAME_SIZE}sHHBBBBII')
+BAND_OFFSET = struct.Struct('<I')
+
+COMPRESSION_NONE = 0
+COMPRESSION_RLE = 1
+
+# LVGL color formats (lv_img_cf_t): value, bits per pixel
+FORMATS = {
+    'true_color': (4, 16),
+    'true_color_alpha': (5, 24),
+    'indexed1': (7, 1),
+    'indexed2': (8, 2),
+    'indexed4': (9, 4),
+}
+
+PNG_SIGNATURE = b'\x89PNG\r\n\x1a\n'
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def read_png(path):
+    """Returns the width, the height and the rows of RGBA tuples of a PNG file."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:8] != PNG_SIGNATURE:
+        raise ValueError(f'{path}: not a PNG file')
+
+    offset = 8
+    palette, transparency, compressed = [], b'', b''
+    while offset < len(data):
+        length, kind = struct.unpack_from('>I4s', data, offset)
+        chunk = data[offset + 8:offset + 8 + length]
+        offset += 12 + length
+        if kind == b'IHDR':
+            width, height, depth, color_type, _, _, interlace = struct.unpack('>IIBBBBB', chunk)
+        elif kind == b'PLTE':
+            palette = [tuple(chunk[i:i + 3]) for i in range(0, len(chunk), 3)]
+        elif kind == b'tRNS':
+            transparency = chunk
+        elif kind == b'IDAT':
+            compressed += chunk
+    if interlace != 0:
+        raise ValueError(f'{path}: interlaced PNG files are not supported')
+    if color_type != 3 and depth != 8:
+        raise ValueError(f'{path}: only 8 bits per channel are supported')
+
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color_type]
+    bits_per_pixel = channels * depth
+    stride = (width * bits_per_pixel + 7) // 8
+    step = max(1, bits_per_pixel // 8)
+    raw = zlib.decompress(compressed)
+
+    rows = []
+    previous = bytearray(stride)
+    for y in range(height):
+        start = y * (stride + 1)
+        filter_type, line = raw[start], bytearray(raw[start + 1:start + 1 + stride])
+        for i in range(stride):
+            left = line[i - step] if i >= step else 0
+            up, up_left = previous[i], previous[i - step] if i >= step else 0
+            line[i] = (line[i] + [0, left, up, (left + up) // 2, paeth(left, up, up_left)][filter_type]) & 0xFF
+        previous = line
+
+        row = []
+        for x in range(width):
+            if color_type == 3:
+                bit = x * depth
+                index = (line[bit // 8] >> (8 - depth - bit % 8)) & ((1 << depth) - 1)
+                alpha = transparency[index] if index < len(transparency) else 255
+                row.append(palette[index] + (alpha,))
+            else:
+                pixel = line[x * channels:(x + 1) * channels]
+                if color_type == 0:
+                    row.append((pixel[0],) * 3 + (255,))
+                elif color_type == 2:
+                    row.append(tuple(pixel) + (255,))
+                elif color_type == 4:
+                    row.append((pixel[0],) * 3 + (pixel[1],))
+                else:
+                    row.append(tuple(pixel))
+        rows.append(row)
+    return width, height, rows
+
+
+def rgb565(pixel):
+    """LV_COLOR_16_SWAP: most significant byte first."""
+    r, g, b = pixel[:3]
+    return struct.pack('>H', ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3))
+
+
+def encode_pixels(name, rows, format_name):
+    """Returns the palette (lv_color32_t) and the rows of bytes of the image."""
+    _, bits_per_pixel = FORMATS[format_name]
+    if bits_per_pixel >= 16:
+        with_alpha = format_name == 'true_color_alpha'
+        return b'', [b''.join(rgb565(p) + (bytes([p[3]]) if with_alpha else b'') for p in row) for row in rows]
+
+    colors = []
+    for row in rows:
+        for pixel in row:
+            # All the fully transparent pixels share the same entry
+            pixel = pixel if pixel[3] > 0 else (0, 0, 0, 0)
+            if pixel not in colors:
+                colors.append(pixel)
+    if len(colors) > (1 << bits_per_pixel):
+        raise ValueError(f'{name}: {len(colors)} colors do not fit in {format_name}')
+    colors += [(0, 0, 0, 0)] * ((1 << bits_per_pixel) - len(colors))
+    palette = b''.join(bytes([b, g, r, a]) for r, g, b, a in colors)
+
+    encoded = []
+    for row in rows:
+        line = bytearray((len(row) * bits_per_pixel + 7) // 8)
+        for x, pixel in enumerate(row):
+            index = colors.index(pixel if pixel[3] > 0 else (0, 0, 0, 0))
+            bit = x * bits_per_pixel
+            line[bit // 8] |= index << (8 - bits_per_pixel - bit % 8)
+        encoded.append(bytes(line))
+    return palette, encoded
+
+
+def rle_encode(data, unit_size):
+    """Control byte n: n + 1 literal units follow if n < 128, otherwise the next unit is repeated n - 126 times.
+
+    A unit is a pixel for the true color formats, a byte for the indexed ones."""
+    units = [data[i:i + unit_size] for i in range(0, len(data), unit_size)]
+    output = bytearray()
+    literals = []
+
+    def flush_literals():
+        for start in range(0, len(literals), 128):
+            chunk = literals[start:start + 128]
+            output.append(len(chunk) - 1)
+            output.extend(b''.join(chunk))
+        literals.clear()
+
+    i = 0
+    while i < len(units):
+        run = 1
+        while i + run < len(units) and run < 129 and units[i + run] == units[i]:
+            run += 1
+        if run >= 3:
+            flush_literals()
+            output.append(run + 126)
+            output.extend(units[i])
+        else:
+            literals.extend(units[i:i + run])
+        i += run
+    flush_literals()
+    return bytes(output)
+
+
+def pack_image(name, format_name, path, use_rle):
+    width, height, rows = read_png(path)
+    if width > MAX_WIDTH:
+        raise ValueError(f'{name}: wider than {MAX_WIDTH} pixels')
+    palette, lines = encode_pixels(name, rows, format_name)
+    stride = len(lines[0])
+    if stride > TILE_SIZE:
+        raise ValueError(f'{name}: a row of {stride} bytes does not fit in a tile of {TILE_SIZE} bytes')
+
+    rows_per_band = min(255, TILE_SIZE // stride)
+    bands = [b''.join(lines[y:y + rows_per_band]) for y in range(0, height, rows_per_band)]
+    raw = b''.join(bands)
+
+    compression, data = COMPRESSION_NONE, raw
+    if use_rle:
+        _, bits_per_pixel = FORMATS[format_name]
+        unit_size = bits_per_pixel // 8 if bits_per_pixel >= 16 else 1
+        encoded = [rle_encode(band, unit_size) for band in bands]
+        offsets, position = [], 0
+        for band in encoded:
+            offsets.append(position)
+            position += len(band)
+        offsets.append(position)
+        compressed = b''.join(BAND_OFFSET.pack(o) for o in offsets) + b''.join(encoded)
+        if len(compressed) < len(raw):
+            compression, data = COMPRESSION_RLE, compressed
+
+    color_format, _ = FORMATS[format_name]
+    return (name, width, height, color_format, compression, rows_per_band), palette + data, len(raw)
+
+
+def pack(args):
+    if len(args.images) > MAX_IMAGES:
+        sys.exit(f'error: at most {MAX_IMAGES} images')
+
+    images = []
+    for description in args.images:
+        try:
+            name, format_name, path = description.split(':', 2)
+        except ValueError:
+            sys.exit(f'error: {description}: expected name:format:path')
+        if len(name.encode()) > NAME_SIZE or format_name not in FORMATS:
+            sys.exit(f'error: {description}: invalid name or format')
+        try:
+            images.append(pack_image(name, format_name, path, not args.no_rle))
+        except (OSError, ValueError) as error:
+            sys.exit(f'error: {error}')
+
+    index, data = b'', b''
+    offset = HEADER.size + ENTRY.size * len(images)
+    for (name, width, height, color_format, compression, rows_per_band), image_data, _ in images:
+        index += ENTRY.pack(name.encode(), width, height, color_format, compression, rows_per_band, 0,
+                            offset + len(data), len(image_data))
+        data += image_data
+
+    content = index + data
+    with open(args.pack, 'wb') as f:
+        f.write(HEADER.pack(MAGIC, VERSION, len(images), zlib.crc32(content), 0) + content)
+
+    raw_size = sum(raw for _, _, raw in images)
+    print(f'{len(images)} images packed to {args.pack}: {HEADER.size + len(content)} bytes, '
+          f'{raw_size} bytes of uncompressed pixels')
+
+
+def info(args):
+    with open(args.pack, 'rb') as f:
+        content = f.read()
+    magic, version, nb_images, crc, _ = HEADER.unpack_from(content)
+    if magic != MAGIC or version != VERSION:
+        sys.exit(f'error: {args.pack} is not an image pack of version {VERSION}')
+    valid = zlib.crc32(content[HEADER.size:]) == crc
+    print(f'{nb_images} images, {len(content)} bytes, CRC {"valid" if valid else "INVALID"}')
+
+    format_names = {value: name for name, (value, _) in FORMATS.items()}
+    for i in range(nb_images):
+        name, width, height, color_format, compression, rows_per_band, _, offset, size = \
+            ENTRY.unpack_from(content, HEADER.size + i * ENTRY.size)
+        nb_bands = (height + rows_per_band - 1) // rows_per_band
+        name = name.rstrip(b'\0').decode()
+        print(f'{name:{NAME_SIZE}} {width:3}x{height:<3} '
+              f'{format_names.get(color_format, color_format):16} {"rle" if compression else "raw"} '
+              f'{nb_bands:3} bands of {rows_per_band:3} rows, {size:6} bytes at {offset:#08x}')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest='command', required=True)
+
+    pack_parser = commands.add_parser('pack', help='pack PNG images')
+    pack_parser.add_argument('pack')
+    pack_parser.add_argument('images', nargs='+', help='name:format:path of each image')
+    pack_parser.add_argument('--no-rle', action='store_true', help='store the pixels uncompressed')
+    pack_parser.set_defaults(function=pack)
+
+    info_parser = commands.add_parser('info', help='list the images of a pack')
+    info_parser.add_argument('pack')
+    info_parser.set_defaults(function=info)
+
+    args = parser.parse_args()
+    args.function(args)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""Dictionary extractor and decoder of the tokenized logs of InfiniTime.
+
+  logtokens.py extract pinetime-app.out pinetime-app.tokens.csv
+      Extracts the dictionary of the tokens from the .log_tokens section of the ELF file (done at the end of the build).
+  logtokens.py decode pinetime-app.tokens.csv capture.bin
+      Decodes the records read from the RTT channel 1 (a file, or - for stdin) to text.
+
+See doc/TokenizedLog.md for the format of the records.
+"""
+
+import argparse
+import csv
+import re
+import struct
+import sys
+
+SECTION_NAME = '.log_tokens'
+FIELD_SEPARATOR = '\x1f'
+MAX_TOKEN = 0xFFFE
+LOST_TOKEN = 0xFFFF
+
+RECORD_HEADER = struct.Struct('<HBBI')
+ARGUMENT = struct.Struct('<I')
+TIMESTAMP_FREQUENCY = 32768
+TIMESTAMP_MASK = 0xFFFFFF
+
+ELF_HEADER = struct.Struct('<16sHHIIIIIHHHHHH')
+SECTION_HEADER = struct.Struct('<IIIIIIIIII')
+
+SPECIFIER = re.compile(r'%([-+ #0]*)(\d*)(?:\.(\d+))?(?:hh|h|ll|l|j|z|t)?([diouxXeEfFgGcp%])')
+
+
+def read_section(elf, name):
+    if elf[:4] != b'\x7fELF' or elf[4] != 1 or elf[5] != 1:
+        raise ValueError('not a 32-bit little-endian ELF file')
+    header = ELF_HEADER.unpack_from(elf)
+    shoff, shentsize, shnum, shstrndx = header[6], header[11], header[12], header[13]
+    sections = [SECTION_HEADER.unpack_from(elf, shoff + i * shentsize) for i in range(shnum)]
+    names = sections[shstrndx]
+    for section in sections:
+        start = names[4] + section[0]
+        section_name = elf[start:elf.index(b'\0', start)].decode()
+        if section_name == name:
+            address, offset, size = section[3], section[4], section[5]
+            return address, elf[offset:offset + size]
+    raise ValueError(f'no {name} section: was the firmware built with -DENABLE_TOKENIZED_LOG=1?')
+
+
+def extract(args):
+    with open(args.elf, 'rb') as f:
+        address, data = read_section(f.read(), SECTION_NAME)
+
+    entries = []
+    offset = 0
+    while offset < len(data):
+        end = data.index(b'\0', offset)
+        if end > offset:
+            token = address + offset
+            if token > MAX_TOKEN:
+                sys.exit(f'error: token {token:#x} does not fit on 16 bits')
+            level, location, format_string = data[offset:end].decode().split(FIELD_SEPARATOR, 2)
+            entries.append((token, level, location, format_string))
+        offset = end + 1
+
+    with open(args.dictionary, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(['token', 'level', 'location', 'format'])
+        writer.writerows(entries)
+    print(f'{len(entries)} tokens extracted to {args.dictionary}')
+
+
+def load_dictionary(path):
+    with open(path, newline='') as f:
+        return {int(row['token']): (row['level'], row['location'], row['format']) for row in csv.DictReader(f)}
+
+
+def format_arguments(format_string, arguments):
+    remaining = list(arguments)
+
+    def replace(match):
+        flags, width, precision, conversion = match.groups()
+        if conversion == '%':
+            return '%'
+        if not remaining:
+            return '<missing>'
+        value = remaining.pop(0)
+        spec = '%' + flags + width + ('.' + precision if precision is not None else '')
+        if conversion in 'di':
+            return (spec + 'd') % (value - (1 << 32) if value & 0x80000000 else value)
+        if conversion == 'u':
+            return (spec + 'd') % value
+        if conversion in 'eEfFgG':
+            return (spec + conversion) % struct.unpack('<f', ARGUMENT.pack(value))[0]
+        if conversion == 'c':
+            return (spec + 'c') % (value & 0xFF)
+        if conversion == 'p':
+            return f'0x{value:08x}'
+        return (spec + conversion) % value
+
+    return SPECIFIER.sub(replace, format_string)
+
+
+def read_records(stream):
+    while True:
+        header = stream.read(RECORD_HEADER.size)
+        if len(header) < RECORD_HEADER.size:
+            return
+        token, nb_arguments, _, timestamp = RECORD_HEADER.unpack(header)
+        data = stream.read(ARGUMENT.size * nb_arguments)
+        if len(data) < ARGUMENT.size * nb_arguments:
+            return
+        yield token, timestamp, [a[0] for a in ARGUMENT.iter_unpack(data)]
+
+
+def decode(args):
+    dictionary = load_dictionary(args.dictionary)
+    stream = sys.stdin.buffer if args.capture == '-' else open(args.capture, 'rb')
+
+    # The timestamps wrap around every 512s: the records are in order, the wrap-arounds are counted
+    elapsed = 0
+    previous = None
+    for token, timestamp, arguments in read_records(stream):
+        if previous is not None:
+            elapsed += (timestamp - previous) & TIMESTAMP_MASK
+        previous = timestamp
+        time = f'{elapsed / TIMESTAMP_FREQUENCY:10.4f}'
+
+        if token == LOST_TOKEN:
+            print(f'{time} W <{arguments[0] if arguments else "?"} records lost>')
+        elif token not in dictionary:
+            print(f'{time} ? <unknown token {token:#06x}, arguments {arguments}: wrong dictionary?>')
+        else:
+            level, location, format_string = dictionary[token]
+            text = format_arguments(format_string, arguments).rstrip('\n')
+            print(f'{time} {level} {text}' + (f'  ({location})' if args.locations else ''))
+        sys.stdout.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest='command', required=True)
+
+    extract_parser = commands.add_parser('extract', help='extract the dictionary of the tokens from the ELF file')
+    extract_parser.add_argument('elf')
+    extract_parser.add_argument('dictionary')
+    extract_parser.set_defaults(function=extract)
+
+    decode_parser = commands.add_parser('decode', help='decode the records read from RTT')
+    decode_parser.add_argument('dictionary')
+    decode_parser.add_argument('capture', help='file of the records, - for stdin')
+    decode_parser.add_argument('--locations', action='store_true', help='show the file and line of each log')
+    decode_parser.set_defaults(function=decode)
+
+    args = parser.parse_args()
+    args.function(args)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+
+"""Record the raw PPG stream of InfiniTime into a CSV file.
+
+The watch must be connected and the Heart Rate app must be opened on the watch.
+Requires bleak (pip install bleak).
+
+CSV columns: timestamp_ms, hrs, als, agc_peak
+"""
+
+import argparse
+import asyncio
+import struct
+import sys
+
+RAW_PPG_UUID = "00050001-78fc-48fe-8e23-433b3a1942d0"
+HEADER = struct.Struct("<BBHHI")
+SAMPLE_SIZE = 12
+
+
+def decode_packet(data):
+    """Decode a raw PPG notification.
+
+    :return: (sequence, dropped, [(timestamp_ms, hrs, als, agc_peak), ...])
+    """
+    version, count, sequence, dropped, base = HEADER.unpack_from(data, 0)
+    if version != 1:
+        raise ValueError("Unsupported raw PPG format version %d" % version)
+    if len(data) != HEADER.size + count * SAMPLE_SIZE:
+        raise ValueError("Invalid raw PPG packet length %d for %d samples" % (len(data), count))
+
+    samples = []
+    for i in range(count):
+        offset = HEADER.size + i * SAMPLE_SIZE
+        dt, = struct.unpack_from("<H", data, offset)
+        hrs = int.from_bytes(data[offset + 2:offset + 5], "little")
+        als = int.from_bytes(data[offset + 5:offset + 8], "little")
+        agc_peak, = struct.unpack_from("<f", data, offset + 8)
+        samples.append((base + dt, hrs, als, agc_peak))
+    return sequence, dropped, samples
+
+
+async def record(address, output, duration):
+    from bleak import BleakClient
+
+    expected_sequence = None
+    last_dropped = 0
+
+    def on_notification(_, data):
+        nonlocal expected_sequence, last_dropped
+        sequence, dropped, samples = decode_packet(bytes(data))
+        if expected_sequence is not None and sequence != expected_sequence:
+            print("Lost %d packet(s)" % ((sequence - expected_sequence) & 0xffff), file=sys.stderr)
+        if dropped != last_dropped:
+            print("The watch dropped %d sample(s)" % ((dropped - last_dropped) & 0xffff), file=sys.stderr)
+        expected_sequence = (sequence + 1) & 0xffff
+        last_dropped = dropped
+        for sample in samples:
+            output.write("%d,%d,%d,%f\n" % sample)
+
+    async with BleakClient(address) as client:
+        await client.start_notify(RAW_PPG_UUID, on_notification)
+        await asyncio.sleep(duration)
+        await client.stop_notify(RAW_PPG_UUID)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("address", help="BLE address of the watch")
+    parser.add_argument("output", help="CSV file to write")
+    parser.add_argument("--duration", type=float, default=60, help="Recording duration in seconds (default: 60)")
+    args = parser.parse_args()
+
+    with open(args.output, "w") as output:
+        output.write("timestamp_ms,hrs,als,agc_peak\n")
+        asyncio.run(record(args.address, output, args.duration))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,54 @@
+// Replays a raw PPG trace recorded with ppg_record.py through the heart rate algorithm of the firmware
+// (Pinetime::Controllers::Ppg), the same way HeartRateTask does, and prints the BPM computed for each window.
+
+#include <cstdio>
+#include <cstdlib>
+#include "components/heartrate/Ppg.h"
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::fprintf(stderr, "Usage: %s <trace.csv>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  FILE* trace = std::fopen(argv[1], "r");
+  if (trace == nullptr) {
+    std::perror(argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  char line[128];
+  if (std::fgets(line, sizeof(line), trace) == nullptr) {
+    std::fprintf(stderr, "Empty trace\n");
+    return EXIT_FAILURE;
+  }
+
+  Pinetime::Controllers::Ppg ppg;
+  bool first = true;
+  std::printf("timestamp_ms,bpm\n");
+  while (std::fgets(line, sizeof(line), trace) != nullptr) {
+    unsigned long timestamp;
+    unsigned long hrs;
+    unsigned long als;
+    float agcPeak;
+    if (std::sscanf(line, "%lu,%lu,%lu,%f", &timestamp, &hrs, &als, &agcPeak) != 4) {
+      continue;
+    }
+
+    if (first) {
+      // HeartRateTask::StartMeasurement() uses the first sample as the offset
+      ppg.SetOffset(static_cast<float>(hrs));
+      first = false;
+      continue;
+    }
+
+    ppg.Preprocess(static_cast<float>(hrs));
+    auto bpm = ppg.HeartRate();
+    if (bpm != 0) {
+      std::printf("%lu,%d\n", timestamp, static_cast<int>(bpm));
+    }
+  }
+
+  std::fclose(trace);
+  return EXIT_SUCCESS;
+}
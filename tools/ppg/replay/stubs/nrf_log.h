@@ -0,0 +1,3 @@
+#pragma once
+// Host replacement for the NRF logger used by the heart rate algorithm
+#define NRF_LOG_INFO(...)
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""Extracts the allocations of the LVGL memory from a binary trace dumped by InfiniTime (/trace.bin).
+
+The result is replayed on the host by tests/displayapp/LvglAllocatorTest.cpp. See doc/Trace.md for the events, and
+tests/displayapp/lvgl-traces/README.md for the format of the result.
+"""
+
+import argparse
+import sys
+
+from trace2chrome import TraceError, decode
+
+EVENT_LOAD_APP_START = 13
+EVENT_LVGL_ALLOC = 15
+EVENT_LVGL_ALLOCATED = 16
+EVENT_LVGL_FREE = 17
+FAILED = 0xFFFF
+
+
+def to_allocations(records):
+    """Returns (lines, nb_unknown_frees): the lines of the allocation trace of decoded records.
+
+    The blocks freed in the trace but allocated before it started are not replayed.
+    """
+    lines = []
+    blocks = {}
+    next_id = 0
+    pending_size = None
+    nb_unknown_frees = 0
+    for _timestamp, event, argument in records:
+        if event == EVENT_LOAD_APP_START:
+            lines.append('o {}'.format(argument))
+        elif event == EVENT_LVGL_ALLOC:
+            pending_size = argument
+        elif event == EVENT_LVGL_ALLOCATED and pending_size is not None:
+            if argument == FAILED:
+                lines.append('x {}'.format(pending_size))
+            else:
+                blocks[argument] = next_id
+                lines.append('a {} {}'.format(next_id, pending_size))
+                next_id += 1
+            pending_size = None
+        elif event == EVENT_LVGL_FREE:
+            if argument in blocks:
+                lines.append('f {}'.format(blocks.pop(argument)))
+            elif argument != FAILED:
+                nb_unknown_frees += 1
+    return lines, nb_unknown_frees
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('dump', help='binary trace read from the watch (/trace.bin)')
+    parser.add_argument('output', nargs='?', help='allocation trace (default: standard output)')
+    args = parser.parse_args()
+
+    with open(args.dump, 'rb') as f:
+        data = f.read()
+    try:
+        _frequency, lost, _tasks, records = decode(data)
+    except TraceError as e:
+        sys.exit('{}: {}'.format(args.dump, e))
+
+    lines, nb_unknown_frees = to_allocations(records)
+    if lost:
+        print('{} events were lost: the trace may be incomplete'.format(lost), file=sys.stderr)
+    if nb_unknown_frees:
+        print('{} blocks allocated before the start of the trace were freed'.format(nb_unknown_frees), file=sys.stderr)
+
+    text = '\n'.join(lines) + '\n'
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == '__main__':
+    main()
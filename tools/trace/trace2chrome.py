@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""Converts a binary trace dumped by InfiniTime (/trace.bin) to the Chrome trace JSON format.
+
+The result can be opened in https://ui.perfetto.dev or chrome://tracing. See doc/Trace.md for the dump format.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b'ITRC'
+HEADER = struct.Struct('<4sBBHIII')
+TASK = struct.Struct('<H4s')
+RECORD = struct.Struct('<IBBH')
+TIMESTAMP_MASK = 0xFFFFFF
+
+EVENT_TASK_SWITCHED_IN = 1
+EVENT_QUEUE_POSTED = 2
+EVENT_SYSTEM_MESSAGE = 3
+EVENT_DISPLAY_MESSAGE = 4
+# Pairs of events delimiting a duration: start event -> (end event, name, track)
+SPANS = {
+    5: (6, 'SPIM0 IRQ', 'Interrupts'),
+    7: (8, 'GPIOTE IRQ', 'Interrupts'),
+    9: (10, 'FlushDisplay', 'Display'),
+    11: (12, 'TWI transfer', 'TWI'),
+    13: (14, 'LoadApp', 'Display'),
+}
+SPAN_ENDS = {end: start for start, (end, _, _) in SPANS.items()}
+INSTANTS = {
+    EVENT_QUEUE_POSTED: ('Queue post', 'queue', '0x{:04x}'),
+    EVENT_SYSTEM_MESSAGE: ('SystemTask message', 'message', '{}'),
+    EVENT_DISPLAY_MESSAGE: ('DisplayApp message', 'message', '{}'),
+}
+
+PID = 1
+# Thread ids of the tracks that are not tasks, above the task numbers
+TRACK_IDS = {'Interrupts': 1000, 'Display': 1001, 'TWI': 1002, 'Messages': 1003}
+
+
+class TraceError(Exception):
+    pass
+
+
+def decode(data):
+    """Returns (frequency, lost, tasks, records) from the content of a dump.
+
+    tasks maps the task numbers to their names, records is a list of (timestamp, event, argument) with timestamps
+    unwrapped (assuming that consecutive events are less than 512s apart).
+    """
+    if len(data) < HEADER.size:
+        raise TraceError('File too short')
+    magic, version, record_size, nb_tasks, frequency, nb_records, lost = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise TraceError('Not an InfiniTime trace')
+    if version != 1 or record_size != RECORD.size:
+        raise TraceError('Unsupported trace format version {} (record size {})'.format(version, record_size))
+
+    offset = HEADER.size
+    if len(data) < offset + nb_tasks * TASK.size + nb_records * RECORD.size:
+        raise TraceError('Truncated trace')
+
+    tasks = {}
+    for _ in range(nb_tasks):
+        number, name = TASK.unpack_from(data, offset)
+        tasks[number] = name.split(b'\0', 1)[0].decode('ascii', 'replace')
+        offset += TASK.size
+
+    records = []
+    previous = None
+    base = 0
+    for _ in range(nb_records):
+        timestamp, event, _reserved, argument = RECORD.unpack_from(data, offset)
+        offset += RECORD.size
+        timestamp &= TIMESTAMP_MASK
+        if previous is not None and timestamp < previous:
+            base += TIMESTAMP_MASK + 1
+        previous = timestamp
+        records.append((base + timestamp, event, argument))
+    return frequency, lost, tasks, records
+
+
+def to_chrome_trace(frequency, lost, tasks, records):
+    """Returns the Chrome trace (as a dict ready to be serialized in JSON) of decoded records."""
+    events = []
+
+    def metadata(tid, name):
+        events.append({'ph': 'M', 'name': 'thread_name', 'pid': PID, 'tid': tid, 'args': {'name': name}})
+
+    metadata(0, 'Unknown task')
+    for number, name in sorted(tasks.items()):
+        metadata(number, name)
+    for name, tid in TRACK_IDS.items():
+        metadata(tid, name)
+
+    if not records:
+        return {'traceEvents': events, 'displayTimeUnit': 'ms'}
+
+    origin = records[0][0]
+
+    def microseconds(timestamp):
+        return (timestamp - origin) * 1e6 / frequency
+
+    current_task = None
+    task_start = None
+    open_spans = {}
+    for timestamp, event, argument in records:
+        ts = microseconds(timestamp)
+        if event == EVENT_TASK_SWITCHED_IN:
+            if current_task is not None:
+                events.append({'ph': 'X', 'name': tasks.get(current_task, str(current_task)), 'pid': PID,
+                               'tid': current_task, 'ts': task_start, 'dur': ts - task_start})
+            current_task = argument
+            task_start = ts
+        elif event in SPANS:
+            open_spans[event] = (ts, argument)
+        elif event in SPAN_ENDS:
+            start = SPAN_ENDS[event]
+            if start in open_spans:
+                start_ts, start_argument = open_spans.pop(start)
+                _, name, track = SPANS[start]
+                events.append({'ph': 'X', 'name': name, 'pid': PID, 'tid': TRACK_IDS[track], 'ts': start_ts,
+                               'dur': ts - start_ts, 'args': {'argument': start_argument, 'end_argument': argument}})
+        elif event in INSTANTS:
+            name, key, fmt = INSTANTS[event]
+            events.append({'ph': 'i', 's': 't', 'name': name, 'pid': PID, 'tid': TRACK_IDS['Messages'], 'ts': ts,
+                           'args': {key: fmt.format(argument)}})
+        else:
+            events.append({'ph': 'i', 's': 't', 'name': 'Event {}'.format(event), 'pid': PID,
+                           'tid': TRACK_IDS['Messages'], 'ts': ts, 'args': {'argument': argument}})
+
+    if current_task is not None:
+        end_ts = microseconds(records[-1][0])
+        events.append({'ph': 'X', 'name': tasks.get(current_task, str(current_task)), 'pid': PID,
+                       'tid': current_task, 'ts': task_start, 'dur': end_ts - task_start})
+
+    return {'traceEvents': events, 'displayTimeUnit': 'ms', 'otherData': {'lostEvents': lost}}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('dump', help='binary trace read from the watch (/trace.bin)')
+    parser.add_argument('output', nargs='?', help='Chrome trace JSON file (default: standard output)')
+    args = parser.parse_args()
+
+    with open(args.dump, 'rb') as f:
+        data = f.read()
+    try:
+        trace = to_chrome_trace(*decode(data))
+    except TraceError as e:
+        sys.exit('{}: {}'.format(args.dump, e))
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()